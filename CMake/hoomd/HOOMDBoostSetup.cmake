@@ -50,6 +50,11 @@ endif ()
 
 find_package(Boost 1.32.0 COMPONENTS REQUIRED ${REQUIRED_BOOST_COMPONENTS})
 
+# compressed output is written as a series of gzip members, older versions of gzip_decompressor only read the first
+if (ENABLE_ZLIB AND Boost_MAJOR_VERSION EQUAL 1 AND Boost_MINOR_VERSION LESS 44)
+message(FATAL_ERROR "ENABLE_ZLIB requires boost >= 1.44.0 (found ${Boost_MAJOR_VERSION}.${Boost_MINOR_VERSION}). Upgrade boost or set ENABLE_ZLIB=OFF.")
+endif ()
+
 # add include directories
 include_directories(${Boost_INCLUDE_DIR})
 
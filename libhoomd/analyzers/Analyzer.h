@@ -62,6 +62,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <boost/shared_ptr.hpp>
 #include <boost/utility.hpp>
+#include <boost/function.hpp>
 
 #include "Profiler.h"
 #include "SystemDefinition.h"
@@ -93,6 +94,15 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
     themselves. (it is recomenned to pass a shared pointer to the Compute
     into the constructor of the derived class).
 
+    <b>Asynchronous analysis</b>
+
+    When System is set to run analyzers asynchronously, it calls prepareAnalysis() instead of analyze(). Analyzers
+    that only read the particle data can override it to split their work: everything that touches ParticleData,
+    groups or computes is done in prepareAnalysis() on the main thread (typically taking a snapshot), and the returned
+    function does the rest (calculations on the snapshot and file output) on a worker thread while the simulation
+    continues. The returned function must only use the data it was given and state that prepareAnalysis() does not
+    modify. System never runs two functions of the same analyzer at the same time, and runs them in order.
+
     See \ref page_dev_info for more information
 
     \ingroup analyzers
@@ -110,6 +120,18 @@ class Analyzer : boost::noncopyable
             */
         virtual void analyze(unsigned int timestep) = 0;
 
+        //! Performs the part of the analysis that needs the simulation state
+        /*! \param timestep Current time step of the simulation
+            \returns The remaining part of the analysis, which can run on another thread, or an empty function
+
+            The base class performs the whole analysis with analyze() and returns an empty function.
+        */
+        virtual boost::function<void ()> prepareAnalysis(unsigned int timestep)
+            {
+            analyze(timestep);
+            return boost::function<void ()>();
+            }
+
         //! Sets the profiler for the analyzer to use
         void setProfiler(boost::shared_ptr<Profiler> prof);
 
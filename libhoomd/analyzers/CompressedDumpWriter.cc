@@ -0,0 +1,304 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+/*! \file CompressedDumpWriter.cc
+    \brief Defines the CompressedDumpWriter class
+*/
+
+#ifdef WIN32
+#pragma warning( push )
+#pragma warning( disable : 4244 )
+#endif
+
+#include <fstream>
+#include <stdexcept>
+#include <cmath>
+
+#include "CompressedDumpWriter.h"
+
+#include <boost/python.hpp>
+#include <boost/filesystem/operations.hpp>
+using namespace boost::python;
+using namespace std;
+
+/*! \param sysdef SystemDefinition containing the ParticleData to dump
+    \param fname File name to write to
+    \param group Group of particles to include in the output
+    \param precision Quantization step of the positions (in distance units)
+    \param overwrite If false, existing files will be appended to. If true, existing files will be overwritten.
+
+    No file operations are attempted until analyze() is called.
+*/
+CompressedDumpWriter::CompressedDumpWriter(boost::shared_ptr<SystemDefinition> sysdef,
+                                           const std::string &fname,
+                                           boost::shared_ptr<ParticleGroup> group,
+                                           Scalar precision,
+                                           bool overwrite)
+    : Analyzer(sysdef), m_fname(fname), m_group(group), m_precision(precision), m_key_interval(100),
+      m_overwrite(overwrite), m_is_initialized(false), m_num_particles(0), m_frames_since_key(0), m_num_prev(0)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing CompressedDumpWriter: " << fname << " " << precision << " "
+                                << overwrite << endl;
+
+    if (precision <= Scalar(0.0))
+        {
+        m_exec_conf->msg->error() << "dump.compressed: precision must be positive" << endl;
+        throw runtime_error("Error initializing CompressedDumpWriter");
+        }
+    }
+
+CompressedDumpWriter::~CompressedDumpWriter()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying CompressedDumpWriter" << endl;
+    }
+
+/*! \param interval Number of frames between key frames
+
+    Larger intervals compress better, smaller intervals make reading random frames faster.
+*/
+void CompressedDumpWriter::setKeyFrameInterval(unsigned int interval)
+    {
+    if (interval == 0)
+        {
+        m_exec_conf->msg->error() << "dump.compressed: key frame interval must be at least 1" << endl;
+        throw runtime_error("Error setting dump.compressed parameters");
+        }
+    m_key_interval = interval;
+    }
+
+//! Initializes the output file for writing
+void CompressedDumpWriter::initFileIO()
+    {
+    unsigned int nparticles = m_group->getNumMembersGlobal();
+
+    if (!m_overwrite && boost::filesystem::exists(m_fname) && boost::filesystem::file_size(m_fname) > 0)
+        {
+        m_exec_conf->msg->notice(3) << "dump.compressed: Appending to existing file \"" << m_fname << "\"" << endl;
+
+        ifstream file(m_fname.c_str(), ios::in | ios::binary);
+        QTRFileHeader header;
+        file.read((char*)&header, sizeof(QTRFileHeader));
+        if (!file.good() || memcmp(header.magic, QTR_FILE_MAGIC, 8) != 0 || header.version != QTR_FORMAT_VERSION)
+            {
+            m_exec_conf->msg->error() << "dump.compressed: " << m_fname
+                                      << " is not a compressed trajectory or has an unsupported version" << endl;
+            throw runtime_error("Error appending to compressed trajectory");
+            }
+        if (header.num_particles != nparticles)
+            {
+            m_exec_conf->msg->error() << "dump.compressed: " << m_fname << " has " << header.num_particles
+                                      << " particles per frame, but the group has " << nparticles << endl;
+            throw runtime_error("Error appending to compressed trajectory");
+            }
+        if (header.precision != m_precision)
+            {
+            m_exec_conf->msg->warning() << "dump.compressed: appending to a file with precision " << header.precision
+                                        << ", ignoring the requested precision of " << m_precision << endl;
+            m_precision = header.precision;
+            }
+        }
+    else
+        {
+        ofstream file(m_fname.c_str(), ios::out | ios::binary | ios::trunc);
+
+        QTRFileHeader header;
+        memset(&header, 0, sizeof(QTRFileHeader));
+        memcpy(header.magic, QTR_FILE_MAGIC, 8);
+        header.version = QTR_FORMAT_VERSION;
+        header.num_particles = nparticles;
+        header.precision = m_precision;
+        file.write((char*)&header, sizeof(QTRFileHeader));
+
+        if (!file.good())
+            {
+            m_exec_conf->msg->error() << "dump.compressed: Unable to open " << m_fname << " for writing" << endl;
+            throw runtime_error("Error writing compressed trajectory");
+            }
+        }
+
+    // the first frame written by this instance is always a key frame
+    m_num_particles = nparticles;
+    m_num_prev = 0;
+    m_frames_since_key = 0;
+    m_is_initialized = true;
+    }
+
+/*! \param timestep Current time step of the simulation
+
+    The first call to analyze() creates (or opens for appending) the file. Every call appends one frame.
+*/
+void CompressedDumpWriter::analyze(unsigned int timestep)
+    {
+    if (m_prof)
+        m_prof->push("Dump compressed");
+
+    // take particle data snapshot
+    SnapshotParticleData snapshot(m_pdata->getNGlobal());
+
+    m_pdata->takeSnapshot(snapshot);
+
+#ifdef ENABLE_MPI
+    // if we are not the root processor, do not perform file I/O
+    if (m_comm && !m_exec_conf->isRoot())
+        {
+        if (m_prof) m_prof->pop();
+        return;
+        }
+#endif
+
+    if (!m_is_initialized)
+        initFileIO();
+
+    BoxDim box = m_pdata->getGlobalBox();
+    unsigned int nparticles = m_group->getNumMembersGlobal();
+    if (nparticles != m_num_particles)
+        {
+        m_exec_conf->msg->error() << "dump.compressed: the number of particles in the group changed from "
+                                  << m_num_particles << " to " << nparticles << endl;
+        throw runtime_error("Error writing compressed trajectory");
+        }
+    double inv_precision = 1.0 / m_precision;
+
+    // quantize the unwrapped positions in tag order
+    for (unsigned int c = 0; c < 3; c++)
+        m_q[c].resize(nparticles);
+
+    for (unsigned int group_idx = 0; group_idx < nparticles; group_idx++)
+        {
+        unsigned int i = m_group->getMemberTag(group_idx);
+        Scalar3 pos = box.shift(snapshot.pos[i], snapshot.image[i]);
+        m_q[0][group_idx] = (boost::int64_t)floor(double(pos.x) * inv_precision + 0.5);
+        m_q[1][group_idx] = (boost::int64_t)floor(double(pos.y) * inv_precision + 0.5);
+        m_q[2][group_idx] = (boost::int64_t)floor(double(pos.z) * inv_precision + 0.5);
+        }
+
+    bool key_frame = (m_num_prev == 0 || m_frames_since_key >= m_key_interval);
+    if (key_frame)
+        m_num_prev = 0;
+
+    // code each coordinate with the predictor that leaves the smallest residuals
+    m_payload.clear();
+    QTRBitWriter out(m_payload);
+    std::vector<boost::uint64_t> best, trial;
+    for (unsigned int c = 0; c < 3; c++)
+        {
+        unsigned int best_predictor = qtr_predict_particle;
+        qtr_residuals(m_q[c], m_prev1[c], m_prev2[c], qtr_predict_particle, best);
+        boost::uint64_t best_cost = qtr_cost(best);
+
+        for (unsigned int p = qtr_predict_frame; p <= qtr_predict_linear && p <= m_num_prev; p++)
+            {
+            qtr_residuals(m_q[c], m_prev1[c], m_prev2[c], p, trial);
+            boost::uint64_t cost = qtr_cost(trial);
+            if (cost < best_cost)
+                {
+                best.swap(trial);
+                best_cost = cost;
+                best_predictor = p;
+                }
+            }
+
+        out.write(best_predictor, 2);
+        qtr_encode_values(best, out);
+        }
+    out.flush();
+
+    // write the frame to the end of the file
+    QTRFrameHeader header;
+    memset(&header, 0, sizeof(QTRFrameHeader));
+    memcpy(header.magic, QTR_FRAME_MAGIC, 4);
+    header.timestep = timestep;
+    header.key_frame = key_frame ? 1 : 0;
+    Scalar3 L = box.getL();
+    header.box[0] = L.x;
+    header.box[1] = L.y;
+    header.box[2] = L.z;
+    header.box[3] = box.getTiltFactorXY();
+    header.box[4] = box.getTiltFactorXZ();
+    header.box[5] = box.getTiltFactorYZ();
+    header.payload_size = m_payload.size();
+
+    ofstream file(m_fname.c_str(), ios::out | ios::binary | ios::app);
+    file.write((char*)&header, sizeof(QTRFrameHeader));
+    if (m_payload.size())
+        file.write((char*)&m_payload[0], m_payload.size());
+
+    if (!file.good())
+        {
+        m_exec_conf->msg->error() << "dump.compressed: I/O error while writing " << m_fname << endl;
+        throw runtime_error("Error writing compressed trajectory");
+        }
+
+    // this frame becomes the prediction source of the next one
+    for (unsigned int c = 0; c < 3; c++)
+        {
+        m_prev2[c].swap(m_prev1[c]);
+        m_prev1[c].swap(m_q[c]);
+        }
+    m_num_prev = (m_num_prev < 2) ? m_num_prev + 1 : 2;
+    m_frames_since_key = key_frame ? 1 : m_frames_since_key + 1;
+
+    if (m_prof)
+        m_prof->pop();
+    }
+
+void export_CompressedDumpWriter()
+    {
+    class_<CompressedDumpWriter, boost::shared_ptr<CompressedDumpWriter>, bases<Analyzer>, boost::noncopyable>
+    ("CompressedDumpWriter", init< boost::shared_ptr<SystemDefinition>, std::string, boost::shared_ptr<ParticleGroup>,
+                                   Scalar, bool>())
+    .def("setKeyFrameInterval", &CompressedDumpWriter::setKeyFrameInterval)
+    ;
+    }
+
+#ifdef WIN32
+#pragma warning( pop )
+#endif
@@ -0,0 +1,125 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+/*! \file CompressedDumpWriter.h
+    \brief Declares the CompressedDumpWriter class
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <string>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include "Analyzer.h"
+#include "ParticleGroup.h"
+#include "CompressedTrajectoryFormat.h"
+
+#ifndef __COMPRESSED_DUMP_WRITER_H__
+#define __COMPRESSED_DUMP_WRITER_H__
+
+//! Analyzer for writing lossy compressed trajectories
+/*! CompressedDumpWriter appends the unwrapped positions of the particles in a group to a compressed trajectory every
+    time analyze() is called. Positions are quantized to a user set precision, predicted from neighboring particles or
+    previous frames and entropy coded; see CompressedTrajectoryFormat.h for the details. Use
+    CompressedTrajectoryReader to read the frames back.
+
+    Every \a key_interval frames a key frame is written that does not depend on earlier frames, which bounds the work
+    needed to read an arbitrary frame.
+
+    \ingroup analyzers
+*/
+class CompressedDumpWriter : public Analyzer
+    {
+    public:
+        //! Construct the writer
+        CompressedDumpWriter(boost::shared_ptr<SystemDefinition> sysdef,
+                             const std::string &fname,
+                             boost::shared_ptr<ParticleGroup> group,
+                             Scalar precision,
+                             bool overwrite=false);
+
+        //! Destructor
+        ~CompressedDumpWriter();
+
+        //! Write out the data for the current timestep
+        void analyze(unsigned int timestep);
+
+        //! Set the number of frames between key frames
+        void setKeyFrameInterval(unsigned int interval);
+
+    private:
+        std::string m_fname;                        //!< The file name we are writing to
+        boost::shared_ptr<ParticleGroup> m_group;   //!< Group of particles to write
+        double m_precision;                         //!< Quantization step
+        unsigned int m_key_interval;                //!< Number of frames between key frames
+        bool m_overwrite;                           //!< True if the file should be overwritten
+        bool m_is_initialized;                      //!< True if file IO has been initialized
+        unsigned int m_num_particles;               //!< Number of particles in each frame of the file
+
+        unsigned int m_frames_since_key;            //!< Number of frames written since the last key frame
+        unsigned int m_num_prev;                    //!< Number of previous frames available for prediction
+        std::vector<boost::int64_t> m_q[3];         //!< Quantized coordinates of the current frame
+        std::vector<boost::int64_t> m_prev1[3];     //!< Quantized coordinates of the previous frame
+        std::vector<boost::int64_t> m_prev2[3];     //!< Quantized coordinates of the frame before that
+        std::vector<unsigned char> m_payload;       //!< Coded frame data
+
+        //! Initializes the output file for writing
+        void initFileIO();
+    };
+
+//! Exports the CompressedDumpWriter class to python
+void export_CompressedDumpWriter();
+
+#endif
@@ -0,0 +1,391 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+/*! \file CompressedTrajectoryFormat.h
+    \brief Declares the file layout and coder shared by CompressedDumpWriter and CompressedTrajectoryReader
+*/
+
+#ifndef __COMPRESSED_TRAJECTORY_FORMAT_H__
+#define __COMPRESSED_TRAJECTORY_FORMAT_H__
+
+#include <vector>
+#include <cstring>
+
+#include <boost/cstdint.hpp>
+
+//! \name Compressed trajectory format
+/*! Compressed trajectories store unwrapped particle positions quantized to a fixed precision, so the error of every
+    coordinate is bounded by half the precision.
+
+    Layout (all values in native byte order):
+     - File header: QTRFileHeader
+     - Frames, each consisting of a QTRFrameHeader followed by \a payload_size bytes of coded data
+
+    Each coordinate (x, y and z separately) of a frame is predicted with one of the predictors in QTRPredictor and
+    only the residuals are stored. Key frames use the previous particle (in tag order) as the prediction, so they can
+    be decoded on their own. Other frames pick, per coordinate, whichever of the key frame predictor, the previous
+    frame, or a linear extrapolation of the two previous frames gives the smallest residuals. The residuals are
+    zig-zag mapped to unsigned integers and entropy coded with adaptive Rice codes: every block of
+    QTR_BLOCK_SIZE values selects the Rice parameter that fits its magnitude.
+
+    A reader seeks to the closest key frame at or before the requested frame and decodes forward from there.
+*/
+//@{
+
+//! Magic string at the start of every compressed trajectory
+const char QTR_FILE_MAGIC[8] = {'H','O','O','M','D','Q','T','R'};
+//! Magic string at the start of every frame
+const char QTR_FRAME_MAGIC[4] = {'Q','F','R','M'};
+//! Current version of the format
+const unsigned int QTR_FORMAT_VERSION = 1;
+//! Number of residuals sharing a Rice parameter
+const unsigned int QTR_BLOCK_SIZE = 64;
+//! Largest unary quotient before a value is escaped and stored verbatim
+const unsigned int QTR_MAX_QUOTIENT = 16;
+
+//! Predictors for the coordinates of a frame
+enum QTRPredictor
+    {
+    qtr_predict_particle = 0,   //!< Previous particle in the same frame
+    qtr_predict_frame,          //!< Same particle in the previous frame
+    qtr_predict_linear          //!< Linear extrapolation from the two previous frames
+    };
+
+//! File header
+struct QTRFileHeader
+    {
+    char magic[8];                  //!< QTR_FILE_MAGIC
+    unsigned int version;           //!< QTR_FORMAT_VERSION
+    unsigned int num_particles;     //!< Number of particles in every frame
+    double precision;               //!< Quantization step
+    };
+
+//! Header at the start of each frame
+struct QTRFrameHeader
+    {
+    char magic[4];                  //!< QTR_FRAME_MAGIC
+    unsigned int timestep;          //!< Time step of the frame
+    unsigned int key_frame;         //!< 1 if the frame can be decoded on its own
+    unsigned int reserved;          //!< Unused, written as 0
+    double box[6];                  //!< Lx, Ly, Lz, xy, xz, yz
+    boost::uint64_t payload_size;   //!< Number of bytes of coded data following the header
+    };
+
+//! Appends bits to a byte buffer
+class QTRBitWriter
+    {
+    public:
+        //! Construct a writer appending to \a out
+        QTRBitWriter(std::vector<unsigned char>& out) : m_out(out), m_acc(0), m_nbits(0) { }
+
+        //! Write the \a n low bits of \a v (n <= 57)
+        void write(boost::uint64_t v, unsigned int n)
+            {
+            if (n == 0)
+                return;
+            m_acc |= (v & ((boost::uint64_t(1) << n) - 1)) << m_nbits;
+            m_nbits += n;
+            while (m_nbits >= 8)
+                {
+                m_out.push_back((unsigned char)(m_acc & 0xff));
+                m_acc >>= 8;
+                m_nbits -= 8;
+                }
+            }
+
+        //! Write \a n one bits followed by a zero bit
+        void writeUnary(unsigned int n)
+            {
+            while (n >= 32)
+                {
+                write(0xffffffffu, 32);
+                n -= 32;
+                }
+            write((boost::uint64_t(1) << n) - 1, n+1);
+            }
+
+        //! Write out the last partial byte
+        void flush()
+            {
+            if (m_nbits > 0)
+                m_out.push_back((unsigned char)(m_acc & 0xff));
+            m_acc = 0;
+            m_nbits = 0;
+            }
+
+    private:
+        std::vector<unsigned char>& m_out;  //!< Output buffer
+        boost::uint64_t m_acc;              //!< Bits not yet written
+        unsigned int m_nbits;               //!< Number of bits in m_acc
+    };
+
+//! Reads bits written by QTRBitWriter
+class QTRBitReader
+    {
+    public:
+        //! Construct a reader of \a size bytes at \a data
+        QTRBitReader(const unsigned char *data, size_t size)
+            : m_data(data), m_size(size), m_pos(0), m_acc(0), m_nbits(0), m_overrun(false) { }
+
+        //! Read \a n bits (n <= 57)
+        boost::uint64_t read(unsigned int n)
+            {
+            if (n == 0)
+                return 0;
+            refill();
+            if (m_nbits < n)
+                {
+                m_overrun = true;
+                return 0;
+                }
+            boost::uint64_t v = m_acc & ((boost::uint64_t(1) << n) - 1);
+            m_acc >>= n;
+            m_nbits -= n;
+            return v;
+            }
+
+        //! Read a unary coded value, stopping at \a limit ones
+        unsigned int readUnary(unsigned int limit)
+            {
+            unsigned int n = 0;
+            while (n < limit && read(1))
+                n++;
+            return n;
+            }
+
+        //! Test if the reader ran past the end of the data
+        bool overrun() const
+            {
+            return m_overrun;
+            }
+
+    private:
+        const unsigned char *m_data;    //!< Coded data
+        size_t m_size;                  //!< Size of the coded data
+        size_t m_pos;                   //!< Next byte to load
+        boost::uint64_t m_acc;          //!< Loaded bits
+        unsigned int m_nbits;           //!< Number of bits in m_acc
+        bool m_overrun;                 //!< True if a read went past the end
+
+        //! Load as many bytes as fit in the accumulator
+        void refill()
+            {
+            while (m_nbits <= 56 && m_pos < m_size)
+                {
+                m_acc |= boost::uint64_t(m_data[m_pos++]) << m_nbits;
+                m_nbits += 8;
+                }
+            }
+    };
+
+//! Map a signed residual to an unsigned integer, small magnitudes first
+inline boost::uint64_t qtr_zigzag(boost::int64_t v)
+    {
+    return (boost::uint64_t(v) << 1) ^ boost::uint64_t(v >> 63);
+    }
+
+//! Inverse of qtr_zigzag()
+inline boost::int64_t qtr_unzigzag(boost::uint64_t v)
+    {
+    return boost::int64_t(v >> 1) ^ -boost::int64_t(v & 1);
+    }
+
+//! Number of significant bits in \a v
+inline unsigned int qtr_bit_length(boost::uint64_t v)
+    {
+    unsigned int n = 0;
+    while (v)
+        {
+        v >>= 1;
+        n++;
+        }
+    return n;
+    }
+
+//! Rice code a list of unsigned values
+/*! \param values Values to code
+    \param out Writer to append to
+*/
+inline void qtr_encode_values(const std::vector<boost::uint64_t>& values, QTRBitWriter& out)
+    {
+    for (size_t start = 0; start < values.size(); start += QTR_BLOCK_SIZE)
+        {
+        size_t end = start + QTR_BLOCK_SIZE;
+        if (end > values.size())
+            end = values.size();
+
+        // the best Rice parameter is close to log2 of the mean value
+        boost::uint64_t sum = 0;
+        for (size_t i = start; i < end; i++)
+            sum += values[i];
+        boost::uint64_t mean = sum / (end - start);
+        unsigned int k = mean ? qtr_bit_length(mean) - 1 : 0;
+        if (k > 56)
+            k = 56;
+        out.write(k, 6);
+
+        for (size_t i = start; i < end; i++)
+            {
+            boost::uint64_t q = values[i] >> k;
+            if (q < QTR_MAX_QUOTIENT)
+                {
+                out.writeUnary((unsigned int)q);
+                out.write(values[i], k);
+                }
+            else
+                {
+                // escape: QTR_MAX_QUOTIENT ones without a terminating zero, then the value verbatim
+                out.write((boost::uint64_t(1) << QTR_MAX_QUOTIENT) - 1, QTR_MAX_QUOTIENT);
+                unsigned int n = qtr_bit_length(values[i]);
+                out.write(n, 7);
+                if (n > 32)
+                    {
+                    out.write(values[i], 32);
+                    out.write(values[i] >> 32, n - 32);
+                    }
+                else
+                    out.write(values[i], n);
+                }
+            }
+        }
+    }
+
+//! Decode values written by qtr_encode_values()
+/*! \param in Reader to read from
+    \param values Filled with the decoded values (the size must be set by the caller)
+*/
+inline void qtr_decode_values(QTRBitReader& in, std::vector<boost::uint64_t>& values)
+    {
+    unsigned int k = 0;
+    for (size_t i = 0; i < values.size(); i++)
+        {
+        if (i % QTR_BLOCK_SIZE == 0)
+            k = (unsigned int)in.read(6);
+
+        unsigned int q = in.readUnary(QTR_MAX_QUOTIENT);
+        if (q < QTR_MAX_QUOTIENT)
+            values[i] = (boost::uint64_t(q) << k) | in.read(k);
+        else
+            {
+            unsigned int n = (unsigned int)in.read(7);
+            if (n > 32)
+                {
+                boost::uint64_t lo = in.read(32);
+                values[i] = lo | (in.read(n - 32) << 32);
+                }
+            else
+                values[i] = in.read(n);
+            }
+        }
+    }
+
+//! Compute the residuals of one coordinate with the given predictor
+/*! \param q Quantized coordinates of the current frame
+    \param prev1 Quantized coordinates of the previous frame
+    \param prev2 Quantized coordinates of the frame before that
+    \param predictor Predictor to use
+    \param residuals Filled with the zig-zag mapped residuals
+*/
+inline void qtr_residuals(const std::vector<boost::int64_t>& q,
+                          const std::vector<boost::int64_t>& prev1,
+                          const std::vector<boost::int64_t>& prev2,
+                          unsigned int predictor,
+                          std::vector<boost::uint64_t>& residuals)
+    {
+    size_t n = q.size();
+    residuals.resize(n);
+    for (size_t i = 0; i < n; i++)
+        {
+        boost::int64_t p;
+        if (predictor == qtr_predict_frame)
+            p = prev1[i];
+        else if (predictor == qtr_predict_linear)
+            p = 2*prev1[i] - prev2[i];
+        else
+            p = i ? q[i-1] : 0;
+        residuals[i] = qtr_zigzag(q[i] - p);
+        }
+    }
+
+//! Invert qtr_residuals()
+inline void qtr_reconstruct(const std::vector<boost::uint64_t>& residuals,
+                            const std::vector<boost::int64_t>& prev1,
+                            const std::vector<boost::int64_t>& prev2,
+                            unsigned int predictor,
+                            std::vector<boost::int64_t>& q)
+    {
+    size_t n = residuals.size();
+    q.resize(n);
+    for (size_t i = 0; i < n; i++)
+        {
+        boost::int64_t p;
+        if (predictor == qtr_predict_frame)
+            p = prev1[i];
+        else if (predictor == qtr_predict_linear)
+            p = 2*prev1[i] - prev2[i];
+        else
+            p = i ? q[i-1] : 0;
+        q[i] = p + qtr_unzigzag(residuals[i]);
+        }
+    }
+
+//! Estimate the coded size of a list of residuals in bits
+inline boost::uint64_t qtr_cost(const std::vector<boost::uint64_t>& residuals)
+    {
+    boost::uint64_t bits = 0;
+    for (size_t i = 0; i < residuals.size(); i++)
+        bits += 2*qtr_bit_length(residuals[i]) + 1;
+    return bits;
+    }
+
+//@}
+
+#endif
@@ -0,0 +1,277 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+/*! \file CompressedTrajectoryReader.cc
+    \brief Defines the CompressedTrajectoryReader class
+*/
+
+#ifdef WIN32
+#pragma warning( push )
+#pragma warning( disable : 4244 4267 )
+#endif
+
+#include <stdexcept>
+
+#include "CompressedTrajectoryReader.h"
+
+#include <boost/filesystem/operations.hpp>
+using namespace boost::python;
+using namespace std;
+
+/*! \param exec_conf Execution configuration
+    \param fname File to read
+*/
+CompressedTrajectoryReader::CompressedTrajectoryReader(boost::shared_ptr<const ExecutionConfiguration> exec_conf,
+                                                       const std::string &fname)
+    : m_exec_conf(exec_conf), m_fname(fname), m_num_particles(0), m_precision(0.0), m_cur_frame(-1), m_num_prev(0)
+    {
+    if (!boost::filesystem::exists(fname))
+        {
+        m_exec_conf->msg->error() << "CompressedTrajectoryReader: File " << fname << " not found" << endl;
+        throw runtime_error("Error reading compressed trajectory");
+        }
+
+    try
+        {
+        m_file.open(fname);
+        }
+    catch (std::exception& e)
+        {
+        m_exec_conf->msg->error() << "CompressedTrajectoryReader: Unable to open " << fname << ": " << e.what() << endl;
+        throw runtime_error("Error reading compressed trajectory");
+        }
+
+    QTRFileHeader header;
+    if (m_file.size() < sizeof(QTRFileHeader))
+        {
+        m_exec_conf->msg->error() << "CompressedTrajectoryReader: " << fname << " is not a compressed trajectory" << endl;
+        throw runtime_error("Error reading compressed trajectory");
+        }
+    memcpy(&header, m_file.data(), sizeof(QTRFileHeader));
+    if (memcmp(header.magic, QTR_FILE_MAGIC, 8) != 0 || header.version != QTR_FORMAT_VERSION)
+        {
+        m_exec_conf->msg->error() << "CompressedTrajectoryReader: " << fname
+                                  << " is not a compressed trajectory or has an unsupported version" << endl;
+        throw runtime_error("Error reading compressed trajectory");
+        }
+    m_num_particles = header.num_particles;
+    m_precision = header.precision;
+
+    // index the frames, only the headers are touched
+    boost::uint64_t offset = sizeof(QTRFileHeader);
+    boost::uint64_t size = m_file.size();
+    while (offset + sizeof(QTRFrameHeader) <= size)
+        {
+        QTRFrameHeader frame;
+        memcpy(&frame, m_file.data() + offset, sizeof(QTRFrameHeader));
+        if (memcmp(frame.magic, QTR_FRAME_MAGIC, 4) != 0 ||
+            frame.payload_size > size - offset - sizeof(QTRFrameHeader))
+            break;
+
+        // a trajectory that was appended to in a later run must start over at a key frame
+        if (m_frames.empty() && !frame.key_frame)
+            break;
+
+        FrameEntry entry;
+        entry.offset = offset;
+        entry.timestep = frame.timestep;
+        entry.key_frame = frame.key_frame != 0;
+        m_frames.push_back(entry);
+        offset += sizeof(QTRFrameHeader) + frame.payload_size;
+        }
+
+    if (offset != size)
+        m_exec_conf->msg->warning() << "CompressedTrajectoryReader: ignoring " << size - offset
+                                    << " bytes of incomplete data at the end of " << fname << endl;
+    }
+
+/*! \param frame Index of the frame
+*/
+unsigned int CompressedTrajectoryReader::getTimeStep(unsigned int frame) const
+    {
+    if (frame >= m_frames.size())
+        {
+        m_exec_conf->msg->error() << "CompressedTrajectoryReader: Frame " << frame << " out of range" << endl;
+        throw runtime_error("Error reading compressed trajectory");
+        }
+    return m_frames[frame].timestep;
+    }
+
+/*! \param frame Index of the frame
+*/
+BoxDim CompressedTrajectoryReader::getBox(unsigned int frame) const
+    {
+    if (frame >= m_frames.size())
+        {
+        m_exec_conf->msg->error() << "CompressedTrajectoryReader: Frame " << frame << " out of range" << endl;
+        throw runtime_error("Error reading compressed trajectory");
+        }
+
+    QTRFrameHeader header;
+    memcpy(&header, m_file.data() + m_frames[frame].offset, sizeof(QTRFrameHeader));
+    BoxDim box(Scalar(header.box[0]), Scalar(header.box[1]), Scalar(header.box[2]));
+    box.setTiltFactors(Scalar(header.box[3]), Scalar(header.box[4]), Scalar(header.box[5]));
+    return box;
+    }
+
+/*! \param frame Index of the frame
+    \returns Unwrapped positions of the particles in the frame
+
+    The returned reference is valid until the next call to readFrame().
+*/
+const std::vector<Scalar3>& CompressedTrajectoryReader::readFrame(unsigned int frame)
+    {
+    if (frame >= m_frames.size())
+        {
+        m_exec_conf->msg->error() << "CompressedTrajectoryReader: Frame " << frame << " out of range" << endl;
+        throw runtime_error("Error reading compressed trajectory");
+        }
+
+    if (m_cur_frame == int(frame))
+        return m_pos;
+
+    // find the key frame this frame depends on
+    unsigned int start = frame;
+    while (!m_frames[start].key_frame)
+        start--;
+
+    // continue from the current frame if it lies between the key frame and the requested one
+    if (m_cur_frame >= int(start) && m_cur_frame < int(frame))
+        start = m_cur_frame + 1;
+
+    for (unsigned int i = start; i <= frame; i++)
+        decodeFrame(i);
+
+    // convert to positions
+    m_pos.resize(m_num_particles);
+    for (unsigned int i = 0; i < m_num_particles; i++)
+        m_pos[i] = make_scalar3(Scalar(double(m_prev1[0][i]) * m_precision),
+                                Scalar(double(m_prev1[1][i]) * m_precision),
+                                Scalar(double(m_prev1[2][i]) * m_precision));
+    return m_pos;
+    }
+
+/*! \param frame Index of the frame to decode
+
+    The caller must decode the frames in order, starting at a key frame. After the call, the decoded coordinates are
+    in m_prev1.
+*/
+void CompressedTrajectoryReader::decodeFrame(unsigned int frame)
+    {
+    const FrameEntry& entry = m_frames[frame];
+    QTRFrameHeader header;
+    memcpy(&header, m_file.data() + entry.offset, sizeof(QTRFrameHeader));
+
+    if (header.key_frame)
+        m_num_prev = 0;
+
+    QTRBitReader in((const unsigned char*)m_file.data() + entry.offset + sizeof(QTRFrameHeader),
+                    (size_t)header.payload_size);
+    std::vector<boost::uint64_t> residuals(m_num_particles);
+    for (unsigned int c = 0; c < 3; c++)
+        {
+        unsigned int predictor = (unsigned int)in.read(2);
+        if (predictor > m_num_prev)
+            {
+            m_exec_conf->msg->error() << "CompressedTrajectoryReader: Corrupt frame " << frame << " in "
+                                      << m_fname << endl;
+            m_cur_frame = -1;
+            throw runtime_error("Error reading compressed trajectory");
+            }
+        qtr_decode_values(in, residuals);
+        qtr_reconstruct(residuals, m_prev1[c], m_prev2[c], predictor, m_q[c]);
+        }
+
+    if (in.overrun())
+        {
+        m_exec_conf->msg->error() << "CompressedTrajectoryReader: Corrupt frame " << frame << " in " << m_fname << endl;
+        m_cur_frame = -1;
+        throw runtime_error("Error reading compressed trajectory");
+        }
+
+    // this frame becomes the prediction source of the next one
+    for (unsigned int c = 0; c < 3; c++)
+        {
+        m_prev2[c].swap(m_prev1[c]);
+        m_prev1[c].swap(m_q[c]);
+        }
+    m_num_prev = (m_num_prev < 2) ? m_num_prev + 1 : 2;
+    m_cur_frame = frame;
+    }
+
+/*! \param frame Index of the frame
+    \returns A list of (x,y,z) tuples
+*/
+boost::python::list CompressedTrajectoryReader::getPositions(unsigned int frame)
+    {
+    const std::vector<Scalar3>& pos = readFrame(frame);
+    boost::python::list result;
+    for (unsigned int i = 0; i < pos.size(); i++)
+        result.append(boost::python::make_tuple(pos[i].x, pos[i].y, pos[i].z));
+    return result;
+    }
+
+void export_CompressedTrajectoryReader()
+    {
+    class_<CompressedTrajectoryReader, boost::shared_ptr<CompressedTrajectoryReader>, boost::noncopyable>
+    ("CompressedTrajectoryReader", init< boost::shared_ptr<const ExecutionConfiguration>, std::string >())
+    .def("getNumFrames", &CompressedTrajectoryReader::getNumFrames)
+    .def("getNumParticles", &CompressedTrajectoryReader::getNumParticles)
+    .def("getPrecision", &CompressedTrajectoryReader::getPrecision)
+    .def("getTimeStep", &CompressedTrajectoryReader::getTimeStep)
+    .def("getBox", &CompressedTrajectoryReader::getBox)
+    .def("getPositions", &CompressedTrajectoryReader::getPositions)
+    ;
+    }
+
+#ifdef WIN32
+#pragma warning( pop )
+#endif
@@ -0,0 +1,150 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+/*! \file CompressedTrajectoryReader.h
+    \brief Declares the CompressedTrajectoryReader class
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <string>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/python.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#include "ExecutionConfiguration.h"
+#include "BoxDim.h"
+#include "CompressedTrajectoryFormat.h"
+
+#ifndef __COMPRESSED_TRAJECTORY_READER_H__
+#define __COMPRESSED_TRAJECTORY_READER_H__
+
+//! Reads trajectories written by CompressedDumpWriter
+/*! The file is memory mapped and the frame headers are scanned in the constructor. readFrame() decodes forward from
+    the closest key frame, or from the last frame read if that is closer, so reading a trajectory in order costs one
+    frame decode per frame.
+
+    Positions are returned unwrapped, in the order of the particle tags in the group that was written.
+
+    \ingroup analyzers
+*/
+class CompressedTrajectoryReader
+    {
+    public:
+        //! Open the file and index its frames
+        CompressedTrajectoryReader(boost::shared_ptr<const ExecutionConfiguration> exec_conf,
+                                   const std::string &fname);
+
+        //! Get the number of frames in the file
+        unsigned int getNumFrames() const
+            {
+            return (unsigned int)m_frames.size();
+            }
+
+        //! Get the number of particles in each frame
+        unsigned int getNumParticles() const
+            {
+            return m_num_particles;
+            }
+
+        //! Get the quantization step
+        Scalar getPrecision() const
+            {
+            return Scalar(m_precision);
+            }
+
+        //! Get the time step of a frame
+        unsigned int getTimeStep(unsigned int frame) const;
+
+        //! Get the box of a frame
+        BoxDim getBox(unsigned int frame) const;
+
+        //! Decode the positions of a frame
+        const std::vector<Scalar3>& readFrame(unsigned int frame);
+
+        //! Decode the positions of a frame into a python list of tuples
+        boost::python::list getPositions(unsigned int frame);
+
+    private:
+        //! Location of a frame in the file
+        struct FrameEntry
+            {
+            boost::uint64_t offset;     //!< Offset of the frame header
+            unsigned int timestep;      //!< Time step of the frame
+            bool key_frame;             //!< True if the frame is a key frame
+            };
+
+        boost::shared_ptr<const ExecutionConfiguration> m_exec_conf; //!< Execution configuration
+        std::string m_fname;                        //!< File name
+        boost::iostreams::mapped_file_source m_file;    //!< The memory mapped file
+        unsigned int m_num_particles;               //!< Number of particles per frame
+        double m_precision;                         //!< Quantization step
+        std::vector<FrameEntry> m_frames;           //!< Index of the frames
+
+        int m_cur_frame;                            //!< Last decoded frame (-1 if none)
+        unsigned int m_num_prev;                    //!< Number of previous frames available for prediction
+        std::vector<boost::int64_t> m_q[3];         //!< Quantized coordinates of the last decoded frame
+        std::vector<boost::int64_t> m_prev1[3];     //!< Quantized coordinates of the frame before that
+        std::vector<boost::int64_t> m_prev2[3];     //!< Quantized coordinates of the frame before m_prev1
+        std::vector<Scalar3> m_pos;                 //!< Positions of the last decoded frame
+
+        //! Decode the frame following the current one
+        void decodeFrame(unsigned int frame);
+    };
+
+//! Exports the CompressedTrajectoryReader class to python
+void export_CompressedTrajectoryReader();
+
+#endif
@@ -68,6 +68,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 
 #include <boost/python.hpp>
+#include <boost/bind.hpp>
 #include <boost/filesystem/operations.hpp>
 #include <boost/filesystem/convenience.hpp>
 using boost::filesystem::exists;
@@ -118,7 +119,8 @@ DCDDumpWriter::DCDDumpWriter(boost::shared_ptr<SystemDefinition> sysdef,
                              boost::shared_ptr<ParticleGroup> group,
                              bool overwrite)
     : Analyzer(sysdef), m_fname(fname), m_start_timestep(0), m_period(period), m_group(group),
-    m_rigid_data(sysdef->getRigidData()), m_num_frames_written(0), m_last_written_step(0), m_appending(false),
+    m_rigid_data(sysdef->getRigidData()), m_num_frames_written(0), m_num_frames_queued(0),
+      m_last_written_step(0), m_appending(false),
       m_unwrap_full(false), m_unwrap_rigid(false), m_angle(false),
       m_overwrite(overwrite), m_is_initialized(false)
     {
@@ -139,6 +141,7 @@ void DCDDumpWriter::initFileIO()
         file.seekp(NFILE_POS);
 
         m_num_frames_written = read_int(file);
+        m_num_frames_queued = m_num_frames_written;
         m_start_timestep = read_int(file);
         unsigned int file_period = read_int(file);
 
@@ -158,16 +161,12 @@ void DCDDumpWriter::initFileIO()
         m_appending = true;
         }
 
-    m_staging_buffer = new float[m_pdata->getNGlobal()];
     m_is_initialized = true;
     }
 
 DCDDumpWriter::~DCDDumpWriter()
     {
     m_exec_conf->msg->notice(5) << "Destroying DCDDumpWriter" << endl;
-
-    if (m_is_initialized)
-        delete[] m_staging_buffer;
     }
 
 /*! \param timestep Current time step of the simulation
@@ -177,26 +176,97 @@ DCDDumpWriter::~DCDDumpWriter()
 */
 void DCDDumpWriter::analyze(unsigned int timestep)
     {
+    boost::function<void ()> write = prepareAnalysis(timestep);
+    if (write)
+        write();
+    }
+
+/*! \param timestep Current time step of the simulation
+    \returns A function that converts the coordinates and writes the frame to the file
+
+    Only the snapshot, the box, the group members and the rigid body images are taken here. The coordinates are
+    converted to the output format by the returned function.
+*/
+boost::function<void ()> DCDDumpWriter::prepareAnalysis(unsigned int timestep)
+    {
+#ifdef ENABLE_MPI
+    if (m_comm && m_unwrap_rigid)
+        {
+        m_exec_conf->msg->error() << "dump.dcd: Unwrap of rigid bodies in DCD files is currently not supported in MPI simulations" << endl;
+        throw runtime_error("Error writing DCD file");
+        }
+#endif
+
     if (m_prof)
         m_prof->push("Dump DCD");
 
     // take particle data snapshot
-    SnapshotParticleData snapshot(m_pdata->getNGlobal());
+    boost::shared_ptr<Frame> frame(new Frame);
+    frame->snapshot = boost::shared_ptr<SnapshotParticleData>(new SnapshotParticleData(m_pdata->getNGlobal()));
 
-    m_pdata->takeSnapshot(snapshot);
+    m_pdata->takeSnapshot(*frame->snapshot);
 
 #ifdef ENABLE_MPI
     // if we are not the root processor, do not perform file I/O
     if (m_comm && !m_exec_conf->isRoot())
         {
         if (m_prof) m_prof->pop();
-        return;
+        return boost::function<void ()>();
         }
 #endif
 
     if (! m_is_initialized)
         initFileIO();
 
+    // the time step is checked against the file here, so that any warning is printed from the calling thread
+    if (m_num_frames_queued == 0)
+        {
+        m_start_timestep = timestep;
+        }
+    else
+        {
+        if (m_appending && timestep <= m_last_written_step)
+            {
+            m_exec_conf->msg->warning() << "dump.dcd: not writing output at timestep " << timestep << " because the file reports that it already has data up to step " << m_last_written_step << endl;
+            if (m_prof) m_prof->pop();
+            return boost::function<void ()>();
+            }
+
+        // verify the period on subsequent frames
+        if ( (timestep - m_start_timestep) % m_period != 0)
+            m_exec_conf->msg->warning() << "dump.dcd: writing time step " << timestep << " which is not specified in the period of the DCD file: " << m_start_timestep << " + i * " << m_period << endl;
+        }
+    m_num_frames_queued++;
+
+    frame->box = m_pdata->getGlobalBox();
+
+    // copy the group members, the group may change before the frame is converted
+        {
+        ArrayHandle<unsigned int> h_member_tags(m_group->getMemberTagArray(), access_location::host, access_mode::read);
+        frame->members.assign(h_member_tags.data, h_member_tags.data + m_group->getNumMembersGlobal());
+        }
+
+    if (m_unwrap_rigid)
+        {
+        ArrayHandle<int3> h_body_image(m_rigid_data->getBodyImage(), access_location::host, access_mode::read);
+        frame->body_image.assign(h_body_image.data, h_body_image.data + m_rigid_data->getNumBodies());
+        }
+
+    if (m_prof)
+        m_prof->pop();
+
+    return boost::bind(&DCDDumpWriter::write_frame, this, timestep, frame);
+    }
+
+/*! \param timestep Time step of the frame
+    \param frame Frame to write
+    The very first frame written results in the creation (or overwriting) of the file fname. After that, each frame
+    is added to the end of the file.
+*/
+void DCDDumpWriter::write_frame(unsigned int timestep, boost::shared_ptr<Frame> frame)
+    {
+    fill_frame(*frame);
+
     // the file object
     fstream file;
 
@@ -207,46 +277,30 @@ void DCDDumpWriter::analyze(unsigned int timestep)
         file.open(m_fname.c_str(), ios::trunc | ios::out | ios::binary);
 
         // write the file header
-        m_start_timestep = timestep;
-        write_file_header(file);
+        write_file_header(file, (unsigned int)frame->x.size());
         }
     else
         {
-        if (m_appending && timestep <= m_last_written_step)
-            {
-            m_exec_conf->msg->warning() << "dump.dcd: not writing output at timestep " << timestep << " because the file reports that it already has data up to step " << m_last_written_step << endl;
-
-            if (m_prof)
-                m_prof->pop();
-            return;
-            }
-
         // open the file and move the file pointer to the end
         file.open(m_fname.c_str(), ios::ate | ios::in | ios::out | ios::binary);
-
-        // verify the period on subsequent frames
-        if ( (timestep - m_start_timestep) % m_period != 0)
-            m_exec_conf->msg->warning() << "dump.dcd: writing time step " << timestep << " which is not specified in the period of the DCD file: " << m_start_timestep << " + i * " << m_period << endl;
         }
 
     // write the data for the current time step
-    write_frame_header(file);
-    write_frame_data(file, snapshot);
+    write_frame_header(file, frame->box);
+    write_frame_data(file, *frame);
 
     // update the header with the number of frames written
     m_num_frames_written++;
     write_updated_header(file, timestep);
     file.close();
-
-    if (m_prof)
-        m_prof->pop();
     }
 
 /*! \param file File to write to
+    \param nparticles Number of particles in each frame
     Writes the initial DCD header to the beginning of the file. This must be
     called on a newly created (or truncated file).
 */
-void DCDDumpWriter::write_file_header(std::fstream &file)
+void DCDDumpWriter::write_file_header(std::fstream &file, unsigned int nparticles)
     {
     // the first 4 bytes in the file must be 84
     write_int(file, 84);
@@ -294,26 +348,24 @@ void DCDDumpWriter::write_file_header(std::fstream &file)
 
     write_int(file, 164);
     write_int(file, 4);
-    unsigned int nparticles = m_group->getNumMembersGlobal();
     write_int(file, nparticles);
     write_int(file, 4);
 
     // check for errors
     if (!file.good())
         {
-        m_exec_conf->msg->error() << "dump.dcd: I/O rrror when writing DCD header" << endl;
-        throw runtime_error("Error writing DCD file");
+        throw runtime_error("dump.dcd: I/O error when writing DCD header");
         }
     }
 
 /*! \param file File to write to
+    \param box Box of the frame
     Writes the header that precedes each snapshot in the file. This header
     includes information on the box size of the simulation.
 */
-void DCDDumpWriter::write_frame_header(std::fstream &file)
+void DCDDumpWriter::write_frame_header(std::fstream &file, const BoxDim& box)
     {
     double unitcell[6];
-    BoxDim box = m_pdata->getGlobalBox();
     // set box dimensions
     Scalar a,b,c,alpha,beta,gamma;
     Scalar3 va = box.getLatticeVector(0);
@@ -341,86 +393,50 @@ void DCDDumpWriter::write_frame_header(std::fstream &file)
     // check for errors
     if (!file.good())
         {
-        m_exec_conf->msg->error() << "dump.dcd: I/O rrror while writing DCD frame header" << endl;
-        throw runtime_error("Error writing DCD file");
+        throw runtime_error("dump.dcd: I/O error while writing DCD frame header");
         }
     }
 
-/*! \param file File to write to
-    \param snapshot Snapshot to write
-    Writes the actual particle positions for all particles at the current time step
+/*! \param frame Frame to convert. On output, holds the coordinates of the group members in the order of the group.
+    Unwraps the particle coordinates as requested and converts them to the single precision used in the file. The
+    snapshot is released afterwards.
 */
-void DCDDumpWriter::write_frame_data(std::fstream &file, const SnapshotParticleData& snapshot)
+void DCDDumpWriter::fill_frame(Frame& frame)
     {
-    // we need to unsort the positions and write in tag order
-    assert(m_staging_buffer);
+    const SnapshotParticleData& snapshot = *frame.snapshot;
+    const BoxDim& box = frame.box;
 
-#ifdef ENABLE_MPI
-    if (m_comm && m_unwrap_rigid)
-        {
-        m_exec_conf->msg->error() << "dump.dcd: Unwrap of rigid bodies in DCD files is currently not supported in MPI simulations" << endl;
-        throw runtime_error("Error writing DCD file");
-        }
-#endif
-
-    ArrayHandle<int3> body_image_handle(m_rigid_data->getBodyImage(),access_location::host,access_mode::read);
-    BoxDim box = m_pdata->getGlobalBox();
-
-    unsigned int nparticles = m_group->getNumMembersGlobal();
+    unsigned int nparticles = (unsigned int)frame.members.size();
+    frame.x.resize(nparticles);
+    frame.y.resize(nparticles);
+    frame.z.resize(nparticles);
 
-    // Create a tmp copy of the particle data and unwrap particles
-    std::vector<Scalar3> tmp_pos(snapshot.pos);
+    // unwrap the particles and write them in the order of the group
     for (unsigned int group_idx = 0; group_idx < nparticles; group_idx++)
         {
-        unsigned int i = m_group->getMemberTag(group_idx);
+        unsigned int i = frame.members[group_idx];
+        Scalar3 pos = snapshot.pos[i];
 
         if (m_unwrap_full)
             {
-            tmp_pos[i] = box.shift(tmp_pos[i], snapshot.image[i]);
+            pos = box.shift(pos, snapshot.image[i]);
             }
         else if (m_unwrap_rigid && snapshot.body[i] != NO_BODY)
             {
-            int body_ix = body_image_handle.data[snapshot.body[i]].x;
-            int body_iy = body_image_handle.data[snapshot.body[i]].y;
-            int body_iz = body_image_handle.data[snapshot.body[i]].z;
+            int body_ix = frame.body_image[snapshot.body[i]].x;
+            int body_iy = frame.body_image[snapshot.body[i]].y;
+            int body_iz = frame.body_image[snapshot.body[i]].z;
             int3 particle_img = snapshot.image[i];
             int3 img_diff = make_int3(particle_img.x - body_ix,
                                       particle_img.y - body_iy,
                                       particle_img.z - body_iz);
 
-            tmp_pos[i] = box.shift(tmp_pos[i], img_diff);
+            pos = box.shift(pos, img_diff);
             }
-        }
 
-    // prepare x coords for writing, looping in tag order
-    for (unsigned int group_idx = 0; group_idx < nparticles; group_idx++)
-        {
-        unsigned int i = m_group->getMemberTag(group_idx);
-        m_staging_buffer[group_idx] = float(tmp_pos[i].x);
-        }
-
-    // write x coords
-    write_int(file, nparticles * sizeof(float));
-    file.write((char *)m_staging_buffer, nparticles * sizeof(float));
-    write_int(file, nparticles * sizeof(float));
-
-    // prepare y coords for writing
-    for (unsigned int group_idx = 0; group_idx < nparticles; group_idx++)
-        {
-        unsigned int i = m_group->getMemberTag(group_idx);
-        m_staging_buffer[group_idx] = float(tmp_pos[i].y);
-        }
-
-    // write y coords
-    write_int(file, nparticles * sizeof(float));
-    file.write((char *)m_staging_buffer, nparticles * sizeof(float));
-    write_int(file, nparticles * sizeof(float));
-
-    // prepare z coords for writing
-    for (unsigned int group_idx = 0; group_idx < nparticles; group_idx++)
-        {
-        unsigned int i = m_group->getMemberTag(group_idx);
-        m_staging_buffer[group_idx] = float(tmp_pos[i].z);
+        frame.x[group_idx] = float(pos.x);
+        frame.y[group_idx] = float(pos.y);
+        frame.z[group_idx] = float(pos.z);
 
         // m_angle set to True turns on a hack where the particle orientation angle is written out to the z component
         // this only works in 2D simulations, obviously
@@ -430,20 +446,43 @@ void DCDDumpWriter::write_frame_data(std::fstream &file, const SnapshotParticleD
             if (snapshot.orientation[i].w < 0)
                 s = -1;
 
-            m_staging_buffer[group_idx] = acosf(snapshot.orientation[i].x) * 2 * s;
+            frame.z[group_idx] = acosf(snapshot.orientation[i].x) * 2 * s;
             }
         }
 
+    frame.snapshot.reset();
+    }
+
+/*! \param file File to write to
+    \param frame Frame to write
+    Writes the actual particle positions for all particles at the current time step
+*/
+void DCDDumpWriter::write_frame_data(std::fstream &file, const Frame& frame)
+    {
+    unsigned int nparticles = frame.x.size();
+
+    // write x coords
+    write_int(file, nparticles * sizeof(float));
+    if (nparticles > 0)
+        file.write((const char *)&frame.x[0], nparticles * sizeof(float));
+    write_int(file, nparticles * sizeof(float));
+
+    // write y coords
+    write_int(file, nparticles * sizeof(float));
+    if (nparticles > 0)
+        file.write((const char *)&frame.y[0], nparticles * sizeof(float));
+    write_int(file, nparticles * sizeof(float));
+
     // write z coords
     write_int(file, nparticles * sizeof(float));
-    file.write((char *)m_staging_buffer, nparticles * sizeof(float));
+    if (nparticles > 0)
+        file.write((const char *)&frame.z[0], nparticles * sizeof(float));
     write_int(file, nparticles * sizeof(float));
 
     // check for errors
     if (!file.good())
         {
-        m_exec_conf->msg->error() << "I/O error while writing DCD frame data" << endl;
-        throw runtime_error("Error writing DCD file");
+        throw runtime_error("dump.dcd: I/O error while writing DCD frame data");
         }
     }
 
@@ -53,6 +53,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #define __DCDDUMPWRITER_H__
 
 #include <string>
+#include <vector>
 #include <boost/shared_ptr.hpp>
 #include <fstream>
 #include "Analyzer.h"
@@ -106,6 +107,9 @@ class DCDDumpWriter : public Analyzer
         //! Write out the data for the current timestep
         void analyze(unsigned int timestep);
 
+        //! Sample the current coordinates and return a function that converts and writes them out
+        virtual boost::function<void ()> prepareAnalysis(unsigned int timestep);
+
         //! Set whether coordinates should be written out wrapped or unwrapped.
         void setUnwrapFull(bool enable)
             {
@@ -131,6 +135,7 @@ class DCDDumpWriter : public Analyzer
         boost::shared_ptr<ParticleGroup> m_group; //!< Group of particles to write to the DCD file
         boost::shared_ptr<RigidData> m_rigid_data; //!< For accessing rigid body data
         unsigned int m_num_frames_written;  //!< Count the number of frames written to the file
+        unsigned int m_num_frames_queued;   //!< Count the number of frames handed out by prepareAnalysis()
         unsigned int m_last_written_step;   //!< Last timestep written in a a file we are appending to
         bool m_appending;                   //!< True if this instance is appending to an existing DCD file
         bool m_unwrap_full;                 //!< True if coordinates should be written out fully unwrapped in the box
@@ -140,16 +145,30 @@ class DCDDumpWriter : public Analyzer
         bool m_overwrite;                   //!< True if file should be overwritten
         bool m_is_initialized;              //!< True if file IO has been initialized
 
-        float *m_staging_buffer;            //!< Buffer for staging particle positions in tag order
+        //! One frame: the sampled data and the coordinates converted from it
+        struct Frame
+            {
+            BoxDim box;                     //!< Box of the frame
+            boost::shared_ptr<SnapshotParticleData> snapshot; //!< Snapshot the coordinates are converted from
+            std::vector<unsigned int> members;  //!< Tags of the group members
+            std::vector<int3> body_image;   //!< Images of the rigid bodies (only when unwrapping rigid bodies)
+            std::vector<float> x;           //!< x coordinates of the group members
+            std::vector<float> y;           //!< y coordinates of the group members
+            std::vector<float> z;           //!< z coordinates (or angles) of the group members
+            };
 
         // helper functions
 
+        //! Converts the particle coordinates of the snapshot of a frame
+        void fill_frame(Frame& frame);
+        //! Writes a frame to the file
+        void write_frame(unsigned int timestep, boost::shared_ptr<Frame> frame);
         //! Initalizes the file header
-        void write_file_header(std::fstream &file);
+        void write_file_header(std::fstream &file, unsigned int nparticles);
         //! Writes the frame header
-        void write_frame_header(std::fstream &file);
+        void write_frame_header(std::fstream &file, const BoxDim& box);
         //! Writes the particle positions for a frame
-        void write_frame_data(std::fstream &file, const SnapshotParticleData& snapshot);
+        void write_frame_data(std::fstream &file, const Frame& frame);
         //! Updates the file header
         void write_updated_header(std::fstream &file, unsigned int timestep);
         //! Initializes the output file for writing
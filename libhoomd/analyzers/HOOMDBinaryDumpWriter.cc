@@ -69,11 +69,9 @@ using namespace boost::python;
 
 #include <boost/iostreams/device/file.hpp>
 #include <boost/iostreams/filtering_stream.hpp>
-#ifdef ENABLE_ZLIB
-#include <boost/iostreams/filter/gzip.hpp>
-#endif
 
 #include "HOOMDBinaryDumpWriter.h"
+#include "ParallelGzipSink.h"
 #include "BondedGroupData.h"
 #include "WallData.h"
 
@@ -128,15 +126,24 @@ void HOOMDBinaryDumpWriter::writeFile(std::string fname, unsigned int timestep)
         m_exec_conf->msg->warning() << "init.read_bin will not recognize that this file is uncompressed" << endl;
         }
 
-    // setup the file output for compression
+    // setup the file output, compressing blocks on worker threads if requested
     filtering_ostream f;
     #ifdef ENABLE_ZLIB
+    boost::shared_ptr<ParallelGzipSink> gz_sink;
     if (m_enable_compression)
-        f.push(gzip_compressor());
+        {
+        // the worker threads are started with the first compressed file and kept for all later ones
+        if (!m_gzip_pool)
+            m_gzip_pool = boost::shared_ptr<GzipWorkerPool>(new GzipWorkerPool());
+        gz_sink = boost::shared_ptr<ParallelGzipSink>(new ParallelGzipSink(fname, m_gzip_pool));
+        if (gz_sink->is_open())
+            f.push(*gz_sink);
+        }
+    else
     #endif
-    f.push(file_sink(fname.c_str(), ios::out | ios::binary));
+        f.push(file_sink(fname.c_str(), ios::out | ios::binary));
 
-    if (!f.good())
+    if (!f.is_complete() || !f.good())
         {
         m_exec_conf->msg->error() << "dump.bin: Unable to open dump file for writing: " << fname << endl;
         throw runtime_error("Error writing hoomd binary dump file");
@@ -429,6 +436,15 @@ void HOOMDBinaryDumpWriter::writeFile(std::string fname, unsigned int timestep)
         throw runtime_error("Error writing HOOMD dump file");
         }
 
+    // close the stream to write out the last compressed blocks
+    f.reset();
+    #ifdef ENABLE_ZLIB
+    if (gz_sink && gz_sink->failed())
+        {
+        m_exec_conf->msg->error() << "dump.bin: I/O error writing HOOMD dump file" << endl;
+        throw runtime_error("Error writing HOOMD dump file");
+        }
+    #endif
     }
 
 /*! \param timestep Current time step of the simulation
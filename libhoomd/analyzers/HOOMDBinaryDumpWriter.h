@@ -64,6 +64,8 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Analyzer.h"
 #include "BondedGroupData.h"
 
+class GzipWorkerPool;
+
 #ifndef __HOOMD_BINARY_DUMP_WRITER_H__
 #define __HOOMD_BINARY_DUMP_WRITER_H__
 
@@ -114,6 +116,7 @@ class HOOMDBinaryDumpWriter : public Analyzer
         bool m_alternating;         //!< True if we are to write to m_fname1 and m_fname in an alternating fasion
         unsigned int m_cur_file;    //!< Current index of the file we are writing to (1 or 2)
         bool m_enable_compression;  //!< True if gzip compression should be enabled
+        boost::shared_ptr<GzipWorkerPool> m_gzip_pool; //!< Compression threads (ENABLE_ZLIB only)
         };
 
 //! Exports the HOOMDBinaryDumpWriter class to python
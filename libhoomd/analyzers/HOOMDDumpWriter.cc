@@ -66,8 +66,13 @@ using namespace boost::python;
 #include <stdexcept>
 #include <iomanip>
 #include <boost/shared_ptr.hpp>
+#include <boost/bind.hpp>
+
+#include <boost/iostreams/device/file.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
 
 #include "HOOMDDumpWriter.h"
+#include "ParallelGzipSink.h"
 #include "BondedGroupData.h"
 #include "WallData.h"
 
@@ -77,6 +82,7 @@ using namespace boost::python;
 
 using namespace std;
 using namespace boost;
+using namespace boost::iostreams;
 
 /*! \param sysdef SystemDefinition containing the ParticleData to dump
     \param base_fname The base name of the file xml file to output the information
@@ -203,44 +209,123 @@ void HOOMDDumpWriter::setOutputMomentInertia(bool enable)
     m_output_moment_inertia = enable;
     }
 
-/*! \param fname File name to write
-    \param timestep Current time step of the simulation
+//! Helper function to copy the type names of bonded groups into their snapshot
+/*! \param data Bonded group data to get the names from
+    \param snapshot Snapshot to fill in
 */
-void HOOMDDumpWriter::writeFile(std::string fname, unsigned int timestep)
+template<class T> static void copy_type_mapping(const T& data, typename T::Snapshot& snapshot)
     {
-    // acquire the particle data
-    SnapshotParticleData snapshot(m_pdata->getNGlobal());
+    snapshot.type_mapping.resize(data.getNTypes());
+    for (unsigned int i = 0; i < data.getNTypes(); i++)
+        snapshot.type_mapping[i] = data.getNameByType(i);
+    }
 
+/*! \returns A frame with all the data that is requested for output, or a null pointer on ranks that do not write
+*/
+boost::shared_ptr<HOOMDDumpWriter::Frame> HOOMDDumpWriter::takeFrame()
+    {
+    boost::shared_ptr<Frame> frame(new Frame);
+
+    // acquire the particle data
+    SnapshotParticleData& snapshot = frame->particles;
+    snapshot.resize(m_pdata->getNGlobal());
     m_pdata->takeSnapshot(snapshot);
 
-    BondData::Snapshot bdata_snapshot(m_sysdef->getBondData()->getNGlobal());
-    if (m_output_bond) m_sysdef->getBondData()->takeSnapshot(bdata_snapshot);
+    if (m_output_bond)
+        {
+        m_sysdef->getBondData()->takeSnapshot(frame->bonds);
+        copy_type_mapping(*m_sysdef->getBondData(), frame->bonds);
+        }
 
-    AngleData::Snapshot adata_snapshot(m_sysdef->getAngleData()->getNGlobal());
-    if (m_output_angle) m_sysdef->getAngleData()->takeSnapshot(adata_snapshot);
+    if (m_output_angle)
+        {
+        m_sysdef->getAngleData()->takeSnapshot(frame->angles);
+        copy_type_mapping(*m_sysdef->getAngleData(), frame->angles);
+        }
 
-    DihedralData::Snapshot ddata_snapshot(m_sysdef->getDihedralData()->getNGlobal());
-    if (m_output_dihedral) m_sysdef->getDihedralData()->takeSnapshot(ddata_snapshot);
+    if (m_output_dihedral)
+        {
+        m_sysdef->getDihedralData()->takeSnapshot(frame->dihedrals);
+        copy_type_mapping(*m_sysdef->getDihedralData(), frame->dihedrals);
+        }
 
-    ImproperData::Snapshot idata_snapshot(m_sysdef->getImproperData()->getNGlobal());
-    if (m_output_improper) m_sysdef->getImproperData()->takeSnapshot(idata_snapshot);
+    if (m_output_improper)
+        {
+        m_sysdef->getImproperData()->takeSnapshot(frame->impropers);
+        copy_type_mapping(*m_sysdef->getImproperData(), frame->impropers);
+        }
 
 #ifdef ENABLE_MPI
     // only the root processor writes the output file
     if (m_pdata->getDomainDecomposition() && ! m_exec_conf->isRoot())
-        return;
+        return boost::shared_ptr<Frame>();
 #endif
 
-    // open the file for writing
-    ofstream f(fname.c_str());
+    if (m_output_wall)
+        {
+        boost::shared_ptr<WallData> wall_data = m_sysdef->getWallData();
+        for (unsigned int i = 0; i < wall_data->getNumWalls(); i++)
+            frame->walls.push_back(wall_data->getWall(i));
+        }
 
-    if (!f.good())
+    frame->box = m_pdata->getGlobalBox();
+    frame->dimensions = m_sysdef->getNDimensions();
+    return frame;
+    }
+
+/*! \param fname File name to write
+    \param timestep Current time step of the simulation
+*/
+void HOOMDDumpWriter::writeFile(std::string fname, unsigned int timestep)
+    {
+    #ifndef ENABLE_ZLIB
+    if (fname.size() > 3 && fname.substr(fname.size()-3) == string(".gz"))
+        m_exec_conf->msg->warning() << "dump.xml: This build of hoomd was compiled with ENABLE_ZLIB=off, "
+                                    << fname << " will NOT be compressed" << endl;
+    #endif
+
+    boost::shared_ptr<Frame> frame = takeFrame();
+    if (frame)
+        writeFrame(fname, timestep, frame);
+    }
+
+/*! \param fname File name to write
+    \param timestep Time step of the frame
+    \param frame Frame to write
+
+    Only the data in \a frame and the output settings are used, so this can run on another thread. Errors are
+    reported by throwing, the messenger is not used here.
+*/
+void HOOMDDumpWriter::writeFrame(const std::string& fname, unsigned int timestep, boost::shared_ptr<const Frame> frame)
+    {
+    const SnapshotParticleData& snapshot = frame->particles;
+
+    // open the file for writing, file names ending in .gz are compressed on worker threads
+    filtering_ostream f;
+    #ifdef ENABLE_ZLIB
+    bool gz_ext = fname.size() > 3 && fname.substr(fname.size()-3) == string(".gz");
+    boost::shared_ptr<ParallelGzipSink> gz_sink;
+    if (gz_ext)
         {
-        m_exec_conf->msg->error() << "dump.xml: Unable to open dump file for writing: " << fname << endl;
-        throw runtime_error("Error writting hoomd_xml dump file");
+        // the worker threads are started with the first compressed file and kept for all later ones
+        if (!m_gzip_pool)
+            m_gzip_pool = boost::shared_ptr<GzipWorkerPool>(new GzipWorkerPool());
+        gz_sink = boost::shared_ptr<ParallelGzipSink>(new ParallelGzipSink(fname, m_gzip_pool));
+        if (gz_sink->is_open())
+            f.push(*gz_sink);
+        }
+    else
+    #endif
+        {
+        f.push(file_sink(fname.c_str()));
         }
 
-    BoxDim box = m_pdata->getGlobalBox();
+    if (!f.is_complete() || !f.good())
+        {
+        throw runtime_error("dump.xml: Unable to open dump file for writing: " + fname);
+        }
+
+    const BoxDim& box = frame->box;
     Scalar3 L = box.getL();
     Scalar xy = box.getTiltFactorXY();
     Scalar xz = box.getTiltFactorXZ();
@@ -250,8 +335,8 @@ void HOOMDDumpWriter::writeFile(std::string fname, unsigned int timestep)
     f << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>" << "\n";
     f << "<hoomd_xml version=\"1.5\">" << "\n";
     f << "<configuration time_step=\"" << timestep << "\" "
-      << "dimensions=\"" << m_sysdef->getNDimensions() << "\" "
-      << "natoms=\"" << m_pdata->getNGlobal() << "\" ";
+      << "dimensions=\"" << frame->dimensions << "\" "
+      << "natoms=\"" << snapshot.size << "\" ";
     if (m_vizsigma_set)
         f << "vizsigma=\"" << m_vizsigma << "\" ";
     f << ">" << "\n";
@@ -263,8 +348,8 @@ void HOOMDDumpWriter::writeFile(std::string fname, unsigned int timestep)
     // If the position flag is true output the position of all particles to the file
     if (m_output_position)
         {
-        f << "<position num=\"" << m_pdata->getNGlobal() << "\">" << "\n";
-        for (unsigned int j = 0; j < m_pdata->getNGlobal(); j++)
+        f << "<position num=\"" << snapshot.size << "\">" << "\n";
+        for (unsigned int j = 0; j < snapshot.size; j++)
             {
             Scalar3 pos = snapshot.pos[j];
 
@@ -272,8 +357,7 @@ void HOOMDDumpWriter::writeFile(std::string fname, unsigned int timestep)
 
             if (!f.good())
                 {
-                m_exec_conf->msg->error() << "dump.xml: I/O error while writing HOOMD dump file" << endl;
-                throw runtime_error("Error writting HOOMD dump file");
+                throw runtime_error("dump.xml: I/O error while writing HOOMD dump file");
                 }
             }
         f <<"</position>" << "\n";
@@ -282,8 +366,8 @@ void HOOMDDumpWriter::writeFile(std::string fname, unsigned int timestep)
     // If the image flag is true, output the image of each particle to the file
     if (m_output_image)
         {
-        f << "<image num=\"" << m_pdata->getNGlobal() << "\">" << "\n";
-        for (unsigned int j = 0; j < m_pdata->getNGlobal(); j++)
+        f << "<image num=\"" << snapshot.size << "\">" << "\n";
+        for (unsigned int j = 0; j < snapshot.size; j++)
             {
             int3 image = snapshot.image[j];
 
@@ -291,8 +375,7 @@ void HOOMDDumpWriter::writeFile(std::string fname, unsigned int timestep)
 
             if (!f.good())
                 {
-                m_exec_conf->msg->error() << "dump.xml: I/O error while writing HOOMD dump file" << endl;
-                throw runtime_error("Error writting HOOMD dump file");
+                throw runtime_error("dump.xml: I/O error while writing HOOMD dump file");
                 }
             }
         f <<"</image>" << "\n";
@@ -301,16 +384,15 @@ void HOOMDDumpWriter::writeFile(std::string fname, unsigned int timestep)
     // If the velocity flag is true output the velocity of all particles to the file
     if (m_output_velocity)
         {
-        f <<"<velocity num=\"" << m_pdata->getNGlobal() << "\">" << "\n";
+        f <<"<velocity num=\"" << snapshot.size << "\">" << "\n";
 
-        for (unsigned int j = 0; j < m_pdata->getNGlobal(); j++)
+        for (unsigned int j = 0; j < snapshot.size; j++)
             {
             Scalar3 vel = snapshot.vel[j];
             f << vel.x << " " << vel.y << " " << vel.z << "\n";
             if (!f.good())
                 {
-                m_exec_conf->msg->error() << "dump.xml: I/O error while writing HOOMD dump file" << endl;
-                throw runtime_error("Error writting HOOMD dump file");
+                throw runtime_error("dump.xml: I/O error while writing HOOMD dump file");
                 }
             }
 
@@ -320,17 +402,16 @@ void HOOMDDumpWriter::writeFile(std::string fname, unsigned int timestep)
     // If the velocity flag is true output the velocity of all particles to the file
     if (m_output_accel)
         {
-        f <<"<acceleration num=\"" << m_pdata->getNGlobal() << "\">" << "\n";
+        f <<"<acceleration num=\"" << snapshot.size << "\">" << "\n";
 
-        for (unsigned int j = 0; j < m_pdata->getNGlobal(); j++)
+        for (unsigned int j = 0; j < snapshot.size; j++)
             {
             Scalar3 accel = snapshot.accel[j];
 
             f << accel.x << " " << accel.y << " " << accel.z << "\n";
             if (!f.good())
                 {
-                m_exec_conf->msg->error() << "dump.xml: I/O error while writing HOOMD dump file" << endl;
-                throw runtime_error("Error writting HOOMD dump file");
+                throw runtime_error("dump.xml: I/O error while writing HOOMD dump file");
                 }
             }
 
@@ -340,17 +421,16 @@ void HOOMDDumpWriter::writeFile(std::string fname, unsigned int timestep)
     // If the mass flag is true output the mass of all particles to the file
     if (m_output_mass)
         {
-        f <<"<mass num=\"" << m_pdata->getNGlobal() << "\">" << "\n";
+        f <<"<mass num=\"" << snapshot.size << "\">" << "\n";
 
-        for (unsigned int j = 0; j < m_pdata->getNGlobal(); j++)
+        for (unsigned int j = 0; j < snapshot.size; j++)
             {
             Scalar mass = snapshot.mass[j];
 
             f << mass << "\n";
             if (!f.good())
                 {
-                m_exec_conf->msg->error() << "dump.xml: I/O error while writing HOOMD dump file" << endl;
-                throw runtime_error("Error writting HOOMD dump file");
+                throw runtime_error("dump.xml: I/O error while writing HOOMD dump file");
                 }
             }
 
@@ -360,16 +440,15 @@ void HOOMDDumpWriter::writeFile(std::string fname, unsigned int timestep)
     // If the diameter flag is true output the mass of all particles to the file
     if (m_output_diameter)
         {
-        f <<"<diameter num=\"" << m_pdata->getNGlobal() << "\">" << "\n";
+        f <<"<diameter num=\"" << snapshot.size << "\">" << "\n";
 
-        for (unsigned int j = 0; j < m_pdata->getNGlobal(); j++)
+        for (unsigned int j = 0; j < snapshot.size; j++)
             {
             Scalar diameter = snapshot.diameter[j];
             f << diameter << "\n";
             if (!f.good())
                 {
-                m_exec_conf->msg->error() << "dump.xml: I/O error while writing HOOMD dump file" << endl;
-                throw runtime_error("Error writting HOOMD dump file");
+                throw runtime_error("dump.xml: I/O error while writing HOOMD dump file");
                 }
             }
 
@@ -379,11 +458,11 @@ void HOOMDDumpWriter::writeFile(std::string fname, unsigned int timestep)
     // If the Type flag is true output the types of all particles to an xml file
     if  (m_output_type)
         {
-        f <<"<type num=\"" << m_pdata->getNGlobal() << "\">" << "\n";
-        for (unsigned int j = 0; j < m_pdata->getNGlobal(); j++)
+        f <<"<type num=\"" << snapshot.size << "\">" << "\n";
+        for (unsigned int j = 0; j < snapshot.size; j++)
             {
             unsigned int type = snapshot.type[j];
-            f << m_pdata->getNameByType(type) << "\n";
+            f << snapshot.type_mapping[type] << "\n";
             }
         f <<"</type>" << "\n";
         }
@@ -391,8 +470,8 @@ void HOOMDDumpWriter::writeFile(std::string fname, unsigned int timestep)
     // If the body flag is true output the bodies of all particles to an xml file
     if  (m_output_body)
         {
-        f <<"<body num=\"" << m_pdata->getNGlobal() << "\">" << "\n";
-        for (unsigned int j = 0; j < m_pdata->getNGlobal(); j++)
+        f <<"<body num=\"" << snapshot.size << "\">" << "\n";
+        for (unsigned int j = 0; j < snapshot.size; j++)
             {
             unsigned int body;
             int out;
@@ -410,15 +489,14 @@ void HOOMDDumpWriter::writeFile(std::string fname, unsigned int timestep)
     // if the bond flag is true, output the bonds to the xml file
     if (m_output_bond)
         {
-        f << "<bond num=\"" << bdata_snapshot.groups.size() << "\">" << "\n";
-        boost::shared_ptr<BondData> bond_data = m_sysdef->getBondData();
+        f << "<bond num=\"" << frame->bonds.groups.size() << "\">" << "\n";
 
         // loop over all bonds and write them out
-        for (unsigned int i = 0; i < bdata_snapshot.groups.size(); i++)
+        for (unsigned int i = 0; i < frame->bonds.groups.size(); i++)
             {
-            BondData::members_t bond = bdata_snapshot.groups[i];
-            unsigned int bond_type = bdata_snapshot.type_id[i];
-            f << bond_data->getNameByType(bond_type) << " " << bond.tag[0] << " " << bond.tag[1] << "\n";
+            BondData::members_t bond = frame->bonds.groups[i];
+            unsigned int bond_type = frame->bonds.type_id[i];
+            f << frame->bonds.type_mapping[bond_type] << " " << bond.tag[0] << " " << bond.tag[1] << "\n";
             }
 
         f << "</bond>" << "\n";
@@ -427,15 +505,14 @@ void HOOMDDumpWriter::writeFile(std::string fname, unsigned int timestep)
     // if the angle flag is true, output the angles to the xml file
     if (m_output_angle)
         {
-        f << "<angle num=\"" << adata_snapshot.groups.size() << "\">" << "\n";
-        boost::shared_ptr<AngleData> angle_data = m_sysdef->getAngleData();
+        f << "<angle num=\"" << frame->angles.groups.size() << "\">" << "\n";
 
         // loop over all angles and write them out
-        for (unsigned int i = 0; i < adata_snapshot.groups.size(); i++)
+        for (unsigned int i = 0; i < frame->angles.groups.size(); i++)
             {
-            AngleData::members_t angle = adata_snapshot.groups[i];
-            unsigned int angle_type = adata_snapshot.type_id[i];
-            f << angle_data->getNameByType(angle_type) << " " << angle.tag[0]  << " " << angle.tag[1] << " " << angle.tag[2] << "\n";
+            AngleData::members_t angle = frame->angles.groups[i];
+            unsigned int angle_type = frame->angles.type_id[i];
+            f << frame->angles.type_mapping[angle_type] << " " << angle.tag[0]  << " " << angle.tag[1] << " " << angle.tag[2] << "\n";
             }
 
         f << "</angle>" << "\n";
@@ -444,15 +521,14 @@ void HOOMDDumpWriter::writeFile(std::string fname, unsigned int timestep)
     // if dihedral is true, write out dihedrals to the xml file
     if (m_output_dihedral)
         {
-        f << "<dihedral num=\"" << ddata_snapshot.groups.size() << "\">" << "\n";
-        boost::shared_ptr<DihedralData> dihedral_data = m_sysdef->getDihedralData();
+        f << "<dihedral num=\"" << frame->dihedrals.groups.size() << "\">" << "\n";
 
         // loop over all angles and write them out
-        for (unsigned int i = 0; i < ddata_snapshot.groups.size(); i++)
+        for (unsigned int i = 0; i < frame->dihedrals.groups.size(); i++)
             {
-            DihedralData::members_t dihedral = ddata_snapshot.groups[i];
-            unsigned int dihedral_type = ddata_snapshot.type_id[i];
-            f << dihedral_data->getNameByType(dihedral_type) << " " << dihedral.tag[0]  << " " << dihedral.tag[1] << " "
+            DihedralData::members_t dihedral = frame->dihedrals.groups[i];
+            unsigned int dihedral_type = frame->dihedrals.type_id[i];
+            f << frame->dihedrals.type_mapping[dihedral_type] << " " << dihedral.tag[0]  << " " << dihedral.tag[1] << " "
             << dihedral.tag[2] << " " << dihedral.tag[3] << "\n";
             }
 
@@ -462,15 +538,14 @@ void HOOMDDumpWriter::writeFile(std::string fname, unsigned int timestep)
     // if improper is true, write out impropers to the xml file
     if (m_output_improper)
         {
-        f << "<improper num=\"" << idata_snapshot.groups.size() << "\">" << "\n";
-        boost::shared_ptr<ImproperData> improper_data = m_sysdef->getImproperData();
+        f << "<improper num=\"" << frame->impropers.groups.size() << "\">" << "\n";
 
         // loop over all angles and write them out
-        for (unsigned int i = 0; i < idata_snapshot.groups.size(); i++)
+        for (unsigned int i = 0; i < frame->impropers.groups.size(); i++)
             {
-            ImproperData::members_t improper = idata_snapshot.groups[i];
-            unsigned int improper_type = idata_snapshot.type_id[i];
-            f << improper_data->getNameByType(improper_type) << " " << improper.tag[0]  << " " << improper.tag[1] << " "
+            ImproperData::members_t improper = frame->impropers.groups[i];
+            unsigned int improper_type = frame->impropers.type_id[i];
+            f << frame->impropers.type_mapping[improper_type] << " " << improper.tag[0]  << " " << improper.tag[1] << " "
             << improper.tag[2] << " " << improper.tag[3] << "\n";
             }
 
@@ -481,12 +556,10 @@ void HOOMDDumpWriter::writeFile(std::string fname, unsigned int timestep)
     if (m_output_wall)
         {
         f << "<wall>" << "\n";
-        boost::shared_ptr<WallData> wall_data = m_sysdef->getWallData();
-
         // loop over all walls and write them out
-        for (unsigned int i = 0; i < wall_data->getNumWalls(); i++)
+        for (unsigned int i = 0; i < frame->walls.size(); i++)
             {
-            Wall wall = wall_data->getWall(i);
+            const Wall& wall = frame->walls[i];
             f << "<coord ox=\"" << wall.origin_x << "\" oy=\"" << wall.origin_y << "\" oz=\"" << wall.origin_z <<
             "\" nx=\"" << wall.normal_x << "\" ny=\"" << wall.normal_y << "\" nz=\"" << wall.normal_z << "\" />" << "\n";
             }
@@ -496,16 +569,15 @@ void HOOMDDumpWriter::writeFile(std::string fname, unsigned int timestep)
     // If the charge flag is true output the mass of all particles to the file
     if (m_output_charge)
         {
-        f <<"<charge num=\"" << m_pdata->getNGlobal() << "\">" << "\n";
+        f <<"<charge num=\"" << snapshot.size << "\">" << "\n";
 
-        for (unsigned int j = 0; j < m_pdata->getNGlobal(); j++)
+        for (unsigned int j = 0; j < snapshot.size; j++)
             {
             Scalar charge = snapshot.charge[j];
             f << charge << "\n";
             if (!f.good())
                 {
-                m_exec_conf->msg->error() << "dump.xml: I/O error while writing HOOMD dump file" << endl;
-                throw runtime_error("Error writting HOOMD dump file");
+                throw runtime_error("dump.xml: I/O error while writing HOOMD dump file");
                 }
             }
 
@@ -515,17 +587,16 @@ void HOOMDDumpWriter::writeFile(std::string fname, unsigned int timestep)
     // if the orientation flag is set, write out the orientation quaternion to the XML file
     if (m_output_orientation)
         {
-        f << "<orientation num=\"" << m_pdata->getNGlobal() << "\">" << "\n";
+        f << "<orientation num=\"" << snapshot.size << "\">" << "\n";
 
-        for (unsigned int j = 0; j < m_pdata->getNGlobal(); j++)
+        for (unsigned int j = 0; j < snapshot.size; j++)
             {
             // use the rtag data to output the particles in the order they were read in
             Scalar4 orientation = snapshot.orientation[j];
             f << orientation.x << " " << orientation.y << " " << orientation.z << " " << orientation.w << "\n";
             if (!f.good())
                 {
-                m_exec_conf->msg->error() << "dump.xml: I/O error while writing HOOMD dump file" << endl;
-                throw runtime_error("Error writting HOOMD dump file");
+                throw runtime_error("dump.xml: I/O error while writing HOOMD dump file");
                 }
             }
         f << "</orientation>" << "\n";
@@ -534,9 +605,9 @@ void HOOMDDumpWriter::writeFile(std::string fname, unsigned int timestep)
     // if the moment_inertia flag is set, write out the orientation quaternion to the XML file
     if (m_output_moment_inertia)
         {
-        f << "<moment_inertia num=\"" << m_pdata->getNGlobal() << "\">" << "\n";
+        f << "<moment_inertia num=\"" << snapshot.size << "\">" << "\n";
 
-        for (unsigned int i = 0; i < m_pdata->getNGlobal(); i++)
+        for (unsigned int i = 0; i < snapshot.size; i++)
             {
             // inertia tensors are stored by tag
             InertiaTensor I = snapshot.inertia_tensor[i];
@@ -546,8 +617,7 @@ void HOOMDDumpWriter::writeFile(std::string fname, unsigned int timestep)
 
             if (!f.good())
                 {
-                m_exec_conf->msg->error() << "dump.xml: I/O error while writing HOOMD dump file" << endl;
-                throw runtime_error("Error writting HOOMD dump file");
+                throw runtime_error("dump.xml: I/O error while writing HOOMD dump file");
                 }
             }
         f << "</moment_inertia>" << "\n";
@@ -558,11 +628,17 @@ void HOOMDDumpWriter::writeFile(std::string fname, unsigned int timestep)
 
     if (!f.good())
         {
-                m_exec_conf->msg->error() << "dump.xml: I/O error while writing HOOMD dump file" << endl;
-        throw runtime_error("Error writting HOOMD dump file");
+                throw runtime_error("dump.xml: I/O error while writing HOOMD dump file");
         }
 
-    f.close();
+    // close the stream to write out the last compressed blocks
+    f.reset();
+    #ifdef ENABLE_ZLIB
+    if (gz_sink && gz_sink->failed())
+        {
+        throw runtime_error("dump.xml: I/O error while writing HOOMD dump file");
+        }
+    #endif
 
     }
 
@@ -570,6 +646,18 @@ void HOOMDDumpWriter::writeFile(std::string fname, unsigned int timestep)
     Writes a snapshot of the current state of the ParticleData to a hoomd_xml file.
 */
 void HOOMDDumpWriter::analyze(unsigned int timestep)
+    {
+    boost::function<void ()> write = prepareAnalysis(timestep);
+    if (write)
+        write();
+    }
+
+/*! \param timestep Current time step of the simulation
+    \returns A function that writes the file
+
+    Only the snapshots are taken here, the file is formatted and written by the returned function.
+*/
+boost::function<void ()> HOOMDDumpWriter::prepareAnalysis(unsigned int timestep)
     {
     if (m_prof)
         m_prof->push("Dump XML");
@@ -579,10 +667,15 @@ void HOOMDDumpWriter::analyze(unsigned int timestep)
 
     // Generate a filename with the timestep padded to ten zeros
     full_fname << m_base_fname << "." << setfill('0') << setw(10) << timestep << filetype;
-    writeFile(full_fname.str(), timestep);
+    boost::shared_ptr<Frame> frame = takeFrame();
 
     if (m_prof)
         m_prof->pop();
+
+    if (!frame)
+        return boost::function<void ()>();
+    return boost::bind(&HOOMDDumpWriter::writeFrame, this, full_fname.str(), timestep,
+                       boost::shared_ptr<const Frame>(frame));
     }
 
 void export_HOOMDDumpWriter()
@@ -63,6 +63,8 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "Analyzer.h"
 
+class GzipWorkerPool;
+
 #ifndef __HOOMD_DUMP_WRITER_H__
 #define __HOOMD_DUMP_WRITER_H__
 
@@ -100,6 +102,10 @@ class HOOMDDumpWriter : public Analyzer
 
         //! Write out the data for the current timestep
         void analyze(unsigned int timestep);
+
+        //! Take the snapshots and return a function that writes them out
+        virtual boost::function<void ()> prepareAnalysis(unsigned int timestep);
+
         //! Enables/disables the writing of the particle positions
         void setOutputPosition(bool enable);
         //! Enables/disables the writing of particle images
@@ -161,6 +167,25 @@ class HOOMDDumpWriter : public Analyzer
         bool m_output_moment_inertia;  //!< true if moment_inertia should be written
         Scalar m_vizsigma;          //!< vizsigma value to write out to xml files
         bool m_vizsigma_set;        //!< true if vizsigma has been set
+        boost::shared_ptr<GzipWorkerPool> m_gzip_pool; //!< Compression threads for .gz files (ENABLE_ZLIB only)
+
+        //! All data written to one file
+        struct Frame
+            {
+            BoxDim box;                         //!< Box of the frame
+            unsigned int dimensions;            //!< Number of dimensions
+            SnapshotParticleData particles;     //!< Particle data
+            BondData::Snapshot bonds;           //!< Bonds, with their type names (if written)
+            AngleData::Snapshot angles;         //!< Angles, with their type names (if written)
+            DihedralData::Snapshot dihedrals;   //!< Dihedrals, with their type names (if written)
+            ImproperData::Snapshot impropers;   //!< Impropers, with their type names (if written)
+            std::vector<Wall> walls;            //!< Walls (if written)
+            };
+
+        //! Take the snapshots of the current state
+        boost::shared_ptr<Frame> takeFrame();
+        //! Write a frame to a file
+        void writeFrame(const std::string& fname, unsigned int timestep, boost::shared_ptr<const Frame> frame);
         };
 
 //! Exports the HOOMDDumpWriter class to python
@@ -0,0 +1,552 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+/*! \file HOOMDIndexedDumpWriter.cc
+    \brief Defines the HOOMDIndexedDumpWriter class
+*/
+
+#ifdef WIN32
+#pragma warning( push )
+#pragma warning( disable : 4244 )
+#endif
+
+#include <boost/python.hpp>
+using namespace boost::python;
+
+#include <fstream>
+#include <stdexcept>
+#include <cstring>
+
+#include <boost/filesystem.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#ifdef ENABLE_ZLIB
+#include <zlib.h>
+#endif
+
+#include "HOOMDIndexedDumpWriter.h"
+#include "SnapshotSystemData.h"
+
+using namespace std;
+using namespace boost;
+
+//! Element type used to store Scalar values
+static const IndexedElementType scalar_elem_type = (sizeof(Scalar) == 4) ? indexed_float32 : indexed_float64;
+
+//! Size in bytes of a single element of the given type
+static unsigned int elem_size(IndexedElementType type)
+    {
+    if (type == indexed_uint8)
+        return 1;
+    else if (type == indexed_float64)
+        return 8;
+    else
+        return 4;
+    }
+
+/*! \param sysdef SystemDefinition containing the data to dump
+    \param fname File name to write
+    \param overwrite If true, an existing file is replaced. If false, new frames are appended to it.
+*/
+HOOMDIndexedDumpWriter::HOOMDIndexedDumpWriter(boost::shared_ptr<SystemDefinition> sysdef,
+                                               const std::string& fname,
+                                               bool overwrite)
+        : Analyzer(sysdef), m_fname(fname), m_enable_compression(true), m_end_offset(0)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing HOOMDIndexedDumpWriter: " << fname << " " << overwrite << endl;
+
+    const char *fields[] = {"position", "velocity", "acceleration", "type", "mass", "charge", "diameter", "image",
+                            "body", "orientation", "moment_inertia", "bond", "angle", "dihedral", "improper",
+                            "integrator"};
+    m_fields.insert(fields, fields + sizeof(fields)/sizeof(fields[0]));
+
+    // only the root rank touches the file
+    if (m_exec_conf->getRank() == 0)
+        openFile(overwrite);
+    }
+
+HOOMDIndexedDumpWriter::~HOOMDIndexedDumpWriter()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying HOOMDIndexedDumpWriter" << endl;
+    }
+
+/*! \param overwrite If true, truncate the file. Otherwise read the frame index of the existing file.
+
+    A file whose footer is missing (because a previous run was killed while writing) is recovered by walking its
+    frames. Anything past the last complete frame is discarded.
+*/
+void HOOMDIndexedDumpWriter::openFile(bool overwrite)
+    {
+    m_frames.clear();
+
+    if (!overwrite && boost::filesystem::exists(m_fname) && boost::filesystem::file_size(m_fname) > 0)
+        {
+        bool complete = false;
+            {
+            iostreams::mapped_file_source file;
+            try
+                {
+                file.open(m_fname);
+                }
+            catch (std::exception& e)
+                {
+                m_exec_conf->msg->error() << "dump.indexed: Unable to open " << m_fname << " for appending: "
+                                          << e.what() << endl;
+                throw runtime_error("Error opening indexed dump file");
+                }
+
+            IndexedFileHeader header;
+            if (file.size() < sizeof(IndexedFileHeader))
+                {
+                m_exec_conf->msg->error() << "dump.indexed: " << m_fname << " is not an indexed file" << endl;
+                throw runtime_error("Error opening indexed dump file");
+                }
+            memcpy(&header, file.data(), sizeof(IndexedFileHeader));
+            if (memcmp(header.magic, INDEXED_FILE_MAGIC, 8) != 0 || header.version != INDEXED_FORMAT_VERSION)
+                {
+                m_exec_conf->msg->error() << "dump.indexed: " << m_fname
+                                          << " is not an indexed file or has an unsupported version" << endl;
+                throw runtime_error("Error opening indexed dump file");
+                }
+
+            complete = indexed_read_frame_index(file.data(), file.size(), m_frames, m_end_offset);
+            }
+
+        if (!complete)
+            {
+            m_exec_conf->msg->warning() << "dump.indexed: " << m_fname << " was not closed properly, recovered "
+                                        << m_frames.size() << " frames" << endl;
+            boost::filesystem::resize_file(m_fname, m_end_offset);
+            }
+        return;
+        }
+
+    // start a new file
+    ofstream f(m_fname.c_str(), ios::out | ios::binary | ios::trunc);
+    if (!f.good())
+        {
+        m_exec_conf->msg->error() << "dump.indexed: Unable to open dump file for writing: " << m_fname << endl;
+        throw runtime_error("Error writing indexed dump file");
+        }
+
+    IndexedFileHeader header;
+    memcpy(header.magic, INDEXED_FILE_MAGIC, 8);
+    header.version = INDEXED_FORMAT_VERSION;
+    header.reserved = 0;
+    f.write((char*)&header, sizeof(IndexedFileHeader));
+    m_end_offset = sizeof(IndexedFileHeader);
+    }
+
+/*! \param field Name of the field
+    \param enable true to write the field in future frames, false to omit it
+*/
+void HOOMDIndexedDumpWriter::setOutputField(const std::string& field, bool enable)
+    {
+    if (field != "position" && field != "velocity" && field != "acceleration" && field != "type" &&
+        field != "mass" && field != "charge" && field != "diameter" && field != "image" && field != "body" &&
+        field != "orientation" && field != "moment_inertia" && field != "bond" && field != "angle" &&
+        field != "dihedral" && field != "improper" && field != "integrator")
+        {
+        m_exec_conf->msg->error() << "dump.indexed: Unknown field " << field << endl;
+        throw runtime_error("Error setting dump.indexed output");
+        }
+
+    if (enable)
+        m_fields.insert(field);
+    else
+        m_fields.erase(field);
+    }
+
+/*! \param enable_compression true to compress the chunks of future frames
+
+    Compression is silently ignored when HOOMD was built without zlib.
+*/
+void HOOMDIndexedDumpWriter::enableCompression(bool enable_compression)
+    {
+    m_enable_compression = enable_compression;
+    }
+
+/*! \param name Name of the chunk
+    \param elem_type Type of the values in \a data
+    \param elem_per_item Number of values per item
+    \param num_items Number of items
+    \param data Values to store
+
+    Chunks are compressed with the fastest zlib level: writing must keep up with the simulation, and readers
+    decompress every chunk they touch. When the chunk does not shrink it is stored verbatim.
+*/
+void HOOMDIndexedDumpWriter::addChunk(const std::string& name,
+                                      IndexedElementType elem_type,
+                                      unsigned int elem_per_item,
+                                      unsigned int num_items,
+                                      const void *data)
+    {
+    assert(name.size() < INDEXED_CHUNK_NAME_LEN);
+
+    IndexedChunkEntry entry;
+    memset(&entry, 0, sizeof(IndexedChunkEntry));
+    strncpy(entry.name, name.c_str(), INDEXED_CHUNK_NAME_LEN-1);
+    entry.codec = indexed_codec_raw;
+    entry.elem_type = elem_type;
+    entry.elem_per_item = elem_per_item;
+    entry.num_items = num_items;
+    entry.raw_size = (boost::uint64_t)num_items*elem_per_item*elem_size(elem_type);
+    // offset is relative to the start of the chunk data until the frame is written
+    entry.offset = m_frame_data.size();
+
+    const char *raw = (const char *)data;
+    size_t raw_size = (size_t)entry.raw_size;
+    bool stored = false;
+
+    #ifdef ENABLE_ZLIB
+    if (m_enable_compression && raw_size > 0)
+        {
+        // group the bytes of equal significance together
+        const char *src = raw;
+        unsigned int esize = elem_size(elem_type);
+        if (esize > 1)
+            {
+            m_shuffle_buf.resize(raw_size);
+            size_t n = raw_size / esize;
+            for (unsigned int b = 0; b < esize; b++)
+                for (size_t i = 0; i < n; i++)
+                    m_shuffle_buf[b*n + i] = raw[i*esize + b];
+            src = &m_shuffle_buf[0];
+            }
+
+        uLongf dest_len = compressBound(raw_size);
+        size_t start = m_frame_data.size();
+        m_frame_data.resize(start + dest_len);
+        int err = compress2((Bytef*)&m_frame_data[start], &dest_len, (const Bytef*)src, raw_size, Z_BEST_SPEED);
+        if (err == Z_OK && dest_len < raw_size)
+            {
+            m_frame_data.resize(start + dest_len);
+            entry.codec = indexed_codec_zlib | ((esize > 1) ? indexed_codec_shuffle : 0);
+            entry.stored_size = dest_len;
+            stored = true;
+            }
+        else
+            m_frame_data.resize(start);
+        }
+    #endif
+
+    if (!stored)
+        {
+        m_frame_data.insert(m_frame_data.end(), raw, raw + raw_size);
+        entry.stored_size = raw_size;
+        }
+
+    m_chunks.push_back(entry);
+    }
+
+/*! \param name Name of the chunk
+    \param names Names to store, written 0 terminated one after the other
+*/
+void HOOMDIndexedDumpWriter::addNameChunk(const std::string& name, const std::vector<std::string>& names)
+    {
+    std::vector<char> buf;
+    for (unsigned int i = 0; i < names.size(); i++)
+        {
+        buf.insert(buf.end(), names[i].begin(), names[i].end());
+        buf.push_back(0);
+        }
+    addChunk(name, indexed_uint8, 1, (unsigned int)buf.size(), buf.empty() ? NULL : &buf[0]);
+    }
+
+/*! \param name Name of the group chunk (bond, angle, ...)
+    \param group_size Number of members per group
+    \param snap Snapshot of the bonded group data
+
+    Each group is stored as its type id followed by the member tags. The type names go to \a name_types.
+*/
+template<class Snapshot>
+void HOOMDIndexedDumpWriter::addGroupChunks(const std::string& name, unsigned int group_size, const Snapshot& snap)
+    {
+    unsigned int n = (unsigned int)snap.groups.size();
+    std::vector<unsigned int> buf(n*(group_size+1));
+    for (unsigned int i = 0; i < n; i++)
+        {
+        buf[i*(group_size+1)] = snap.type_id[i];
+        for (unsigned int j = 0; j < group_size; j++)
+            buf[i*(group_size+1) + j + 1] = snap.groups[i].tag[j];
+        }
+    addChunk(name, indexed_uint32, group_size+1, n, n ? &buf[0] : NULL);
+    addNameChunk(name + "_types", snap.type_mapping);
+    }
+
+/*! \param timestep Current time step of the simulation
+
+    The frame is assembled in memory and then written to the file in a single pass, followed by the updated frame
+    index and footer.
+*/
+void HOOMDIndexedDumpWriter::analyze(unsigned int timestep)
+    {
+    if (m_prof)
+        m_prof->push("Dump indexed");
+
+    // gather the requested data on the root rank
+    boost::shared_ptr<SnapshotSystemData> snap = m_sysdef->takeSnapshot(true,
+                                                                       isEnabled("bond"),
+                                                                       isEnabled("angle"),
+                                                                       isEnabled("dihedral"),
+                                                                       isEnabled("improper"),
+                                                                       false,
+                                                                       false,
+                                                                       isEnabled("integrator"));
+
+#ifdef ENABLE_MPI
+    // only the root processor writes the output file
+    if (m_pdata->getDomainDecomposition() && ! m_exec_conf->isRoot())
+        {
+        if (m_prof)
+            m_prof->pop();
+        return;
+        }
+#endif
+
+    const SnapshotParticleData& pdata = snap->particle_data;
+    unsigned int N = pdata.size;
+    m_chunks.clear();
+    m_frame_data.clear();
+
+    std::vector<Scalar> sbuf;
+    if (isEnabled("position") || isEnabled("velocity") || isEnabled("acceleration"))
+        {
+        const char *names[] = {"position", "velocity", "acceleration"};
+        const std::vector<Scalar3> *src[] = {&pdata.pos, &pdata.vel, &pdata.accel};
+        sbuf.resize(N*3);
+        for (unsigned int k = 0; k < 3; k++)
+            {
+            if (!isEnabled(names[k]))
+                continue;
+            for (unsigned int i = 0; i < N; i++)
+                {
+                sbuf[i*3] = (*src[k])[i].x;
+                sbuf[i*3+1] = (*src[k])[i].y;
+                sbuf[i*3+2] = (*src[k])[i].z;
+                }
+            addChunk(names[k], scalar_elem_type, 3, N, N ? &sbuf[0] : NULL);
+            }
+        }
+
+    if (isEnabled("type"))
+        {
+        addChunk("type", indexed_uint32, 1, N, N ? &pdata.type[0] : NULL);
+        addNameChunk("type_names", pdata.type_mapping);
+        }
+    if (isEnabled("mass"))
+        addChunk("mass", scalar_elem_type, 1, N, N ? &pdata.mass[0] : NULL);
+    if (isEnabled("charge"))
+        addChunk("charge", scalar_elem_type, 1, N, N ? &pdata.charge[0] : NULL);
+    if (isEnabled("diameter"))
+        addChunk("diameter", scalar_elem_type, 1, N, N ? &pdata.diameter[0] : NULL);
+    if (isEnabled("body"))
+        addChunk("body", indexed_uint32, 1, N, N ? &pdata.body[0] : NULL);
+
+    if (isEnabled("image"))
+        {
+        std::vector<int> ibuf(N*3);
+        for (unsigned int i = 0; i < N; i++)
+            {
+            ibuf[i*3] = pdata.image[i].x;
+            ibuf[i*3+1] = pdata.image[i].y;
+            ibuf[i*3+2] = pdata.image[i].z;
+            }
+        addChunk("image", indexed_int32, 3, N, N ? &ibuf[0] : NULL);
+        }
+
+    if (isEnabled("orientation"))
+        {
+        sbuf.resize(N*4);
+        for (unsigned int i = 0; i < N; i++)
+            {
+            sbuf[i*4] = pdata.orientation[i].x;
+            sbuf[i*4+1] = pdata.orientation[i].y;
+            sbuf[i*4+2] = pdata.orientation[i].z;
+            sbuf[i*4+3] = pdata.orientation[i].w;
+            }
+        addChunk("orientation", scalar_elem_type, 4, N, N ? &sbuf[0] : NULL);
+        }
+
+    if (isEnabled("moment_inertia"))
+        {
+        sbuf.resize(N*6);
+        for (unsigned int i = 0; i < N; i++)
+            for (unsigned int c = 0; c < 6; c++)
+                sbuf[i*6+c] = pdata.inertia_tensor[i].components[c];
+        addChunk("moment_inertia", scalar_elem_type, 6, N, N ? &sbuf[0] : NULL);
+        }
+
+    if (isEnabled("bond"))
+        addGroupChunks("bond", 2, snap->bond_data);
+    if (isEnabled("angle"))
+        addGroupChunks("angle", 3, snap->angle_data);
+    if (isEnabled("dihedral"))
+        addGroupChunks("dihedral", 4, snap->dihedral_data);
+    if (isEnabled("improper"))
+        addGroupChunks("improper", 4, snap->improper_data);
+
+    if (isEnabled("integrator"))
+        {
+        // one type name and one variable count per integrator, followed by all of the variables
+        std::vector<std::string> types;
+        std::vector<unsigned int> counts;
+        std::vector<double> vars;
+        for (unsigned int i = 0; i < snap->integrator_data.size(); i++)
+            {
+            const IntegratorVariables& v = snap->integrator_data[i];
+            types.push_back(v.type);
+            counts.push_back((unsigned int)v.variable.size());
+            vars.insert(vars.end(), v.variable.begin(), v.variable.end());
+            }
+        addNameChunk("integrator_types", types);
+        addChunk("integrator_counts", indexed_uint32, 1, (unsigned int)counts.size(), counts.empty() ? NULL : &counts[0]);
+        addChunk("integrator", indexed_float64, 1, (unsigned int)vars.size(), vars.empty() ? NULL : &vars[0]);
+        }
+
+    // fill out the frame header and make the chunk offsets absolute
+    BoxDim box = snap->global_box;
+    Scalar3 L = box.getL();
+
+    IndexedFrameHeader header;
+    memset(&header, 0, sizeof(IndexedFrameHeader));
+    memcpy(header.magic, INDEXED_FRAME_MAGIC, 4);
+    header.timestep = timestep;
+    header.dimensions = snap->dimensions;
+    header.num_chunks = (unsigned int)m_chunks.size();
+    header.num_particles = N;
+    header.box[0] = L.x;
+    header.box[1] = L.y;
+    header.box[2] = L.z;
+    header.box[3] = box.getTiltFactorXY();
+    header.box[4] = box.getTiltFactorXZ();
+    header.box[5] = box.getTiltFactorYZ();
+
+    boost::uint64_t data_start = m_end_offset + sizeof(IndexedFrameHeader) + m_chunks.size()*sizeof(IndexedChunkEntry);
+    header.frame_size = data_start - m_end_offset + m_frame_data.size() + sizeof(IndexedFrameTrailer);
+    for (unsigned int i = 0; i < m_chunks.size(); i++)
+        m_chunks[i].offset += data_start;
+
+    IndexedFrameTrailer trailer;
+    memcpy(trailer.magic, INDEXED_FRAME_END_MAGIC, 4);
+    trailer.timestep = timestep;
+    trailer.frame_size = header.frame_size;
+    trailer.checksum = indexed_checksum((const char*)&header, sizeof(IndexedFrameHeader));
+    if (m_chunks.size())
+        trailer.checksum = indexed_checksum((const char*)&m_chunks[0], m_chunks.size()*sizeof(IndexedChunkEntry),
+                                            trailer.checksum);
+    if (m_frame_data.size())
+        trailer.checksum = indexed_checksum(&m_frame_data[0], m_frame_data.size(), trailer.checksum);
+
+    IndexedFrameEntry frame;
+    frame.offset = m_end_offset;
+    frame.timestep = timestep;
+    frame.reserved = 0;
+    m_frames.push_back(frame);
+
+    // cut off the old index and footer first: if the write is interrupted, no index is left behind that lists
+    // the new frame's bytes as part of the old frames
+    boost::filesystem::resize_file(m_fname, m_end_offset);
+
+    // write the frame where the old index was, then the new index and footer
+    fstream f(m_fname.c_str(), ios::in | ios::out | ios::binary);
+    if (!f.good())
+        {
+        m_exec_conf->msg->error() << "dump.indexed: Unable to open dump file for writing: " << m_fname << endl;
+        throw runtime_error("Error writing indexed dump file");
+        }
+
+    // the header goes last, so that an interrupted write never leaves a frame that looks complete
+    f.seekp(m_end_offset + sizeof(IndexedFrameHeader));
+    if (m_chunks.size())
+        f.write((char*)&m_chunks[0], m_chunks.size()*sizeof(IndexedChunkEntry));
+    if (m_frame_data.size())
+        f.write(&m_frame_data[0], m_frame_data.size());
+    f.write((char*)&trailer, sizeof(IndexedFrameTrailer));
+    f.flush();
+    f.seekp(m_end_offset);
+    f.write((char*)&header, sizeof(IndexedFrameHeader));
+    f.flush();
+    f.seekp(m_end_offset + header.frame_size);
+    m_end_offset += header.frame_size;
+
+    boost::uint64_t n_frames = m_frames.size();
+    f.write(INDEXED_INDEX_MAGIC, 4);
+    f.write((char*)&n_frames, sizeof(boost::uint64_t));
+    f.write((char*)&m_frames[0], m_frames.size()*sizeof(IndexedFrameEntry));
+
+    IndexedFooter footer;
+    footer.index_offset = m_end_offset;
+    memcpy(footer.magic, INDEXED_FOOTER_MAGIC, 8);
+    f.write((char*)&footer, sizeof(IndexedFooter));
+
+    if (!f.good())
+        {
+        m_exec_conf->msg->error() << "dump.indexed: I/O error while writing file " << m_fname << endl;
+        throw runtime_error("Error writing indexed dump file");
+        }
+
+    if (m_prof)
+        m_prof->pop();
+    }
+
+void export_HOOMDIndexedDumpWriter()
+    {
+    class_<HOOMDIndexedDumpWriter, boost::shared_ptr<HOOMDIndexedDumpWriter>, bases<Analyzer>, boost::noncopyable>
+    ("HOOMDIndexedDumpWriter", init< boost::shared_ptr<SystemDefinition>, const std::string&, bool >())
+    .def("setOutputField", &HOOMDIndexedDumpWriter::setOutputField)
+    .def("enableCompression", &HOOMDIndexedDumpWriter::enableCompression)
+    .def("getNumFrames", &HOOMDIndexedDumpWriter::getNumFrames)
+    ;
+    }
+
+#ifdef WIN32
+#pragma warning( pop )
+#endif
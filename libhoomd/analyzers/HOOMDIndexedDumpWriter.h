@@ -0,0 +1,149 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+/*! \file HOOMDIndexedDumpWriter.h
+    \brief Declares the HOOMDIndexedDumpWriter class
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <string>
+#include <vector>
+#include <set>
+
+#include <boost/shared_ptr.hpp>
+
+#include "Analyzer.h"
+#include "HOOMDIndexedFormat.h"
+
+#ifndef __HOOMD_INDEXED_DUMP_WRITER_H__
+#define __HOOMD_INDEXED_DUMP_WRITER_H__
+
+//! Analyzer for writing indexed binary trajectories
+/*! HOOMDIndexedDumpWriter appends one frame to a single indexed binary file each time analyze() is called. The
+    file layout is described in HOOMDIndexedFormat.h: every frame is split into per-field chunks that are
+    compressed independently and a frame index is kept at the end of the file, so readers
+    (HOOMDIndexedInitializer) can jump straight to any frame and decode only the fields they need.
+
+    The state is collected with SystemDefinition::takeSnapshot(), so the writer works with domain decomposition.
+    Only the root rank writes the file.
+
+    The fields written can be selected with setOutputField(). Valid field names are position, velocity,
+    acceleration, type, mass, charge, diameter, image, body, orientation, moment_inertia, bond, angle, dihedral,
+    improper and integrator. All of them are written by default.
+
+    \ingroup analyzers
+*/
+class HOOMDIndexedDumpWriter : public Analyzer
+    {
+    public:
+        //! Construct the writer
+        HOOMDIndexedDumpWriter(boost::shared_ptr<SystemDefinition> sysdef, const std::string& fname, bool overwrite);
+
+        //! Destructor
+        ~HOOMDIndexedDumpWriter();
+
+        //! Write out the data for the current timestep
+        void analyze(unsigned int timestep);
+
+        //! Enable or disable output of a field
+        void setOutputField(const std::string& field, bool enable);
+
+        //! Enable or disable compression of the chunks
+        void enableCompression(bool enable_compression);
+
+        //! Get the number of frames in the file
+        unsigned int getNumFrames() const
+            {
+            return (unsigned int)m_frames.size();
+            }
+
+    private:
+        std::string m_fname;                        //!< File name to write
+        bool m_enable_compression;                  //!< True if chunks should be compressed
+        std::set<std::string> m_fields;             //!< Fields to write
+        std::vector<IndexedFrameEntry> m_frames;    //!< Index of the frames in the file
+        boost::uint64_t m_end_offset;               //!< Offset at which the next frame is written
+
+        std::vector<IndexedChunkEntry> m_chunks;    //!< Chunk table of the frame being written
+        std::vector<char> m_frame_data;             //!< Stored data of the frame being written
+        std::vector<char> m_shuffle_buf;            //!< Scratch space for byte shuffling
+
+        //! Opens (or creates) the file and reads its frame index
+        void openFile(bool overwrite);
+
+        //! Checks if a field is enabled
+        bool isEnabled(const std::string& field) const
+            {
+            return m_fields.count(field) > 0;
+            }
+
+        //! Encodes a chunk and appends it to the frame being written
+        void addChunk(const std::string& name,
+                      IndexedElementType elem_type,
+                      unsigned int elem_per_item,
+                      unsigned int num_items,
+                      const void *data);
+
+        //! Adds the chunks of a bonded group snapshot
+        template<class Snapshot>
+        void addGroupChunks(const std::string& name, unsigned int group_size, const Snapshot& snap);
+
+        //! Adds a chunk holding a list of names
+        void addNameChunk(const std::string& name, const std::vector<std::string>& names);
+        };
+
+//! Exports the HOOMDIndexedDumpWriter class to python
+void export_HOOMDIndexedDumpWriter();
+
+#endif
@@ -59,6 +59,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 
 #include "Logger.h"
+#include "ComputeThermo.h"
 
 #include <boost/python.hpp>
 #include <boost/filesystem/operations.hpp>
@@ -68,6 +69,8 @@ using namespace boost::filesystem;
 
 #include <stdexcept>
 #include <iomanip>
+#include <algorithm>
+#include <cstring>
 using namespace std;
 
 #ifdef ENABLE_MPI
@@ -78,16 +81,22 @@ using namespace std;
     \param fname File name to write the log to
     \param header_prefix String to write before the header
     \param overwrite Will overwite an exiting file if true (default is to append)
+    \param binary Write the log in binary format if true (default is delimited text)
 
     Constructing a logger will open the file \a fname, overwriting it if it exists.
 */
 Logger::Logger(boost::shared_ptr<SystemDefinition> sysdef,
                const std::string& fname,
                const std::string& header_prefix,
-               bool overwrite)
-    : Analyzer(sysdef), m_delimiter("\t"), m_filename(fname), m_header_prefix(header_prefix), m_appending(!overwrite), m_is_initialized(false)
+               bool overwrite,
+               bool binary)
+    : Analyzer(sysdef), m_delimiter("\t"), m_filename(fname), m_header_prefix(header_prefix), m_appending(!overwrite),
+      m_binary(binary), m_flush_period(1), m_rows_since_flush(0), m_is_initialized(false), m_quantities_set(false),
+      m_history_size(0),
+      m_history_start(0), m_history_count(0)
     {
-    m_exec_conf->msg->notice(5) << "Constructing Logger: " << fname << " " << header_prefix << " " << overwrite << endl;
+    m_exec_conf->msg->notice(5) << "Constructing Logger: " << fname << " " << header_prefix << " " << overwrite << " "
+                                << binary << endl;
     }
 
 void Logger::openOutputFiles()
@@ -98,16 +107,22 @@ void Logger::openOutputFiles()
         if (! m_exec_conf->isRoot())
             return;
 #endif
-    // open the file
-    if (exists(m_filename) && m_appending)
+    ios_base::openmode mode = m_binary ? ios_base::binary : ios_base::openmode(0);
+
+    // open the file, an empty binary log gets a new schema block
+    if (exists(m_filename) && m_appending && !(m_binary && file_size(m_filename) == 0))
         {
+        // the rows must match the schema already in the file
+        if (m_binary)
+            checkBinaryHeader();
+
         m_exec_conf->msg->notice(3) << "analyze.log: Appending log to existing file \"" << m_filename << "\"" << endl;
-        m_file.open(m_filename.c_str(), ios_base::in | ios_base::out | ios_base::ate);
+        m_file.open(m_filename.c_str(), ios_base::in | ios_base::out | ios_base::ate | mode);
         }
     else
         {
         m_exec_conf->msg->notice(3) << "analyze.log: Creating new log in file \"" << m_filename << "\"" << endl;
-        m_file.open(m_filename.c_str(), ios_base::out);
+        m_file.open(m_filename.c_str(), ios_base::out | mode);
         m_appending = false;
         }
 
@@ -121,6 +136,130 @@ void Logger::openOutputFiles()
 Logger::~Logger()
     {
     m_exec_conf->msg->notice(5) << "Destroying Logger" << endl;
+
+    // write out any rows still buffered by the stream
+    if (m_file.is_open())
+        m_file.flush();
+    }
+
+/*! \param str String to write
+
+    The string is written as its length (uint32) followed by its characters.
+*/
+void Logger::writeBinaryString(const std::string& str)
+    {
+    uint32_t len = str.size();
+    m_file.write((char*)&len, sizeof(uint32_t));
+    m_file.write(str.c_str(), len);
+    }
+
+/*! Writes the schema block describing the columns of the following rows. See the class documentation for the layout.
+*/
+void Logger::writeBinaryHeader()
+    {
+    m_file.write("HOOMDLOG", 8);
+
+    uint32_t version = 2;
+    m_file.write((char*)&version, sizeof(uint32_t));
+
+    writeBinaryString(m_header_prefix);
+
+    // timestep is always output
+    uint32_t num_columns = m_logged_quantities.size() + 1;
+    m_file.write((char*)&num_columns, sizeof(uint32_t));
+    writeBinaryString("timestep");
+    for (unsigned int i = 0; i < m_logged_quantities.size(); i++)
+        writeBinaryString(m_logged_quantities[i]);
+
+    m_file.flush();
+    }
+
+/*! \param f Stream to read from
+    \param str Set to the string read
+    \param len_limit Longest string accepted, to stop early on files that are not binary logs
+    \returns true if a complete string was read
+*/
+static bool readBinaryString(std::istream& f, std::string& str, uint32_t len_limit)
+    {
+    uint32_t len = 0;
+    f.read((char*)&len, sizeof(uint32_t));
+    if (!f.good() || len > len_limit)
+        return false;
+    str.resize(len);
+    if (len > 0)
+        f.read(&str[0], len);
+    return f.good();
+    }
+
+/*! Reads the schema block at the start of an existing binary log and checks that it is the one writeBinaryHeader()
+    would write. Rows appended with a different schema could not be told apart from the ones already in the file.
+*/
+void Logger::checkBinaryHeader()
+    {
+    ifstream f(m_filename.c_str(), ios_base::in | ios_base::binary);
+    char magic[8];
+    f.read(magic, 8);
+    if (!f.good() || memcmp(magic, "HOOMDLOG", 8) != 0)
+        {
+        m_exec_conf->msg->error() << "analyze.log: Cannot append to " << m_filename << ", it is not a binary log"
+                                  << endl;
+        throw runtime_error("Error initializing Logger");
+        }
+
+    uint32_t version = 0;
+    f.read((char*)&version, sizeof(uint32_t));
+    if (!f.good() || version != 2)
+        {
+        m_exec_conf->msg->error() << "analyze.log: Cannot append to " << m_filename << ", it has format version "
+                                  << version << " (expected 2)" << endl;
+        throw runtime_error("Error initializing Logger");
+        }
+
+    // the prefix and column names are short, anything longer means the file is damaged
+    const uint32_t len_limit = 1 << 20;
+    std::string prefix;
+    uint32_t num_columns = 0;
+    bool ok = readBinaryString(f, prefix, len_limit);
+    if (ok)
+        {
+        f.read((char*)&num_columns, sizeof(uint32_t));
+        ok = f.good() && num_columns <= len_limit;
+        }
+
+    std::vector< std::string > columns;
+    for (unsigned int i = 0; ok && i < num_columns; i++)
+        {
+        std::string name;
+        ok = readBinaryString(f, name, len_limit);
+        columns.push_back(name);
+        }
+
+    if (!ok)
+        {
+        m_exec_conf->msg->error() << "analyze.log: Cannot append to " << m_filename << ", its schema is incomplete"
+                                  << endl;
+        throw runtime_error("Error initializing Logger");
+        }
+
+    if (prefix != m_header_prefix)
+        {
+        m_exec_conf->msg->error() << "analyze.log: Cannot append to " << m_filename
+                                  << ", its header prefix does not match" << endl;
+        throw runtime_error("Error initializing Logger");
+        }
+
+    // timestep is always the first column
+    std::vector< std::string > expected(1, "timestep");
+    expected.insert(expected.end(), m_logged_quantities.begin(), m_logged_quantities.end());
+    if (columns != expected)
+        {
+        std::string names;
+        for (unsigned int i = 0; i < columns.size(); i++)
+            names += " " + columns[i];
+        m_exec_conf->msg->error() << "analyze.log: Cannot append to " << m_filename
+                                  << ", it logs different quantities:" << names << endl;
+        throw runtime_error("Error initializing Logger");
+        }
     }
 
 /*! \param compute The Compute to register
@@ -179,15 +318,33 @@ void Logger::removeAll()
     by delimiters. After all quantities are written to the file a newline is written.
 
     Each time setLoggedQuantities is called, a header listing the column names is also written.
+
+    A binary log has a single schema block at the start of the file, so its quantities cannot be changed once set.
 */
 void Logger::setLoggedQuantities(const std::vector< std::string >& quantities)
     {
+    if (m_binary && m_quantities_set)
+        {
+        // setting the same quantities again leaves the schema as it is
+        if (quantities == m_logged_quantities)
+            return;
+
+        m_exec_conf->msg->error() << "analyze.log: Cannot change the quantities of a binary log" << endl;
+        throw runtime_error("Error setting logged quantities");
+        }
+
     m_logged_quantities = quantities;
+    m_quantities_set = true;
 
     // prepare or adjust storage for caching the logger properties.
     cached_timestep = -1;
     cached_quantities.resize(quantities.size());
 
+    // the rows in the history no longer match the columns
+    m_history.resize(m_history_size*quantities.size());
+    m_history_start = 0;
+    m_history_count = 0;
+
 #ifdef ENABLE_MPI
     // only output to file on root processor
     if (m_pdata->getDomainDecomposition())
@@ -201,6 +358,17 @@ void Logger::setLoggedQuantities(const std::vector< std::string >& quantities)
 
     m_is_initialized = true;
 
+    if (m_binary)
+        {
+        // only write the schema if this is a new file, openOutputFiles() checked the one of an existing file
+        if (!m_appending)
+            writeBinaryHeader();
+
+        if (quantities.size() == 0)
+            m_exec_conf->msg->warning() << "analyze.log: No quantities specified for logging" << endl;
+        return;
+        }
+
     // only write the header if this is a new file
     if (!m_appending)
         {
@@ -240,6 +408,37 @@ void Logger::setDelimiter(const std::string& delimiter)
     m_delimiter = delimiter;
     }
 
+/*! \param flush_period Number of rows between file flushes
+
+    Rows are still written every time analyze() is called, but they are only guaranteed to be in the file after
+    \a flush_period rows have been written or the logger is destroyed.
+*/
+void Logger::setFlushPeriod(unsigned int flush_period)
+    {
+    if (flush_period == 0)
+        {
+        m_exec_conf->msg->error() << "analyze.log: flush_period must be positive" << endl;
+        throw runtime_error("Error setting log parameters");
+        }
+
+    m_flush_period = flush_period;
+    }
+
+/*! \param history_size Number of rows to keep in the history buffer
+
+    The current contents of the history buffer are discarded.
+*/
+void Logger::setHistorySize(unsigned int history_size)
+    {
+    m_history_size = history_size;
+    m_history.clear();
+    m_history.resize(m_history_size*m_logged_quantities.size());
+    m_history_steps.clear();
+    m_history_steps.resize(m_history_size);
+    m_history_start = 0;
+    m_history_count = 0;
+    }
+
 /*! \param timestep Time step to write out data for
 
     Writes a single line of output to the log file with each specified quantity separated by
@@ -249,10 +448,39 @@ void Logger::analyze(unsigned int timestep)
     {
     if (m_prof) m_prof->push("Log");
 
+    // evaluate all thermo computes that provide logged quantities together
+    std::vector< boost::shared_ptr<ComputeThermo> > thermos;
+    for (unsigned int i = 0; i < m_logged_quantities.size(); i++)
+        {
+        std::map< std::string, boost::shared_ptr<Compute> >::iterator compute
+            = m_compute_quantities.find(m_logged_quantities[i]);
+        if (compute == m_compute_quantities.end())
+            continue;
+
+        boost::shared_ptr<ComputeThermo> thermo = boost::dynamic_pointer_cast<ComputeThermo>(compute->second);
+        if (thermo)
+            thermos.push_back(thermo);
+        }
+    ComputeThermo::computeMany(thermos, timestep);
+
     // update info in cache for later use and for immediate output.
     for (unsigned int i = 0; i < m_logged_quantities.size(); i++)
         cached_quantities[i] = getValue(m_logged_quantities[i], timestep);
 
+    if (m_history_size > 0)
+        {
+        // overwrite the oldest row once the buffer is full
+        unsigned int row = (m_history_start + m_history_count) % m_history_size;
+        if (m_history_count == m_history_size)
+            m_history_start = (m_history_start + 1) % m_history_size;
+        else
+            m_history_count++;
+
+        m_history_steps[row] = timestep;
+        std::copy(cached_quantities.begin(), cached_quantities.end(),
+                  m_history.begin() + row*m_logged_quantities.size());
+        }
+
 #ifdef ENABLE_MPI
     // only output to file on root processor
     if (m_comm)
@@ -263,25 +491,45 @@ void Logger::analyze(unsigned int timestep)
             }
 #endif
 
-    // The timestep is always output
-    m_file << setprecision(10) << timestep;
     cached_timestep = timestep;
 
-    // quit now if there is nothing to log
-    if (m_logged_quantities.size() == 0)
+    if (m_binary)
         {
-        return;
+        // The timestep is always output
+        uint32_t step = timestep;
+        m_file.write((char*)&step, sizeof(uint32_t));
+
+        if (m_logged_quantities.size() > 0)
+            {
+            std::vector<double> row(cached_quantities.begin(), cached_quantities.end());
+            m_file.write((char*)&row[0], sizeof(double)*row.size());
+            }
         }
+    else
+        {
+        // The timestep is always output
+        m_file << setprecision(10) << timestep;
 
-    // only print the delimiter after the timestep if there are more quantities logged
-    m_file << m_delimiter;
+        // only print the delimiter after the timestep if there are more quantities logged
+        if (m_logged_quantities.size() > 0)
+            {
+            m_file << m_delimiter;
 
-    // write all but the last of the quantities separated by the delimiter
-    for (unsigned int i = 0; i < m_logged_quantities.size()-1; i++)
-        m_file << setprecision(10) << cached_quantities[i] << m_delimiter;
-    // write the last one with no delimiter after it
-    m_file << setprecision(10) << cached_quantities[m_logged_quantities.size()-1] << endl;
-    m_file.flush();
+            // write all but the last of the quantities separated by the delimiter
+            for (unsigned int i = 0; i < m_logged_quantities.size()-1; i++)
+                m_file << setprecision(10) << cached_quantities[i] << m_delimiter;
+            // write the last one with no delimiter after it
+            m_file << setprecision(10) << cached_quantities[m_logged_quantities.size()-1];
+            }
+        m_file << '\n';
+        }
+
+    m_rows_since_flush++;
+    if (m_rows_since_flush >= m_flush_period)
+        {
+        m_file.flush();
+        m_rows_since_flush = 0;
+        }
 
     if (!m_file.good())
         {
@@ -311,6 +559,53 @@ Scalar Logger::getCachedQuantity(const std::string &quantity)
     return Scalar(0.0);
     }
 
+/*! \param quantity Quantity to get
+    \param i Row of the history buffer to read, from 0 (oldest) to getNumHistory()-1 (most recent)
+
+    Only the values recorded by analyze() are returned, no compute or updater is evaluated.
+*/
+Scalar Logger::getHistoryQuantity(const std::string &quantity, unsigned int i)
+    {
+    unsigned int row = getHistoryRow(i);
+
+    if (quantity == "timestep")
+        return Scalar(m_history_steps[row]);
+
+    std::vector< std::string >::iterator it = std::find(m_logged_quantities.begin(), m_logged_quantities.end(),
+                                                        quantity);
+    if (it == m_logged_quantities.end())
+        {
+        m_exec_conf->msg->error() << "analyze.log: Log quantity " << quantity << " is not logged" << endl;
+        throw runtime_error("Error querying log history");
+        }
+
+    unsigned int column = it - m_logged_quantities.begin();
+    return m_history[row*m_logged_quantities.size() + column];
+    }
+
+/*! \param i Row of the history buffer to read, from 0 (oldest) to getNumHistory()-1 (most recent)
+
+    The time step is kept as an integer so that it is exact regardless of the precision of Scalar.
+*/
+unsigned int Logger::getHistoryTimestep(unsigned int i)
+    {
+    return m_history_steps[getHistoryRow(i)];
+    }
+
+/*! \param i Row of the history buffer, from 0 (oldest) to getNumHistory()-1 (most recent)
+    \returns The position of that row in the ring buffer
+*/
+unsigned int Logger::getHistoryRow(unsigned int i)
+    {
+    if (i >= m_history_count)
+        {
+        m_exec_conf->msg->error() << "analyze.log: History row " << i << " out of range" << endl;
+        throw runtime_error("Error querying log history");
+        }
+
+    return (m_history_start + i) % m_history_size;
+    }
+
 /*! \param quantity Quantity to get
     \param timestep Time step to compute value for (needed for Compute classes)
 */
@@ -346,13 +641,18 @@ Scalar Logger::getValue(const std::string &quantity, int timestep)
 void export_Logger()
     {
     class_<Logger, boost::shared_ptr<Logger>, bases<Analyzer>, boost::noncopyable>
-    ("Logger", init< boost::shared_ptr<SystemDefinition>, const std::string&, const std::string&, bool >())
+    ("Logger", init< boost::shared_ptr<SystemDefinition>, const std::string&, const std::string&, bool, bool >())
     .def("registerCompute", &Logger::registerCompute)
     .def("registerUpdater", &Logger::registerUpdater)
     .def("removeAll", &Logger::removeAll)
     .def("setLoggedQuantities", &Logger::setLoggedQuantities)
     .def("setDelimiter", &Logger::setDelimiter)
     .def("getCachedQuantity", &Logger::getCachedQuantity)
+    .def("setFlushPeriod", &Logger::setFlushPeriod)
+    .def("setHistorySize", &Logger::setHistorySize)
+    .def("getNumHistory", &Logger::getNumHistory)
+    .def("getHistoryQuantity", &Logger::getHistoryQuantity)
+    .def("getHistoryTimestep", &Logger::getHistoryTimestep)
     ;
     }
 
@@ -88,6 +88,23 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
     The removeAll method can be used to clear all registered computes and updaters. hoomd_script will
     removeAll() and re-register all active computes and updaters before every run()
 
+    In binary mode, the log is written as a sequence of fixed width rows instead of delimited text. A new file starts
+    with a single schema block:
+     - the 8 characters \c HOOMDLOG
+     - the format version (uint32, currently 2)
+     - the header prefix (uint32 length followed by the characters)
+     - the number of columns (uint32), including the leading timestep column
+     - the name of each column (uint32 length followed by the characters)
+
+    followed by one row per call to analyze(): the time step (uint32) and then one double per logged quantity, all in
+    native byte order. The schema is never repeated, so the logged quantities of a binary log cannot be changed once
+    they are set: setLoggedQuantities() throws if called again with a different list. When appending to an existing
+    binary log, its schema is read back and setLoggedQuantities() throws unless the version, header prefix and
+    columns match.
+
+    The file is flushed every setFlushPeriod() rows (default: every row). setHistorySize() enables an in-memory ring
+    buffer of the most recent rows, which can be queried with getHistoryQuantity() without evaluating any compute.
+
     \ingroup analyzers
 */
 class Logger : public Analyzer
@@ -97,7 +114,8 @@ class Logger : public Analyzer
         Logger(boost::shared_ptr<SystemDefinition> sysdef,
                const std::string& fname,
                const std::string& header_prefix="",
-               bool overwrite=false);
+               bool overwrite=false,
+               bool binary=false);
 
         //! Destructor
         ~Logger();
@@ -117,9 +135,27 @@ class Logger : public Analyzer
         //! Sets the delimiter to use between fields
         void setDelimiter(const std::string& delimiter);
 
+        //! Sets the number of rows between file flushes
+        void setFlushPeriod(unsigned int flush_period);
+
+        //! Sets the number of rows kept in the history buffer
+        void setHistorySize(unsigned int history_size);
+
         //! Query the last logged value for a given quantity
         Scalar getCachedQuantity(const std::string& quantity="timestep");
 
+        //! Get the number of rows in the history buffer
+        unsigned int getNumHistory() const
+            {
+            return m_history_count;
+            }
+
+        //! Query a value of a given quantity from the history buffer
+        Scalar getHistoryQuantity(const std::string& quantity, unsigned int i);
+
+        //! Query the time step of a row in the history buffer
+        unsigned int getHistoryTimestep(unsigned int i);
+
         //! Write out the data for the current timestep
         void analyze(unsigned int timestep);
 
@@ -144,6 +180,12 @@ class Logger : public Analyzer
         std::string m_header_prefix;
         //! Flag indicating this file is being appended to
         bool m_appending;
+        //! Flag indicating the log is written in binary format
+        bool m_binary;
+        //! Number of rows between file flushes
+        unsigned int m_flush_period;
+        //! Number of rows written since the last flush
+        unsigned int m_rows_since_flush;
         //! The file we write out to
         std::ofstream m_file;
         //! A map of computes indexed by logged quantity that they provide
@@ -160,12 +202,36 @@ class Logger : public Analyzer
         std::vector< Scalar > cached_quantities;
         //! Flag to indicate whether we have initialized the file IO
         bool m_is_initialized;
+        //! Flag to indicate the logged quantities have been set
+        bool m_quantities_set;
+        //! Maximum number of rows in the history buffer
+        unsigned int m_history_size;
+        //! Ring buffer of the logged quantities in the most recent rows
+        std::vector< Scalar > m_history;
+        //! Ring buffer of the time steps of the most recent rows
+        std::vector< unsigned int > m_history_steps;
+        //! Position of the oldest row in the history buffer
+        unsigned int m_history_start;
+        //! Number of rows in the history buffer
+        unsigned int m_history_count;
 
         //! Helper function to get a value for a given quantity
         Scalar getValue(const std::string &quantity, int timestep);
 
+        //! Helper function to map a history row to its position in the ring buffer
+        unsigned int getHistoryRow(unsigned int i);
+
         //! Helper function to open output files
         void openOutputFiles();
+
+        //! Helper function to write the schema block of a binary log
+        void writeBinaryHeader();
+
+        //! Helper function to check the schema block of a binary log being appended to
+        void checkBinaryHeader();
+
+        //! Helper function to write a string to a binary log
+        void writeBinaryString(const std::string& str);
     };
 
 //! exports the Logger class to python
@@ -66,12 +66,14 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 
 #include <boost/python.hpp>
+#include <boost/bind.hpp>
 #include <boost/filesystem/operations.hpp>
 #include <boost/filesystem/convenience.hpp>
 using namespace boost::python;
 using namespace boost::filesystem;
 
 #include <iomanip>
+#include <sstream>
 using namespace std;
 
 /*! \param sysdef SystemDefinition containing the Particle data to analyze
@@ -154,50 +156,78 @@ MSDAnalyzer::~MSDAnalyzer()
     On every call, analyze() will write calculate the MSD for each group and write out a row in the file.
 */
 void MSDAnalyzer::analyze(unsigned int timestep)
+    {
+    boost::function<void ()> write = prepareAnalysis(timestep);
+    if (write)
+        write();
+    }
+
+/*! \param timestep Current time step of the simulation
+    \returns A function that calculates the MSDs and writes the row to the file
+
+    Only the snapshot, the box and the group members are taken here. The MSD of every column is calculated by the
+    returned function.
+*/
+boost::function<void ()> MSDAnalyzer::prepareAnalysis(unsigned int timestep)
     {
     if (m_prof)
         m_prof->push("Analyze MSD");
 
     // take particle data snapshot
-    SnapshotParticleData snapshot(m_pdata->getNGlobal());
+    boost::shared_ptr<SnapshotParticleData> snapshot(new SnapshotParticleData(m_pdata->getNGlobal()));
 
-    m_pdata->takeSnapshot(snapshot);
+    m_pdata->takeSnapshot(*snapshot);
 
 #ifdef ENABLE_MPI
     // if we are not the root processor, do not perform file I/O
     if (m_comm && !m_exec_conf->isRoot())
         {
         if (m_prof) m_prof->pop();
-        return;
+        return boost::function<void ()>();
         }
 #endif
 
-    // error check
+    // error check, done here so that the warning is not written from another thread
     if (m_columns.size() == 0)
         {
         m_exec_conf->msg->warning() << "analyze.msd: No columns specified in the MSD analysis" << endl;
-        return;
+        if (m_prof) m_prof->pop();
+        return boost::function<void ()>();
         }
 
-    // ignore writing the header on the first call when appending the file
-    if (m_columns_changed && m_appending)
+    // copy the members of every column, the groups may change before the row is calculated
+    boost::shared_ptr< std::vector< std::vector<unsigned int> > > members(
+        new std::vector< std::vector<unsigned int> >(m_columns.size()));
+    for (unsigned int i = 0; i < m_columns.size(); i++)
         {
-        m_appending = false;
-        m_columns_changed = false;
+        boost::shared_ptr<ParticleGroup const> group = m_columns[i].m_group;
+        if (group->getNumMembersGlobal() == 0)
+            {
+            m_exec_conf->msg->warning() << "analyze.msd: Group has 0 members, reporting a calculated msd of 0.0" << endl;
+            continue;
+            }
+
+        ArrayHandle<unsigned int> h_member_tags(group->getMemberTagArray(), access_location::host, access_mode::read);
+        (*members)[i].assign(h_member_tags.data, h_member_tags.data + group->getNumMembersGlobal());
         }
 
-    // write out the header only once if the columns change
+    BoxDim box = m_pdata->getGlobalBox();
+
+    // the header is formatted here, the columns may change before the row is written
+    std::string header;
     if (m_columns_changed)
         {
-        writeHeader();
+        // ignore writing the header on the first row when appending the file
+        if (!m_appending)
+            header = formatHeader();
+        m_appending = false;
         m_columns_changed = false;
         }
 
-    // write out the row every time
-    writeRow(timestep, snapshot);
-
     if (m_prof)
         m_prof->pop();
+
+    return boost::bind(&MSDAnalyzer::writeRow, this, timestep, header, snapshot, box, members);
     }
 
 /*! \param delimiter New delimiter to set
@@ -286,57 +316,56 @@ void MSDAnalyzer::setR0(const std::string& xml_fname)
         }
     }
 
-/*! The entire header row is written to the file. First, timestep is written as every file includes it and then the
+/*! \returns The entire header row. First, timestep is written as every file includes it and then the
     columns are looped through and their names printed, separated by the delimiter.
 */
-void MSDAnalyzer::writeHeader()
+std::string MSDAnalyzer::formatHeader() const
     {
+    ostringstream header;
+
     // write out the header prefix
-    m_file << m_header_prefix;
+    header << m_header_prefix;
 
     // timestep is always output
-    m_file << "timestep";
-
-    if (m_columns.size() == 0)
-        {
-        m_exec_conf->msg->warning() << "analyze.msd: No columns specified in the MSD analysis" << endl;
-        return;
-        }
+    header << "timestep";
 
     // only print the delimiter after the timestep if there are more columns
-    m_file << m_delimiter;
+    if (m_columns.size() > 0)
+        header << m_delimiter;
 
-    // write all but the last of the quantities separated by the delimiter
-    for (unsigned int i = 0; i < m_columns.size()-1; i++)
-        m_file << m_columns[i].m_name << m_delimiter;
-    // write the last one with no delimiter after it
-    m_file << m_columns[m_columns.size()-1].m_name << endl;
-    m_file.flush();
+    // write the quantities separated by the delimiter
+    for (unsigned int i = 0; i < m_columns.size(); i++)
+        {
+        header << m_columns[i].m_name;
+        if (i != m_columns.size()-1)
+            header << m_delimiter;
+        }
+    header << "\n";
+    return header.str();
     }
 
-/*! \param group Particle group to calculate the MSD of
-    Loop through all particles in the given group and calculate the MSD over them.
-    \returns The calculated MSD
+/*! \param members Tags of the particles to calculate the MSD of
+    \param snapshot Snapshot of the particle data
+    \param box Box of the snapshot
+    Loop through all particles in the given list and calculate the MSD over them.
+    \returns The calculated MSD, 0 if there are no members
 */
-Scalar MSDAnalyzer::calcMSD(boost::shared_ptr<ParticleGroup const> group, const SnapshotParticleData& snapshot)
+Scalar MSDAnalyzer::calcMSD(const std::vector<unsigned int>& members,
+                            const SnapshotParticleData& snapshot,
+                            const BoxDim& box)
     {
-    BoxDim box = m_pdata->getGlobalBox();
-
     // initial sum for the average
     Scalar msd = Scalar(0.0);
 
-    // handle the case where there are 0 members gracefully
-    if (group->getNumMembersGlobal() == 0)
-        {
-        m_exec_conf->msg->warning() << "analyze.msd: Group has 0 members, reporting a calculated msd of 0.0" << endl;
+    // handle the case where there are 0 members gracefully, prepareAnalysis() has warned about it
+    if (members.size() == 0)
         return Scalar(0.0);
-        }
 
     // for each particle in the group
-    for (unsigned int group_idx = 0; group_idx < group->getNumMembersGlobal(); group_idx++)
+    for (unsigned int group_idx = 0; group_idx < members.size(); group_idx++)
         {
-        // get the tag for the current group member from the group
-        unsigned int tag = group->getMemberTag(group_idx);
+        // get the tag for the current group member
+        unsigned int tag = members[group_idx];
         Scalar3 pos = snapshot.pos[tag];
         int3 image = snapshot.image[tag];
         Scalar3 unwrapped = box.shift(pos, image);
@@ -348,45 +377,50 @@ Scalar MSDAnalyzer::calcMSD(boost::shared_ptr<ParticleGroup const> group, const
         }
 
     // divide to complete the average
-    msd /= Scalar(group->getNumMembersGlobal());
+    msd /= Scalar(members.size());
     return msd;
     }
 
 /*! \param timestep current time step of the simulation
+    \param header Header row to write before the row, empty if the columns have not changed
+    \param snapshot Snapshot of the particle data at \a timestep
+    \param box Box at \a timestep
+    \param members Tags of the members of every column at \a timestep
 
-    Performs all the steps needed in order to calculate the MSDs for all the groups in the columns and writes out an
-    entire row to the file.
+    Calculates the MSD of every column, then writes out the header if the columns have changed, followed by an entire
+    row. Errors are reported by throwing, the messenger is not used here.
 */
-void MSDAnalyzer::writeRow(unsigned int timestep, const SnapshotParticleData& snapshot)
+void MSDAnalyzer::writeRow(unsigned int timestep,
+                           const std::string& header,
+                           boost::shared_ptr<const SnapshotParticleData> snapshot,
+                           const BoxDim& box,
+                           boost::shared_ptr< const std::vector< std::vector<unsigned int> > > members)
     {
-    if (m_prof) m_prof->push("MSD");
+    std::vector<Scalar> values(members->size());
+    for (unsigned int i = 0; i < members->size(); i++)
+        values[i] = calcMSD((*members)[i], *snapshot, box);
+
+    // write out the header only once if the columns change
+    if (!header.empty())
+        m_file << header;
 
     // The timestep is always output
     m_file << setprecision(10) << timestep;
 
-    // quit now if there is nothing to log
-    if (m_columns.size() == 0)
-        {
-        return;
-        }
-
     // only print the delimiter after the timestep if there are more columns
     m_file << m_delimiter;
 
     // write all but the last of the columns separated by the delimiter
-    for (unsigned int i = 0; i < m_columns.size()-1; i++)
-        m_file << setprecision(10) << calcMSD(m_columns[i].m_group, snapshot) << m_delimiter;
+    for (unsigned int i = 0; i < values.size()-1; i++)
+        m_file << setprecision(10) << values[i] << m_delimiter;
     // write the last one with no delimiter after it
-    m_file << setprecision(10) << calcMSD(m_columns[m_columns.size()-1].m_group, snapshot) << endl;
+    m_file << setprecision(10) << values[values.size()-1] << endl;
     m_file.flush();
 
     if (!m_file.good())
         {
-        m_exec_conf->msg->error() << "analyze.msd: I/O error while writing file" << endl;
-        throw runtime_error("Error writting msd file");
+        throw runtime_error("analyze.msd: I/O error while writing file");
         }
-
-    if (m_prof) m_prof->pop();
     }
 
 void export_MSDAnalyzer()
@@ -99,6 +99,9 @@ class MSDAnalyzer : public Analyzer
         //! Write out the data for the current timestep
         void analyze(unsigned int timestep);
 
+        //! Sample the particle data and return a function that calculates and writes out the MSDs
+        virtual boost::function<void ()> prepareAnalysis(unsigned int timestep);
+
         //! Sets the delimiter to use between fields
         void setDelimiter(const std::string& delimiter);
 
@@ -138,12 +141,16 @@ class MSDAnalyzer : public Analyzer
 
         std::vector<column> m_columns;  //!< List of groups to output
 
-        //! Helper function to write out the header
-        void writeHeader();
+        //! Helper function to format the header row
+        std::string formatHeader() const;
         //! Helper function to calculate the MSD of a single group
-        Scalar calcMSD(boost::shared_ptr<ParticleGroup const> group, const SnapshotParticleData& snapshot);
-        //! Helper function to write one row of output
-        void writeRow(unsigned int timestep, const SnapshotParticleData& snapshot);
+        Scalar calcMSD(const std::vector<unsigned int>& members, const SnapshotParticleData& snapshot, const BoxDim& box);
+        //! Helper function to calculate and write one row of output
+        void writeRow(unsigned int timestep,
+                      const std::string& header,
+                      boost::shared_ptr<const SnapshotParticleData> snapshot,
+                      const BoxDim& box,
+                      boost::shared_ptr< const std::vector< std::vector<unsigned int> > > members);
     };
 
 //! Exports the MSDAnalyzer class to python
@@ -112,6 +112,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "TwoStepBDNVTRigid.h"
 #include "TempRescaleUpdater.h"
 #include "ZeroMomentumUpdater.h"
+#include "GroupSelectUpdater.h"
 #include "FIREEnergyMinimizer.h"
 #include "FIREEnergyMinimizerRigid.h"
 #include "SFCPackUpdater.h"
@@ -890,24 +890,20 @@ Communicator::Communicator(boost::shared_ptr<SystemDefinition> sysdef,
 
     initializeNeighborArrays();
 
-    #ifdef ENABLE_CUDA
-    if (m_exec_conf->isCUDAEnabled())
-        {
-        // set up autotuners to determine whether to use mapped memory (boolean values)
-        std::vector<unsigned int> valid_params(2);
-        valid_params[0] = 0; valid_params[1]  = 1;
+    // set up autotuners to determine whether to precompute forces before the ghost update (boolean values)
+    // on the CPU, the tuner times the step with the host clock
+    std::vector<unsigned int> valid_params(2);
+    valid_params[0] = 0; valid_params[1]  = 1;
 
-        // use a sufficiently long measurement period to average over
-        unsigned int nsteps = 100;
-        m_tuner_precompute.reset(new Autotuner(valid_params, nsteps, 100000, "comm_precompute", this->m_exec_conf));
+    // use a sufficiently long measurement period to average over
+    unsigned int nsteps = 100;
+    m_tuner_precompute.reset(new Autotuner(valid_params, nsteps, 100000, "comm_precompute", this->m_exec_conf));
 
-        // average execution times instead of median
-        m_tuner_precompute->setAverage(true);
+    // average execution times instead of median
+    m_tuner_precompute->setAverage(true);
 
-        // we require syncing for aligned execution streams
-        m_tuner_precompute->setSync(true);
-        }
-    #endif
+    // we require syncing for aligned execution streams
+    m_tuner_precompute->setSync(true);
     }
 
 //! Destructor
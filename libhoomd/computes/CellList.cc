@@ -78,6 +78,7 @@ CellList::CellList(boost::shared_ptr<SystemDefinition> sysdef)
     m_particles_sorted = false;
     m_box_changed = false;
     m_multiple = 1;
+    m_width_tolerance = Scalar(0.1);
 
     GPUFlags<uint3> conditions(exec_conf);
     m_conditions.swap(conditions);
@@ -109,6 +110,16 @@ static unsigned int roundDown(unsigned int v, unsigned int m)
     return d*m;
     }
 
+//! Round up to the nearest multiple
+/*! \param v Value to round
+    \param m Multiple
+    \returns \a v if it is a multiple of \a m, otherwise, \a v rounded up to the nearest multiple of \a m.
+*/
+static unsigned int roundUp(unsigned int v, unsigned int m)
+    {
+    return roundDown(v + m - 1, m);
+    }
+
 /*! \returns Cell dimensions that match with the current width, box dimension, and max_cells setting
 */
 uint3 CellList::computeDimensions()
@@ -199,6 +210,19 @@ void CellList::compute(unsigned int timestep)
             // number of bins has not changed, only need to update width
             initializeWidth();
             }
+        else if (canKeepDimensions(new_dim))
+            {
+            // the existing cells are stretched with the box, memory and the adjacency list stay the same
+            initializeGhostWidth();
+            }
+        else if (new_dim.x < m_dim.x || new_dim.y < m_dim.y || new_dim.z < m_dim.z)
+            {
+            // the box shrinks, reinitialize memory for cells as wide as the tolerance allows so that further
+            // compression can stretch them
+            m_dim = computeCompressedDimensions(new_dim);
+            initializeGhostWidth();
+            initializeMemory();
+            }
         else
             {
             // number of bins has changed, need to fully reinitialize memory
@@ -291,6 +315,14 @@ void CellList::initializeWidth()
     // initialize dimensions and width
     m_dim = computeDimensions();
 
+    initializeGhostWidth();
+
+    if (m_prof)
+        m_prof->pop();
+    }
+
+void CellList::initializeGhostWidth()
+    {
     const BoxDim& box = m_pdata->getBox();
 
     // the number of ghost cells along every non-periodic direction is two (one on each side)
@@ -308,10 +340,68 @@ void CellList::initializeWidth()
     m_ghost_width = make_scalar3(L.x/(Scalar)(m_dim.x-m_num_ghost_cells.x)*(Scalar)(m_num_ghost_cells.x/2),
                              L.y/(Scalar)(m_dim.y-m_num_ghost_cells.y)*(Scalar)(m_num_ghost_cells.y/2),
                              L.z/(Scalar)(m_dim.z-m_num_ghost_cells.z)*(Scalar)(m_num_ghost_cells.z/2));
+    }
 
-    if (m_prof)
-        m_prof->pop();
+/*! \param new_dim Dimensions computeDimensions() gives for the current box
+    \returns Cell dimensions for a shrinking box
+
+    Along every direction, the fewest cells are used that are at most m_width_tolerance wider than the nominal width,
+    rounded up to the multiple. Cells are never narrower than in \a new_dim.
+*/
+uint3 CellList::computeCompressedDimensions(const uint3& new_dim)
+    {
+    const BoxDim& box = m_pdata->getBox();
+    Scalar3 L = box.getNearestPlaneDistance();
+    Scalar max_width = m_nominal_width * (Scalar(1.0) + m_width_tolerance);
+
+    uint3 ghosts = make_uint3(box.getPeriodic().x ? 0 : 2, box.getPeriodic().y ? 0 : 2, box.getPeriodic().z ? 0 : 2);
+    uint3 dim = new_dim;
+
+    // number of cells inside the domain along each direction
+    unsigned int n_x = roundUp((unsigned int)(ceil(L.x / max_width)), m_multiple);
+    unsigned int n_y = roundUp((unsigned int)(ceil(L.y / max_width)), m_multiple);
+    unsigned int n_z = roundUp((unsigned int)(ceil(L.z / max_width)), m_multiple);
+
+    if (n_x > 0 && n_x + ghosts.x < dim.x)
+        dim.x = n_x + ghosts.x;
+    if (n_y > 0 && n_y + ghosts.y < dim.y)
+        dim.y = n_y + ghosts.y;
+    if (m_sysdef->getNDimensions() == 3 && n_z > 0 && n_z + ghosts.z < dim.z)
+        dim.z = n_z + ghosts.z;
+
+    return dim;
+    }
+
+/*! \param new_dim Dimensions computeDimensions() gives for the current box
+    \returns true if the current dimensions can be kept
+
+    The cells must not be narrower than the nominal width in any direction, and not more than m_width_tolerance wider
+    than it in directions where computeDimensions() would add cells.
+*/
+bool CellList::canKeepDimensions(const uint3& new_dim)
+    {
+    if (m_dim.x > new_dim.x || m_dim.y > new_dim.y || m_dim.z > new_dim.z)
+        return false;
+
+    // a change in the boundary conditions changes the ghost layers
+    const BoxDim& box = m_pdata->getBox();
+    if ((m_num_ghost_cells.x == 0) != bool(box.getPeriodic().x) || (m_num_ghost_cells.y == 0) != bool(box.getPeriodic().y))
+        return false;
+    if (m_sysdef->getNDimensions() == 3 && (m_num_ghost_cells.z == 0) != bool(box.getPeriodic().z))
+        return false;
+
+    Scalar3 L = box.getNearestPlaneDistance();
+    Scalar max_width = m_nominal_width * (Scalar(1.0) + m_width_tolerance);
+
+    if (m_dim.x < new_dim.x && L.x / Scalar(m_dim.x - m_num_ghost_cells.x) > max_width)
+        return false;
+    if (m_dim.y < new_dim.y && L.y / Scalar(m_dim.y - m_num_ghost_cells.y) > max_width)
+        return false;
+    if (m_sysdef->getNDimensions() == 3 && m_dim.z < new_dim.z
+        && L.z / Scalar(m_dim.z - m_num_ghost_cells.z) > max_width)
+        return false;
 
+    return true;
     }
 
 void CellList::initializeMemory()
@@ -706,6 +796,7 @@ void export_CellList()
         .def("setNominalWidth", &CellList::setNominalWidth)
         .def("setRadius", &CellList::setRadius)
         .def("setMaxCells", &CellList::setMaxCells)
+        .def("setWidthTolerance", &CellList::setWidthTolerance)
         .def("setComputeTDB", &CellList::setComputeTDB)
         .def("setFlagCharge", &CellList::setFlagCharge)
         .def("setFlagIndex", &CellList::setFlagIndex)
@@ -123,6 +123,16 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
      - \c max_cells - maximum number of cells to allocate
      - \c multiple - Round down to the nearest multiple number of cells in each direction (only applied to cells
                      inside the domain, not the ghost cells).
+     - \c width_tolerance - relative amount by which cells may grow wider than \c width before the cell dimensions are
+                     recomputed on a box change
+
+    <b>Box changes:</b>
+    When the box shrinks so that a cell would become narrower than the nominal width, or a box change requires
+    a different number of cells for more than \c width_tolerance growth, memory is reallocated and the adjacency list
+    rebuilt. Otherwise, the existing cells are simply stretched with the box. A reallocation for a shrinking box uses
+    cells up to \c width_tolerance wider than \c width, so that the following compression is absorbed the same way.
+    A box that is compressed or expanded gradually, such as by BoxResizeUpdater, therefore only reallocates every few
+    percent of change in box length.
 
     After a set call is made to adjust a parameter, changes do not take effect until the next call to compute().
 
@@ -227,6 +237,12 @@ class CellList : public Compute
             m_box_changed = true;
             }
 
+        //! Set the relative amount that cells may grow wider than the nominal width before the dimensions are changed
+        void setWidthTolerance(Scalar width_tolerance)
+            {
+            m_width_tolerance = width_tolerance;
+            }
+
         //! Set the multiple value
         void setMultiple(unsigned int multiple)
             {
@@ -354,6 +370,7 @@ class CellList : public Compute
         bool m_particles_sorted;     //!< Set to true when the particles have been sorted
         bool m_box_changed;          //!< Set to ttrue when the box size has changed
         unsigned int m_multiple;     //!< Round cell dimensions down to a multiple of this value
+        Scalar m_width_tolerance;    //!< Relative growth of the cell width tolerated on box changes
 
         // parameters determined by initialize
         uint3 m_dim;                 //!< Current dimensions
@@ -384,6 +401,15 @@ class CellList : public Compute
         //! Initialize width
         void initializeWidth();
 
+        //! Initialize the ghost cell layer for the current dimensions
+        void initializeGhostWidth();
+
+        //! Test if the current dimensions remain valid for the box
+        bool canKeepDimensions(const uint3& new_dim);
+
+        //! Compute the dimensions to allocate when the box shrinks
+        uint3 computeCompressedDimensions(const uint3& new_dim);
+
         //! Initialize indexers and allocate memory
         void initializeMemory();
 
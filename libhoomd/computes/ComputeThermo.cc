@@ -55,6 +55,8 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "ComputeThermo.h"
 #include <boost/python.hpp>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
 using namespace boost::python;
 
 #ifdef ENABLE_MPI
@@ -63,6 +65,7 @@ using namespace boost::python;
 #endif
 
 #include <iostream>
+#include <algorithm>
 using namespace std;
 
 /*! \param sysdef System for which to compute thermodynamic properties
@@ -312,6 +315,33 @@ void ComputeThermo::computeProperties()
             }
         }
 
+    double pressure_kinetic[6] = { pressure_kinetic_xx, pressure_kinetic_xy, pressure_kinetic_xz,
+                                   pressure_kinetic_yy, pressure_kinetic_yz, pressure_kinetic_zz };
+    double virial[6] = { virial_xx, virial_xy, virial_xz, virial_yy, virial_yz, virial_zz };
+    storeProperties(ke_total, pe_total, W, pressure_kinetic, virial);
+
+    #ifdef ENABLE_MPI
+    // in MPI, reduce extensive quantities only when they're needed
+    m_properties_reduced = !m_pdata->getDomainDecomposition();
+    #endif // ENABLE_MPI
+
+    if (m_prof) m_prof->pop();
+    }
+
+/*! \param ke_total Total kinetic energy of the group
+    \param pe_total Total potential energy of the group
+    \param W Isotropic virial of the group (including the 1/3 factor)
+    \param pressure_kinetic Kinetic part of the upper triangular pressure tensor (xx, xy, xz, yy, yz, zz)
+    \param virial Upper triangular virial tensor (xx, xy, xz, yy, yz, zz)
+
+    Converts the sums over the group members into the thermodynamic properties and stores them in m_properties.
+*/
+void ComputeThermo::storeProperties(double ke_total,
+                                    double pe_total,
+                                    double W,
+                                    const double *pressure_kinetic,
+                                    const double *virial)
+    {
     // compute the temperature
     Scalar temperature = Scalar(2.0) * Scalar(ke_total) / Scalar(m_ndof);
 
@@ -337,33 +367,290 @@ void ComputeThermo::computeProperties()
     // pressure: P = (N * K_B * T + W)/V
     Scalar pressure =  (2.0 * ke_total / Scalar(D) + W) / volume;
 
-    // pressure tensor = (kinetic part + virial) / V
-    Scalar pressure_xx = (pressure_kinetic_xx + virial_xx) / volume;
-    Scalar pressure_xy = (pressure_kinetic_xy + virial_xy) / volume;
-    Scalar pressure_xz = (pressure_kinetic_xz + virial_xz) / volume;
-    Scalar pressure_yy = (pressure_kinetic_yy + virial_yy) / volume;
-    Scalar pressure_yz = (pressure_kinetic_yz + virial_yz) / volume;
-    Scalar pressure_zz = (pressure_kinetic_zz + virial_zz) / volume;
-
     // fill out the GPUArray
     ArrayHandle<Scalar> h_properties(m_properties, access_location::host, access_mode::overwrite);
     h_properties.data[thermo_index::temperature] = temperature;
     h_properties.data[thermo_index::pressure] = pressure;
     h_properties.data[thermo_index::kinetic_energy] = Scalar(ke_total);
     h_properties.data[thermo_index::potential_energy] = Scalar(pe_total);
-    h_properties.data[thermo_index::pressure_xx] = pressure_xx;
-    h_properties.data[thermo_index::pressure_xy] = pressure_xy;
-    h_properties.data[thermo_index::pressure_xz] = pressure_xz;
-    h_properties.data[thermo_index::pressure_yy] = pressure_yy;
-    h_properties.data[thermo_index::pressure_yz] = pressure_yz;
-    h_properties.data[thermo_index::pressure_zz] = pressure_zz;
+
+    // pressure tensor = (kinetic part + virial) / V
+    h_properties.data[thermo_index::pressure_xx] = (pressure_kinetic[0] + virial[0]) / volume;
+    h_properties.data[thermo_index::pressure_xy] = (pressure_kinetic[1] + virial[1]) / volume;
+    h_properties.data[thermo_index::pressure_xz] = (pressure_kinetic[2] + virial[2]) / volume;
+    h_properties.data[thermo_index::pressure_yy] = (pressure_kinetic[3] + virial[3]) / volume;
+    h_properties.data[thermo_index::pressure_yz] = (pressure_kinetic[4] + virial[4]) / volume;
+    h_properties.data[thermo_index::pressure_zz] = (pressure_kinetic[5] + virial[5]) / volume;
+    }
+
+/*! \param args Particle data and group membership flags
+    \param first First particle index to sum
+    \param last One past the last particle index to sum
+    \param sums Output: num_fused_sums sums per group, added to the values already there
+
+    Each particle is read once and its contributions are added to the sums of every group it belongs to.
+*/
+void ComputeThermo::sumFusedRange(const FusedArgs& args, unsigned int first, unsigned int last, double *sums)
+    {
+    unsigned int num_groups = args.is_member.size();
+    unsigned int virial_pitch = args.virial_pitch;
+
+    for (unsigned int j = first; j < last; j++)
+        {
+        // read the particle data once
+        double mass = args.vel[j].w;
+        double vx = args.vel[j].x;
+        double vy = args.vel[j].y;
+        double vz = args.vel[j].z;
+        double pe = args.net_force[j].w;
+        double v_xx = args.net_virial[j+0*virial_pitch];
+        double v_xy = args.net_virial[j+1*virial_pitch];
+        double v_xz = args.net_virial[j+2*virial_pitch];
+        double v_yy = args.net_virial[j+3*virial_pitch];
+        double v_yz = args.net_virial[j+4*virial_pitch];
+        double v_zz = args.net_virial[j+5*virial_pitch];
+
+        double p_xx = mass*vx*vx;
+        double p_xy = mass*vx*vy;
+        double p_xz = mass*vx*vz;
+        double p_yy = mass*vy*vy;
+        double p_yz = mass*vy*vz;
+        double p_zz = mass*vz*vz;
+
+        // and add it to every group it belongs to
+        for (unsigned int g = 0; g < num_groups; g++)
+            {
+            if (!args.is_member[g][j])
+                continue;
+
+            double *s = &sums[g*num_fused_sums];
+            s[0] += p_xx + p_yy + p_zz;
+            s[1] += pe;
+            s[2] += v_xx + v_yy + v_zz;
+            s[3] += p_xx;
+            s[4] += p_xy;
+            s[5] += p_xz;
+            s[6] += p_yy;
+            s[7] += p_yz;
+            s[8] += p_zz;
+            s[9] += v_xx;
+            s[10] += v_xy;
+            s[11] += v_xz;
+            s[12] += v_yy;
+            s[13] += v_yz;
+            s[14] += v_zz;
+            }
+        }
+    }
+
+/*! \param thermos List of computes to evaluate
+    \param timestep Current time step of the simulation
+    \param num_threads Number of threads to split the particles over, 0 picks the number of cores (and at most one
+           thread per 4096 particles, below which starting a thread costs more than it saves)
+
+    Every compute in \a thermos that needs updating at \a timestep is evaluated in a single pass over the particle data.
+    Each particle is read once and its contributions are accumulated (in double precision) into the sums of every
+    group it belongs to, using the per-index membership flags of the groups. Computes that implement their own
+    computeProperties() (i.e. ComputeThermoGPU) are evaluated separately with compute().
+
+    Each thread sums a contiguous range of particles into its own partial sums, which are then added up in thread
+    order. The result is deterministic for a given number of threads.
+
+    In MPI simulations, the properties of all fused computes are reduced with a single MPI_Allreduce.
+
+    The result is the same as calling compute() on each member of \a thermos, up to the rounding of the sums.
+*/
+void ComputeThermo::computeMany(const std::vector< boost::shared_ptr<ComputeThermo> >& thermos,
+                                unsigned int timestep,
+                                unsigned int num_threads)
+    {
+    // select the computes that take part in the fused pass
+    std::vector< ComputeThermo* > fused;
+    for (unsigned int i = 0; i < thermos.size(); i++)
+        {
+        ComputeThermo *thermo = thermos[i].get();
+        if (!thermo->canComputeFused())
+            {
+            thermo->compute(timestep);
+            continue;
+            }
+
+        // a compute listed more than once is only evaluated once
+        if (std::find(fused.begin(), fused.end(), thermo) != fused.end())
+            continue;
+
+        if (!thermo->shouldCompute(timestep))
+            continue;
+
+        // the single group code path drops out for empty groups, too
+        if (thermo->m_group->getNumMembersGlobal() == 0)
+            continue;
+
+        fused.push_back(thermo);
+        }
+
+    if (fused.size() == 0)
+        return;
+
+    // all computes must act on the same particle data
+    boost::shared_ptr<ParticleData> pdata = fused[0]->m_pdata;
+    for (unsigned int g = 0; g < fused.size(); g++)
+        {
+        if (fused[g]->m_pdata != pdata)
+            {
+            fused[0]->m_exec_conf->msg->error() << "compute.thermo: Cannot evaluate computes of different systems together"
+                                                << endl;
+            throw runtime_error("Error computing thermodynamic properties");
+            }
+        }
+
+    boost::shared_ptr<Profiler> prof = fused[0]->m_prof;
+    if (prof) prof->push("Thermo");
+
+    unsigned int num_groups = fused.size();
+
+    // acquire the membership flags of all groups (this may rebuild the index lists, so do it before accessing the
+    // particle data)
+    std::vector< const GPUArray<unsigned char>* > member_flags(num_groups);
+    for (unsigned int g = 0; g < num_groups; g++)
+        member_flags[g] = &fused[g]->m_group->getMemberFlagArray();
+
+    PDataFlags flags = pdata->getFlags();
+    bool compute_tensor = flags[pdata_flag::pressure_tensor];
+    bool compute_pe = flags[pdata_flag::potential_energy];
+    bool compute_virial = flags[pdata_flag::isotropic_virial];
+
+    // per group sums: kinetic energy (2x), potential energy, isotropic virial (3x), kinetic pressure tensor, virial
+    // tensor
+    const unsigned int num_sums = num_fused_sums;
+    std::vector<double> sums(num_groups*num_sums, 0.0);
+
+        {
+        ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_net_force(pdata->getNetForce(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_net_virial(pdata->getNetVirial(), access_location::host, access_mode::read);
+
+        FusedArgs args;
+        args.vel = h_vel.data;
+        args.net_force = h_net_force.data;
+        args.net_virial = h_net_virial.data;
+        args.virial_pitch = pdata->getNetVirial().getPitch();
+        args.is_member.resize(num_groups);
+
+        std::vector< boost::shared_ptr< ArrayHandle<unsigned char> > > member_handles;
+        for (unsigned int g = 0; g < num_groups; g++)
+            {
+            // computes may share a group, whose flags can only be acquired once
+            unsigned int other = std::find(member_flags.begin(), member_flags.begin() + g, member_flags[g])
+                                 - member_flags.begin();
+            if (other < g)
+                {
+                args.is_member[g] = args.is_member[other];
+                continue;
+                }
+
+            member_handles.push_back(boost::shared_ptr< ArrayHandle<unsigned char> >(
+                new ArrayHandle<unsigned char>(*member_flags[g], access_location::host, access_mode::read)));
+            args.is_member[g] = member_handles.back()->data;
+            }
+
+        unsigned int nparticles = pdata->getN();
+        if (num_threads == 0)
+            {
+            num_threads = boost::thread::hardware_concurrency();
+            num_threads = std::min(num_threads, nparticles / 4096);
+            }
+        num_threads = std::max(1u, std::min(num_threads, nparticles));
+
+        if (num_threads == 1)
+            sumFusedRange(args, 0, nparticles, &sums[0]);
+        else
+            {
+            // partial sums of each thread
+            std::vector<double> thread_sums(num_threads*num_groups*num_sums, 0.0);
+            boost::thread_group threads;
+            for (unsigned int i = 0; i < num_threads; i++)
+                {
+                unsigned int first = (unsigned int)((unsigned long long)nparticles * i / num_threads);
+                unsigned int last = (unsigned int)((unsigned long long)nparticles * (i+1) / num_threads);
+                threads.create_thread(boost::bind(&ComputeThermo::sumFusedRange, boost::cref(args), first, last,
+                                                  &thread_sums[i*num_groups*num_sums]));
+                }
+            threads.join_all();
+
+            for (unsigned int i = 0; i < num_threads; i++)
+                for (unsigned int k = 0; k < num_groups*num_sums; k++)
+                    sums[k] += thread_sums[i*num_groups*num_sums + k];
+            }
+        }
+
+    // convert the sums into the properties of each group, following the same rules as computeProperties()
+    for (unsigned int g = 0; g < num_groups; g++)
+        {
+        ComputeThermo *thermo = fused[g];
+        assert(thermo->m_ndof != 0);
+        const double *s = &sums[g*num_sums];
+
+        double ke_total = 0.5*s[0];
+        double pe_total = compute_pe ? s[1] : 0.0;
+
+        double pressure_kinetic[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+        double virial[6];
+        for (unsigned int i = 0; i < 6; i++)
+            virial[i] = pdata->getExternalVirial(i);
+
+        double W = 0.0;
+        if (compute_tensor)
+            {
+            for (unsigned int i = 0; i < 6; i++)
+                {
+                pressure_kinetic[i] = s[3+i];
+                virial[i] += s[9+i];
+                }
+
+            // kinetic energy = 1/2 trace of kinetic part of pressure tensor
+            ke_total = 0.5*(pressure_kinetic[0] + pressure_kinetic[3] + pressure_kinetic[5]);
+
+            // isotropic virial = 1/3 trace of virial tensor
+            if (compute_virial)
+                W = Scalar(1./3.) * (virial[0] + virial[3] + virial[5]);
+            }
+        else if (compute_virial)
+            {
+            W = Scalar(1./3.) * s[2];
+            }
+
+        thermo->storeProperties(ke_total, pe_total, W, pressure_kinetic, virial);
+        }
 
     #ifdef ENABLE_MPI
-    // in MPI, reduce extensive quantities only when they're needed
-    m_properties_reduced = !m_pdata->getDomainDecomposition();
-    #endif // ENABLE_MPI
+    if (pdata->getDomainDecomposition())
+        {
+        // reduce the properties of all groups at once
+        unsigned int num_quantities = thermo_index::num_quantities;
+        std::vector<Scalar> properties(num_groups*num_quantities);
+        for (unsigned int g = 0; g < num_groups; g++)
+            {
+            ArrayHandle<Scalar> h_properties(fused[g]->m_properties, access_location::host, access_mode::read);
+            std::copy(h_properties.data, h_properties.data + num_quantities, properties.begin() + g*num_quantities);
+            }
 
-    if (m_prof) m_prof->pop();
+        MPI_Allreduce(MPI_IN_PLACE, &properties.front(), num_groups*num_quantities, MPI_HOOMD_SCALAR,
+                MPI_SUM, fused[0]->m_exec_conf->getMPICommunicator());
+
+        for (unsigned int g = 0; g < num_groups; g++)
+            {
+            ArrayHandle<Scalar> h_properties(fused[g]->m_properties, access_location::host, access_mode::overwrite);
+            std::copy(properties.begin() + g*num_quantities, properties.begin() + (g+1)*num_quantities,
+                      h_properties.data);
+            }
+        }
+
+    for (unsigned int g = 0; g < num_groups; g++)
+        fused[g]->m_properties_reduced = true;
+    #endif
+
+    if (prof) prof->pop();
     }
 
 #ifdef ENABLE_MPI
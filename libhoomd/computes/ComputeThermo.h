@@ -93,6 +93,10 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
     to each quantity provided to the logger. Typical usage is to provide _groupname as the suffix so that properties
     of different groups can be logged seperately (e.g. temperature_group1 and temperature_group2).
 
+    When many groups are evaluated at the same point in a time step (i.e. by the Logger), computeMany() evaluates them
+    all with a single pass over the particle data and a single MPI reduction instead of one of each per group. The
+    pass is split over several threads, each summing a range of particles.
+
     \ingroup computes
 */
 class ComputeThermo : public Compute
@@ -109,6 +113,11 @@ class ComputeThermo : public Compute
         //! Compute the temperature
         virtual void compute(unsigned int timestep);
 
+        //! Compute the properties of many groups in a single pass over the particle data
+        static void computeMany(const std::vector< boost::shared_ptr<ComputeThermo> >& thermos,
+                                unsigned int timestep,
+                                unsigned int num_threads=0);
+
         //! Change the number of degrees of freedom
         void setNDOF(unsigned int ndof);
 
@@ -249,6 +258,37 @@ class ComputeThermo : public Compute
         //! Does the actual computation
         virtual void computeProperties();
 
+        //! Stores the properties computed from the sums over the group members
+        void storeProperties(double ke_total,
+                             double pe_total,
+                             double W,
+                             const double *pressure_kinetic,
+                             const double *virial);
+
+        //! Data shared by all threads in computeMany()
+        struct FusedArgs
+            {
+            const Scalar4 *vel;                         //!< Particle velocities and masses
+            const Scalar4 *net_force;                   //!< Net force and potential energy of the particles
+            const Scalar *net_virial;                   //!< Net virial of the particles
+            unsigned int virial_pitch;                  //!< Pitch of the net virial array
+            std::vector<const unsigned char *> is_member;   //!< Membership flags of each group
+            };
+
+        //! Number of per group sums accumulated by computeMany()
+        static const unsigned int num_fused_sums = 15;
+
+        //! Sums the contributions of a range of particles to every group in computeMany()
+        static void sumFusedRange(const FusedArgs& args, unsigned int first, unsigned int last, double *sums);
+
+        //! Test if this compute can take part in computeMany()
+        /*! Derived classes that override computeProperties() must return false.
+        */
+        virtual bool canComputeFused() const
+            {
+            return true;
+            }
+
         #ifdef ENABLE_MPI
         bool m_properties_reduced;      //!< True if properties have been reduced across MPI
 
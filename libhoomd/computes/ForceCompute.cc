@@ -78,7 +78,7 @@ using namespace boost;
     \post \c force and \c virial GPUarrays are initialized
     \post All forces are initialized to 0
 */
-ForceCompute::ForceCompute(boost::shared_ptr<SystemDefinition> sysdef) : Compute(sysdef), m_particles_sorted(false)
+ForceCompute::ForceCompute(boost::shared_ptr<SystemDefinition> sysdef) : Compute(sysdef), m_particles_sorted(false), m_particles_migrated(false)
     {
     assert(m_pdata);
     assert(m_pdata->getMaxN() > 0);
@@ -97,6 +97,11 @@ ForceCompute::ForceCompute(boost::shared_ptr<SystemDefinition> sysdef) : Compute
     // connect to the ParticleData to recieve notifications when particles change order in memory
     m_sort_connection = m_pdata->connectParticleSort(bind(&ForceCompute::setParticlesSorted, this));
 
+#ifdef ENABLE_MPI
+    // connect to the ParticleData to receive notifications when particles migrate between domains
+    m_migrate_connection = m_pdata->connectParticleMigration(bind(&ForceCompute::setParticlesMigrated, this));
+#endif
+
     // connect to the ParticleData to receive notifications when the maximum number of particles changes
     m_max_particle_num_change_connection = m_pdata->connectMaxParticleNumberChange(bind(&ForceCompute::reallocate, this));
 
@@ -123,6 +128,9 @@ void ForceCompute::reallocate()
 ForceCompute::~ForceCompute()
     {
     m_sort_connection.disconnect();
+#ifdef ENABLE_MPI
+    m_migrate_connection.disconnect();
+#endif
     m_max_particle_num_change_connection.disconnect();
     }
 
@@ -165,6 +173,7 @@ void ForceCompute::compute(unsigned int timestep)
 
     computeForces(timestep);
     m_particles_sorted = false;
+    m_particles_migrated = false;
     }
 
 /*! \param num_iters Number of iterations to average for the benchmark
@@ -155,6 +155,18 @@ class ForceCompute : public Compute
             return m_torque;
             }
 
+        //! Test if the particles have been reordered since the forces were last computed
+        bool getParticlesSorted() const
+            {
+            return m_particles_sorted;
+            }
+
+        //! Test if particles have migrated into or out of the local domain since the forces were last computed
+        bool getParticlesMigrated() const
+            {
+            return m_particles_migrated;
+            }
+
         //! Get the contribution to the external virial
         Scalar getExternalVirial(unsigned int dir)
             {
@@ -175,6 +187,7 @@ class ForceCompute : public Compute
 
     protected:
         bool m_particles_sorted;    //!< Flag set to true when particles are resorted in memory
+        bool m_particles_migrated;  //!< Flag set to true when the local particles change by domain migration
 
         //! Helper function called when particles are sorted
         /*! setParticlesSorted() is passed as a slot to the particle sort signal.
@@ -187,6 +200,12 @@ class ForceCompute : public Compute
             m_particles_sorted = true;
             }
 
+        //! Helper function called when particles migrate between domains
+        void setParticlesMigrated()
+            {
+            m_particles_migrated = true;
+            }
+
         //! Reallocate internal arrays
         void reallocate();
 
@@ -210,6 +229,11 @@ class ForceCompute : public Compute
         //! Connection to the signal notifying when particles are resorted
         boost::signals2::connection m_sort_connection;
 
+        #ifdef ENABLE_MPI
+        //! Connection to the signal notifying when particles migrate between domains
+        boost::signals2::connection m_migrate_connection;
+        #endif
+
         //! Connection to the signal notifying when maximum number of particles changes
         boost::signals2::connection m_max_particle_num_change_connection;
 
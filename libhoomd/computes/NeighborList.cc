@@ -1387,6 +1387,7 @@ void export_NeighborList()
                      .def("forceUpdate", &NeighborList::forceUpdate)
                      .def("estimateNNeigh", &NeighborList::estimateNNeigh)
                      .def("getSmallestRebuild", &NeighborList::getSmallestRebuild)
+                     .def("getRBuff", &NeighborList::getRBuff)
                      .def("getNumUpdates", &NeighborList::getNumUpdates)
                      .def("getNumExclusions", &NeighborList::getNumExclusions)
                      .def("wantExclusions", &NeighborList::wantExclusions)
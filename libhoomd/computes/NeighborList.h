@@ -209,6 +209,36 @@ class NeighborList : public Compute
             return m_storage_mode;
             }
 
+        //! Get the cutoff radius
+        Scalar getRCut()
+            {
+            return m_r_cut;
+            }
+
+        //! Get the buffer radius
+        Scalar getRBuff()
+            {
+            return m_r_buff;
+            }
+
+        //! Get the maximum diameter
+        Scalar getMaximumDiameter()
+            {
+            return m_d_max;
+            }
+
+        //! Get the number of steps between the last build and the first distance check
+        unsigned int getEvery()
+            {
+            return m_every;
+            }
+
+        //! Test if distance checks are enabled
+        bool getDistCheck()
+            {
+            return m_dist_check;
+            }
+
         // @}
         //! \name Statistics
         // @{
@@ -222,6 +252,21 @@ class NeighborList : public Compute
         //! Gets the shortest rebuild period this nlist has experienced since a call to resetStats
         unsigned int getSmallestRebuild();
 
+        //! Get the number of dangerous builds since a call to resetStats
+        int64_t getNumDangerousUpdates()
+            {
+            return m_dangerous_updates;
+            }
+
+        //! Get the histogram of rebuild periods since a call to resetStats
+        /*! Element \a i counts the builds that occured \a i steps after the previous one. The last element also
+            counts all longer periods.
+        */
+        const std::vector<unsigned int>& getUpdatePeriods()
+            {
+            return m_update_periods;
+            }
+
         // @}
         //! \name Get data
         // @{
@@ -405,6 +450,12 @@ class NeighborList : public Compute
             return m_last_updated_tstep == timestep && m_has_been_updated_once;
             }
 
+        //! Return true if the neighbor list has been built at least once
+        bool hasBeenUpdatedOnce()
+            {
+            return m_has_been_updated_once;
+            }
+
    protected:
         Scalar m_r_cut;             //!< The cuttoff radius
         Scalar m_r_buff;            //!< The buffer around the cuttoff
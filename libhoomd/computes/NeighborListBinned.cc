@@ -74,7 +74,22 @@ NeighborListBinned::NeighborListBinned(boost::shared_ptr<SystemDefinition> sysde
     if (!m_cl)
         m_cl = boost::shared_ptr<CellList>(new CellList(sysdef));
 
-    m_cl->setNominalWidth(r_cut + r_buff + m_d_max - Scalar(1.0));
+    // cell width multipliers in percent of the minimum cell width
+    std::vector<unsigned int> valid_params;
+    valid_params.push_back(100);
+    valid_params.push_back(115);
+    valid_params.push_back(130);
+    valid_params.push_back(150);
+
+    m_tuner.reset(new Autotuner(valid_params, 5, 100000, "nlist_binned_cell_width", this->m_exec_conf));
+    m_last_tuned_timestep = 0;
+
+    #ifdef ENABLE_MPI
+    // synchronize autotuner results across ranks
+    m_tuner->setSync(m_pdata->getDomainDecomposition());
+    #endif
+
+    updateCellWidth();
     m_cl->setRadius(1);
     m_cl->setComputeTDB(false);
     m_cl->setFlagIndex();
@@ -90,7 +105,7 @@ void NeighborListBinned::setRCut(Scalar r_cut, Scalar r_buff)
     {
     NeighborList::setRCut(r_cut, r_buff);
 
-    m_cl->setNominalWidth(r_cut + r_buff + m_d_max - Scalar(1.0));
+    updateCellWidth();
     }
 
 void NeighborListBinned::setMaximumDiameter(Scalar d_max)
@@ -98,11 +113,29 @@ void NeighborListBinned::setMaximumDiameter(Scalar d_max)
     NeighborList::setMaximumDiameter(d_max);
 
     // need to update the cell list settings appropriately
-    m_cl->setNominalWidth(m_r_cut + m_r_buff + m_d_max - Scalar(1.0));
+    updateCellWidth();
+    }
+
+/*! The cell list is only touched when the width actually changes, since a new nominal width forces it to
+    reinitialize.
+*/
+void NeighborListBinned::updateCellWidth()
+    {
+    Scalar width = (m_r_cut + m_r_buff + m_d_max - Scalar(1.0)) * Scalar(m_tuner->getParam()) / Scalar(100.0);
+
+    if (width != m_cl->getNominalWidth())
+        m_cl->setNominalWidth(width);
     }
 
 void NeighborListBinned::buildNlist(unsigned int timestep)
     {
+    // only time the first build on a given step
+    bool tune = m_last_tuned_timestep != timestep;
+    if (tune) m_tuner->begin();
+
+    // the tuner may have moved on to a new cell width
+    updateCellWidth();
+
     m_cl->compute(timestep);
 
     uint3 dim = m_cl->getDim();
@@ -238,6 +271,9 @@ void NeighborListBinned::buildNlist(unsigned int timestep)
     // write out conditions
     m_conditions.resetFlags(conditions);
 
+    if (tune) m_tuner->end();
+    m_last_tuned_timestep = timestep;
+
     if (m_prof)
         m_prof->pop(exec_conf);
     }
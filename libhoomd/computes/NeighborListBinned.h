@@ -51,6 +51,9 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "NeighborList.h"
 #include "CellList.h"
+#include "Autotuner.h"
+
+#include <boost/scoped_ptr.hpp>
 
 /*! \file NeighborListBinned.h
     \brief Declares the NeighborListBinned class
@@ -66,6 +69,10 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 //! Efficient neighbor list build on the CPU
 /*! Implements the O(N) neighbor list build on the CPU using a cell list.
 
+    The nominal cell width is autotuned as a multiple of the minimum width r_cut + r_buff + d_max - 1. Wider cells
+    hold more particles and check more distant pairs, but reduce the number of cells that need to be walked. The
+    multiplier is given in percent and is never less than 100, so the 27 cell stencil always covers the cutoff.
+
     \ingroup computes
 */
 class NeighborListBinned : public NeighborList
@@ -86,8 +93,24 @@ class NeighborListBinned : public NeighborList
         //! Set the maximum diameter to use in computing neighbor lists
         virtual void setMaximumDiameter(Scalar d_max);
 
+        //! Set autotuner parameters
+        /*! \param enable Enable/disable autotuning
+            \param period period (approximate) in time steps when returning occurs
+        */
+        virtual void setAutotunerParams(bool enable, unsigned int period)
+            {
+            NeighborList::setAutotunerParams(enable, period);
+            m_tuner->setPeriod(period/10);
+            m_tuner->setEnabled(enable);
+            }
+
     protected:
         boost::shared_ptr<CellList> m_cl;   //!< The cell list
+        boost::scoped_ptr<Autotuner> m_tuner; //!< Autotuner for the cell width multiplier (in percent)
+        unsigned int m_last_tuned_timestep; //!< Last tuning timestep
+
+        //! Set the nominal cell width from the cutoff and the current tuner parameter
+        void updateCellWidth();
 
         //! Builds the neighbor list
         virtual void buildNlist(unsigned int timestep);
@@ -89,6 +89,12 @@ class ComputeThermoGPU : public ComputeThermo
 
         //! Does the actual computation
         virtual void computeProperties();
+
+        //! The GPU computation cannot be fused with other computes
+        virtual bool canComputeFused() const
+            {
+            return false;
+            }
     };
 
 //! Exports the ComputeThermoGPU class to python
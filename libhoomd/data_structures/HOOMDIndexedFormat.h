@@ -0,0 +1,307 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+/*! \file HOOMDIndexedFormat.h
+    \brief Declares the on-disk layout of the indexed binary trajectory format
+*/
+
+#ifndef __HOOMD_INDEXED_FORMAT_H__
+#define __HOOMD_INDEXED_FORMAT_H__
+
+#include <vector>
+#include <cstring>
+
+#include <boost/cstdint.hpp>
+
+//! \name Indexed binary trajectory format
+/*! The indexed format stores any number of frames in a single file, written by HOOMDIndexedDumpWriter and
+    read by HOOMDIndexedInitializer. Every frame is split into named per-field chunks (position, velocity, bond,
+    ...), and each chunk is stored independently so that a reader can memory map the file and decode only the
+    fields it needs from the frame it wants.
+
+    Layout (all values in native byte order):
+     - File header: IndexedFileHeader
+     - Frames, each consisting of an IndexedFrameHeader, \a num_chunks IndexedChunkEntry records, the
+       stored chunk data and an IndexedFrameTrailer. Chunk offsets are absolute file offsets.
+     - Frame index: the magic "INDX", a uint64 frame count and one IndexedFrameEntry per frame
+     - Footer: IndexedFooter pointing back to the frame index
+
+    New frames overwrite the old frame index and footer and then write updated ones, so appending never needs
+    to move existing data. Each frame header records the total frame size, so a file whose footer was lost
+    (e.g. the run was killed while writing) can still be recovered by walking the frames from the start.
+    The writer truncates the old index and footer away, stores the chunk table, chunk data and trailer and writes
+    the frame header last. The trailer repeats the frame size and time step and holds a checksum of the whole
+    frame, so a frame that was only partly written is detected and dropped during recovery. Readers also check
+    the last frame listed in the index before trusting it.
+
+    Chunk data may be byte shuffled (all first bytes of each element, then all second bytes, ...) before being
+    compressed, which groups the slowly varying exponent bytes of floating point data together and makes the
+    compressor far more effective on them.
+*/
+//@{
+
+//! Magic string at the start of every indexed file
+const char INDEXED_FILE_MAGIC[8] = {'H','O','O','M','D','I','D','X'};
+//! Magic string at the start of every frame
+const char INDEXED_FRAME_MAGIC[4] = {'F','R','M','E'};
+//! Magic string at the end of every frame
+const char INDEXED_FRAME_END_MAGIC[4] = {'F','E','N','D'};
+//! Magic string at the start of the frame index
+const char INDEXED_INDEX_MAGIC[4] = {'I','N','D','X'};
+//! Magic string at the very end of a complete file
+const char INDEXED_FOOTER_MAGIC[8] = {'H','O','O','M','D','E','N','D'};
+//! Current version of the indexed file format
+const unsigned int INDEXED_FORMAT_VERSION = 2;
+//! Maximum length of a chunk name (including the terminating 0)
+const unsigned int INDEXED_CHUNK_NAME_LEN = 24;
+
+//! Element types stored in a chunk
+enum IndexedElementType
+    {
+    indexed_uint8 = 0,      //!< Raw bytes (strings)
+    indexed_int32,          //!< 32-bit signed integers
+    indexed_uint32,         //!< 32-bit unsigned integers
+    indexed_float32,        //!< Single precision floating point
+    indexed_float64         //!< Double precision floating point
+    };
+
+//! Flags describing how a chunk is encoded
+enum IndexedCodecFlags
+    {
+    indexed_codec_raw = 0,          //!< Stored verbatim
+    indexed_codec_zlib = 1,         //!< Compressed with zlib
+    indexed_codec_shuffle = 2       //!< Bytes shuffled by element before compression
+    };
+
+//! File header
+struct IndexedFileHeader
+    {
+    char magic[8];                  //!< INDEXED_FILE_MAGIC
+    unsigned int version;           //!< INDEXED_FORMAT_VERSION
+    unsigned int reserved;          //!< Unused, written as 0
+    };
+
+//! Header at the start of each frame
+struct IndexedFrameHeader
+    {
+    char magic[4];                  //!< INDEXED_FRAME_MAGIC
+    unsigned int timestep;          //!< Time step of the frame
+    unsigned int dimensions;        //!< Dimensionality of the system
+    unsigned int num_chunks;        //!< Number of IndexedChunkEntry records following the header
+    unsigned int num_particles;     //!< Number of particles in the frame
+    unsigned int reserved;          //!< Unused, written as 0
+    double box[6];                  //!< Lx, Ly, Lz, xy, xz, yz
+    boost::uint64_t frame_size;     //!< Size of the frame in bytes, including this header
+    };
+
+//! Trailer at the end of each frame
+struct IndexedFrameTrailer
+    {
+    char magic[4];                  //!< INDEXED_FRAME_END_MAGIC
+    unsigned int timestep;          //!< Time step of the frame, same as in the header
+    boost::uint64_t frame_size;     //!< Size of the frame in bytes, same as in the header
+    boost::uint64_t checksum;       //!< indexed_checksum() of the frame from the header up to the trailer
+    };
+
+//! Describes a single chunk of a frame
+struct IndexedChunkEntry
+    {
+    char name[INDEXED_CHUNK_NAME_LEN];  //!< Field name, 0 terminated
+    unsigned int codec;                 //!< Combination of IndexedCodecFlags
+    unsigned int elem_type;             //!< IndexedElementType of the stored values
+    unsigned int elem_per_item;         //!< Number of values per particle (or group)
+    unsigned int num_items;             //!< Number of particles (or groups)
+    boost::uint64_t offset;             //!< Absolute file offset of the stored data
+    boost::uint64_t stored_size;        //!< Size of the stored (possibly compressed) data in bytes
+    boost::uint64_t raw_size;           //!< Size of the decoded data in bytes
+    };
+
+//! Entry of the frame index
+struct IndexedFrameEntry
+    {
+    boost::uint64_t offset;         //!< Absolute file offset of the frame header
+    unsigned int timestep;          //!< Time step of the frame
+    unsigned int reserved;          //!< Unused, written as 0
+    };
+
+//! Footer at the end of a complete file
+struct IndexedFooter
+    {
+    boost::uint64_t index_offset;   //!< Absolute file offset of the frame index
+    char magic[8];                  //!< INDEXED_FOOTER_MAGIC
+    };
+
+//! Checksum of a block of data
+/*! \param data Data to checksum
+    \param size Size of the data in bytes
+    \param hash Checksum of the preceding data, to checksum several blocks in sequence
+    \returns 64-bit FNV-1a hash of the data
+*/
+inline boost::uint64_t indexed_checksum(const char *data, boost::uint64_t size,
+                                        boost::uint64_t hash = 14695981039346656037ULL)
+    {
+    for (boost::uint64_t i = 0; i < size; i++)
+        {
+        hash ^= (unsigned char)data[i];
+        hash *= 1099511628211ULL;
+        }
+    return hash;
+    }
+
+//! Checks that a frame in an indexed file was written completely
+/*! \param data Contents of the file
+    \param size Size of the file in bytes
+    \param offset Offset of the frame header
+    \param header Filled out with the frame header
+    \returns true if the frame header, trailer and checksum are valid
+*/
+inline bool indexed_check_frame(const char *data,
+                                boost::uint64_t size,
+                                boost::uint64_t offset,
+                                IndexedFrameHeader& header)
+    {
+    if (offset + sizeof(IndexedFrameHeader) > size)
+        return false;
+    memcpy(&header, data + offset, sizeof(IndexedFrameHeader));
+    if (memcmp(header.magic, INDEXED_FRAME_MAGIC, 4) != 0 ||
+        header.frame_size < sizeof(IndexedFrameHeader) + sizeof(IndexedFrameTrailer) ||
+        header.frame_size > size - offset)
+        return false;
+
+    boost::uint64_t body_size = header.frame_size - sizeof(IndexedFrameTrailer);
+    IndexedFrameTrailer trailer;
+    memcpy(&trailer, data + offset + body_size, sizeof(IndexedFrameTrailer));
+    return memcmp(trailer.magic, INDEXED_FRAME_END_MAGIC, 4) == 0 &&
+           trailer.frame_size == header.frame_size &&
+           trailer.timestep == header.timestep &&
+           trailer.checksum == indexed_checksum(data + offset, body_size);
+    }
+
+//! Reads the frame index of an indexed file
+/*! \param data Contents of the file
+    \param size Size of the file in bytes
+    \param frames Filled out with one entry per complete frame
+    \param end_offset Set to the offset just past the last complete frame (where the next frame goes)
+    \returns true if the file ended with a valid footer, false if the frames had to be recovered by walking the
+             file from the start
+
+    The index is only used when every entry points at a frame header before the index and the last frame is
+    complete and ends exactly where the index starts. Checking the earlier frames in full would read the whole
+    file, which is what the index is there to avoid.
+
+    The caller is responsible for checking the file header before calling this function.
+*/
+inline bool indexed_read_frame_index(const char *data,
+                                     boost::uint64_t size,
+                                     std::vector<IndexedFrameEntry>& frames,
+                                     boost::uint64_t& end_offset)
+    {
+    frames.clear();
+
+    // fast path: read the index the footer points to
+    if (size >= sizeof(IndexedFileHeader) + sizeof(IndexedFooter))
+        {
+        IndexedFooter footer;
+        memcpy(&footer, data + size - sizeof(IndexedFooter), sizeof(IndexedFooter));
+        boost::uint64_t idx = footer.index_offset;
+        boost::uint64_t n_frames = 0;
+        if (memcmp(footer.magic, INDEXED_FOOTER_MAGIC, 8) == 0 &&
+            idx >= sizeof(IndexedFileHeader) && idx + 4 + sizeof(boost::uint64_t) <= size &&
+            memcmp(data + idx, INDEXED_INDEX_MAGIC, 4) == 0)
+            {
+            memcpy(&n_frames, data + idx + 4, sizeof(boost::uint64_t));
+            boost::uint64_t entries = idx + 4 + sizeof(boost::uint64_t);
+            if (entries + n_frames*sizeof(IndexedFrameEntry) + sizeof(IndexedFooter) == size)
+                {
+                frames.resize(n_frames);
+                if (n_frames > 0)
+                    memcpy(&frames[0], data + entries, n_frames*sizeof(IndexedFrameEntry));
+
+                bool valid = true;
+                for (unsigned int i = 0; i < frames.size() && valid; i++)
+                    valid = frames[i].offset >= sizeof(IndexedFileHeader) &&
+                            frames[i].offset + sizeof(IndexedFrameHeader) <= idx &&
+                            memcmp(data + frames[i].offset, INDEXED_FRAME_MAGIC, 4) == 0;
+
+                IndexedFrameHeader header;
+                if (valid && n_frames > 0)
+                    valid = indexed_check_frame(data, idx, frames.back().offset, header) &&
+                            frames.back().offset + header.frame_size == idx;
+
+                if (valid)
+                    {
+                    end_offset = idx;
+                    return true;
+                    }
+                frames.clear();
+                }
+            }
+        }
+
+    // slow path: walk the frames until the first incomplete one
+    boost::uint64_t offset = sizeof(IndexedFileHeader);
+    IndexedFrameHeader header;
+    while (indexed_check_frame(data, size, offset, header))
+        {
+        IndexedFrameEntry entry;
+        entry.offset = offset;
+        entry.timestep = header.timestep;
+        entry.reserved = 0;
+        frames.push_back(entry);
+        offset += header.frame_size;
+        }
+    end_offset = offset;
+    return false;
+    }
+
+//@}
+
+#endif
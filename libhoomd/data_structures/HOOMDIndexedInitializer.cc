@@ -0,0 +1,586 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+/*! \file HOOMDIndexedInitializer.cc
+    \brief Defines the HOOMDIndexedInitializer class
+*/
+
+#ifdef WIN32
+#pragma warning( push )
+#pragma warning( disable : 4244 4267 )
+#endif
+
+#include "HOOMDIndexedInitializer.h"
+#include "SnapshotSystemData.h"
+
+#include <stdexcept>
+#include <cstring>
+
+using namespace std;
+
+#include <boost/python.hpp>
+#include <boost/filesystem/operations.hpp>
+#ifdef ENABLE_ZLIB
+#include <zlib.h>
+#endif
+
+using namespace boost::python;
+using namespace boost;
+
+//! Size in bytes of a single element of the given type
+static unsigned int elem_size(unsigned int type)
+    {
+    if (type == indexed_uint8)
+        return 1;
+    else if (type == indexed_float64)
+        return 8;
+    else
+        return 4;
+    }
+
+//! Reads element \a i of a decoded chunk and converts it to T
+template<class T>
+static T get_value(const char *data, unsigned int type, size_t i)
+    {
+    switch (type)
+        {
+        case indexed_uint8:
+            return T((unsigned char)data[i]);
+        case indexed_int32:
+            {
+            int v;
+            memcpy(&v, data + i*sizeof(int), sizeof(int));
+            return T(v);
+            }
+        case indexed_uint32:
+            {
+            unsigned int v;
+            memcpy(&v, data + i*sizeof(unsigned int), sizeof(unsigned int));
+            return T(v);
+            }
+        case indexed_float32:
+            {
+            float v;
+            memcpy(&v, data + i*sizeof(float), sizeof(float));
+            return T(v);
+            }
+        default:
+            {
+            double v;
+            memcpy(&v, data + i*sizeof(double), sizeof(double));
+            return T(v);
+            }
+        }
+    }
+
+/*! \param exec_conf Execution configuration
+    \param fname File name with the data to load
+
+    Only the frame index is read here, the frame data is decoded in getSnapshot().
+*/
+HOOMDIndexedInitializer::HOOMDIndexedInitializer(boost::shared_ptr<const ExecutionConfiguration> exec_conf,
+                                                 const std::string &fname)
+    : m_exec_conf(exec_conf), m_fname(fname), m_frame(0), m_timestep_set(false), m_timestep(0)
+    {
+    const char *fields[] = {"velocity", "acceleration", "mass", "charge", "diameter", "image", "body",
+                            "orientation", "moment_inertia", "bond", "angle", "dihedral", "improper", "integrator"};
+    m_fields.insert(fields, fields + sizeof(fields)/sizeof(fields[0]));
+
+    // execute only on rank zero
+    if (m_exec_conf->getRank()) return;
+
+    openFile();
+
+    // default to the last frame
+    if (m_frames.size())
+        m_frame = (unsigned int)m_frames.size() - 1;
+    }
+
+void HOOMDIndexedInitializer::openFile()
+    {
+    // check that the file exists
+    if (!boost::filesystem::exists(m_fname))
+        {
+        m_exec_conf->msg->error() << endl << "init.read_indexed: File " << m_fname << " not found." << endl;
+        throw runtime_error("Error reading indexed file");
+        }
+
+    try
+        {
+        m_file.open(m_fname);
+        }
+    catch (std::exception& e)
+        {
+        m_exec_conf->msg->error() << endl << "init.read_indexed: Unable to open " << m_fname << ": "
+                                  << e.what() << endl;
+        throw runtime_error("Error reading indexed file");
+        }
+
+    IndexedFileHeader header;
+    if (m_file.size() < sizeof(IndexedFileHeader))
+        {
+        m_exec_conf->msg->error() << endl << "init.read_indexed: " << m_fname << " is not an indexed file" << endl;
+        throw runtime_error("Error reading indexed file");
+        }
+    memcpy(&header, m_file.data(), sizeof(IndexedFileHeader));
+    if (memcmp(header.magic, INDEXED_FILE_MAGIC, 8) != 0)
+        {
+        m_exec_conf->msg->error() << endl << "init.read_indexed: " << m_fname << " is not an indexed file" << endl;
+        throw runtime_error("Error reading indexed file");
+        }
+    if (header.version != INDEXED_FORMAT_VERSION)
+        {
+        m_exec_conf->msg->error() << endl << "init.read_indexed: " << m_fname << " has unsupported version "
+                                  << header.version << endl;
+        throw runtime_error("Error reading indexed file");
+        }
+
+    boost::uint64_t end_offset;
+    if (!indexed_read_frame_index(m_file.data(), m_file.size(), m_frames, end_offset))
+        m_exec_conf->msg->warning() << "init.read_indexed: " << m_fname << " was not closed properly, recovered "
+                                    << m_frames.size() << " frames" << endl;
+
+    if (m_frames.size() == 0)
+        {
+        m_exec_conf->msg->error() << endl << "init.read_indexed: " << m_fname << " contains no frames" << endl;
+        throw runtime_error("Error reading indexed file");
+        }
+    }
+
+/*! \returns Time step of the selected frame, or the time step set with setTimeStep()
+*/
+unsigned int HOOMDIndexedInitializer::getTimeStep() const
+    {
+    if (m_timestep_set || m_frames.size() == 0)
+        return m_timestep;
+    return m_frames[m_frame].timestep;
+    }
+
+/*! \param ts Time step to return from getTimeStep()
+*/
+void HOOMDIndexedInitializer::setTimeStep(unsigned int ts)
+    {
+    m_timestep = ts;
+    m_timestep_set = true;
+    }
+
+/*! \param frame Index of the frame
+*/
+unsigned int HOOMDIndexedInitializer::getFrameTimeStep(unsigned int frame) const
+    {
+    if (frame >= m_frames.size())
+        {
+        m_exec_conf->msg->error() << "init.read_indexed: Frame " << frame << " out of range" << endl;
+        throw runtime_error("Error reading indexed file");
+        }
+    return m_frames[frame].timestep;
+    }
+
+/*! \param frame Index of the frame to read. Negative values count back from the last frame.
+*/
+void HOOMDIndexedInitializer::setFrame(int frame)
+    {
+    if (m_exec_conf->getRank()) return;
+
+    int n = (int)m_frames.size();
+    if (frame < 0)
+        frame += n;
+    if (frame < 0 || frame >= n)
+        {
+        m_exec_conf->msg->error() << "init.read_indexed: Frame " << frame << " out of range, the file has "
+                                  << n << " frames" << endl;
+        throw runtime_error("Error reading indexed file");
+        }
+    m_frame = (unsigned int)frame;
+    }
+
+/*! \param field Name of the field (the same names as accepted by HOOMDIndexedDumpWriter::setOutputField())
+    \param enable true to read the field
+*/
+void HOOMDIndexedInitializer::setReadField(const std::string& field, bool enable)
+    {
+    if (field == "position" || field == "type")
+        {
+        if (!enable)
+            m_exec_conf->msg->warning() << "init.read_indexed: " << field << " is always read" << endl;
+        return;
+        }
+
+    if (field != "velocity" && field != "acceleration" && field != "mass" && field != "charge" &&
+        field != "diameter" && field != "image" && field != "body" && field != "orientation" &&
+        field != "moment_inertia" && field != "bond" && field != "angle" && field != "dihedral" &&
+        field != "improper" && field != "integrator")
+        {
+        m_exec_conf->msg->error() << "init.read_indexed: Unknown field " << field << endl;
+        throw runtime_error("Error reading indexed file");
+        }
+
+    if (enable)
+        m_fields.insert(field);
+    else
+        m_fields.erase(field);
+    }
+
+/*! \param chunks Chunk table of the frame
+    \param name Name of the chunk
+    \returns The chunk entry, or NULL if the frame has no such chunk
+*/
+const IndexedChunkEntry *HOOMDIndexedInitializer::findChunk(const std::vector<IndexedChunkEntry>& chunks,
+                                                            const std::string& name) const
+    {
+    for (unsigned int i = 0; i < chunks.size(); i++)
+        if (strncmp(chunks[i].name, name.c_str(), INDEXED_CHUNK_NAME_LEN) == 0)
+            return &chunks[i];
+    return NULL;
+    }
+
+/*! \param chunk Chunk to decode
+    \param out Filled with the decoded values
+*/
+void HOOMDIndexedInitializer::decodeChunk(const IndexedChunkEntry& chunk, std::vector<char>& out) const
+    {
+    if (chunk.offset > m_file.size() || chunk.stored_size > m_file.size() - chunk.offset ||
+        chunk.raw_size != (boost::uint64_t)chunk.num_items*chunk.elem_per_item*elem_size(chunk.elem_type))
+        {
+        m_exec_conf->msg->error() << "init.read_indexed: Corrupt chunk " << chunk.name << " in " << m_fname << endl;
+        throw runtime_error("Error reading indexed file");
+        }
+
+    const char *src = m_file.data() + chunk.offset;
+    out.resize(chunk.raw_size);
+    if (chunk.raw_size == 0)
+        return;
+
+    if (!(chunk.codec & indexed_codec_zlib))
+        {
+        memcpy(&out[0], src, chunk.raw_size);
+        return;
+        }
+
+    #ifdef ENABLE_ZLIB
+    std::vector<char> inflated(chunk.raw_size);
+    uLongf dest_len = chunk.raw_size;
+    int err = uncompress((Bytef*)&inflated[0], &dest_len, (const Bytef*)src, chunk.stored_size);
+    if (err != Z_OK || dest_len != chunk.raw_size)
+        {
+        m_exec_conf->msg->error() << "init.read_indexed: Unable to decompress chunk " << chunk.name << " in "
+                                  << m_fname << endl;
+        throw runtime_error("Error reading indexed file");
+        }
+
+    if (chunk.codec & indexed_codec_shuffle)
+        {
+        unsigned int esize = elem_size(chunk.elem_type);
+        size_t n = chunk.raw_size / esize;
+        for (unsigned int b = 0; b < esize; b++)
+            for (size_t i = 0; i < n; i++)
+                out[i*esize + b] = inflated[b*n + i];
+        }
+    else
+        out.swap(inflated);
+    #else
+    m_exec_conf->msg->error() << "init.read_indexed: " << m_fname
+                              << " is compressed, but HOOMD was built without zlib support" << endl;
+    throw runtime_error("Error reading indexed file");
+    #endif
+    }
+
+/*! \param chunks Chunk table of the frame
+    \param name Name of the chunk
+    \param elem_per_item Expected number of values per item
+    \param out Filled with the values, converted to T
+    \returns false if the frame does not have the chunk
+*/
+template<class T>
+bool HOOMDIndexedInitializer::readChunk(const std::vector<IndexedChunkEntry>& chunks,
+                                        const std::string& name,
+                                        unsigned int elem_per_item,
+                                        std::vector<T>& out) const
+    {
+    const IndexedChunkEntry *chunk = findChunk(chunks, name);
+    if (!chunk)
+        return false;
+
+    if (chunk->elem_per_item != elem_per_item)
+        {
+        m_exec_conf->msg->error() << "init.read_indexed: Chunk " << name << " has " << chunk->elem_per_item
+                                  << " values per item, expected " << elem_per_item << endl;
+        throw runtime_error("Error reading indexed file");
+        }
+
+    std::vector<char> raw;
+    decodeChunk(*chunk, raw);
+
+    size_t n = (size_t)chunk->num_items*elem_per_item;
+    out.resize(n);
+    if (n == 0)
+        return true;
+    for (size_t i = 0; i < n; i++)
+        out[i] = get_value<T>(&raw[0], chunk->elem_type, i);
+    return true;
+    }
+
+/*! \param chunks Chunk table of the frame
+    \param name Name of the chunk
+    \param out Filled with the names
+    \returns false if the frame does not have the chunk
+*/
+bool HOOMDIndexedInitializer::readNameChunk(const std::vector<IndexedChunkEntry>& chunks,
+                                            const std::string& name,
+                                            std::vector<std::string>& out) const
+    {
+    const IndexedChunkEntry *chunk = findChunk(chunks, name);
+    if (!chunk)
+        return false;
+
+    std::vector<char> raw;
+    decodeChunk(*chunk, raw);
+
+    out.clear();
+    size_t start = 0;
+    for (size_t i = 0; i < raw.size(); i++)
+        {
+        if (raw[i] == 0)
+            {
+            out.push_back(std::string(&raw[start], i - start));
+            start = i+1;
+            }
+        }
+    return true;
+    }
+
+/*! \param chunks Chunk table of the frame
+    \param name Name of the group chunk (bond, angle, ...)
+    \param group_size Number of members per group
+    \param snap Snapshot to fill out
+    \returns false if the frame does not have the chunk
+*/
+template<class Snapshot>
+bool HOOMDIndexedInitializer::readGroupChunks(const std::vector<IndexedChunkEntry>& chunks,
+                                              const std::string& name,
+                                              unsigned int group_size,
+                                              Snapshot& snap) const
+    {
+    std::vector<unsigned int> buf;
+    if (!readChunk(chunks, name, group_size+1, buf))
+        return false;
+
+    unsigned int n = (unsigned int)(buf.size() / (group_size+1));
+    snap.resize(n);
+    for (unsigned int i = 0; i < n; i++)
+        {
+        snap.type_id[i] = buf[i*(group_size+1)];
+        for (unsigned int j = 0; j < group_size; j++)
+            snap.groups[i].tag[j] = buf[i*(group_size+1) + j + 1];
+        }
+    readNameChunk(chunks, name + "_types", snap.type_mapping);
+    return true;
+    }
+
+/*! \returns A snapshot of the selected frame, containing the selected fields
+*/
+boost::shared_ptr<SnapshotSystemData> HOOMDIndexedInitializer::getSnapshot() const
+    {
+    boost::shared_ptr<SnapshotSystemData> snapshot(new SnapshotSystemData());
+
+    // only execute on rank 0
+    if (m_exec_conf->getRank()) return snapshot;
+
+    // read the frame header and chunk table straight from the mapped file
+    boost::uint64_t offset = m_frames[m_frame].offset;
+    IndexedFrameHeader header;
+    if (offset + sizeof(IndexedFrameHeader) > m_file.size())
+        {
+        m_exec_conf->msg->error() << "init.read_indexed: Corrupt frame index in " << m_fname << endl;
+        throw runtime_error("Error reading indexed file");
+        }
+    memcpy(&header, m_file.data() + offset, sizeof(IndexedFrameHeader));
+    if (memcmp(header.magic, INDEXED_FRAME_MAGIC, 4) != 0 ||
+        offset + sizeof(IndexedFrameHeader) + header.num_chunks*sizeof(IndexedChunkEntry) > m_file.size())
+        {
+        m_exec_conf->msg->error() << "init.read_indexed: Corrupt frame " << m_frame << " in " << m_fname << endl;
+        throw runtime_error("Error reading indexed file");
+        }
+
+    std::vector<IndexedChunkEntry> chunks(header.num_chunks);
+    if (header.num_chunks)
+        memcpy(&chunks[0], m_file.data() + offset + sizeof(IndexedFrameHeader),
+               header.num_chunks*sizeof(IndexedChunkEntry));
+
+    // box and dimensions
+    snapshot->dimensions = header.dimensions;
+    BoxDim box(Scalar(header.box[0]), Scalar(header.box[1]), Scalar(header.box[2]));
+    box.setTiltFactors(Scalar(header.box[3]), Scalar(header.box[4]), Scalar(header.box[5]));
+    snapshot->global_box = box;
+
+    // particle data
+    SnapshotParticleData& pdata = snapshot->particle_data;
+    unsigned int N = header.num_particles;
+    pdata.resize(N);
+
+    std::vector<Scalar> sbuf;
+    const char *vec_names[] = {"position", "velocity", "acceleration"};
+    std::vector<Scalar3> *vec_dest[] = {&pdata.pos, &pdata.vel, &pdata.accel};
+    if (!findChunk(chunks, "position") || !findChunk(chunks, "type"))
+        {
+        m_exec_conf->msg->error() << "init.read_indexed: Frame " << m_frame << " in " << m_fname
+                                  << " has no position or type data" << endl;
+        throw runtime_error("Error reading indexed file");
+        }
+
+    for (unsigned int k = 0; k < 3; k++)
+        {
+        if ((k == 0 || m_fields.count(vec_names[k])) && readChunk(chunks, vec_names[k], 3, sbuf))
+            {
+            if (sbuf.size() != N*3)
+                {
+                m_exec_conf->msg->error() << "init.read_indexed: " << vec_names[k] << " has the wrong size" << endl;
+                throw runtime_error("Error reading indexed file");
+                }
+            for (unsigned int i = 0; i < N; i++)
+                (*vec_dest[k])[i] = make_scalar3(sbuf[i*3], sbuf[i*3+1], sbuf[i*3+2]);
+            }
+        }
+
+    std::vector<unsigned int> ubuf;
+    readChunk(chunks, "type", 1, ubuf);
+    if (ubuf.size() != N)
+        {
+        m_exec_conf->msg->error() << "init.read_indexed: type has the wrong size" << endl;
+        throw runtime_error("Error reading indexed file");
+        }
+    pdata.type = ubuf;
+    readNameChunk(chunks, "type_names", pdata.type_mapping);
+
+    const char *scalar_names[] = {"mass", "charge", "diameter"};
+    std::vector<Scalar> *scalar_dest[] = {&pdata.mass, &pdata.charge, &pdata.diameter};
+    for (unsigned int k = 0; k < 3; k++)
+        {
+        if (m_fields.count(scalar_names[k]) && readChunk(chunks, scalar_names[k], 1, sbuf) && sbuf.size() == N)
+            *scalar_dest[k] = sbuf;
+        }
+
+    if (m_fields.count("body") && readChunk(chunks, "body", 1, ubuf) && ubuf.size() == N)
+        pdata.body = ubuf;
+
+    std::vector<int> ibuf;
+    if (m_fields.count("image") && readChunk(chunks, "image", 3, ibuf) && ibuf.size() == N*3)
+        {
+        for (unsigned int i = 0; i < N; i++)
+            pdata.image[i] = make_int3(ibuf[i*3], ibuf[i*3+1], ibuf[i*3+2]);
+        }
+
+    if (m_fields.count("orientation") && readChunk(chunks, "orientation", 4, sbuf) && sbuf.size() == N*4)
+        {
+        for (unsigned int i = 0; i < N; i++)
+            pdata.orientation[i] = make_scalar4(sbuf[i*4], sbuf[i*4+1], sbuf[i*4+2], sbuf[i*4+3]);
+        }
+
+    if (m_fields.count("moment_inertia") && readChunk(chunks, "moment_inertia", 6, sbuf) && sbuf.size() == N*6)
+        {
+        for (unsigned int i = 0; i < N; i++)
+            for (unsigned int c = 0; c < 6; c++)
+                pdata.inertia_tensor[i].components[c] = sbuf[i*6+c];
+        }
+
+    // bonded groups
+    snapshot->has_bond_data = m_fields.count("bond") && readGroupChunks(chunks, "bond", 2, snapshot->bond_data);
+    snapshot->has_angle_data = m_fields.count("angle") && readGroupChunks(chunks, "angle", 3, snapshot->angle_data);
+    snapshot->has_dihedral_data = m_fields.count("dihedral") &&
+                                  readGroupChunks(chunks, "dihedral", 4, snapshot->dihedral_data);
+    snapshot->has_improper_data = m_fields.count("improper") &&
+                                  readGroupChunks(chunks, "improper", 4, snapshot->improper_data);
+
+    // integrator variables
+    std::vector<std::string> types;
+    std::vector<double> vars;
+    if (m_fields.count("integrator") && readNameChunk(chunks, "integrator_types", types) &&
+        readChunk(chunks, "integrator_counts", 1, ubuf) && readChunk(chunks, "integrator", 1, vars) &&
+        types.size() == ubuf.size())
+        {
+        unsigned int k = 0;
+        for (unsigned int i = 0; i < types.size(); i++)
+            {
+            IntegratorVariables v;
+            v.type = types[i];
+            for (unsigned int j = 0; j < ubuf[i] && k < vars.size(); j++)
+                v.variable.push_back(Scalar(vars[k++]));
+            snapshot->integrator_data.push_back(v);
+            }
+        snapshot->has_integrator_data = true;
+        }
+    else
+        snapshot->has_integrator_data = false;
+
+    // rigid bodies and walls are not stored in indexed files
+    snapshot->has_rigid_data = false;
+    snapshot->has_wall_data = false;
+
+    return snapshot;
+    }
+
+void export_HOOMDIndexedInitializer()
+    {
+    class_< HOOMDIndexedInitializer >("HOOMDIndexedInitializer",
+        init<boost::shared_ptr<const ExecutionConfiguration>, const string&>())
+        .def("getSnapshot", &HOOMDIndexedInitializer::getSnapshot)
+        .def("getTimeStep", &HOOMDIndexedInitializer::getTimeStep)
+        .def("setTimeStep", &HOOMDIndexedInitializer::setTimeStep)
+        .def("getNumFrames", &HOOMDIndexedInitializer::getNumFrames)
+        .def("getFrameTimeStep", &HOOMDIndexedInitializer::getFrameTimeStep)
+        .def("setFrame", &HOOMDIndexedInitializer::setFrame)
+        .def("setReadField", &HOOMDIndexedInitializer::setReadField)
+        ;
+    }
+
+#ifdef WIN32
+#pragma warning( pop )
+#endif
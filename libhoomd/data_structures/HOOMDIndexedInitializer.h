@@ -0,0 +1,163 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+/*! \file HOOMDIndexedInitializer.h
+    \brief Declares the HOOMDIndexedInitializer class
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include "ExecutionConfiguration.h"
+#include "HOOMDIndexedFormat.h"
+
+#include <string>
+#include <vector>
+#include <set>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+
+#ifndef __HOOMD_INDEXED_INITIALIZER_H__
+#define __HOOMD_INDEXED_INITIALIZER_H__
+
+//! Forward definition of SnapshotSystemData
+class SnapshotSystemData;
+
+//! Initializes the system from a frame of an indexed binary file
+/*! The file format is described in HOOMDIndexedFormat.h and is written by HOOMDIndexedDumpWriter.
+
+    The file is memory mapped and only its frame index is read in the constructor. getSnapshot() then seeks
+    directly to the selected frame (see setFrame()) and decodes only the chunks of the fields selected with
+    setReadField(), so loading the last frame of a long trajectory costs the same as loading the first one.
+    Positions and types are always read. Other fields missing from the file (or not selected) are left at their
+    snapshot defaults.
+
+    Like the other initializers, the file is only read on rank 0.
+
+    \ingroup data_structs
+*/
+class HOOMDIndexedInitializer
+    {
+    public:
+        //! Opens the file and reads its frame index
+        HOOMDIndexedInitializer(boost::shared_ptr<const ExecutionConfiguration> exec_conf,
+                                const std::string &fname);
+
+        //! Returns the timestep of the simulation
+        virtual unsigned int getTimeStep() const;
+
+        //! Sets the timestep of the simulation
+        virtual void setTimeStep(unsigned int ts);
+
+        //! initializes a snapshot with the particle data of the selected frame
+        virtual boost::shared_ptr<SnapshotSystemData> getSnapshot() const;
+
+        //! Get the number of frames in the file
+        unsigned int getNumFrames() const
+            {
+            return (unsigned int)m_frames.size();
+            }
+
+        //! Get the time step of a frame
+        unsigned int getFrameTimeStep(unsigned int frame) const;
+
+        //! Select the frame to read
+        void setFrame(int frame);
+
+        //! Select whether a field is read
+        void setReadField(const std::string& field, bool enable);
+
+    private:
+        boost::shared_ptr<const ExecutionConfiguration> m_exec_conf; //!< Execution configuration
+        std::string m_fname;                                //!< Name of the file
+        boost::iostreams::mapped_file_source m_file;        //!< The memory mapped file
+        std::vector<IndexedFrameEntry> m_frames;            //!< Frame index
+        unsigned int m_frame;                               //!< Selected frame
+        std::set<std::string> m_fields;                     //!< Fields to read
+        bool m_timestep_set;                                //!< True if setTimeStep() overrode the frame time step
+        unsigned int m_timestep;                            //!< Time step set with setTimeStep()
+
+        //! Helper function to open the file and read the frame index
+        void openFile();
+
+        //! Find a chunk of a frame
+        const IndexedChunkEntry *findChunk(const std::vector<IndexedChunkEntry>& chunks,
+                                           const std::string& name) const;
+
+        //! Decode a chunk into raw values
+        void decodeChunk(const IndexedChunkEntry& chunk, std::vector<char>& out) const;
+
+        //! Decode a chunk and convert its values
+        template<class T>
+        bool readChunk(const std::vector<IndexedChunkEntry>& chunks,
+                       const std::string& name,
+                       unsigned int elem_per_item,
+                       std::vector<T>& out) const;
+
+        //! Read a chunk holding a list of names
+        bool readNameChunk(const std::vector<IndexedChunkEntry>& chunks,
+                           const std::string& name,
+                           std::vector<std::string>& out) const;
+
+        //! Read the chunks of a bonded group snapshot
+        template<class Snapshot>
+        bool readGroupChunks(const std::vector<IndexedChunkEntry>& chunks,
+                             const std::string& name,
+                             unsigned int group_size,
+                             Snapshot& snap) const;
+    };
+
+//! Exports HOOMDIndexedInitializer to python
+void export_HOOMDIndexedInitializer();
+
+#endif
@@ -67,15 +67,351 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <stdexcept>
 #include <sstream>
 #include <algorithm>
+#include <cstdlib>
+#include <cstring>
 
 using namespace std;
 
 #include <boost/python.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
+#ifdef ENABLE_ZLIB
+#include <boost/iostreams/device/file.hpp>
+#include <boost/iostreams/filtering_stream.hpp>
+#include <boost/iostreams/filter/gzip.hpp>
+#include <boost/iostreams/copy.hpp>
+#include <boost/iostreams/device/back_inserter.hpp>
+#endif
 
 using namespace boost::python;
 
 using namespace boost;
 
+//! Powers of ten that are exactly representable as doubles
+static const double exact_powers_of_ten[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12,
+                                              1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+//! Convert a decimal number to a double
+/*! \param begin First character of the number
+    \param end One past the last character of the number
+    \param value Output: the parsed value
+    \returns true if the whole range is a valid number
+
+    Numbers with at most 15 significant digits and a decimal exponent within [-22,22] (which covers everything
+    HOOMDDumpWriter writes) are converted exactly with a single floating point multiplication or division. All other
+    numbers are handed to strtod().
+*/
+static bool parse_double(const char *begin, const char *end, double& value)
+    {
+    const char *p = begin;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+        {
+        negative = (*p == '-');
+        p++;
+        }
+
+    unsigned long long mantissa = 0;
+    unsigned int num_digits = 0;
+    int exponent = 0;
+    bool any_digit = false;
+
+    // integer part
+    for (; p < end && *p >= '0' && *p <= '9'; p++)
+        {
+        any_digit = true;
+        if (num_digits < 19)
+            {
+            mantissa = mantissa*10 + (*p - '0');
+            if (mantissa) num_digits++;
+            }
+        else
+            exponent++;
+        }
+
+    // fractional part
+    if (p < end && *p == '.')
+        {
+        for (p++; p < end && *p >= '0' && *p <= '9'; p++)
+            {
+            any_digit = true;
+            if (num_digits < 19)
+                {
+                mantissa = mantissa*10 + (*p - '0');
+                if (mantissa) num_digits++;
+                exponent--;
+                }
+            }
+        }
+
+    if (!any_digit)
+        return false;
+
+    // exponent
+    if (p < end && (*p == 'e' || *p == 'E'))
+        {
+        p++;
+        bool negative_exponent = false;
+        if (p < end && (*p == '-' || *p == '+'))
+            {
+            negative_exponent = (*p == '-');
+            p++;
+            }
+
+        int e = 0;
+        bool any_exponent_digit = false;
+        for (; p < end && *p >= '0' && *p <= '9'; p++)
+            {
+            any_exponent_digit = true;
+            if (e < 100000)
+                e = e*10 + (*p - '0');
+            }
+
+        if (!any_exponent_digit)
+            return false;
+
+        exponent += negative_exponent ? -e : e;
+        }
+
+    if (p != end)
+        return false;
+
+    if (num_digits <= 15 && exponent >= -22 && exponent <= 22)
+        {
+        // the mantissa and the power of ten are exact, so the result is correctly rounded
+        double v = double(mantissa);
+        if (exponent < 0)
+            v /= exact_powers_of_ten[-exponent];
+        else
+            v *= exact_powers_of_ten[exponent];
+        value = negative ? -v : v;
+        return true;
+        }
+
+    // fall back on the C library for everything else
+    string number(begin, end);
+    char *number_end;
+    value = strtod(number.c_str(), &number_end);
+    return number_end == number.c_str() + number.size();
+    }
+
+//! Convert a decimal integer
+/*! \param begin First character of the number
+    \param end One past the last character of the number
+    \param value Output: the parsed value
+    \returns true if the whole range is a valid integer
+*/
+static bool parse_int(const char *begin, const char *end, long& value)
+    {
+    const char *p = begin;
+    bool negative = false;
+    if (p < end && (*p == '-' || *p == '+'))
+        {
+        negative = (*p == '-');
+        p++;
+        }
+
+    if (p == end)
+        return false;
+
+    long v = 0;
+    for (; p < end; p++)
+        {
+        if (*p < '0' || *p > '9')
+            return false;
+        v = v*10 + (*p - '0');
+        }
+
+    value = negative ? -v : v;
+    return true;
+    }
+
+//! Test for XML white space
+static inline bool is_space(char c)
+    {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+    }
+
+//! Find the next white space separated token in a block of text
+/*! \param cur Current position in the text, advanced past the token
+    \param end End of the text
+    \param token Output: first character of the token
+    \param token_end Output: one past the last character of the token
+    \returns false if there are no more tokens
+*/
+static inline bool next_token(const char *&cur, const char *end, const char *&token, const char *&token_end)
+    {
+    while (cur < end && is_space(*cur))
+        cur++;
+    if (cur == end)
+        return false;
+
+    token = cur;
+    while (cur < end && !is_space(*cur))
+        cur++;
+    token_end = cur;
+    return true;
+    }
+
+//! Read the next token of a block of text as a Scalar
+static inline bool read_scalar(const char *&cur, const char *end, Scalar& value)
+    {
+    const char *token, *token_end;
+    double v;
+    if (!next_token(cur, end, token, token_end) || !parse_double(token, token_end, v))
+        return false;
+    value = Scalar(v);
+    return true;
+    }
+
+//! Read the next token of a block of text as an int
+static inline bool read_int(const char *&cur, const char *end, int& value)
+    {
+    const char *token, *token_end;
+    long v;
+    if (!next_token(cur, end, token, token_end) || !parse_int(token, token_end, v))
+        return false;
+    value = int(v);
+    return true;
+    }
+
+//! Read the next token of a block of text as an unsigned int
+static inline bool read_uint(const char *&cur, const char *end, unsigned int& value)
+    {
+    const char *token, *token_end;
+    long v;
+    if (!next_token(cur, end, token, token_end) || !parse_int(token, token_end, v) || v < 0)
+        return false;
+    value = (unsigned int)v;
+    return true;
+    }
+
+//! Read the next token of a block of text as a string
+static inline bool read_string(const char *&cur, const char *end, string& value)
+    {
+    const char *token, *token_end;
+    if (!next_token(cur, end, token, token_end))
+        return false;
+    value.assign(token, token_end);
+    return true;
+    }
+
+//! Count the lines in a block of text, as an estimate of the number of entries it contains
+static unsigned int count_lines(const char *begin, const char *end)
+    {
+    return (unsigned int)std::count(begin, end, '\n');
+    }
+
+//! An XML tag found while scanning the input file
+struct xml_tag
+    {
+    string name;            //!< Lower case name of the tag
+    const char *begin;      //!< Position of the opening '<'
+    const char *end;        //!< One past the closing '>'
+    bool closing;           //!< True if this is a closing tag </name>
+    bool self_closing;      //!< True if this is an empty element tag <name/>
+    };
+
+//! Find the next tag in the file
+/*! \param cur Current position, advanced past the tag
+    \param end End of the file
+    \param tag Output: the tag found
+    \returns false if there are no more (complete) tags
+
+    Processing instructions, comments and declarations (<?..?>, <!--..-->, <!..>) are skipped.
+*/
+static bool next_tag(const char *&cur, const char *end, xml_tag& tag)
+    {
+    while (true)
+        {
+        cur = std::find(cur, end, '<');
+        if (cur == end)
+            return false;
+
+        if (end - cur >= 4 && strncmp(cur, "<!--", 4) == 0)
+            {
+            const char *comment_end = "-->";
+            cur = std::search(cur + 4, end, comment_end, comment_end + 3);
+            if (cur == end)
+                return false;
+            cur += 3;
+            continue;
+            }
+
+        if (end - cur >= 2 && (cur[1] == '?' || cur[1] == '!'))
+            {
+            cur = std::find(cur, end, '>');
+            if (cur == end)
+                return false;
+            cur++;
+            continue;
+            }
+
+        break;
+        }
+
+    tag.begin = cur;
+    const char *p = cur + 1;
+    tag.closing = (p < end && *p == '/');
+    if (tag.closing)
+        p++;
+
+    const char *name_begin = p;
+    while (p < end && !is_space(*p) && *p != '>' && *p != '/')
+        p++;
+    tag.name.assign(name_begin, p);
+    transform(tag.name.begin(), tag.name.end(), tag.name.begin(), ::tolower);
+
+    // find the end of the tag, skipping over quoted attribute values
+    char quote = 0;
+    for (; p < end; p++)
+        {
+        if (quote)
+            {
+            if (*p == quote)
+                quote = 0;
+            }
+        else if (*p == '"' || *p == '\'')
+            quote = *p;
+        else if (*p == '>')
+            break;
+        }
+
+    if (p == end)
+        return false;
+
+    tag.self_closing = (*(p-1) == '/');
+    tag.end = p + 1;
+    cur = tag.end;
+    return true;
+    }
+
+//! Find the closing tag of an element
+/*! \param cur Position right after the opening tag
+    \param end End of the file
+    \param name Lower case name of the element
+    \param close Output: the closing tag
+    \returns false if the closing tag was not found
+
+    Elements of the same name cannot be nested in hoomd_xml files, so the first closing tag of the same name is the
+    matching one.
+*/
+static bool find_closing_tag(const char *cur, const char *end, const string& name, xml_tag& close)
+    {
+    while (next_tag(cur, end, close))
+        {
+        if (close.closing && close.name == name)
+            return true;
+        }
+    return false;
+    }
+
+//! Get the line number of a position in the file
+static unsigned int line_number(const char *begin, const char *pos)
+    {
+    return (unsigned int)std::count(begin, pos, '\n') + 1;
+    }
+
 /*! \param fname File name with the data to load
     The file will be read and parsed fully during the constructor call.
 */
@@ -95,21 +431,21 @@ HOOMDInitializer::HOOMDInitializer(boost::shared_ptr<const ExecutionConfiguratio
 
     // initialize the parser map
     m_parser_map["box"] = bind(&HOOMDInitializer::parseBoxNode, this, _1);
-    m_parser_map["position"] = bind(&HOOMDInitializer::parsePositionNode, this, _1);
-    m_parser_map["image"] = bind(&HOOMDInitializer::parseImageNode, this, _1);
-    m_parser_map["velocity"] = bind(&HOOMDInitializer::parseVelocityNode, this, _1);
-    m_parser_map["mass"] = bind(&HOOMDInitializer::parseMassNode, this, _1);
-    m_parser_map["diameter"] = bind(&HOOMDInitializer::parseDiameterNode, this, _1);
-    m_parser_map["type"] = bind(&HOOMDInitializer::parseTypeNode, this, _1);
-    m_parser_map["body"] = bind(&HOOMDInitializer::parseBodyNode, this, _1);
-    m_parser_map["bond"] = bind(&HOOMDInitializer::parseBondNode, this, _1);
-    m_parser_map["angle"] = bind(&HOOMDInitializer::parseAngleNode, this, _1);
-    m_parser_map["dihedral"] = bind(&HOOMDInitializer::parseDihedralNode, this, _1);
-    m_parser_map["improper"] = bind(&HOOMDInitializer::parseImproperNode, this, _1);
-    m_parser_map["charge"] = bind(&HOOMDInitializer::parseChargeNode, this, _1);
     m_parser_map["wall"] = bind(&HOOMDInitializer::parseWallNode, this, _1);
-    m_parser_map["orientation"] = bind(&HOOMDInitializer::parseOrientationNode, this, _1);
-    m_parser_map["moment_inertia"] = bind(&HOOMDInitializer::parseMomentInertiaNode, this, _1);
+    m_text_parser_map["position"] = bind(&HOOMDInitializer::parsePositionNode, this, _1, _2);
+    m_text_parser_map["image"] = bind(&HOOMDInitializer::parseImageNode, this, _1, _2);
+    m_text_parser_map["velocity"] = bind(&HOOMDInitializer::parseVelocityNode, this, _1, _2);
+    m_text_parser_map["mass"] = bind(&HOOMDInitializer::parseMassNode, this, _1, _2);
+    m_text_parser_map["diameter"] = bind(&HOOMDInitializer::parseDiameterNode, this, _1, _2);
+    m_text_parser_map["type"] = bind(&HOOMDInitializer::parseTypeNode, this, _1, _2);
+    m_text_parser_map["body"] = bind(&HOOMDInitializer::parseBodyNode, this, _1, _2);
+    m_text_parser_map["bond"] = bind(&HOOMDInitializer::parseBondNode, this, _1, _2);
+    m_text_parser_map["angle"] = bind(&HOOMDInitializer::parseAngleNode, this, _1, _2);
+    m_text_parser_map["dihedral"] = bind(&HOOMDInitializer::parseDihedralNode, this, _1, _2);
+    m_text_parser_map["improper"] = bind(&HOOMDInitializer::parseImproperNode, this, _1, _2);
+    m_text_parser_map["charge"] = bind(&HOOMDInitializer::parseChargeNode, this, _1, _2);
+    m_text_parser_map["orientation"] = bind(&HOOMDInitializer::parseOrientationNode, this, _1, _2);
+    m_text_parser_map["moment_inertia"] = bind(&HOOMDInitializer::parseMomentInertiaNode, this, _1, _2);
 
     // read in the file
     readFile(fname);
@@ -314,37 +650,71 @@ boost::shared_ptr<SnapshotSystemData> HOOMDInitializer::getSnapshot() const
     \post Internal data arrays and members are filled out from which futre calls
     like getSnapshot() will use to intialize the ParticleData
 
-    This function implements the main parser loop. It reads in XML nodes from the
-    file one by one and passes them of to parsers registered in \c m_parser_map.
+    This function implements the main parser loop. The file is memory mapped (or, for .gz files, decompressed into
+    memory) and scanned for XML tags without building a DOM of the whole document. The children of the configuration
+    node are passed off one by one to the parsers registered in \c m_text_parser_map, which read the text of the node
+    in place, or \c m_parser_map, which receive a small XMLNode built from just that node.
 */
 void HOOMDInitializer::readFile(const string &fname)
     {
-    // Create a Root Node and a child node
-    XMLNode root_node;
-
-    // Open the file and read the root element "hoomd_xml"
     m_exec_conf->msg->notice(2) << "Reading " << fname << "..." << endl;
-    XMLResults results;
-    root_node = XMLNode::parseFile(fname.c_str(),"hoomd_xml", &results);
 
-    // handle errors
-    if (results.error != eXMLErrorNone)
+    // memory map the file
+    if (!boost::filesystem::exists(fname))
+        {
+        m_exec_conf->msg->error() << endl << "File " << fname << " not found" << endl << endl;
+        throw runtime_error("Error reading xml file");
+        }
+
+    if (boost::filesystem::file_size(fname) == 0)
+        {
+        m_exec_conf->msg->error() << endl << "Root node of " << fname << " is not <hoomd_xml>" << endl << endl;
+        throw runtime_error("Error reading xml file");
+        }
+
+    boost::iostreams::mapped_file_source file;
+    string inflated;
+    const char *file_begin = NULL;
+    const char *file_end = NULL;
+    try
         {
-        // create message
-        if (results.error==eXMLErrorFirstTagNotFound)
+        #ifdef ENABLE_ZLIB
+        // gzip files (written by dump.xml with a .gz file name) are decompressed into memory first
+        if (fname.size() > 3 && fname.substr(fname.size()-3) == string(".gz"))
             {
-            m_exec_conf->msg->error() << endl << "Root node of " << fname << " is not <hoomd_xml>" << endl << endl;
-            throw runtime_error("Error reading xml file");
+            boost::iostreams::filtering_istream in;
+            in.push(boost::iostreams::gzip_decompressor());
+            in.push(boost::iostreams::file_source(fname, ios::in | ios::binary));
+            boost::iostreams::copy(in, boost::iostreams::back_inserter(inflated));
+            file_begin = inflated.data();
+            file_end = file_begin + inflated.size();
+            }
+        else
+        #endif
+            {
+            file.open(fname);
+            file_begin = file.data();
+            file_end = file_begin + file.size();
             }
+        }
+    catch (std::exception& e)
+        {
+        m_exec_conf->msg->error() << endl << "Unable to open " << fname << ": " << e.what() << endl << endl;
+        throw runtime_error("Error reading xml file");
+        }
 
-        ostringstream error_message;
-        error_message << XMLNode::getError(results.error) << " in file "
-        << fname << " at line " << results.nLine << " col "
-        << results.nColumn;
-        m_exec_conf->msg->error() << endl << error_message.str() << endl << endl;
+    const char *cur = file_begin;
+
+    // find the root element "hoomd_xml"
+    xml_tag tag;
+    if (!next_tag(cur, file_end, tag) || tag.closing || tag.name != "hoomd_xml")
+        {
+        m_exec_conf->msg->error() << endl << "Root node of " << fname << " is not <hoomd_xml>" << endl << endl;
         throw runtime_error("Error reading xml file");
         }
 
+    XMLNode root_node = parseStartTag(tag.begin, tag.end, tag.name);
+
     string xml_version;
     if (root_node.isAttributeSet("version"))
         {
@@ -379,50 +749,138 @@ void HOOMDInitializer::readFile(const string &fname)
              << "hoomd_xml file with version not in the range 1.0-1.5  specified,"
              << " I don't know how to read this. Continuing anyways." << endl << endl;
 
-    // the file was parsed successfully by the XML reader. Extract the information now
-    // start by checking the number of configurations in the file
-    int num_configurations = root_node.nChildNode("configuration");
-    if (num_configurations == 0)
+    // scan the children of the root node for the configuration
+    int num_configurations = 0;
+    bool root_closed = tag.self_closing;
+    while (!root_closed && next_tag(cur, file_end, tag))
         {
-        m_exec_conf->msg->error() << endl << "No <configuration> specified in the XML file" << endl << endl;
-        throw runtime_error("Error reading xml file");
-        }
-    if (num_configurations > 1)
-        {
-        m_exec_conf->msg->error() << endl << "Sorry, the input XML file must have only one configuration" << endl << endl;
-        throw runtime_error("Error reading xml file");
-        }
+        if (tag.closing)
+            {
+            if (tag.name == "hoomd_xml")
+                root_closed = true;
+            continue;
+            }
 
-    // extract the only configuration node
-    XMLNode configuration_node = root_node.getChildNode("configuration");
-    // extract the time step
-    if (configuration_node.isAttributeSet("time_step"))
-        {
-        m_timestep = atoi(configuration_node.getAttribute("time_step"));
+        if (tag.name != "configuration")
+            {
+            // skip over anything else
+            xml_tag close;
+            if (!tag.self_closing)
+                {
+                if (!find_closing_tag(cur, file_end, tag.name, close))
+                    {
+                    m_exec_conf->msg->error() << endl << "Missing </" << tag.name << "> for the node in file "
+                                              << fname << " at line " << line_number(file_begin, tag.begin)
+                                              << endl << endl;
+                    throw runtime_error("Error reading xml file");
+                    }
+                cur = close.end;
+                }
+            continue;
+            }
+
+        num_configurations++;
+        if (num_configurations > 1)
+            {
+            m_exec_conf->msg->error() << endl << "Sorry, the input XML file must have only one configuration"
+                                      << endl << endl;
+            throw runtime_error("Error reading xml file");
+            }
+
+        XMLNode configuration_node = parseStartTag(tag.begin, tag.end, tag.name);
+
+        // extract the time step
+        if (configuration_node.isAttributeSet("time_step"))
+            {
+            m_timestep = atoi(configuration_node.getAttribute("time_step"));
+            }
+
+        // extract the number of dimensions, or default to 3
+        if (configuration_node.isAttributeSet("dimensions"))
+            {
+            m_num_dimensions = atoi(configuration_node.getAttribute("dimensions"));
+            }
+        else
+            m_num_dimensions = 3;
+
+        if (tag.self_closing)
+            continue;
+
+        // loop through all child nodes of the configuration
+        bool configuration_closed = false;
+        while (!configuration_closed && next_tag(cur, file_end, tag))
+            {
+            if (tag.closing)
+                {
+                if (tag.name == "configuration")
+                    configuration_closed = true;
+                continue;
+                }
+
+            // find the end of the node
+            xml_tag close;
+            const char *text_end = tag.end;
+            const char *node_end = tag.end;
+            if (!tag.self_closing)
+                {
+                if (!find_closing_tag(tag.end, file_end, tag.name, close))
+                    {
+                    m_exec_conf->msg->error() << endl << "Missing </" << tag.name << "> for the node in file "
+                                              << fname << " at line " << line_number(file_begin, tag.begin)
+                                              << endl << endl;
+                    throw runtime_error("Error reading xml file");
+                    }
+                text_end = close.begin;
+                node_end = close.end;
+                }
+
+            // call the appropriate node parser, if it exists
+            std::map< std::string, boost::function< void (const char*, const char*) > >::iterator text_parser;
+            std::map< std::string, boost::function< void (const XMLNode&) > >::iterator parser;
+            text_parser = m_text_parser_map.find(tag.name);
+            parser = m_parser_map.find(tag.name);
+            if (text_parser != m_text_parser_map.end())
+                {
+                text_parser->second(tag.end, text_end);
+                }
+            else if (parser != m_parser_map.end())
+                {
+                // these nodes are small, build a DOM of just this node
+                string node_text(tag.begin, node_end);
+                XMLResults results;
+                XMLNode node = XMLNode::parseString(node_text.c_str(), tag.name.c_str(), &results);
+                if (results.error != eXMLErrorNone)
+                    {
+                    m_exec_conf->msg->error() << endl << XMLNode::getError(results.error) << " in file " << fname
+                                              << " at line " << line_number(file_begin, tag.begin) + results.nLine - 1
+                                              << endl << endl;
+                    throw runtime_error("Error reading xml file");
+                    }
+                parser->second(node);
+                }
+            else
+                m_exec_conf->msg->notice(2) << "Parser for node <" << tag.name << "> not defined, ignoring" << endl;
+
+            cur = node_end;
+            }
+
+        if (!configuration_closed)
+            {
+            m_exec_conf->msg->error() << endl << "Missing </configuration> in file " << fname << endl << endl;
+            throw runtime_error("Error reading xml file");
+            }
         }
 
-    // extract the number of dimensions, or default to 3
-    if (configuration_node.isAttributeSet("dimensions"))
+    if (!root_closed)
         {
-        m_num_dimensions = atoi(configuration_node.getAttribute("dimensions"));
+        m_exec_conf->msg->error() << endl << "Missing </hoomd_xml> in file " << fname << endl << endl;
+        throw runtime_error("Error reading xml file");
         }
-    else
-        m_num_dimensions = 3;
 
-    // loop through all child nodes of the configuration
-    for (int cur_node=0; cur_node < configuration_node.nChildNode(); cur_node++)
+    if (num_configurations == 0)
         {
-        // extract the name and call the appropriate node parser, if it exists
-        XMLNode node = configuration_node.getChildNode(cur_node);
-        string name = node.getName();
-        transform(name.begin(), name.end(), name.begin(), ::tolower);
-
-        std::map< std::string, boost::function< void (const XMLNode&) > >::iterator parser;
-        parser = m_parser_map.find(name);
-        if (parser != m_parser_map.end())
-            parser->second(node);
-        else
-            m_exec_conf->msg->notice(2) << "Parser for node <" << name << "> not defined, ignoring" << endl;
+        m_exec_conf->msg->error() << endl << "No <configuration> specified in the XML file" << endl << endl;
+        throw runtime_error("Error reading xml file");
         }
 
     // check for required items in the file
@@ -532,6 +990,30 @@ void HOOMDInitializer::readFile(const string &fname)
         m_exec_conf->msg->notice(2) << m_moment_inertia.size() << " moments of inertia" << endl;
     }
 
+/*! \param begin Position of the opening '<' of the tag
+    \param end One past the closing '>' of the tag
+    \param name Name of the tag
+    \returns An XMLNode with the attributes of the tag, but without any children
+*/
+XMLNode HOOMDInitializer::parseStartTag(const char *begin, const char *end, const std::string& name)
+    {
+    // turn the start tag into an empty element tag so that it can be parsed on its own
+    string tag_text(begin, end - 1);
+    if (tag_text[tag_text.size()-1] != '/')
+        tag_text += "/";
+    tag_text += ">";
+
+    XMLResults results;
+    XMLNode node = XMLNode::parseString(tag_text.c_str(), name.c_str(), &results);
+    if (results.error != eXMLErrorNone)
+        {
+        m_exec_conf->msg->error() << endl << XMLNode::getError(results.error) << " in <" << name << "> node"
+                                  << endl << endl;
+        throw runtime_error("Error reading xml file");
+        }
+    return node;
+    }
+
 /*! \param node XMLNode passed from the top level parser in readFile
     This function extracts all of the information in the attributes of the \b box node
 */
@@ -604,355 +1086,198 @@ void HOOMDInitializer::parseBoxNode(const XMLNode &node)
     m_box_read = true;
     }
 
-/*! \param node XMLNode passed from the top level parser in readFile
+/*! \param text First character of the text of the \b position node
+    \param text_end One past the last character of the text
     This function extracts all of the data in a \b position node and fills out m_pos_array. The number
     of particles in the array is determined dynamically.
 */
-void HOOMDInitializer::parsePositionNode(const XMLNode &node)
+void HOOMDInitializer::parsePositionNode(const char *text, const char *text_end)
     {
-    // check that this is actually a position node
-    string name = node.getName();
-    transform(name.begin(), name.end(), name.begin(), ::tolower);
-    assert(name == string("position"));
+    m_pos_array.reserve(m_pos_array.size() + count_lines(text, text_end));
 
-    // extract the data from the node
-    string all_text;
-    for (int i = 0; i < node.nText(); i++)
-        all_text += string(node.getText(i)) + string("\n");
-
-    istringstream parser;
-    parser.str(all_text);
-    while (parser.good())
-        {
-        Scalar x,y,z;
-        parser >> x >> y >> z;
-        if (parser.good())
-            m_pos_array.push_back(vec(x,y,z));
-        }
+    Scalar x,y,z;
+    while (read_scalar(text, text_end, x) && read_scalar(text, text_end, y) && read_scalar(text, text_end, z))
+        m_pos_array.push_back(vec(x,y,z));
     }
 
-/*! \param node XMLNode passed from the top level parser in readFile
+/*! \param text First character of the text of the \b image node
+    \param text_end One past the last character of the text
     This function extracts all of the data in a \b image node and fills out m_pos_array. The number
     of particles in the array is determined dynamically.
 */
-void HOOMDInitializer::parseImageNode(const XMLNode& node)
+void HOOMDInitializer::parseImageNode(const char *text, const char *text_end)
     {
-    string name = node.getName();
-    transform(name.begin(), name.end(), name.begin(), ::tolower);
-    assert(name == string("image"));
-
-    // extract the data from the node
-    string all_text;
-    for (int i = 0; i < node.nText(); i++)
-        all_text += string(node.getText(i)) + string("\n");
+    m_image_array.reserve(m_image_array.size() + count_lines(text, text_end));
 
-    istringstream parser;
-    parser.str(all_text);
-    while (parser.good())
-        {
-        int x,y,z;
-        parser >> x >> y >> z;
-        if (parser.good())
-            m_image_array.push_back(vec_int(x,y,z));
-        }
+    int x,y,z;
+    while (read_int(text, text_end, x) && read_int(text, text_end, y) && read_int(text, text_end, z))
+        m_image_array.push_back(vec_int(x,y,z));
     }
 
-/*! \param node XMLNode passed from the top level parser in readFile
+/*! \param text First character of the text of the \b velocity node
+    \param text_end One past the last character of the text
     This function extracts all of the data in a \b velocity node and fills out m_vel_array. The number
     of particles in the array is determined dynamically.
 */
-void HOOMDInitializer::parseVelocityNode(const XMLNode &node)
+void HOOMDInitializer::parseVelocityNode(const char *text, const char *text_end)
     {
-    // check that this is actually a velocity node
-    string name = node.getName();
-    transform(name.begin(), name.end(), name.begin(), ::tolower);
-    assert(name == string("velocity"));
-
-    // extract the data from the node
-    string all_text;
-    for (int i = 0; i < node.nText(); i++)
-        all_text += string(node.getText(i)) + string("\n");
+    m_vel_array.reserve(m_vel_array.size() + count_lines(text, text_end));
 
-    istringstream parser;
-    parser.str(all_text);
-    while (parser.good())
-        {
-        Scalar x,y,z;
-        parser >> x >> y >> z;
-        if (parser.good())
-            m_vel_array.push_back(vec(x,y,z));
-        }
+    Scalar x,y,z;
+    while (read_scalar(text, text_end, x) && read_scalar(text, text_end, y) && read_scalar(text, text_end, z))
+        m_vel_array.push_back(vec(x,y,z));
     }
 
-/*! \param node XMLNode passed from the top level parser in readFile
+/*! \param text First character of the text of the \b mass node
+    \param text_end One past the last character of the text
     This function extracts all of the data in a \b mass node and fills out m_mass_array. The number
     of particles in the array is determined dynamically.
 */
-void HOOMDInitializer::parseMassNode(const XMLNode &node)
+void HOOMDInitializer::parseMassNode(const char *text, const char *text_end)
     {
-    // check that this is actually a velocity node
-    string name = node.getName();
-    transform(name.begin(), name.end(), name.begin(), ::tolower);
-    assert(name == string("mass"));
-
-    // extract the data from the node
-    string all_text;
-    for (int i = 0; i < node.nText(); i++)
-        all_text += string(node.getText(i)) + string("\n");
+    m_mass_array.reserve(m_mass_array.size() + count_lines(text, text_end));
 
-    istringstream parser;
-    parser.str(all_text);
-    while (parser.good())
-        {
-        Scalar mass;
-        parser >> mass;
-        if (parser.good())
-            m_mass_array.push_back(mass);
-        }
+    Scalar mass;
+    while (read_scalar(text, text_end, mass))
+        m_mass_array.push_back(mass);
     }
 
-/*! \param node XMLNode passed from the top level parser in readFile
+/*! \param text First character of the text of the \b diameter node
+    \param text_end One past the last character of the text
     This function extracts all of the data in a \b diameter node and fills out m_diameter_array. The number
     of particles in the array is determined dynamically.
 */
-void HOOMDInitializer::parseDiameterNode(const XMLNode &node)
+void HOOMDInitializer::parseDiameterNode(const char *text, const char *text_end)
     {
-    // check that this is actually a velocity node
-    string name = node.getName();
-    transform(name.begin(), name.end(), name.begin(), ::tolower);
-    assert(name == string("diameter"));
+    m_diameter_array.reserve(m_diameter_array.size() + count_lines(text, text_end));
 
-    // extract the data from the node
-    string all_text;
-    for (int i = 0; i < node.nText(); i++)
-        all_text += string(node.getText(i)) + string("\n");
-
-    istringstream parser;
-    parser.str(all_text);
-    while (parser.good())
-        {
-        Scalar diameter;
-        parser >> diameter;
-        if (parser.good())
-            m_diameter_array.push_back(diameter);
-        }
+    Scalar diameter;
+    while (read_scalar(text, text_end, diameter))
+        m_diameter_array.push_back(diameter);
     }
 
-/*! \param node XMLNode passed from the top level parser in readFile
+/*! \param text First character of the text of the \b type node
+    \param text_end One past the last character of the text
     This function extracts all of the data in a \b type node and fills out m_type_array. The number
     of particles in the array is determined dynamically.
 */
-void HOOMDInitializer::parseTypeNode(const XMLNode &node)
+void HOOMDInitializer::parseTypeNode(const char *text, const char *text_end)
     {
-    // check that this is actually a type node
-    string name = node.getName();
-    transform(name.begin(), name.end(), name.begin(), ::tolower);
-    assert(name == string("type"));
-
-    // extract the data from the node
-    string all_text;
-    for (int i = 0; i < node.nText(); i++)
-        all_text += string(node.getText(i)) + string("\n");
+    m_type_array.reserve(m_type_array.size() + count_lines(text, text_end));
 
-    istringstream parser;
-    parser.str(all_text);
-    while (parser.good())
-        {
-        // dynamically determine the particle types
-        string type;
-        parser >> type;
-        if (parser.good())
-            m_type_array.push_back(getTypeId(type));
-        }
+    // dynamically determine the particle types
+    string type;
+    while (read_string(text, text_end, type))
+        m_type_array.push_back(getTypeId(type));
     }
 
-/*! \param node XMLNode passed from the top level parser in readFile
+/*! \param text First character of the text of the \b body node
+    \param text_end One past the last character of the text
     This function extracts all of the data in a \b body node and fills out m_body_array. The number
     of particles in the array is determined dynamically.
 */
-void HOOMDInitializer::parseBodyNode(const XMLNode &node)
+void HOOMDInitializer::parseBodyNode(const char *text, const char *text_end)
     {
-    // check that this is actually a type node
-    string name = node.getName();
-    transform(name.begin(), name.end(), name.begin(), ::tolower);
-    assert(name == string("body"));
-
-    // extract the data from the node
-    string all_text;
-    for (int i = 0; i < node.nText(); i++)
-        all_text += string(node.getText(i)) + string("\n");
+    m_body_array.reserve(m_body_array.size() + count_lines(text, text_end));
 
-    istringstream parser;
-    parser.str(all_text);
-    while (parser.good())
+    int body;
+    while (read_int(text, text_end, body))
         {
         // handle -1 as NO_BODY
-        int body;
-        parser >> body;
-
-        if (parser.good())
-            {
-            if (body == -1)
-                m_body_array.push_back(NO_BODY);
-            else
-                m_body_array.push_back(body);
-            }
+        if (body == -1)
+            m_body_array.push_back(NO_BODY);
+        else
+            m_body_array.push_back(body);
         }
     }
 
-/*! \param node XMLNode passed from the top level parser in readFile
+/*! \param text First character of the text of the \b bond node
+    \param text_end One past the last character of the text
     This function extracts all of the data in a \b bond node and fills out m_bonds. The number
     of bonds in the array is determined dynamically.
 */
-void HOOMDInitializer::parseBondNode(const XMLNode &node)
+void HOOMDInitializer::parseBondNode(const char *text, const char *text_end)
     {
-    // check that this is actually a bond node
-    string name = node.getName();
-    transform(name.begin(), name.end(), name.begin(), ::tolower);
-    assert(name == string("bond"));
-
-    // extract the data from the node
-    string all_text;
-    for (int i = 0; i < node.nText(); i++)
-        all_text += string(node.getText(i)) + string("\n");
-
-    istringstream parser;
-    parser.str(all_text);
-    while (parser.good())
+    unsigned int num_lines = count_lines(text, text_end);
+    m_bonds.reserve(m_bonds.size() + num_lines);
+    m_bond_types.reserve(m_bond_types.size() + num_lines);
+
+    string type_name;
+    BondData::members_t bond;
+    while (read_string(text, text_end, type_name)
+           && read_uint(text, text_end, bond.tag[0]) && read_uint(text, text_end, bond.tag[1]))
         {
-        string type_name;
-        unsigned int a, b;
-        parser >> type_name >> a >> b;
-        if (parser.good())
-            {
-            BondData::members_t bond;
-            bond.tag[0] = a; bond.tag[1] = b;
-            m_bonds.push_back(bond);
-            m_bond_types.push_back(getBondTypeId(type_name));
-            }
+        m_bonds.push_back(bond);
+        m_bond_types.push_back(getBondTypeId(type_name));
         }
     }
 
-void HOOMDInitializer::parseAngleNode(const XMLNode &node)
+/*! \param text First character of the text of the \b angle node
+    \param text_end One past the last character of the text
+    This function extracts all of the data in a \b angle node and fills out m_angles. The number
+    of angles in the array is determined dynamically.
+*/
+void HOOMDInitializer::parseAngleNode(const char *text, const char *text_end)
     {
-    // check that this is actually a angle node
-    string name = node.getName();
-    transform(name.begin(), name.end(), name.begin(), ::tolower);
-    assert(name == string("angle"));
-
-    // extract the data from the node
-    string all_text;
-    for (int i = 0; i < node.nText(); i++)
-        all_text += string(node.getText(i)) + string("\n");
-
-    istringstream parser;
-    parser.str(all_text);
-    while (parser.good())
+    string type_name;
+    AngleData::members_t angle;
+    while (read_string(text, text_end, type_name)
+           && read_uint(text, text_end, angle.tag[0]) && read_uint(text, text_end, angle.tag[1])
+           && read_uint(text, text_end, angle.tag[2]))
         {
-        string type_name;
-        unsigned int a, b, c;
-        parser >> type_name >> a >> b >> c;
-        if (parser.good())
-            {
-            AngleData::members_t angle;
-            angle.tag[0] = a; angle.tag[1] = b; angle.tag[2] = c;
-            m_angles.push_back(angle);
-            m_angle_types.push_back(getAngleTypeId(type_name));
-            }
+        m_angles.push_back(angle);
+        m_angle_types.push_back(getAngleTypeId(type_name));
         }
     }
 
-/*! \param node XMLNode passed from the top level parser in readFile
+/*! \param text First character of the text of the \b dihedral node
+    \param text_end One past the last character of the text
     This function extracts all of the data in a \b dihedral node and fills out m_dihedrals. The number
     of dihedrals in the array is determined dynamically.
 */
-void HOOMDInitializer::parseDihedralNode(const XMLNode &node)
+void HOOMDInitializer::parseDihedralNode(const char *text, const char *text_end)
     {
-    // check that this is actually a dihedral node
-    string name = node.getName();
-    transform(name.begin(), name.end(), name.begin(), ::tolower);
-    assert(name == string("dihedral"));
-
-    // extract the data from the node
-    string all_text;
-    for (int i = 0; i < node.nText(); i++)
-        all_text += string(node.getText(i)) + string("\n");
-
-    istringstream parser;
-    parser.str(all_text);
-    while (parser.good())
+    string type_name;
+    DihedralData::members_t dihedral;
+    while (read_string(text, text_end, type_name)
+           && read_uint(text, text_end, dihedral.tag[0]) && read_uint(text, text_end, dihedral.tag[1])
+           && read_uint(text, text_end, dihedral.tag[2]) && read_uint(text, text_end, dihedral.tag[3]))
         {
-        string type_name;
-        unsigned int a, b, c, d;
-        parser >> type_name >> a >> b >> c >> d;
-        if (parser.good())
-            {
-            DihedralData::members_t dihedral;
-            dihedral.tag[0] = a; dihedral.tag[1] = b; dihedral.tag[2] = c; dihedral.tag[3] = d;
-            m_dihedrals.push_back(dihedral);
-            m_dihedral_types.push_back(getDihedralTypeId(type_name));
-            }
+        m_dihedrals.push_back(dihedral);
+        m_dihedral_types.push_back(getDihedralTypeId(type_name));
         }
     }
 
-/*! \param node XMLNode passed from the top level parser in readFile
-    This function extracts all of the data in a \b dihedral node and fills out m_dihedrals. The number
-    of dihedrals in the array is determined dynamically.
+/*! \param text First character of the text of the \b improper node
+    \param text_end One past the last character of the text
+    This function extracts all of the data in a \b improper node and fills out m_impropers. The number
+    of impropers in the array is determined dynamically.
 */
-void HOOMDInitializer::parseImproperNode(const XMLNode &node)
+void HOOMDInitializer::parseImproperNode(const char *text, const char *text_end)
     {
-    // check that this is actually a improper node
-    string name = node.getName();
-    transform(name.begin(), name.end(), name.begin(), ::tolower);
-    assert(name == string("improper"));
-
-    // extract the data from the node
-    string all_text;
-    for (int i = 0; i < node.nText(); i++)
-        all_text += string(node.getText(i)) + string("\n");
-
-    istringstream parser;
-    parser.str(all_text);
-    while (parser.good())
+    string type_name;
+    ImproperData::members_t improper;
+    while (read_string(text, text_end, type_name)
+           && read_uint(text, text_end, improper.tag[0]) && read_uint(text, text_end, improper.tag[1])
+           && read_uint(text, text_end, improper.tag[2]) && read_uint(text, text_end, improper.tag[3]))
         {
-        string type_name;
-        unsigned int a, b, c, d;
-        parser >> type_name >> a >> b >> c >> d;
-        if (parser.good())
-            {
-            ImproperData::members_t improper;
-            improper.tag[0] = a; improper.tag[1] = b; improper.tag[2] = c; improper.tag[3] = d;
-            m_impropers.push_back(improper);
-            m_improper_types.push_back(getImproperTypeId(type_name));
-            }
+        m_impropers.push_back(improper);
+        m_improper_types.push_back(getImproperTypeId(type_name));
         }
     }
 
-/*! \param node XMLNode passed from the top level parser in readFile
+/*! \param text First character of the text of the \b charge node
+    \param text_end One past the last character of the text
     This function extracts all of the data in a \b charge node and fills out m_charge_array. The number
     of particles in the array is determined dynamically.
 */
-void HOOMDInitializer::parseChargeNode(const XMLNode &node)
+void HOOMDInitializer::parseChargeNode(const char *text, const char *text_end)
     {
-    // check that this is actually a charge node
-    string name = node.getName();
-    transform(name.begin(), name.end(), name.begin(), ::tolower);
-    assert(name == string("charge"));
+    m_charge_array.reserve(m_charge_array.size() + count_lines(text, text_end));
 
-    // extract the data from the node
-    string all_text;
-    for (int i = 0; i < node.nText(); i++)
-        all_text += string(node.getText(i)) + string("\n");
-
-    istringstream parser;
-    parser.str(all_text);
-    while (parser.good())
-        {
-        Scalar charge;
-        parser >> charge;
-        if (parser.good())
-            m_charge_array.push_back(charge);
-        }
+    Scalar charge;
+    while (read_scalar(text, text_end, charge))
+        m_charge_array.push_back(charge);
     }
 
 /*! \param node XMLNode passed from the top level parser in readFile
@@ -1025,59 +1350,40 @@ void HOOMDInitializer::parseWallNode(const XMLNode& node)
         }
     }
 
-/*! \param node XMLNode passed from the top level parser in readFile
+/*! \param text First character of the text of the \b orientation node
+    \param text_end One past the last character of the text
     This function extracts all of the data in a \b orientation node and fills out m_orientation. The number
     of particles in the array is determined dynamically.
 */
-void HOOMDInitializer::parseOrientationNode(const XMLNode &node)
+void HOOMDInitializer::parseOrientationNode(const char *text, const char *text_end)
     {
-    // check that this is actually a charge node
-    string name = node.getName();
-    transform(name.begin(), name.end(), name.begin(), ::tolower);
-    assert(name == string("orientation"));
+    m_orientation.reserve(m_orientation.size() + count_lines(text, text_end));
 
-    // extract the data from the node
-    string all_text;
-    for (int i = 0; i < node.nText(); i++)
-        all_text += string(node.getText(i)) + string("\n");
-
-    istringstream parser;
-    parser.str(all_text);
-    while (parser.good())
-        {
-        Scalar ox, oy, oz, ow;
-        parser >> ox >> oy >> oz >> ow;
-        if (parser.good())
-            m_orientation.push_back(make_scalar4(ox, oy, oz, ow));
-        }
+    Scalar ox, oy, oz, ow;
+    while (read_scalar(text, text_end, ox) && read_scalar(text, text_end, oy)
+           && read_scalar(text, text_end, oz) && read_scalar(text, text_end, ow))
+        m_orientation.push_back(make_scalar4(ox, oy, oz, ow));
     }
 
-/*! \param node XMLNode passed from the top level parser in readFile
+/*! \param text First character of the text of the \b moment_inertia node
+    \param text_end One past the last character of the text
     This function extracts all of the data in a \b moment_inertia node and fills out m_moment_inertia. The number
     of particles in the array is determined dynamically.
 */
-void HOOMDInitializer::parseMomentInertiaNode(const XMLNode &node)
+void HOOMDInitializer::parseMomentInertiaNode(const char *text, const char *text_end)
     {
-    // check that this is actually a charge node
-    string name = node.getName();
-    transform(name.begin(), name.end(), name.begin(), ::tolower);
-    assert(name == string("moment_inertia"));
+    m_moment_inertia.reserve(m_moment_inertia.size() + count_lines(text, text_end));
 
-    // extract the data from the node
-    string all_text;
-    for (int i = 0; i < node.nText(); i++)
-        all_text += string(node.getText(i)) + string("\n");
-
-    istringstream parser;
-    parser.str(all_text);
-    while (parser.good())
+    while (true)
         {
         InertiaTensor I;
-        for (unsigned int i = 0; i < 6; i++)
-            parser >> I.components[i];
+        bool complete = true;
+        for (unsigned int i = 0; i < 6 && complete; i++)
+            complete = read_scalar(text, text_end, I.components[i]);
 
-        if (parser.good())
-            m_moment_inertia.push_back(I);
+        if (!complete)
+            break;
+        m_moment_inertia.push_back(I);
         }
     }
 
@@ -87,10 +87,16 @@ class SnapshotSystemData;
     to ParticleData which will then make the needed calls to copy the data into its representation.
 
     HOOMD's XML file format and this class are designed to be very extensible. Parsers for inidividual
-    XML nodes are written in separate functions and stored by name in the map \c m_parser_map. As the
-    main parser loops through, it reads in xml nodes and fires of parsers from this map to parse each
-    of them. Adding a new node to the file format parser is as simple as adding a new node parser function
-    (like parsePositionNode()) and adding it to the map in the constructor.
+    XML nodes are written in separate functions and stored by name in the maps \c m_text_parser_map and
+    \c m_parser_map. As the main parser loops through, it reads in xml nodes and fires of parsers from these maps
+    to parse each of them. Adding a new node to the file format parser is as simple as adding a new node parser
+    function (like parsePositionNode()) and adding it to one of the maps in the constructor.
+
+    The file is memory mapped and scanned tag by tag instead of being read into a DOM, so that large files can be
+    read with little more memory than the particle data itself. Nodes holding per-particle or per-bond data are
+    parsed straight from the mapped text by the parsers in \c m_text_parser_map. Nodes whose data is stored in
+    attributes or child nodes (box, wall) are small; each of them is parsed into its own XMLNode and passed to the
+    parsers in \c m_parser_map.
 
     \ingroup data_structs
 */
@@ -160,38 +166,40 @@ class HOOMDInitializer
     private:
         //! Helper function to read the input file
         void readFile(const std::string &fname);
+        //! Helper function to parse the attributes of a start tag
+        XMLNode parseStartTag(const char *begin, const char *end, const std::string& name);
         //! Helper function to parse the box node
         void parseBoxNode(const XMLNode& node);
         //! Helper function to parse the position node
-        void parsePositionNode(const XMLNode& node);
+        void parsePositionNode(const char *text, const char *text_end);
         //! Helper function to parse the image node
-        void parseImageNode(const XMLNode& node);
+        void parseImageNode(const char *text, const char *text_end);
         //! Helper function to parse the velocity node
-        void parseVelocityNode(const XMLNode& node);
+        void parseVelocityNode(const char *text, const char *text_end);
         //! Helper function to parse the mass node
-        void parseMassNode(const XMLNode& node);
+        void parseMassNode(const char *text, const char *text_end);
         //! Helper function to parse diameter node
-        void parseDiameterNode(const XMLNode& node);
+        void parseDiameterNode(const char *text, const char *text_end);
         //! Helper function to parse the type node
-        void parseTypeNode(const XMLNode& node);
+        void parseTypeNode(const char *text, const char *text_end);
         //! Helper function to parse the body node
-        void parseBodyNode(const XMLNode& node);
+        void parseBodyNode(const char *text, const char *text_end);
         //! Helper function to parse the bonds node
-        void parseBondNode(const XMLNode& node);
+        void parseBondNode(const char *text, const char *text_end);
         //! Helper function to parse the angle node
-        void parseAngleNode(const XMLNode& node);
+        void parseAngleNode(const char *text, const char *text_end);
         //! Helper function to parse the dihedral node
-        void parseDihedralNode(const XMLNode& node);
+        void parseDihedralNode(const char *text, const char *text_end);
         //! Helper function to parse the improper node
-        void parseImproperNode(const XMLNode& node);
+        void parseImproperNode(const char *text, const char *text_end);
         //! Parse charge node
-        void parseChargeNode(const XMLNode& node);
+        void parseChargeNode(const char *text, const char *text_end);
         //! Parse wall node
         void parseWallNode(const XMLNode& node);
         //! Parse orientation node
-        void parseOrientationNode(const XMLNode& node);
+        void parseOrientationNode(const char *text, const char *text_end);
         //! Parse moment inertia node
-        void parseMomentInertiaNode(const XMLNode& node);
+        void parseMomentInertiaNode(const char *text, const char *text_end);
 
         //! Helper function for identifying the particle type id
         unsigned int getTypeId(const std::string& name);
@@ -205,6 +213,7 @@ class HOOMDInitializer
         unsigned int getImproperTypeId(const std::string& name);
 
         std::map< std::string, boost::function< void (const XMLNode&) > > m_parser_map; //!< Map for dispatching parsers based on node type
+        std::map< std::string, boost::function< void (const char*, const char*) > > m_text_parser_map; //!< Map for dispatching parsers of the node text based on node type
 
         BoxDim m_box;   //!< Simulation box read from the file
         bool m_box_read;    //!< Stores the box we read in
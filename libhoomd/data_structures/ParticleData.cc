@@ -358,6 +358,17 @@ boost::signals2::connection ParticleData::connectSingleParticleMove(
     {
     return m_ptl_move_signal.connect(func);
     }
+
+/*! \param func Function to be called when particles migrate into or out of the local domain
+    \return Connection to manage the signal
+
+    The migration signal is triggered by removeParticles() and addParticles() right before the particle sort signal,
+    so that listeners can tell a change of the local particle set from a reordering of the same particles.
+ */
+boost::signals2::connection ParticleData::connectParticleMigration(const boost::function<void ()> &func)
+    {
+    return m_migrate_signal.connect(func);
+    }
 #endif
 
 /*! \param name Type name to get the index of
@@ -2172,7 +2183,8 @@ void ParticleData::removeParticles(std::vector<pdata_element>& out, std::vector<
 
     if (m_prof) m_prof->pop();
 
-    // notify subscribers that particle data order has been changed
+    // notify subscribers that the local particles and their order have been changed
+    m_migrate_signal();
     notifyParticleSort();
     }
 
@@ -2234,7 +2246,8 @@ void ParticleData::addParticles(const std::vector<pdata_element>& in)
 
     if (m_prof) m_prof->pop();
 
-    // notify subscribers that particle data order has been changed
+    // notify subscribers that the local particles and their order have been changed
+    m_migrate_signal();
     notifyParticleSort();
     }
 
@@ -2360,6 +2373,7 @@ void ParticleData::removeParticlesGPU(GPUVector<pdata_element>& out, GPUVector<u
     swapTags();
 
     // notify subscribers
+    m_migrate_signal();
     notifyParticleSort();
 
     if (m_prof) m_prof->pop(m_exec_conf);
@@ -2416,6 +2430,7 @@ void ParticleData::addParticlesGPU(const GPUVector<pdata_element>& in)
         }
 
     // notify subscribers
+    m_migrate_signal();
     notifyParticleSort();
 
     if (m_prof) m_prof->pop(m_exec_conf);
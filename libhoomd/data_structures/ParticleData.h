@@ -650,6 +650,9 @@ class ParticleData : boost::noncopyable
         //! Connects a function to be called every time a single particle migration is requested
         boost::signals2::connection connectSingleParticleMove(
             const boost::function<void (unsigned int, unsigned int, unsigned int)> &func);
+
+        //! Connects a function to be called every time particles migrate into or out of the local domain
+        boost::signals2::connection connectParticleMigration(const boost::function<void ()> &func);
         #endif
 
         //! Notify listeners that the number of ghost particles has changed
@@ -923,6 +926,7 @@ class ParticleData : boost::noncopyable
 
         #ifdef ENABLE_MPI
         boost::signals2::signal<void (unsigned int, unsigned int, unsigned int)> m_ptl_move_signal; //!< Signal when particle moves between domains
+        boost::signals2::signal<void ()> m_migrate_signal;    //!< Signal that is triggered when particles are added to or removed from the domain
         #endif
 
         unsigned int m_nparticles;                  //!< number of particles
@@ -0,0 +1,266 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+/*! \file ParticleDataHostAccess.cc
+    \brief Defines the ParticleDataHostAccess class
+*/
+
+#ifdef WIN32
+#pragma warning( push )
+#pragma warning( disable : 4103 4244 )
+#endif
+
+#include "ParticleDataHostAccess.h"
+
+#include <stdexcept>
+#include <string.h>
+
+using namespace boost::python;
+using namespace boost;
+using namespace std;
+
+/*! \param pdata Particle data to access
+
+    Acquires all exposed arrays on the host with read/write access.
+*/
+ParticleDataHostAccess::ParticleDataHostAccess(boost::shared_ptr<ParticleData> pdata)
+    : m_pdata(pdata), m_N(pdata->getN()), m_active(true)
+    {
+    m_pos = boost::shared_ptr< ArrayHandle<Scalar4> >(
+        new ArrayHandle<Scalar4>(m_pdata->getPositions(), access_location::host, access_mode::readwrite));
+    m_vel = boost::shared_ptr< ArrayHandle<Scalar4> >(
+        new ArrayHandle<Scalar4>(m_pdata->getVelocities(), access_location::host, access_mode::readwrite));
+    m_net_force = boost::shared_ptr< ArrayHandle<Scalar4> >(
+        new ArrayHandle<Scalar4>(m_pdata->getNetForce(), access_location::host, access_mode::readwrite));
+    m_tag = boost::shared_ptr< ArrayHandle<unsigned int> >(
+        new ArrayHandle<unsigned int>(m_pdata->getTags(), access_location::host, access_mode::read));
+    m_rtag = boost::shared_ptr< ArrayHandle<unsigned int> >(
+        new ArrayHandle<unsigned int>(m_pdata->getRTags(), access_location::host, access_mode::read));
+    }
+
+ParticleDataHostAccess::~ParticleDataHostAccess()
+    {
+    release();
+    }
+
+/*! Releases the held arrays. Buffers obtained from this access must not be used afterwards.
+*/
+void ParticleDataHostAccess::release()
+    {
+    m_pos.reset();
+    m_vel.reset();
+    m_net_force.reset();
+    m_tag.reset();
+    m_rtag.reset();
+    m_active = false;
+    }
+
+void ParticleDataHostAccess::checkActive() const
+    {
+    if (!m_active)
+        {
+        m_pdata->getExecConf()->msg->error() << "Particle data host access used after it was released" << endl;
+        throw runtime_error("Error accessing particle data");
+        }
+    }
+
+/*! \param data Host pointer to wrap
+    \param size Size of the memory in bytes
+    \param writable True if python may write to the memory
+    \returns A python buffer object pointing at \a data (no copy is made)
+
+    Arrays acquired with access_mode::read must not be wrapped writable: writes would not mark the device copy stale.
+*/
+object ParticleDataHostAccess::makeBuffer(void *data, size_t size, bool writable)
+    {
+    #if PY_MAJOR_VERSION >= 3
+    PyObject *buf = PyMemoryView_FromMemory((char *)data, size, writable ? PyBUF_WRITE : PyBUF_READ);
+    #else
+    PyObject *buf = writable ? PyBuffer_FromReadWriteMemory(data, size) : PyBuffer_FromMemory(data, size);
+    #endif
+    return object(handle<>(buf));
+    }
+
+object ParticleDataHostAccess::getPositions()
+    {
+    checkActive();
+    return makeBuffer(m_pos->data, sizeof(Scalar4)*m_N, true);
+    }
+
+object ParticleDataHostAccess::getVelocities()
+    {
+    checkActive();
+    return makeBuffer(m_vel->data, sizeof(Scalar4)*m_N, true);
+    }
+
+object ParticleDataHostAccess::getNetForces()
+    {
+    checkActive();
+    return makeBuffer(m_net_force->data, sizeof(Scalar4)*m_N, true);
+    }
+
+object ParticleDataHostAccess::getTags()
+    {
+    checkActive();
+    return makeBuffer(m_tag->data, sizeof(unsigned int)*m_N, false);
+    }
+
+object ParticleDataHostAccess::getRTags()
+    {
+    checkActive();
+    return makeBuffer(m_rtag->data, sizeof(unsigned int)*m_pdata->getRTags().getNumElements(), false);
+    }
+
+/*! \param values Python object supporting the buffer protocol, holding 3*N contiguous Scalars
+    \param out Vector to copy the values to
+*/
+void ParticleDataHostAccess::readValues(object values, std::vector<Scalar3>& out) const
+    {
+    Py_buffer view;
+    if (PyObject_GetBuffer(values.ptr(), &view, PyBUF_C_CONTIGUOUS) != 0)
+        {
+        PyErr_Clear();
+        m_pdata->getExecConf()->msg->error() << "Values must be a contiguous array" << endl;
+        throw runtime_error("Error setting particle data");
+        }
+
+    if (size_t(view.len) != sizeof(Scalar)*3*m_N)
+        {
+        PyBuffer_Release(&view);
+        m_pdata->getExecConf()->msg->error() << "Expected " << 3*m_N << " values of " << sizeof(Scalar)
+                                             << " bytes, got " << view.len << " bytes" << endl;
+        throw runtime_error("Error setting particle data");
+        }
+
+    out.resize(m_N);
+    const Scalar *src = (const Scalar *)view.buf;
+    for (unsigned int i = 0; i < m_N; i++)
+        out[i] = make_scalar3(src[3*i], src[3*i+1], src[3*i+2]);
+    PyBuffer_Release(&view);
+    }
+
+/*! \param values 3*N Scalars, the positions of the local particles in index order
+
+    Each position is shifted by the origin and wrapped into the global box. Image flags are not changed, as in
+    ParticleData::setPosition().
+
+    With a domain decomposition, particles that move out of the local domain would have to migrate to another rank,
+    which cannot be done while the arrays are held. setPositions() is therefore not available in that case. Every rank
+    has a decomposition, so all ranks fail the same way.
+*/
+void ParticleDataHostAccess::setPositions(object values)
+    {
+    checkActive();
+
+#ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        {
+        m_pdata->getExecConf()->msg->error() << "Setting all positions at once is not supported with a domain "
+                                             << "decomposition, set the positions of single particles instead" << endl;
+        throw runtime_error("Error setting particle data");
+        }
+#endif
+
+    std::vector<Scalar3> pos;
+    readValues(values, pos);
+
+    const BoxDim& box = m_pdata->getGlobalBox();
+    Scalar3 origin = m_pdata->getOrigin();
+    for (unsigned int i = 0; i < m_N; i++)
+        {
+        Scalar3 p = pos[i] + origin;
+        int3 img = make_int3(0,0,0);
+        box.wrap(p, img);
+        m_pos->data[i].x = p.x;
+        m_pos->data[i].y = p.y;
+        m_pos->data[i].z = p.z;
+        }
+    }
+
+/*! \param values 3*N Scalars, the velocities of the local particles in index order
+
+    The particle masses are not changed.
+*/
+void ParticleDataHostAccess::setVelocities(object values)
+    {
+    checkActive();
+    std::vector<Scalar3> vel;
+    readValues(values, vel);
+
+    for (unsigned int i = 0; i < m_N; i++)
+        {
+        m_vel->data[i].x = vel[i].x;
+        m_vel->data[i].y = vel[i].y;
+        m_vel->data[i].z = vel[i].z;
+        }
+    }
+
+void export_ParticleDataHostAccess()
+    {
+    class_<ParticleDataHostAccess, boost::shared_ptr<ParticleDataHostAccess>, boost::noncopyable>
+        ("ParticleDataHostAccess", init< boost::shared_ptr<ParticleData> >())
+    .def("release", &ParticleDataHostAccess::release)
+    .def("isActive", &ParticleDataHostAccess::isActive)
+    .def("getN", &ParticleDataHostAccess::getN)
+    .def("getScalarSize", &ParticleDataHostAccess::getScalarSize)
+    .def("getPositions", &ParticleDataHostAccess::getPositions)
+    .def("getVelocities", &ParticleDataHostAccess::getVelocities)
+    .def("getNetForces", &ParticleDataHostAccess::getNetForces)
+    .def("getTags", &ParticleDataHostAccess::getTags)
+    .def("getRTags", &ParticleDataHostAccess::getRTags)
+    .def("setPositions", &ParticleDataHostAccess::setPositions)
+    .def("setVelocities", &ParticleDataHostAccess::setVelocities)
+    ;
+    }
+
+#ifdef WIN32
+#pragma warning( pop )
+#endif
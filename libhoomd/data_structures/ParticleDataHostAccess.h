@@ -0,0 +1,165 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+/*! \file ParticleDataHostAccess.h
+    \brief Declares the ParticleDataHostAccess class
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#ifndef __PARTICLE_DATA_HOST_ACCESS_H__
+#define __PARTICLE_DATA_HOST_ACCESS_H__
+
+#include "ParticleData.h"
+
+#include <boost/shared_ptr.hpp>
+#include <boost/python.hpp>
+#include <boost/utility.hpp>
+#include <vector>
+
+//! Scoped host access to the local particle arrays from python
+/*! Reading the particle data through ParticleData::getPosition() and friends crosses from python into C++ once per
+    particle and property. ParticleDataHostAccess instead acquires the local position, velocity, net force, tag and
+    reverse tag arrays on the host for the lifetime of the access, and hands them to python as buffer objects that
+    point directly at the host memory. hoomd_script wraps the buffers in numpy arrays without copying. The tag and
+    reverse tag arrays are acquired read only, and their buffers are read only as well.
+
+    The buffers are valid only until release() is called. While the access is held, the arrays are acquired and no
+    other code may access them, so the access must be released before the simulation continues. On GPU builds, the
+    host copy is synchronized when the access is created and the changes are copied back to the device the next time
+    the device data is accessed.
+
+    Only the N local particles are exposed, in their current memory order. Use the tag and reverse tag arrays to map
+    between particle tags and indices.
+
+    setPositions() and setVelocities() set the whole local array from a buffer of 3*N Scalars in one call. Positions
+    are shifted and wrapped the same way ParticleData::setPosition() does it. Particles are not migrated between
+    ranks, so setPositions() raises an error when there is a domain decomposition.
+    \ingroup data_structs
+*/
+class ParticleDataHostAccess : boost::noncopyable
+    {
+    public:
+        //! Constructor
+        ParticleDataHostAccess(boost::shared_ptr<ParticleData> pdata);
+
+        //! Destructor
+        ~ParticleDataHostAccess();
+
+        //! Release the arrays
+        void release();
+
+        //! Test if the arrays are held
+        bool isActive() const
+            {
+            return m_active;
+            }
+
+        //! Get the number of local particles in the buffers
+        unsigned int getN() const
+            {
+            return m_N;
+            }
+
+        //! Get the size of a Scalar in bytes
+        unsigned int getScalarSize() const
+            {
+            return sizeof(Scalar);
+            }
+
+        //! Get a buffer of the N local positions and types (Scalar4)
+        boost::python::object getPositions();
+
+        //! Get a buffer of the N local velocities and masses (Scalar4)
+        boost::python::object getVelocities();
+
+        //! Get a buffer of the N local net forces and energies (Scalar4)
+        boost::python::object getNetForces();
+
+        //! Get a buffer of the N local tags (unsigned int)
+        boost::python::object getTags();
+
+        //! Get a buffer of the global reverse tags (unsigned int)
+        boost::python::object getRTags();
+
+        //! Set the local positions from 3*N Scalars
+        void setPositions(boost::python::object values);
+
+        //! Set the local velocities from 3*N Scalars
+        void setVelocities(boost::python::object values);
+
+    private:
+        boost::shared_ptr<ParticleData> m_pdata;    //!< Particle data being accessed
+        unsigned int m_N;                           //!< Number of local particles when the access was created
+        bool m_active;                              //!< True while the arrays are held
+
+        boost::shared_ptr< ArrayHandle<Scalar4> > m_pos;        //!< Held handle to the positions
+        boost::shared_ptr< ArrayHandle<Scalar4> > m_vel;        //!< Held handle to the velocities
+        boost::shared_ptr< ArrayHandle<Scalar4> > m_net_force;  //!< Held handle to the net forces
+        boost::shared_ptr< ArrayHandle<unsigned int> > m_tag;   //!< Held handle to the tags
+        boost::shared_ptr< ArrayHandle<unsigned int> > m_rtag;  //!< Held handle to the reverse tags
+
+        //! Check that the access is active
+        void checkActive() const;
+
+        //! Wrap host memory in a python buffer
+        static boost::python::object makeBuffer(void *data, size_t size, bool writable);
+
+        //! Copy 3*N Scalars out of a python buffer
+        void readValues(boost::python::object values, std::vector<Scalar3>& out) const;
+    };
+
+//! Exports ParticleDataHostAccess to python
+void export_ParticleDataHostAccess();
+
+#endif
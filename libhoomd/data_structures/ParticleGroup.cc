@@ -61,8 +61,13 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "CachedAllocator.h"
 #endif
 
+#ifdef ENABLE_MPI
+#include "HOOMDMPI.h"
+#endif
+
 #include <boost/python.hpp>
 #include <boost/bind.hpp>
+#include <boost/thread.hpp>
 using namespace boost::python;
 using namespace boost;
 
@@ -97,6 +102,47 @@ bool ParticleSelector::isSelected(unsigned int tag) const
     return false;
     }
 
+/*! \param member_tags Output: sorted list of all selected tags
+
+    The base class tests every tag with isSelected().
+*/
+void ParticleSelector::getSelectedTags(std::vector<unsigned int>& member_tags) const
+    {
+    member_tags.clear();
+    for (unsigned int tag = 0; tag < m_pdata->getNGlobal(); tag++)
+        {
+        // add the tag to the list if it matches the selection
+        if (isSelected(tag))
+            member_tags.push_back(tag);
+        }
+    }
+
+/*! \param member_tags On input, the tags selected among the local particles. On output, the sorted list of tags
+        selected on all ranks.
+*/
+void ParticleSelector::gatherSelectedTags(std::vector<unsigned int>& member_tags) const
+    {
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        {
+        // collect the local selections on the root processor and distribute the combined list
+        std::vector< std::vector<unsigned int> > all_tags;
+        gather_v(member_tags, all_tags, 0, m_exec_conf->getMPICommunicator());
+
+        if (m_exec_conf->getRank() == 0)
+            {
+            member_tags.clear();
+            for (unsigned int i = 0; i < all_tags.size(); i++)
+                member_tags.insert(member_tags.end(), all_tags[i].begin(), all_tags[i].end());
+            }
+
+        bcast(member_tags, 0, m_exec_conf->getMPICommunicator());
+        }
+    #endif
+
+    sort(member_tags.begin(), member_tags.end());
+    }
+
 //////////////////////////////////////////////////////////////////////////////
 // ParticleSelectorTag
 
@@ -130,6 +176,15 @@ bool ParticleSelectorTag::isSelected(unsigned int tag) const
     return (m_tag_min <= tag && tag <= m_tag_max);
     }
 
+/*! \param member_tags Output: sorted list of all selected tags
+*/
+void ParticleSelectorTag::getSelectedTags(std::vector<unsigned int>& member_tags) const
+    {
+    member_tags.clear();
+    for (unsigned int tag = m_tag_min; tag <= m_tag_max && tag < m_pdata->getNGlobal(); tag++)
+        member_tags.push_back(tag);
+    }
+
 //////////////////////////////////////////////////////////////////////////////
 // ParticleSelectorType
 
@@ -164,6 +219,27 @@ bool ParticleSelectorType::isSelected(unsigned int tag) const
     return result;
     }
 
+/*! \param member_tags Output: sorted list of all selected tags
+*/
+void ParticleSelectorType::getSelectedTags(std::vector<unsigned int>& member_tags) const
+    {
+    member_tags.clear();
+
+        {
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+
+        for (unsigned int idx = 0; idx < m_pdata->getN(); idx++)
+            {
+            unsigned int typ = __scalar_as_int(h_pos.data[idx].w);
+            if (m_typ_min <= typ && typ <= m_typ_max)
+                member_tags.push_back(h_tag.data[idx]);
+            }
+        }
+
+    gatherSelectedTags(member_tags);
+    }
+
 //////////////////////////////////////////////////////////////////////////////
 // ParticleSelectorRigid
 
@@ -196,11 +272,32 @@ bool ParticleSelectorRigid::isSelected(unsigned int tag) const
     return result;
     }
 
+/*! \param member_tags Output: sorted list of all selected tags
+*/
+void ParticleSelectorRigid::getSelectedTags(std::vector<unsigned int>& member_tags) const
+    {
+    member_tags.clear();
+
+        {
+        ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+
+        for (unsigned int idx = 0; idx < m_pdata->getN(); idx++)
+            {
+            bool in_body = (h_body.data[idx] != NO_BODY);
+            if (in_body == m_rigid)
+                member_tags.push_back(h_tag.data[idx]);
+            }
+        }
+
+    gatherSelectedTags(member_tags);
+    }
+
 //////////////////////////////////////////////////////////////////////////////
 // ParticleSelectorCuboid
 
 ParticleSelectorCuboid::ParticleSelectorCuboid(boost::shared_ptr<SystemDefinition> sysdef, Scalar3 min, Scalar3 max)
-    :ParticleSelector(sysdef), m_min(min), m_max(max)
+    :ParticleSelector(sysdef), m_min(min), m_max(max), m_num_threads(0)
     {
     // make a quick check on the sanity of the input data
     if (m_min.x >= m_max.x || m_min.y >= m_max.y || m_min.z >= m_max.z)
@@ -228,6 +325,84 @@ bool ParticleSelectorCuboid::isSelected(unsigned int tag) const
     return result;
     }
 
+/*! \param member_tags Output: sorted list of all selected tags
+
+    Positions are shifted and wrapped the same way as in ParticleData::getPosition(), so that the result is identical
+    to calling isSelected() on every tag. The local particles are split into one contiguous range per thread, and the
+    selections of the ranges are concatenated in order.
+*/
+void ParticleSelectorCuboid::getSelectedTags(std::vector<unsigned int>& member_tags) const
+    {
+    member_tags.clear();
+
+        {
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+
+        SelectArgs args;
+        args.pos = h_pos.data;
+        args.image = h_image.data;
+        args.tag = h_tag.data;
+        args.global_box = m_pdata->getGlobalBox();
+        args.origin = m_pdata->getOrigin();
+        args.o_image = m_pdata->getOriginImage();
+
+        unsigned int N = m_pdata->getN();
+        unsigned int num_threads = m_num_threads;
+        if (num_threads == 0)
+            {
+            num_threads = boost::thread::hardware_concurrency();
+            num_threads = std::min(num_threads, N / 16384);
+            }
+        num_threads = std::max(1u, std::min(num_threads, N));
+
+        if (num_threads == 1)
+            selectRange(args, 0, N, &member_tags);
+        else
+            {
+            std::vector< std::vector<unsigned int> > thread_tags(num_threads);
+            boost::thread_group threads;
+            for (unsigned int i = 0; i < num_threads; i++)
+                {
+                unsigned int first = (unsigned int)((unsigned long long)N * i / num_threads);
+                unsigned int last = (unsigned int)((unsigned long long)N * (i+1) / num_threads);
+                threads.create_thread(boost::bind(&ParticleSelectorCuboid::selectRange, this, boost::cref(args),
+                                                  first, last, &thread_tags[i]));
+                }
+            threads.join_all();
+
+            for (unsigned int i = 0; i < num_threads; i++)
+                member_tags.insert(member_tags.end(), thread_tags[i].begin(), thread_tags[i].end());
+            }
+        }
+
+    gatherSelectedTags(member_tags);
+    }
+
+/*! \param args Particle data to select from
+    \param first First local particle index to check
+    \param last One past the last local particle index to check
+    \param member_tags Output: the selected tags are appended
+*/
+void ParticleSelectorCuboid::selectRange(const SelectArgs& args, unsigned int first, unsigned int last,
+                                         std::vector<unsigned int> *member_tags) const
+    {
+    for (unsigned int idx = first; idx < last; idx++)
+        {
+        Scalar3 pos = make_scalar3(args.pos[idx].x, args.pos[idx].y, args.pos[idx].z) - args.origin;
+        int3 img = make_int3(args.image[idx].x - args.o_image.x,
+                             args.image[idx].y - args.o_image.y,
+                             args.image[idx].z - args.o_image.z);
+        args.global_box.wrap(pos, img);
+
+        if (m_min.x <= pos.x && pos.x < m_max.x &&
+            m_min.y <= pos.y && pos.y < m_max.y &&
+            m_min.z <= pos.z && pos.z < m_max.z)
+            member_tags->push_back(args.tag[idx]);
+        }
+    }
+
 //////////////////////////////////////////////////////////////////////////////
 // ParticleGroup
 
@@ -327,43 +502,87 @@ ParticleGroup::~ParticleGroup()
         }
     }
 
+/*! \param selector Selector used to choose the new group members
+
+    The data structures of the group are only updated if the membership actually changed.
+*/
 void ParticleGroup::updateMemberTags(boost::shared_ptr<ParticleSelector> selector)
     {
     // assign all of the particles that belong to the group
-    // for each particle in the (global) data
     vector<unsigned int> member_tags;
-    for (unsigned int tag = 0; tag < m_pdata->getNGlobal(); tag++)
+    selector->getSelectedTags(member_tags);
+
+    // nothing to do if the membership did not change
+    if (!m_is_member_tag.isNull() && m_is_member_tag.getNumElements() == m_pdata->getNGlobal()
+        && member_tags.size() == m_member_tags.getNumElements())
         {
-        // add the tag to the list if it matches the selection
-        if (selector->isSelected(tag))
-            member_tags.push_back(tag);
+        ArrayHandle<unsigned int> h_member_tags(m_member_tags, access_location::host, access_mode::read);
+        if (std::equal(member_tags.begin(), member_tags.end(), h_member_tags.data))
+            return;
         }
 
-    // store member tags
-    GPUArray<unsigned int> member_tags_array(member_tags.size(), m_pdata->getExecConf());
-    m_member_tags.swap(member_tags_array);
+    setMemberTags(member_tags);
+    }
+
+/*! \param member_tags Sorted list of the new member tags
+
+    If the tag lookup table is already allocated, only the entries of the old and new members are touched. The index
+    list is rebuilt the next time it is accessed.
+*/
+void ParticleGroup::setMemberTags(const std::vector<unsigned int>& member_tags)
+    {
+    bool incremental = !m_is_member_tag.isNull() && m_is_member_tag.getNumElements() == m_pdata->getNGlobal();
+
+    if (incremental)
+        {
+        // clear the flags of the old members
+        ArrayHandle<unsigned char> h_is_member_tag(m_is_member_tag, access_location::host, access_mode::readwrite);
+        ArrayHandle<unsigned int> h_member_tags(m_member_tags, access_location::host, access_mode::read);
+        unsigned int num_members = m_member_tags.getNumElements();
+        for (unsigned int member = 0; member < num_members; member++)
+            h_is_member_tag.data[h_member_tags.data[member]] = 0;
+        }
+
+    // store member tags, reallocating only if the number of members changed
+    if (m_member_tags.isNull() || m_member_tags.getNumElements() != member_tags.size())
+        {
+        GPUArray<unsigned int> member_tags_array(member_tags.size(), m_pdata->getExecConf());
+        m_member_tags.swap(member_tags_array);
+
+        GPUArray<unsigned int> member_idx(member_tags.size(), m_pdata->getExecConf());
+        m_member_idx.swap(member_idx);
+        }
 
         {
         ArrayHandle<unsigned int> h_member_tags(m_member_tags, access_location::host, access_mode::overwrite);
         std::copy(member_tags.begin(), member_tags.end(), h_member_tags.data);
         }
 
-
     // one byte per particle to indicate membership in the group, initialize with current number of local particles
-    GPUArray<unsigned char> is_member(m_pdata->getMaxN(), m_pdata->getExecConf());
-    m_is_member.swap(is_member);
-
-    GPUArray<unsigned char> is_member_tag(m_pdata->getNGlobal(), m_pdata->getExecConf());
-    m_is_member_tag.swap(is_member_tag);
+    if (m_is_member.isNull())
+        {
+        GPUArray<unsigned char> is_member(m_pdata->getMaxN(), m_pdata->getExecConf());
+        m_is_member.swap(is_member);
+        }
 
-    // build the reverse lookup table for tags
-    buildTagHash();
+    if (incremental)
+        {
+        // set the flags of the new members
+        ArrayHandle<unsigned char> h_is_member_tag(m_is_member_tag, access_location::host, access_mode::readwrite);
+        for (unsigned int member = 0; member < member_tags.size(); member++)
+            h_is_member_tag.data[member_tags[member]] = 1;
+        }
+    else
+        {
+        GPUArray<unsigned char> is_member_tag(m_pdata->getNGlobal(), m_pdata->getExecConf());
+        m_is_member_tag.swap(is_member_tag);
 
-    GPUArray<unsigned int> member_idx(member_tags.size(), m_pdata->getExecConf());
-    m_member_idx.swap(member_idx);
+        // build the reverse lookup table for tags
+        buildTagHash();
+        }
 
-    // now that the tag list is completely set up and all memory is allocated, rebuild the index list
-    rebuildIndexList();
+    // the index list is rebuilt on first use
+    m_particles_sorted = true;
     }
 
 void ParticleGroup::reallocate()
@@ -601,19 +820,24 @@ void ParticleGroup::rebuildIndexList() const
         ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
         ArrayHandle<unsigned int> h_member_idx(m_member_idx, access_location::host, access_mode::readwrite);
         unsigned int nparticles = m_pdata->getN();
+        unsigned int num_members = m_member_tags.getNumElements();
         unsigned int cur_member = 0;
-        for (unsigned int idx = 0; idx < nparticles; idx ++)
+        unsigned int idx = 0;
+
+        // branch-free compaction, as long as there are members left to be found
+        for (; idx < nparticles && cur_member < num_members; idx++)
             {
             assert(h_tag.data[idx] < m_pdata->getNGlobal());
             unsigned char is_member = h_is_member_tag.data[h_tag.data[idx]];
-            h_is_member.data[idx] =  is_member;
-            if (is_member)
-                {
-                h_member_idx.data[cur_member] = idx;
-                cur_member++;
-                }
+            h_is_member.data[idx] = is_member;
+            h_member_idx.data[cur_member] = idx;
+            cur_member += is_member;
             }
 
+        // all members have been found, the remaining particles are not in the group
+        if (idx < nparticles)
+            memset(h_is_member.data + idx, 0, sizeof(unsigned char)*(nparticles - idx));
+
         m_num_local_members = cur_member;
         assert(m_num_local_members <= m_member_tags.getNumElements());
         }
@@ -688,6 +912,7 @@ void export_ParticleGroup()
 
     class_<ParticleSelectorCuboid, boost::shared_ptr<ParticleSelectorCuboid>, bases<ParticleSelector>, boost::noncopyable>
         ("ParticleSelectorCuboid", init< boost::shared_ptr<SystemDefinition>, Scalar3, Scalar3 >())
+        .def("setNumThreads", &ParticleSelectorCuboid::setNumThreads)
         ;
     }
 
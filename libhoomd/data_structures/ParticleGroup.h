@@ -82,6 +82,11 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
     The base class isSelected() method will simply reject all particles. Derived classes will implement specific
     selection semantics.
+
+    Selecting a whole group one tag at a time through isSelected() costs a virtual call and a particle data lookup
+    per tag (and a collective operation per tag in MPI simulations). getSelectedTags() returns all selected tags at
+    once. The base class implementation falls back on isSelected(), while derived classes override it to evaluate the
+    criteria directly on the local particle data arrays and combine the results of all ranks in a single step.
 */
 class ParticleSelector
     {
@@ -92,7 +97,13 @@ class ParticleSelector
 
         //! Test if a particle meets the selection criteria
         virtual bool isSelected(unsigned int tag) const;
+
+        //! Get the tags of all particles that meet the selection criteria
+        virtual void getSelectedTags(std::vector<unsigned int>& member_tags) const;
     protected:
+        //! Combine the tags selected on all ranks into a sorted global list
+        void gatherSelectedTags(std::vector<unsigned int>& member_tags) const;
+
         boost::shared_ptr<SystemDefinition> m_sysdef;   //!< The system definition assigned to this selector
         boost::shared_ptr<ParticleData> m_pdata;        //!< The particle data from m_sysdef, stored as a convenience
         boost::shared_ptr<const ExecutionConfiguration> m_exec_conf; //!< Stored shared ptr to the execution configuration
@@ -108,6 +119,9 @@ class ParticleSelectorTag : public ParticleSelector
 
         //! Test if a particle meets the selection criteria
         virtual bool isSelected(unsigned int tag) const;
+
+        //! Get the tags of all particles that meet the selection criteria
+        virtual void getSelectedTags(std::vector<unsigned int>& member_tags) const;
     protected:
         unsigned int m_tag_min;     //!< Minimum tag to select
         unsigned int m_tag_max;     //!< Maximum tag to select (inclusive)
@@ -123,6 +137,9 @@ class ParticleSelectorType : public ParticleSelector
 
         //! Test if a particle meets the selection criteria
         virtual bool isSelected(unsigned int tag) const;
+
+        //! Get the tags of all particles that meet the selection criteria
+        virtual void getSelectedTags(std::vector<unsigned int>& member_tags) const;
     protected:
         unsigned int m_typ_min;     //!< Minimum type to select
         unsigned int m_typ_max;     //!< Maximum type to select (inclusive)
@@ -138,9 +155,36 @@ class ParticleSelectorCuboid : public ParticleSelector
 
         //! Test if a particle meets the selection criteria
         virtual bool isSelected(unsigned int tag) const;
+
+        //! Get the tags of all particles that meet the selection criteria
+        virtual void getSelectedTags(std::vector<unsigned int>& member_tags) const;
+
+        //! Set the number of threads to split getSelectedTags() over
+        /*! \param num_threads Number of threads, 0 uses all cores (and at most one thread per 16384 particles)
+        */
+        void setNumThreads(unsigned int num_threads)
+            {
+            m_num_threads = num_threads;
+            }
     protected:
         Scalar3 m_min;     //!< Minimum type to select (inclusive)
         Scalar3 m_max;     //!< Maximum type to select (exclusive)
+        unsigned int m_num_threads; //!< Number of threads to use in getSelectedTags()
+
+        //! Data shared by all threads in getSelectedTags()
+        struct SelectArgs
+            {
+            const Scalar4 *pos;     //!< Particle positions
+            const int3 *image;      //!< Particle images
+            const unsigned int *tag;    //!< Particle tags
+            BoxDim global_box;      //!< Global simulation box
+            Scalar3 origin;         //!< Origin of the particle positions
+            int3 o_image;           //!< Image of the origin
+            };
+
+        //! Selects the particles in a range of local indices
+        void selectRange(const SelectArgs& args, unsigned int first, unsigned int last,
+                         std::vector<unsigned int> *member_tags) const;
     };
 
 //! Select particles based on their rigid body
@@ -153,6 +197,9 @@ class ParticleSelectorRigid : public ParticleSelector
 
         //! Test if a particle meets the selection criteria
         virtual bool isSelected(unsigned int tag) const;
+
+        //! Get the tags of all particles that meet the selection criteria
+        virtual void getSelectedTags(std::vector<unsigned int>& member_tags) const;
     protected:
         bool m_rigid;   //!< true if we should select rigid boides, false if we should select non-rigid particles
     };
@@ -172,9 +219,9 @@ class ParticleSelectorRigid : public ParticleSelector
 
     Membership in the group is determined through a generic ParticleSelector class. See its documentation for details.
 
-    Group membership is determined once at the instantiation of the group. Thus ParticleGroup only supports static
-    groups where membership does not change over the course of a simulation. Dynamic groups, if they are needed,
-    may require a drastically different design to allow for efficient access.
+    Group membership is determined once at the instantiation of the group. It can be re-evaluated with
+    updateMemberTags(), which only touches the data structures if the membership actually changed.
+    GroupSelectUpdater calls it periodically during a run.
 
     In many use-cases, ParticleGroup may be accessed many times within inner loops. Thus, it must not aquire any
     ParticleData arrays within most of the get() calls as the caller must be allowed to leave their ParticleData
@@ -187,6 +234,8 @@ class ParticleSelectorRigid : public ParticleSelector
     in a sorted tag order. This list can be accessed directly via getMemberTag() to meet the 2nd use case listed above.
     In order to iterate through all particles in the group in a cache-efficient manner, an auxilliary list is stored
     that lists all particle <i>indicies</i> that belong to the group. This list must be updated on every particle sort.
+    The update is lazy: it is only performed the next time the index list of the group is accessed, so groups that are
+    not used in a given step cost nothing.
     Thirdly, a dynamic bitset is used to store one bit per particle for efficient O(1) tests if a given particle is in
     the group.
 
@@ -251,6 +300,15 @@ class ParticleGroup
             return h_member_tags.data[i];
             }
 
+        //! Direct access to the member tags
+        /*! \returns A GPUArray with the tags of all getNumMembersGlobal() members, in the order of getMemberTag()
+            \note The caller \b must \b not write to or change the array.
+        */
+        const GPUArray<unsigned int>& getMemberTagArray() const
+            {
+            return m_member_tags;
+            }
+
         //! Get a member index from the group
         /*! \param j Value from 0 to getNumMembers()-1 of the group member to get
             \returns Index of the member at position \a j
@@ -301,6 +359,21 @@ class ParticleGroup
             return m_member_idx;
             }
 
+        //! Direct access to the membership flags
+        /*! \returns A GPUArray with one flag per particle index, == 1 if the particle is in the group
+            \note The caller \b must \b not write to or change the array.
+
+            \note This method CAN access the particle data tag array if the index is rebuilt.
+                  Hence, the tag array may not be accessed in the same scope in which this method is called.
+        */
+        const GPUArray<unsigned char>& getMemberFlagArray() const
+            {
+            // check if local members have changed
+            if (m_particles_sorted) rebuildIndexList();
+
+            return m_is_member;
+            }
+
         // @}
         //! \name Analysis methods
         // @{
@@ -336,7 +409,7 @@ class ParticleGroup
         boost::signals2::connection m_max_particle_num_change_connection; //!< Connection to the max particle number change signal
         GPUArray<unsigned int> m_member_tags;           //!< Lists the tags of the paritcle members
         mutable unsigned int m_num_local_members;       //!< Number of members on the local processor
-        mutable bool m_particles_sorted;                //!< True if particle have been sorted since last rebuild
+        mutable bool m_particles_sorted;                //!< True if the index list needs to be rebuilt before use
 
         GPUArray<unsigned char> m_is_member_tag;        //!< One byte per particle, == 1 if tag is a member of the group
         #ifdef ENABLE_CUDA
@@ -357,6 +430,9 @@ class ParticleGroup
         //! Helper function to build the 1:1 hash for tag membership
         void buildTagHash();
 
+        //! Helper function to replace the member tags
+        void setMemberTags(const std::vector<unsigned int>& member_tags);
+
 #ifdef ENABLE_CUDA
         //! Helper function to rebuild the index lists afer the particles have been sorted
         void rebuildIndexListGPU() const;
@@ -55,12 +55,15 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 
 #include "RandomGenerator.h"
+#include "saruprng.h"
 
 #include <cassert>
 #include <stdexcept>
 
 #include <boost/python.hpp>
 #include <boost/python/suite/indexing/vector_indexing_suite.hpp>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
 using namespace boost::python;
 
 using namespace std;
@@ -84,7 +87,8 @@ GeneratedParticles::GeneratedParticles(boost::shared_ptr<const ExecutionConfigur
                                        unsigned int n_particles,
                                        const BoxDim& box,
                                        const std::map< std::string, Scalar >& radii)
-    : m_exec_conf(exec_conf), m_particles(n_particles), m_box(box), m_radii(radii)
+    : m_exec_conf(exec_conf), m_particles(n_particles), m_box(box), m_radii(radii),
+      m_region_lo(make_scalar3(0,0,0)), m_region_hi(make_scalar3(1,1,1)), m_partial(false), m_retries(0)
     {
     // sanity checks
     assert(n_particles > 0);
@@ -119,11 +123,6 @@ GeneratedParticles::GeneratedParticles(boost::shared_ptr<const ExecutionConfigur
     if (m_Mz == 0)
         m_Mz = 1;
 
-    if (m_Mx > 100 || m_My > 100 || m_Mz > 100)
-        {
-        m_exec_conf->msg->warning() << "Random generator is about to allocate a very large amount of memory and may crash." << endl << endl;
-        }
-
     // setup the memory arrays
     m_bins.resize(m_Mx*m_My*m_Mz);
     }
@@ -139,7 +138,9 @@ bool GeneratedParticles::canPlace(const particle& p)
     // begin with an error check that p.type is actually in the radius map
     if (m_radii.count(p.type) == 0)
         {
-        m_exec_conf->msg->error() << endl << "Radius not set for particle in RandomGenerator" << endl << endl;
+        // regions are filled on worker threads, the object is then retried and the error reported on the main thread
+        if (!m_partial)
+            m_exec_conf->msg->error() << endl << "Radius not set for particle in RandomGenerator" << endl << endl;
         throw runtime_error("Error placing particle");
         }
 
@@ -239,7 +240,9 @@ void GeneratedParticles::place(const particle& p, unsigned int idx)
     // begin with an error check that p.type is actually in the radius map
     if (m_radii.count(p.type) == 0)
         {
-        m_exec_conf->msg->error() << endl << "Radius not set for particle in RandomGenerator" << endl << endl;
+        // as in canPlace(), regions leave the error to the serial pass
+        if (!m_partial)
+            m_exec_conf->msg->error() << endl << "Radius not set for particle in RandomGenerator" << endl << endl;
         throw runtime_error("Error placing particle");
         }
 
@@ -347,6 +350,19 @@ void GeneratedParticles::addBond(unsigned int a, unsigned int b, const std::stri
     m_bonds.push_back(bond(a,b, type));
     }
 
+/*! \param lo Lower corner of the region in fractional coordinates
+    \param hi Upper corner of the region in fractional coordinates
+
+    Objects should start inside the region, but may extend out of it. Particles outside of the region are still
+    checked for overlaps, but only against the objects of this region.
+*/
+void GeneratedParticles::setRegion(const Scalar3& lo, const Scalar3& hi)
+    {
+    m_region_lo = lo;
+    m_region_hi = hi;
+    m_partial = true;
+    }
+
 /*! \param exec_conf Execution configuration
     \param box Box dimensions to generate in
     \param seed Random number generator seed
@@ -359,7 +375,8 @@ RandomGenerator::RandomGenerator(boost::shared_ptr<const ExecutionConfiguration>
     : m_exec_conf(exec_conf),
       m_box(box),
       m_seed(seed),
-      m_dimensions(dimensions)
+      m_dimensions(dimensions),
+      m_num_threads(0)
     {
     }
 
@@ -438,38 +455,295 @@ void RandomGenerator::generate()
     assert(m_generators.size() > 0);
     assert(m_generators.size() == m_generator_repeat.size());
 
-    // count the number of particles
+    // list the objects to generate and count the number of particles
+    std::vector<object> objects;
     unsigned int n_particles = 0;
     for (unsigned int i = 0; i < m_generators.size(); i++)
-        n_particles += m_generator_repeat[i] * m_generators[i]->getNumToGenerate();
+        {
+        for (unsigned int j = 0; j < m_generator_repeat[i]; j++)
+            {
+            object obj;
+            obj.generator = i;
+            obj.start_idx = n_particles;
+            objects.push_back(obj);
+            n_particles += m_generators[i]->getNumToGenerate();
+            }
+        }
 
     // setup data structures
     m_data = GeneratedParticles(m_exec_conf, n_particles, m_box, m_radii);
 
+    // the regions are binned the same way on the worker threads, so the memory use is only checked here
+    if (m_data.m_Mx > 100 || m_data.m_My > 100 || m_data.m_Mz > 100)
+        {
+        m_exec_conf->msg->warning() << "Random generator is about to allocate a very large amount of memory and may crash." << endl << endl;
+        }
+
+    // split large systems into regions of roughly 4096 particles, at most 8 along each direction
+    unsigned int n_regions = std::min(n_particles / 4096, (unsigned int)objects.size());
+    unsigned int n_split = 1;
+    while (n_split < 8)
+        {
+        unsigned int next = (m_dimensions == 2) ? (n_split+1)*(n_split+1) : (n_split+1)*(n_split+1)*(n_split+1);
+        if (next > n_regions)
+            break;
+        n_split++;
+        }
+
+    if (n_split < 2)
+        generateSerial(objects);
+    else
+        generateRegions(objects, n_particles, make_uint3(n_split, n_split, (m_dimensions == 2) ? 1 : n_split));
+
+    // get the type id of all particles
+    for (unsigned int i = 0; i < m_data.m_particles.size(); i++)
+        {
+        m_data.m_particles[i].type_id = getTypeId(m_data.m_particles[i].type);
+        }
+
+    // walk through all the bonds and assign ids
+    for (unsigned int i = 0; i < m_data.m_bonds.size(); i++)
+        m_data.m_bonds[i].type_id = getBondTypeId(m_data.m_bonds[i].type);
+    }
+
+/*! \param objects Objects to place
+*/
+void RandomGenerator::generateSerial(const std::vector<object>& objects)
+    {
     // start the random number generator
     boost::mt19937 rnd;
     rnd.seed(boost::mt19937::result_type(m_seed));
 
     // perform the generation
-    unsigned int start_idx = 0;
+    for (unsigned int k = 0; k < objects.size(); k++)
+        m_generators[objects[k].generator]->generateParticles(m_data, rnd, objects[k].start_idx);
+    }
+
+//! State shared by the worker threads of RandomGenerator::generateRegions()
+struct RandomGenerator::WorkerState
+    {
+    //! Constructor
+    WorkerState(std::vector<region>& _regions, const std::vector<object>& _objects)
+        : regions(_regions), objects(_objects), next(0), failed(false)
+        {
+        }
+
+    std::vector<region>& regions;           //!< The regions to generate
+    const std::vector<object>& objects;     //!< All objects
+    unsigned int next;                      //!< Next region to hand out
+    bool failed;                            //!< Set when a worker caught an unexpected exception
+    boost::mutex mutex;                     //!< Protects next and failed
+    };
+
+/*! \param objects Objects to place
+    \param n_particles Total number of particles
+    \param grid Number of regions along each direction
+*/
+void RandomGenerator::generateRegions(const std::vector<object>& objects, unsigned int n_particles, const uint3& grid)
+    {
+    unsigned int n_regions = grid.x*grid.y*grid.z;
+    std::vector<region> regions(n_regions);
+    for (unsigned int r = 0; r < n_regions; r++)
+        {
+        unsigned int ix = r / (grid.y*grid.z);
+        unsigned int iy = (r / grid.z) % grid.y;
+        unsigned int iz = r % grid.z;
+        regions[r].lo = make_scalar3(Scalar(ix)/Scalar(grid.x), Scalar(iy)/Scalar(grid.y), Scalar(iz)/Scalar(grid.z));
+        regions[r].hi = make_scalar3(Scalar(ix+1)/Scalar(grid.x), Scalar(iy+1)/Scalar(grid.y), Scalar(iz+1)/Scalar(grid.z));
+        }
+
+    // deal the objects out to the regions, so that each region gets the same mix
+    for (unsigned int k = 0; k < objects.size(); k++)
+        regions[k % n_regions].objects.push_back(k);
+
+    // place the objects of all regions independently
+    unsigned int num_threads = m_num_threads;
+    if (num_threads == 0)
+        num_threads = boost::thread::hardware_concurrency();
+    if (num_threads == 0)
+        num_threads = 1;
+    num_threads = std::min(num_threads, n_regions);
+
+    // python generators cannot run without the GIL, keep them on this thread
     for (unsigned int i = 0; i < m_generators.size(); i++)
         {
-        for (unsigned int j = 0; j < m_generator_repeat[i]; j++)
+        if (!m_generators[i]->isThreadSafe())
+            num_threads = 1;
+        }
+
+    m_exec_conf->msg->notice(2) << "RandomGenerator: placing " << n_particles << " particles in " << n_regions
+                                << " regions on " << num_threads << " threads" << endl;
+
+    WorkerState state(regions, objects);
+    if (num_threads == 1)
+        regionWorker(&state);
+    else
+        {
+        boost::thread_group threads;
+        for (unsigned int i = 0; i < num_threads; i++)
+            threads.create_thread(boost::bind(&RandomGenerator::regionWorker, this, &state));
+        threads.join_all();
+        }
+
+    if (state.failed)
+        {
+        m_exec_conf->msg->error() << "RandomGenerator: unexpected error while generating particles" << endl << endl;
+        throw runtime_error("Error generating particles");
+        }
+
+    // report the retries now that the workers are done with the messenger
+    unsigned int retries = 0;
+    for (unsigned int r = 0; r < n_regions; r++)
+        retries += regions[r].retries;
+    if (retries > 0)
+        m_exec_conf->msg->notice(2) << "RandomGenerator: started " << retries
+                                    << " objects over while filling the regions" << endl;
+
+    // merge the regions in object order, dropping objects that overlap objects of other regions placed before them
+    std::vector<unsigned int> rejected;
+    for (unsigned int k = 0; k < objects.size(); k++)
+        {
+        const region& reg = regions[k % n_regions];
+        unsigned int j = k / n_regions;
+        const object& obj = objects[k];
+        unsigned int n = m_generators[obj.generator]->getNumToGenerate();
+
+        bool ok = reg.placed[j];
+        unsigned int i = 0;
+        for (; ok && i < n; i++)
+            {
+            const GeneratedParticles::particle& p = reg.particles[reg.local_start[j] + i];
+            if (!m_data.canPlace(p))
+                {
+                ok = false;
+                break;
+                }
+
+            // p is already inside the box, keep its image from the region
+            m_data.place(p, obj.start_idx + i);
+            m_data.m_particles[obj.start_idx + i] = p;
+            }
+
+        if (!ok)
+            {
+            // roll back the particles placed so far
+            for (unsigned int l = 0; l < i; l++)
+                m_data.undoPlace(obj.start_idx + l);
+            rejected.push_back(k);
+            continue;
+            }
+
+        for (unsigned int b = reg.bond_start[j]; b < reg.bond_start[j+1]; b++)
             {
-            m_generators[i]->generateParticles(m_data, rnd, start_idx);
-            start_idx += m_generators[i]->getNumToGenerate();
+            const GeneratedParticles::bond& bond = reg.bonds[b];
+            m_data.addBond(bond.tag_a - reg.local_start[j] + obj.start_idx,
+                           bond.tag_b - reg.local_start[j] + obj.start_idx,
+                           bond.type);
             }
         }
 
-    // get the type id of all particles
-    for (unsigned int i = 0; i < m_data.m_particles.size(); i++)
+    // free the memory of the regions before the serial pass
+    std::vector<region>().swap(regions);
+
+    // generate the rejected objects again, against the complete system
+    if (rejected.size() > 0)
+        m_exec_conf->msg->notice(2) << "RandomGenerator: placing " << rejected.size()
+                                    << " objects that overlapped between regions" << endl;
+
+    boost::mt19937 rnd;
+    Saru saru(m_seed, n_regions);
+    rnd.seed(boost::mt19937::result_type(saru.u32()));
+    for (unsigned int r = 0; r < rejected.size(); r++)
         {
-        m_data.m_particles[i].type_id = getTypeId(m_data.m_particles[i].type);
+        const object& obj = objects[rejected[r]];
+        m_generators[obj.generator]->generateParticles(m_data, rnd, obj.start_idx);
         }
+    }
 
-    // walk through all the bonds and assign ids
-    for (unsigned int i = 0; i < m_data.m_bonds.size(); i++)
-        m_data.m_bonds[i].type_id = getBondTypeId(m_data.m_bonds[i].type);
+/*! \param reg Region to generate
+    \param objects All objects
+    \param idx Index of the region
+
+    The random number stream is seeded from the seed and \a idx only, so the result does not depend on the thread
+    that generates the region. Objects that cannot be placed are marked and left to the serial pass in
+    generateRegions().
+*/
+void RandomGenerator::generateRegion(region& reg, const std::vector<object>& objects, unsigned int idx)
+    {
+    unsigned int n_objects = (unsigned int)reg.objects.size();
+    reg.local_start.resize(n_objects);
+    reg.bond_start.resize(n_objects+1);
+    reg.placed.assign(n_objects, false);
+    reg.retries = 0;
+
+    unsigned int n_particles = 0;
+    for (unsigned int j = 0; j < n_objects; j++)
+        {
+        reg.local_start[j] = n_particles;
+        n_particles += m_generators[objects[reg.objects[j]].generator]->getNumToGenerate();
+        }
+
+    if (n_particles == 0)
+        {
+        reg.bond_start.assign(n_objects+1, 0);
+        return;
+        }
+
+    GeneratedParticles data(m_exec_conf, n_particles, m_box, m_radii);
+    data.setRegion(reg.lo, reg.hi);
+
+    boost::mt19937 rnd;
+    Saru saru(m_seed, idx);
+    rnd.seed(boost::mt19937::result_type(saru.u32()));
+
+    for (unsigned int j = 0; j < n_objects; j++)
+        {
+        reg.bond_start[j] = (unsigned int)data.m_bonds.size();
+        try
+            {
+            m_generators[objects[reg.objects[j]].generator]->generateParticles(data, rnd, reg.local_start[j]);
+            reg.placed[j] = true;
+            }
+        catch (std::runtime_error&)
+            {
+            // the region is too crowded, leave the object to the serial pass
+            data.m_bonds.resize(reg.bond_start[j]);
+            }
+        }
+    reg.bond_start[n_objects] = (unsigned int)data.m_bonds.size();
+    reg.retries = data.getNumRetries();
+
+    reg.particles.swap(data.m_particles);
+    reg.bonds.swap(data.m_bonds);
+    }
+
+/*! \param state Shared state of the workers
+
+    Generates regions until there are none left.
+*/
+void RandomGenerator::regionWorker(WorkerState* state)
+    {
+    while (true)
+        {
+        unsigned int idx;
+            {
+            boost::mutex::scoped_lock lock(state->mutex);
+            if (state->failed || state->next == state->regions.size())
+                return;
+            idx = state->next++;
+            }
+
+        try
+            {
+            generateRegion(state->regions[idx], state->objects, idx);
+            }
+        catch (...)
+            {
+            boost::mutex::scoped_lock lock(state->mutex);
+            state->failed = true;
+            return;
+            }
+        }
     }
 
 /*! \param name Name to get type id of
@@ -563,8 +837,9 @@ void PolymerParticleGenerator::generateParticles(GeneratedParticles& particles,
     // make a maximum of m_max_attempts tries to generate the polymer
     for (unsigned int attempt = 0; attempt < m_max_attempts; attempt++)
         {
-        // generate the position of the first particle
+        // generate the position of the first particle inside the region being filled
         Scalar3 f = make_scalar3(random01(rnd),random01(rnd),random01(rnd));
+        f = particles.getRegionLo() + f * (particles.getRegionHi() - particles.getRegionLo());
         if (m_dimensions == 2)
             f.z = 0;
         Scalar3 pos = box.makeCoordinates(f);
@@ -592,9 +867,16 @@ void PolymerParticleGenerator::generateParticles(GeneratedParticles& particles,
 
         // failure, rollback
         particles.undoPlace(start_idx);
-        m_exec_conf->msg->notice(2) << "Polymer generator is trying particle " << start_idx << " again" << endl;
+        if (particles.isPartial())
+            particles.addRetry();   // may be on a worker thread, RandomGenerator reports the count
+        else
+            m_exec_conf->msg->notice(2) << "Polymer generator is trying particle " << start_idx << " again" << endl;
         }
 
+    // when filling one region of a larger system, RandomGenerator retries the polymer against the complete system
+    if (particles.isPartial())
+        throw runtime_error("Error generating polymer in region");
+
     // we've failed to place a polymer, this is an unrecoverable error
     m_exec_conf->msg->error() << endl << "The polymer generator failed to place a polymer, the system is too dense or the separation radii are set too high" << endl << endl;
     throw runtime_error("Error generating polymer system");
@@ -686,6 +968,12 @@ class ParticleGeneratorWrap : public ParticleGenerator, public wrapper<ParticleG
             {
             this->get_override("generateParticle")(particles, rnd, start_idx);
             }
+
+        //! Python overrides need the GIL, so they must run on the calling thread
+        bool isThreadSafe()
+            {
+            return false;
+            }
     };
 
 
@@ -699,6 +987,7 @@ void export_RandomGenerator()
     // virtual methods from ParticleDataInitializer are inherited
     .def("setSeparationRadius", &RandomGenerator::setSeparationRadius)
     .def("addGenerator", &RandomGenerator::addGenerator)
+    .def("setNumThreads", &RandomGenerator::setNumThreads)
     .def("generate", &RandomGenerator::generate)
     .def("getSnapshot", &RandomGenerator::getSnapshot)
     ;
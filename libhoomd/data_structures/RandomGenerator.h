@@ -83,6 +83,13 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
     After all particles are placed in GeneratedParticles, RandomGenerator will
     then translate that data over to ParticleData in the initializer.
+
+    When RandomGenerator fills a large box in parallel, each thread works on a GeneratedParticles that holds only the
+    objects started in one region of the box. setRegion() marks it as such. Generators should choose the starting point
+    of each object inside getRegionLo() .. getRegionHi(), and may give up on an object early when isPartial() is true,
+    because RandomGenerator retries rejected objects later against the complete system. Messenger streams must not be
+    written from a worker thread: generators record retries with addRetry() instead, and RandomGenerator reports
+    the total once the threads are done.
 */
 class GeneratedParticles
     {
@@ -107,7 +114,7 @@ class GeneratedParticles
         //! Empty constructor
         /*! Included so that GeneratedParticles can be stored in a vector.
         */
-        GeneratedParticles() { }
+        GeneratedParticles() : m_partial(false), m_retries(0) { }
 
         //! Check if a particle can be placed while obeying the separation radii
         bool canPlace(const particle& p);
@@ -127,6 +134,39 @@ class GeneratedParticles
         //! Add a bond
         void addBond(unsigned int a, unsigned int b, const std::string& type="");
 
+        //! Restrict new objects to a region of the box
+        void setRegion(const Scalar3& lo, const Scalar3& hi);
+
+        //! Get the lower corner of the region new objects start in, in fractional coordinates
+        const Scalar3& getRegionLo() const
+            {
+            return m_region_lo;
+            }
+
+        //! Get the upper corner of the region new objects start in, in fractional coordinates
+        const Scalar3& getRegionHi() const
+            {
+            return m_region_hi;
+            }
+
+        //! Test if only the objects of one region are generated here
+        bool isPartial() const
+            {
+            return m_partial;
+            }
+
+        //! Record that an object had to be started over
+        void addRetry()
+            {
+            m_retries++;
+            }
+
+        //! Get the number of objects that were started over
+        unsigned int getNumRetries() const
+            {
+            return m_retries;
+            }
+
     private:
         friend class RandomGenerator;
 
@@ -138,6 +178,10 @@ class GeneratedParticles
         int m_My;       //!< Number of bins in the y direction
         int m_Mz;       //!< Number of bins in the z direction
         std::map< std::string, Scalar > m_radii;    //!< Separation radii accessed by particle type
+        Scalar3 m_region_lo;    //!< Lower corner of the region objects start in (fractional coordinates)
+        Scalar3 m_region_hi;    //!< Upper corner of the region objects start in (fractional coordinates)
+        bool m_partial;         //!< True if only the objects of one region are generated
+        unsigned int m_retries; //!< Number of objects that were started over
 
         //! Structure representing a single bond
         struct bond
@@ -197,6 +241,15 @@ class ParticleGenerator
             \a start_idx, \a start_idx + 1, ... \a start_idx + getNumToGenerate()-1
         */
         virtual void generateParticles(GeneratedParticles& particles, boost::mt19937& rnd, unsigned int start_idx)=0;
+
+        //! Test if generateParticles() may be called from a worker thread
+        /*! Generators implemented in python need the GIL, so RandomGenerator places all objects on the calling
+            thread when any of its generators returns false.
+        */
+        virtual bool isThreadSafe()
+            {
+            return true;
+            }
     };
 
 //! Generates random polymers
@@ -255,6 +308,14 @@ class PolymerParticleGenerator : public ParticleGenerator
 
     By default, bonds are named "bond". This can be changed by calling setBondType().
 
+    Large systems are generated in parallel. The box is split into a grid of regions and every object is assigned to
+    a region in round robin order. Each region places its objects on its own, with a random number stream seeded
+    from the seed and the region index. The regions are then merged in object order: an object that overlaps one
+    from another region is dropped and generated again against the complete system. The region grid depends only on
+    the system, not on the number of threads, so the result is the same for any setNumThreads(). Systems too small
+    to split are generated serially with a single stream, as before. When a generator is not thread safe (i.e. it is
+    implemented in python), the regions are generated one after another on the calling thread.
+
     \b Usage:<br>
     Before the initializer can be passed to a ParticleData for initialization, the following
     steps must be performed.
@@ -284,6 +345,14 @@ class RandomGenerator
         //! Adds a generator
         void addGenerator(unsigned int repeat, boost::shared_ptr<ParticleGenerator> generator);
 
+        //! Set the number of threads used by generate()
+        /*! \param num_threads Number of threads (0 selects the number of cores)
+        */
+        void setNumThreads(unsigned int num_threads)
+            {
+            m_num_threads = num_threads;
+            }
+
         //! Place the particles
         void generate();
 
@@ -298,6 +367,39 @@ class RandomGenerator
         std::vector<std::string> m_type_mapping;            //!< The created mapping between particle types and ids
         std::vector<std::string> m_bond_type_mapping;       //!< The created mapping between bond types and ids
         unsigned int m_dimensions;                          //!< Number of dimensions
+        unsigned int m_num_threads;                         //!< Number of threads to generate with
+
+        //! One object to generate
+        struct object
+            {
+            unsigned int generator; //!< Index of the generator
+            unsigned int start_idx; //!< Index of the first particle
+            };
+
+        //! The objects generated in one region
+        struct region
+            {
+            Scalar3 lo;                                         //!< Lower corner (fractional coordinates)
+            Scalar3 hi;                                         //!< Upper corner (fractional coordinates)
+            std::vector<unsigned int> objects;                  //!< Objects in the region
+            std::vector<unsigned int> local_start;              //!< Index of the first particle of each object
+            std::vector<unsigned int> bond_start;               //!< Index of the first bond of each object
+            std::vector<bool> placed;                           //!< True for each object that was placed
+            std::vector<GeneratedParticles::particle> particles;    //!< Particles generated in the region
+            std::vector<GeneratedParticles::bond> bonds;        //!< Bonds, in region particle indices
+            unsigned int retries;                               //!< Number of objects that were started over
+            };
+
+        //! Place all objects serially
+        void generateSerial(const std::vector<object>& objects);
+        //! Place the objects in a grid of regions and merge them
+        void generateRegions(const std::vector<object>& objects, unsigned int n_particles, const uint3& grid);
+        //! Place the objects of a single region
+        void generateRegion(region& reg, const std::vector<object>& objects, unsigned int idx);
+
+        struct WorkerState;
+        //! Worker thread of generateRegions()
+        void regionWorker(WorkerState* state);
 
         //! Helper function for identifying the particle type id
         unsigned int getTypeId(const std::string& name);
@@ -56,12 +56,14 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <stdexcept>
 #include <boost/shared_ptr.hpp>
 #include <boost/python.hpp>
+#include <boost/scoped_ptr.hpp>
 
 #include "HOOMDMath.h"
 #include "Index1D.h"
 #include "GPUArray.h"
 #include "ForceCompute.h"
 #include "NeighborList.h"
+#include "PotentialPairFused.h"
 
 #ifdef ENABLE_MPI
 #include "Communicator.h"
@@ -125,10 +127,14 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
     the evaluator. Perhaps in the future we could allow users to change that so multiple pair potentials could be logged
     independantly.
 
+    PotentialPair implements FusablePairPotential so that it can be evaluated together with other pair potentials on
+    the same neighbor list in a single PotentialPairFused pass. evalPair() holds the per pair evaluation shared by both
+    code paths.
+
     \sa export_PotentialPair()
 */
 template < class evaluator >
-class PotentialPair : public ForceCompute
+class PotentialPair : public ForceCompute, public FusablePairPotential
     {
     public:
         //! Param type from evaluator
@@ -172,6 +178,44 @@ class PotentialPair : public ForceCompute
         virtual CommFlags getRequestedCommFlags(unsigned int timestep);
         #endif
 
+        //! Test if this potential can be evaluated in a fused pass
+        virtual bool supportsFusion() const
+            {
+            return true;
+            }
+
+        //! Get the neighbor list the potential is evaluated over
+        virtual boost::shared_ptr<NeighborList> getNeighborList() const
+            {
+            return m_nlist;
+            }
+
+        //! Test if the potential needs particle diameters
+        virtual bool fusedNeedsDiameter() const
+            {
+            return evaluator::needsDiameter();
+            }
+
+        //! Test if the potential needs particle charges
+        virtual bool fusedNeedsCharge() const
+            {
+            return evaluator::needsCharge();
+            }
+
+        //! Prepare for a fused pass
+        virtual void beginFused();
+
+        //! Evaluate all pairs of particle i
+        virtual double evalFusedParticle(unsigned int i,
+                                         unsigned int typei,
+                                         Scalar di,
+                                         Scalar qi,
+                                         const FusedPairNeighbors& neigh,
+                                         FusedPairOutput& out);
+
+        //! Complete a fused pass
+        virtual void endFused();
+
     protected:
         boost::shared_ptr<NeighborList> m_nlist;    //!< The neighborlist to use for the computation
         energyShiftMode m_shift_mode;               //!< Store the mode with which to handle the energy shift at r_cut
@@ -182,8 +226,25 @@ class PotentialPair : public ForceCompute
         std::string m_prof_name;                    //!< Cached profiler name
         std::string m_log_name;                     //!< Cached log name
 
+        boost::scoped_ptr< ArrayHandle<Scalar> > m_fused_ronsq;        //!< ronsq held during a fused pass
+        boost::scoped_ptr< ArrayHandle<Scalar> > m_fused_rcutsq;       //!< rcutsq held during a fused pass
+        boost::scoped_ptr< ArrayHandle<param_type> > m_fused_params;   //!< Parameters held during a fused pass
+
         //! Actually compute the forces
         virtual void computeForces(unsigned int timestep);
+
+        //! Evaluate the force and energy of a single pair
+        inline bool evalPair(Scalar rsq,
+                             unsigned int typpair_idx,
+                             Scalar di,
+                             Scalar dj,
+                             Scalar qi,
+                             Scalar qj,
+                             const param_type *params,
+                             const Scalar *rcutsq_array,
+                             const Scalar *ronsq_array,
+                             Scalar& force_divr,
+                             Scalar& pair_eng);
     };
 
 /*! \param sysdef System to compute forces on
@@ -416,65 +477,14 @@ void PotentialPair< evaluator >::computeForces(unsigned int timestep)
             // calculate r_ij squared (FLOPS: 5)
             Scalar rsq = dot(dx, dx);
 
-            // get parameters for this type pair
-            unsigned int typpair_idx = m_typpair_idx(typei, typej);
-            param_type param = h_params.data[typpair_idx];
-            Scalar rcutsq = h_rcutsq.data[typpair_idx];
-            Scalar ronsq = Scalar(0.0);
-            if (m_shift_mode == xplor)
-                ronsq = h_ronsq.data[typpair_idx];
-
-            // design specifies that energies are shifted if
-            // 1) shift mode is set to shift
-            // or 2) shift mode is explor and ron > rcut
-            bool energy_shift = false;
-            if (m_shift_mode == shift)
-                energy_shift = true;
-            else if (m_shift_mode == xplor)
-                {
-                if (ronsq > rcutsq)
-                    energy_shift = true;
-                }
-
             // compute the force and potential energy
             Scalar force_divr = Scalar(0.0);
             Scalar pair_eng = Scalar(0.0);
-            evaluator eval(rsq, rcutsq, param);
-            if (evaluator::needsDiameter())
-                eval.setDiameter(di, dj);
-            if (evaluator::needsCharge())
-                eval.setCharge(qi, qj);
-
-            bool evaluated = eval.evalForceAndEnergy(force_divr, pair_eng, energy_shift);
+            bool evaluated = evalPair(rsq, m_typpair_idx(typei, typej), di, dj, qi, qj,
+                                      h_params.data, h_rcutsq.data, h_ronsq.data, force_divr, pair_eng);
 
             if (evaluated)
                 {
-                // modify the potential for xplor shifting
-                if (m_shift_mode == xplor)
-                    {
-                    if (rsq >= ronsq && rsq < rcutsq)
-                        {
-                        // Implement XPLOR smoothing (FLOPS: 16)
-                        Scalar old_pair_eng = pair_eng;
-                        Scalar old_force_divr = force_divr;
-
-                        // calculate 1.0 / (xplor denominator)
-                        Scalar xplor_denom_inv =
-                            Scalar(1.0) / ((rcutsq - ronsq) * (rcutsq - ronsq) * (rcutsq - ronsq));
-
-                        Scalar rsq_minus_r_cut_sq = rsq - rcutsq;
-                        Scalar s = rsq_minus_r_cut_sq * rsq_minus_r_cut_sq *
-                                   (rcutsq + Scalar(2.0) * rsq - Scalar(3.0) * ronsq) * xplor_denom_inv;
-                        Scalar ds_dr_divr = Scalar(12.0) * (rsq - ronsq) * rsq_minus_r_cut_sq * xplor_denom_inv;
-
-                        // make modifications to the old pair energy and force
-                        pair_eng = old_pair_eng * s;
-                        // note: I'm not sure why the minus sign needs to be there: my notes have a +
-                        // But this is verified correct via plotting
-                        force_divr = s * old_force_divr - ds_dr_divr * old_pair_eng;
-                        }
-                    }
-
                 Scalar force_div2r = force_divr * Scalar(0.5);
                 // add the force, potential energy and virial to the particle i
                 // (FLOPS: 8)
@@ -532,6 +542,187 @@ void PotentialPair< evaluator >::computeForces(unsigned int timestep)
     if (m_prof) m_prof->pop();
     }
 
+/*! \param rsq Squared distance between the particles
+    \param typpair_idx Index of the type pair in the per type pair arrays
+    \param di Diameter of particle i
+    \param dj Diameter of particle j
+    \param qi Charge of particle i
+    \param qj Charge of particle j
+    \param params Per type pair parameters
+    \param rcutsq_array Per type pair rcutsq
+    \param ronsq_array Per type pair ronsq
+    \param force_divr Output F(r)/r
+    \param pair_eng Output pair energy
+
+    \returns True if the pair is within the cutoff and the outputs were written
+
+    The energy shift and XPLOR smoothing are applied according to the current shift mode.
+*/
+template< class evaluator >
+inline bool PotentialPair< evaluator >::evalPair(Scalar rsq,
+                                                 unsigned int typpair_idx,
+                                                 Scalar di,
+                                                 Scalar dj,
+                                                 Scalar qi,
+                                                 Scalar qj,
+                                                 const param_type *params,
+                                                 const Scalar *rcutsq_array,
+                                                 const Scalar *ronsq_array,
+                                                 Scalar& force_divr,
+                                                 Scalar& pair_eng)
+    {
+    // get parameters for this type pair
+    param_type param = params[typpair_idx];
+    Scalar rcutsq = rcutsq_array[typpair_idx];
+    Scalar ronsq = Scalar(0.0);
+    if (m_shift_mode == xplor)
+        ronsq = ronsq_array[typpair_idx];
+
+    // design specifies that energies are shifted if
+    // 1) shift mode is set to shift
+    // or 2) shift mode is explor and ron > rcut
+    bool energy_shift = false;
+    if (m_shift_mode == shift)
+        energy_shift = true;
+    else if (m_shift_mode == xplor)
+        {
+        if (ronsq > rcutsq)
+            energy_shift = true;
+        }
+
+    // compute the force and potential energy
+    evaluator eval(rsq, rcutsq, param);
+    if (evaluator::needsDiameter())
+        eval.setDiameter(di, dj);
+    if (evaluator::needsCharge())
+        eval.setCharge(qi, qj);
+
+    bool evaluated = eval.evalForceAndEnergy(force_divr, pair_eng, energy_shift);
+
+    // modify the potential for xplor shifting
+    if (evaluated && m_shift_mode == xplor)
+        {
+        if (rsq >= ronsq && rsq < rcutsq)
+            {
+            // Implement XPLOR smoothing (FLOPS: 16)
+            Scalar old_pair_eng = pair_eng;
+            Scalar old_force_divr = force_divr;
+
+            // calculate 1.0 / (xplor denominator)
+            Scalar xplor_denom_inv =
+                Scalar(1.0) / ((rcutsq - ronsq) * (rcutsq - ronsq) * (rcutsq - ronsq));
+
+            Scalar rsq_minus_r_cut_sq = rsq - rcutsq;
+            Scalar s = rsq_minus_r_cut_sq * rsq_minus_r_cut_sq *
+                       (rcutsq + Scalar(2.0) * rsq - Scalar(3.0) * ronsq) * xplor_denom_inv;
+            Scalar ds_dr_divr = Scalar(12.0) * (rsq - ronsq) * rsq_minus_r_cut_sq * xplor_denom_inv;
+
+            // make modifications to the old pair energy and force
+            pair_eng = old_pair_eng * s;
+            // note: I'm not sure why the minus sign needs to be there: my notes have a +
+            // But this is verified correct via plotting
+            force_divr = s * old_force_divr - ds_dr_divr * old_pair_eng;
+            }
+        }
+
+    return evaluated;
+    }
+
+/*! Acquires the per type pair arrays for the duration of the fused pass
+*/
+template< class evaluator >
+void PotentialPair< evaluator >::beginFused()
+    {
+    m_fused_ronsq.reset(new ArrayHandle<Scalar>(m_ronsq, access_location::host, access_mode::read));
+    m_fused_rcutsq.reset(new ArrayHandle<Scalar>(m_rcutsq, access_location::host, access_mode::read));
+    m_fused_params.reset(new ArrayHandle<param_type>(m_params, access_location::host, access_mode::read));
+    }
+
+/*! \param i Index of the particle
+    \param typei Type of particle i
+    \param di Diameter of particle i
+    \param qi Charge of particle i
+    \param neigh Neighbors of particle i
+    \param out Output arrays and accumulators of particle i
+
+    \returns The potential energy added to local particles
+
+    Forces on i are accumulated in \a out, third law forces on j are written directly to the output arrays.
+*/
+template< class evaluator >
+double PotentialPair< evaluator >::evalFusedParticle(unsigned int i,
+                                                     unsigned int typei,
+                                                     Scalar di,
+                                                     Scalar qi,
+                                                     const FusedPairNeighbors& neigh,
+                                                     FusedPairOutput& out)
+    {
+    assert(m_fused_params && m_fused_rcutsq && m_fused_ronsq);
+    const param_type *params = m_fused_params->data;
+    const Scalar *rcutsq = m_fused_rcutsq->data;
+    const Scalar *ronsq = m_fused_ronsq->data;
+
+    double energy = 0.0;
+    for (unsigned int k = 0; k < neigh.n; k++)
+        {
+        unsigned int j = neigh.j[k];
+        Scalar3 dx = neigh.dx[k];
+        Scalar dj = evaluator::needsDiameter() ? neigh.dj[k] : Scalar(0.0);
+        Scalar qj = evaluator::needsCharge() ? neigh.qj[k] : Scalar(0.0);
+
+        Scalar force_divr = Scalar(0.0);
+        Scalar pair_eng = Scalar(0.0);
+        if (!evalPair(neigh.rsq[k], m_typpair_idx(typei, neigh.typej[k]), di, dj, qi, qj,
+                      params, rcutsq, ronsq, force_divr, pair_eng))
+            continue;
+
+        Scalar force_div2r = force_divr * Scalar(0.5);
+        out.fi += dx*force_divr;
+        out.pei += pair_eng * Scalar(0.5);
+        energy += pair_eng * Scalar(0.5);
+        if (out.compute_virial)
+            {
+            out.virial_i[0] += force_div2r*dx.x*dx.x;
+            out.virial_i[1] += force_div2r*dx.x*dx.y;
+            out.virial_i[2] += force_div2r*dx.x*dx.z;
+            out.virial_i[3] += force_div2r*dx.y*dx.y;
+            out.virial_i[4] += force_div2r*dx.y*dx.z;
+            out.virial_i[5] += force_div2r*dx.z*dx.z;
+            }
+
+        // only add force to local particles
+        if (out.third_law && j < out.N)
+            {
+            out.force[j].x -= dx.x*force_divr;
+            out.force[j].y -= dx.y*force_divr;
+            out.force[j].z -= dx.z*force_divr;
+            out.force[j].w += pair_eng * Scalar(0.5);
+            energy += pair_eng * Scalar(0.5);
+            if (out.compute_virial)
+                {
+                out.virial[0*out.virial_pitch+j] += force_div2r*dx.x*dx.x;
+                out.virial[1*out.virial_pitch+j] += force_div2r*dx.x*dx.y;
+                out.virial[2*out.virial_pitch+j] += force_div2r*dx.x*dx.z;
+                out.virial[3*out.virial_pitch+j] += force_div2r*dx.y*dx.y;
+                out.virial[4*out.virial_pitch+j] += force_div2r*dx.y*dx.z;
+                out.virial[5*out.virial_pitch+j] += force_div2r*dx.z*dx.z;
+                }
+            }
+        }
+
+    return energy;
+    }
+
+/*! Releases the arrays acquired in beginFused()
+*/
+template< class evaluator >
+void PotentialPair< evaluator >::endFused()
+    {
+    m_fused_params.reset();
+    m_fused_rcutsq.reset();
+    m_fused_ronsq.reset();
+    }
+
 #ifdef ENABLE_MPI
 /*! \param timestep Current time step
  */
@@ -109,6 +109,12 @@ class PotentialPairDPDThermo : public PotentialPair<evaluator>
         //! Set the temperature
         virtual void setT(boost::shared_ptr<Variant> T);
 
+        //! The thermostat forces cannot be evaluated in a fused pass
+        virtual bool supportsFusion() const
+            {
+            return false;
+            }
+
         #ifdef ENABLE_MPI
         //! Get ghost particle fields requested by this pair potential
         virtual CommFlags getRequestedCommFlags(unsigned int timestep);
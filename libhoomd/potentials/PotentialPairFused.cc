@@ -0,0 +1,345 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+#ifdef WIN32
+#pragma warning( push )
+#pragma warning( disable : 4103 4244 )
+#endif
+
+#include <boost/python.hpp>
+using namespace boost::python;
+
+#include "PotentialPairFused.h"
+
+#include <stdexcept>
+#include <string.h>
+
+#ifdef ENABLE_MPI
+#include "Communicator.h"
+#endif
+
+using namespace std;
+
+/*! \file PotentialPairFused.cc
+    \brief Contains code for the PotentialPairFused class
+*/
+
+//! Ends the fused pass of every potential that has begun it, also when the pass is left by an exception
+class FusedPassGuard : boost::noncopyable
+    {
+    public:
+        //! Call endFused() on all potentials begun with begin()
+        ~FusedPassGuard()
+            {
+            for (unsigned int k = 0; k < m_begun.size(); k++)
+                m_begun[k]->endFused();
+            }
+
+        //! Call beginFused() on \a potential and remember to end its pass
+        void begin(FusablePairPotential *potential)
+            {
+            potential->beginFused();
+            m_begun.push_back(potential);
+            }
+
+    private:
+        std::vector<FusablePairPotential*> m_begun;     //!< Potentials whose fused pass has begun
+    };
+
+/*! \param sysdef System to compute forces on
+    \param nlist Neighbor list shared by all fused potentials
+*/
+PotentialPairFused::PotentialPairFused(boost::shared_ptr<SystemDefinition> sysdef,
+                                       boost::shared_ptr<NeighborList> nlist)
+    : ForceCompute(sysdef), m_nlist(nlist)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing PotentialPairFused" << endl;
+
+    assert(m_nlist);
+
+    if (m_exec_conf->isCUDAEnabled())
+        {
+        m_exec_conf->msg->error() << "pair.fused: Fused pair potentials are not supported on the GPU" << endl;
+        throw runtime_error("Error initializing PotentialPairFused");
+        }
+    }
+
+PotentialPairFused::~PotentialPairFused()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying PotentialPairFused" << endl;
+    }
+
+/*! \param potential Pair potential to evaluate in the fused pass
+
+    \a potential must be a standard pair potential that uses the same neighbor list as this compute.
+*/
+void PotentialPairFused::addPotential(boost::shared_ptr<ForceCompute> potential)
+    {
+    FusablePairPotential *fusable = dynamic_cast<FusablePairPotential*>(potential.get());
+    if (!fusable || !fusable->supportsFusion())
+        {
+        m_exec_conf->msg->error() << "pair.fused: Only standard pair potentials can be fused" << endl;
+        throw runtime_error("Error adding potential to PotentialPairFused");
+        }
+
+    if (fusable->getNeighborList() != m_nlist)
+        {
+        m_exec_conf->msg->error() << "pair.fused: Fused pair potentials must share the same neighbor list" << endl;
+        throw runtime_error("Error adding potential to PotentialPairFused");
+        }
+
+    for (unsigned int k = 0; k < m_computes.size(); k++)
+        {
+        if (m_computes[k] == potential)
+            {
+            m_exec_conf->msg->error() << "pair.fused: The same pair potential cannot be fused twice" << endl;
+            throw runtime_error("Error adding potential to PotentialPairFused");
+            }
+        }
+
+    vector<string> quantities = potential->getProvidedLogQuantities();
+    m_computes.push_back(potential);
+    m_potentials.push_back(fusable);
+    m_log_names.push_back(quantities.size() > 0 ? quantities[0] : string());
+    m_energy.push_back(0.0);
+    }
+
+/*! PotentialPairFused provides the log quantities of all fused potentials
+*/
+std::vector< std::string > PotentialPairFused::getProvidedLogQuantities()
+    {
+    vector<string> list;
+    for (unsigned int k = 0; k < m_log_names.size(); k++)
+        {
+        if (m_log_names[k] != string())
+            list.push_back(m_log_names[k]);
+        }
+    return list;
+    }
+
+/*! \param quantity Name of the log value to get
+    \param timestep Current timestep of the simulation
+*/
+Scalar PotentialPairFused::getLogValue(const std::string& quantity, unsigned int timestep)
+    {
+    for (unsigned int k = 0; k < m_log_names.size(); k++)
+        {
+        if (quantity == m_log_names[k])
+            {
+            compute(timestep);
+
+            double energy = m_energy[k];
+#ifdef ENABLE_MPI
+            if (m_comm)
+                {
+                // reduce potential energy on all processors
+                MPI_Allreduce(MPI_IN_PLACE, &energy, 1, MPI_DOUBLE, MPI_SUM, m_exec_conf->getMPICommunicator());
+                }
+#endif
+            return Scalar(energy);
+            }
+        }
+
+    m_exec_conf->msg->error() << "pair.fused: " << quantity << " is not a valid log quantity" << endl;
+    throw runtime_error("Error getting log value");
+    }
+
+/*! \post The forces of all fused potentials are summed into the force and virial arrays.
+
+    \param timestep specifies the current time step of the simulation
+*/
+void PotentialPairFused::computeForces(unsigned int timestep)
+    {
+    // start by updating the neighborlist
+    m_nlist->compute(timestep);
+
+    if (m_prof) m_prof->push("Pair fused");
+
+    bool need_diameter = false;
+    bool need_charge = false;
+    for (unsigned int k = 0; k < m_potentials.size(); k++)
+        {
+        need_diameter |= m_potentials[k]->fusedNeedsDiameter();
+        need_charge |= m_potentials[k]->fusedNeedsCharge();
+        }
+
+    // access the neighbor list, particle data, and system box
+    ArrayHandle<unsigned int> h_n_neigh(m_nlist->getNNeighArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_nlist(m_nlist->getNListArray(), access_location::host, access_mode::read);
+    Index2D nli = m_nlist->getNListIndexer();
+
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
+
+    ArrayHandle<Scalar4> h_force(m_force,access_location::host, access_mode::overwrite);
+    ArrayHandle<Scalar>  h_virial(m_virial,access_location::host, access_mode::overwrite);
+
+    const BoxDim& box = m_pdata->getGlobalBox();
+
+    PDataFlags flags = m_pdata->getFlags();
+
+    // need to start from a zero force, energy and virial
+    memset((void*)h_force.data,0,sizeof(Scalar4)*m_force.getNumElements());
+    memset((void*)h_virial.data,0,sizeof(Scalar)*m_virial.getNumElements());
+
+    FusedPairOutput out;
+    out.force = h_force.data;
+    out.virial = h_virial.data;
+    out.virial_pitch = m_virial_pitch;
+    out.N = m_pdata->getN();
+    out.third_law = m_nlist->getStorageMode() == NeighborList::half;
+    out.compute_virial = flags[pdata_flag::pressure_tensor] || flags[pdata_flag::isotropic_virial];
+
+    FusedPassGuard guard;
+    for (unsigned int k = 0; k < m_potentials.size(); k++)
+        {
+        guard.begin(m_potentials[k]);
+        m_energy[k] = 0.0;
+        }
+
+    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+        {
+        // load the neighbors of particle i once for all potentials
+        Scalar3 pi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
+        unsigned int typei = __scalar_as_int(h_pos.data[i].w);
+        Scalar di = need_diameter ? h_diameter.data[i] : Scalar(0.0);
+        Scalar qi = need_charge ? h_charge.data[i] : Scalar(0.0);
+
+        const unsigned int size = h_n_neigh.data[i];
+        if (m_neigh_j.size() < size)
+            {
+            m_neigh_j.resize(size);
+            m_neigh_typej.resize(size);
+            m_neigh_dx.resize(size);
+            m_neigh_rsq.resize(size);
+            m_neigh_dj.resize(size);
+            m_neigh_qj.resize(size);
+            }
+
+        for (unsigned int k = 0; k < size; k++)
+            {
+            unsigned int j = h_nlist.data[nli(i, k)];
+            assert(j < m_pdata->getN() + m_pdata->getNGhosts());
+
+            Scalar3 pj = make_scalar3(h_pos.data[j].x, h_pos.data[j].y, h_pos.data[j].z);
+            Scalar3 dx = box.minImage(pi - pj);
+
+            m_neigh_j[k] = j;
+            m_neigh_typej[k] = __scalar_as_int(h_pos.data[j].w);
+            m_neigh_dx[k] = dx;
+            m_neigh_rsq[k] = dot(dx, dx);
+            if (need_diameter)
+                m_neigh_dj[k] = h_diameter.data[j];
+            if (need_charge)
+                m_neigh_qj[k] = h_charge.data[j];
+            }
+
+        FusedPairNeighbors neigh;
+        neigh.n = size;
+        neigh.j = size ? &m_neigh_j[0] : NULL;
+        neigh.typej = size ? &m_neigh_typej[0] : NULL;
+        neigh.dx = size ? &m_neigh_dx[0] : NULL;
+        neigh.rsq = size ? &m_neigh_rsq[0] : NULL;
+        neigh.dj = size ? &m_neigh_dj[0] : NULL;
+        neigh.qj = size ? &m_neigh_qj[0] : NULL;
+
+        out.fi = make_scalar3(0, 0, 0);
+        out.pei = Scalar(0.0);
+        for (unsigned int l = 0; l < 6; l++)
+            out.virial_i[l] = Scalar(0.0);
+
+        // evaluate every potential on the loaded neighbors
+        for (unsigned int k = 0; k < m_potentials.size(); k++)
+            m_energy[k] += m_potentials[k]->evalFusedParticle(i, typei, di, qi, neigh, out);
+
+        // finally, increment the force, potential energy and virial for particle i
+        h_force.data[i].x += out.fi.x;
+        h_force.data[i].y += out.fi.y;
+        h_force.data[i].z += out.fi.z;
+        h_force.data[i].w += out.pei;
+        if (out.compute_virial)
+            {
+            for (unsigned int l = 0; l < 6; l++)
+                h_virial.data[l*m_virial_pitch+i] += out.virial_i[l];
+            }
+        }
+
+    if (m_prof) m_prof->pop();
+    }
+
+#ifdef ENABLE_MPI
+/*! \param timestep Current time step
+ */
+CommFlags PotentialPairFused::getRequestedCommFlags(unsigned int timestep)
+    {
+    CommFlags flags = CommFlags(0);
+
+    for (unsigned int k = 0; k < m_computes.size(); k++)
+        flags |= m_computes[k]->getRequestedCommFlags(timestep);
+
+    flags |= ForceCompute::getRequestedCommFlags(timestep);
+
+    return flags;
+    }
+#endif
+
+void export_PotentialPairFused()
+    {
+    class_< PotentialPairFused, boost::shared_ptr<PotentialPairFused>, bases<ForceCompute>, boost::noncopyable >
+    ("PotentialPairFused", init< boost::shared_ptr<SystemDefinition>, boost::shared_ptr<NeighborList> >())
+    .def("addPotential", &PotentialPairFused::addPotential)
+    ;
+    }
+
+#ifdef WIN32
+#pragma warning( pop )
+#endif
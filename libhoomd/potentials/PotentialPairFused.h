@@ -0,0 +1,210 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+/*! \file PotentialPairFused.h
+    \brief Declares the PotentialPairFused class and the FusablePairPotential interface
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include "ForceCompute.h"
+#include "NeighborList.h"
+
+#include <boost/shared_ptr.hpp>
+#include <vector>
+#include <string>
+
+#ifndef __POTENTIAL_PAIR_FUSED_H__
+#define __POTENTIAL_PAIR_FUSED_H__
+
+//! Neighbors of a single particle as loaded by PotentialPairFused
+/*! All arrays have \a n elements. \a dj and \a qj are only filled out when a fused potential needs them.
+*/
+struct FusedPairNeighbors
+    {
+    unsigned int n;                 //!< Number of neighbors
+    const unsigned int *j;          //!< Index of each neighbor
+    const unsigned int *typej;      //!< Type of each neighbor
+    const Scalar3 *dx;              //!< Minimum image vector r_i - r_j
+    const Scalar *rsq;              //!< Squared length of dx
+    const Scalar *dj;               //!< Diameter of each neighbor
+    const Scalar *qj;               //!< Charge of each neighbor
+    };
+
+//! Output arrays and accumulators for particle i in a fused pair pass
+struct FusedPairOutput
+    {
+    Scalar4 *force;                 //!< Net force array (receives the third law contributions on j)
+    Scalar *virial;                 //!< Net virial array (receives the third law contributions on j)
+    unsigned int virial_pitch;      //!< Pitch of \a virial
+    unsigned int N;                 //!< Number of local particles
+    bool third_law;                 //!< True if forces should be applied to j as well
+    bool compute_virial;            //!< True if the virial is needed
+
+    Scalar3 fi;                     //!< Force on particle i
+    Scalar pei;                     //!< Potential energy of particle i
+    Scalar virial_i[6];             //!< Virial of particle i
+    };
+
+//! Interface of pair potentials that can be evaluated in a PotentialPairFused pass
+/*! PotentialPairFused walks the neighbor list once and hands the neighbors of every particle to each fused potential
+    in turn via evalFusedParticle(). beginFused() is called before the pass and endFused() after it, also when the
+    pass is left by an exception, so that the potential can hold on to its parameter arrays for the duration of the
+    pass. The potential's own force arrays are not touched, all forces are summed into the output of the
+    PotentialPairFused. Each potential reports the energy it added so that the energies can still be logged separately.
+
+    \ingroup computes
+*/
+class FusablePairPotential
+    {
+    public:
+        //! Destructor
+        virtual ~FusablePairPotential() {};
+
+        //! Test if this potential can be evaluated in a fused pass
+        virtual bool supportsFusion() const = 0;
+
+        //! Get the neighbor list the potential is evaluated over
+        virtual boost::shared_ptr<NeighborList> getNeighborList() const = 0;
+
+        //! Test if the potential needs particle diameters
+        virtual bool fusedNeedsDiameter() const = 0;
+
+        //! Test if the potential needs particle charges
+        virtual bool fusedNeedsCharge() const = 0;
+
+        //! Prepare for a fused pass
+        virtual void beginFused() = 0;
+
+        //! Evaluate all pairs of particle i
+        /*! \param i Index of the particle
+            \param typei Type of particle i
+            \param di Diameter of particle i
+            \param qi Charge of particle i
+            \param neigh Neighbors of particle i
+            \param out Output arrays and accumulators of particle i
+            \returns The potential energy added to local particles
+        */
+        virtual double evalFusedParticle(unsigned int i,
+                                         unsigned int typei,
+                                         Scalar di,
+                                         Scalar qi,
+                                         const FusedPairNeighbors& neigh,
+                                         FusedPairOutput& out) = 0;
+
+        //! Complete a fused pass
+        virtual void endFused() = 0;
+    };
+
+//! Computes several pair potentials in a single pass over a shared neighbor list
+/*! Every PotentialPair walks the entire neighbor list, loading positions, types, diameters, and charges and computing
+    the minimum image separation of every pair. When several pair potentials share the same neighbor list, all of that
+    work is repeated for each one. PotentialPairFused loads the neighbors of each particle once and then evaluates every
+    added potential on them while they are still in cache.
+
+    The forces, energies, and virials of all added potentials are summed into this compute's arrays. The added
+    potentials should not be applied by the integrator separately. Their energies are still tallied one by one and
+    PotentialPairFused provides the log quantities of all added potentials under their original names
+    (e.g. \c pair_lj_energy and \c pair_ewald_energy).
+
+    Only potentials on the CPU that use the same neighbor list as this compute can be added.
+
+    \ingroup computes
+*/
+class PotentialPairFused : public ForceCompute
+    {
+    public:
+        //! Constructs the compute
+        PotentialPairFused(boost::shared_ptr<SystemDefinition> sysdef,
+                           boost::shared_ptr<NeighborList> nlist);
+
+        //! Destructor
+        virtual ~PotentialPairFused();
+
+        //! Add a potential to the fused pass
+        void addPotential(boost::shared_ptr<ForceCompute> potential);
+
+        //! Returns a list of log quantities this compute calculates
+        virtual std::vector< std::string > getProvidedLogQuantities();
+
+        //! Calculates the requested log value and returns it
+        virtual Scalar getLogValue(const std::string& quantity, unsigned int timestep);
+
+        #ifdef ENABLE_MPI
+        //! Get ghost particle fields requested by the fused potentials
+        virtual CommFlags getRequestedCommFlags(unsigned int timestep);
+        #endif
+
+    protected:
+        //! Actually compute the forces
+        virtual void computeForces(unsigned int timestep);
+
+    private:
+        boost::shared_ptr<NeighborList> m_nlist;                        //!< The neighbor list to use for the computation
+        std::vector< boost::shared_ptr<ForceCompute> > m_computes;      //!< The fused potentials
+        std::vector< FusablePairPotential* > m_potentials;              //!< The fused potentials (interface pointers)
+        std::vector< std::string > m_log_names;                         //!< Log quantity of each fused potential
+        std::vector< double > m_energy;                                 //!< Local energy of each fused potential
+
+        std::vector< unsigned int > m_neigh_j;      //!< Neighbor indices of the current particle
+        std::vector< unsigned int > m_neigh_typej;  //!< Neighbor types of the current particle
+        std::vector< Scalar3 > m_neigh_dx;          //!< Separation vectors of the current particle
+        std::vector< Scalar > m_neigh_rsq;          //!< Squared separations of the current particle
+        std::vector< Scalar > m_neigh_dj;           //!< Neighbor diameters of the current particle
+        std::vector< Scalar > m_neigh_qj;           //!< Neighbor charges of the current particle
+    };
+
+//! Exports the PotentialPairFused class to python
+void export_PotentialPairFused();
+
+#endif
@@ -61,6 +61,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ClockSource.h"
 #include "Profiler.h"
 #include "ParticleData.h"
+#include "ParticleDataHostAccess.h"
 #include "RigidData.h"
 #include "SystemDefinition.h"
 #include "BondedGroupData.h"
@@ -68,6 +69,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Initializers.h"
 #include "HOOMDInitializer.h"
 #include "HOOMDBinaryInitializer.h"
+#include "HOOMDIndexedInitializer.h"
 #include "RandomGenerator.h"
 #include "Compute.h"
 #include "CellList.h"
@@ -95,6 +97,9 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "IMDInterface.h"
 #include "HOOMDDumpWriter.h"
 #include "HOOMDBinaryDumpWriter.h"
+#include "HOOMDIndexedDumpWriter.h"
+#include "CompressedDumpWriter.h"
+#include "CompressedTrajectoryReader.h"
 #include "PDBDumpWriter.h"
 #include "MOL2DumpWriter.h"
 #include "DCDDumpWriter.h"
@@ -117,6 +122,8 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "TwoStepBDNVTRigid.h"
 #include "TempRescaleUpdater.h"
 #include "ZeroMomentumUpdater.h"
+#include "GroupSelectUpdater.h"
+#include "NeighborListBufferTuner.h"
 #include "FIREEnergyMinimizer.h"
 #include "FIREEnergyMinimizerRigid.h"
 #include "SFCPackUpdater.h"
@@ -124,11 +131,13 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Enforce2DUpdater.h"
 #include "System.h"
 #include "Variant.h"
+#include "Schedule.h"
 #include "EAMForceCompute.h"
 #include "ConstraintSphere.h"
 #include "PotentialPairDPDThermo.h"
 #include "EvaluatorTersoff.h"
 #include "PotentialPair.h"
+#include "PotentialPairFused.h"
 #include "PotentialTersoff.h"
 #include "PPPMForceCompute.h"
 #include "AllExternalPotentials.h"
@@ -459,6 +468,7 @@ BOOST_PYTHON_MODULE(hoomd)
     // data structures
     export_BoxDim();
     export_ParticleData();
+    export_ParticleDataHostAccess();
     export_SnapshotParticleData();
     export_RigidData();
     export_SnapshotRigidData();
@@ -476,6 +486,7 @@ BOOST_PYTHON_MODULE(hoomd)
     export_SimpleCubicInitializer();
     export_HOOMDInitializer();
     export_HOOMDBinaryInitializer();
+    export_HOOMDIndexedInitializer();
     export_RandomGenerator();
 
     // computes
@@ -499,10 +510,12 @@ BOOST_PYTHON_MODULE(hoomd)
     export_PotentialPair<PotentialPairSLJ>("PotentialPairSLJ");
     export_PotentialPair<PotentialPairYukawa>("PotentialPairYukawa");
     export_PotentialPair<PotentialPairEwald>("PotentialPairEwald");
+    def("ewald_fast_erfc_error", &EvaluatorPairEwald::getFastErfcError);
     export_PotentialPair<PotentialPairMorse>("PotentialPairMorse");
     export_PotentialPair<PotentialPairDPD> ("PotentialPairDPD");
     export_PotentialPair<PotentialPairMoliere> ("PotentialPairMoliere");
     export_PotentialPair<PotentialPairZBL> ("PotentialPairZBL");
+    export_PotentialPairFused();
     export_PotentialTersoff<PotentialTripletTersoff> ("PotentialTersoff");
     export_tersoff_params();
     export_PotentialPair<PotentialPairForceShiftedLJ>("PotentialPairForceShiftedLJ");
@@ -561,6 +574,9 @@ BOOST_PYTHON_MODULE(hoomd)
     export_IMDInterface();
     export_HOOMDDumpWriter();
     export_HOOMDBinaryDumpWriter();
+    export_HOOMDIndexedDumpWriter();
+    export_CompressedDumpWriter();
+    export_CompressedTrajectoryReader();
     export_PDBDumpWriter();
     export_DCDDumpWriter();
     export_MOL2DumpWriter();
@@ -575,6 +591,8 @@ BOOST_PYTHON_MODULE(hoomd)
     export_IntegrationMethodTwoStep();
     export_TempRescaleUpdater();
     export_ZeroMomentumUpdater();
+    export_GroupSelectUpdater();
+    export_NeighborListBufferTuner();
     export_SFCPackUpdater();
     export_BoxResizeUpdater();
     export_TwoStepNVE();
@@ -622,6 +640,7 @@ BOOST_PYTHON_MODULE(hoomd)
 
     // variant
     export_Variant();
+    export_Schedule();
 
     // messenger
     export_Messenger();
@@ -0,0 +1,186 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+/*! \file AnalyzerQueue.cc
+    \brief Defines the AnalyzerQueue class
+*/
+
+#include "AnalyzerQueue.h"
+
+#include <stdexcept>
+#include <boost/bind.hpp>
+
+using namespace std;
+
+/*! \param num_threads Number of worker threads to start
+    \param max_depth Maximum number of tasks waiting to be started
+*/
+AnalyzerQueue::AnalyzerQueue(unsigned int num_threads, unsigned int max_depth)
+    : m_num_threads(num_threads), m_max_depth(max_depth), m_stop(false), m_failed(false)
+    {
+    if (m_num_threads == 0)
+        m_num_threads = 1;
+    if (m_max_depth == 0)
+        m_max_depth = 1;
+
+    for (unsigned int i = 0; i < m_num_threads; i++)
+        m_workers.create_thread(boost::bind(&AnalyzerQueue::work, this));
+    }
+
+/*! Tasks still in the queue are completed before the workers exit. Errors are not reported any more.
+*/
+AnalyzerQueue::~AnalyzerQueue()
+    {
+        {
+        boost::mutex::scoped_lock lock(m_mutex);
+        m_stop = true;
+        }
+    m_work_cond.notify_all();
+    m_workers.join_all();
+    }
+
+/*! \param key Identifies the analyzer the task belongs to
+    \param task Function to execute on a worker thread
+
+    Blocks while the queue is full.
+*/
+void AnalyzerQueue::push(const void *key, const boost::function<void ()>& task)
+    {
+    boost::mutex::scoped_lock lock(m_mutex);
+    checkError();
+
+    while (m_queue.size() >= m_max_depth)
+        {
+        m_done_cond.wait(lock);
+        checkError();
+        }
+
+    Task t;
+    t.key = key;
+    t.func = task;
+    m_queue.push_back(t);
+    m_work_cond.notify_all();
+    }
+
+/*! \post All tasks pushed so far have completed
+*/
+void AnalyzerQueue::wait()
+    {
+    boost::mutex::scoped_lock lock(m_mutex);
+    while (!m_queue.empty() || !m_running.empty())
+        m_done_cond.wait(lock);
+    checkError();
+    }
+
+void AnalyzerQueue::checkError()
+    {
+    if (m_failed)
+        {
+        m_failed = false;
+        throw runtime_error("Error in asynchronous analysis: " + m_error);
+        }
+    }
+
+void AnalyzerQueue::work()
+    {
+    boost::mutex::scoped_lock lock(m_mutex);
+    while (true)
+        {
+        // take the oldest task whose analyzer is not busy, this keeps the tasks of each analyzer in order
+        std::list<Task>::iterator task = m_queue.begin();
+        while (task != m_queue.end() && m_running.count(task->key) > 0)
+            ++task;
+
+        if (task == m_queue.end())
+            {
+            if (m_stop && m_queue.empty())
+                return;
+            m_work_cond.wait(lock);
+            continue;
+            }
+
+        const void *key = task->key;
+        boost::function<void ()> func = task->func;
+        m_queue.erase(task);
+        m_running.insert(key);
+        m_done_cond.notify_all();
+
+        lock.unlock();
+        std::string error;
+        bool failed = false;
+        try
+            {
+            func();
+            }
+        catch (std::exception& e)
+            {
+            failed = true;
+            error = e.what();
+            }
+        catch (...)
+            {
+            failed = true;
+            error = "unknown exception";
+            }
+        lock.lock();
+
+        m_running.erase(key);
+        if (failed && !m_failed)
+            {
+            m_failed = true;
+            m_error = error;
+            }
+
+        // another task of this analyzer may now be able to run
+        m_work_cond.notify_all();
+        m_done_cond.notify_all();
+        }
+    }
@@ -0,0 +1,135 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+/*! \file AnalyzerQueue.h
+    \brief Declares the AnalyzerQueue class
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#ifndef __ANALYZER_QUEUE_H__
+#define __ANALYZER_QUEUE_H__
+
+#include <list>
+#include <set>
+#include <string>
+
+#include <boost/function.hpp>
+#include <boost/thread.hpp>
+#include <boost/utility.hpp>
+
+//! Runs the deferred part of analyzer executions on worker threads
+/*! System hands the functions returned by Analyzer::prepareAnalysis() to an AnalyzerQueue when asynchronous analysis
+    is enabled. Each task is pushed with a key identifying the analyzer it belongs to. Tasks with the same key are
+    executed one at a time in the order they were pushed, tasks with different keys run concurrently on up to
+    \a num_threads workers.
+
+    At most \a max_depth tasks wait in the queue. push() blocks until a worker has taken a task when the queue is full,
+    so a slow analyzer holds the simulation back instead of buffering an unlimited number of snapshots.
+
+    An exception thrown by a task is caught on the worker and rethrown as std::runtime_error from the next call to
+    push() or wait() on the main thread.
+
+    \ingroup hoomd_lib
+*/
+class AnalyzerQueue : boost::noncopyable
+    {
+    public:
+        //! Start the worker threads
+        AnalyzerQueue(unsigned int num_threads, unsigned int max_depth);
+
+        //! Finish all tasks and stop the workers
+        ~AnalyzerQueue();
+
+        //! Add a task
+        void push(const void *key, const boost::function<void ()>& task);
+
+        //! Wait until all tasks have completed
+        void wait();
+
+        //! Get the number of worker threads
+        unsigned int getNumThreads() const
+            {
+            return m_num_threads;
+            }
+
+    private:
+        //! A task waiting in the queue
+        struct Task
+            {
+            const void *key;                //!< Key of the analyzer the task belongs to
+            boost::function<void ()> func;  //!< The work to do
+            };
+
+        unsigned int m_num_threads;         //!< Number of worker threads
+        unsigned int m_max_depth;           //!< Maximum number of tasks waiting in the queue
+
+        std::list<Task> m_queue;            //!< Tasks not yet started, in push order
+        std::set<const void*> m_running;    //!< Keys of the tasks currently executing
+        bool m_stop;                        //!< Set to true to make the workers exit
+        bool m_failed;                      //!< True if a task threw an exception that has not been reported
+        std::string m_error;                //!< Message of the exception
+
+        boost::mutex m_mutex;               //!< Protects all of the above
+        boost::condition_variable m_work_cond;  //!< Signalled when a task may have become available
+        boost::condition_variable m_done_cond;  //!< Signalled when a task is taken or completed
+        boost::thread_group m_workers;      //!< The worker threads
+
+        //! Worker thread main loop
+        void work();
+
+        //! Throw the error of a failed task, called with the lock held
+        void checkError();
+    };
+
+#endif
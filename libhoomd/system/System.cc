@@ -60,11 +60,14 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "System.h"
 #include "SignalHandler.h"
+#include "AnalyzerQueue.h"
 
 #include <boost/python.hpp>
+#include <boost/bind.hpp>
 using namespace boost::python;
 
 #include <stdexcept>
+#include <exception>
 
 #ifdef ENABLE_MPI
 #include "Communicator.h"
@@ -82,7 +85,7 @@ using namespace std;
 System::System(boost::shared_ptr<SystemDefinition> sysdef, unsigned int initial_tstep)
         : m_sysdef(sysdef), m_start_tstep(initial_tstep), m_end_tstep(0), m_cur_tstep(initial_tstep),
         m_last_status_time(0), m_last_status_tstep(initial_tstep), m_quiet_run(false),
-        m_profile(false), m_stats_period(10)
+        m_profile(false), m_hw_counters(false), m_hw_vector_fp_event(0), m_stats_period(10)
     {
     // sanity check
     assert(m_sysdef);
@@ -191,6 +194,15 @@ void System::setAnalyzerPeriodVariable(const std::string& name, boost::python::o
     }
 
 
+/*! \param name Name of the Analyzer to modify
+    \param schedule Schedule to execute the Analyzer on, counted from the current time step
+*/
+void System::setAnalyzerSchedule(const std::string& name, boost::shared_ptr<Schedule> schedule)
+    {
+    vector<System::analyzer_item>::iterator i = findAnalyzerItem(name);
+    i->setSchedule(schedule, m_cur_tstep);
+    }
+
 /*! \param name Name of the Analyzer to get the period of
     \returns Period of the Analyzer
 */
@@ -200,6 +212,42 @@ unsigned int System::getAnalyzerPeriod(const std::string& name)
     return i->m_period;
     }
 
+/*! \param num_threads Number of worker threads to run analysis tasks on (0 to analyze synchronously)
+    \param max_depth Maximum number of tasks that may wait in the queue before the time step loop blocks
+
+    Any tasks still pending on a previous queue are completed before it is replaced.
+*/
+void System::setAnalyzerThreads(unsigned int num_threads, unsigned int max_depth)
+    {
+    if (num_threads > 0 && max_depth == 0)
+        {
+        m_exec_conf->msg->error() << "System: max_depth must be at least 1" << endl;
+        throw runtime_error("Error setting analyzer threads");
+        }
+
+    if (m_analyzer_queue)
+        {
+        m_analyzer_queue->wait();
+        m_analyzer_queue = boost::shared_ptr<AnalyzerQueue>();
+        }
+
+    if (num_threads > 0)
+        {
+        m_analyzer_queue = boost::shared_ptr<AnalyzerQueue>(new AnalyzerQueue(num_threads, max_depth));
+        m_exec_conf->msg->notice(2) << "System: running analyzers on " << num_threads << " worker thread(s)" << endl;
+        }
+    }
+
+//! Run a deferred analysis task
+/*! \param analyzer Analyzer that produced the task
+    \param task Task to run
+
+    Holding \a analyzer keeps it alive until the task completes, even if it is removed from the System meanwhile.
+*/
+static void runAnalyzerTask(boost::shared_ptr<Analyzer> analyzer, boost::function<void ()> task)
+    {
+    task();
+    }
 
 // -------------- Updater get/set methods
 /*! \param name Name of the Updater to find in m_updaters
@@ -294,6 +342,15 @@ void System::setUpdaterPeriodVariable(const std::string& name, boost::python::ob
     i->setVariablePeriod(update_func, m_cur_tstep);
     }
 
+/*! \param name Name of the Updater to modify
+    \param schedule Schedule to execute the Updater on, counted from the current time step
+*/
+void System::setUpdaterSchedule(const std::string& name, boost::shared_ptr<Schedule> schedule)
+    {
+    vector<System::updater_item>::iterator i = findUpdaterItem(name);
+    i->setSchedule(schedule, m_cur_tstep);
+    }
+
 /*! \param name Name of the Updater to get the period of
     \returns Period of the Updater
 */
@@ -388,6 +445,36 @@ void System::setCommunicator(boost::shared_ptr<Communicator> comm)
 
 // -------------- Methods for running the simulation
 
+//! Prints the buffered messages of all ranks when it goes out of scope
+/*! System::run() has several exit paths. Holding one of these ensures that the messages issued during the run are
+    printed on all of them.
+*/
+class RunMessageFlusher
+    {
+    public:
+        //! Constructor
+        /*! \param msg Messenger to flush
+        */
+        RunMessageFlusher(boost::shared_ptr<Messenger> msg) : m_msg(msg)
+            {
+            }
+
+        //! Destructor
+        /*! While an exception propagates, the other ranks may never reach the collective flush. This rank's
+            messages are then printed without aggregation.
+        */
+        ~RunMessageFlusher()
+            {
+            if (std::uncaught_exception())
+                m_msg->flushLocal();
+            else
+                m_msg->collectiveFlush();
+            }
+
+    private:
+        boost::shared_ptr<Messenger> m_msg;    //!< Messenger to flush
+    };
+
 /*! \param nsteps Number of simulation steps to run
     \param limit_hours Number of hours to run for (0.0 => infinity)
     \param cb_frequency Modulus of timestep number when to call the callback (0 = at end)
@@ -462,12 +549,19 @@ void System::run(unsigned int nsteps, unsigned int cb_frequency,
         }
     #endif
 
+    // print the messages of all ranks from setting up the run, and those from the run however it ends
+    m_exec_conf->msg->collectiveFlush();
+    RunMessageFlusher flusher(m_exec_conf->msg);
+
     // catch exceptions during simulation
     try
         {
         // handle time steps
         for ( ; m_cur_tstep < m_end_tstep; m_cur_tstep++)
             {
+            if (m_trace)
+                m_trace->setTimestep(m_cur_tstep);
+
             // check the clock and output a status line if needed
             uint64_t cur_time = m_clk.getTime();
 
@@ -529,7 +623,18 @@ void System::run(unsigned int nsteps, unsigned int cb_frequency,
             for (analyzer =  m_analyzers.begin(); analyzer != m_analyzers.end(); ++analyzer)
                 {
                 if (analyzer->shouldExecute(m_cur_tstep))
-                    analyzer->m_analyzer->analyze(m_cur_tstep);
+                    {
+                    if (m_analyzer_queue)
+                        {
+                        // sample on this thread, write out on the queue
+                        boost::function<void ()> task = analyzer->m_analyzer->prepareAnalysis(m_cur_tstep);
+                        if (task)
+                            m_analyzer_queue->push(analyzer->m_analyzer.get(),
+                                                   boost::bind(runAnalyzerTask, analyzer->m_analyzer, task));
+                        }
+                    else
+                        analyzer->m_analyzer->analyze(m_cur_tstep);
+                    }
                 }
 
             // execute updaters
@@ -546,18 +651,60 @@ void System::run(unsigned int nsteps, unsigned int cb_frequency,
 
             // execute the integrator
             if (m_integrator)
+                {
+                // the end of this step may be deferred and merged into the next one if nothing looks at or
+                // modifies the particle data before the integrator runs again
+                unsigned int next_tstep = m_cur_tstep+1;
+                bool defer = next_tstep < m_end_tstep;
+                if (limit_hours != 0.0f && next_tstep % limit_multiple == 0)
+                    defer = false;
+                if (callback && (cb_frequency > 0) && (next_tstep % cb_frequency == 0))
+                    defer = false;
+                for (analyzer = m_analyzers.begin(); defer && analyzer != m_analyzers.end(); ++analyzer)
+                    defer = !analyzer->peekExecute(next_tstep);
+                for (updater = m_updaters.begin(); defer && updater != m_updaters.end(); ++updater)
+                    defer = !updater->peekExecute(next_tstep);
+
+                m_integrator->setDeferStep(defer);
                 m_integrator->update(m_cur_tstep);
+                }
 
             // quit if cntrl-C was pressed
             if (g_sigint_recvd)
                 {
                 g_sigint_recvd = 0;
+                if (m_integrator)
+                    m_integrator->finishStep();
+                if (m_analyzer_queue)
+                    m_analyzer_queue->wait();
+                if (m_trace)
+                    m_trace->flush();
                 return;
                 }
             }
+
+        // complete the last step if its end was deferred
+        if (m_integrator)
+            m_integrator->finishStep();
+
+        // complete all pending analysis
+        if (m_analyzer_queue)
+            m_analyzer_queue->wait();
         } // end try
     catch (std::exception const & ex)
         {
+        // drain the analysis queue so that no task outlives the run, the original error takes precedence
+        if (m_analyzer_queue)
+            {
+            try
+                {
+                m_analyzer_queue->wait();
+                }
+            catch (...)
+                {
+                }
+            }
+
         #ifdef ENABLE_MPI
         if (m_sysdef->getParticleData()->getDomainDecomposition() && m_exec_conf->msg->isLocked())
             {
@@ -611,9 +758,12 @@ void System::run(unsigned int nsteps, unsigned int cb_frequency,
         m_exec_conf->msg->notice(1) << "Average TPS: " << m_last_TPS << endl;
 
     // write out the profile data
-    if (m_profiler)
+    if (m_profiler && m_profile)
         m_exec_conf->msg->notice(1) << *m_profiler;
 
+    if (m_trace)
+        m_trace->flush();
+
     if (!m_quiet_run)
         printStats();
 
@@ -626,6 +776,43 @@ void System::enableProfiler(bool enable)
     m_profile = enable;
     }
 
+/*! \param filename File to write the trace to (an empty string disables tracing)
+    \param binary Set to true to write the compact binary format instead of JSON
+    \param period Record events every \a period time steps
+    \param block_size Number of events in each trace block
+
+    The trace is kept (and keeps writing to the same file) as long as the parameters do not change.
+*/
+void System::setTraceParams(const std::string& filename, bool binary, unsigned int period, unsigned int block_size)
+    {
+    ProfileTrace::traceFormat format = binary ? ProfileTrace::binary : ProfileTrace::json;
+
+    if (filename.empty())
+        {
+        m_trace = boost::shared_ptr<ProfileTrace>();
+        return;
+        }
+
+    if (m_trace && m_trace->hasParams(filename, format, period, block_size))
+        return;
+
+    // close the old file before opening a new one, the name may be the same
+    m_trace = boost::shared_ptr<ProfileTrace>();
+    m_trace = boost::shared_ptr<ProfileTrace>(new ProfileTrace(m_exec_conf, filename, format, period, block_size));
+    m_exec_conf->msg->notice(2) << "System: tracing every " << period << " steps to " << filename << endl;
+    }
+
+/*! \param enable Set to true to read hardware counters in every profiled region
+    \param vector_fp_event Raw event code for vector FP instructions (0 to not count them)
+
+    The counters are opened at the start of each profiled run, so the setting takes effect at the next run.
+*/
+void System::setHardwareCounters(bool enable, unsigned int vector_fp_event)
+    {
+    m_hw_counters = enable;
+    m_hw_vector_fp_event = vector_fp_event;
+    }
+
 /*! \param logger Logger to register computes and updaters with
     All computes and updaters registered with the system are also registerd with the logger.
 */
@@ -687,8 +874,20 @@ void System::setAutotunerParams(bool enabled, unsigned int period)
 
 void System::setupProfiling()
     {
-    if (m_profile)
+    if (m_profile || m_trace)
+        {
         m_profiler = boost::shared_ptr<Profiler>(new Profiler("Simulation"));
+        m_profiler->setTrace(m_trace);
+
+        // a trace alone should not serialize the GPU
+        m_profiler->setSync(m_profile);
+
+        if (m_profile && m_hw_counters)
+            {
+            boost::shared_ptr<HardwareCounters> hw(new HardwareCounters(m_exec_conf, m_hw_vector_fp_event));
+            m_profiler->setHardwareCounters(hw);
+            }
+        }
     else
         m_profiler = boost::shared_ptr<Profiler>();
 
@@ -822,13 +1021,16 @@ void export_System()
     .def("getAnalyzer", &System::getAnalyzer)
     .def("setAnalyzerPeriod", &System::setAnalyzerPeriod)
     .def("setAnalyzerPeriodVariable", &System::setAnalyzerPeriodVariable)
+    .def("setAnalyzerSchedule", &System::setAnalyzerSchedule)
     .def("getAnalyzerPeriod", &System::getAnalyzerPeriod)
+    .def("setAnalyzerThreads", &System::setAnalyzerThreads)
 
     .def("addUpdater", &System::addUpdater)
     .def("removeUpdater", &System::removeUpdater)
     .def("getUpdater", &System::getUpdater)
     .def("setUpdaterPeriod", &System::setUpdaterPeriod)
     .def("setUpdaterPeriodVariable", &System::setUpdaterPeriodVariable)
+    .def("setUpdaterSchedule", &System::setUpdaterSchedule)
     .def("getUpdaterPeriod", &System::getUpdaterPeriod)
 
     .def("addCompute", &System::addCompute)
@@ -842,6 +1044,8 @@ void export_System()
     .def("setStatsPeriod", &System::setStatsPeriod)
     .def("setAutotunerParams", &System::setAutotunerParams)
     .def("enableProfiler", &System::enableProfiler)
+    .def("setTraceParams", &System::setTraceParams)
+    .def("setHardwareCounters", &System::setHardwareCounters)
     .def("enableQuietRun", &System::enableQuietRun)
     .def("run", &System::run)
 
@@ -54,6 +54,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Compute.h"
 #include "Integrator.h"
 #include "Logger.h"
+#include "Schedule.h"
 
 #include <string>
 #include <vector>
@@ -64,8 +65,9 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #ifndef __SYSTEM_H__
 #define __SYSTEM_H__
 
-#ifdef ENABLE_MPI
 //! Forward declarations
+class AnalyzerQueue;
+#ifdef ENABLE_MPI
 class Communicator;
 #endif
 
@@ -96,6 +98,18 @@ class Communicator;
     Integrator::update() method is called to advance the simulation forward
     one step and the process is repeated again.
 
+    When setAnalyzerThreads() has been called with a non-zero thread count, each
+    Analyzer is instead asked for Analyzer::prepareAnalysis(). The returned task (if any)
+    is queued on an AnalyzerQueue and executed by worker threads while the time step loop
+    continues. All queued tasks are completed before run() returns.
+
+    setTraceParams() attaches a ProfileTrace to the Profiler. Runs are then profiled (the
+    table is only printed when profiling is enabled) and the trace is told the time step
+    at the start of each step. The trace is flushed at the end of each run.
+
+    setHardwareCounters() opens HardwareCounters for profiled runs, so that the profile also lists the measured
+    counts for every region.
+
     \note Adding/removing/accessing analyzers, updaters, and computes by name
     is meant to be a once per simulation operation. In other words, the accesses
     are not optimized.
@@ -127,9 +141,15 @@ class System
         //! Change the period of an Analyzer to be variable
         void setAnalyzerPeriodVariable(const std::string& name, boost::python::object update_func);
 
+        //! Change an Analyzer to execute on a native schedule
+        void setAnalyzerSchedule(const std::string& name, boost::shared_ptr<Schedule> schedule);
+
         //! Get the period of an Analyzer
         unsigned int getAnalyzerPeriod(const std::string& name);
 
+        //! Run the output stage of analyzers asynchronously on worker threads
+        void setAnalyzerThreads(unsigned int num_threads, unsigned int max_depth);
+
         // -------------- Updater get/set methods
 
         //! Adds an Updater
@@ -147,6 +167,9 @@ class System
         //! Change the period of an Updater to be variable
         void setUpdaterPeriodVariable(const std::string& name, boost::python::object update_func);
 
+        //! Change an Updater to execute on a native schedule
+        void setUpdaterSchedule(const std::string& name, boost::shared_ptr<Schedule> schedule);
+
         //! Get the period of on Updater
         unsigned int getUpdaterPeriod(const std::string& name);
 
@@ -192,6 +215,12 @@ class System
         //! Configures profiling of runs
         void enableProfiler(bool enable);
 
+        //! Configures the trace of profiled events
+        void setTraceParams(const std::string& filename, bool binary, unsigned int period, unsigned int block_size);
+
+        //! Configures the hardware counters read in profiled runs
+        void setHardwareCounters(bool enable, unsigned int vector_fp_event);
+
         //! Toggle whether or not to print the status line and TPS for each run
         void enableQuietRun(bool enable)
             {
@@ -239,7 +268,7 @@ class System
             */
             analyzer_item(boost::shared_ptr<Analyzer> analyzer, const std::string& name, unsigned int period,
                           unsigned int created_tstep)
-                    : m_analyzer(analyzer), m_name(name), m_period(period), m_created_tstep(created_tstep), m_next_execute_tstep(created_tstep), m_is_variable_period(false), m_n(1)
+                    : m_analyzer(analyzer), m_name(name), m_period(period), m_created_tstep(created_tstep), m_next_execute_tstep(created_tstep), m_is_variable_period(false), m_n(1), m_schedule_origin(0)
                 {
                 }
 
@@ -252,7 +281,11 @@ class System
                 {
                 if (tstep == m_next_execute_tstep)
                     {
-                    if (m_is_variable_period)
+                    if (m_schedule)
+                        {
+                        m_next_execute_tstep = getScheduledStep(tstep+1);
+                        }
+                    else if (m_is_variable_period)
                         {
                         boost::python::object pynext = m_update_func(m_n);
                         int next = (int)boost::python::extract<float>(pynext) + m_created_tstep;
@@ -305,6 +338,7 @@ class System
                 m_period = period;
                 m_next_execute_tstep = tstep;
                 m_is_variable_period = false;
+                m_schedule = boost::shared_ptr<Schedule>();
                 }
 
             //! Changes to a variable period
@@ -319,6 +353,34 @@ class System
                 m_update_func = update_func;
                 m_next_execute_tstep = tstep;
                 m_is_variable_period = true;
+                m_schedule = boost::shared_ptr<Schedule>();
+                }
+
+            //! Changes to a native schedule
+            /*! \param schedule Schedule to execute on
+                \param tstep current time step
+
+                The steps of the schedule are counted from \a tstep. The next step is computed each time the item
+                executes, without calling into python.
+            */
+            void setSchedule(boost::shared_ptr<Schedule> schedule, unsigned int tstep)
+                {
+                m_schedule = schedule;
+                m_schedule_origin = tstep;
+                m_is_variable_period = false;
+                m_next_execute_tstep = getScheduledStep(tstep);
+                }
+
+            //! Get the first scheduled step at or after a given step
+            /*! \param tstep Simulation step
+                \returns The absolute time step (0xffffffff if the schedule has no more steps)
+            */
+            unsigned int getScheduledStep(unsigned int tstep)
+                {
+                unsigned int next = m_schedule->getNextStep(tstep - m_schedule_origin);
+                if (next == Schedule::never || next > Schedule::never - m_schedule_origin)
+                    return Schedule::never;
+                return next + m_schedule_origin;
                 }
 
             boost::shared_ptr<Analyzer> m_analyzer; //!< The analyzer
@@ -330,6 +392,9 @@ class System
 
             unsigned int m_n;                       //!< Current value of n for the variable period func
             boost::python::object m_update_func;    //!< Python lambda function to evaluate time steps to update at
+
+            boost::shared_ptr<Schedule> m_schedule; //!< Native schedule (NULL if not used)
+            unsigned int m_schedule_origin;         //!< Time step that the schedule counts from
             };
 
         std::vector<analyzer_item> m_analyzers; //!< List of analyzers belonging to this System
@@ -345,7 +410,7 @@ class System
             */
             updater_item(boost::shared_ptr<Updater> updater, const std::string& name, unsigned int period,
                          unsigned int created_tstep)
-                    : m_updater(updater), m_name(name), m_period(period), m_created_tstep(created_tstep), m_next_execute_tstep(created_tstep), m_is_variable_period(false), m_n(1)
+                    : m_updater(updater), m_name(name), m_period(period), m_created_tstep(created_tstep), m_next_execute_tstep(created_tstep), m_is_variable_period(false), m_n(1), m_schedule_origin(0)
                 {
                 }
 
@@ -358,7 +423,11 @@ class System
                 {
                 if (tstep == m_next_execute_tstep)
                     {
-                    if (m_is_variable_period)
+                    if (m_schedule)
+                        {
+                        m_next_execute_tstep = getScheduledStep(tstep+1);
+                        }
+                    else if (m_is_variable_period)
                         {
                         boost::python::object pynext = m_update_func(m_n);
                         int next = (int)boost::python::extract<float>(pynext) + m_created_tstep;
@@ -410,6 +479,7 @@ class System
                 m_period = period;
                 m_next_execute_tstep = tstep;
                 m_is_variable_period = false;
+                m_schedule = boost::shared_ptr<Schedule>();
                 }
 
             //! Changes to a variable period
@@ -424,6 +494,34 @@ class System
                 m_update_func = update_func;
                 m_next_execute_tstep = tstep;
                 m_is_variable_period = true;
+                m_schedule = boost::shared_ptr<Schedule>();
+                }
+
+            //! Changes to a native schedule
+            /*! \param schedule Schedule to execute on
+                \param tstep current time step
+
+                The steps of the schedule are counted from \a tstep. The next step is computed each time the item
+                executes, without calling into python.
+            */
+            void setSchedule(boost::shared_ptr<Schedule> schedule, unsigned int tstep)
+                {
+                m_schedule = schedule;
+                m_schedule_origin = tstep;
+                m_is_variable_period = false;
+                m_next_execute_tstep = getScheduledStep(tstep);
+                }
+
+            //! Get the first scheduled step at or after a given step
+            /*! \param tstep Simulation step
+                \returns The absolute time step (0xffffffff if the schedule has no more steps)
+            */
+            unsigned int getScheduledStep(unsigned int tstep)
+                {
+                unsigned int next = m_schedule->getNextStep(tstep - m_schedule_origin);
+                if (next == Schedule::never || next > Schedule::never - m_schedule_origin)
+                    return Schedule::never;
+                return next + m_schedule_origin;
                 }
 
             boost::shared_ptr<Updater> m_updater;   //!< The analyzer
@@ -435,6 +533,9 @@ class System
 
             unsigned int m_n;                       //!< Current value of n for the variable period func
             boost::python::object m_update_func;    //!< Python lambda function to evaluate time steps to update at
+
+            boost::shared_ptr<Schedule> m_schedule; //!< Native schedule (NULL if not used)
+            unsigned int m_schedule_origin;         //!< Time step that the schedule counts from
             };
 
         std::vector<updater_item> m_updaters;   //!< List of updaters belonging to this System
@@ -444,6 +545,7 @@ class System
         boost::shared_ptr<Integrator> m_integrator;     //!< Integrator that advances time in this System
         boost::shared_ptr<SystemDefinition> m_sysdef;   //!< SystemDefinition for this System
         boost::shared_ptr<Profiler> m_profiler;         //!< Profiler to profile runs
+        boost::shared_ptr<ProfileTrace> m_trace;        //!< Trace of profiled events (NULL if disabled)
 
 #ifdef ENABLE_MPI
         boost::shared_ptr<Communicator> m_comm;         //!< Communicator to use
@@ -458,8 +560,12 @@ class System
 
         bool m_quiet_run;       //!< True to suppress the status line and TPS from being printed to stdout for each run
         bool m_profile;         //!< True if runs should be profiled
+        bool m_hw_counters;     //!< True if profiled runs should read hardware counters
+        unsigned int m_hw_vector_fp_event;  //!< Raw event code for vector FP instructions (0 if not counted)
         unsigned int m_stats_period; //!< Number of seconds between statistics output lines
 
+        boost::shared_ptr<AnalyzerQueue> m_analyzer_queue;  //!< Queue of asynchronous analysis tasks (NULL if disabled)
+
         // --------- Steps in the simulation run implemented in helper functions
         //! Sets up m_profiler and attaches/detaches to/from all computes, updaters, and analyzers
         void setupProfiling();
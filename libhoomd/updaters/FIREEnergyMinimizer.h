@@ -85,6 +85,11 @@ class FIREEnergyMinimizer : public IntegratorTwoStep
         //! Perform one minimization iteration
         virtual void update(unsigned int);
 
+        //! FIRE adjusts the velocities after every step, so it never leaves a step pending
+        virtual void setDeferStep(bool defer)
+            {
+            }
+
         //! Return whether or not the minimization has converged
         bool hasConverged() const {return m_converged;}
 
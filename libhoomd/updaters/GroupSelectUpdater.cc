@@ -0,0 +1,110 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+// Maintainer: joaander
+
+/*! \file GroupSelectUpdater.cc
+    \brief Defines the GroupSelectUpdater class
+*/
+
+#ifdef WIN32
+#pragma warning( push )
+#pragma warning( disable : 4103 4244 )
+#endif
+
+#include <boost/python.hpp>
+using namespace boost::python;
+
+#include "GroupSelectUpdater.h"
+
+#include <iostream>
+
+using namespace std;
+
+/*! \param sysdef System the group belongs to
+    \param group Group to update
+    \param selector Selection to re-evaluate
+*/
+GroupSelectUpdater::GroupSelectUpdater(boost::shared_ptr<SystemDefinition> sysdef,
+                                       boost::shared_ptr<ParticleGroup> group,
+                                       boost::shared_ptr<ParticleSelector> selector)
+        : Updater(sysdef), m_group(group), m_selector(selector)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing GroupSelectUpdater" << endl;
+    assert(m_group);
+    assert(m_selector);
+    }
+
+GroupSelectUpdater::~GroupSelectUpdater()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying GroupSelectUpdater" << endl;
+    }
+
+/*! \param timestep Current time step of the simulation
+*/
+void GroupSelectUpdater::update(unsigned int timestep)
+    {
+    if (m_prof) m_prof->push("Group select");
+
+    m_group->updateMemberTags(m_selector);
+
+    if (m_prof) m_prof->pop();
+    }
+
+void export_GroupSelectUpdater()
+    {
+    class_<GroupSelectUpdater, boost::shared_ptr<GroupSelectUpdater>, bases<Updater>, boost::noncopyable>
+    ("GroupSelectUpdater", init< boost::shared_ptr<SystemDefinition>,
+                                 boost::shared_ptr<ParticleGroup>,
+                                 boost::shared_ptr<ParticleSelector> >())
+    ;
+    }
+
+#ifdef WIN32
+#pragma warning( pop )
+#endif
@@ -134,6 +134,8 @@ class Communicator;
        forward for the second half step
     -# each integration method only applies these operations to the particles contained within its group (exceptions
        are allowed when box rescaling is needed)
+    -# integrateStepTwoOne(), if overridden, gives the same result as integrateStepTwo() of the previous step followed
+       by integrateStepOne() of the current one
 
     <b>Design items still left to do:</b>
 
@@ -163,6 +165,28 @@ class IntegrationMethodTwoStep : boost::noncopyable
             {
             }
 
+        //! Performs the second step of the previous time step and the first step of the current one
+        /*! \param timestep Current time step
+
+            IntegratorTwoStep calls this instead of integrateStepTwo(timestep-1) followed by integrateStepOne(timestep)
+            when nothing reads or modifies the particle data in between and all methods return true from
+            hasFusedStep(). The base class performs the two steps one after the other.
+        */
+        virtual void integrateStepTwoOne(unsigned int timestep)
+            {
+            integrateStepTwo(timestep-1);
+            integrateStepOne(timestep);
+            }
+
+        //! Test if integrateStepTwoOne() is implemented as a single pass over the group
+        /*! Derived classes that override integrateStepTwoOne() return true. Classes derived from one of those that
+            change integrateStepOne() or integrateStepTwo() must return false again.
+        */
+        virtual bool hasFusedStep()
+            {
+            return false;
+            }
+
         //! Sets the profiler for the integration method to use
         void setProfiler(boost::shared_ptr<Profiler> prof);
 
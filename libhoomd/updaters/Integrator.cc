@@ -78,7 +78,8 @@ using namespace std;
 /*! \param sysdef System to update
     \param deltaT Time step to use
 */
-Integrator::Integrator(boost::shared_ptr<SystemDefinition> sysdef, Scalar deltaT) : Updater(sysdef), m_deltaT(deltaT)
+Integrator::Integrator(boost::shared_ptr<SystemDefinition> sysdef, Scalar deltaT)
+    : Updater(sysdef), m_deltaT(deltaT), m_respa_origin(0)
     {
     if (m_deltaT <= 0.0)
         m_exec_conf->msg->warning() << "integrate.*: A timestep of less than 0.0 was specified" << endl;
@@ -101,6 +102,9 @@ void Integrator::addForceCompute(boost::shared_ptr<ForceCompute> fc)
     {
     assert(fc);
     m_forces.push_back(fc);
+    m_respa_periods.push_back(1);
+    m_respa_sums.resize(m_respa_sums.size() + 7, Scalar(0.0));
+    m_respa_sums_valid.push_back(false);
     fc->setDeltaT(m_deltaT);
     }
 
@@ -119,9 +123,52 @@ void Integrator::addForceConstraint(boost::shared_ptr<ForceConstraint> fc)
 void Integrator::removeForceComputes()
     {
     m_forces.clear();
+    m_respa_periods.clear();
+    m_respa_sums.clear();
+    m_respa_sums_valid.clear();
     m_constraint_forces.clear();
     }
 
+/*! \param fc ForceCompute previously added with addForceCompute()
+    \param period Number of time steps between evaluations of \a fc
+
+    A force with a period larger than 1 is evaluated every \a period steps, counted from m_respa_origin. Between
+    evaluations, the last computed energy and virial remain in the net arrays so that thermodynamic quantities stay
+    available, but the force itself is left out of the net force. The integrator is responsible for applying it.
+*/
+void Integrator::setRESPAPeriod(boost::shared_ptr<ForceCompute> fc, unsigned int period)
+    {
+    if (period == 0)
+        {
+        m_exec_conf->msg->error() << "integrate.*: The RESPA period must be at least 1" << endl;
+        throw runtime_error("Error setting RESPA period");
+        }
+
+    for (unsigned int i = 0; i < m_forces.size(); i++)
+        {
+        if (m_forces[i] == fc)
+            {
+            m_respa_periods[i] = period;
+            return;
+            }
+        }
+
+    m_exec_conf->msg->error() << "integrate.*: Cannot set the RESPA period of a force that was not added" << endl;
+    throw runtime_error("Error setting RESPA period");
+    }
+
+/*! \returns true if any force has a RESPA period larger than 1
+*/
+bool Integrator::hasRESPA() const
+    {
+    for (unsigned int i = 0; i < m_respa_periods.size(); i++)
+        {
+        if (m_respa_periods[i] > 1)
+            return true;
+        }
+    return false;
+    }
+
 /*! \param deltaT New time step to set
 */
 void Integrator::setDeltaT(Scalar deltaT)
@@ -342,9 +389,16 @@ Scalar Integrator::computeTotalMomentum(unsigned int timestep)
 */
 void Integrator::computeNetForce(unsigned int timestep)
     {
-    std::vector< boost::shared_ptr<ForceCompute> >::iterator force_compute;
-    for (force_compute = m_forces.begin(); force_compute != m_forces.end(); ++force_compute)
-        (*force_compute)->compute(timestep);
+    // slow forces are only evaluated on their own period, or when the particles were sorted since the last
+    // evaluation so that their energy and virial are summed into the right particles. Particles that migrated
+    // between domains do not trigger an evaluation, the slow force then contributes its last local totals instead.
+    for (unsigned int i = 0; i < m_forces.size(); i++)
+        {
+        bool sorted = m_forces[i]->getParticlesSorted();
+        bool migrated = m_forces[i]->getParticlesMigrated() && m_respa_sums_valid[i];
+        if (isRESPAStep(i, timestep) || (sorted && !migrated))
+            m_forces[i]->compute(timestep);
+        }
 
     if (m_prof)
         {
@@ -377,39 +431,73 @@ void Integrator::computeNetForce(unsigned int timestep)
         assert(6*nparticles <= net_virial.getNumElements());
         assert(nparticles <= net_torque.getNumElements());
 
-        for (force_compute = m_forces.begin(); force_compute != m_forces.end(); ++force_compute)
+        for (unsigned int i = 0; i < m_forces.size(); i++)
             {
+            boost::shared_ptr<ForceCompute> force_compute = m_forces[i];
+
             //phasing out ForceDataArrays
-            //ForceDataArrays force_arrays = (*force_compute)->acquire();
-            GPUArray<Scalar4>& h_force_array = (*force_compute)->getForceArray();
-            GPUArray<Scalar>& h_virial_array = (*force_compute)->getVirialArray();
-            GPUArray<Scalar4>& h_torque_array = (*force_compute)->getTorqueArray();
+            //ForceDataArrays force_arrays = force_compute->acquire();
+            GPUArray<Scalar4>& h_force_array = force_compute->getForceArray();
+            GPUArray<Scalar>& h_virial_array = force_compute->getVirialArray();
+            GPUArray<Scalar4>& h_torque_array = force_compute->getTorqueArray();
 
             ArrayHandle<Scalar4> h_force(h_force_array,access_location::host,access_mode::read);
             ArrayHandle<Scalar> h_virial(h_virial_array,access_location::host,access_mode::read);
             ArrayHandle<Scalar4> h_torque(h_torque_array,access_location::host,access_mode::read);
 
             unsigned int virial_pitch = h_virial_array.getPitch();
-            for (unsigned int j = 0; j < nparticles; j++)
+            if (m_respa_periods[i] == 1)
                 {
-                h_net_force.data[j].x += h_force.data[j].x;
-                h_net_force.data[j].y += h_force.data[j].y;
-                h_net_force.data[j].z += h_force.data[j].z;
-                h_net_force.data[j].w += h_force.data[j].w;
-
-                h_net_torque.data[j].x += h_torque.data[j].x;
-                h_net_torque.data[j].y += h_torque.data[j].y;
-                h_net_torque.data[j].z += h_torque.data[j].z;
-                h_net_torque.data[j].w += h_torque.data[j].w;
+                for (unsigned int j = 0; j < nparticles; j++)
+                    {
+                    h_net_force.data[j].x += h_force.data[j].x;
+                    h_net_force.data[j].y += h_force.data[j].y;
+                    h_net_force.data[j].z += h_force.data[j].z;
+                    h_net_force.data[j].w += h_force.data[j].w;
+
+                    h_net_torque.data[j].x += h_torque.data[j].x;
+                    h_net_torque.data[j].y += h_torque.data[j].y;
+                    h_net_torque.data[j].z += h_torque.data[j].z;
+                    h_net_torque.data[j].w += h_torque.data[j].w;
+
+                    for (unsigned int k = 0; k < 6; k++)
+                        {
+                        h_net_virial.data[k*net_virial_pitch+j] += h_virial.data[k*virial_pitch+j];
+                        }
+                    }
+                }
+            else if (!force_compute->getParticlesSorted())
+                {
+                // slow force: the integrator applies it as an impulse, only sum up the energy and virial and
+                // remember their local totals
+                Scalar *sums = &m_respa_sums[7*i];
+                for (unsigned int k = 0; k < 7; k++)
+                    sums[k] = Scalar(0.0);
 
-                for (unsigned int k = 0; k < 6; k++)
+                for (unsigned int j = 0; j < nparticles; j++)
                     {
-                    h_net_virial.data[k*net_virial_pitch+j] += h_virial.data[k*virial_pitch+j];
+                    h_net_force.data[j].w += h_force.data[j].w;
+                    sums[0] += h_force.data[j].w;
+                    for (unsigned int k = 0; k < 6; k++)
+                        {
+                        h_net_virial.data[k*net_virial_pitch+j] += h_virial.data[k*virial_pitch+j];
+                        sums[k+1] += h_virial.data[k*virial_pitch+j];
+                        }
                     }
+                m_respa_sums_valid[i] = true;
+                }
+            else if (nparticles > 0)
+                {
+                // the per-particle values of a slow force no longer match the local particles after a migration,
+                // add its last local totals to the first particle so that the domain sums stay correct
+                const Scalar *sums = &m_respa_sums[7*i];
+                h_net_force.data[0].w += sums[0];
+                for (unsigned int k = 0; k < 6; k++)
+                    h_net_virial.data[k*net_virial_pitch] += sums[k+1];
                 }
 
             for (unsigned int k = 0; k < 6; k++)
-                external_virial[k] += (*force_compute)->getExternalVirial(k);
+                external_virial[k] += force_compute->getExternalVirial(k);
             }
         }
 
@@ -872,11 +960,12 @@ void Integrator::setCommunicator(boost::shared_ptr<Communicator> comm)
 
 void Integrator::computeCallback(unsigned int timestep)
     {
-    // pre-compute all active forces
-    std::vector< boost::shared_ptr<ForceCompute> >::iterator force_compute;
-
-    for (force_compute = m_forces.begin(); force_compute != m_forces.end(); ++force_compute)
-        (*force_compute)->preCompute(timestep);
+    // pre-compute all active forces, skipping slow forces that are not due
+    for (unsigned int i = 0; i < m_forces.size(); i++)
+        {
+        if (isRESPAStep(i, timestep))
+            m_forces[i]->preCompute(timestep);
+        }
 
     // pre-compute all active constraint forces
     std::vector< boost::shared_ptr<ForceConstraint> >::iterator force_constraint;
@@ -892,6 +981,7 @@ void export_Integrator()
     .def("addForceCompute", &Integrator::addForceCompute)
     .def("addForceConstraint", &Integrator::addForceConstraint)
     .def("removeForceComputes", &Integrator::removeForceComputes)
+    .def("setRESPAPeriod", &Integrator::setRESPAPeriod)
     .def("setDeltaT", &Integrator::setDeltaT)
     .def("getNDOF", &Integrator::getNDOF)
     ;
@@ -98,6 +98,11 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
     accelerations are to be modified, they must be done through forces, and added to
     an Integrator via addForceCompute().
 
+    For multiple time step integration, setRESPAPeriod() marks a force as slow: it is then only evaluated every
+    \a period steps, and computeNetForce() adds only its energy and virial to the net arrays, not its force.
+    Integrators that support this (IntegratorTwoStep) apply the force as an impulse instead and set m_respa_origin,
+    the time step the periods are counted from.
+
     No such ownership is taken of the particle positions and velocities. Other Updaters
     can modify particle positions and velocities as they wish. Those updates will be taken
     into account by the Integrator. It would probably make the most sense to have such updaters
@@ -127,6 +132,9 @@ class Integrator : public Updater
         //! Removes all ForceComputes from the list
         virtual void removeForceComputes();
 
+        //! Evaluate a force only every few steps
+        virtual void setRESPAPeriod(boost::shared_ptr<ForceCompute> fc, unsigned int period);
+
         //! Change the timestep
         virtual void setDeltaT(Scalar deltaT);
 
@@ -157,6 +165,25 @@ class Integrator : public Updater
         //! Prepare for the run
         virtual void prepRun(unsigned int timestep);
 
+        //! Allow the integrator to leave the end of the next step unfinished
+        /*! \param defer Set to true when nothing reads or modifies the particle data between the next call to
+                          update() and the one after it
+
+            System sets this before every update(). An integrator that makes use of it may postpone the last part of
+            the step and merge it into the start of the following one. The base class ignores the hint.
+        */
+        virtual void setDeferStep(bool defer)
+            {
+            }
+
+        //! Complete any part of the last step that was deferred
+        /*! After this call the particle data is fully at the time step following the last update(). The base class
+            never defers anything.
+        */
+        virtual void finishStep()
+            {
+            }
+
         #ifdef ENABLE_MPI
         //! Set the communicator to use
         /*! \param comm The Communicator
@@ -170,9 +197,22 @@ class Integrator : public Updater
     protected:
         Scalar m_deltaT;                                            //!< The time step
         std::vector< boost::shared_ptr<ForceCompute> > m_forces;    //!< List of all the force computes
+        std::vector<unsigned int> m_respa_periods;                  //!< Evaluation period of each force in m_forces
+        unsigned int m_respa_origin;                                //!< Time step the RESPA periods are counted from
+        std::vector<Scalar> m_respa_sums;                           //!< Local energy and virial totals of each slow force
+        std::vector<bool> m_respa_sums_valid;                       //!< True if m_respa_sums holds the last evaluation
 
         std::vector< boost::shared_ptr<ForceConstraint> > m_constraint_forces;    //!< List of all the constraints
 
+        //! Test if any force is evaluated less often than every step
+        bool hasRESPA() const;
+
+        //! Test if the force \a i is due for evaluation on \a timestep
+        bool isRESPAStep(unsigned int i, unsigned int timestep) const
+            {
+            return m_respa_periods[i] == 1 || (timestep - m_respa_origin) % m_respa_periods[i] == 0;
+            }
+
         //! helper function to compute initial accelerations
         void computeAccelerations(unsigned int timestep);
 
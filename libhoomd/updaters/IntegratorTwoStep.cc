@@ -71,7 +71,8 @@ using namespace boost;
 #endif
 
 IntegratorTwoStep::IntegratorTwoStep(boost::shared_ptr<SystemDefinition> sysdef, Scalar deltaT)
-    : Integrator(sysdef, deltaT), m_first_step(true), m_prepared(false), m_gave_warning(false)
+    : Integrator(sysdef, deltaT), m_first_step(true), m_prepared(false), m_gave_warning(false),
+      m_defer_next(false), m_step_two_pending(false), m_pending_timestep(0)
     {
     m_exec_conf->msg->notice(5) << "Constructing IntegratorTwoStep" << endl;
     }
@@ -148,13 +149,36 @@ void IntegratorTwoStep::update(unsigned int timestep)
     // ensure that prepRun() has been called
     assert(m_prepared);
 
+    // the hint only applies to this step
+    bool defer = m_defer_next;
+    m_defer_next = false;
+
+    // a pending second step can only be merged if it belongs to the previous time step
+    if (m_step_two_pending && m_pending_timestep+1 != timestep)
+        finishStep();
+
+    // slow forces that are due at the start of this step are applied as an impulse before the fast step
+    bool respa = hasRESPA();
+    if (respa)
+        applyRESPAImpulses(timestep);
+
     if (m_prof)
         m_prof->push("Integrate");
 
-    // perform the first step of the integration on all groups
+    // perform the first step of the integration on all groups, merged with the pending second step of the
+    // previous update if there is one
     std::vector< boost::shared_ptr<IntegrationMethodTwoStep> >::iterator method;
-    for (method = m_methods.begin(); method != m_methods.end(); ++method)
-        (*method)->integrateStepOne(timestep);
+    if (m_step_two_pending)
+        {
+        for (method = m_methods.begin(); method != m_methods.end(); ++method)
+            (*method)->integrateStepTwoOne(timestep);
+        m_step_two_pending = false;
+        }
+    else
+        {
+        for (method = m_methods.begin(); method != m_methods.end(); ++method)
+            (*method)->integrateStepOne(timestep);
+        }
 
     // Update the rigid body particle positions and velocities if they are present
     if (m_sysdef->getRigidData()->getNumBodies() > 0)
@@ -173,14 +197,22 @@ void IntegratorTwoStep::update(unsigned int timestep)
         }
 #endif
 
-    // compute the net force on all particles
+    // compute the net force on all particles (the GPU summation does not separate out slow forces)
 #ifdef ENABLE_CUDA
-    if (exec_conf->exec_mode == ExecutionConfiguration::GPU)
+    if (exec_conf->exec_mode == ExecutionConfiguration::GPU && !respa)
         computeNetForceGPU(timestep+1);
     else
 #endif
         computeNetForce(timestep+1);
 
+    // leave the second step for the next update() if nothing looks at the particles before then
+    if (defer && canFuseSteps())
+        {
+        m_step_two_pending = true;
+        m_pending_timestep = timestep;
+        return;
+        }
+
     if (m_prof)
         m_prof->push("Integrate");
 
@@ -201,6 +233,142 @@ void IntegratorTwoStep::update(unsigned int timestep)
     if (flags[pdata_flag::isotropic_virial] && m_sysdef->getRigidData()->getNumBodies() > 0)
         m_sysdef->getRigidData()->computeVirialCorrectionEnd(m_deltaT/2.0);
 
+    if (m_prof)
+        m_prof->pop();
+
+    // slow forces that are due at the end of this step were evaluated with the net force, apply their impulse
+    if (respa)
+        applyRESPAImpulses(timestep+1);
+    }
+
+/*! \param timestep Time step the impulses are applied at
+
+    Every slow force that is due on \a timestep kicks the velocities of all particles integrated by the methods
+    by half of its period times deltaT. The force is brought up to date first, which only evaluates it if it has not
+    been computed on \a timestep yet or the particles have been reordered since.
+*/
+void IntegratorTwoStep::applyRESPAImpulses(unsigned int timestep)
+    {
+    for (unsigned int i = 0; i < m_forces.size(); i++)
+        {
+        unsigned int period = m_respa_periods[i];
+        if (period == 1 || !isRESPAStep(i, timestep))
+            continue;
+
+        m_forces[i]->compute(timestep);
+
+        if (m_prof)
+            {
+            m_prof->push("Integrate");
+            m_prof->push("RESPA");
+            }
+
+            {
+            ArrayHandle<Scalar4> h_force(m_forces[i]->getForceArray(), access_location::host, access_mode::read);
+            ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
+
+            Scalar dt_half = Scalar(0.5) * Scalar(period) * m_deltaT;
+
+            std::vector< boost::shared_ptr<IntegrationMethodTwoStep> >::iterator method;
+            for (method = m_methods.begin(); method != m_methods.end(); ++method)
+                {
+                boost::shared_ptr<ParticleGroup> group = (*method)->getGroup();
+                unsigned int group_size = group->getNumMembers();
+                for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+                    {
+                    unsigned int j = group->getMemberIndex(group_idx);
+                    Scalar minv = Scalar(1.0) / h_vel.data[j].w;
+                    h_vel.data[j].x += dt_half * h_force.data[j].x * minv;
+                    h_vel.data[j].y += dt_half * h_force.data[j].y * minv;
+                    h_vel.data[j].z += dt_half * h_force.data[j].z * minv;
+                    }
+                }
+            }
+
+        if (m_prof)
+            {
+            m_prof->pop();
+            m_prof->pop();
+            }
+        }
+    }
+
+/*! \param timestep Time step the run starts at
+
+    The RESPA intervals start at the first run, so that its opening kicks are applied on the first step even when
+    \a timestep is not a multiple of the periods. A later run continues the intervals of the previous run if that one
+    ended in the middle of an interval, because the opening kick has already been applied. Otherwise, the intervals
+    are aligned to the start of the new run.
+*/
+void IntegratorTwoStep::alignRESPAIntervals(unsigned int timestep)
+    {
+    // collect the slow forces of this run
+    std::vector< boost::shared_ptr<ForceCompute> > run_forces;
+    std::vector<unsigned int> run_periods;
+    for (unsigned int i = 0; i < m_forces.size(); i++)
+        {
+        if (m_respa_periods[i] > 1)
+            {
+            run_forces.push_back(m_forces[i]);
+            run_periods.push_back(m_respa_periods[i]);
+            }
+        }
+
+    // check if the previous run left an interval open
+    bool open = false;
+    if (!m_first_step)
+        {
+        for (unsigned int i = 0; i < m_respa_run_periods.size(); i++)
+            {
+            if ((timestep - m_respa_origin) % m_respa_run_periods[i] != 0)
+                open = true;
+            }
+        }
+
+    if (!open)
+        m_respa_origin = timestep;
+    else if (run_forces != m_respa_run_forces || run_periods != m_respa_run_periods)
+        {
+        m_exec_conf->msg->warning() << "integrate.mode_standard: Slow forces changed in the middle of a RESPA interval, "
+                                    << "the first impulses of this run are not exact" << endl;
+        }
+
+    m_respa_run_forces.swap(run_forces);
+    m_respa_run_periods.swap(run_periods);
+    }
+
+/*! \returns true if the second step of an update() may be merged into the first step of the next one
+*/
+bool IntegratorTwoStep::canFuseSteps()
+    {
+    if (m_methods.size() == 0 || hasRESPA() || m_sysdef->getRigidData()->getNumBodies() > 0)
+        return false;
+
+    std::vector< boost::shared_ptr<IntegrationMethodTwoStep> >::iterator method;
+    for (method = m_methods.begin(); method != m_methods.end(); ++method)
+        {
+        if (!(*method)->hasFusedStep())
+            return false;
+        }
+    return true;
+    }
+
+/*! \post The particle velocities are at the time step following the last call to update()
+*/
+void IntegratorTwoStep::finishStep()
+    {
+    if (!m_step_two_pending)
+        return;
+
+    m_step_two_pending = false;
+
+    if (m_prof)
+        m_prof->push("Integrate");
+
+    std::vector< boost::shared_ptr<IntegrationMethodTwoStep> >::iterator method;
+    for (method = m_methods.begin(); method != m_methods.end(); ++method)
+        (*method)->integrateStepTwo(m_pending_timestep);
+
     if (m_prof)
         m_prof->pop();
     }
@@ -255,6 +423,7 @@ void IntegratorTwoStep::addIntegrationMethod(boost::shared_ptr<IntegrationMethod
 */
 void IntegratorTwoStep::removeAllIntegrationMethods()
     {
+    finishStep();
     m_methods.clear();
     m_gave_warning = false;
     }
@@ -301,6 +470,16 @@ unsigned int IntegratorTwoStep::getNDOF(boost::shared_ptr<ParticleGroup> group)
 */
 void IntegratorTwoStep::prepRun(unsigned int timestep)
     {
+    finishStep();
+
+    if (hasRESPA() && m_sysdef->getRigidData()->getNumBodies() > 0)
+        {
+        m_exec_conf->msg->error() << "integrate.mode_standard: Multiple time step integration is not supported with rigid bodies" << endl;
+        throw std::runtime_error("Error preparing the integrator");
+        }
+
+    alignRESPAIntervals(timestep);
+
     // if we haven't been called before, then the net force and accelerations have not been set and we need to calculate them
     if (m_first_step)
         {
@@ -318,6 +497,11 @@ void IntegratorTwoStep::prepRun(unsigned int timestep)
             }
 #endif
 
+        // evaluate all forces, including slow ones that are not due, so the first kick and the logged
+        // quantities are valid
+        for (unsigned int i = 0; i < m_forces.size(); i++)
+            m_forces[i]->compute(timestep);
+
         // net force is always needed (ticket #393)
         computeNetForce(timestep);
 
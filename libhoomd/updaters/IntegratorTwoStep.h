@@ -76,6 +76,27 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
     To ensure that the user does not make a mistake and specify more than one method operating on a single particle,
     the particle groups are checked for intersections whenever a new method is added in addIntegrationMethod()
 
+    <b>Multiple time step integration</b>
+
+    Forces given a period larger than 1 with setRESPAPeriod() are integrated with the impulse form of r-RESPA. The
+    integration methods only see the fast forces in the net force and take their usual steps of deltaT. A slow force
+    with period k is evaluated every k steps and applied as a velocity kick of k*deltaT/2 times the force to all
+    integrated particles, once at the start and once at the end of each k step interval. The intervals are counted
+    from the start of the first run, and from the start of any later run that does not continue an open interval of
+    the previous one, so a run may start on any time step. Between kicks, the last energy and virial of a slow force
+    stay in the net arrays, so logged quantities and barostats see the full system. After particles migrate between
+    domains, its last local totals are used instead of the per-particle values until the next evaluation. Kicks only
+    change velocities, so any number of slow levels can be used, and the periods should divide each other to keep the
+    scheme time reversible. Rigid bodies are not supported with slow forces.
+
+    <b>Fused steps</b>
+
+    When System reports with setDeferStep() that nothing will look at the particles before the next update(), the
+    second step of the integration is left pending and merged with the first step of the next update() through
+    IntegrationMethodTwoStep::integrateStepTwoOne(). This saves one pass over the particle data per step. It is only
+    done when every method implements the fused pass (hasFusedStep()), there are no rigid bodies and no slow forces.
+    finishStep() completes a pending step; it is called by System at the end of every run.
+
     \ingroup updaters
 */
 class IntegratorTwoStep : public Integrator
@@ -114,6 +135,15 @@ class IntegratorTwoStep : public Integrator
         //! Prepare for the run
         virtual void prepRun(unsigned int timestep);
 
+        //! Allow the second step of the next update() to be deferred
+        virtual void setDeferStep(bool defer)
+            {
+            m_defer_next = defer;
+            }
+
+        //! Complete a deferred second step
+        virtual void finishStep();
+
         //! Get needed pdata flags
         virtual PDataFlags getRequestedPDataFlags();
 
@@ -130,12 +160,28 @@ class IntegratorTwoStep : public Integrator
         //! Helper method to test if all added methods have valid restart information
         bool isValidRestart();
 
+        //! Apply the impulses of the slow forces that are due on a time step
+        void applyRESPAImpulses(unsigned int timestep);
+
+        //! Choose the time step the RESPA intervals of a new run are counted from
+        void alignRESPAIntervals(unsigned int timestep);
+
+        //! Test if the second step can be merged with the first step of the next update()
+        bool canFuseSteps();
+
         std::vector< boost::shared_ptr<IntegrationMethodTwoStep> > m_methods;   //!< List of all the integration methods
 
+        std::vector< boost::shared_ptr<ForceCompute> > m_respa_run_forces; //!< Slow forces of the last run
+        std::vector<unsigned int> m_respa_run_periods;  //!< RESPA periods of the slow forces of the last run
+
         bool m_first_step;      //!< True before the first call to update()
         bool m_prepared;        //!< True if preprun has been called
         bool m_gave_warning;    //!< True if a warning has been given about no methods added
 
+        bool m_defer_next;              //!< True if the next update() may leave its second step pending
+        bool m_step_two_pending;        //!< True if the second step of the last update() has not been performed
+        unsigned int m_pending_timestep; //!< Time step passed to the update() whose second step is pending
+
     };
 
 //! Exports the IntegratorTwoStep class to python
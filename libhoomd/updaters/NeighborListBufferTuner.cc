@@ -0,0 +1,341 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+/*! \file NeighborListBufferTuner.cc
+    \brief Defines the NeighborListBufferTuner class
+*/
+
+#ifdef WIN32
+#pragma warning( push )
+#pragma warning( disable : 4103 4244 )
+#endif
+
+#include <boost/python.hpp>
+using namespace boost::python;
+
+#include "NeighborListBufferTuner.h"
+
+#ifdef ENABLE_MPI
+#include "HOOMDMPI.h"
+#endif
+
+#include <iostream>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+/*! \param sysdef System definition
+    \param nlist Neighbor list to tune
+    \param r_min Smallest buffer radius to try
+    \param r_max Largest buffer radius to try
+    \param dr Initial step size in the buffer radius
+*/
+NeighborListBufferTuner::NeighborListBufferTuner(boost::shared_ptr<SystemDefinition> sysdef,
+                                                 boost::shared_ptr<NeighborList> nlist,
+                                                 Scalar r_min,
+                                                 Scalar r_max,
+                                                 Scalar dr)
+        : Updater(sysdef), m_nlist(nlist), m_r_min(r_min), m_r_max(r_max), m_dr(dr), m_max_every(20),
+          m_window_valid(false), m_window_start(0), m_window_tstep(0), m_window_dangerous(0),
+          m_settling(false), m_settle_every(1), m_step(dr), m_direction(1), m_best_cost(-1.0), m_best_r_buff(0)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing NeighborListBufferTuner" << endl;
+    assert(m_nlist);
+
+    if (m_r_min <= Scalar(0.0) || m_r_max < m_r_min)
+        {
+        m_exec_conf->msg->error() << "tune.nlist_buffer: r_min must be positive and no larger than r_max" << endl;
+        throw runtime_error("Error initializing NeighborListBufferTuner");
+        }
+
+    if (m_dr <= Scalar(0.0))
+        {
+        m_exec_conf->msg->error() << "tune.nlist_buffer: dr must be positive" << endl;
+        throw runtime_error("Error initializing NeighborListBufferTuner");
+        }
+
+    m_best_r_buff = m_nlist->getRBuff();
+    }
+
+NeighborListBufferTuner::~NeighborListBufferTuner()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying NeighborListBufferTuner" << endl;
+    }
+
+/*! \param timestep Current time step of the simulation
+
+    Ends the current measurement window and acts on it.
+*/
+void NeighborListBufferTuner::update(unsigned int timestep)
+    {
+    if (!m_window_valid || timestep <= m_window_tstep)
+        {
+        startWindow(timestep);
+        return;
+        }
+
+    if (m_prof) m_prof->push("NList tune");
+
+    // wall clock cost of the window in ms per step
+    double cost = double(m_clk.getTime() - m_window_start) * 1e-6 / double(timestep - m_window_tstep);
+
+    // count the dangerous builds in the window (stats may have been reset since it started)
+    int64_t dangerous_total = m_nlist->getNumDangerousUpdates();
+    unsigned int dangerous = (unsigned int)(dangerous_total >= m_window_dangerous ?
+                                            dangerous_total - m_window_dangerous : dangerous_total);
+
+    // find the shortest rebuild period in the window
+    const std::vector<unsigned int>& periods = m_nlist->getUpdatePeriods();
+    unsigned int smallest = periods.size();
+    for (unsigned int i = 0; i < periods.size(); i++)
+        {
+        unsigned int count = periods[i];
+        if (m_window_periods.size() == periods.size() && count >= m_window_periods[i])
+            count -= m_window_periods[i];
+
+        if (count != 0)
+            {
+            smallest = i;
+            break;
+            }
+        }
+
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        {
+        // all ranks must make the same decision
+        MPI_Allreduce(MPI_IN_PLACE, &cost, 1, MPI_DOUBLE, MPI_MAX, m_exec_conf->getMPICommunicator());
+        MPI_Allreduce(MPI_IN_PLACE, &dangerous, 1, MPI_UNSIGNED, MPI_MAX, m_exec_conf->getMPICommunicator());
+        MPI_Allreduce(MPI_IN_PLACE, &smallest, 1, MPI_UNSIGNED, MPI_MIN, m_exec_conf->getMPICommunicator());
+        }
+    #endif
+
+    Scalar r_buff = m_nlist->getRBuff();
+    unsigned int every = m_nlist->getEvery();
+    bool dist_check = m_nlist->getDistCheck();
+
+    if (m_settling)
+        {
+        // the rebuild statistics at the new buffer determine a safe check period
+        m_settling = false;
+        if (dist_check && smallest < periods.size() && smallest > 1)
+            setCheckPeriod(std::min(smallest - 1, m_max_every), "shortest rebuild period");
+        else if (dist_check && smallest >= periods.size())
+            {
+            // no rebuilds to learn from, do not let a check period of 1 inflate the cost of the next window
+            setCheckPeriod(std::min(m_settle_every, m_max_every), "no rebuilds while settling");
+            }
+        }
+    else if (dangerous > 0 && dist_check)
+        {
+        // discard the measurement and back off
+        setCheckPeriod(every > 1 ? every - 1 : 1, "dangerous builds");
+        }
+    else
+        {
+        if (m_best_cost < 0.0 || cost < m_best_cost)
+            {
+            m_best_cost = cost;
+            m_best_r_buff = r_buff;
+            }
+        else if (m_step >= m_dr / Scalar(8.0))
+            {
+            // this buffer was slower: search on the other side of the best one with a smaller step
+            m_direction = -m_direction;
+            m_step /= Scalar(2.0);
+            }
+        else if (r_buff == m_best_r_buff && cost > 1.1 * m_best_cost)
+            {
+            // conditions have changed since the search converged, start over
+            m_exec_conf->msg->notice(2) << "tune.nlist_buffer: cost rose to " << cost << " ms/step, restarting search"
+                                        << endl;
+            m_step = m_dr;
+            m_best_cost = cost;
+            }
+
+        Scalar r_lo = m_r_min;
+        Scalar r_hi = std::min(m_r_max, getMaxRBuff());
+
+        Scalar r_next = m_best_r_buff;
+        if (m_step >= m_dr / Scalar(8.0))
+            {
+            r_next = std::max(r_lo, std::min(r_hi, m_best_r_buff + Scalar(m_direction) * m_step));
+
+            // turn around at the bounds
+            if (r_next == m_best_r_buff)
+                {
+                m_direction = -m_direction;
+                r_next = std::max(r_lo, std::min(r_hi, m_best_r_buff + Scalar(m_direction) * m_step));
+                }
+            }
+
+        if (r_next != r_buff)
+            setRBuff(r_next, cost);
+        }
+
+    startWindow(timestep);
+
+    if (m_prof) m_prof->pop();
+    }
+
+/*! \param timestep Time step at the start of the window
+*/
+void NeighborListBufferTuner::startWindow(unsigned int timestep)
+    {
+    m_window_valid = true;
+    m_window_tstep = timestep;
+    m_window_dangerous = m_nlist->getNumDangerousUpdates();
+    m_window_periods = m_nlist->getUpdatePeriods();
+    m_window_start = m_clk.getTime();
+    }
+
+/*! \param r_buff New buffer radius
+    \param cost Cost measured in the last window (ms per step)
+
+    The check period is reset to 1 because the old one is not safe for a smaller buffer. The old period is restored
+    after settling if the window sees no rebuilds.
+*/
+void NeighborListBufferTuner::setRBuff(Scalar r_buff, double cost)
+    {
+    m_exec_conf->msg->notice(2) << "tune.nlist_buffer: r_buff " << m_nlist->getRBuff() << " -> " << r_buff
+                                << " (" << cost << " ms/step, best " << m_best_cost << " ms/step at r_buff = "
+                                << m_best_r_buff << ")" << endl;
+
+    m_nlist->setRCut(m_nlist->getRCut(), r_buff);
+
+    if (m_nlist->getDistCheck())
+        {
+        m_settle_every = m_nlist->getEvery();
+        setCheckPeriod(1, "new r_buff");
+        }
+
+    m_settling = true;
+    }
+
+/*! \param every New check period
+    \param reason Short description of why the period changed (for the notice stream)
+*/
+void NeighborListBufferTuner::setCheckPeriod(unsigned int every, const char *reason)
+    {
+    if (every == m_nlist->getEvery())
+        return;
+
+    m_exec_conf->msg->notice(2) << "tune.nlist_buffer: check_period " << m_nlist->getEvery() << " -> " << every
+                                << " (" << reason << ")" << endl;
+    m_nlist->setEvery(every, m_nlist->getDistCheck());
+    }
+
+/*! \returns The largest buffer that keeps r_cut + r_buff + d_max - 1 below half of the box (and local box)
+*/
+Scalar NeighborListBufferTuner::getMaxRBuff()
+    {
+    Scalar3 L = m_pdata->getGlobalBox().getNearestPlaneDistance();
+    Scalar3 L_local = m_pdata->getBox().getNearestPlaneDistance();
+    Scalar l_min = std::min(std::min(L.x, L.y), std::min(L_local.x, L_local.y));
+    if (m_sysdef->getNDimensions() == 3)
+        l_min = std::min(l_min, std::min(L.z, L_local.z));
+
+    Scalar r_hi = Scalar(0.99) * Scalar(0.5) * l_min - m_nlist->getRCut() - (m_nlist->getMaximumDiameter() - Scalar(1.0));
+
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        MPI_Allreduce(MPI_IN_PLACE, &r_hi, 1, MPI_HOOMD_SCALAR, MPI_MIN, m_exec_conf->getMPICommunicator());
+    #endif
+
+    return r_hi;
+    }
+
+/*! The wall clock time between runs does not belong to any step, so the window starts over.
+*/
+void NeighborListBufferTuner::resetStats()
+    {
+    m_window_valid = false;
+    }
+
+/*! \returns The list of quantities this updater provides
+*/
+std::vector< std::string > NeighborListBufferTuner::getProvidedLogQuantities()
+    {
+    std::vector< std::string > list;
+    list.push_back("nlist_r_buff");
+    list.push_back("nlist_check_period");
+    return list;
+    }
+
+/*! \param quantity Name of the log quantity to get
+    \param timestep Current time step of the simulation
+*/
+Scalar NeighborListBufferTuner::getLogValue(const std::string& quantity, unsigned int timestep)
+    {
+    if (quantity == "nlist_r_buff")
+        return m_nlist->getRBuff();
+    else if (quantity == "nlist_check_period")
+        return Scalar(m_nlist->getEvery());
+    else
+        {
+        m_exec_conf->msg->error() << "tune.nlist_buffer: " << quantity << " is not a valid log quantity" << endl;
+        throw runtime_error("Error getting log value");
+        }
+    }
+
+void export_NeighborListBufferTuner()
+    {
+    class_<NeighborListBufferTuner, boost::shared_ptr<NeighborListBufferTuner>, bases<Updater>, boost::noncopyable>
+    ("NeighborListBufferTuner", init< boost::shared_ptr<SystemDefinition>, boost::shared_ptr<NeighborList>,
+                                      Scalar, Scalar, Scalar >())
+    .def("setMaximumCheckPeriod", &NeighborListBufferTuner::setMaximumCheckPeriod)
+    ;
+    }
+
+#ifdef WIN32
+#pragma warning( pop )
+#endif
@@ -0,0 +1,165 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+/*! \file NeighborListBufferTuner.h
+    \brief Declares an updater that tunes the neighbor list buffer during a run
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <boost/shared_ptr.hpp>
+
+#include "Updater.h"
+#include "NeighborList.h"
+#include "ClockSource.h"
+
+#include <vector>
+
+#ifndef __NEIGHBORLISTBUFFERTUNER_H__
+#define __NEIGHBORLISTBUFFERTUNER_H__
+
+//! Tunes the neighbor list buffer radius and check period while a simulation runs
+/*! A larger buffer radius makes neighbor list builds less frequent, but puts more pairs in the list for the forces
+    to evaluate. The best value depends on the temperature, density and hardware, so NeighborListBufferTuner
+    searches for it online instead of with a separate scan before the run.
+
+    Each call to update() ends a measurement window (the updater period) and starts the next one. The wall clock time
+    per step in the window is the cost being minimized. It includes the pair force evaluation and the neighbor list
+    builds, as well as everything else in the step.
+
+    The tuner alternates between two kinds of windows:
+     - After the buffer changes, the check period is set to 1 and the window collects rebuild statistics. At the end
+       of this settling window, the check period is set to one less than the shortest rebuild period seen. If there
+       were no rebuilds, the check period from before the buffer change is restored.
+     - The next window measures the cost at the new buffer. The buffer then takes a step of size \a dr from the best
+       buffer found so far. The step reverses and halves each time the cost gets worse. Once the step is smaller
+       than \a dr / 8, the buffer is held at the best value. The search restarts if the cost later rises by more
+       than 10% above the best.
+
+    Dangerous builds lower the check period by one and discard the measurement. The buffer is kept within
+    [r_min, r_max] and small enough that the neighbor list fits in the box. The check period is never set above
+    the maximum set by setMaximumCheckPeriod(). When distance checks are disabled, the check period is left alone.
+    Every change is written to the notice stream at level 2.
+
+    Under MPI, the cost is the maximum over all ranks and the rebuild statistics are reduced, so all ranks make the
+    same decisions.
+
+    \ingroup updaters
+*/
+class NeighborListBufferTuner : public Updater
+    {
+    public:
+        //! Constructor
+        NeighborListBufferTuner(boost::shared_ptr<SystemDefinition> sysdef,
+                                boost::shared_ptr<NeighborList> nlist,
+                                Scalar r_min,
+                                Scalar r_max,
+                                Scalar dr);
+        virtual ~NeighborListBufferTuner();
+
+        //! Take one timestep forward
+        virtual void update(unsigned int timestep);
+
+        //! Set the largest check period the tuner may choose
+        void setMaximumCheckPeriod(unsigned int max_every)
+            {
+            m_max_every = max_every;
+            }
+
+        //! Discard the current measurement window
+        virtual void resetStats();
+
+        //! Returns a list of log quantities this updater calculates
+        virtual std::vector< std::string > getProvidedLogQuantities();
+
+        //! Calculates the requested log value and returns it
+        virtual Scalar getLogValue(const std::string& quantity, unsigned int timestep);
+
+    private:
+        boost::shared_ptr<NeighborList> m_nlist;    //!< The neighbor list to tune
+        Scalar m_r_min;                  //!< Smallest buffer to try
+        Scalar m_r_max;                  //!< Largest buffer to try
+        Scalar m_dr;                     //!< Initial step size
+        unsigned int m_max_every;        //!< Largest check period to set
+
+        ClockSource m_clk;               //!< Wall clock for timing the windows
+        bool m_window_valid;             //!< True if a measurement window has been started
+        int64_t m_window_start;          //!< Wall clock time at the start of the window (in ns)
+        unsigned int m_window_tstep;     //!< Time step at the start of the window
+        int64_t m_window_dangerous;      //!< Count of dangerous builds at the start of the window
+        std::vector<unsigned int> m_window_periods; //!< Rebuild period histogram at the start of the window
+
+        bool m_settling;                 //!< True if the current window collects rebuild statistics
+        unsigned int m_settle_every;     //!< Check period before the current settling window
+        Scalar m_step;                   //!< Current step size
+        int m_direction;                 //!< Direction of the next step (+1 or -1)
+        double m_best_cost;              //!< Lowest cost seen so far (ms per step, negative if none)
+        Scalar m_best_r_buff;            //!< Buffer that gave the lowest cost
+
+        //! Start a new measurement window
+        void startWindow(unsigned int timestep);
+
+        //! Set a new buffer radius and start settling
+        void setRBuff(Scalar r_buff, double cost);
+
+        //! Set a new check period
+        void setCheckPeriod(unsigned int every, const char *reason);
+
+        //! Get the largest buffer that fits in the box
+        Scalar getMaxRBuff();
+    };
+
+//! Export the NeighborListBufferTuner to python
+void export_NeighborListBufferTuner();
+
+#endif
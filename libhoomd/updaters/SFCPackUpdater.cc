@@ -59,6 +59,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 
 #include <boost/python.hpp>
+#include <boost/thread.hpp>
 using namespace boost::python;
 using namespace boost;
 
@@ -67,6 +68,7 @@ using namespace boost;
 #include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <string.h>
 
 #include "SFCPackUpdater.h"
 #include "Communicator.h"
@@ -76,18 +78,19 @@ using namespace std;
 /*! \param sysdef System to perform sorts on
  */
 SFCPackUpdater::SFCPackUpdater(boost::shared_ptr<SystemDefinition> sysdef)
-        : Updater(sysdef), m_last_grid(0), m_last_dim(0)
+        : Updater(sysdef), m_last_grid(0), m_last_dim(0), m_adaptive(false), m_have_reference(false),
+          m_ref_walk_time(0.0), m_sort_time(0.0), m_last_check_step(0), m_measure_reference(false),
+          m_num_threads(0)
     {
     m_exec_conf->msg->notice(5) << "Constructing SFCPackUpdater" << endl;
 
     // perform lots of sanity checks
     assert(m_pdata);
 
-    m_sort_order.resize(m_pdata->getMaxN());
-    m_particle_bins.resize(m_pdata->getMaxN());
+    reallocate();
 
     // set the default grid
-    // Grid dimension must always be a power of 2 and determines the memory usage for m_traversal_order
+    // Grid dimension must always be a power of 2 and determines the memory usage for m_traversal_order on the GPU
     // To prevent massive overruns of the memory, always use 256 for 3d and 4096 for 2d
     if (m_sysdef->getNDimensions() == 2)
         m_grid = 4096;
@@ -103,7 +106,9 @@ SFCPackUpdater::SFCPackUpdater(boost::shared_ptr<SystemDefinition> sysdef)
 void SFCPackUpdater::reallocate()
     {
     m_sort_order.resize(m_pdata->getMaxN());
-    m_particle_bins.resize(m_pdata->getMaxN());
+    m_particle_keys.resize(m_pdata->getMaxN());
+    m_keys_tmp.resize(m_pdata->getMaxN());
+    m_order_tmp.resize(m_pdata->getMaxN());
     }
 
 /*! Destructor
@@ -121,6 +126,130 @@ SFCPackUpdater::~SFCPackUpdater()
     \param timestep Current timestep of the simulation
  */
 void SFCPackUpdater::update(unsigned int timestep)
+    {
+    if (m_adaptive && m_nlist)
+        {
+        if (!shouldSort(timestep))
+            return;
+
+        // time the sort so that the next decision can weigh it against the expected gain
+        uint64_t start_time = m_clk.getTime();
+        sortParticles();
+        m_sort_time = Scalar(double(m_clk.getTime() - start_time) / 1e6);
+
+        // the neighbor list is rebuilt on the next step, take the new reference at the next check
+        m_measure_reference = true;
+        }
+    else
+        sortParticles();
+    }
+
+/*! The particles are sorted on the very first call, and whenever the time lost in walking the neighbor list compared
+    to the reference time right after the last sort, summed over the steps since the last check, exceeds the time it
+    takes to sort.
+
+    \param timestep Current timestep of the simulation
+    \returns true if the particles should be sorted now
+*/
+bool SFCPackUpdater::shouldSort(unsigned int timestep)
+    {
+    unsigned int steps = timestep - m_last_check_step;
+    m_last_check_step = timestep;
+
+    Scalar walk_time(0.0);
+    Scalar metric(0.0);
+    int sort = 0;
+
+    // the neighbor list holds no data until it has been computed at least once
+    if (m_nlist->hasBeenUpdatedOnce())
+        {
+        metric = measureLocality(walk_time);
+
+        if (!m_have_reference && !m_measure_reference)
+            {
+            // no information yet, sort to get a reference
+            sort = 1;
+            }
+        else if (m_measure_reference)
+            {
+            m_ref_walk_time = walk_time;
+            m_have_reference = true;
+            m_measure_reference = false;
+            }
+        else
+            {
+            Scalar gain = (walk_time - m_ref_walk_time) * Scalar(steps);
+            sort = (gain > m_sort_time) ? 1 : 0;
+            }
+        }
+
+    #ifdef ENABLE_MPI
+    // sorting migrates particles, all ranks need to agree
+    if (m_pdata->getDomainDecomposition())
+        MPI_Allreduce(MPI_IN_PLACE, &sort, 1, MPI_INT, MPI_MAX, m_exec_conf->getMPICommunicator());
+    #endif
+
+    SortDecision decision;
+    decision.timestep = timestep;
+    decision.metric = metric;
+    decision.walk_time = walk_time;
+    decision.sorted = (sort != 0);
+    m_decisions.push_back(decision);
+
+    m_exec_conf->msg->notice(7) << "SFCPackUpdater: step " << timestep << " mean |i-j| = " << metric
+                                << " walk time = " << walk_time << " ms, sort = " << sort << endl;
+
+    return sort != 0;
+    }
+
+/*! \param walk_time Output: time in ms needed to walk the neighbor list
+    \returns The mean index distance |i - j| over all pairs in the neighbor list
+
+    The walk loads the position of every neighbor j, the same access pattern as the pair force computation, so its
+    run time grows with the number of cache misses as the particles unsort.
+*/
+Scalar SFCPackUpdater::measureLocality(Scalar& walk_time)
+    {
+    if (m_prof) m_prof->push(m_exec_conf, "SFCPack locality");
+
+    ArrayHandle<unsigned int> h_n_neigh(m_nlist->getNNeighArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_nlist(m_nlist->getNListArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    Index2D nli = m_nlist->getNListIndexer();
+
+    uint64_t start_time = m_clk.getTime();
+
+    double dist_sum = 0.0;
+    double rsq_sum = 0.0;
+    unsigned int n_pairs = 0;
+    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+        {
+        Scalar3 pi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
+        unsigned int size = h_n_neigh.data[i];
+        for (unsigned int k = 0; k < size; k++)
+            {
+            unsigned int j = h_nlist.data[nli(i, k)];
+            Scalar3 dx = pi - make_scalar3(h_pos.data[j].x, h_pos.data[j].y, h_pos.data[j].z);
+            rsq_sum += dot(dx, dx);
+            dist_sum += (j > i) ? double(j - i) : double(i - j);
+            }
+        n_pairs += size;
+        }
+
+    walk_time = Scalar(double(m_clk.getTime() - start_time) / 1e6);
+
+    // rsq_sum only exists so that the position loads are not optimized away
+    if (rsq_sum < 0.0)
+        walk_time = Scalar(0.0);
+
+    if (m_prof) m_prof->pop(m_exec_conf);
+
+    return (n_pairs > 0) ? Scalar(dist_sum / double(n_pairs)) : Scalar(0.0);
+    }
+
+/*! Sorts the particles along the space filling curve
+*/
+void SFCPackUpdater::sortParticles()
     {
     m_exec_conf->msg->notice(6) << "SFCPackUpdater: particle sort" << std::endl;
 
@@ -166,129 +295,124 @@ void SFCPackUpdater::update(unsigned int timestep)
 
     }
 
-void SFCPackUpdater::applySortOrder()
+void SFCPackUpdater::printStats()
     {
-    assert(m_pdata);
-    assert(m_sort_order.size() >= m_pdata->getN());
-    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
-    ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
-    ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::readwrite);
-    ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::readwrite);
-    ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::readwrite);
-    ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
-    ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::readwrite);
-    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::readwrite);
-    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::readwrite);
-
-    // construct a temporary holding array for the sorted data
-    Scalar4 *scal4_tmp = new Scalar4[m_pdata->getN()];
-
-    // sort positions and types
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal4_tmp[i] = h_pos.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_pos.data[i] = scal4_tmp[i];
-
-    // sort velocities and mass
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal4_tmp[i] = h_vel.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_vel.data[i] = scal4_tmp[i];
-
-    Scalar3 *scal3_tmp = new Scalar3[m_pdata->getN()];
-    // sort accelerations
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal3_tmp[i] = h_accel.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_accel.data[i] = scal3_tmp[i];
-
-    Scalar *scal_tmp  = new Scalar[m_pdata->getN()];
-    // sort charge
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal_tmp[i] = h_charge.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_charge.data[i] = scal_tmp[i];
-
-    // sort diameter
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal_tmp[i] = h_diameter.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_diameter.data[i] = scal_tmp[i];
-
-    // in case anyone access it from frame to frame, sort the net virial
+    if (!m_adaptive || m_decisions.size() == 0)
+        return;
+
+    // return early if the notice level is less than 1
+    if (m_exec_conf->msg->getNoticeLevel() < 1)
+        return;
+
+    unsigned int n_sorts = 0;
+    for (unsigned int i = 0; i < m_decisions.size(); i++)
+        if (m_decisions[i].sorted)
+            n_sorts++;
+
+    m_exec_conf->msg->notice(1) << "-- Adaptive sorter stats:" << endl;
+    m_exec_conf->msg->notice(1) << m_decisions.size() << " checks / " << n_sorts << " sorts" << endl;
+    m_exec_conf->msg->notice(1) << "sort time: " << m_sort_time << " ms / reference nlist walk time: "
+                                << m_ref_walk_time << " ms" << endl;
+
+    // list the most recent decisions
+    unsigned int first = (m_decisions.size() > 10) ? m_decisions.size() - 10 : 0;
+    for (unsigned int i = first; i < m_decisions.size(); i++)
         {
-        ArrayHandle<Scalar> h_net_virial(m_pdata->getNetVirial(), access_location::host, access_mode::readwrite);
-        unsigned int virial_pitch = m_pdata->getNetVirial().getPitch();
-
-        for (unsigned int j = 0; j < 6; j++)
-            {
-            for (unsigned int i = 0; i < m_pdata->getN(); i++)
-                scal_tmp[i] = h_net_virial.data[j*virial_pitch+m_sort_order[i]];
-            for (unsigned int i = 0; i < m_pdata->getN(); i++)
-                h_net_virial.data[j*virial_pitch+i] = scal_tmp[i];
-            }
+        const SortDecision& d = m_decisions[i];
+        m_exec_conf->msg->notice(2) << "step " << d.timestep << ": mean |i-j| = " << d.metric << " / walk time = "
+                                    << d.walk_time << " ms / " << (d.sorted ? "sorted" : "skipped") << endl;
         }
+    }
 
-    // sort net force, net torque, and orientation
-        {
-        ArrayHandle<Scalar4> h_net_force(m_pdata->getNetForce(), access_location::host, access_mode::readwrite);
+void SFCPackUpdater::resetStats()
+    {
+    m_decisions.clear();
+    }
 
-        for (unsigned int i = 0; i < m_pdata->getN(); i++)
-            scal4_tmp[i] = h_net_force.data[m_sort_order[i]];
-        for (unsigned int i = 0; i < m_pdata->getN(); i++)
-            h_net_force.data[i] = scal4_tmp[i];
-        }
+/*! The sort order is applied to all per-particle arrays in a single gather pass. The reordered data is written to the
+    alternate arrays of ParticleData, which are swapped in afterwards, so no temporary copies are needed.
+*/
+void SFCPackUpdater::applySortOrder()
+    {
+    assert(m_pdata);
+    assert(m_sort_order.size() >= m_pdata->getN());
 
         {
-        ArrayHandle<Scalar4> h_net_torque(m_pdata->getNetTorqueArray(), access_location::host, access_mode::readwrite);
-
-        for (unsigned int i = 0; i < m_pdata->getN(); i++)
-            scal4_tmp[i] = h_net_torque.data[m_sort_order[i]];
-        for (unsigned int i = 0; i < m_pdata->getN(); i++)
-            h_net_torque.data[i] = scal4_tmp[i];
-        }
+        // access alternate arrays to write to
+        ArrayHandle<Scalar4> h_pos_alt(m_pdata->getAltPositions(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_vel_alt(m_pdata->getAltVelocities(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar3> h_accel_alt(m_pdata->getAltAccelerations(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar> h_charge_alt(m_pdata->getAltCharges(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar> h_diameter_alt(m_pdata->getAltDiameters(), access_location::host, access_mode::overwrite);
+        ArrayHandle<int3> h_image_alt(m_pdata->getAltImages(), access_location::host, access_mode::overwrite);
+        ArrayHandle<unsigned int> h_body_alt(m_pdata->getAltBodies(), access_location::host, access_mode::overwrite);
+        ArrayHandle<unsigned int> h_tag_alt(m_pdata->getAltTags(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_orientation_alt(m_pdata->getAltOrientationArray(), access_location::host, access_mode::overwrite);
+
+        ArrayHandle<Scalar> h_net_virial_alt(m_pdata->getAltNetVirial(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_net_force_alt(m_pdata->getAltNetForce(), access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar4> h_net_torque_alt(m_pdata->getAltNetTorqueArray(), access_location::host, access_mode::overwrite);
+
+        // access live particle data to read from
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
+        ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+
+        ArrayHandle<Scalar> h_net_virial(m_pdata->getNetVirial(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_net_force(m_pdata->getNetForce(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_net_torque(m_pdata->getNetTorqueArray(), access_location::host, access_mode::read);
+
+        // access rtags
+        ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::readwrite);
 
-        {
-        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
+        unsigned int virial_pitch = m_pdata->getNetVirial().getPitch();
+        unsigned int virial_pitch_alt = m_pdata->getAltNetVirial().getPitch();
 
+        // gather all per-particle data in one sweep and rebuild the rtags on the fly
         for (unsigned int i = 0; i < m_pdata->getN(); i++)
-            scal4_tmp[i] = h_orientation.data[m_sort_order[i]];
-        for (unsigned int i = 0; i < m_pdata->getN(); i++)
-            h_orientation.data[i] = scal4_tmp[i];
-        }
-
-    // sort image
-    int3 *int3_tmp = new int3[m_pdata->getN()];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        int3_tmp[i] = h_image.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_image.data[i] = int3_tmp[i];
-
-    // sort body
-    unsigned int *uint_tmp = new unsigned int[m_pdata->getN()];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        uint_tmp[i] = h_body.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_body.data[i] = uint_tmp[i];
-
-    // sort global tag
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        uint_tmp[i] = h_tag.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_tag.data[i] = uint_tmp[i];
-
-    // rebuild global rtag
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        {
-        h_rtag.data[h_tag.data[i]] = i;
+            {
+            unsigned int old_idx = m_sort_order[i];
+
+            h_pos_alt.data[i] = h_pos.data[old_idx];
+            h_vel_alt.data[i] = h_vel.data[old_idx];
+            h_accel_alt.data[i] = h_accel.data[old_idx];
+            h_charge_alt.data[i] = h_charge.data[old_idx];
+            h_diameter_alt.data[i] = h_diameter.data[old_idx];
+            h_image_alt.data[i] = h_image.data[old_idx];
+            h_body_alt.data[i] = h_body.data[old_idx];
+            h_orientation_alt.data[i] = h_orientation.data[old_idx];
+            h_net_force_alt.data[i] = h_net_force.data[old_idx];
+            h_net_torque_alt.data[i] = h_net_torque.data[old_idx];
+
+            // in case anyone access it from frame to frame, sort the net virial
+            for (unsigned int j = 0; j < 6; j++)
+                h_net_virial_alt.data[j*virial_pitch_alt+i] = h_net_virial.data[j*virial_pitch+old_idx];
+
+            unsigned int tag = h_tag.data[old_idx];
+            h_tag_alt.data[i] = tag;
+            h_rtag.data[tag] = i;
+            }
         }
 
-    delete[] scal_tmp;
-    delete[] scal4_tmp;
-    delete[] scal3_tmp;
-    delete[] uint_tmp;
-    delete[] int3_tmp;
-
+    // make alternate arrays current
+    m_pdata->swapPositions();
+    m_pdata->swapVelocities();
+    m_pdata->swapAccelerations();
+    m_pdata->swapCharges();
+    m_pdata->swapDiameters();
+    m_pdata->swapImages();
+    m_pdata->swapBodies();
+    m_pdata->swapTags();
+    m_pdata->swapOrientations();
+    m_pdata->swapNetVirial();
+    m_pdata->swapNetForce();
+    m_pdata->swapNetTorque();
     }
 
 //! x walking table for the hilbert curve
@@ -484,6 +608,211 @@ void SFCPackUpdater::generateTraversalOrder(int i, int j, int k, int w, int Mx,
         }
     }
 
+//! Compute the position of a grid point along a hilbert curve
+/*! \param X Coordinates of the grid point (overwritten)
+    \param bits Number of bits per coordinate
+    \param n Number of dimensions (2 or 3)
+    \returns The distance of the grid point along the hilbert curve that traverses the 2^bits wide grid
+
+    The key is computed arithmetically with the transpose algorithm of J. Skilling, "Programming the Hilbert curve",
+    AIP Conf. Proc. 707, 381 (2004), so no traversal table needs to be stored.
+*/
+static inline uint64_t hilbert_key(unsigned int X[3], unsigned int bits, unsigned int n)
+    {
+    unsigned int M = 1u << (bits-1);
+
+    // inverse undo excess work
+    for (unsigned int Q = M; Q > 1; Q >>= 1)
+        {
+        unsigned int P = Q - 1;
+        for (unsigned int i = 0; i < n; i++)
+            {
+            if (X[i] & Q)
+                X[0] ^= P;
+            else
+                {
+                unsigned int t = (X[0] ^ X[i]) & P;
+                X[0] ^= t;
+                X[i] ^= t;
+                }
+            }
+        }
+
+    // gray encode
+    for (unsigned int i = 1; i < n; i++)
+        X[i] ^= X[i-1];
+    unsigned int t = 0;
+    for (unsigned int Q = M; Q > 1; Q >>= 1)
+        {
+        if (X[n-1] & Q)
+            t ^= Q - 1;
+        }
+    for (unsigned int i = 0; i < n; i++)
+        X[i] ^= t;
+
+    // interleave the transposed bits into a single key, most significant bits first
+    uint64_t key = 0;
+    for (int b = bits-1; b >= 0; b--)
+        for (unsigned int i = 0; i < n; i++)
+            key = (key << 1) | ((X[i] >> b) & 1);
+
+    return key;
+    }
+
+/*! \param max_bits Maximum number of bits per dimension that fit in the 64-bit hilbert key
+    \returns log2(m_grid), limited to \a max_bits
+*/
+unsigned int SFCPackUpdater::getGridBits(unsigned int max_bits)
+    {
+    unsigned int bits = 0;
+    while ((1u << bits) < m_grid && bits < 31)
+        bits++;
+
+    if (bits > max_bits)
+        {
+        if (m_last_grid != m_grid)
+            m_exec_conf->msg->warning() << "sorter: grid dimension " << m_grid << " is too large, using "
+                                        << (1u << max_bits) << " instead" << endl;
+        bits = max_bits;
+        }
+
+    // the hilbert curve needs at least one level of recursion
+    if (bits == 0)
+        bits = 1;
+
+    m_last_grid = m_grid;
+    return bits;
+    }
+
+/*! \param keys Keys to histogram
+    \param first First key of the range
+    \param last One past the last key of the range
+    \param shift Position of the digit in the keys
+    \param count Output: number of keys in the range with each of the 256 digit values
+*/
+static void radixHistogram(const uint64_t *keys, unsigned int first, unsigned int last, unsigned int shift,
+                           unsigned int *count)
+    {
+    memset(count, 0, sizeof(unsigned int)*256);
+    for (unsigned int i = first; i < last; i++)
+        count[(keys[i] >> shift) & 0xff]++;
+    }
+
+/*! \param keys_in Keys to scatter
+    \param order_in Particle indices belonging to \a keys_in
+    \param keys_out Output keys
+    \param order_out Output particle indices
+    \param first First key of the range
+    \param last One past the last key of the range
+    \param shift Position of the digit in the keys
+    \param offset Output offset of the next key with each of the 256 digit values, advanced as keys are written
+*/
+static void radixScatter(const uint64_t *keys_in, const unsigned int *order_in, uint64_t *keys_out,
+                         unsigned int *order_out, unsigned int first, unsigned int last, unsigned int shift,
+                         unsigned int *offset)
+    {
+    for (unsigned int i = first; i < last; i++)
+        {
+        unsigned int dst = offset[(keys_in[i] >> shift) & 0xff]++;
+        keys_out[dst] = keys_in[i];
+        order_out[dst] = order_in[i];
+        }
+    }
+
+/*! Sorts the first \a N particle indices in m_sort_order by the keys in m_particle_keys. An LSD radix sort with 8 bit
+    digits is used, which is stable and takes a number of passes that only depends on the number of significant bits.
+
+    Each pass splits the keys into one contiguous range per thread. Every thread histograms its range, the output
+    offsets are assigned by digit and then by thread, and every thread scatters its range to its own offsets. Ranges
+    of earlier threads go first within a digit, so the sort stays stable and gives the same order for any number of
+    threads.
+
+    \param N Number of keys to sort
+    \param key_bits Number of significant bits in the keys
+*/
+void SFCPackUpdater::radixSortKeys(unsigned int N, unsigned int key_bits)
+    {
+    assert(m_particle_keys.size() >= N);
+    assert(m_keys_tmp.size() >= N);
+    assert(m_order_tmp.size() >= N);
+
+    if (N == 0)
+        return;
+
+    uint64_t *keys_in = &m_particle_keys[0];
+    uint64_t *keys_out = &m_keys_tmp[0];
+    unsigned int *order_in = &m_sort_order[0];
+    unsigned int *order_out = &m_order_tmp[0];
+
+    unsigned int num_threads = m_num_threads;
+    if (num_threads == 0)
+        {
+        // below this many keys per thread, starting the threads costs more than the passes
+        num_threads = boost::thread::hardware_concurrency();
+        num_threads = std::min(num_threads, N / 65536);
+        }
+    num_threads = std::max(1u, std::min(num_threads, N));
+
+    std::vector<unsigned int> range(num_threads+1);
+    for (unsigned int t = 0; t <= num_threads; t++)
+        range[t] = (unsigned int)((unsigned long long)N * t / num_threads);
+
+    // digit counts (and then output offsets) of each thread
+    std::vector<unsigned int> count(num_threads*256);
+
+    for (unsigned int shift = 0; shift < key_bits; shift += 8)
+        {
+        // histogram the current digit
+        if (num_threads == 1)
+            radixHistogram(keys_in, 0, N, shift, &count[0]);
+        else
+            {
+            boost::thread_group threads;
+            for (unsigned int t = 0; t < num_threads; t++)
+                threads.create_thread(boost::bind(&radixHistogram, keys_in, range[t], range[t+1], shift,
+                                                  &count[t*256]));
+            threads.join_all();
+            }
+
+        // skip the pass if all particles share this digit
+        unsigned int first_digit = (keys_in[0] >> shift) & 0xff;
+        unsigned int num_first_digit = 0;
+        for (unsigned int t = 0; t < num_threads; t++)
+            num_first_digit += count[t*256 + first_digit];
+        if (num_first_digit == N)
+            continue;
+
+        // exclusive scan over the digits, and over the threads within each digit, to get the output offsets
+        unsigned int offset = 0;
+        for (unsigned int d = 0; d < 256; d++)
+            for (unsigned int t = 0; t < num_threads; t++)
+                {
+                unsigned int c = count[t*256 + d];
+                count[t*256 + d] = offset;
+                offset += c;
+                }
+
+        // scatter
+        if (num_threads == 1)
+            radixScatter(keys_in, order_in, keys_out, order_out, 0, N, shift, &count[0]);
+        else
+            {
+            boost::thread_group threads;
+            for (unsigned int t = 0; t < num_threads; t++)
+                threads.create_thread(boost::bind(&radixScatter, keys_in, order_in, keys_out, order_out, range[t],
+                                                  range[t+1], shift, &count[t*256]));
+            threads.join_all();
+            }
+
+        std::swap(keys_in, keys_out);
+        std::swap(order_in, order_out);
+        }
+
+    // make sure the result ends up in m_sort_order
+    if (order_in != &m_sort_order[0])
+        memcpy(&m_sort_order[0], order_in, sizeof(unsigned int)*N);
+    }
+
 void SFCPackUpdater::getSortedOrder2D()
     {
     // start by checking the saneness of some member variables
@@ -493,34 +822,31 @@ void SFCPackUpdater::getSortedOrder2D()
     // make even bin dimensions
     const BoxDim& box = m_pdata->getBox();
 
-    // put the particles in the bins
+    // 32 bits per dimension fit into the key, but limit it so that the bin computation below does not overflow
+    unsigned int bits = getGridBits(31);
+    unsigned int grid = 1u << bits;
+    m_last_dim = 2;
+
+    // compute the hilbert key of each particle
     {
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
 
-    // for each particle
     for (unsigned int n = 0; n < m_pdata->getN(); n++)
         {
         // find the bin each particle belongs in
         Scalar3 p = make_scalar3(h_pos.data[n].x, h_pos.data[n].y, h_pos.data[n].z);
         Scalar3 f = box.makeFraction(p,make_scalar3(0.0,0.0,0.0));
-        unsigned int ib = (unsigned int)(f.x * m_grid) % m_grid;
-        unsigned int jb = (unsigned int)(f.y * m_grid) % m_grid;
+        unsigned int X[3];
+        X[0] = (unsigned int)(f.x * grid) % grid;
+        X[1] = (unsigned int)(f.y * grid) % grid;
 
-        // record its bin
-        unsigned int bin = ib*m_grid + jb;
-
-        m_particle_bins[n] = std::pair<unsigned int, unsigned int>(bin, n);
+        m_particle_keys[n] = hilbert_key(X, bits, 2);
+        m_sort_order[n] = n;
         }
     }
 
-    // sort the tuples
-    sort(m_particle_bins.begin(), m_particle_bins.begin() + m_pdata->getN());
-
-    // translate the sorted order
-    for (unsigned int j = 0; j < m_pdata->getN(); j++)
-        {
-        m_sort_order[j] = m_particle_bins[j].second;
-        }
+    // sort the particles along the curve
+    radixSortKeys(m_pdata->getN(), 2*bits);
     }
 
 void SFCPackUpdater::getSortedOrder3D()
@@ -532,80 +858,31 @@ void SFCPackUpdater::getSortedOrder3D()
     // make even bin dimensions
     const BoxDim& box = m_pdata->getBox();
 
-    // reallocate memory arrays if m_grid changed
-    // also regenerate the traversal order
-    if (m_last_grid != m_grid || m_last_dim != 3)
-        {
-        if (m_grid > 256)
-            {
-            unsigned int mb = m_grid*m_grid*m_grid*4 / 1024 / 1024;
-            m_exec_conf->msg->warning() << "sorter is about to allocate a very large amount of memory (" << mb << "MB)"
-                 << " and may crash." << endl;
-            m_exec_conf->msg->warning() << "            Reduce the amount of memory allocated to prevent this by decreasing the " << endl;
-            m_exec_conf->msg->warning() << "            grid dimension (i.e. sorter.set_params(grid=128) ) or by disabling it " << endl;
-            m_exec_conf->msg->warning() << "            ( sorter.disable() ) before beginning the run()." << endl;
-            }
-
-        // generate the traversal order
-        GPUArray<unsigned int> traversal_order(m_grid*m_grid*m_grid,m_exec_conf);
-        m_traversal_order.swap(traversal_order);
-
-        vector< unsigned int > reverse_order(m_grid*m_grid*m_grid);
-        reverse_order.clear();
-
-        // we need to start the hilbert curve with a seed order 0,1,2,3,4,5,6,7
-        unsigned int cell_order[8];
-        for (unsigned int i = 0; i < 8; i++)
-            cell_order[i] = i;
-        generateTraversalOrder(0,0,0, m_grid, m_grid, cell_order, reverse_order);
-
-        // access traversal order
-        ArrayHandle<unsigned int> h_traversal_order(m_traversal_order, access_location::host, access_mode::overwrite);
-
-        for (unsigned int i = 0; i < m_grid*m_grid*m_grid; i++)
-            h_traversal_order.data[reverse_order[i]] = i;
+    // 21 bits per dimension fit into the 64-bit key
+    unsigned int bits = getGridBits(21);
+    unsigned int grid = 1u << bits;
+    m_last_dim = 3;
 
-        // write the traversal order out to a file for testing/presentations
-        // writeTraversalOrder("hilbert.mol2", reverse_order);
-
-        m_last_grid = m_grid;
-        // store the last system dimension computed so we can be mindful if that ever changes
-        m_last_dim = m_sysdef->getNDimensions();
-        }
-
-    // sanity checks
-    assert(m_particle_bins.size() >= m_pdata->getN());
-    assert(m_traversal_order.getNumElements() == m_grid*m_grid*m_grid);
-
-    // put the particles in the bins
+    // compute the hilbert key of each particle
+    {
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
 
-    // access traversal order
-    ArrayHandle<unsigned int> h_traversal_order(m_traversal_order, access_location::host, access_mode::read);
-
-    // for each particle
     for (unsigned int n = 0; n < m_pdata->getN(); n++)
         {
         Scalar3 p = make_scalar3(h_pos.data[n].x, h_pos.data[n].y, h_pos.data[n].z);
         Scalar3 f = box.makeFraction(p,make_scalar3(0.0,0.0,0.0));
-        unsigned int ib = (unsigned int)(f.x * m_grid) % m_grid;
-        unsigned int jb = (unsigned int)(f.y * m_grid) % m_grid;
-        unsigned int kb = (unsigned int)(f.z * m_grid) % m_grid;
+        unsigned int X[3];
+        X[0] = (unsigned int)(f.x * grid) % grid;
+        X[1] = (unsigned int)(f.y * grid) % grid;
+        X[2] = (unsigned int)(f.z * grid) % grid;
 
-        // record its bin
-        unsigned int bin = ib*(m_grid*m_grid) + jb * m_grid + kb;
-
-        m_particle_bins[n] = std::pair<unsigned int, unsigned int>(h_traversal_order.data[bin], n);
+        m_particle_keys[n] = hilbert_key(X, bits, 3);
+        m_sort_order[n] = n;
         }
+    }
 
-    // sort the tuples
-    sort(m_particle_bins.begin(), m_particle_bins.begin() + m_pdata->getN());
-
-    // translate the sorted order
-    for (unsigned int j = 0; j < m_pdata->getN(); j++)
-        {
-        m_sort_order[j] = m_particle_bins[j].second;
-        }
+    // sort the particles along the curve
+    radixSortKeys(m_pdata->getN(), 3*bits);
     }
 
 void SFCPackUpdater::writeTraversalOrder(const std::string& fname, const vector< unsigned int >& reverse_order)
@@ -643,6 +920,9 @@ void export_SFCPackUpdater()
     class_<SFCPackUpdater, boost::shared_ptr<SFCPackUpdater>, bases<Updater>, boost::noncopyable>
     ("SFCPackUpdater", init< boost::shared_ptr<SystemDefinition> >())
     .def("setGrid", &SFCPackUpdater::setGrid)
+    .def("setNeighborList", &SFCPackUpdater::setNeighborList)
+    .def("setAdaptive", &SFCPackUpdater::setAdaptive)
+    .def("setNumThreads", &SFCPackUpdater::setNumThreads)
     ;
     }
 
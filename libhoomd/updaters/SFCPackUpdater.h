@@ -66,10 +66,12 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <boost/signals2.hpp>
 #include <vector>
 #include <utility>
+#include <stdint.h>
 
 #include "Updater.h"
 #include "NeighborList.h"
 #include "GPUVector.h"
+#include "ClockSource.h"
 
 #ifndef __SFCPACK_UPDATER_H__
 #define __SFCPACK_UPDATER_H__
@@ -92,8 +94,19 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
     Implementation details:<br>
     The rearranging is done by computing bins for the particles, and then ordering the particles based on the order in
-    which those bins appear along a hilbert curve. It is very efficient, even when the box size changes often as the
-    grid dimension is kept constant.
+    which those bins appear along a hilbert curve. The position of each bin along the curve is computed arithmetically
+    from the bin coordinates, so neither the time nor the memory needed for a sort depends on the grid dimension. The
+    particles are ordered with an LSD radix sort on the hilbert keys, and the new order is applied to all per-particle
+    arrays in a single gather pass into the alternate arrays of ParticleData, which are then swapped in. The histogram
+    and scatter passes of the radix sort are split over several threads (see setNumThreads()).
+
+    Adaptive sorting:<br>
+    When a NeighborList is attached with setNeighborList() and adaptive sorting is enabled with setAdaptive(), update()
+    no longer sorts unconditionally. Instead, it walks the neighbor list, measures the mean memory distance |i - j|
+    between neighbors and times the walk as a proxy for the cache misses in the pair force computation. The time of the
+    walk measured right after a sort is the reference. The particles are only sorted when the additional time per step
+    compared to that reference, accumulated over the steps since the last check, exceeds the measured cost of a sort.
+    Every decision is recorded and summarized in printStats().
 
     \ingroup updaters
 */
@@ -118,11 +131,42 @@ class SFCPackUpdater : public Updater
             m_grid = (unsigned int)pow(2.0, ceil(log(double(grid)) / log(2.0)));;
             }
 
+        //! Set the neighbor list used to measure the locality of the particle data
+        /*! \param nlist Neighbor list to walk when deciding whether to sort
+        */
+        void setNeighborList(boost::shared_ptr<NeighborList> nlist)
+            {
+            m_nlist = nlist;
+            }
+
+        //! Enable or disable adaptive sorting
+        /*! \param adaptive Set to true to only sort when the expected speedup exceeds the cost of the sort
+        */
+        void setAdaptive(bool adaptive)
+            {
+            m_adaptive = adaptive;
+            m_have_reference = false;
+            }
+
+        //! Set the number of threads to split the radix sort over
+        /*! \param num_threads Number of threads, 0 uses all cores (and at most one thread per 65536 particles)
+        */
+        void setNumThreads(unsigned int num_threads)
+            {
+            m_num_threads = num_threads;
+            }
+
+        //! Print statistics on the adaptive sort decisions
+        virtual void printStats();
+
+        //! Clear the recorded sort decisions
+        virtual void resetStats();
+
     protected:
         unsigned int m_grid;        //!< Grid dimension to use
         unsigned int m_last_grid;   //!< The last value of MMax
         unsigned int m_last_dim;    //!< Check the last dimension we ran at
-        GPUArray< unsigned int > m_traversal_order;      //!< Generated traversal order of bins
+        GPUArray< unsigned int > m_traversal_order;      //!< Generated traversal order of bins (GPU implementation only)
 
         boost::signals2::connection m_max_particle_num_change_connection; //!< Connection to the maximum particle number change signal of particle data
         //! Helper function that actually performs the sort
@@ -133,6 +177,41 @@ class SFCPackUpdater : public Updater
         //! Apply the sorted order to the particle data
         virtual void applySortOrder();
 
+        //! Record of one adaptive sort decision
+        struct SortDecision
+            {
+            unsigned int timestep;  //!< Timestep at which the decision was made
+            Scalar metric;          //!< Mean |i - j| of the neighbor list at that time
+            Scalar walk_time;       //!< Time to walk the neighbor list (ms)
+            bool sorted;            //!< True if the particles were sorted
+            };
+
+        boost::shared_ptr<NeighborList> m_nlist;    //!< Neighbor list used to measure locality (may be null)
+        bool m_adaptive;                            //!< True if adaptive sorting is enabled
+        bool m_have_reference;                      //!< True if m_ref_walk_time is valid
+        Scalar m_ref_walk_time;                     //!< Time to walk the neighbor list right after a sort (ms)
+        Scalar m_sort_time;                         //!< Time of the last sort (ms)
+        unsigned int m_last_check_step;             //!< Timestep of the last adaptive check
+        bool m_measure_reference;                   //!< True if the next check should set the reference
+        ClockSource m_clk;                          //!< Timer for the adaptive decisions
+        std::vector<SortDecision> m_decisions;      //!< History of adaptive sort decisions
+        unsigned int m_num_threads;                 //!< Number of threads to use in radixSortKeys()
+
+        //! Decide whether the particles need to be sorted
+        bool shouldSort(unsigned int timestep);
+
+        //! Measure the locality of the particle data by walking the neighbor list
+        Scalar measureLocality(Scalar& walk_time);
+
+        //! Perform the sort
+        void sortParticles();
+
+        //! Sort the particles by their hilbert keys
+        void radixSortKeys(unsigned int N, unsigned int key_bits);
+
+        //! Compute the number of bits per dimension needed to index m_grid bins
+        unsigned int getGridBits(unsigned int max_bits);
+
         //! Helper function to generate traversal order
         static void generateTraversalOrder(int i, int j, int k, int w, int Mx, unsigned int cell_order[8], vector< unsigned int > &traversal_order);
 
@@ -144,7 +223,9 @@ class SFCPackUpdater : public Updater
 
     private:
         std::vector<unsigned int> m_sort_order;             //!< Generated sort order of the particles
-        std::vector< std::pair<unsigned int, unsigned int> > m_particle_bins;    //!< Binned particles
+        std::vector<uint64_t> m_particle_keys;              //!< Hilbert curve key of each particle
+        std::vector<uint64_t> m_keys_tmp;                   //!< Scratch space for the radix sort (keys)
+        std::vector<unsigned int> m_order_tmp;              //!< Scratch space for the radix sort (indices)
 
    };
 
@@ -59,6 +59,9 @@ using namespace boost::python;
 
 #include "TwoStepBDNVT.h"
 
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+
 #ifdef ENABLE_MPI
 #include "HOOMDMPI.h"
 #endif
@@ -81,7 +84,8 @@ TwoStepBDNVT::TwoStepBDNVT(boost::shared_ptr<SystemDefinition> sysdef,
                            unsigned int seed,
                            bool gamma_diam,
                            const std::string& suffix)
-    : TwoStepNVE(sysdef, group, true), m_T(T), m_seed(seed), m_gamma_diam(gamma_diam), m_reservoir_energy(0),  m_extra_energy_overdeltaT(0), m_tally(false)
+    : TwoStepNVE(sysdef, group, true), m_T(T), m_seed(seed), m_gamma_diam(gamma_diam), m_reservoir_energy(0),  m_extra_energy_overdeltaT(0), m_tally(false),
+      m_num_threads(1)
     {
     m_exec_conf->msg->notice(5) << "Constructing TwoStepBDNVT" << endl;
 
@@ -169,113 +173,160 @@ Scalar TwoStepBDNVT::getLogValue(const std::string& quantity, unsigned int times
 */
 void TwoStepBDNVT::integrateStepTwo(unsigned int timestep)
     {
-#ifdef ENABLE_MPI
-    unsigned int group_size = m_group->getNumMembers();
-#else
     unsigned int group_size = m_group->getNumMembers();
-#endif
     if (group_size == 0)
         return;
 
     const GPUArray< Scalar4 >& net_force = m_pdata->getNetForce();
 
-
     // profile this step
     if (m_prof)
         m_prof->push("NVE step 2");
 
+    // the member indices are read directly, getMemberIndex() can't be called while the tags are accessed
+    ArrayHandle<unsigned int> h_index(m_group->getIndexArray(), access_location::host, access_mode::read);
+
     ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::readwrite);
 
     ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
 
     ArrayHandle<Scalar4> h_net_force(net_force, access_location::host, access_mode::read);
     ArrayHandle<Scalar> h_gamma(m_gamma, access_location::host, access_mode::read);
 
-    // grab some initial variables
-    const Scalar currentTemp = m_T->getValue(timestep);
-    const Scalar D = Scalar(m_sysdef->getNDimensions());
+    StepTwoArgs args;
+    args.index = h_index.data;
+    args.vel = h_vel.data;
+    args.accel = h_accel.data;
+    args.diameter = h_diameter.data;
+    args.pos = h_pos.data;
+    args.tag = h_tag.data;
+    args.net_force = h_net_force.data;
+    args.gamma = h_gamma.data;
+    args.T = m_T->getValue(timestep);
+    args.timestep = timestep;
+
+    unsigned int num_threads = m_num_threads;
+    if (num_threads == 0)
+        num_threads = boost::thread::hardware_concurrency();
+    if (num_threads == 0)
+        num_threads = 1;
+    num_threads = std::min(num_threads, group_size);
+
+    // energy transferred over this time step, summed per thread
+    std::vector<Scalar> bd_energy_transfer(num_threads, Scalar(0.0));
+
+    if (num_threads == 1)
+        integrateStepTwoRange(args, 0, group_size, &bd_energy_transfer[0]);
+    else
+        {
+        boost::thread_group threads;
+        for (unsigned int i = 0; i < num_threads; i++)
+            {
+            unsigned int first = (unsigned int)((unsigned long long)group_size * i / num_threads);
+            unsigned int last = (unsigned int)((unsigned long long)group_size * (i+1) / num_threads);
+            threads.create_thread(boost::bind(&TwoStepBDNVT::integrateStepTwoRange, this, boost::cref(args),
+                                              first, last, &bd_energy_transfer[i]));
+            }
+        threads.join_all();
+        }
+
+    // update energy reservoir
+    if (m_tally)
+        {
+        Scalar total_transfer = Scalar(0.0);
+        for (unsigned int i = 0; i < num_threads; i++)
+            total_transfer += bd_energy_transfer[i];
+
+        #ifdef ENABLE_MPI
+        if (m_comm)
+            {
+            MPI_Allreduce(MPI_IN_PLACE, &total_transfer, 1, MPI_HOOMD_SCALAR, MPI_SUM, m_exec_conf->getMPICommunicator());
+            }
+        #endif
+        m_reservoir_energy -= total_transfer*m_deltaT;
+        m_extra_energy_overdeltaT = 0.5*total_transfer;
+        }
 
-    // initialize the RNG
-    Saru saru(m_seed, timestep);
+    // done profiling
+    if (m_prof)
+        m_prof->pop();
+    }
 
-    // energy transferred over this time step
+/*! \param args Particle data and parameters for this step
+    \param first First group index to integrate
+    \param last One past the last group index to integrate
+    \param energy Output: energy transferred from the reservoir to the particles in the range, divided by deltaT
+
+    Every particle draws its random numbers from Saru(tag, timestep + seed), so any split of the group into ranges
+    gives the same velocities.
+*/
+void TwoStepBDNVT::integrateStepTwoRange(const StepTwoArgs& args, unsigned int first, unsigned int last, Scalar *energy)
+    {
+    const Scalar D = Scalar(m_sysdef->getNDimensions());
     Scalar bd_energy_transfer = 0;
 
     // a(t+deltaT) gets modified with the bd forces
     // v(t+deltaT) = v(t+deltaT/2) + 1/2 * a(t+deltaT)*deltaT
-    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+    for (unsigned int group_idx = first; group_idx < last; group_idx++)
         {
-        unsigned int j = m_group->getMemberIndex(group_idx);
+        unsigned int j = args.index[group_idx];
 
         // first, calculate the BD forces
-        // Generate three random numbers
+        // Generate three random numbers from the stream of this particle
+        Saru saru(args.tag[j], args.timestep + m_seed);
         Scalar rx = saru.d(-1,1);
         Scalar ry = saru.d(-1,1);
-        Scalar rz =  saru.d(-1,1);
+        Scalar rz = saru.d(-1,1);
 
         Scalar gamma;
         if (m_gamma_diam)
-            gamma = h_diameter.data[j];
+            gamma = args.diameter[j];
         else
             {
-            unsigned int type = __scalar_as_int(h_pos.data[j].w);
-            gamma = h_gamma.data[type];
+            unsigned int type = __scalar_as_int(args.pos[j].w);
+            gamma = args.gamma[type];
             }
 
         // compute the bd force
-        Scalar coeff = sqrt(Scalar(6.0) *gamma*currentTemp/m_deltaT);
-        Scalar bd_fx = rx*coeff - gamma*h_vel.data[j].x;
-        Scalar bd_fy = ry*coeff - gamma*h_vel.data[j].y;
-        Scalar bd_fz = rz*coeff - gamma*h_vel.data[j].z;
+        Scalar coeff = sqrt(Scalar(6.0) *gamma*args.T/m_deltaT);
+        Scalar bd_fx = rx*coeff - gamma*args.vel[j].x;
+        Scalar bd_fy = ry*coeff - gamma*args.vel[j].y;
+        Scalar bd_fz = rz*coeff - gamma*args.vel[j].z;
 
         if (D < 3.0)
             bd_fz = Scalar(0.0);
 
         // then, calculate acceleration from the net force
-        Scalar minv = Scalar(1.0) / h_vel.data[j].w;
-        h_accel.data[j].x = (h_net_force.data[j].x + bd_fx)*minv;
-        h_accel.data[j].y = (h_net_force.data[j].y + bd_fy)*minv;
-        h_accel.data[j].z = (h_net_force.data[j].z + bd_fz)*minv;
+        Scalar minv = Scalar(1.0) / args.vel[j].w;
+        args.accel[j].x = (args.net_force[j].x + bd_fx)*minv;
+        args.accel[j].y = (args.net_force[j].y + bd_fy)*minv;
+        args.accel[j].z = (args.net_force[j].z + bd_fz)*minv;
 
         // then, update the velocity
-        h_vel.data[j].x += Scalar(1.0/2.0)*h_accel.data[j].x*m_deltaT;
-        h_vel.data[j].y += Scalar(1.0/2.0)*h_accel.data[j].y*m_deltaT;
-        h_vel.data[j].z += Scalar(1.0/2.0)*h_accel.data[j].z*m_deltaT;
+        args.vel[j].x += Scalar(1.0/2.0)*args.accel[j].x*m_deltaT;
+        args.vel[j].y += Scalar(1.0/2.0)*args.accel[j].y*m_deltaT;
+        args.vel[j].z += Scalar(1.0/2.0)*args.accel[j].z*m_deltaT;
 
         // tally the energy transfer from the bd thermal reservor to the particles
-        if (m_tally) bd_energy_transfer += bd_fx * h_vel.data[j].x + bd_fy * h_vel.data[j].y + bd_fz * h_vel.data[j].z;
+        if (m_tally) bd_energy_transfer += bd_fx * args.vel[j].x + bd_fy * args.vel[j].y + bd_fz * args.vel[j].z;
 
         // limit the movement of the particles
         if (m_limit)
             {
-            Scalar vel = sqrt(h_vel.data[j].x*h_vel.data[j].x + h_vel.data[j].y*h_vel.data[j].y + h_vel.data[j].z*h_vel.data[j].z );
+            Scalar vel = sqrt(args.vel[j].x*args.vel[j].x + args.vel[j].y*args.vel[j].y + args.vel[j].z*args.vel[j].z );
             if ( (vel*m_deltaT) > m_limit_val)
                 {
-                h_vel.data[j].x = h_vel.data[j].x / vel * m_limit_val / m_deltaT;
-                h_vel.data[j].y = h_vel.data[j].y / vel * m_limit_val / m_deltaT;
-                h_vel.data[j].z = h_vel.data[j].z / vel * m_limit_val / m_deltaT;
+                args.vel[j].x = args.vel[j].x / vel * m_limit_val / m_deltaT;
+                args.vel[j].y = args.vel[j].y / vel * m_limit_val / m_deltaT;
+                args.vel[j].z = args.vel[j].z / vel * m_limit_val / m_deltaT;
                 }
             }
         }
 
-    // update energy reservoir
-    if (m_tally) {
-        #ifdef ENABLE_MPI
-        if (m_comm)
-            {
-            MPI_Allreduce(MPI_IN_PLACE, &bd_energy_transfer, 1, MPI_HOOMD_SCALAR, MPI_SUM, m_exec_conf->getMPICommunicator());
-            }
-        #endif
-        m_reservoir_energy -= bd_energy_transfer*m_deltaT;
-        m_extra_energy_overdeltaT = 0.5*bd_energy_transfer;
-
-       }
-
-    // done profiling
-    if (m_prof)
-        m_prof->pop();
+    *energy = bd_energy_transfer;
     }
 
 void export_TwoStepBDNVT()
@@ -291,6 +342,7 @@ void export_TwoStepBDNVT()
         .def("setT", &TwoStepBDNVT::setT)
         .def("setGamma", &TwoStepBDNVT::setGamma)
         .def("setTally", &TwoStepBDNVT::setTally)
+        .def("setNumThreads", &TwoStepBDNVT::setNumThreads)
         ;
     }
 
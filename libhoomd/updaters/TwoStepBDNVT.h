@@ -73,6 +73,11 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
     additions needed are a random number generator and some storage for gamma and temperature settings. The NVE
     integration is modified by overrideing integrateStepTwo() to add in the needed bd forces.
 
+    The random force on each particle is drawn from its own Saru stream keyed on the particle tag and the time step
+    plus the seed, the same streams TwoStepBDNVTGPU uses. The noise therefore does not depend on the order the
+    particles are stored in, on the domain decomposition or on the number of threads. setNumThreads() splits the group
+    over several threads.
+
     \ingroup updaters
 */
 class TwoStepBDNVT : public TwoStepNVE
@@ -97,6 +102,13 @@ class TwoStepBDNVT : public TwoStepNVE
         //! Sets gamma for a given particle type
         void setGamma(unsigned int typ, Scalar gamma);
 
+        //! Set the number of threads to split the group over
+        /*! \param num_threads Number of threads, 0 uses all cores */
+        void setNumThreads(unsigned int num_threads)
+            {
+            m_num_threads = num_threads;
+            }
+
         //! Turn on or off Tally
         /*! \param tally if true, tallies energy exchange from bd thermal reservoir */
         void setTally(bool tally)
@@ -113,6 +125,12 @@ class TwoStepBDNVT : public TwoStepNVE
         //! Performs the second step of the integration
         virtual void integrateStepTwo(unsigned int timestep);
 
+        //! The stochastic force is applied in integrateStepTwo(), which the fused NVE pass skips
+        virtual bool hasFusedStep()
+            {
+            return false;
+            }
+
     protected:
         boost::shared_ptr<Variant> m_T;   //!< The Temperature of the Stochastic Bath
         unsigned int m_seed;              //!< The seed for the RNG of the Stochastic Bath
@@ -123,6 +141,25 @@ class TwoStepBDNVT : public TwoStepNVE
         std::string m_log_name;           //!< Name of the reservior quantity that we log
 
         GPUArray<Scalar> m_gamma;         //!< List of per type gammas to use
+        unsigned int m_num_threads;       //!< Number of threads to use in integrateStepTwo()
+
+        //! Data shared by all threads in integrateStepTwo()
+        struct StepTwoArgs
+            {
+            const unsigned int *index;      //!< Particle indices of the group members
+            Scalar4 *vel;                   //!< Particle velocities
+            Scalar3 *accel;                 //!< Particle accelerations
+            const Scalar *diameter;         //!< Particle diameters
+            const Scalar4 *pos;             //!< Particle positions and types
+            const unsigned int *tag;        //!< Particle tags
+            const Scalar4 *net_force;       //!< Net force on the particles
+            const Scalar *gamma;            //!< Per type gammas
+            Scalar T;                       //!< Current temperature
+            unsigned int timestep;          //!< Current time step
+            };
+
+        //! Performs the second step on a range of group members
+        void integrateStepTwoRange(const StepTwoArgs& args, unsigned int first, unsigned int last, Scalar *energy);
     };
 
 //! Exports the TwoStepBDNVT class to python
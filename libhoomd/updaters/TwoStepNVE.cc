@@ -244,6 +244,98 @@ void TwoStepNVE::integrateStepTwo(unsigned int timestep)
         m_prof->pop();
     }
 
+/*! \param timestep Current time step
+    \post Particle velocities are moved forward to \a timestep (completing the previous step), then positions are
+          moved forward to timestep+1 and velocities to timestep+1/2.
+
+    The result is identical to calling integrateStepTwo(timestep-1) followed by integrateStepOne(timestep), but the
+    particle data is only streamed through once.
+*/
+void TwoStepNVE::integrateStepTwoOne(unsigned int timestep)
+    {
+    unsigned int group_size = m_group->getNumMembers();
+    if (group_size == 0)
+        return;
+
+    const GPUArray< Scalar4 >& net_force = m_pdata->getNetForce();
+
+    // profile this step
+    if (m_prof)
+        m_prof->push("NVE step 2+1");
+
+    ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_net_force(net_force, access_location::host, access_mode::read);
+
+    const BoxDim& box = m_pdata->getBox();
+
+    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+        {
+        unsigned int j = m_group->getMemberIndex(group_idx);
+
+        // second half step of the previous time step: v(t) = v(t-deltaT/2) + 1/2 * a(t)*deltaT
+        if (m_zero_force)
+            {
+            h_accel.data[j].x = h_accel.data[j].y = h_accel.data[j].z = 0.0;
+            }
+        else
+            {
+            Scalar minv = Scalar(1.0) / h_vel.data[j].w;
+            h_accel.data[j].x = h_net_force.data[j].x*minv;
+            h_accel.data[j].y = h_net_force.data[j].y*minv;
+            h_accel.data[j].z = h_net_force.data[j].z*minv;
+            }
+
+        h_vel.data[j].x += Scalar(1.0/2.0)*h_accel.data[j].x*m_deltaT;
+        h_vel.data[j].y += Scalar(1.0/2.0)*h_accel.data[j].y*m_deltaT;
+        h_vel.data[j].z += Scalar(1.0/2.0)*h_accel.data[j].z*m_deltaT;
+
+        if (m_limit)
+            {
+            Scalar vel = sqrt(h_vel.data[j].x*h_vel.data[j].x+h_vel.data[j].y*h_vel.data[j].y+h_vel.data[j].z*h_vel.data[j].z);
+            if ( (vel*m_deltaT) > m_limit_val)
+                {
+                h_vel.data[j].x = h_vel.data[j].x / vel * m_limit_val / m_deltaT;
+                h_vel.data[j].y = h_vel.data[j].y / vel * m_limit_val / m_deltaT;
+                h_vel.data[j].z = h_vel.data[j].z / vel * m_limit_val / m_deltaT;
+                }
+            }
+
+        // first half step of this time step: r(t+deltaT) = r(t) + v(t)*deltaT + (1/2)a(t)*deltaT^2
+        Scalar dx = h_vel.data[j].x*m_deltaT + Scalar(1.0/2.0)*h_accel.data[j].x*m_deltaT*m_deltaT;
+        Scalar dy = h_vel.data[j].y*m_deltaT + Scalar(1.0/2.0)*h_accel.data[j].y*m_deltaT*m_deltaT;
+        Scalar dz = h_vel.data[j].z*m_deltaT + Scalar(1.0/2.0)*h_accel.data[j].z*m_deltaT*m_deltaT;
+
+        if (m_limit)
+            {
+            Scalar len = sqrt(dx*dx + dy*dy + dz*dz);
+            if (len > m_limit_val)
+                {
+                dx = dx / len * m_limit_val;
+                dy = dy / len * m_limit_val;
+                dz = dz / len * m_limit_val;
+                }
+            }
+
+        h_pos.data[j].x += dx;
+        h_pos.data[j].y += dy;
+        h_pos.data[j].z += dz;
+
+        // v(t+deltaT/2) = v(t) + (1/2)a*deltaT
+        h_vel.data[j].x += Scalar(1.0/2.0)*h_accel.data[j].x*m_deltaT;
+        h_vel.data[j].y += Scalar(1.0/2.0)*h_accel.data[j].y*m_deltaT;
+        h_vel.data[j].z += Scalar(1.0/2.0)*h_accel.data[j].z*m_deltaT;
+
+        box.wrap(h_pos.data[j], h_image.data[j]);
+        }
+
+    // done profiling
+    if (m_prof)
+        m_prof->pop();
+    }
+
 void export_TwoStepNVE()
     {
     class_<TwoStepNVE, boost::shared_ptr<TwoStepNVE>, bases<IntegrationMethodTwoStep>, boost::noncopyable>
@@ -97,6 +97,15 @@ class TwoStepNVE : public IntegrationMethodTwoStep
         //! Performs the second step of the integration
         virtual void integrateStepTwo(unsigned int timestep);
 
+        //! Performs the second step of the previous time step and the first step of this one in a single pass
+        virtual void integrateStepTwoOne(unsigned int timestep);
+
+        //! TwoStepNVE implements integrateStepTwoOne() as a single pass
+        virtual bool hasFusedStep()
+            {
+            return true;
+            }
+
     protected:
         bool m_limit;       //!< True if we should limit the distance a particle moves in one step
         Scalar m_limit_val; //!< The maximum distance a particle is to move in one step
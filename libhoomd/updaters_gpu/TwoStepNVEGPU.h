@@ -82,6 +82,12 @@ class TwoStepNVEGPU : public TwoStepNVE
         //! Performs the second step of the integration
         virtual void integrateStepTwo(unsigned int timestep);
 
+        //! The steps run as separate kernels on the GPU
+        virtual bool hasFusedStep()
+            {
+            return false;
+            }
+
         //! Set autotuner parameters
         /*! \param enable Enable/disable autotuning
             \param period period (approximate) in time steps when returning occurs
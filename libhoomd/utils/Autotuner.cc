@@ -79,7 +79,7 @@ Autotuner::Autotuner(const std::vector<unsigned int>& parameters,
                      boost::shared_ptr<const ExecutionConfiguration> exec_conf)
     : m_nsamples(nsamples), m_period(period), m_enabled(true), m_name(name), m_parameters(parameters),
       m_state(STARTUP), m_current_sample(0), m_current_element(0), m_calls(0),
-      m_exec_conf(exec_conf), m_avg(false)
+      m_exec_conf(exec_conf), m_avg(false), m_start_time(0)
     {
     m_exec_conf->msg->notice(5) << "Constructing Autotuner " << nsamples << " " << period << " " << name << endl;
 
@@ -103,11 +103,18 @@ Autotuner::Autotuner(const std::vector<unsigned int>& parameters,
 
     m_current_param = m_parameters[m_current_element];
 
+    // time on the host unless kernels run on the GPU
+    m_host_timer = true;
+
     // create CUDA events
     #ifdef ENABLE_CUDA
-    cudaEventCreate(&m_start);
-    cudaEventCreate(&m_stop);
-    CHECK_CUDA_ERROR();
+    if (m_exec_conf->isCUDAEnabled())
+        {
+        m_host_timer = false;
+        cudaEventCreate(&m_start);
+        cudaEventCreate(&m_stop);
+        CHECK_CUDA_ERROR();
+        }
     #endif
 
     m_sync = false;
@@ -133,7 +140,7 @@ Autotuner::Autotuner(unsigned int start,
                      boost::shared_ptr<const ExecutionConfiguration> exec_conf)
     : m_nsamples(nsamples), m_period(period), m_enabled(true), m_name(name),
       m_state(STARTUP), m_current_sample(0), m_current_element(0), m_calls(0), m_current_param(0),
-      m_exec_conf(exec_conf), m_avg(false)
+      m_exec_conf(exec_conf), m_avg(false), m_start_time(0)
     {
     m_exec_conf->msg->notice(5) << "Constructing Autotuner " << " " << start << " " << end << " " << step << " "
                                 << nsamples << " " << period << " " << name << endl;
@@ -167,11 +174,18 @@ Autotuner::Autotuner(unsigned int start,
 
     m_current_param = m_parameters[m_current_element];
 
+    // time on the host unless kernels run on the GPU
+    m_host_timer = true;
+
     // create CUDA events
     #ifdef ENABLE_CUDA
-    cudaEventCreate(&m_start);
-    cudaEventCreate(&m_stop);
-    CHECK_CUDA_ERROR();
+    if (m_exec_conf->isCUDAEnabled())
+        {
+        m_host_timer = false;
+        cudaEventCreate(&m_start);
+        cudaEventCreate(&m_stop);
+        CHECK_CUDA_ERROR();
+        }
     #endif
 
     m_sync = false;
@@ -181,9 +195,12 @@ Autotuner::~Autotuner()
     {
     m_exec_conf->msg->notice(5) << "Destroying Autotuner " << m_name << endl;
     #ifdef ENABLE_CUDA
-    cudaEventDestroy(m_start);
-    cudaEventDestroy(m_stop);
-    CHECK_CUDA_ERROR();
+    if (!m_host_timer)
+        {
+        cudaEventDestroy(m_start);
+        cudaEventDestroy(m_stop);
+        CHECK_CUDA_ERROR();
+        }
     #endif
     }
 
@@ -193,15 +210,22 @@ void Autotuner::begin()
     if (!m_enabled)
         return;
 
-    #ifdef ENABLE_CUDA
-    // if we are scanning, record a cuda event - otherwise do nothing
+    // if we are scanning, record the start time - otherwise do nothing
     if (m_state == STARTUP || m_state == SCANNING)
         {
-        cudaEventRecord(m_start, 0);
-        if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
-            CHECK_CUDA_ERROR();
+        if (m_host_timer)
+            {
+            m_start_time = m_clk.getTime();
+            }
+        #ifdef ENABLE_CUDA
+        else
+            {
+            cudaEventRecord(m_start, 0);
+            if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
+                CHECK_CUDA_ERROR();
+            }
+        #endif
         }
-    #endif
     }
 
 void Autotuner::end()
@@ -210,20 +234,29 @@ void Autotuner::end()
     if (!m_enabled)
         return;
 
-    #ifdef ENABLE_CUDA
     // handle timing updates if scanning
     if (m_state == STARTUP || m_state == SCANNING)
         {
-        cudaEventRecord(m_stop, 0);
-        cudaEventSynchronize(m_stop);
-        cudaEventElapsedTime(&m_samples[m_current_element][m_current_sample], m_start, m_stop);
+        if (m_host_timer)
+            {
+            // store the elapsed wall clock time in ms, to match cudaEventElapsedTime
+            m_samples[m_current_element][m_current_sample] = float(m_clk.getTime() - m_start_time) * 1e-6f;
+            }
+        #ifdef ENABLE_CUDA
+        else
+            {
+            cudaEventRecord(m_stop, 0);
+            cudaEventSynchronize(m_stop);
+            cudaEventElapsedTime(&m_samples[m_current_element][m_current_sample], m_start, m_stop);
+
+            if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
+                CHECK_CUDA_ERROR();
+            }
+        #endif
+
         m_exec_conf->msg->notice(9) << "Autotuner " << m_name << ": t(" << m_current_param << "," << m_current_sample
                                      << ") = " << m_samples[m_current_element][m_current_sample] << endl;
-
-        if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
-            CHECK_CUDA_ERROR();
         }
-    #endif
 
     // handle state data updates and transitions
     if (m_state == STARTUP)
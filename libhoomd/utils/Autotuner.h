@@ -56,6 +56,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
 #include "ExecutionConfiguration.h"
+#include "ClockSource.h"
 
 #include <vector>
 #include <string>
@@ -64,11 +65,12 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <cuda_runtime.h>
 #endif
 
-//! Autotuner for low level GPU kernel parameters
+//! Autotuner for low level kernel parameters
 /*! **Overview** <br>
-    Autotuner is a helper class that autotunes GPU kernel parameters (such as block size) for performance. It runs an
-    internal state machine and makes sweeps over all valid parameter values. Performance is measured just for the single
-    kernel in question with cudaEvent timers. A number of sweeps are combined with a median to determine the fastest
+    Autotuner is a helper class that autotunes GPU kernel parameters (such as block size) and CPU kernel parameters
+    (such as cell widths) for performance. It runs an internal state machine and makes sweeps over all valid parameter
+    values. Performance is measured just for the single kernel in question with cudaEvent timers on the GPU, or with a
+    host ClockSource when the execution configuration does not use CUDA. A number of sweeps are combined with a median to determine the fastest
     parameter. Additional timing sweeps are performed at a defined period in order to update to changing conditions.
 
     The begin() and end() methods must be called before and after the kernel launch to be tuned. The value of the tuned
@@ -83,8 +85,9 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
     Each Autotuner instance has a string name to help identify it's output on the notice stream.
 
-    Autotuner is not useful in non-GPU builds. Timing is performed with CUDA events and requires ENABLE_CUDA=on.
-    Behavior of Autotuner is undefined when ENABLE_CUDA=off.
+    When running on the CPU, the host timer measures wall clock time between begin() and end(). Wall clock samples are
+    noisier than kernel timings, so CPU tuners should take enough samples for the median to be meaningful. When
+    running with domain decomposition, call setSync(true) so that all ranks agree on the chosen parameter.
 
     ** Implementation ** <br>
     Internally, m_nsamples is the number of samples to take (odd for median computation). m_current_sample is the
@@ -235,6 +238,10 @@ class Autotuner
 
         bool m_sync;              //!< If true, synchronize results via MPI
         bool m_avg;               //!< If true, use sample average instead of median
+
+        bool m_host_timer;        //!< True if samples are timed with the host clock
+        ClockSource m_clk;        //!< Host clock for timing CPU kernels
+        int64_t m_start_time;     //!< Host time (in ns) recorded by begin()
     };
 
 //! Export the Autotuner class to python
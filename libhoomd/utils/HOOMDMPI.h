@@ -77,6 +77,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <boost/serialization/map.hpp>
 #include <boost/serialization/vector.hpp>
+#include <boost/serialization/utility.hpp>
 
 #ifdef SINGLE_PRECISION
 //! Define MPI_FLOAT as Scalar MPI data type
@@ -337,5 +338,51 @@ void gather_v(const T& in_value, std::vector<T> & out_values, unsigned int root,
     delete[] sbuf;
     }
 
+//! Wrapper around MPI_Send that handles any serializable object
+template<typename T>
+void send(const T& val, const unsigned int dest, const unsigned int tag, const MPI_Comm mpi_comm)
+    {
+    // serialize object
+    std::string str;
+    boost::iostreams::back_insert_device <std::string> inserter(str);
+    boost::iostreams::stream<boost::iostreams::back_insert_device< std::string> > s(inserter);
+    boost::archive::binary_oarchive ar(s);
+
+    ar << val;
+    s.flush();
+
+    // copy into send buffer
+    int send_count = str.size();
+    char *buf = new char[send_count];
+    str.copy(buf, send_count);
+
+    MPI_Send(&send_count, 1, MPI_INT, dest, tag, mpi_comm);
+    MPI_Send(buf, send_count, MPI_BYTE, dest, tag, mpi_comm);
+
+    delete[] buf;
+    }
+
+//! Wrapper around MPI_Recv that handles any serializable object
+template<typename T>
+void recv(T& val, const unsigned int src, const unsigned int tag, const MPI_Comm mpi_comm)
+    {
+    int recv_count;
+    MPI_Status status;
+    MPI_Recv(&recv_count, 1, MPI_INT, src, tag, mpi_comm, &status);
+
+    char *buf = new char[recv_count];
+    MPI_Recv(buf, recv_count, MPI_BYTE, src, tag, mpi_comm, &status);
+
+    // de-serialize
+    std::string str(buf, recv_count);
+    boost::iostreams::basic_array_source<char> dev(str.data(), str.size());
+    boost::iostreams::stream<boost::iostreams::basic_array_source<char> > s(dev);
+    boost::archive::binary_iarchive ar(s);
+
+    ar >> val;
+
+    delete[] buf;
+    }
+
 #endif // ENABLE_MPI
 #endif // __HOOMD_MATH_H__
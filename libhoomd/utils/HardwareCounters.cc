@@ -0,0 +1,186 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+/*! \file HardwareCounters.cc
+    \brief Defines the HardwareCounters class
+*/
+
+#include "HardwareCounters.h"
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#include <string.h>
+#endif
+
+#include <vector>
+
+using namespace std;
+
+#ifdef __linux__
+//! Open one perf event counter of the calling thread
+/*! \param type Event type
+    \param config Event config
+    \param group_fd Group leader (-1 to start a new group)
+    \returns The file descriptor, or -1 on failure
+*/
+static int open_counter(uint32_t type, uint64_t config, int group_fd)
+    {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = (group_fd == -1) ? 1 : 0;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+
+    return (int)syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0);
+    }
+#endif
+
+/*! \param exec_conf Execution configuration
+    \param vector_fp_event Raw event code for the vector floating point counter (0 to not count it)
+*/
+HardwareCounters::HardwareCounters(boost::shared_ptr<const ExecutionConfiguration> exec_conf,
+                                   unsigned int vector_fp_event)
+    : m_exec_conf(exec_conf), m_group_fd(-1), m_n_open(0)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing HardwareCounters" << endl;
+
+    for (unsigned int c = 0; c < num_counters; c++)
+        {
+        m_fd[c] = -1;
+        m_index[c] = -1;
+        }
+
+    #ifdef __linux__
+    uint32_t types[num_counters] = {PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_RAW};
+    uint64_t configs[num_counters] = {PERF_COUNT_HW_CPU_CYCLES,
+                                      PERF_COUNT_HW_INSTRUCTIONS,
+                                      PERF_COUNT_HW_CACHE_MISSES,
+                                      vector_fp_event};
+
+    for (unsigned int c = 0; c < num_counters; c++)
+        {
+        if (c == vector_fp && vector_fp_event == 0)
+            continue;
+
+        int fd = open_counter(types[c], configs[c], m_group_fd);
+        if (fd == -1)
+            continue;
+
+        if (m_group_fd == -1)
+            m_group_fd = fd;
+        m_fd[c] = fd;
+        m_index[c] = m_n_open++;
+        }
+
+    if (m_group_fd != -1)
+        {
+        ioctl(m_group_fd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(m_group_fd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+    #endif
+
+    const char *names[num_counters] = {"cycles", "instructions", "LLC misses", "vector FP instructions"};
+    for (unsigned int c = 0; c < num_counters; c++)
+        {
+        if (c == vector_fp && vector_fp_event == 0)
+            continue;
+        if (!isAvailable(c))
+            m_exec_conf->msg->warning() << "Hardware counter for " << names[c] << " is not available" << endl;
+        }
+    }
+
+HardwareCounters::~HardwareCounters()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying HardwareCounters" << endl;
+
+    #ifdef __linux__
+    // close the members before the group leader
+    for (int c = num_counters-1; c >= 0; c--)
+        {
+        if (m_fd[c] != -1 && m_fd[c] != m_group_fd)
+            close(m_fd[c]);
+        }
+    if (m_group_fd != -1)
+        close(m_group_fd);
+    #endif
+    }
+
+/*! \param values Array of num_counters values to fill out (unavailable counters are set to 0)
+*/
+void HardwareCounters::read(int64_t *values) const
+    {
+    for (unsigned int c = 0; c < num_counters; c++)
+        values[c] = 0;
+
+    #ifdef __linux__
+    if (m_group_fd == -1)
+        return;
+
+    // a group read returns the number of counters followed by their values
+    uint64_t buf[1 + num_counters];
+    ssize_t n = ::read(m_group_fd, buf, sizeof(uint64_t) * (1 + m_n_open));
+    if (n < ssize_t(sizeof(uint64_t)))
+        return;
+
+    for (unsigned int c = 0; c < num_counters; c++)
+        {
+        if (m_index[c] >= 0 && (unsigned int)m_index[c] < buf[0])
+            values[c] = int64_t(buf[1 + m_index[c]]);
+        }
+    #endif
+    }
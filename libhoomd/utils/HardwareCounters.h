@@ -0,0 +1,121 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+/*! \file HardwareCounters.h
+    \brief Declares the HardwareCounters class
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include "ExecutionConfiguration.h"
+
+#include <string>
+#include <boost/shared_ptr.hpp>
+#include <boost/utility.hpp>
+
+#ifndef __HARDWARE_COUNTERS_H__
+#define __HARDWARE_COUNTERS_H__
+
+//! Reads CPU hardware performance counters for the calling thread
+/*! HardwareCounters opens a group of perf_event counters on Linux: cycles, instructions, last level cache misses and
+    (optionally) a raw event counting vector floating point instructions. The counters only count user space events of
+    the thread that constructed the object. Profiler reads them at each push and pop to attribute the counts to
+    profiled regions.
+
+    There is no portable event for floating point work, so the vector FP counter is only opened when a raw event code
+    is given. The code is the model specific (umask << 8) | event value as used by perf stat -e rXXXX. For example,
+    0x3cc7 selects FP_ARITH_INST_RETIRED for all packed 128 and 256 bit instructions on recent Intel cores. Note that
+    it counts instructions, not flops.
+
+    Counters that cannot be opened (e.g. because of /proc/sys/kernel/perf_event_paranoid or on systems without
+    perf_event support) are reported as unavailable and read as 0. A warning is printed in that case.
+
+    \ingroup utils
+*/
+class HardwareCounters : boost::noncopyable
+    {
+    public:
+        //! Counters that are read
+        enum counter
+            {
+            cycles = 0,         //!< CPU cycles
+            instructions,       //!< Retired instructions
+            llc_misses,         //!< Last level cache misses
+            vector_fp,          //!< Vector floating point instructions (raw event)
+            num_counters        //!< Number of counters
+            };
+
+        //! Open the counters
+        HardwareCounters(boost::shared_ptr<const ExecutionConfiguration> exec_conf, unsigned int vector_fp_event=0);
+
+        //! Close the counters
+        ~HardwareCounters();
+
+        //! Test if a counter could be opened
+        bool isAvailable(unsigned int c) const
+            {
+            return m_index[c] >= 0;
+            }
+
+        //! Read the current value of all counters
+        void read(int64_t *values) const;
+
+    private:
+        boost::shared_ptr<const ExecutionConfiguration> m_exec_conf; //!< Execution configuration
+        int m_fd[num_counters];     //!< File descriptor of each counter (-1 if not open)
+        int m_index[num_counters];  //!< Position of each counter in a group read (-1 if not open)
+        int m_group_fd;             //!< File descriptor of the group leader (-1 if nothing is open)
+        unsigned int m_n_open;      //!< Number of counters in the group
+    };
+
+#endif
@@ -57,6 +57,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "ExecutionConfiguration.h"
 
 #include <assert.h>
+#include <map>
 using namespace std;
 
 #include <boost/python.hpp>
@@ -67,6 +68,8 @@ using namespace std;
 
 using namespace boost::python;
 
+const unsigned int Messenger::notice_buffer_size;
+
 /*! \post Warning and error streams are set to cerr
     \post The notice stream is set to cout
     \post The notice level is set to 2
@@ -82,6 +85,7 @@ Messenger::Messenger()
     m_err_prefix     = "**ERROR**";
     m_warning_prefix = "*Warning*";
     m_notice_prefix  = "notice";
+    m_aggregate = false;
 
 #ifdef ENABLE_MPI
     // initial value
@@ -116,6 +120,9 @@ Messenger::Messenger(const Messenger& msg)
     m_partition = msg.m_partition;
     m_nranks = msg.m_nranks;
 
+    // buffered messages stay with the Messenger that received them
+    m_aggregate = msg.m_aggregate;
+
     #ifdef ENABLE_MPI
     m_shared_filename = msg.m_shared_filename;
     m_mpi_comm = msg.m_mpi_comm;
@@ -127,6 +134,8 @@ Messenger::Messenger(const Messenger& msg)
 
 Messenger& Messenger::operator=(Messenger& msg)
     {
+    flushLocal();
+
     #ifdef ENABLE_MPI
     releaseSharedMem();
     #endif
@@ -145,6 +154,9 @@ Messenger& Messenger::operator=(Messenger& msg)
     m_partition = msg.m_partition;
     m_nranks = msg.m_nranks;
 
+    // buffered messages stay with the Messenger that received them
+    m_aggregate = msg.m_aggregate;
+
     #ifdef ENABLE_MPI
     m_shared_filename = msg.m_shared_filename;
     m_mpi_comm = msg.m_mpi_comm;
@@ -158,6 +170,9 @@ Messenger& Messenger::operator=(Messenger& msg)
 
 Messenger::~Messenger()
     {
+    // write out anything that was never flushed
+    flushLocal();
+
     // set pointers to NULL
     m_err_stream = NULL;
     m_warning_stream = NULL;
@@ -191,9 +206,28 @@ std::ostream& Messenger::error() const
         m_has_lock = m_has_lock || (flag == 1);
 
         // if we do not have exclusive access to stdout, return NULL stream
-        if (! m_has_lock) return *m_nullstream;
+        if (! m_has_lock)
+            {
+            boost::mutex::scoped_lock lock(m_buffer_mutex);
+            ThreadBuffers *buf = getThreadBuffers(false);
+            if (buf)
+                mergeBuffers(*buf);
+            writeNotices();
+            return *m_nullstream;
+            }
         }
     #endif
+
+    // errors are never buffered, print what this thread holds first so that the output stays in order
+        {
+        boost::mutex::scoped_lock lock(m_buffer_mutex);
+        ThreadBuffers *buf = getThreadBuffers(false);
+        if (buf)
+            mergeBuffers(*buf);
+        writeWarnings();
+        writeNotices();
+        }
+
     if (m_err_prefix != string(""))
         *m_err_stream << m_err_prefix << ": ";
     if (m_nranks > 1)
@@ -216,6 +250,15 @@ void Messenger::errorStr(const std::string& msg) const
 std::ostream& Messenger::warning() const
     {
     assert(m_warning_stream);
+    if (m_aggregate && m_nranks > 1)
+        {
+        // each call starts a new message, the prefix is added when the message is printed
+        boost::mutex::scoped_lock lock(m_buffer_mutex);
+        ThreadBuffers *buf = getThreadBuffers(true);
+        mergeBuffers(*buf);
+        return buf->warning;
+        }
+
     if (m_warning_prefix != string(""))
         *m_warning_stream << m_warning_prefix << ": ";
    if (m_nranks > 1)
@@ -242,9 +285,33 @@ std::ostream& Messenger::notice(unsigned int level) const
     assert(m_notice_stream);
     if (level <= m_notice_level)
         {
+        std::ostream *stream = m_notice_stream;
+        if (m_aggregate)
+            {
+            boost::mutex::scoped_lock lock(m_buffer_mutex);
+            if (level > 1)
+                {
+                // write out the buffer in large blocks
+                ThreadBuffers *buf = getThreadBuffers(true);
+                if (buf->notice.tellp() > std::streampos(notice_buffer_size))
+                    {
+                    mergeBuffers(*buf);
+                    writeNotices();
+                    }
+                stream = &buf->notice;
+                }
+            else
+                {
+                ThreadBuffers *buf = getThreadBuffers(false);
+                if (buf)
+                    mergeBuffers(*buf);
+                writeNotices();
+                }
+            }
+
         if (m_notice_prefix != string("") && level > 1)
-            *m_notice_stream << m_notice_prefix << "(" << level << "): ";
-        return *m_notice_stream;
+            *stream << m_notice_prefix << "(" << level << "): ";
+        return *stream;
         }
     else
         {
@@ -315,6 +382,182 @@ void Messenger::noticeStr(unsigned int level, const std::string& msg) const
     notice(level) << msg;
     }
 
+/*! \param aggregate true to buffer warnings and notices, false to print them immediately
+
+    Messages that are already buffered are printed by each rank when aggregation is disabled.
+*/
+void Messenger::setAggregate(bool aggregate)
+    {
+    if (!aggregate)
+        flushLocal();
+    m_aggregate = aggregate;
+    }
+
+/*! \param create true to create the buffers if the calling thread has none
+    \returns The buffers of the calling thread, or NULL if it has none and \a create is false
+    \pre m_buffer_mutex is locked
+*/
+Messenger::ThreadBuffers *Messenger::getThreadBuffers(bool create) const
+    {
+    boost::thread::id id = boost::this_thread::get_id();
+    ThreadBufferMap::iterator it = m_buffers.find(id);
+    if (it != m_buffers.end())
+        return it->second.get();
+    if (!create)
+        return NULL;
+
+    boost::shared_ptr<ThreadBuffers> buf(new ThreadBuffers());
+    m_buffers[id] = buf;
+    return buf.get();
+    }
+
+/*! \param buf Buffers to empty
+    \pre m_buffer_mutex is locked, and the thread owning \a buf is the caller or is not writing to it
+*/
+void Messenger::mergeBuffers(ThreadBuffers& buf) const
+    {
+    std::string msg = buf.warning.str();
+    if (msg != string(""))
+        {
+        m_warnings.push_back(msg);
+        buf.warning.str("");
+        }
+
+    if (buf.notice.tellp() > 0)
+        {
+        m_notices += buf.notice.str();
+        buf.notice.str("");
+        }
+    }
+
+/*! \pre m_buffer_mutex is locked and no other thread is writing messages
+*/
+void Messenger::mergeAllBuffers() const
+    {
+    ThreadBufferMap::iterator it;
+    for (it = m_buffers.begin(); it != m_buffers.end(); ++it)
+        mergeBuffers(*it->second);
+
+    // worker threads come and go, forget about the ones that are done
+    m_buffers.clear();
+    }
+
+/*! \pre m_buffer_mutex is locked
+*/
+void Messenger::writeWarnings() const
+    {
+    for (unsigned int i = 0; i < m_warnings.size(); i++)
+        {
+        if (m_warning_prefix != string(""))
+            *m_warning_stream << m_warning_prefix << ": ";
+        if (m_nranks > 1)
+            *m_warning_stream << " (Rank " << m_rank << "): ";
+        *m_warning_stream << m_warnings[i];
+        }
+    m_warnings.clear();
+    }
+
+/*! \pre m_buffer_mutex is locked
+*/
+void Messenger::writeNotices() const
+    {
+    if (m_notices != string(""))
+        {
+        *m_notice_stream << m_notices;
+        m_notice_stream->flush();
+        m_notices.clear();
+        }
+    }
+
+/*! The buffered warnings and notices of all threads are written out without waiting for the other ranks. This
+    does not change whether later messages are aggregated.
+*/
+void Messenger::flushLocal() const
+    {
+    boost::mutex::scoped_lock lock(m_buffer_mutex);
+    mergeAllBuffers();
+    writeWarnings();
+    writeNotices();
+    }
+
+/*! Identical warnings of all ranks are combined in a binary tree reduction towards rank 0, which prints each
+    distinct message once along with the number of ranks that issued it and the lowest of those ranks. Buffered
+    notices are written out afterwards.
+
+    This method must be called by all ranks of the communicator. It does nothing if aggregation is disabled.
+*/
+void Messenger::collectiveFlush() const
+    {
+    if (!m_aggregate)
+        return;
+
+    boost::mutex::scoped_lock lock(m_buffer_mutex);
+    mergeAllBuffers();
+
+    #ifdef ENABLE_MPI
+    if (m_nranks > 1)
+        {
+        int rank;
+        int size;
+        MPI_Comm_rank(m_mpi_comm, &rank);
+        MPI_Comm_size(m_mpi_comm, &size);
+
+        // number of ranks and lowest rank that issued each message
+        std::map<std::string, std::pair<unsigned int, unsigned int> > counts;
+        for (unsigned int i = 0; i < m_warnings.size(); i++)
+            counts[m_warnings[i]] = std::make_pair(1, rank);
+        m_warnings.clear();
+
+        // in round k, ranks that are odd multiples of 2^k send their counts to the rank 2^k below them
+        for (int step = 1; step < size; step *= 2)
+            {
+            if (rank & step)
+                {
+                send(counts, rank - step, 0, m_mpi_comm);
+                break;
+                }
+            else if (rank + step < size)
+                {
+                std::map<std::string, std::pair<unsigned int, unsigned int> > recv_counts;
+                recv(recv_counts, rank + step, 0, m_mpi_comm);
+
+                std::map<std::string, std::pair<unsigned int, unsigned int> >::iterator it;
+                for (it = recv_counts.begin(); it != recv_counts.end(); ++it)
+                    {
+                    std::map<std::string, std::pair<unsigned int, unsigned int> >::iterator entry;
+                    entry = counts.find(it->first);
+                    if (entry == counts.end())
+                        counts.insert(*it);
+                    else
+                        {
+                        entry->second.first += it->second.first;
+                        entry->second.second = std::min(entry->second.second, it->second.second);
+                        }
+                    }
+                }
+            }
+
+        if (rank == 0)
+            {
+            std::map<std::string, std::pair<unsigned int, unsigned int> >::iterator it;
+            for (it = counts.begin(); it != counts.end(); ++it)
+                {
+                if (m_warning_prefix != string(""))
+                    *m_warning_stream << m_warning_prefix << ": ";
+                if (it->second.first == 1)
+                    *m_warning_stream << " (Rank " << it->second.second << "): ";
+                else
+                    *m_warning_stream << " (" << it->second.first << " ranks, first " << it->second.second << "): ";
+                *m_warning_stream << it->first;
+                }
+            m_warning_stream->flush();
+            }
+        }
+    #endif
+
+    writeNotices();
+    }
+
 /*! \param fname File name
     The file is ovewritten if it exists. If there is an error opening the file, all level's streams are left
     as is and an error() is issued.
@@ -442,5 +685,8 @@ void export_Messenger()
          .def("setSharedFile", &Messenger::setSharedFile)
 #endif
          .def("openStd", &Messenger::openStd)
+         .def("setAggregate", &Messenger::setAggregate)
+         .def("getAggregate", &Messenger::getAggregate)
+         .def("collectiveFlush", &Messenger::collectiveFlush)
          ;
     }
@@ -58,6 +58,9 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <string>
 #include <boost/shared_ptr.hpp>
 #include <sstream>
+#include <vector>
+#include <map>
+#include <boost/thread.hpp>
 
 #ifdef ENABLE_MPI
 #include "HOOMDMPI.h"
@@ -177,6 +180,24 @@ class mpi_io
         - 6 memory allocation/reallocation notices from every major class
         - 7 memory allocation/reallocation notices from GPUArray
     - 10: Trace messages that may print many times per time step.
+
+    \b Aggregation
+
+    With many MPI ranks, a warning issued by every rank is printed once per rank. When aggregation is enabled with
+    setAggregate(), warnings are held in a buffer on each rank instead. collectiveFlush() combines the buffered
+    warnings of all ranks in a binary tree reduction and rank 0 prints each distinct message once, annotated with the
+    number of ranks that issued it. Notices with level > 1 are buffered as well and written in large blocks, at the
+    latest when collectiveFlush() is called. Level 1 notices and errors are written immediately, after any buffered
+    messages of the calling rank so that the output stays in order.
+
+    Each thread writing to the Messenger gets its own buffers, so worker threads may issue warnings and notices
+    concurrently. A thread's messages are merged into the shared buffers the next time that thread calls warning() or
+    notice(), and the messages of all threads when the buffers are flushed. collectiveFlush() and setAggregate() must
+    therefore not be called while other threads are still writing.
+
+    collectiveFlush() must be called by all ranks of the communicator. System::run() calls it at the start and end
+    of each run. flushLocal() prints only the buffered messages of the calling rank, for when the other ranks cannot
+    be relied on to take part, e.g. while an exception propagates.
 */
 class Messenger
     {
@@ -214,6 +235,23 @@ class Messenger
         //! Alternate method to print notice strings
         void noticeStr(unsigned int level, const std::string& msg) const;
 
+        //! Enable or disable aggregation of messages across ranks
+        void setAggregate(bool aggregate);
+
+        //! Get whether messages are aggregated
+        /*! \returns true if warnings and notices are buffered for aggregation
+        */
+        bool getAggregate() const
+            {
+            return m_aggregate;
+            }
+
+        //! Print the buffered messages of all ranks
+        void collectiveFlush() const;
+
+        //! Print the buffered messages of this rank without aggregation
+        void flushLocal() const;
+
         //! Set processor rank
         /*! Error and warning messages are prefixed with rank information.
 
@@ -426,6 +464,40 @@ class Messenger
         unsigned int m_partition;       //!< The MPI partition
         unsigned int m_nranks;          //!< Number of ranks in communicator
 
+        //! Messages being written by one thread
+        struct ThreadBuffers
+            {
+            std::ostringstream warning;     //!< Warning message being written
+            std::ostringstream notice;      //!< Notices not yet merged
+            };
+
+        //! Buffers of each thread that writes messages
+        typedef std::map<boost::thread::id, boost::shared_ptr<ThreadBuffers> > ThreadBufferMap;
+
+        bool m_aggregate;                                   //!< True if messages are buffered for aggregation
+        mutable ThreadBufferMap m_buffers;                  //!< Per-thread message buffers
+        mutable std::vector<std::string> m_warnings;        //!< Complete buffered warning messages
+        mutable std::string m_notices;                      //!< Merged buffered notices
+        mutable boost::mutex m_buffer_mutex;                //!< Protects all of the above
+
+        //! Size in bytes at which buffered notices are written out
+        static const unsigned int notice_buffer_size = 65536;
+
+        //! Get the buffers of the calling thread
+        ThreadBuffers *getThreadBuffers(bool create) const;
+
+        //! Move the messages of one thread to the shared buffers
+        void mergeBuffers(ThreadBuffers& buf) const;
+
+        //! Move the messages of all threads to the shared buffers
+        void mergeAllBuffers() const;
+
+        //! Write out the merged warnings of this rank without aggregation
+        void writeWarnings() const;
+
+        //! Write out the merged notices
+        void writeNotices() const;
+
 #ifdef ENABLE_MPI
         std::string m_shared_filename;  //!< Filename of shared log file
         MPI_Comm m_mpi_comm;            //!< The MPI communicator
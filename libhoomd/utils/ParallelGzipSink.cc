@@ -0,0 +1,328 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+/*! \file ParallelGzipSink.cc
+    \brief Defines the ParallelGzipSink and GzipWorkerPool classes
+*/
+
+#ifdef ENABLE_ZLIB
+
+#include "ParallelGzipSink.h"
+#include "WorkQueue.h"
+
+#include <fstream>
+#include <vector>
+#include <deque>
+
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
+#include <boost/version.hpp>
+#include <zlib.h>
+
+// the files are read back with gzip_decompressor, which only reads past the first gzip member since boost 1.44
+#if BOOST_VERSION < 104400
+#error ENABLE_ZLIB requires boost >= 1.44.0
+#endif
+
+using namespace std;
+
+//! One block of data on its way through the compressor
+struct GzipBlock
+    {
+    std::vector<char> in;       //!< Uncompressed data
+    std::vector<char> out;      //!< Compressed gzip member
+    int level;                  //!< zlib compression level
+    bool done;                  //!< True when the worker is finished with the block
+    bool failed;                //!< True if compression failed
+
+    GzipBlock() : level(-1), done(false), failed(false) { }
+    };
+
+//! Queue and threads of a GzipWorkerPool
+struct GzipWorkerPool::Impl
+    {
+    WorkQueue< boost::shared_ptr<GzipBlock> > queue;    //!< Blocks waiting for a worker
+    boost::thread_group workers;                        //!< The worker threads
+    boost::mutex mutex;                                 //!< Protects the done flags of the blocks
+    boost::condition_variable cond;                     //!< Signalled when a block is done
+
+    //! Worker thread main loop
+    void work()
+        {
+        while (true)
+            {
+            boost::shared_ptr<GzipBlock> block = queue.wait_and_pop();
+
+            // a null block asks the worker to exit
+            if (!block)
+                return;
+
+            bool ok = compress(*block);
+
+            boost::mutex::scoped_lock lock(mutex);
+            block->failed = !ok;
+            block->done = true;
+            cond.notify_all();
+            }
+        }
+
+    //! Compress a block into a complete gzip member
+    static bool compress(GzipBlock& block)
+        {
+        z_stream strm;
+        strm.zalloc = Z_NULL;
+        strm.zfree = Z_NULL;
+        strm.opaque = Z_NULL;
+
+        // 16 added to the window bits selects the gzip wrapper
+        if (deflateInit2(&strm, block.level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+            return false;
+
+        block.out.resize(deflateBound(&strm, block.in.size()) + 32);
+        strm.next_in = block.in.empty() ? Z_NULL : (Bytef*)&block.in[0];
+        strm.avail_in = block.in.size();
+        strm.next_out = (Bytef*)&block.out[0];
+        strm.avail_out = block.out.size();
+
+        int err = deflate(&strm, Z_FINISH);
+        block.out.resize(block.out.size() - strm.avail_out);
+        deflateEnd(&strm);
+
+        // release the input early, the block may wait a while before it is written
+        std::vector<char>().swap(block.in);
+        return err == Z_STREAM_END;
+        }
+    };
+
+/*! \param num_threads Number of worker threads (0 selects the number of hardware threads)
+*/
+GzipWorkerPool::GzipWorkerPool(unsigned int num_threads)
+    : m_impl(new Impl)
+    {
+    if (num_threads == 0)
+        num_threads = boost::thread::hardware_concurrency();
+    if (num_threads == 0)
+        num_threads = 1;
+
+    for (unsigned int i = 0; i < num_threads; i++)
+        m_impl->workers.create_thread(boost::bind(&GzipWorkerPool::Impl::work, m_impl.get()));
+    }
+
+/*! Blocks still in the queue are compressed before the workers exit.
+*/
+GzipWorkerPool::~GzipWorkerPool()
+    {
+    unsigned int num_threads = getNumThreads();
+    for (unsigned int i = 0; i < num_threads; i++)
+        m_impl->queue.push(boost::shared_ptr<GzipBlock>());
+    m_impl->workers.join_all();
+    }
+
+unsigned int GzipWorkerPool::getNumThreads() const
+    {
+    return (unsigned int)m_impl->workers.size();
+    }
+
+//! Shared state of all copies of a ParallelGzipSink
+struct ParallelGzipSink::State
+    {
+    std::ofstream file;                                 //!< Output file
+    boost::shared_ptr<GzipWorkerPool> pool;             //!< Workers that compress the blocks
+    unsigned int block_size;                            //!< Uncompressed size of each block
+    int level;                                          //!< zlib compression level
+    unsigned int max_pending;                           //!< Maximum number of blocks in flight
+
+    std::vector<char> cur;                              //!< Block currently being filled
+    std::deque< boost::shared_ptr<GzipBlock> > pending; //!< Blocks submitted, in file order
+    unsigned int num_written;                           //!< Number of blocks written so far
+
+    bool closed;                                        //!< True after close()
+    bool failed;                                        //!< True after any error
+
+    State() : num_written(0), closed(false), failed(false) { }
+
+    //! Wait for the blocks in flight, they refer to the pool
+    ~State()
+        {
+        if (pool)
+            writeFinished(0);
+        }
+
+    //! Hand the current block to the workers
+    void submit()
+        {
+        boost::shared_ptr<GzipBlock> block(new GzipBlock);
+        block->in.swap(cur);
+        block->level = level;
+        cur.reserve(block_size);
+        pending.push_back(block);
+        pool->m_impl->queue.push(block);
+        }
+
+    //! Write out finished blocks in order
+    /*! \param min_pending Wait for blocks to finish until no more than this many are pending
+    */
+    void writeFinished(unsigned int min_pending)
+        {
+        GzipWorkerPool::Impl& impl = *pool->m_impl;
+        while (!pending.empty())
+            {
+            boost::shared_ptr<GzipBlock> block = pending.front();
+                {
+                boost::mutex::scoped_lock lock(impl.mutex);
+                if (pending.size() > min_pending)
+                    {
+                    while (!block->done)
+                        impl.cond.wait(lock);
+                    }
+                else if (!block->done)
+                    return;
+                }
+
+            if (block->failed)
+                failed = true;
+            else if (!block->out.empty() && file.is_open())
+                file.write(&block->out[0], block->out.size());
+            if (!file.good())
+                failed = true;
+
+            pending.pop_front();
+            num_written++;
+            }
+        }
+    };
+
+/*! \param fname File to write
+    \param pool Worker threads to compress the blocks with
+    \param block_size Number of uncompressed bytes per gzip member
+    \param level zlib compression level (-1 selects the zlib default)
+*/
+ParallelGzipSink::ParallelGzipSink(const std::string& fname,
+                                   boost::shared_ptr<GzipWorkerPool> pool,
+                                   unsigned int block_size,
+                                   int level)
+    : m_state(new State)
+    {
+    m_state->file.open(fname.c_str(), ios::out | ios::binary | ios::trunc);
+    m_state->pool = pool;
+    m_state->block_size = block_size;
+    m_state->level = level;
+    m_state->cur.reserve(block_size);
+
+    // a couple of blocks per thread keeps all workers busy while the oldest block is written
+    m_state->max_pending = 2*pool->getNumThreads();
+    }
+
+/*! \param s Data to write
+    \param n Number of bytes to write
+    \returns \a n
+*/
+std::streamsize ParallelGzipSink::write(const char *s, std::streamsize n)
+    {
+    State& state = *m_state;
+    if (state.closed || !is_open())
+        {
+        state.failed = true;
+        return n;
+        }
+
+    std::streamsize remaining = n;
+    while (remaining > 0)
+        {
+        std::streamsize space = state.block_size - state.cur.size();
+        std::streamsize count = (remaining < space) ? remaining : space;
+        state.cur.insert(state.cur.end(), s, s + count);
+        s += count;
+        remaining -= count;
+
+        if (state.cur.size() >= state.block_size)
+            {
+            state.submit();
+            state.writeFinished(state.max_pending);
+            }
+        }
+    return n;
+    }
+
+void ParallelGzipSink::close()
+    {
+    State& state = *m_state;
+    if (state.closed)
+        return;
+    state.closed = true;
+
+    if (!is_open())
+        {
+        state.failed = true;
+        return;
+        }
+
+    // flush the partial block (an empty file still needs one member to be a valid gzip file)
+    if (!state.cur.empty() || state.num_written + state.pending.size() == 0)
+        state.submit();
+    state.writeFinished(0);
+
+    state.file.close();
+    if (state.file.fail())
+        state.failed = true;
+    }
+
+bool ParallelGzipSink::is_open() const
+    {
+    return m_state->file.is_open() && m_state->pool->getNumThreads() > 0;
+    }
+
+bool ParallelGzipSink::failed() const
+    {
+    return m_state->failed || (!m_state->closed && !is_open());
+    }
+
+#endif
@@ -0,0 +1,162 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+/*! \file ParallelGzipSink.h
+    \brief Declares the ParallelGzipSink and GzipWorkerPool classes
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#ifndef __PARALLEL_GZIP_SINK_H__
+#define __PARALLEL_GZIP_SINK_H__
+
+#ifdef ENABLE_ZLIB
+
+#include <string>
+#include <iosfwd>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/utility.hpp>
+#include <boost/iostreams/categories.hpp>
+
+//! Worker threads that compress the blocks of ParallelGzipSink
+/*! A writer that produces many compressed files keeps one pool and passes it to the sink of every file, so the
+    threads are started once instead of once per file. Any number of sinks may use the same pool, but a pool must
+    only be used by one thread at a time.
+
+    \ingroup utils
+*/
+class GzipWorkerPool : boost::noncopyable
+    {
+    public:
+        //! Start the worker threads
+        GzipWorkerPool(unsigned int num_threads=0);
+
+        //! Stop the worker threads
+        ~GzipWorkerPool();
+
+        //! Get the number of worker threads
+        unsigned int getNumThreads() const;
+
+    private:
+        friend class ParallelGzipSink;
+        struct Impl;
+        boost::scoped_ptr<Impl> m_impl;     //!< Queue and threads
+    };
+
+//! boost::iostreams sink that writes gzip files, compressing blocks on worker threads
+/*! The data written to the sink is cut into fixed size blocks. Each block is compressed on its own into a complete
+    gzip member by a pool of worker threads while the caller keeps producing data, and the members are appended to
+    the file in order. A file made of several gzip members is itself a valid gzip file, so it can be read by any gzip
+    reader (including boost::iostreams::gzip_decompressor used by init.read_bin).
+
+    The number of blocks in flight is bounded, so memory use stays at a few blocks per thread no matter how large
+    the file is.
+
+    The multi-member files are only read back completely by gzip_decompressor from boost 1.44 on. CMake requires that
+    version when ENABLE_ZLIB is on.
+
+    Usage:
+    \code
+    boost::shared_ptr<GzipWorkerPool> pool(new GzipWorkerPool());
+    ...
+    ParallelGzipSink sink(fname, pool);
+    if (!sink.is_open())
+        ... error ...
+    filtering_ostream f;
+    f.push(sink);
+    f << ... ;
+    f.reset();
+    if (sink.failed())
+        ... error ...
+    \endcode
+
+    Copies of the sink share the same state, which is how the caller can query failed() after the stream (which holds
+    its own copy) has closed it.
+
+    \ingroup utils
+*/
+class ParallelGzipSink
+    {
+    public:
+        typedef char char_type;
+        //! The sink must be closed to flush the last block
+        struct category : boost::iostreams::sink_tag, boost::iostreams::closable_tag { };
+
+        //! Open the file
+        ParallelGzipSink(const std::string& fname,
+                         boost::shared_ptr<GzipWorkerPool> pool,
+                         unsigned int block_size=1048576,
+                         int level=-1);
+
+        //! Write data
+        std::streamsize write(const char *s, std::streamsize n);
+
+        //! Compress the remaining data, write everything out and close the file
+        void close();
+
+        //! Test if the file was opened successfully
+        bool is_open() const;
+
+        //! Test if an error occured while compressing or writing
+        bool failed() const;
+
+    private:
+        struct State;
+        boost::shared_ptr<State> m_state;   //!< State shared by all copies of the sink
+    };
+
+#endif
+
+#endif
@@ -0,0 +1,381 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+/*! \file ProfileTrace.cc
+    \brief Defines the ProfileTrace class
+*/
+
+#include "ProfileTrace.h"
+
+#ifdef ENABLE_MPI
+#include "HOOMDMPI.h"
+#endif
+
+#include <sstream>
+#include <iomanip>
+#include <stdexcept>
+#include <boost/bind.hpp>
+
+using namespace std;
+
+/*! \param exec_conf Execution configuration
+    \param filename File to write (the rank is inserted before the extension when running on more than one rank)
+    \param format Output format
+    \param period Record events every \a period time steps
+    \param block_size Number of events in each block
+    \param nblocks Number of blocks in the ring of each recording thread
+*/
+ProfileTrace::ProfileTrace(boost::shared_ptr<const ExecutionConfiguration> exec_conf,
+                           const std::string& filename,
+                           traceFormat format,
+                           unsigned int period,
+                           unsigned int block_size,
+                           unsigned int nblocks)
+    : m_exec_conf(exec_conf), m_filename(filename), m_format(format), m_period(period), m_block_size(block_size),
+      m_nblocks(nblocks), m_rank(0), m_t0(0), m_timestep(0), m_active(false), m_first_event(true),
+      m_local(&ProfileTrace::releaseLocal), m_writing(false), m_stop(false)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing ProfileTrace " << filename << endl;
+
+    if (m_period == 0 || m_block_size == 0 || m_nblocks < 2)
+        {
+        m_exec_conf->msg->error() << "Trace period and block size must be positive and at least 2 blocks are needed"
+                                  << endl;
+        throw runtime_error("Error initializing ProfileTrace");
+        }
+
+    // one file per rank
+    string fname = filename;
+    #ifdef ENABLE_MPI
+    m_rank = m_exec_conf->getRank();
+    if (m_exec_conf->getNRanks() > 1)
+        {
+        ostringstream rank_str;
+        rank_str << "." << m_rank;
+        size_t dot = fname.find_last_of('.');
+        size_t slash = fname.find_last_of('/');
+        if (dot == string::npos || (slash != string::npos && dot < slash))
+            fname += rank_str.str();
+        else
+            fname.insert(dot, rank_str.str());
+        }
+    #endif
+
+    if (m_format == binary)
+        m_file.open(fname.c_str(), ios_base::out | ios_base::binary | ios_base::trunc);
+    else
+        m_file.open(fname.c_str(), ios_base::out | ios_base::trunc);
+
+    if (!m_file.good())
+        {
+        m_exec_conf->msg->error() << "Unable to open trace file " << fname << endl;
+        throw runtime_error("Error initializing ProfileTrace");
+        }
+
+    if (m_format == binary)
+        {
+        unsigned int header[2] = {1, m_rank};
+        m_file.write("HOOMDTRC", 8);
+        m_file.write((const char *)header, sizeof(header));
+        }
+    else
+        {
+        m_file << "[";
+        }
+
+    // start all clocks together so that the timelines of the ranks line up
+    #ifdef ENABLE_MPI
+    if (m_exec_conf->getNRanks() > 1)
+        MPI_Barrier(m_exec_conf->getMPICommunicator());
+    #endif
+    m_t0 = m_clk.getTime();
+
+    m_writer.reset(new boost::thread(boost::bind(&ProfileTrace::writeLoop, this)));
+    }
+
+/*! Recording threads other than the caller must have stopped recording.
+*/
+ProfileTrace::~ProfileTrace()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying ProfileTrace" << endl;
+
+        {
+        boost::mutex::scoped_lock lock(m_mutex);
+
+        // hand over the partial blocks of all threads
+        for (unsigned int i = 0; i < m_threads.size(); i++)
+            {
+            ThreadBuffer *buf = m_threads[i].get();
+            if (buf->cur && buf->cur->n > 0)
+                {
+                Filled f;
+                f.owner = buf;
+                f.block = buf->cur;
+                m_filled.push_back(f);
+                buf->cur = NULL;
+                }
+            }
+
+        m_stop = true;
+        }
+    m_work_cond.notify_all();
+    m_writer->join();
+
+    writeFooter();
+    m_file.close();
+
+    uint64_t dropped = getNumDropped();
+    if (dropped > 0)
+        m_exec_conf->msg->warning() << "Trace dropped " << dropped << " events, increase the block size" << endl;
+    }
+
+/*! \param name Name of an event
+    \returns The index of \a name in the name table
+*/
+unsigned int ProfileTrace::getNameIndex(const std::string& name)
+    {
+    boost::mutex::scoped_lock lock(m_mutex);
+
+    map<string, unsigned int>::iterator it = m_name_index.find(name);
+    if (it != m_name_index.end())
+        return it->second;
+
+    unsigned int idx = m_names.size();
+    m_names.push_back(name);
+    m_name_index[name] = idx;
+    return idx;
+    }
+
+/*! \returns The buffer of the calling thread
+*/
+ProfileTrace::ThreadBuffer *ProfileTrace::addThread()
+    {
+    boost::shared_ptr<ThreadBuffer> buf(new ThreadBuffer);
+    buf->dropped = 0;
+    for (unsigned int i = 0; i < m_nblocks; i++)
+        {
+        boost::shared_ptr<Block> block(new Block);
+        block->events.resize(m_block_size);
+        block->n = 0;
+        buf->blocks.push_back(block);
+        buf->free.push_back(block.get());
+        }
+    buf->cur = buf->free.back();
+    buf->free.pop_back();
+
+        {
+        boost::mutex::scoped_lock lock(m_mutex);
+        buf->thread = m_threads.size();
+        m_threads.push_back(buf);
+        }
+
+    m_local.reset(buf.get());
+    return buf.get();
+    }
+
+/*! \param buf Buffer of the calling thread
+    \returns true if a free block is available for recording
+*/
+bool ProfileTrace::nextBlock(ThreadBuffer *buf)
+    {
+    bool filled = false;
+
+        {
+        boost::mutex::scoped_lock lock(m_mutex);
+
+        if (buf->cur && buf->cur->n > 0)
+            {
+            Filled f;
+            f.owner = buf;
+            f.block = buf->cur;
+            m_filled.push_back(f);
+            buf->cur = NULL;
+            filled = true;
+            }
+
+        if (!buf->cur && !buf->free.empty())
+            {
+            buf->cur = buf->free.back();
+            buf->free.pop_back();
+            buf->cur->n = 0;
+            }
+        }
+
+    if (filled)
+        m_work_cond.notify_all();
+
+    return buf->cur != NULL;
+    }
+
+/*! \post All events recorded by the calling thread so far are written to the file
+*/
+void ProfileTrace::flush()
+    {
+    ThreadBuffer *buf = m_local.get();
+    if (buf && buf->cur && buf->cur->n > 0)
+        nextBlock(buf);
+
+        {
+        boost::mutex::scoped_lock lock(m_mutex);
+        while (!m_filled.empty() || m_writing)
+            m_done_cond.wait(lock);
+        }
+
+    m_file.flush();
+    }
+
+/*! \returns The total number of events dropped by all threads
+*/
+uint64_t ProfileTrace::getNumDropped()
+    {
+    boost::mutex::scoped_lock lock(m_mutex);
+    uint64_t dropped = 0;
+    for (unsigned int i = 0; i < m_threads.size(); i++)
+        dropped += m_threads[i]->dropped;
+    return dropped;
+    }
+
+void ProfileTrace::writeLoop()
+    {
+    boost::mutex::scoped_lock lock(m_mutex);
+    while (true)
+        {
+        while (m_filled.empty() && !m_stop)
+            m_work_cond.wait(lock);
+
+        if (m_filled.empty())
+            break;
+
+        Filled f = m_filled.front();
+        m_filled.pop_front();
+        m_writing = true;
+
+        lock.unlock();
+        writeBlock(f.owner->thread, *f.block);
+        lock.lock();
+
+        // return the block to its thread
+        f.block->n = 0;
+        f.owner->free.push_back(f.block);
+        m_writing = false;
+        m_done_cond.notify_all();
+        }
+    }
+
+/*! \param thread Index of the thread that recorded the block
+    \param block Block to write
+
+    Called by the writer thread without the lock held.
+*/
+void ProfileTrace::writeBlock(unsigned int thread, const Block& block)
+    {
+    if (m_format == binary)
+        {
+        unsigned int header[2] = {thread, block.n};
+        m_file.write((const char *)header, sizeof(header));
+        m_file.write((const char *)&block.events[0], sizeof(ProfileTraceEvent) * block.n);
+        return;
+        }
+
+    // copy the names needed so that the lock is not held while formatting
+    vector<string> names;
+        {
+        boost::mutex::scoped_lock lock(m_mutex);
+        names = m_names;
+        }
+
+    ostringstream o;
+    o << fixed << setprecision(3);
+    for (unsigned int i = 0; i < block.n; i++)
+        {
+        const ProfileTraceEvent& ev = block.events[i];
+        unsigned int name = ev.name & 0x7fffffffu;
+        bool begin = (ev.name & 0x80000000u) != 0;
+
+        if (!m_first_event)
+            o << ",";
+        m_first_event = false;
+
+        o << "\n{\"name\":\"";
+        const string& s = name < names.size() ? names[name] : string();
+        for (unsigned int j = 0; j < s.size(); j++)
+            {
+            if (s[j] == '"' || s[j] == '\\')
+                o << '\\';
+            o << s[j];
+            }
+        o << "\",\"ph\":\"" << (begin ? 'B' : 'E') << "\",\"ts\":" << double(ev.time) * 1e-3
+          << ",\"pid\":" << m_rank << ",\"tid\":" << thread << ",\"args\":{\"step\":" << ev.timestep << "}}";
+        }
+
+    m_file << o.str();
+    }
+
+void ProfileTrace::writeFooter()
+    {
+    if (m_format == binary)
+        {
+        unsigned int marker[2] = {0xffffffffu, (unsigned int)m_names.size()};
+        m_file.write((const char *)marker, sizeof(marker));
+        for (unsigned int i = 0; i < m_names.size(); i++)
+            {
+            unsigned int len = m_names[i].size();
+            m_file.write((const char *)&len, sizeof(len));
+            m_file.write(m_names[i].c_str(), len);
+            }
+        uint64_t dropped = getNumDropped();
+        m_file.write((const char *)&dropped, sizeof(dropped));
+        }
+    else
+        {
+        m_file << "\n]\n";
+        }
+    }
@@ -0,0 +1,274 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+/*! \file ProfileTrace.h
+    \brief Declares the ProfileTrace class
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include "ClockSource.h"
+#include "ExecutionConfiguration.h"
+
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+#include <fstream>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread.hpp>
+#include <boost/thread/tss.hpp>
+#include <boost/utility.hpp>
+
+#ifndef __PROFILE_TRACE_H__
+#define __PROFILE_TRACE_H__
+
+//! A single begin or end event in a ProfileTrace
+/*! The highest bit of \a name is set for begin events. The remaining bits index the name table of the trace.
+    \ingroup utils
+*/
+struct ProfileTraceEvent
+    {
+    int64_t time;               //!< Time of the event in ns since the trace started
+    unsigned int timestep;      //!< Time step the event occured in
+    unsigned int name;          //!< Name index and begin flag
+    };
+
+//! Records a timeline of Profiler push/pop events
+/*! Profiler only accumulates totals. A ProfileTrace attached to it with Profiler::setTrace() also records each push
+    and pop as a begin and end event with the time, the time step, the MPI rank and the thread. The timeline shows
+    jitter between steps and imbalance between ranks that the totals hide.
+
+    Each thread that records events gets a ring of \a nblocks preallocated blocks of \a block_size events. Recording an
+    event only writes to the current block of the calling thread. When a block fills up, it is handed to a writer
+    thread and recording continues in the next free block. If the writer falls behind and no block is free, events are
+    dropped and counted instead of blocking the simulation. flush() hands over the partially filled block of the
+    calling thread and waits for the writer.
+
+    Events are only recorded on time steps that are a multiple of \a period. setTimestep() must be called at the
+    start of each step.
+
+    Each rank writes its own file. With more than one rank, the rank number is inserted before the file extension
+    (trace.json becomes trace.1.json). Two formats are available:
+     - \b json writes the Chrome trace event format (JSON array form), which chrome://tracing and Perfetto load
+       directly. The process id is the rank and the thread id is the index of the recording thread.
+     - \b binary writes a compact stream. It starts with the 8 characters "HOOMDTRC", the format version (1) and
+       the rank as 32-bit unsigned integers. Then follow any number of blocks, each a 32-bit thread index, a 32-bit
+       event count and that many ProfileTraceEvent records (16 bytes each). The stream ends with the marker
+       0xffffffff, the 32-bit number of names, each name as a 32-bit length followed by its characters, and the
+       64-bit number of dropped events.
+
+    All ranks start their clocks together after a barrier, so times are comparable between ranks.
+
+    \ingroup utils
+*/
+class ProfileTrace : boost::noncopyable
+    {
+    public:
+        //! Output formats
+        enum traceFormat
+            {
+            json,       //!< Chrome trace event JSON
+            binary      //!< Compact binary stream
+            };
+
+        //! Open the trace file and start the writer thread
+        ProfileTrace(boost::shared_ptr<const ExecutionConfiguration> exec_conf,
+                     const std::string& filename,
+                     traceFormat format,
+                     unsigned int period,
+                     unsigned int block_size,
+                     unsigned int nblocks=4);
+
+        //! Write out all remaining events and close the file
+        ~ProfileTrace();
+
+        //! Set the current time step
+        /*! \param timestep Time step that is about to execute
+        */
+        void setTimestep(unsigned int timestep)
+            {
+            m_timestep = timestep;
+            m_active = (timestep % m_period) == 0;
+            }
+
+        //! Test if events are recorded on the current time step
+        bool isActive() const
+            {
+            return m_active;
+            }
+
+        //! Get the index of a name in the name table, adding it if needed
+        unsigned int getNameIndex(const std::string& name);
+
+        //! Record an event on the calling thread
+        void record(unsigned int name, bool begin);
+
+        //! Hand over the events of the calling thread and wait until they are written
+        void flush();
+
+        //! Get the number of events dropped because no block was free
+        uint64_t getNumDropped();
+
+        //! Test if the trace was set up with the given parameters
+        bool hasParams(const std::string& filename, traceFormat format, unsigned int period, unsigned int block_size) const
+            {
+            return m_filename == filename && m_format == format && m_period == period && m_block_size == block_size;
+            }
+
+    private:
+        //! A block of preallocated events
+        struct Block
+            {
+            std::vector<ProfileTraceEvent> events;  //!< Event storage
+            unsigned int n;                         //!< Number of events recorded in the block
+            };
+
+        //! The ring of blocks owned by one recording thread
+        struct ThreadBuffer
+            {
+            unsigned int thread;                //!< Index of the thread in the trace
+            Block *cur;                         //!< Block being recorded into (NULL if none is free)
+            std::vector<Block *> free;          //!< Blocks available for recording (protected by m_mutex)
+            std::vector< boost::shared_ptr<Block> > blocks; //!< All blocks of this thread
+            uint64_t dropped;                   //!< Number of events dropped by this thread
+            };
+
+        //! A filled block waiting for the writer
+        struct Filled
+            {
+            ThreadBuffer *owner;                //!< Thread the block belongs to
+            Block *block;                       //!< The block
+            };
+
+        boost::shared_ptr<const ExecutionConfiguration> m_exec_conf; //!< Execution configuration
+        std::string m_filename;                 //!< File name requested by the user
+        traceFormat m_format;                   //!< Output format
+        unsigned int m_period;                  //!< Record every m_period time steps
+        unsigned int m_block_size;              //!< Number of events in a block
+        unsigned int m_nblocks;                 //!< Number of blocks per thread
+        unsigned int m_rank;                    //!< MPI rank (pid in the trace)
+
+        ClockSource m_clk;                      //!< Clock for event times
+        int64_t m_t0;                           //!< Clock value at the start of the trace
+        unsigned int m_timestep;                //!< Current time step
+        bool m_active;                          //!< True if events are recorded on the current time step
+
+        std::ofstream m_file;                   //!< Output file
+        bool m_first_event;                     //!< True until the first JSON event has been written
+
+        std::vector<std::string> m_names;       //!< Name table
+        std::map<std::string, unsigned int> m_name_index; //!< Lookup into the name table
+
+        std::vector< boost::shared_ptr<ThreadBuffer> > m_threads;   //!< All recording threads
+        boost::thread_specific_ptr<ThreadBuffer> m_local;           //!< Buffer of the calling thread
+        std::list<Filled> m_filled;             //!< Blocks waiting for the writer
+        bool m_writing;                         //!< True while the writer works on a block
+        bool m_stop;                            //!< Set to true to make the writer exit
+
+        boost::mutex m_mutex;                   //!< Protects the name table, block lists and writer state
+        boost::condition_variable m_work_cond;  //!< Signalled when a block is filled
+        boost::condition_variable m_done_cond;  //!< Signalled when the writer has finished a block
+        boost::scoped_ptr<boost::thread> m_writer;  //!< Writer thread
+
+        //! Set up the buffer of the calling thread
+        ThreadBuffer *addThread();
+
+        //! Hand over the current block of a thread and take a free one
+        bool nextBlock(ThreadBuffer *buf);
+
+        //! Writer thread main loop
+        void writeLoop();
+
+        //! Write one block to the file
+        void writeBlock(unsigned int thread, const Block& block);
+
+        //! Write the end of the file
+        void writeFooter();
+
+        //! Does nothing, the buffers are owned by m_threads
+        static void releaseLocal(ThreadBuffer *)
+            {
+            }
+    };
+
+/////////////////////////////////////
+// ProfileTrace inlines
+
+/*! \param name Index of the event name from getNameIndex()
+    \param begin True for a begin event, false for an end event
+*/
+inline void ProfileTrace::record(unsigned int name, bool begin)
+    {
+    ThreadBuffer *buf = m_local.get();
+    if (!buf)
+        buf = addThread();
+
+    if (!buf->cur || buf->cur->n == m_block_size)
+        {
+        if (!nextBlock(buf))
+            {
+            buf->dropped++;
+            return;
+            }
+        }
+
+    ProfileTraceEvent& ev = buf->cur->events[buf->cur->n++];
+    ev.time = m_clk.getTime() - m_t0;
+    ev.timestep = m_timestep;
+    ev.name = begin ? (name | 0x80000000u) : name;
+    }
+
+#endif
@@ -118,6 +118,20 @@ int64_t ProfileDataElem::getTotalMemByteCount() const
     return total;
     }
 
+/*! \param c Index of the hardware counter
+    \returns Sum of the counter over the children of this node
+*/
+int64_t ProfileDataElem::getChildHWCount(unsigned int c) const
+    {
+    int64_t total = 0;
+
+    map<string, ProfileDataElem>::const_iterator i;
+    for (i = m_children.begin(); i != m_children.end(); ++i)
+        total += (*i).second.m_hw_count[c];
+
+    return total;
+    }
+
 /*! Recursive output routine to write results from this profile node and all sub nodes printed in
     a tree.
     \param o stream to write output to
@@ -125,8 +139,10 @@ int64_t ProfileDataElem::getTotalMemByteCount() const
     \param tab_level Current number of tabs in the tree
     \param total_time Total number of nanoseconds taken by this node
     \param name_width Maximum name width for all siblings of this node (used to align output columns)
+    \param hw True if hardware counter data should be printed
  */
-void ProfileDataElem::output(std::ostream &o, const std::string& name, int tab_level, int64_t total_time, int name_width) const
+void ProfileDataElem::output(std::ostream &o, const std::string& name, int tab_level, int64_t total_time, int name_width,
+                             bool hw) const
     {
     // create a tab string to output for the current tab level
     string tabs = "";
@@ -147,7 +163,7 @@ void ProfileDataElem::output(std::ostream &o, const std::string& name, int tab_l
         bytes = double(getTotalMemByteCount())/sec;
         }
 
-    output_line(o, name, sec, perc, flops, bytes, name_width);
+    output_line(o, name, sec, perc, flops, bytes, name_width, hw ? m_hw_count : NULL);
 
     // start by determining the name width
     map<string, ProfileDataElem>::const_iterator i;
@@ -164,7 +180,7 @@ void ProfileDataElem::output(std::ostream &o, const std::string& name, int tab_l
     // output each of the children
     for (i = m_children.begin(); i != m_children.end(); ++i)
         {
-        (*i).second.output(o, (*i).first, tab_level+1, total_time, child_max_width);
+        (*i).second.output(o, (*i).first, tab_level+1, total_time, child_max_width, hw);
         }
 
     // output an "Self" item to account for time actually spent in this data elem
@@ -175,11 +191,15 @@ void ProfileDataElem::output(std::ostream &o, const std::string& name, int tab_l
         double flops = double(m_flop_count)/sec;
         double bytes = double(m_mem_byte_count)/sec;
 
+        int64_t self_hw[HardwareCounters::num_counters];
+        for (unsigned int c = 0; c < HardwareCounters::num_counters; c++)
+            self_hw[c] = m_hw_count[c] - getChildHWCount(c);
+
         // don't print Self unless perc is significant
         if (perc >= 0.1)
             {
             o << tabs << "        ";
-            output_line(o, "Self", sec, perc, flops, bytes, child_max_width);
+            output_line(o, "Self", sec, perc, flops, bytes, child_max_width, hw ? self_hw : NULL);
             }
         }
     }
@@ -190,7 +210,8 @@ void ProfileDataElem::output_line(std::ostream &o,
                                   double perc,
                                   double flops,
                                   double bytes,
-                                  unsigned int name_width) const
+                                  unsigned int name_width,
+                                  const int64_t *hw) const
     {
     o << setiosflags(ios::fixed);
 
@@ -234,13 +255,34 @@ void ProfileDataElem::output_line(std::ostream &o,
             o << bytes/1e9 << " GiB/s ";
         }
 
+    // output the measured counters next to the estimates
+    if (hw && hw[HardwareCounters::cycles] > 0)
+        {
+        o << "| IPC " << setprecision(3) << double(hw[HardwareCounters::instructions])
+                                            / double(hw[HardwareCounters::cycles]);
+
+        // every LLC miss is one cache line of memory traffic
+        double llc_bytes = double(hw[HardwareCounters::llc_misses]) * 64.0 / sec;
+        o << ", LLC " << setprecision(5);
+        if (llc_bytes < 1e6)
+            o << llc_bytes << " B/s";
+        else if (llc_bytes < 1e9)
+            o << llc_bytes/1e6 << " MiB/s";
+        else
+            o << llc_bytes/1e9 << " GiB/s";
+
+        if (hw[HardwareCounters::vector_fp] > 0)
+            o << ", vec FP " << double(hw[HardwareCounters::vector_fp])/sec/1e9 << " Ginst/s";
+        o << " ";
+        }
+
     o << endl;
     }
 
 ////////////////////////////////////////////////////////////////////
 // Profiler
 
-Profiler::Profiler(const std::string& name) : m_name(name)
+Profiler::Profiler(const std::string& name) : m_name(name), m_sync(true)
     {
     // push the root onto the top of the stack so that it is the default
     m_stack.push(&m_root);
@@ -253,6 +295,17 @@ Profiler::Profiler(const std::string& name) : m_name(name)
     #endif
     }
 
+/*! \param hw Hardware counters to read (NULL to stop reading counters)
+
+    The counters must belong to the thread that pushes and pops.
+*/
+void Profiler::setHardwareCounters(boost::shared_ptr<HardwareCounters> hw)
+    {
+    m_hw = hw;
+    if (m_hw)
+        m_hw->read(m_root.m_hw_start);
+    }
+
 void Profiler::output(std::ostream &o)
     {
     // perform a sanity check, but don't bail out
@@ -268,8 +321,16 @@ void Profiler::output(std::ostream &o)
     // outputting a profile implicitly calls for a time sample
     m_root.m_elapsed_time = m_clk.getTime() - m_root.m_start_time;
 
+    if (m_hw)
+        {
+        int64_t hw[HardwareCounters::num_counters];
+        m_hw->read(hw);
+        for (unsigned int c = 0; c < HardwareCounters::num_counters; c++)
+            m_root.m_hw_count[c] = hw[c] - m_root.m_hw_start[c];
+        }
+
     // startup the recursive output process
-    m_root.output(o, m_name, 0, m_root.m_elapsed_time, (int)m_name.size());
+    m_root.output(o, m_name, 0, m_root.m_elapsed_time, (int)m_name.size(), bool(m_hw));
     }
 
 /*! \param o Stream to output to
@@ -59,6 +59,8 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "ClockSource.h"
 #include "ExecutionConfiguration.h"
+#include "ProfileTrace.h"
+#include "HardwareCounters.h"
 
 #ifdef ENABLE_CUDA
 #include <cuda_runtime.h>
@@ -107,11 +109,18 @@ class ProfileDataElem
     {
     public:
         //! Constructs an element with zeroed counters
-        ProfileDataElem() : m_start_time(0), m_elapsed_time(0), m_flop_count(0), m_mem_byte_count(0)
+        ProfileDataElem() : m_start_time(0), m_elapsed_time(0), m_flop_count(0), m_mem_byte_count(0),
+            m_trace_name(-1), m_traced(false)
             #ifdef SCOREP_USER_ENABLE
             , m_scorep_region(SCOREP_USER_INVALID_REGION)
             #endif
-            {}
+            {
+            for (unsigned int c = 0; c < HardwareCounters::num_counters; c++)
+                {
+                m_hw_start[c] = 0;
+                m_hw_count[c] = 0;
+                }
+            }
 
         //! Returns the total elapsed time of this nodes children
         int64_t getChildElapsedTime() const;
@@ -120,8 +129,12 @@ class ProfileDataElem
         //! Returns the total memory byte count of this node + children
         int64_t getTotalMemByteCount() const;
 
+        //! Returns the total hardware counter value of this nodes children
+        int64_t getChildHWCount(unsigned int c) const;
+
         //! Output helper function
-        void output(std::ostream &o, const std::string &name, int tab_level, int64_t total_time, int name_width) const;
+        void output(std::ostream &o, const std::string &name, int tab_level, int64_t total_time, int name_width,
+                    bool hw=false) const;
         //! Another output helper function
         void output_line(std::ostream &o,
                          const std::string &name,
@@ -129,7 +142,8 @@ class ProfileDataElem
                          double perc,
                          double flops,
                          double bytes,
-                         unsigned int name_width) const;
+                         unsigned int name_width,
+                         const int64_t *hw=NULL) const;
 
         std::map<std::string, ProfileDataElem> m_children; //!< Child nodes of this profile
 
@@ -138,6 +152,12 @@ class ProfileDataElem
         int64_t m_flop_count;   //!< A running total of floating point operations
         int64_t m_mem_byte_count;   //!< A running total of memory bytes transferred
 
+        int64_t m_hw_start[HardwareCounters::num_counters]; //!< Hardware counter values at the most recent push
+        int64_t m_hw_count[HardwareCounters::num_counters]; //!< Running totals of the hardware counters
+
+        int m_trace_name;       //!< Index of this element's name in the trace (-1 if not yet known)
+        bool m_traced;          //!< True if the most recent push was recorded in the trace
+
         #ifdef SCOREP_USER_ENABLE
         SCOREP_User_RegionHandle m_scorep_region;   //!< ScoreP region identifier
         #endif
@@ -162,6 +182,14 @@ class ProfileDataElem
     to provide accurate timing information.
 
     These profiles can of course be output via normal ostream operators.
+
+    When a ProfileTrace is attached with setTrace(), every push and pop on a time step selected by the trace is also
+    recorded as a begin and end event. The synchronizing versions of push() and pop() can be told not to synchronize
+    with setSync(), so that a trace taken without profiling does not slow down the GPU execution stream.
+
+    When HardwareCounters are attached with setHardwareCounters(), the counters are read at every push and pop and the
+    measured IPC, memory traffic from last level cache misses and vector FP instruction rate are printed next to the
+    estimated FLOP/s and B/s. Counter reads are a system call, so they are only meant for coarse regions.
     \ingroup utils
     */
 class Profiler
@@ -179,11 +207,33 @@ class Profiler
         //! Pops back up to the next super-category & syncs the GPUs
         void pop(boost::shared_ptr<const ExecutionConfiguration> exec_conf, uint64_t flop_count = 0, uint64_t byte_count = 0);
 
+        //! Record push and pop events in a trace
+        /*! \param trace Trace to record in (NULL to stop recording)
+        */
+        void setTrace(boost::shared_ptr<ProfileTrace> trace)
+            {
+            m_trace = trace;
+            }
+
+        //! Read hardware counters in every region
+        void setHardwareCounters(boost::shared_ptr<HardwareCounters> hw);
+
+        //! Set whether the GPU is synchronized in push() and pop()
+        /*! \param sync Set to false to time only the host side of GPU kernel launches
+        */
+        void setSync(bool sync)
+            {
+            m_sync = sync;
+            }
+
     private:
         ClockSource m_clk;  //!< Clock to provide timing information
         std::string m_name; //!< The name of this profile
         ProfileDataElem m_root; //!< The root profile element
         std::stack<ProfileDataElem *> m_stack;  //!< A stack of data elements for the push/pop structure
+        boost::shared_ptr<ProfileTrace> m_trace;    //!< Trace to record events in (may be NULL)
+        boost::shared_ptr<HardwareCounters> m_hw;   //!< Hardware counters to read (may be NULL)
+        bool m_sync;                            //!< True if push() and pop() synchronize the GPU
 
         //! Output helper function
         void output(std::ostream &o);
@@ -205,7 +255,7 @@ inline void Profiler::push(boost::shared_ptr<const ExecutionConfiguration> exec_
     {
 #if defined(ENABLE_CUDA) && !defined(ENABLE_NVTOOLS)
     // nvtools profiling disables synchronization so that async CPU/GPU overlap can be seen
-    if (exec_conf->isCUDAEnabled())
+    if (m_sync && exec_conf->isCUDAEnabled())
         cudaThreadSynchronize();
 #endif
     push(name);
@@ -215,7 +265,7 @@ inline void Profiler::pop(boost::shared_ptr<const ExecutionConfiguration> exec_c
     {
 #if defined(ENABLE_CUDA) && !defined(ENABLE_NVTOOLS)
     // nvtools profiling disables synchronization so that async CPU/GPU overlap can be seen
-    if (exec_conf->isCUDAEnabled())
+    if (m_sync && exec_conf->isCUDAEnabled())
         cudaThreadSynchronize();
 #endif
     pop(flop_count, byte_count);
@@ -239,7 +289,20 @@ inline void Profiler::push(const std::string& name)
     cur->m_children[name].m_start_time = t;
 
     // and updating the stack
-    m_stack.push(&cur->m_children[name]);
+    ProfileDataElem *elem = &cur->m_children[name];
+    m_stack.push(elem);
+
+    if (m_hw)
+        m_hw->read(elem->m_hw_start);
+
+    // record the begin event in the trace
+    elem->m_traced = m_trace && m_trace->isActive();
+    if (elem->m_traced)
+        {
+        if (elem->m_trace_name < 0)
+            elem->m_trace_name = m_trace->getNameIndex(name);
+        m_trace->record(elem->m_trace_name, true);
+        }
 
     #ifdef SCOREP_USER_ENABLE
     // log Score-P region
@@ -271,6 +334,19 @@ inline void Profiler::pop(uint64_t flop_count, uint64_t byte_count)
     cur->m_flop_count += flop_count;
     cur->m_mem_byte_count += byte_count;
 
+    // and the measured hardware counters
+    if (m_hw)
+        {
+        int64_t hw[HardwareCounters::num_counters];
+        m_hw->read(hw);
+        for (unsigned int c = 0; c < HardwareCounters::num_counters; c++)
+            cur->m_hw_count[c] += hw[c] - cur->m_hw_start[c];
+        }
+
+    // record the end event if the begin event was recorded
+    if (cur->m_traced)
+        m_trace->record(cur->m_trace_name, false);
+
     // and finally popping the stack so that the next pop will access the correct element
     m_stack.pop();
     }
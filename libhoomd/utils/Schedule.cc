@@ -0,0 +1,196 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+/*! \file Schedule.cc
+    \brief Defines Schedule and related classes
+*/
+
+#ifdef WIN32
+#pragma warning( push )
+#pragma warning( disable : 4103 4244 )
+#endif
+
+#include "Schedule.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <boost/python.hpp>
+using namespace boost::python;
+using namespace std;
+
+const unsigned int Schedule::never;
+
+/*! \param points_per_decade Number of steps per factor of 10
+*/
+ScheduleLog::ScheduleLog(unsigned int points_per_decade) : m_points_per_decade(points_per_decade)
+    {
+    if (m_points_per_decade == 0)
+        throw runtime_error("Error creating ScheduleLog: points_per_decade must be positive");
+    }
+
+/*! \param k Index of the point
+    \returns round(10^(k/points_per_decade))
+*/
+double ScheduleLog::getPoint(unsigned int k) const
+    {
+    return floor(pow(10.0, double(k) / double(m_points_per_decade)) + 0.5);
+    }
+
+/*! \param step Step relative to the origin
+*/
+unsigned int ScheduleLog::getNextStep(unsigned int step) const
+    {
+    if (step == 0)
+        return 0;
+
+    // start just below the point that is closest to step and walk up
+    double k_est = floor(double(m_points_per_decade) * log10(double(step))) - 1.0;
+    unsigned int k = (k_est > 0.0) ? (unsigned int)k_est : 0;
+
+    double next = getPoint(k);
+    while (next < double(step))
+        next = getPoint(++k);
+
+    if (next >= double(never))
+        return never;
+    return (unsigned int)next;
+    }
+
+/*! \param cycle Length of one cycle
+    \param points_per_decade Number of steps per factor of 10 in each cycle
+*/
+ScheduleLinearLog::ScheduleLinearLog(unsigned int cycle, unsigned int points_per_decade)
+    : m_cycle(cycle), m_log(points_per_decade)
+    {
+    if (m_cycle == 0)
+        throw runtime_error("Error creating ScheduleLinearLog: cycle must be positive");
+    }
+
+/*! \param step Step relative to the origin
+*/
+unsigned int ScheduleLinearLog::getNextStep(unsigned int step) const
+    {
+    unsigned int start = step - step % m_cycle;
+    unsigned int next = m_log.getNextStep(step - start);
+
+    // past the last step of this cycle, the next cycle starts with step 0
+    if (next >= m_cycle)
+        {
+        if (start > never - m_cycle)
+            return never;
+        return start + m_cycle;
+        }
+
+    return start + next;
+    }
+
+/*! \param step Step to add (relative to the origin)
+*/
+void ScheduleList::addStep(unsigned int step)
+    {
+    vector<unsigned int>::iterator i = lower_bound(m_steps.begin(), m_steps.end(), step);
+    if (i == m_steps.end() || *i != step)
+        m_steps.insert(i, step);
+    }
+
+/*! \param step Step relative to the origin
+*/
+unsigned int ScheduleList::getNextStep(unsigned int step) const
+    {
+    vector<unsigned int>::const_iterator i = lower_bound(m_steps.begin(), m_steps.end(), step);
+    if (i == m_steps.end())
+        return never;
+    return *i;
+    }
+
+/*! \param schedule Schedule to add to the union
+*/
+void ScheduleUnion::addSchedule(boost::shared_ptr<Schedule> schedule)
+    {
+    if (!schedule)
+        throw runtime_error("Error adding schedule to ScheduleUnion: schedule is NULL");
+    m_schedules.push_back(schedule);
+    }
+
+/*! \param step Step relative to the origin
+*/
+unsigned int ScheduleUnion::getNextStep(unsigned int step) const
+    {
+    unsigned int next = never;
+    for (unsigned int i = 0; i < m_schedules.size(); i++)
+        next = std::min(next, m_schedules[i]->getNextStep(step));
+    return next;
+    }
+
+void export_Schedule()
+    {
+    class_<Schedule, boost::shared_ptr<Schedule>, boost::noncopyable >("Schedule", no_init)
+    .def("getNextStep", &Schedule::getNextStep);
+
+    class_<ScheduleLog, boost::shared_ptr<ScheduleLog>, bases<Schedule>, boost::noncopyable >
+        ("ScheduleLog", init< unsigned int >());
+
+    class_<ScheduleLinearLog, boost::shared_ptr<ScheduleLinearLog>, bases<Schedule>, boost::noncopyable >
+        ("ScheduleLinearLog", init< unsigned int, unsigned int >());
+
+    class_<ScheduleList, boost::shared_ptr<ScheduleList>, bases<Schedule>, boost::noncopyable >
+        ("ScheduleList", init< >())
+    .def("addStep", &ScheduleList::addStep);
+
+    class_<ScheduleUnion, boost::shared_ptr<ScheduleUnion>, bases<Schedule>, boost::noncopyable >
+        ("ScheduleUnion", init< >())
+    .def("addSchedule", &ScheduleUnion::addSchedule);
+    }
+
+#ifdef WIN32
+#pragma warning( pop )
+#endif
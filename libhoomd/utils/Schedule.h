@@ -0,0 +1,175 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+/*! \file Schedule.h
+    \brief Declares the Schedule and related classes
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#ifndef __SCHEDULE_H__
+#define __SCHEDULE_H__
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+//! Base type for the time steps an analyzer or updater executes on
+/*! A Schedule is a set of time steps, counted from an origin that System sets to the time step the schedule was
+    assigned on. System asks for the next step only when an analyzer or updater executes, and stores the result, so
+    the check on every other step is a single integer compare. This replaces the python callback of a variable period
+    for the common cases.
+
+    Schedules do not keep any state between calls. One schedule can be shared by any number of analyzers and updaters.
+    \ingroup utils
+*/
+class Schedule
+    {
+    public:
+        //! Returned by getNextStep() when there are no more steps
+        static const unsigned int never = 0xffffffff;
+
+        //! Virtual destructor
+        virtual ~Schedule() { }
+
+        //! Get the first step of the schedule at or after a given step
+        /*! \param step Step relative to the origin
+            \returns The first step >= \a step in the schedule (relative to the origin), or never
+        */
+        virtual unsigned int getNextStep(unsigned int step) const = 0;
+    };
+
+//! Logarithmically spaced steps
+/*! Executes on step 0 and on the steps round(10^(k/points_per_decade)) for k = 0, 1, 2, ... Values that round to
+    the same step are executed once, so the first decade holds fewer than \a points_per_decade steps.
+    \ingroup utils
+*/
+class ScheduleLog : public Schedule
+    {
+    public:
+        //! Constructor
+        ScheduleLog(unsigned int points_per_decade);
+
+        //! Get the first step of the schedule at or after a given step
+        virtual unsigned int getNextStep(unsigned int step) const;
+
+    private:
+        unsigned int m_points_per_decade;   //!< Number of steps per factor of 10
+
+        //! Get the k'th point of the sequence
+        double getPoint(unsigned int k) const;
+    };
+
+//! Logarithmically spaced steps in repeated cycles
+/*! The log spaced steps of ScheduleLog are restarted every \a cycle steps: the steps are c*cycle + s for every
+    cycle c and every ScheduleLog step s < cycle. This samples time differences on a log scale, with many time
+    origins, as needed for mean squared displacements and time correlation functions.
+    \ingroup utils
+*/
+class ScheduleLinearLog : public Schedule
+    {
+    public:
+        //! Constructor
+        ScheduleLinearLog(unsigned int cycle, unsigned int points_per_decade);
+
+        //! Get the first step of the schedule at or after a given step
+        virtual unsigned int getNextStep(unsigned int step) const;
+
+    private:
+        unsigned int m_cycle;   //!< Length of one cycle
+        ScheduleLog m_log;      //!< Steps within a cycle
+    };
+
+//! An explicit list of steps
+/*! The steps may be given in any order, duplicates are ignored.
+    \ingroup utils
+*/
+class ScheduleList : public Schedule
+    {
+    public:
+        //! Constructs an empty list
+        ScheduleList() { }
+
+        //! Add a step
+        void addStep(unsigned int step);
+
+        //! Get the first step of the schedule at or after a given step
+        virtual unsigned int getNextStep(unsigned int step) const;
+
+    private:
+        std::vector<unsigned int> m_steps;  //!< Sorted steps
+    };
+
+//! The union of several schedules
+/*! Executes on every step that any of its schedules executes on.
+    \ingroup utils
+*/
+class ScheduleUnion : public Schedule
+    {
+    public:
+        //! Constructs an empty union
+        ScheduleUnion() { }
+
+        //! Add a schedule
+        void addSchedule(boost::shared_ptr<Schedule> schedule);
+
+        //! Get the first step of the schedule at or after a given step
+        virtual unsigned int getNextStep(unsigned int step) const;
+
+    private:
+        std::vector< boost::shared_ptr<Schedule> > m_schedules;  //!< The schedules
+    };
+
+//! Exports Schedule* classes to python
+void export_Schedule();
+
+#endif
@@ -85,6 +85,7 @@ from hoomd_script import sorter;
 from hoomd_script import update;
 from hoomd_script import wall;
 from hoomd_script import variant;
+from hoomd_script import schedule;
 from hoomd_script import tune;
 from hoomd_script import hoomd;
 from hoomd_script import compute;
@@ -199,6 +200,9 @@ def get_hoomd_script_version():
 # once at the end of the run. Otherwise the callback is executed whenever the current
 # time step number is a multiple of \a callback_period.
 #
+# Use data.particle_data.host_arrays() in the callback to analyze or modify many particles at once. The arrays
+# must be released before the callback returns.
+#
 def run(tsteps, profile=False, limit_hours=None, limit_multiple=1, callback_period=0, callback=None, quiet=False):
     if not quiet:
         _util.print_status_line();
@@ -217,6 +221,21 @@ def run(tsteps, profile=False, limit_hours=None, limit_multiple=1, callback_peri
     # update autotuner parameters
     globals.system.setAutotunerParams(globals.options.autotuner_enable, int(globals.options.autotuner_period));
 
+    # update the trace of profiled events
+    trace_filename = globals.options.trace_filename;
+    if trace_filename is None:
+        trace_filename = '';
+    globals.system.setTraceParams(trace_filename,
+                                  globals.options.trace_format == 'binary',
+                                  globals.options.trace_period,
+                                  globals.options.trace_block_size);
+
+    # update the hardware counters read in profiled runs
+    vector_fp_event = globals.options.profile_vector_fp_event;
+    if vector_fp_event is None:
+        vector_fp_event = 0;
+    globals.system.setHardwareCounters(globals.options.profile_counters, int(vector_fp_event));
+
     # if rigid bodies, setxv
     if len(data.system_data(globals.system_definition).bodies) > 0:
         data.system_data(globals.system_definition).bodies.updateRV()
@@ -237,6 +256,15 @@ def run(tsteps, profile=False, limit_hours=None, limit_multiple=1, callback_peri
     if limit_hours is None:
         limit_hours = 0.0
 
+    # particle arrays held by python cannot be accessed by the simulation
+    data._check_host_arrays();
+    if callback is not None:
+        user_callback = callback;
+        def callback(step):
+            rv = user_callback(step);
+            data._check_host_arrays();
+            return rv;
+
     if not quiet:
         globals.msg.notice(1, "** starting run **\n");
     globals.system.run(int(tsteps), callback_period, callback, limit_hours, int(limit_multiple));
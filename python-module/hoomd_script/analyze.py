@@ -54,6 +54,7 @@ from hoomd_script import globals;
 import sys;
 from hoomd_script import util;
 from hoomd_script import init;
+from hoomd_script import schedule;
 
 ## \package hoomd_script.analyze
 # \brief Commands that %analyze the system and provide some output
@@ -111,6 +112,56 @@ from hoomd_script import init;
 # Consequently, any analyze, dump, or update command given a variable period becomes ill-defined if it is disabled and then re-enabled.
 # If this is done, it will then re-enable with a constant period of 1000 as a default case.
 #
+# <b>Native schedules</b>
+#
+# The python function is called every time the analyzer executes. For the common cases of log spaced steps,
+# log spaced steps in repeated cycles, and explicit lists of steps, pass a schedule from hoomd_script.schedule
+# instead. Schedules are evaluated in C++ and also count from the time step when the analyzer is created.
+# \code
+# dump.xml(filename="dump", period = schedule.log(points_per_decade=1))
+# \endcode
+# results in dump files 0, 1, 10, 100, 1000, ... time steps after the analyzer is created. Unlike
+# <tt>lambda n: 10**n</tt>, which skips from the first dump to 10 time steps later, it also dumps 1 step after the
+# first.
+#
+# A schedule is dropped in the same way when the command is disabled: after enable() it runs with a constant period
+# of 1000. Pass the schedule to set_period() again to restore it.
+#
+
+## Write analysis output asynchronously
+#
+# \param num_threads Number of worker threads that write analysis output (0 disables asynchronous analysis)
+# \param max_queue Maximum number of pending outputs before the simulation waits for the writers to catch up
+#
+# By default, every analyzer (and dump) performs its full analysis and file output inside the time step loop,
+# so the simulation stalls while output is written. After set_async() is called, analyzers that support it
+# (currently analyze.msd, dump.dcd and dump.xml) take a snapshot of the system during the time step loop and hand
+# off the calculations, formatting and writing of the output to \a num_threads worker threads. The simulation
+# continues while the output is written. Outputs from a single analyzer are always written in order. All pending
+# output is written before run() returns. Analyzers that do not support asynchronous analysis run as before.
+#
+# Each pending output holds a copy of the data it writes. \a max_queue limits the memory used when the
+# writers cannot keep up with the simulation.
+#
+# \b Examples:
+# \code
+# analyze.set_async()
+# analyze.set_async(num_threads=2, max_queue=8)
+# analyze.set_async(num_threads=0)
+# \endcode
+#
+# \note An error in an asynchronous analyzer is reported at the next time step it executes, or at the end of the run.
+#
+# \warning set_async() must be called after the system is initialized.
+def set_async(num_threads=1, max_queue=4):
+    util.print_status_line();
+
+    # check that we have been initialized properly
+    if not init.is_initialized():
+        globals.msg.error("Cannot set asynchronous analysis before initialization\n");
+        raise RuntimeError('Error setting asynchronous analysis');
+
+    globals.system.setAnalyzerThreads(int(num_threads), int(max_queue));
 
 ## \internal
 # \brief Base class for analyzers
@@ -148,7 +199,8 @@ class _analyzer:
     #
     # If an integer is specified, then that is set as the period for the analyzer.
     # If a callable is passed in as a period, then a default period of 1000 is set
-    # to the integer period and the variable period is enabled
+    # to the integer period and the variable period is enabled. A schedule from hoomd_script.schedule
+    # is set the same way, but is evaluated in C++.
     #
     def setupAnalyzer(self, period):
         if type(period) == type(1.0):
@@ -158,6 +210,9 @@ class _analyzer:
         elif type(period) == type(lambda n: n*2):
             globals.system.addAnalyzer(self.cpp_analyzer, self.analyzer_name, 1000);
             globals.system.setAnalyzerPeriodVariable(self.analyzer_name, period);
+        elif isinstance(period, schedule._schedule):
+            globals.system.addAnalyzer(self.cpp_analyzer, self.analyzer_name, 1000);
+            globals.system.setAnalyzerSchedule(self.analyzer_name, period.cpp_schedule);
         else:
             globals.msg.error("I don't know what to do with a period of type " + str(type(period)) + " expecting an int or a function\n");
             raise RuntimeError('Error creating analyzer');
@@ -250,6 +305,7 @@ class _analyzer:
     #
     # While the simulation is \ref run() "running", the action of each analyzer
     # is executed every \a period time steps.
+    # \a period may also be a schedule from hoomd_script.schedule, which is counted from the current time step.
     #
     # To use this command, you must have saved the analyzer in a variable, as
     # shown in this example:
@@ -268,6 +324,11 @@ class _analyzer:
                 self.prev_period = period;
         elif type(period) == type(lambda n: n*2):
             globals.msg.warning("A period cannot be changed to a variable one");
+        elif isinstance(period, schedule._schedule):
+            if self.enabled:
+                globals.system.setAnalyzerSchedule(self.analyzer_name, period.cpp_schedule);
+            else:
+                globals.msg.warning("A schedule cannot be set on a disabled analyzer");
         else:
             globals.msg.warning("I don't know what to do with a period of type " + str(type(period)) + " expecting an int or a function");
 
@@ -429,6 +490,7 @@ class log(_analyzer):
     # \param header_prefix (optional) Specify a string to print before the header
     # \param overwrite When False (the default) an existing log will be appended to.
     #                  If True, an existing log file will be overwritten instead.
+    # \param binary When True, the log is written in a binary format instead of delimited text
     #
     # \b Examples:
     # \code
@@ -445,6 +507,8 @@ class log(_analyzer):
     #             period=10, header_prefix='Log of harmonic energy, run 5\n')
     # logger = analyze.log(filename='mylog.log', period=100,
     #                      quantities=['pair_lj_energy'], overwrite=True)
+    # analyze.log(filename='mylog.bin', quantities=['pair_lj_energy', 'kinetic_energy'],
+    #             period=10, binary=True)
     # \endcode
     #
     # By default, columns in the log file are separated by tabs, suitable for importing as a
@@ -460,15 +524,24 @@ class log(_analyzer):
     # remain consistent with the header already in the file, you must specify the same quantities
     # to log and in the same order for all runs of hoomd that append to the same log.
     #
+    # With \a binary=True, every row is written in fixed width native byte order fields, which avoids the cost of
+    # formatting text: the time step (uint32) followed by each quantity (double). In place of the header line, a
+    # single schema block starts a new file: the characters \c HOOMDLOG, the format version (uint32, currently 2), the
+    # header prefix, the number of columns (uint32, including the time step) and the name of each column, where each
+    # string is written as its length (uint32) followed by its characters. The delimiter is ignored in binary mode.
+    # The schema is not repeated, so the quantities of a binary log cannot be changed with set_params().
+    # When a binary log is appended to, the schema already in the file is read back, and an error is raised unless it
+    # has the same version, \a header_prefix and quantities.
+    #
     # \a period can be a function: see \ref variable_period_docs for details
-    def __init__(self, filename, quantities, period, header_prefix='', overwrite=False):
+    def __init__(self, filename, quantities, period, header_prefix='', overwrite=False, binary=False):
         util.print_status_line();
 
         # initialize base class
         _analyzer.__init__(self);
 
         # create the c++ mirror class
-        self.cpp_analyzer = hoomd.Logger(globals.system_definition, filename, header_prefix, overwrite);
+        self.cpp_analyzer = hoomd.Logger(globals.system_definition, filename, header_prefix, overwrite, binary);
         self.setupAnalyzer(period);
 
         # set the logged quantities
@@ -484,6 +557,8 @@ class log(_analyzer):
     #
     # \param quantities New list of quantities to log (if specified)
     # \param delimiter New delimiter between columns in the output file (if specified)
+    # \param flush_period Number of rows written between flushes of the output file (if specified)
+    # \param history Number of recent rows kept in memory for query_history() (if specified)
     #
     # Using set_params() requires that the specified logger was saved in a variable when created.
     # i.e.
@@ -498,8 +573,16 @@ class log(_analyzer):
     # logger.set_params(quantities=['bond_harmonic_energy'])
     # logger.set_params(delimiter=',');
     # logger.set_params(quantities=['bond_harmonic_energy'], delimiter=',');
+    # logger.set_params(flush_period=100, history=1000);
     # \endcode
-    def set_params(self, quantities=None, delimiter=None):
+    #
+    # By default, the output file is flushed after every row. A larger \a flush_period lets the operating system
+    # buffer the output, at the cost of losing up to \a flush_period rows if the simulation is killed.
+    #
+    # Setting \a history discards the rows currently kept in memory. Changing \a quantities discards them as well.
+    #
+    # The \a quantities of a log written with \a binary=True cannot be changed.
+    def set_params(self, quantities=None, delimiter=None, flush_period=None, history=None):
         util.print_status_line();
 
         if quantities is not None:
@@ -512,6 +595,18 @@ class log(_analyzer):
         if delimiter:
             self.cpp_analyzer.setDelimiter(delimiter);
 
+        if flush_period is not None:
+            if flush_period <= 0:
+                globals.msg.error("analyze.log: flush_period must be positive\n");
+                raise RuntimeError('Error setting log parameters');
+            self.cpp_analyzer.setFlushPeriod(int(flush_period));
+
+        if history is not None:
+            if history < 0:
+                globals.msg.error("analyze.log: history must not be negative\n");
+                raise RuntimeError('Error setting log parameters');
+            self.cpp_analyzer.setHistorySize(int(history));
+
     ## Retrieve a cached value of a monitored quantity from the last update of the logger.
     # \param quantity Name of the quantity to return.
     #
@@ -531,6 +626,26 @@ class log(_analyzer):
         # retrieve data from internal cache.
         return self.cpp_analyzer.getCachedQuantity(quantity);
 
+    ## Retrieve the recent values of a monitored quantity
+    # \param quantity Name of the quantity to return.
+    #
+    # \returns A list of the values of \a quantity in the rows kept in memory, from oldest to most recent
+    #
+    # The number of rows kept in memory is set with set_params(history=...). No computes are evaluated.
+    #
+    # \b Examples:
+    # \code
+    # logger.set_params(history=100)
+    # run(1000)
+    # energies = logger.query_history('potential_energy')
+    # steps = logger.query_history('timestep')
+    # \endcode
+    def query_history(self, quantity):
+        if quantity == 'timestep':
+            return [self.cpp_analyzer.getHistoryTimestep(i) for i in range(self.cpp_analyzer.getNumHistory())];
+
+        return [self.cpp_analyzer.getHistoryQuantity(quantity, i) for i in range(self.cpp_analyzer.getNumHistory())];
+
     ## \internal
     # \brief Re-registers all computes and updaters with the logger
     def update_quantities(self):
@@ -170,6 +170,8 @@ class pppm(force._force):
     # \param Nz - Number of grid points in z direction
     # \param order - Number of grid points in each direction to assign charges to
     # \param rcut  -  Cutoff for the short-ranged part of the electrostatics calculation
+    # \param fast_erfc - Set to True to evaluate the short-ranged part with a fast erfc approximation
+    #                     (see pair.ewald.set_params())
     #
     # Using set_params() requires that the specified PPPM force has been saved in a variable. i.e.
     # \code
@@ -183,7 +185,7 @@ class pppm(force._force):
     # Note that the Fourier transforms are much faster for number of grid points of the form 2^N
     # The parameters for PPPM  must be set
     # before the run() can be started.
-    def set_params(self, Nx, Ny, Nz, order, rcut):
+    def set_params(self, Nx, Ny, Nz, order, rcut, fast_erfc=False):
         util.print_status_line();
 
         if globals.system_definition.getNDimensions() != 3:
@@ -246,6 +248,7 @@ class pppm(force._force):
         for i in range(0,ntypes):
             for j in range(0,ntypes):
                 self.ewald.pair_coeff.set(type_list[i], type_list[j], kappa = kappa, r_cut=rcut)
+        self.ewald.set_params(fast_erfc=fast_erfc);
         util._disable_status_lines = False;
 
         # set the parameters for the appropriate type
@@ -50,9 +50,15 @@
 # Maintainer: joaander
 
 import hoomd
+import weakref
 from hoomd_script import globals
 from hoomd_script import util
 
+try:
+    import numpy;
+except ImportError:
+    numpy = None;
+
 ## \package hoomd_script.data
 # \brief Access particles, bonds, and other state information inside scripts
 #
@@ -314,6 +320,30 @@ from hoomd_script import util
 # If you need to store some particle properties at one time in the simulation and access them again later, you will need
 # to make copies of the actual property values themselves and not of the proxy references.
 #
+# \section data_host_arrays Bulk access with numpy
+# <hr>
+# <h3>Bulk access with numpy</h3>
+#
+# Each property access through a particle proxy calls into C++ for a single particle, which is slow for analysis of
+# many particles. particle_data.host_arrays() instead provides numpy arrays that point directly at the particle %data
+# in memory, without any copies. numpy is required to use it.
+# \code
+# with system.particles.host_arrays() as arrays:
+#     com = numpy.mean(arrays.position[:,0:3], axis=0);
+#     arrays.velocity[:,0:3] *= 0.5;
+#     arrays.set_positions(new_positions);
+# \endcode
+#
+# The arrays are valid only inside the \c with block. They hold the particles local to this rank, in their current
+# memory order, which changes during a run(). Use \c arrays.tag and \c arrays.rtag to map between memory indices
+# and particle tags. The \c with block must end before the simulation continues, so it can be used inside a
+# run() callback but not around a run() command. Particle proxies and snapshots cannot be used inside the \c with
+# block. See particle_host_arrays for the available arrays.
+#
+# In MPI simulations with more than one domain, particles are not migrated between ranks while the arrays are held.
+# set_positions() raises an error there, and positions written to the \c position array must stay inside the local
+# domain. Set the position of a particle proxy to move particles to other domains.
+#
 # \section data_snapshot Snapshots
 # <hr>
 # <h3>Snapshots</h3>
@@ -750,6 +780,14 @@ class particle_data:
     def __len__(self):
         return self.pdata.getNGlobal();
 
+    ## Get numpy arrays of the local particle %data
+    #
+    # \returns A particle_host_arrays that holds the arrays until it is released
+    #
+    # See \ref data_host_arrays for details.
+    def host_arrays(self):
+        return particle_host_arrays(self.pdata);
+
     ## \internal
     # \brief Get an informal string representing the object
     def __str__(self):
@@ -761,6 +799,136 @@ class particle_data:
     def __iter__(self):
         return particle_data.particle_data_iterator(self);
 
+## \internal
+# \brief All particle_host_arrays that have not been garbage collected
+#
+# An access that is collected without release() frees the arrays in its destructor and drops out of the set.
+_host_arrays = weakref.WeakSet();
+
+## Direct numpy access to the local particle arrays
+#
+# particle_host_arrays is returned by particle_data.host_arrays(). See \ref data_host_arrays for an example.
+#
+# The following numpy arrays are available while the access is held:
+# - \c position  : N x 4 array. Columns 0-2 are the positions (in distance units). Column 3 stores the type id in
+#                  the bits of the value and must not be modified.
+# - \c velocity  : N x 4 array. Columns 0-2 are the velocities (in velocity units), column 3 is the mass (in mass units).
+# - \c net_force : N x 4 array. Columns 0-2 are the net forces (in force units), column 3 is the net energy
+#                  (in energy units).
+# - \c tag       : N array of the tag of the particle at each index (read only)
+# - \c rtag      : Array of the index of each particle tag (read only). Tags of particles that are not local to this
+#                  rank map to an index >= N.
+#
+# Positions and velocities may be modified in place. Positions written directly must stay inside the box:
+# set_positions() wraps them into the box.
+#
+# \warning The arrays point at memory owned by the simulation. Do not keep a reference to any of them (or to a numpy
+# view of them) past release(): an array used after release() silently reads or writes whatever the memory holds at
+# that time. On python 3, release() invalidates the underlying buffers and prints a warning if an array still
+# references one of them. On python 2 this cannot be detected.
+class particle_host_arrays:
+    ## \internal
+    # \brief Acquire the arrays
+    #
+    # \param pdata ParticleData to access
+    def __init__(self, pdata):
+        if numpy is None:
+            globals.msg.error("numpy is required for particle_data.host_arrays()\n");
+            raise RuntimeError('Error accessing particle data');
+
+        self.cpp_access = hoomd.ParticleDataHostAccess(pdata);
+        _host_arrays.add(self);
+
+        # memoryviews (python 3) that are invalidated on release()
+        self._buffers = [];
+
+        if self.cpp_access.getScalarSize() == 8:
+            self.scalar_type = numpy.float64;
+        else:
+            self.scalar_type = numpy.float32;
+        self.N = self.cpp_access.getN();
+
+        self.position = self._wrap(self.cpp_access.getPositions(), self.scalar_type, (self.N, 4), True);
+        self.velocity = self._wrap(self.cpp_access.getVelocities(), self.scalar_type, (self.N, 4), True);
+        self.net_force = self._wrap(self.cpp_access.getNetForces(), self.scalar_type, (self.N, 4), True);
+        self.tag = self._wrap(self.cpp_access.getTags(), numpy.uint32, (self.N,), False);
+        self.rtag = self._wrap(self.cpp_access.getRTags(), numpy.uint32, None, False);
+
+    ## \internal
+    # \brief Create a numpy view of a buffer
+    def _wrap(self, buf, dtype, shape, writeable):
+        if hasattr(buf, 'release'):
+            self._buffers.append(buf);
+
+        if len(buf) == 0:
+            a = numpy.zeros(0, dtype=dtype);
+        else:
+            a = numpy.frombuffer(buf, dtype=dtype);
+        if shape is not None:
+            a = a.reshape(shape);
+        if not writeable:
+            a.flags.writeable = False;
+        return a;
+
+    ## \internal
+    # \brief Start a with block
+    def __enter__(self):
+        return self;
+
+    ## \internal
+    # \brief End a with block
+    def __exit__(self, exc_type, exc_value, traceback):
+        self.release();
+        return False;
+
+    ## Release the arrays
+    #
+    # The numpy arrays must not be used after release() is called. Leaving the \c with block calls release().
+    def release(self):
+        # drop the arrays first, so that only arrays still referenced elsewhere keep a buffer exported
+        self.position = None;
+        self.velocity = None;
+        self.net_force = None;
+        self.tag = None;
+        self.rtag = None;
+
+        still_referenced = False;
+        for buf in self._buffers:
+            try:
+                buf.release();
+            except BufferError:
+                still_referenced = True;
+        self._buffers = [];
+
+        self.cpp_access.release();
+
+        if still_referenced:
+            globals.msg.warning("particle_data.host_arrays(): arrays are still referenced after release(), they must not be used\n");
+
+    ## Set the positions of all local particles
+    #
+    # \param values N x 3 array of positions, in the same order as the \c position array (in distance units)
+    #
+    # Positions are wrapped into the box. Image flags are not changed. Not available in MPI simulations with more than
+    # one domain, because the particles cannot migrate to other ranks.
+    def set_positions(self, values):
+        v = numpy.ascontiguousarray(values, dtype=self.scalar_type);
+        self.cpp_access.setPositions(v.reshape(-1));
+
+    ## Set the velocities of all local particles
+    #
+    # \param values N x 3 array of velocities, in the same order as the \c velocity array (in velocity units)
+    def set_velocities(self, values):
+        v = numpy.ascontiguousarray(values, dtype=self.scalar_type);
+        self.cpp_access.setVelocities(v.reshape(-1));
+
+## \internal
+# \brief Check that no particle_host_arrays are held before the simulation continues
+def _check_host_arrays():
+    if any(a.cpp_access.isActive() for a in list(_host_arrays)):
+        globals.msg.error("particle_data.host_arrays() must be released before the simulation continues\n");
+        raise RuntimeError('Error running');
+
 ## Access a single particle via a proxy
 #
 # particle_data_proxy provides access to all of the properties of a single particle in the system.
@@ -246,6 +246,9 @@ class xml(analyze._analyzer):
     # \note When \a time_step is None, the current system time step is written to the file. When specified,
     #       \a time_step overrides this value.
     #
+    # If \a filename ends in \c .gz and hoomd was built with zlib, the file is gzip compressed, with the compression
+    # spread over all cores of the machine. init.read_xml() reads such files directly.
+    #
     # Executing write() requires that the %dump was saved in a variable when it was specified.
     # \code
     # xml = dump.xml()
@@ -255,6 +258,7 @@ class xml(analyze._analyzer):
     # \code
     # xml.write(filename="start.xml")
     # xml.write(filename="start.xml", time_step=0)
+    # xml.write(filename="start.xml.gz")
     # \endcode
     def write(self, filename, time_step = None):
         util.print_status_line();
@@ -300,7 +304,8 @@ class bin(analyze._analyzer):
     # \c particles.0000000000.bin (.gz if \a compress = True)
     #
     # If \a compress is True (the default), output will be gzip compressed for a significant savings. init.read_bin()
-    # will auto-detect whether or not the %data needs to be decompressed by the ".gz" file extension.
+    # will auto-detect whether or not the %data needs to be decompressed by the ".gz" file extension. The %data is
+    # compressed in blocks on all cores of the machine, so compression does not slow down the simulation as much.
     #
     # If \a file1 and \a file2 are specified, then the output is written every \a period time steps alternating
     # between those two files. This use-case is useful when only the most recent state of the system is needed
@@ -393,6 +398,82 @@ class bin(analyze._analyzer):
 
         self.cpp_analyzer.writeFile(filename, globals.system.getCurrentTimeStep());
 
+## Writes simulation snapshots to an indexed binary trajectory
+#
+# Every \a period time steps, a frame is appended to a single file. Each frame is stored as a set of
+# independently compressed per-field chunks and the file ends with an index of all frames, so
+# init.read_indexed() (and analysis tools) can jump straight to any frame and decode only the fields they need,
+# instead of reading the file from the start.
+#
+# \b Examples:
+# \code
+# dump.indexed(filename="trajectory.hidx", period=1000)
+# dump.indexed(filename="restart.hidx", period=1e5, fields=['position', 'velocity', 'image', 'integrator'])
+# idx = dump.indexed(filename="trajectory.hidx", period=1000, compress=False, overwrite=True)
+# \endcode
+#
+# \a fields selects the per-particle and topology fields to write. Valid names are \b position, \b velocity,
+# \b acceleration, \b type, \b mass, \b charge, \b diameter, \b image, \b body, \b orientation,
+# \b moment_inertia, \b bond, \b angle, \b dihedral, \b improper and \b integrator (the internal state of the
+# integration methods). All of them are written when \a fields is None. The time step and box are always written.
+#
+# If \a compress is True (the default) and hoomd was built with zlib, each chunk is compressed with the fastest
+# zlib level. If \a overwrite is False (the default), frames are appended to an existing file, so a restarted job
+# continues the same trajectory. A file left incomplete by a job killed while writing is repaired when it is
+# opened again.
+#
+# \note Rigid body and wall data are not written.
+#
+# \a period can be a function: see \ref variable_period_docs for details
+#
+# \sa init.read_indexed
+# \MPI_SUPPORTED
+class indexed(analyze._analyzer):
+    ## Initialize the indexed writer
+    #
+    # \param filename File name to write
+    # \param period (optional) Number of time steps between frames
+    # \param fields (optional) List of fields to write (all of them if None)
+    # \param compress Set to False to disable compression
+    # \param overwrite Set to True to replace an existing file instead of appending to it
+    def __init__(self, filename, period=None, fields=None, compress=True, overwrite=False):
+        util.print_status_line();
+
+        # initialize base class
+        analyze._analyzer.__init__(self);
+
+        # create the c++ mirror class
+        self.cpp_analyzer = hoomd.HOOMDIndexedDumpWriter(globals.system_definition, filename, overwrite);
+        self.cpp_analyzer.enableCompression(compress);
+
+        if fields is not None:
+            for f in ['position', 'velocity', 'acceleration', 'type', 'mass', 'charge', 'diameter', 'image', 'body',
+                      'orientation', 'moment_inertia', 'bond', 'angle', 'dihedral', 'improper', 'integrator']:
+                self.cpp_analyzer.setOutputField(f, False);
+            for f in fields:
+                self.cpp_analyzer.setOutputField(f, True);
+
+        if period is not None:
+            self.setupAnalyzer(period);
+            self.enabled = True;
+            self.prev_period = 1;
+        else:
+            self.enabled = False;
+
+    ## Append a frame at the current time step
+    #
+    # The periodic writes can be supplemented with frames written at any time step.
+    #
+    # \b Examples:
+    # \code
+    # idx.write()
+    # \endcode
+    def write(self):
+        util.print_status_line();
+        self.check_initialization();
+
+        self.cpp_analyzer.analyze(globals.system.getCurrentTimeStep());
+
 ## Writes a simulation snapshot in the MOL2 format
 #
 # Every \a period time steps, a new file will be created. The state of the
@@ -560,6 +641,53 @@ class dcd(analyze._analyzer):
         raise RuntimeError('Error changing updater period');
 
 
+## Writes particle positions to a lossy compressed trajectory
+#
+# Every \a period time steps, the unwrapped positions of the particles in \a group are rounded to a multiple of
+# \a precision and appended to \a filename. Each coordinate is predicted from the neighboring particle or from the
+# previous frames, whichever is cheapest, and the prediction error is entropy coded. Trajectories of dense fluids
+# typically take a quarter of the space of the equivalent DCD file at a precision of 1e-3 distance units.
+#
+# Every \a key_interval frames, a key frame that does not depend on earlier frames is written so that a reader can
+# seek into the file without decoding it from the start. Use hoomd.CompressedTrajectoryReader to read the file back.
+#
+# Only positions and the box are stored. Use in conjunction with dump.xml to record the particle types and topology.
+#
+# \MPI_SUPPORTED
+class compressed(analyze._analyzer):
+    ## Initialize the compressed trajectory writer
+    #
+    # \param filename File name to write
+    # \param period Number of time steps between frames
+    # \param group Particle group to write. If left as None, all particles will be written
+    # \param precision Quantization step in distance units. Positions read back are within \a precision / 2 of the
+    #        written ones.
+    # \param overwrite When False (the default), an existing file is appended to. When True, it is overwritten.
+    # \param key_interval Number of frames between key frames
+    #
+    # \b Examples:
+    # \code
+    # dump.compressed(filename="trajectory.qtr", period=1000)
+    # qtr = dump.compressed(filename="trajectory.qtr", period=100, precision=1e-2, key_interval=50)
+    # \endcode
+    #
+    # \a period can be a function: see \ref variable_period_docs for details
+    def __init__(self, filename, period, group=None, precision=1e-3, overwrite=False, key_interval=100):
+        util.print_status_line();
+
+        # initialize base class
+        analyze._analyzer.__init__(self);
+
+        if group is None:
+            util._disable_status_lines = True;
+            group = hs_group.all();
+            util._disable_status_lines = False;
+
+        # create the c++ mirror class
+        self.cpp_analyzer = hoomd.CompressedDumpWriter(globals.system_definition, filename, group.cpp_group, float(precision), overwrite);
+        self.cpp_analyzer.setKeyFrameInterval(int(key_interval));
+        self.setupAnalyzer(period);
+
 ## Writes simulation snapshots in the PBD format
 #
 # Every \a period time steps, a new file will be created. The state of the
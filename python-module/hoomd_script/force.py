@@ -99,6 +99,7 @@ class _force:
         self.force_name = "force%d" % (id);
         self.enabled = True;
         self.log =True;
+        self.respa_period = 1;
         globals.forces.append(self);
 
     ## \var enabled
@@ -224,6 +225,35 @@ class _force:
         self.enabled = True;
         self.log = True;
 
+    ## Evaluates the force only every few time steps
+    # \param period Number of time steps between evaluations of the force
+    #
+    # \b Examples:
+    # \code
+    # pppm = charge.pppm(group=charged)
+    # pppm.set_respa(period=4)
+    # \endcode
+    #
+    # Forces that vary slowly in time, such as long range electrostatics, can be evaluated less often than the
+    # stiff bonded forces that limit the time step. integrate.mode_standard applies a force with \a period larger
+    # than 1 as an impulse of \a period * dt / 2 at the start and end of every \a period steps (r-RESPA multiple time
+    # step integration), while all other forces are evaluated every step. The intervals are counted from the start of
+    # the run, or continue those of the previous run if it ended in the middle of one. Between evaluations, the energy
+    # and virial of the force keep their last computed values in logged quantities.
+    #
+    # Use periods that divide each other when setting more than one slow force. Setting \a period back to 1
+    # evaluates the force every time step again. Slow forces are not supported with rigid bodies or energy
+    # minimization.
+    def set_respa(self, period):
+        util.print_status_line();
+        self.check_initialization();
+
+        if int(period) < 1:
+            globals.msg.error("The RESPA period must be at least 1\n");
+            raise RuntimeError('Error setting RESPA period');
+
+        self.respa_period = int(period);
+
     ## \internal
     # \brief updates force coefficients
     def update_coeffs(self):
@@ -144,10 +144,13 @@ class group:
     #
     # \param name Name of the group
     # \param cpp_group an instance of hoomd.ParticleData that defines the group
-    def __init__(self, name, cpp_group):
+    # \param cpp_selector the hoomd.ParticleSelector the group was built from (None for groups built from a list of
+    #        tags or from other groups)
+    def __init__(self, name, cpp_group, cpp_selector=None):
         # initialize the group
         self.name = name;
         self.cpp_group = cpp_group;
+        self.cpp_selector = cpp_selector;
 
     ## \internal
     # \brief Get a particle_proxy reference to the i'th particle in the group
@@ -250,7 +253,7 @@ def all():
 # xmin <= x < xmax (and so forth for y and z) so that directly adjacent cuboids do not have overlapping group members.
 #
 # Group membership is \b static and determined at the time the group is created. As the simulation runs, particles
-# may move outside of the defined cuboid.
+# may move outside of the defined cuboid. Use update.group_select to re-evaluate the membership periodically.
 #
 # The group can then be used by other hoomd_script commands (such as analyze.msd) to specify which particles should be
 # operated on.
@@ -303,7 +306,7 @@ def cuboid(name, xmin=None, xmax=None, ymin=None, ymax=None, zmin=None, zmax=Non
     globals.msg.notice(2, 'Group "' + name + '" created containing ' + str(cpp_group.getNumMembersGlobal()) + ' particles\n');
 
     # return it in the wrapper class
-    return group(name, cpp_group);
+    return group(name, cpp_group, selector);
 
 ## Groups particles that do not belong to rigid bodies
 #
@@ -337,7 +340,7 @@ def nonrigid():
     globals.msg.notice(2, 'Group "' + name + '" created containing ' + str(cpp_group.getNumMembersGlobal()) + ' particles\n');
 
     # return it in the wrapper class
-    return group(name, cpp_group);
+    return group(name, cpp_group, selector);
 
 ## Groups particles that belong to rigid bodies
 #
@@ -371,7 +374,7 @@ def rigid():
     globals.msg.notice(2, 'Group "' + name + '" created containing ' + str(cpp_group.getNumMembersGlobal()) + ' particles\n');
 
     # return it in the wrapper class
-    return group(name, cpp_group);
+    return group(name, cpp_group, selector);
 
 ## Groups particles by tag
 #
@@ -421,7 +424,7 @@ def tags(tag_min, tag_max=None, name=None):
     globals.msg.notice(2, 'Group "' + name + '" created containing ' + str(cpp_group.getNumMembersGlobal()) + ' particles\n');
 
     # return it in the wrapper class
-    return group(name, cpp_group);
+    return group(name, cpp_group, selector);
 
 ## Groups particles by tag list
 #
@@ -501,6 +504,7 @@ def type(type, name=None):
         globals.msg.warning(str(type) + " does not exist in the system, creating an empty group\n");
         cpp_list = hoomd.std_vector_uint();
         cpp_group = hoomd.ParticleGroup(globals.system_definition, cpp_list);
+        selector = None;
     else:
         type_id = globals.system_definition.getParticleData().getTypeByName(type);
         selector = hoomd.ParticleSelectorType(globals.system_definition, type_id, type_id);
@@ -510,7 +514,7 @@ def type(type, name=None):
     globals.msg.notice(2, 'Group "' + name + '" created containing ' + str(cpp_group.getNumMembersGlobal()) + ' particles\n');
 
     # return it in the wrapper class
-    return group(name, cpp_group);
+    return group(name, cpp_group, selector);
 
 
 ## Groups particles that are charged
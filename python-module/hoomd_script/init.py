@@ -358,6 +358,67 @@ def read_bin(filename, time_step = None):
     _perform_common_init_tasks();
     return data.system_data(globals.system_definition);
 
+## Reads initial system state from a frame of an indexed binary file
+#
+# \param filename File to read
+# \param frame Index of the frame to read. Negative values count back from the last frame.
+# \param fields (optional) List of fields to read. All fields in the file are read if None.
+# \param time_step (if specified) Time step number to use instead of the one stored in the file
+#
+# \b Examples:
+# \code
+# init.read_indexed(filename="trajectory.hidx")
+# init.read_indexed(filename="trajectory.hidx", frame=10000)
+# system = init.read_indexed(filename="restart.hidx", fields=['velocity', 'image', 'integrator'], time_step=0)
+# \endcode
+#
+# Indexed files are written by dump.indexed. Only the index of the file and the chunks of the requested frame and
+# fields are read, so reading the last frame of a long trajectory is as fast as reading the first. Particle
+# positions and types are always read. Fields that are not read (or that are not in the file) take their
+# default values.
+#
+# The result of init.read_indexed can be saved in a variable and later used to read and/or change particle
+# properties later in the script. See hoomd_script.data for more information.
+#
+# \sa dump.indexed
+# \MPI_SUPPORTED
+def read_indexed(filename, frame=-1, fields=None, time_step = None):
+    util.print_status_line();
+
+    # initialize GPU/CPU execution configuration and MPI early
+    my_exec_conf = _create_exec_conf();
+
+    # check if initialization has already occurred
+    if is_initialized():
+        globals.msg.error("Cannot initialize more than once\n");
+        raise RuntimeError('Error initializing');
+
+    # read in the data
+    initializer = hoomd.HOOMDIndexedInitializer(my_exec_conf,filename);
+    initializer.setFrame(frame);
+    if fields is not None:
+        for f in ['velocity', 'acceleration', 'mass', 'charge', 'diameter', 'image', 'body', 'orientation',
+                  'moment_inertia', 'bond', 'angle', 'dihedral', 'improper', 'integrator']:
+            initializer.setReadField(f, False);
+        for f in fields:
+            initializer.setReadField(f, True);
+    snapshot = initializer.getSnapshot()
+
+    my_domain_decomposition = _create_domain_decomposition(snapshot.global_box);
+    if my_domain_decomposition is not None:
+        globals.system_definition = hoomd.SystemDefinition(snapshot, my_exec_conf, my_domain_decomposition);
+    else:
+        globals.system_definition = hoomd.SystemDefinition(snapshot, my_exec_conf);
+
+    # initialize the system
+    if time_step is None:
+        globals.system = hoomd.System(globals.system_definition, initializer.getTimeStep());
+    else:
+        globals.system = hoomd.System(globals.system_definition, time_step);
+
+    _perform_common_init_tasks();
+    return data.system_data(globals.system_definition);
+
 ## Generates N randomly positioned particles of the same type
 #
 # \param N Number of particles to create
@@ -758,6 +819,9 @@ def _perform_common_init_tasks():
             # set Communicator in C++ System
             globals.system.setCommunicator(cpp_communicator)
 
+    # print the messages of all ranks from the initialization
+    globals.msg.collectiveFlush();
+
 
 ## Initializes the execution configuration
 #
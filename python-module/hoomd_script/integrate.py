@@ -121,9 +121,10 @@ class _integrator:
             globals.msg.error("Cannot create integrator before initialization\n");
             raise RuntimeError('Error creating integrator');
 
-        # by default, integrators do not support methods
+        # by default, integrators do not support methods or multiple time step integration
         self.cpp_integrator = None;
         self.supports_methods = False;
+        self.supports_respa = False;
 
         # save ourselves in the global variable
         globals.integrator = self;
@@ -138,6 +139,10 @@ class _integrator:
     # \note If hoomd ever needs to support multiple TYPES of methods, we could just change this to a string naming the
     # type that is supported and add a type string to each of the integration_methods.
 
+    ## \var supports_respa
+    # \internal
+    # \brief True if this integrator applies forces with a RESPA period larger than 1 as impulses
+
     ## \internal
     # \brief Checks that proper initialization has completed
     def check_initialization(self):
@@ -164,6 +169,12 @@ class _integrator:
             if f.enabled:
                 self.cpp_integrator.addForceCompute(f.cpp_force);
 
+                if f.respa_period > 1:
+                    if not self.supports_respa:
+                        globals.msg.error('This integrator does not support forces with a RESPA period\n');
+                        raise RuntimeError('Error updating forces');
+                    self.cpp_integrator.setRESPAPeriod(f.cpp_force, f.respa_period);
+
         # set the constraint forces
         for f in globals.constraint_forces:
             if f.cpp_force is None:
@@ -316,6 +327,9 @@ class _integration_method:
 # - integrate.npt
 # - integrate.nph
 #
+# Forces that vary slowly can be evaluated less often than every step with multiple time step integration, see
+# force._force.set_respa().
+#
 # There can only be one integration mode active at a time. If there are more than one integrate.mode_* commands in
 # a hoomd script, only the most recent before a given run() will take effect.
 #
@@ -338,6 +352,7 @@ class mode_standard(_integrator):
         # initialize the reflected c++ class
         self.cpp_integrator = hoomd.IntegratorTwoStep(globals.system_definition, dt);
         self.supports_methods = True;
+        self.supports_respa = True;
 
         globals.system.setIntegrator(self.cpp_integrator);
 
@@ -919,6 +934,7 @@ class bdnvt(_integration_method):
     # \param tally (optional) If true, the energy exchange between the bd thermal reservoir and the particles is
     #                         tracked. Total energy conservation can then be monitored by adding
     #                         \b bdnvt_reservoir_energy_<i>groupname</i> to the logged quantities.
+    # \param num_threads (optional) Number of CPU threads the integration is split over, 0 uses all cores
     #
     # To change the parameters of an existing integrator, you must save it in a variable when it is
     # specified, like so:
@@ -926,12 +942,16 @@ class bdnvt(_integration_method):
     # integrator = integrate.bdnvt(group=all, T=1.0)
     # \endcode
     #
+    # The random force on every particle depends only on its tag, the time step and the seed, so the trajectory does
+    # not depend on \a num_threads.
+    #
     # \b Examples:
     # \code
     # integrator.set_params(T=2.0)
     # integrator.set_params(tally=False)
+    # integrator.set_params(num_threads=4)
     # \endcode
-    def set_params(self, T=None, tally=None):
+    def set_params(self, T=None, tally=None, num_threads=None):
         util.print_status_line();
         self.check_initialization();
 
@@ -944,6 +964,9 @@ class bdnvt(_integration_method):
         if tally is not None:
             self.cpp_method.setTally(tally);
 
+        if num_threads is not None:
+            self.cpp_method.setNumThreads(num_threads);
+
     ## Sets gamma parameter for a particle type
     # \param a Particle type
     # \param gamma \f$ \gamma \f$ for particle type \a (in units of force/velocity)
@@ -80,6 +80,7 @@ class options:
         self.notice_level = 2;
         self.msg_file = None;
         self.shared_msg_file = None;
+        self.msg_aggregate = False;
         self.nrank = None;
         self.nx = None;
         self.ny = None;
@@ -88,6 +89,12 @@ class options:
         self.onelevel = None;
         self.autotuner_enable = True;
         self.autotuner_period = 100000;
+        self.trace_filename = None;
+        self.trace_format = 'json';
+        self.trace_period = 1;
+        self.trace_block_size = 16384;
+        self.profile_counters = False;
+        self.profile_vector_fp_event = None;
 
     def __repr__(self):
         tmp = dict(mode=self.mode,
@@ -99,6 +106,7 @@ class options:
                    notice_level=self.notice_level,
                    msg_file=self.msg_file,
                    shared_msg_file=self.shared_msg_file,
+                   msg_aggregate=self.msg_aggregate,
                    nrank=self.nrank,
                    nx=self.nx,
                    ny=self.ny,
@@ -121,6 +129,7 @@ def _parse_command_line():
     parser.add_option("--notice-level", dest="notice_level", help="Minimum level of notice messages to print");
     parser.add_option("--msg-file", dest="msg_file", help="Name of file to write messages to");
     parser.add_option("--shared-msg-file", dest="shared_msg_file", help="(MPI only) Name of shared file to write message to (append partition #)");
+    parser.add_option("--aggregate-msg", dest="msg_aggregate", action="store_true", default=False, help="(MPI only) Print each warning issued by many ranks once and buffer notices");
     parser.add_option("--nrank", dest="nrank", help="(MPI) Number of ranks to include in a partition");
     parser.add_option("--nx", dest="nx", help="(MPI) Number of domains along the x-direction");
     parser.add_option("--ny", dest="ny", help="(MPI) Number of domains along the y-direction");
@@ -216,6 +225,10 @@ def _parse_command_line():
         globals.options.shared_msg_file = cmd_options.shared_msg_file;
         globals.msg.setSharedFile(globals.options.shared_msg_file);
 
+    if cmd_options.msg_aggregate:
+        globals.options.msg_aggregate = True;
+        globals.msg.setAggregate(True);
+
     if cmd_options.nrank is not None:
         if not hoomd.is_MPI_available():
             globals.msg.error("The --nrank option is only avaible in MPI builds.\n");
@@ -359,6 +372,24 @@ def set_msg_file(fname):
 
     globals.options.msg_file = fname;
 
+## Aggregate messages across MPI ranks
+#
+# \param enable Set to True to aggregate messages, False to print them immediately
+#
+# When enabled, warnings are buffered on each rank. At the start and end of each run() and after initialization,
+# the warnings of all ranks are combined and each distinct message is printed once, annotated with the number of
+# ranks that issued it. Notices above level 1 are buffered and written in large blocks. Errors are always printed
+# immediately. Use this option in jobs with many MPI ranks, where every rank may issue the same warning.
+#
+# Must be called on all ranks.
+#
+# \note Overrides --aggregate-msg on the command line.
+# \sa \ref page_command_line_options
+#
+def set_msg_aggregate(enable=True):
+    globals.msg.setAggregate(enable);
+    globals.options.msg_aggregate = enable;
+
 ## Set the Autotuner parameters
 #
 # \param enable Set to True to enable autotuning. Set to False to disable.
@@ -371,6 +402,88 @@ def set_autotuner_params(enable=True, period=100000):
     globals.options.autotuner_enable = enable;
 
 
+## Record a timeline of profiled events
+#
+# \param filename File to write the trace to. Set to None to stop tracing.
+# \param format Either 'json' or 'binary'
+# \param period Record events on every \a period'th time step
+# \param block_size Number of events buffered per thread before they are handed to the writer thread
+#
+# The profile printed by run(profile=True) only contains totals. With a trace enabled, every profiled region on
+# every \a period'th time step is recorded with its start and end time, the time step, the MPI rank and the thread.
+# This shows jitter between steps and load imbalance between ranks.
+#
+# Events are recorded into preallocated per-thread buffers and written to the file by a background thread. The 'json'
+# format is the Chrome trace event format, which can be opened in chrome://tracing or https://ui.perfetto.dev. The
+# 'binary' format is a compact stream described in the ProfileTrace class documentation. When running on more than
+# one rank, each rank writes its own file with the rank inserted before the extension (trace.json becomes
+# trace.1.json).
+#
+# Tracing does not print the profile table, and unlike run(profile=True) it does not synchronize the GPU at each
+# region. On the GPU, the recorded times are therefore the times at which kernels are launched. Use run(profile=True)
+# together with tracing to time the kernels themselves.
+#
+# The settings take effect at the next run(). The file is written over when the trace is set up, and further runs
+# append to it until the parameters change.
+#
+# \b Examples:
+# \code
+# option.set_trace('trace.json')
+# option.set_trace('trace.bin', format='binary', period=100)
+# option.set_trace(None)
+# \endcode
+#
+def set_trace(filename, format='json', period=1, block_size=16384):
+    if format not in ['json', 'binary']:
+        globals.msg.error("option.set_trace: format must be 'json' or 'binary'\n");
+        raise RuntimeError('Error setting trace options');
+
+    if period < 1 or block_size < 1:
+        globals.msg.error("option.set_trace: period and block_size must be positive\n");
+        raise RuntimeError('Error setting trace options');
+
+    globals.options.trace_filename = filename;
+    globals.options.trace_format = format;
+    globals.options.trace_period = int(period);
+    globals.options.trace_block_size = int(block_size);
+
+
+## Read hardware performance counters in profiled runs
+#
+# \param enable Set to True to read the counters. Set to False to stop.
+# \param vector_fp_event Raw CPU event code that counts vector floating point instructions (None to not count them)
+#
+# The FLOP/s and B/s columns printed by run(profile=True) are estimates computed from the work a kernel is expected
+# to do. With counters enabled, each line of the profile additionally lists values measured by the CPU: the
+# instructions per cycle (IPC), the memory traffic implied by last level cache misses (one 64 byte line per miss),
+# and optionally the rate of vector floating point instructions. A large gap between the estimated and measured
+# bandwidth points to a kernel that is either served from cache or wastes memory traffic.
+#
+# There is no event for vector floating point operations that is common to all CPUs, so \a vector_fp_event must be
+# given as the raw event code for the CPU in use (see the output of `perf list --details`). The column counts
+# instructions, not operations.
+#
+# Counters are read through the Linux perf_event interface and only count the thread that runs the time step loop.
+# Counters that cannot be opened (for example, when perf_event_paranoid forbids it) produce a warning and are left
+# out of the profile. On the GPU, the counters measure the host side of each region.
+#
+# The settings take effect at the next run(profile=True).
+#
+# \b Examples:
+# \code
+# option.set_profile_counters()
+# option.set_profile_counters(vector_fp_event=0x3cc7)
+# option.set_profile_counters(False)
+# \endcode
+#
+def set_profile_counters(enable=True, vector_fp_event=None):
+    if vector_fp_event is not None and vector_fp_event <= 0:
+        globals.msg.error("option.set_profile_counters: vector_fp_event must be a positive event code\n");
+        raise RuntimeError('Error setting profile counter options');
+
+    globals.options.profile_counters = enable;
+    globals.options.profile_vector_fp_event = vector_fp_event;
+
 ################### Parse command line on load
 globals.options = options();
 _parse_command_line();
@@ -386,6 +386,8 @@ class nlist:
         for c in self.subscriber_callbacks:
             r_cut_max = max(r_cut_max, c());
 
+        # r_buff may have been changed by tune.nlist_buffer
+        self.r_buff = self.cpp_nlist.getRBuff();
         self.r_cut = r_cut_max;
         self.cpp_nlist.setRCut(self.r_cut, self.r_buff);
 
@@ -637,6 +639,7 @@ def _update_global_nlist(r_cut):
         # otherwise, we need to update r_cut
         new_r_cut = max(r_cut, globals.neighbor_list.r_cut);
         globals.neighbor_list.r_cut = new_r_cut;
+        globals.neighbor_list.r_buff = globals.neighbor_list.cpp_nlist.getRBuff();
         globals.neighbor_list.cpp_nlist.setRCut(new_r_cut, globals.neighbor_list.r_buff);
 
     return globals.neighbor_list;
@@ -1290,10 +1293,138 @@ class ewald(pair):
         # setup the coefficent options
         self.required_coeffs = ['kappa'];
 
+        self.fast_erfc = False;
+        self.fast_erfc_error = None;
+
+    ## Set parameters controlling the way forces are computed
+    #
+    # \param mode (if set) Set the mode with which potentials are handled at the cutoff (see pair.set_params())
+    # \param fast_erfc (if set) Set to True to evaluate erfc with a fast polynomial approximation
+    #
+    # By default, pair.ewald evaluates erfc(kappa r) with the math library, which dominates the cost of the real space
+    # sum on the CPU. With \a fast_erfc=True, erfc is computed with a rational approximation (Abramowitz and Stegun
+    # 7.1.26) that reuses the exponential needed for the force. Its absolute error in erfc is below 1.5e-7. The
+    # largest error for the current coefficients is reported at the start of the next run().
+    #
+    # \b Examples:
+    # \code
+    # ewald.set_params(fast_erfc=True)
+    # ewald.set_params(mode="shift", fast_erfc=False)
+    # \endcode
+    def set_params(self, mode=None, fast_erfc=None):
+        util.print_status_line();
+
+        if mode is not None:
+            util._disable_status_lines = True;
+            pair.set_params(self, mode=mode);
+            util._disable_status_lines = False;
+
+        if fast_erfc is not None:
+            self.fast_erfc = fast_erfc;
+
     def process_coeff(self, coeff):
         kappa = coeff['kappa'];
 
-        return kappa;
+        if self.fast_erfc:
+            return hoomd.make_scalar2(kappa, 1.0);
+        else:
+            return hoomd.make_scalar2(kappa, 0.0);
+
+    def update_coeffs(self):
+        pair.update_coeffs(self);
+
+        if not self.fast_erfc:
+            return;
+
+        # report the error bound for the largest argument of erfc that will be evaluated
+        ntypes = globals.system_definition.getParticleData().getNTypes();
+        type_list = [];
+        for i in range(0,ntypes):
+            type_list.append(globals.system_definition.getParticleData().getNameByType(i));
+
+        x_max = 0.0;
+        for i in range(0,ntypes):
+            for j in range(i,ntypes):
+                kappa = self.pair_coeff.get(type_list[i], type_list[j], 'kappa');
+                r_cut = self.pair_coeff.get(type_list[i], type_list[j], 'r_cut');
+                x_max = max(x_max, kappa * r_cut);
+
+        error = hoomd.ewald_fast_erfc_error(x_max);
+        if error != self.fast_erfc_error:
+            globals.msg.notice(2, "pair.ewald: fast erfc maximum absolute error " + str(error) + " up to kappa*r_cut = " + str(x_max) + "\n");
+            self.fast_erfc_error = error;
+
+## Fused evaluation of several %pair forces
+#
+# The command pair.fused evaluates several standard %pair forces in a single pass over the neighbor list. Each %pair
+# force on its own loads the neighbors of every particle and computes their separations. When several %pair forces
+# are used together, e.g. pair.lj with pair.ewald, fusing them performs this work only once per time step and then
+# evaluates all of the fused potentials on the loaded neighbors. The resulting forces are identical to those of the
+# separate %pair forces.
+#
+# The fused %pair forces are replaced by pair.fused in the simulation. Their coefficients are still set on the
+# original %pair force objects and their energies are still available for logging under the original names
+# (e.g. \c pair_lj_energy and \c pair_ewald_energy).
+#
+# Any %pair force derived from hoomd_script.pair.pair can be fused, except pair.dpd and pair.dpdlj, whose thermostat
+# forces need the particle velocities. Once fused, a %pair force should not be enabled or disabled on its own, use
+# enable() and disable() on the pair.fused instead.
+#
+# \note pair.fused is not available on the GPU.
+#
+# \MPI_SUPPORTED
+class fused(force._force):
+    ## Fuse %pair forces
+    #
+    # \param potentials List of %pair forces to evaluate together
+    # \param name Name of the force instance
+    #
+    # \b Example:
+    # \code
+    # lj = pair.lj(r_cut=3.0)
+    # lj.pair_coeff.set('A', 'A', epsilon=1.0, sigma=1.0)
+    # yuk = pair.yukawa(r_cut=3.0)
+    # yuk.pair_coeff.set('A', 'A', epsilon=1.0, kappa=1.0)
+    # pair.fused([lj, yuk])
+    # \endcode
+    def __init__(self, potentials, name=None):
+        util.print_status_line();
+
+        # initialize the base class
+        force._force.__init__(self, name);
+
+        if globals.exec_conf.isCUDAEnabled():
+            globals.msg.error("pair.fused is not supported on the GPU\n");
+            raise RuntimeError("Error creating pair.fused");
+
+        if len(potentials) < 2:
+            globals.msg.error("pair.fused needs at least two pair forces\n");
+            raise RuntimeError("Error creating pair.fused");
+
+        for p in potentials:
+            if not isinstance(p, pair) or not p.enabled:
+                globals.msg.error("pair.fused can only fuse enabled standard pair forces\n");
+                raise RuntimeError("Error creating pair.fused");
+
+        # create the c++ mirror class
+        self.cpp_force = hoomd.PotentialPairFused(globals.system_definition, globals.neighbor_list.cpp_nlist);
+        for p in potentials:
+            self.cpp_force.addPotential(p.cpp_force);
+
+        # the fused forces are now applied and logged through this one
+        for p in potentials:
+            p.enabled = False;
+            p.log = False;
+            globals.system.removeCompute(p.force_name);
+
+        self.potentials = list(potentials);
+        globals.neighbor_list.subscribe(lambda: self.log*max([p.get_max_rcut() for p in self.potentials]));
+
+        globals.system.addCompute(self.cpp_force, self.force_name);
+
+    def update_coeffs(self):
+        for p in self.potentials:
+            p.update_coeffs();
 
 ## CMM coarse-grain model %pair %force
 #
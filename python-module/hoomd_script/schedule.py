@@ -0,0 +1,186 @@
+# -- start license --
+# Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+# (HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+# the University of Michigan All rights reserved.
+
+# HOOMD-blue may contain modifications ("Contributions") provided, and to which
+# copyright is held, by various Contributors who have granted The Regents of the
+# University of Michigan the right to modify and/or distribute such Contributions.
+
+# You may redistribute, use, and create derivate works of HOOMD-blue, in source
+# and binary forms, provided you abide by the following conditions:
+
+# * Redistributions of source code must retain the above copyright notice, this
+# list of conditions, and the following disclaimer both in the code and
+# prominently in any materials provided with the distribution.
+
+# * Redistributions in binary form must reproduce the above copyright notice, this
+# list of conditions, and the following disclaimer in the documentation and/or
+# other materials provided with the distribution.
+
+# * All publications and presentations based on HOOMD-blue, including any reports
+# or published results obtained, in whole or in part, with HOOMD-blue, will
+# acknowledge its use according to the terms posted at the time of submission on:
+# http://codeblue.umich.edu/hoomd-blue/citations.html
+
+# * Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+# http://codeblue.umich.edu/hoomd-blue/
+
+# * Apart from the above required attributions, neither the name of the copyright
+# holder nor the names of HOOMD-blue's contributors may be used to endorse or
+# promote products derived from this software without specific prior written
+# permission.
+
+# Disclaimer
+
+# THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+# ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+# WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+# WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+# IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+# INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+# BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+# DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+# LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+# OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+# ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+# -- end license --
+
+# Maintainer: joaander / All Developers are free to add commands for new features
+
+import hoomd;
+from hoomd_script import globals;
+
+## \package hoomd_script.schedule
+# \brief Commands for specifying the time steps that analyzers and updaters execute on
+#
+# Any analyze, update, or dump command accepts a schedule in place of its \a period. Schedules are evaluated in
+# C++ and do not call back into python during a run(), so they are much cheaper than a
+# \ref variable_period_docs "variable period" given as a python function. Like a variable period, the steps of a
+# schedule are counted from the time step <b>when the command is created</b>.
+#
+# \b Examples:
+# \code
+# dump.dcd(filename="log.dcd", period=schedule.log(points_per_decade=10))
+# analyze.log(filename="thermo.log", quantities=['temperature'], period=schedule.linear_log(cycle=10000))
+# dump.xml(filename="dump", period=schedule.combine(schedule.steps([0, 500]), schedule.log()))
+# \endcode
+
+## \internal
+# \brief Base class for schedules
+#
+# _schedule should not be used directly in code, it only serves as a base class
+# for the other schedule types.
+class _schedule:
+    ## Does common initialization for all schedules
+    #
+    def __init__(self):
+        self.cpp_schedule = None;
+
+    ## Get the next step
+    #
+    # \param step Step relative to the start of the schedule
+    # \returns The first step of the schedule at or after \a step, or None if there are no more steps
+    def next_step(self, step):
+        n = self.cpp_schedule.getNextStep(int(step));
+        if n == 0xffffffff:
+            return None;
+        return n;
+
+## Logarithmically spaced time steps
+#
+# schedule.log executes on the first step and then on every step
+# round(10<sup>k / points_per_decade</sup>) for k = 0, 1, 2, ... after it. Steps that round to the same
+# value are executed only once, so early decades contain fewer than \a points_per_decade steps. For example,
+# points_per_decade=1 executes 0, 1, 10, 100, 1000, ... steps after the first step.
+#
+# \b Examples:
+# \code
+# dump.xml(filename="dump", period=schedule.log())
+# dump.dcd(filename="log.dcd", period=schedule.log(points_per_decade=4))
+# \endcode
+class log(_schedule):
+    ## Specify a logarithmic %schedule
+    #
+    # \param points_per_decade Number of steps in each factor of 10
+    def __init__(self, points_per_decade=10):
+        _schedule.__init__(self);
+
+        if points_per_decade <= 0:
+            globals.msg.error("schedule.log: points_per_decade must be positive\n");
+            raise RuntimeError('Error creating schedule');
+
+        self.cpp_schedule = hoomd.ScheduleLog(int(points_per_decade));
+
+## Logarithmically spaced time steps that restart every cycle
+#
+# schedule.linear_log repeats the steps of schedule.log every \a cycle steps: a cycle starts at every multiple of
+# \a cycle and executes on the log spaced steps from that start which are less than \a cycle. This provides many
+# time origins for computing time correlation functions and mean squared displacements.
+#
+# \b Examples:
+# \code
+# dump.dcd(filename="msd.dcd", period=schedule.linear_log(cycle=10000))
+# \endcode
+class linear_log(_schedule):
+    ## Specify a linear-log %schedule
+    #
+    # \param cycle Number of time steps in a cycle
+    # \param points_per_decade Number of steps in each factor of 10
+    def __init__(self, cycle, points_per_decade=10):
+        _schedule.__init__(self);
+
+        if cycle <= 0 or points_per_decade <= 0:
+            globals.msg.error("schedule.linear_log: cycle and points_per_decade must be positive\n");
+            raise RuntimeError('Error creating schedule');
+
+        self.cpp_schedule = hoomd.ScheduleLinearLog(int(cycle), int(points_per_decade));
+
+## An explicit list of time steps
+#
+# schedule.steps executes exactly on the given steps. The steps may be given in any order.
+#
+# \b Examples:
+# \code
+# dump.xml(filename="dump", period=schedule.steps([0, 1000, 5000, 20000]))
+# \endcode
+class steps(_schedule):
+    ## Specify a list of time steps
+    #
+    # \param steps List of time steps
+    def __init__(self, steps):
+        _schedule.__init__(self);
+
+        self.cpp_schedule = hoomd.ScheduleList();
+        for s in steps:
+            if s < 0:
+                globals.msg.error("schedule.steps: steps cannot be negative\n");
+                raise RuntimeError('Error creating schedule');
+            self.cpp_schedule.addStep(int(s));
+
+## Combination of several schedules
+#
+# schedule.combine executes on every step that is in any of the given schedules.
+#
+# \b Examples:
+# \code
+# dump.xml(filename="dump", period=schedule.combine(schedule.log(), schedule.steps([25000])))
+# \endcode
+class combine(_schedule):
+    ## Combine schedules
+    #
+    # \param schedules Schedules to combine
+    def __init__(self, *schedules):
+        _schedule.__init__(self);
+
+        if len(schedules) == 0:
+            globals.msg.error("schedule.combine: at least one schedule is required\n");
+            raise RuntimeError('Error creating schedule');
+
+        self.cpp_schedule = hoomd.ScheduleUnion();
+        for s in schedules:
+            if not isinstance(s, _schedule):
+                globals.msg.error("schedule.combine: arguments must be schedules\n");
+                raise RuntimeError('Error creating schedule');
+            self.cpp_schedule.addSchedule(s.cpp_schedule);
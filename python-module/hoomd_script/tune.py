@@ -53,6 +53,7 @@ import hoomd
 from hoomd_script import globals
 from hoomd_script import init
 from hoomd_script import util
+from hoomd_script import update
 import hoomd_script
 
 import math
@@ -146,3 +147,62 @@ def r_buff(warmup=200000, r_min=0.05, r_max=1.0, jumps=20, steps=5000, set_max_c
 
     # return the results to the script
     return (fastest_r_buff, globals.neighbor_list.query_update_period());
+
+## Tunes the neighbor list r_buff and check_period while the simulation runs
+#
+# \param period Number of time steps in each measurement window
+# \param r_min Smallest value of r_buff to set
+# \param r_max Largest value of r_buff to set
+# \param dr Initial step size in r_buff
+# \param max_check_period Largest check_period to set
+#
+# tune.nlist_buffer() searches for the fastest r_buff during production runs, so there is no need for a separate
+# tune.r_buff() scan. The wall clock time per step is measured over each window of \a period steps. After each
+# window, r_buff takes a step of size \a dr from the best value found so far. The step reverses direction and halves
+# every time the simulation gets slower. When the step drops below \a dr / 8, r_buff is held at the best value. The
+# search starts over if the time per step later grows by more than 10%, as may happen when the temperature or
+# density changes.
+#
+# After each change of r_buff, the check_period is set to 1 for one window. It is then set to one less than the
+# shortest rebuild period seen in that window (but no larger than \a max_check_period), or back to its previous value
+# if the neighbor list was not rebuilt in that window. If a dangerous build occurs, the check_period is lowered by
+# one. When the neighbor list was set with dist_check=False, the check_period is left alone. r_buff is never set so
+# large that the neighbor list does not fit in the box.
+#
+# Each change is printed to the notice stream at level 2. The current values are also available to analyze.log
+# as \b nlist_r_buff and \b nlist_check_period.
+#
+# \b Examples:
+# \code
+# tune.nlist_buffer()
+# tuner = tune.nlist_buffer(period=5000, r_min=0.1, r_max=0.8)
+# \endcode
+#
+# \note Use a \a period long enough to average over several neighbor list builds. Other commands that take wall
+# clock time, such as frequent file output, add noise to the measurement.
+#
+# \MPI_SUPPORTED
+class nlist_buffer(update._updater):
+    def __init__(self, period=2000, r_min=0.05, r_max=1.0, dr=0.05, max_check_period=20):
+        util.print_status_line();
+
+        # initialize base class
+        update._updater.__init__(self);
+
+        # check that there is a nlist
+        if globals.neighbor_list is None:
+            globals.msg.error("Cannot tune r_buff when there is no neighbor list\n");
+            raise RuntimeError('Error creating nlist_buffer tuner');
+
+        if max_check_period < 1:
+            globals.msg.error("tune.nlist_buffer: max_check_period must be at least 1\n");
+            raise RuntimeError('Error creating nlist_buffer tuner');
+
+        # create the c++ mirror class
+        self.cpp_updater = hoomd.NeighborListBufferTuner(globals.system_definition,
+                                                         globals.neighbor_list.cpp_nlist,
+                                                         float(r_min),
+                                                         float(r_max),
+                                                         float(dr));
+        self.cpp_updater.setMaximumCheckPeriod(int(max_check_period));
+        self.setupUpdater(period);
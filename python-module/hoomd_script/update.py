@@ -56,6 +56,7 @@ from hoomd_script import util;
 from hoomd_script import variant;
 import sys;
 from hoomd_script import init;
+from hoomd_script import schedule;
 
 ## \package hoomd_script.update
 # \brief Commands that modify the system state in some way
@@ -100,7 +101,8 @@ class _updater:
     #
     # If an integer is specified, then that is set as the period for the analyzer.
     # If a callable is passed in as a period, then a default period of 1000 is set
-    # to the integer period and the variable period is enabled
+    # to the integer period and the variable period is enabled. A schedule from hoomd_script.schedule
+    # is set the same way, but is evaluated in C++.
     #
     def setupUpdater(self, period):
         if type(period) == type(1.0):
@@ -111,6 +113,9 @@ class _updater:
         elif type(period) == type(lambda n: n*2):
             globals.system.addUpdater(self.cpp_updater, self.updater_name, 1000);
             globals.system.setUpdaterPeriodVariable(self.updater_name, period);
+        elif isinstance(period, schedule._schedule):
+            globals.system.addUpdater(self.cpp_updater, self.updater_name, 1000);
+            globals.system.setUpdaterSchedule(self.updater_name, period.cpp_schedule);
         else:
             globals.msg.error("I don't know what to do with a period of type " + str(type(period)) + "expecting an int or a function\n");
             raise RuntimeError('Error creating updater');
@@ -203,6 +208,7 @@ class _updater:
     #
     # While the simulation is \ref run() "running", the action of each updater
     # is executed every \a period time steps.
+    # \a period may also be a schedule from hoomd_script.schedule, which is counted from the current time step.
     #
     # To use this command, you must have saved the updater in a variable, as
     # shown in this example:
@@ -224,6 +230,11 @@ class _updater:
                 self.prev_period = period;
         elif type(period) == type(lambda n: n*2):
             globals.msg.warning("A period cannot be changed to a variable one");
+        elif isinstance(period, schedule._schedule):
+            if self.enabled:
+                globals.system.setUpdaterSchedule(self.updater_name, period.cpp_schedule);
+            else:
+                globals.msg.warning("A schedule cannot be set on a disabled updater");
         else:
             globals.msg.warning("I don't know what to do with a period of type " + str(type(period)) + " expecting an int or a function");
 
@@ -239,8 +250,11 @@ class _updater:
 # these bins and particles are reordered in memory in the same order in which
 # they fall on the curve. The grid dimension used over the course of the simulation is held constant, and the default
 # is chosen to be as fine as possible without utilizing too much memory. The dimension can be changed with set_params(),
-# just be aware that the value chosen will be rounded up to the next power of 2 and that the amount of memory usage for
-# 3D simulations grows very quickly:
+# just be aware that the value chosen will be rounded up to the next power of 2.
+#
+# On the CPU, the position of each bin along the curve is computed on the fly, so the memory usage and cost of the
+# sort do not depend on the grid dimension (up to a maximum of \a grid=2097152 in 3D). On the GPU, the traversal order
+# of the bins is stored in a table and the amount of memory usage for 3D simulations grows very quickly:
 # - \a grid=128 uses 8 MB
 # - \a grid=256 uses 64 MB
 # - \a grid=512 uses 512 MB
@@ -289,18 +303,38 @@ class sort(_updater):
     ## Change sorter parameters
     #
     # \param grid New grid dimension (if set)
+    # \param adaptive Set to True to enable adaptive sorting (if set)
+    # \param num_threads Number of CPU threads the sort is split over, 0 uses all cores (if set)
+    #
+    # With adaptive sorting, the sorter still checks every \a period time steps, but it only sorts the particles when
+    # the time lost to the growing disorder of the neighbor list, measured since the last sort, exceeds the time needed
+    # to sort. The decisions are summarized at the end of each run. Adaptive sorting needs a neighbor list, so a pair
+    # potential must be specified before enabling it.
     #
     # \b Examples:
     # \code
     # sorter.set_params(grid=128)
+    # sorter.set_params(adaptive=True)
+    # sorter.set_params(num_threads=4)
     # \endcode
-    def set_params(self, grid=None):
+    def set_params(self, grid=None, adaptive=None, num_threads=None):
         util.print_status_line();
         self.check_initialization();
 
         if grid is not None:
             self.cpp_updater.setGrid(grid);
 
+        if num_threads is not None:
+            self.cpp_updater.setNumThreads(num_threads);
+
+        if adaptive is not None:
+            if adaptive:
+                if globals.neighbor_list is None:
+                    globals.msg.error("update.sort: adaptive sorting requires a neighbor list, specify a pair potential first\n");
+                    raise RuntimeError('Error setting sorter parameters');
+                self.cpp_updater.setNeighborList(globals.neighbor_list.cpp_nlist);
+            self.cpp_updater.setAdaptive(adaptive);
+
 
 ## Rescales particle velocities
 #
@@ -396,6 +430,44 @@ class zero_momentum(_updater):
         self.cpp_updater = hoomd.ZeroMomentumUpdater(globals.system_definition);
         self.setupUpdater(period);
 
+## Re-evaluates the membership of a group
+#
+# Group membership is normally determined once, when the group is created. Every \a period time steps,
+# update.group_select re-applies the selection the group was created with, so that e.g. a group.cuboid() keeps
+# containing the particles that are currently inside the cuboid. The group is only modified when its membership
+# actually changed.
+#
+# Only groups created by group.cuboid(), group.type(), group.tags(), group.rigid() and group.nonrigid() can be
+# updated. Groups built from a list of tags or by combining other groups have no selection to re-apply.
+#
+# Commands that were given the group use the new members from the next time step on.
+#
+# \b Examples:
+# \code
+# slab = group.cuboid(name="slab", ymin=-3, ymax=3)
+# update.group_select(slab, period=100)
+# \endcode
+#
+# \a period can be a function: see \ref variable_period_docs for details
+class group_select(_updater):
+    ## Initialize the group updater
+    #
+    # \param group Group to update
+    # \param period The membership is re-evaluated every \a period time steps
+    def __init__(self, group, period=1):
+        util.print_status_line();
+
+        if group.cpp_selector is None:
+            globals.msg.error("update.group_select: group " + group.name + " has no selection to re-evaluate\n");
+            raise RuntimeError('Error creating group updater');
+
+        # initialize base class
+        _updater.__init__(self);
+
+        # create the c++ mirror class
+        self.cpp_updater = hoomd.GroupSelectUpdater(globals.system_definition, group.cpp_group, group.cpp_selector);
+        self.setupUpdater(period);
+
 ## Enforces 2D simulation
 #
 # Every time step, particle velocities and accelerations are modified so that their z components are 0: forcing
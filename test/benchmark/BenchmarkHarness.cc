@@ -0,0 +1,467 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+/*! \file BenchmarkHarness.cc
+    \brief Defines the synthetic systems and the timing harness of the microbenchmarks
+    \ingroup benchmarks
+*/
+
+#ifdef WIN32
+#pragma warning( push )
+#pragma warning( disable : 4103 4244 )
+#endif
+
+#include "BenchmarkHarness.h"
+#include "ClockSource.h"
+#include "SnapshotSystemData.h"
+#include "SFCPackUpdater.h"
+
+#ifdef ENABLE_MPI
+#include "DomainDecomposition.h"
+#endif
+
+#ifdef ENABLE_CUDA
+#include "SFCPackUpdaterGPU.h"
+#endif
+
+#include <algorithm>
+#include <iomanip>
+#include <stdexcept>
+
+#include <boost/random.hpp>
+
+using namespace std;
+using namespace boost;
+
+/*! \param exec_conf Execution configuration
+    \param params Parameters of the system
+    \param bonded True to connect the particles into chains of bonds, angles, dihedrals and impropers
+    \param decompose True to split the system over all MPI ranks (otherwise every rank holds the whole system)
+
+    The particles are placed on the sites of a simple cubic lattice that fills the cubic box at the requested
+    density, each displaced by a random amount of up to 10% of the lattice spacing. Sites are visited along a
+    serpentine path so that consecutive sites are always lattice neighbors, and the chains of the bonded systems
+    follow this path. Every particle then gets a random tag, so that the particle order in memory is random until
+    the system is sorted. Types alternate between A and B along the path and so do the charges (+1 and -1), which
+    keeps the system neutral. Velocities are drawn from a Maxwell-Boltzmann distribution at kT=1.
+
+    All random numbers come from a single stream seeded with \a params.seed, so the same parameters always produce
+    the same system.
+*/
+boost::shared_ptr<SystemDefinition> makeSyntheticSystem(boost::shared_ptr<ExecutionConfiguration> exec_conf,
+                                                        const BenchmarkParams& params,
+                                                        bool bonded,
+                                                        bool decompose)
+    {
+    unsigned int N = params.N;
+    if (N < 8 || params.density <= Scalar(0.0))
+        {
+        exec_conf->msg->error() << "benchmark: N must be at least 8 and the density must be positive" << endl;
+        throw runtime_error("Error building the synthetic system");
+        }
+
+    // lattice with at least N sites
+    unsigned int m = (unsigned int)ceil(pow(double(N), 1.0/3.0));
+    while (m*m*m < N)
+        m++;
+
+    Scalar L = pow(Scalar(N) / params.density, Scalar(1.0/3.0));
+    Scalar a = L / Scalar(m);
+
+    boost::mt19937 rng(params.seed);
+    boost::uniform_real<Scalar> uniform(Scalar(-0.1)*a, Scalar(0.1)*a);
+    boost::normal_distribution<Scalar> normal(Scalar(0.0), Scalar(1.0));
+    boost::variate_generator<boost::mt19937&, boost::uniform_real<Scalar> > jitter(rng, uniform);
+    boost::variate_generator<boost::mt19937&, boost::normal_distribution<Scalar> > gauss(rng, normal);
+
+    // random tag of the particle on each site
+    vector<unsigned int> tag(N);
+    for (unsigned int i = 0; i < N; i++)
+        tag[i] = i;
+    for (unsigned int i = N-1; i > 0; i--)
+        swap(tag[i], tag[rng() % (i+1)]);
+
+    boost::shared_ptr<SnapshotSystemData> snap(new SnapshotSystemData());
+    snap->global_box = BoxDim(L);
+    snap->dimensions = 3;
+
+    SnapshotParticleData& pdata = snap->particle_data;
+    pdata.resize(N);
+    pdata.type_mapping.push_back("A");
+    pdata.type_mapping.push_back("B");
+
+    for (unsigned int s = 0; s < N; s++)
+        {
+        // serpentine path through the lattice
+        unsigned int row = s / m;
+        unsigned int i = (row % 2 == 0) ? s % m : m - 1 - s % m;
+        unsigned int k = row / m;
+        unsigned int j = (k % 2 == 0) ? row % m : m - 1 - row % m;
+
+        unsigned int t = tag[s];
+        pdata.pos[t] = make_scalar3(-L/Scalar(2.0) + (Scalar(i) + Scalar(0.5))*a + jitter(),
+                                    -L/Scalar(2.0) + (Scalar(j) + Scalar(0.5))*a + jitter(),
+                                    -L/Scalar(2.0) + (Scalar(k) + Scalar(0.5))*a + jitter());
+        pdata.vel[t] = make_scalar3(gauss(), gauss(), gauss());
+        pdata.type[t] = s % 2;
+        pdata.charge[t] = (s % 2 == 0) ? Scalar(1.0) : Scalar(-1.0);
+        }
+
+    if (bonded)
+        {
+        snap->bond_data.type_mapping[0] = "A";
+        snap->angle_data.type_mapping[0] = "A";
+        snap->dihedral_data.type_mapping[0] = "A";
+        snap->improper_data.type_mapping[0] = "A";
+
+        unsigned int len = std::max(params.chain_length, (unsigned int)4);
+        for (unsigned int s = 0; s < N; s++)
+            {
+            unsigned int pos_in_chain = s % len;
+            unsigned int left = std::min(len, N - (s - pos_in_chain)) - pos_in_chain;
+
+            if (left >= 2)
+                {
+                BondData::members_t b;
+                b.tag[0] = tag[s]; b.tag[1] = tag[s+1];
+                snap->bond_data.groups.push_back(b);
+                snap->bond_data.type_id.push_back(0);
+                }
+            if (left >= 3)
+                {
+                AngleData::members_t b;
+                b.tag[0] = tag[s]; b.tag[1] = tag[s+1]; b.tag[2] = tag[s+2];
+                snap->angle_data.groups.push_back(b);
+                snap->angle_data.type_id.push_back(0);
+                }
+            if (left >= 4)
+                {
+                DihedralData::members_t b;
+                b.tag[0] = tag[s]; b.tag[1] = tag[s+1]; b.tag[2] = tag[s+2]; b.tag[3] = tag[s+3];
+                snap->dihedral_data.groups.push_back(b);
+                snap->dihedral_data.type_id.push_back(0);
+                snap->improper_data.groups.push_back(b);
+                snap->improper_data.type_id.push_back(0);
+                }
+            }
+        }
+
+    boost::shared_ptr<DomainDecomposition> decomposition;
+    #ifdef ENABLE_MPI
+    if (decompose)
+        decomposition = boost::shared_ptr<DomainDecomposition>(new DomainDecomposition(exec_conf, snap->global_box.getL()));
+    #endif
+
+    boost::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf, decomposition));
+
+    if (params.sorted)
+        {
+        boost::shared_ptr<SFCPackUpdater> sorter;
+        #ifdef ENABLE_CUDA
+        if (exec_conf->isCUDAEnabled())
+            sorter = boost::shared_ptr<SFCPackUpdater>(new SFCPackUpdaterGPU(sysdef));
+        else
+        #endif
+            sorter = boost::shared_ptr<SFCPackUpdater>(new SFCPackUpdater(sysdef));
+        sorter->update(0);
+        }
+
+    return sysdef;
+    }
+
+/*! The sample standard deviation is 0 when there is only one sample.
+*/
+void BenchmarkResult::computeStats()
+    {
+    mean = stddev = min = median = max = 0.0;
+    if (samples.size() == 0)
+        return;
+
+    vector<double> sorted(samples);
+    std::sort(sorted.begin(), sorted.end());
+    min = sorted.front();
+    max = sorted.back();
+    unsigned int n = (unsigned int)sorted.size();
+    median = (n % 2 == 1) ? sorted[n/2] : 0.5*(sorted[n/2-1] + sorted[n/2]);
+
+    for (unsigned int i = 0; i < n; i++)
+        mean += sorted[i];
+    mean /= double(n);
+
+    if (n > 1)
+        {
+        for (unsigned int i = 0; i < n; i++)
+            stddev += (sorted[i] - mean)*(sorted[i] - mean);
+        stddev = sqrt(stddev / double(n-1));
+        }
+    }
+
+/*! \param exec_conf Execution configuration
+    \param params Parameters of the systems and the timing loop
+    \param filters Substrings of "suite.name" that select benchmarks (empty to select all)
+*/
+BenchmarkRunner::BenchmarkRunner(boost::shared_ptr<ExecutionConfiguration> exec_conf,
+                                 const BenchmarkParams& params,
+                                 const std::vector<std::string>& filters)
+    : m_exec_conf(exec_conf), m_params(params), m_filters(filters), m_timestep(0)
+    {
+    if (m_params.iters == 0 || m_params.samples == 0)
+        {
+        m_exec_conf->msg->error() << "benchmark: iters and samples must be positive" << endl;
+        throw runtime_error("Error setting up the benchmarks");
+        }
+    }
+
+/*! \param name Name of the benchmark in the current suite
+*/
+bool BenchmarkRunner::isSelected(const std::string& name) const
+    {
+    if (m_filters.size() == 0)
+        return true;
+
+    string full_name = m_suite + "." + name;
+    for (unsigned int i = 0; i < m_filters.size(); i++)
+        {
+        if (full_name.find(m_filters[i]) != string::npos)
+            return true;
+        }
+    return false;
+    }
+
+/*! \param names Names of all benchmarks in the current suite
+
+    Suites check this before they build their system.
+*/
+bool BenchmarkRunner::isSuiteSelected(const std::vector<std::string>& names) const
+    {
+    for (unsigned int i = 0; i < names.size(); i++)
+        {
+        if (isSelected(names[i]))
+            return true;
+        }
+    return false;
+    }
+
+void BenchmarkRunner::sync()
+    {
+    #ifdef ENABLE_CUDA
+    if (m_exec_conf->isCUDAEnabled())
+        {
+        cudaThreadSynchronize();
+        CHECK_CUDA_ERROR();
+        }
+    #endif
+    }
+
+/*! \param name Name of the benchmark
+    \param step Function that performs one iteration, it is passed an increasing time step
+    \param reset Optional function that restores the input of \a step, called before every iteration
+
+    With a reset function, every iteration is timed on its own so that the resets are left out of the samples.
+*/
+void BenchmarkRunner::time(const std::string& name,
+                           boost::function<void (unsigned int)> step,
+                           boost::function<void ()> reset)
+    {
+    if (!isSelected(name))
+        return;
+
+    for (unsigned int i = 0; i < m_params.warmup; i++)
+        {
+        if (reset)
+            reset();
+        step(m_timestep++);
+        }
+    sync();
+
+    ClockSource clk;
+    vector<double> samples(m_params.samples);
+    for (unsigned int s = 0; s < m_params.samples; s++)
+        {
+        int64_t elapsed = 0;
+        if (reset)
+            {
+            for (unsigned int i = 0; i < m_params.iters; i++)
+                {
+                reset();
+                sync();
+                int64_t start = clk.getTime();
+                step(m_timestep++);
+                sync();
+                elapsed += clk.getTime() - start;
+                }
+            }
+        else
+            {
+            int64_t start = clk.getTime();
+            for (unsigned int i = 0; i < m_params.iters; i++)
+                step(m_timestep++);
+            sync();
+            elapsed = clk.getTime() - start;
+            }
+        samples[s] = double(elapsed) / 1e6 / double(m_params.iters);
+        }
+
+    addResult(name, samples);
+    }
+
+/*! \param name Name of the benchmark
+    \param hook Compute::benchmark() style function: it is passed the number of iterations and returns the mean time
+           of one iteration in milliseconds
+
+    The hooks warm up and synchronize on their own. Only the first sample is preceded by extra warmup iterations.
+*/
+void BenchmarkRunner::timeHook(const std::string& name, boost::function<double (unsigned int)> hook)
+    {
+    if (!isSelected(name))
+        return;
+
+    if (m_params.warmup > 0)
+        hook(m_params.warmup);
+
+    vector<double> samples(m_params.samples);
+    for (unsigned int s = 0; s < m_params.samples; s++)
+        samples[s] = hook(m_params.iters);
+
+    addResult(name, samples);
+    }
+
+/*! \param name Name of the benchmark
+    \param samples Samples measured on this rank
+*/
+void BenchmarkRunner::addResult(const std::string& name, std::vector<double>& samples)
+    {
+    #ifdef ENABLE_MPI
+    MPI_Allreduce(MPI_IN_PLACE, &samples.front(), (int)samples.size(), MPI_DOUBLE, MPI_MAX,
+                  m_exec_conf->getMPICommunicator());
+    #endif
+
+    BenchmarkResult result;
+    result.suite = m_suite;
+    result.name = name;
+    result.N = m_params.N;
+    result.samples = samples;
+    result.computeStats();
+    m_results.push_back(result);
+
+    m_exec_conf->msg->notice(2) << "benchmark: " << setw(32) << left << (m_suite + "." + name) << right
+                                << setprecision(5) << result.median << " ms" << endl;
+    }
+
+/*! \param o Stream to write to
+
+    The output is a single object with the build and run parameters in "config" and one entry per benchmark in
+    "results". All times are milliseconds per iteration.
+*/
+void BenchmarkRunner::writeJSON(std::ostream& o) const
+    {
+    o << setprecision(8);
+    o << "{" << endl;
+    o << "  \"config\": {" << endl;
+    o << "    \"mode\": \"" << (m_exec_conf->isCUDAEnabled() ? "gpu" : "cpu") << "\"," << endl;
+    #ifdef SINGLE_PRECISION
+    o << "    \"precision\": \"single\"," << endl;
+    #else
+    o << "    \"precision\": \"double\"," << endl;
+    #endif
+    #ifdef ENABLE_MPI
+    o << "    \"ranks\": " << m_exec_conf->getNRanks() << "," << endl;
+    #else
+    o << "    \"ranks\": 1," << endl;
+    #endif
+    o << "    \"N\": " << m_params.N << "," << endl;
+    o << "    \"density\": " << m_params.density << "," << endl;
+    o << "    \"chain_length\": " << m_params.chain_length << "," << endl;
+    o << "    \"seed\": " << m_params.seed << "," << endl;
+    o << "    \"sorted\": " << (m_params.sorted ? "true" : "false") << "," << endl;
+    o << "    \"r_cut\": " << m_params.r_cut << "," << endl;
+    o << "    \"r_buff\": " << m_params.r_buff << "," << endl;
+    o << "    \"warmup\": " << m_params.warmup << "," << endl;
+    o << "    \"iters\": " << m_params.iters << "," << endl;
+    o << "    \"samples\": " << m_params.samples << endl;
+    o << "  }," << endl;
+    o << "  \"results\": [";
+
+    for (unsigned int i = 0; i < m_results.size(); i++)
+        {
+        const BenchmarkResult& r = m_results[i];
+        o << (i == 0 ? "" : ",") << endl;
+        o << "    {\"suite\": \"" << r.suite << "\", \"name\": \"" << r.name << "\", \"N\": " << r.N
+          << ", \"mean\": " << r.mean << ", \"stddev\": " << r.stddev << ", \"min\": " << r.min
+          << ", \"median\": " << r.median << ", \"max\": " << r.max << ", \"samples\": [";
+        for (unsigned int s = 0; s < r.samples.size(); s++)
+            o << (s == 0 ? "" : ", ") << r.samples[s];
+        o << "]}";
+        }
+
+    o << endl << "  ]" << endl << "}" << endl;
+    }
+
+/*! \param o Stream to write to
+
+    One line per benchmark, times in milliseconds per iteration. The \c n_samples column holds the number of samples,
+    the individual samples are only written by writeJSON().
+*/
+void BenchmarkRunner::writeCSV(std::ostream& o) const
+    {
+    o << setprecision(8);
+    o << "suite,name,N,mean,stddev,min,median,max,n_samples" << endl;
+    for (unsigned int i = 0; i < m_results.size(); i++)
+        {
+        const BenchmarkResult& r = m_results[i];
+        o << r.suite << "," << r.name << "," << r.N << "," << r.mean << "," << r.stddev << "," << r.min << ","
+          << r.median << "," << r.max << "," << r.samples.size() << endl;
+        }
+    }
+
+#ifdef WIN32
+#pragma warning( pop )
+#endif
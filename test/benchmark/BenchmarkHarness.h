@@ -0,0 +1,216 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+/*! \file BenchmarkHarness.h
+    \brief Declares the synthetic systems and the timing harness of the microbenchmarks
+    \ingroup benchmarks
+*/
+
+#include "HOOMDMath.h"
+#include "SystemDefinition.h"
+
+#include <string>
+#include <vector>
+#include <ostream>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/function.hpp>
+
+#ifndef __BENCHMARK_HARNESS_H__
+#define __BENCHMARK_HARNESS_H__
+
+//! Parameters of the synthetic systems and of the timing loop
+struct BenchmarkParams
+    {
+    //! Default parameters
+    BenchmarkParams()
+        : N(64000), density(Scalar(0.84)), chain_length(16), seed(12345), sorted(true),
+          r_cut(Scalar(3.0)), r_buff(Scalar(0.4)), warmup(5), iters(10), samples(10)
+        {
+        }
+
+    unsigned int N;             //!< Number of particles
+    Scalar density;             //!< Number density
+    unsigned int chain_length;  //!< Number of particles in each chain of the bonded systems
+    unsigned int seed;          //!< Random number seed the system is generated with
+    bool sorted;                //!< True to sort the particles along a space filling curve before timing
+    Scalar r_cut;               //!< Cutoff radius of the pair potentials
+    Scalar r_buff;              //!< Neighbor list buffer width
+    unsigned int warmup;        //!< Number of untimed iterations before the first sample
+    unsigned int iters;         //!< Number of iterations in each sample
+    unsigned int samples;       //!< Number of timed samples
+    };
+
+//! Timing statistics of one benchmark
+struct BenchmarkResult
+    {
+    std::string suite;              //!< Suite the benchmark belongs to
+    std::string name;               //!< Name of the benchmark
+    unsigned int N;                 //!< Number of particles in the system
+    std::vector<double> samples;    //!< Milliseconds per iteration in each sample
+    double mean;                    //!< Mean of the samples
+    double stddev;                  //!< Sample standard deviation
+    double min;                     //!< Fastest sample
+    double median;                  //!< Median sample
+    double max;                     //!< Slowest sample
+
+    //! Compute the statistics from the samples
+    void computeStats();
+    };
+
+//! Build a synthetic system with reproducible inputs
+boost::shared_ptr<SystemDefinition> makeSyntheticSystem(boost::shared_ptr<ExecutionConfiguration> exec_conf,
+                                                        const BenchmarkParams& params,
+                                                        bool bonded,
+                                                        bool decompose=false);
+
+//! Times benchmarks and collects their results
+/*! Each benchmark is run \a warmup times untimed, then timed in \a samples samples of \a iters iterations each. A
+    sample is the mean time of one iteration, in milliseconds. The GPU is synchronized at the end of every sample, so
+    the samples include all kernels launched in the iterations. Under MPI, every sample is the slowest of all ranks.
+
+    Benchmarks are given either as a function that performs one iteration (time()), or as one of the existing
+    Compute::benchmark() hooks (timeHook()), which take the number of iterations and return the mean time per
+    iteration. A benchmark that changes its own input, like a sort, passes time() a reset function that restores the
+    input before every iteration. The reset is not timed.
+
+    Benchmarks are selected by substring filters on "suite.name". With no filters, all benchmarks run.
+
+    \ingroup benchmarks
+*/
+class BenchmarkRunner
+    {
+    public:
+        //! Constructor
+        BenchmarkRunner(boost::shared_ptr<ExecutionConfiguration> exec_conf,
+                        const BenchmarkParams& params,
+                        const std::vector<std::string>& filters);
+
+        //! Get the execution configuration
+        boost::shared_ptr<ExecutionConfiguration> getExecConf() const
+            {
+            return m_exec_conf;
+            }
+
+        //! Get the parameters
+        const BenchmarkParams& getParams() const
+            {
+            return m_params;
+            }
+
+        //! Set the suite that the following benchmarks belong to
+        void setSuite(const std::string& suite)
+            {
+            m_suite = suite;
+            }
+
+        //! Test if a benchmark in the current suite is selected
+        bool isSelected(const std::string& name) const;
+
+        //! Test if any benchmark in the current suite is selected
+        bool isSuiteSelected(const std::vector<std::string>& names) const;
+
+        //! Time a function that performs one iteration
+        void time(const std::string& name,
+                  boost::function<void (unsigned int)> step,
+                  boost::function<void ()> reset = boost::function<void ()>());
+
+        //! Time one of the Compute::benchmark() hooks
+        void timeHook(const std::string& name, boost::function<double (unsigned int)> hook);
+
+        //! Get the results
+        const std::vector<BenchmarkResult>& getResults() const
+            {
+            return m_results;
+            }
+
+        //! Write the results as JSON
+        void writeJSON(std::ostream& o) const;
+
+        //! Write the results as CSV
+        void writeCSV(std::ostream& o) const;
+
+    private:
+        boost::shared_ptr<ExecutionConfiguration> m_exec_conf;  //!< Execution configuration
+        BenchmarkParams m_params;                               //!< Parameters
+        std::vector<std::string> m_filters;                     //!< Selected benchmarks
+        std::string m_suite;                                    //!< Current suite
+        std::vector<BenchmarkResult> m_results;                 //!< Results so far
+        unsigned int m_timestep;                                //!< Time step of the next iteration
+
+        //! Wait for all work on the GPU to finish
+        void sync();
+
+        //! Add a result, taking the slowest rank for each sample
+        void addResult(const std::string& name, std::vector<double>& samples);
+    };
+
+//! Signature of a benchmark suite
+typedef void (*benchmark_suite)(BenchmarkRunner& runner);
+
+//! Times CellList::compute()
+void bmark_cell_list(BenchmarkRunner& runner);
+//! Times NeighborListBinned builds
+void bmark_nlist(BenchmarkRunner& runner);
+//! Times each PotentialPair evaluator
+void bmark_pair(BenchmarkRunner& runner);
+//! Times the bonded force computes
+void bmark_bonded(BenchmarkRunner& runner);
+//! Times the stages of PPPMForceCompute
+void bmark_pppm(BenchmarkRunner& runner);
+//! Times SFCPackUpdater
+void bmark_sort(BenchmarkRunner& runner);
+//! Times integrator steps
+void bmark_integrate(BenchmarkRunner& runner);
+//! Times the Communicator pack/exchange/unpack steps
+void bmark_comm(BenchmarkRunner& runner);
+
+#endif
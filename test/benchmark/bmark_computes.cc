@@ -0,0 +1,353 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+/*! \file bmark_computes.cc
+    \brief Benchmark suites of the cell list, neighbor list and force computes
+    \ingroup benchmarks
+*/
+
+#ifdef WIN32
+#pragma warning( push )
+#pragma warning( disable : 4103 4244 )
+#endif
+
+#include "BenchmarkHarness.h"
+
+#include "CellList.h"
+#include "NeighborListBinned.h"
+#include "AllPairPotentials.h"
+#include "AllBondPotentials.h"
+#include "PotentialPairFused.h"
+#include "HarmonicAngleForceCompute.h"
+#include "HarmonicDihedralForceCompute.h"
+#include "HarmonicImproperForceCompute.h"
+#include "PPPMForceCompute.h"
+
+#ifdef ENABLE_CUDA
+#include "CellListGPU.h"
+#include "NeighborListGPUBinned.h"
+#include "HarmonicAngleForceComputeGPU.h"
+#include "HarmonicDihedralForceComputeGPU.h"
+#include "HarmonicImproperForceComputeGPU.h"
+#include "PPPMForceComputeGPU.h"
+#endif
+
+#include <boost/bind.hpp>
+
+using namespace std;
+using namespace boost;
+
+//! Create the neighbor list used by the force benchmarks
+static boost::shared_ptr<NeighborList> make_nlist(boost::shared_ptr<SystemDefinition> sysdef, const BenchmarkParams& params)
+    {
+    boost::shared_ptr<NeighborList> nlist;
+    #ifdef ENABLE_CUDA
+    if (sysdef->getParticleData()->getExecConf()->isCUDAEnabled())
+        nlist = boost::shared_ptr<NeighborList>(new NeighborListGPUBinned(sysdef, params.r_cut, params.r_buff));
+    else
+    #endif
+        nlist = boost::shared_ptr<NeighborList>(new NeighborListBinned(sysdef, params.r_cut, params.r_buff));
+    return nlist;
+    }
+
+//! Create a pair potential on the CPU or the GPU and set the same parameters for all type pairs
+template<class T, class T_gpu>
+static boost::shared_ptr<T> make_pair_potential(boost::shared_ptr<SystemDefinition> sysdef,
+                                      boost::shared_ptr<NeighborList> nlist,
+                                      Scalar r_cut,
+                                      const typename T::param_type& param)
+    {
+    boost::shared_ptr<T> pair;
+    #ifdef ENABLE_CUDA
+    if (sysdef->getParticleData()->getExecConf()->isCUDAEnabled())
+        pair = boost::shared_ptr<T>(new T_gpu(sysdef, nlist));
+    else
+    #endif
+        pair = boost::shared_ptr<T>(new T(sysdef, nlist));
+
+    unsigned int ntypes = sysdef->getParticleData()->getNTypes();
+    for (unsigned int i = 0; i < ntypes; i++)
+        for (unsigned int j = i; j < ntypes; j++)
+            {
+            pair->setParams(i, j, param);
+            pair->setRcut(i, j, r_cut);
+            }
+    return pair;
+    }
+
+#ifdef ENABLE_CUDA
+//! Create a pair potential on the CPU or the GPU
+#define MAKE_PAIR(name, sysdef, nlist, r_cut, param) make_pair_potential<PotentialPair##name, PotentialPair##name##GPU>(sysdef, nlist, r_cut, param)
+#else
+//! Create a pair potential on the CPU
+#define MAKE_PAIR(name, sysdef, nlist, r_cut, param) make_pair_potential<PotentialPair##name, PotentialPair##name>(sysdef, nlist, r_cut, param)
+#endif
+
+/*! Times CellList::computeCellList() through CellList::benchmark(). The cell width is the neighbor list cutoff
+    plus buffer, as NeighborListBinned uses.
+*/
+void bmark_cell_list(BenchmarkRunner& runner)
+    {
+    runner.setSuite("cell_list");
+    if (!runner.isSelected("compute"))
+        return;
+
+    const BenchmarkParams& params = runner.getParams();
+    boost::shared_ptr<SystemDefinition> sysdef = makeSyntheticSystem(runner.getExecConf(), params, false);
+
+    boost::shared_ptr<CellList> cl;
+    #ifdef ENABLE_CUDA
+    if (runner.getExecConf()->isCUDAEnabled())
+        cl = boost::shared_ptr<CellList>(new CellListGPU(sysdef));
+    else
+    #endif
+        cl = boost::shared_ptr<CellList>(new CellList(sysdef));
+
+    cl->setNominalWidth(params.r_cut + params.r_buff);
+    cl->setRadius(1);
+    cl->setFlagIndex();
+
+    runner.timeHook("compute", boost::bind(&CellList::benchmark, cl, _1));
+    }
+
+/*! Times full neighbor list builds (cell list included) through NeighborList::benchmark(), with and without
+    the third law.
+*/
+void bmark_nlist(BenchmarkRunner& runner)
+    {
+    runner.setSuite("nlist");
+    vector<string> names;
+    names.push_back("binned_full");
+    names.push_back("binned_half");
+    if (!runner.isSuiteSelected(names))
+        return;
+
+    const BenchmarkParams& params = runner.getParams();
+    boost::shared_ptr<SystemDefinition> sysdef = makeSyntheticSystem(runner.getExecConf(), params, false);
+    boost::shared_ptr<NeighborList> nlist = make_nlist(sysdef, params);
+
+    nlist->setStorageMode(NeighborList::full);
+    runner.timeHook("binned_full", boost::bind(&NeighborList::benchmark, nlist, _1));
+
+    // the GPU only builds full lists
+    if (!runner.getExecConf()->isCUDAEnabled())
+        {
+        nlist->setStorageMode(NeighborList::half);
+        runner.timeHook("binned_half", boost::bind(&NeighborList::benchmark, nlist, _1));
+        }
+    }
+
+/*! Times the force evaluation of every PotentialPair evaluator through ForceCompute::benchmark(). All potentials
+    share one neighbor list, which is built once. The parameters put the evaluators in their typical regime for a
+    liquid at the benchmark density. The DPD potentials are timed with their conservative part only.
+*/
+void bmark_pair(BenchmarkRunner& runner)
+    {
+    runner.setSuite("pair");
+    const char *names_c[] = {"lj", "gauss", "slj", "yukawa", "ewald", "ewald_fast_erfc", "morse", "dpd_conservative",
+                             "moliere", "zbl", "dpdlj_conservative", "force_shifted_lj", "fused_lj_yukawa_ewald"};
+    vector<string> names(names_c, names_c + sizeof(names_c)/sizeof(names_c[0]));
+    if (!runner.isSuiteSelected(names))
+        return;
+
+    const BenchmarkParams& params = runner.getParams();
+    boost::shared_ptr<SystemDefinition> sysdef = makeSyntheticSystem(runner.getExecConf(), params, false);
+    boost::shared_ptr<NeighborList> nlist = make_nlist(sysdef, params);
+    Scalar r_cut = params.r_cut;
+
+    // lj1 and lj2 for epsilon = sigma = 1
+    Scalar2 lj = make_scalar2(Scalar(4.0), Scalar(4.0));
+
+    vector< std::pair<string, boost::shared_ptr<ForceCompute> > > pairs;
+    pairs.push_back(std::make_pair(string("lj"), MAKE_PAIR(LJ, sysdef, nlist, r_cut, lj)));
+    pairs.push_back(std::make_pair(string("gauss"),
+                              MAKE_PAIR(Gauss, sysdef, nlist, r_cut, make_scalar2(Scalar(1.0), Scalar(0.5)))));
+    pairs.push_back(std::make_pair(string("slj"), MAKE_PAIR(SLJ, sysdef, nlist, r_cut, lj)));
+    pairs.push_back(std::make_pair(string("yukawa"),
+                              MAKE_PAIR(Yukawa, sysdef, nlist, r_cut, make_scalar2(Scalar(1.0), Scalar(1.0)))));
+    pairs.push_back(std::make_pair(string("ewald"),
+                              MAKE_PAIR(Ewald, sysdef, nlist, r_cut, make_scalar2(Scalar(1.0), Scalar(0.0)))));
+    pairs.push_back(std::make_pair(string("ewald_fast_erfc"),
+                              MAKE_PAIR(Ewald, sysdef, nlist, r_cut, make_scalar2(Scalar(1.0), Scalar(1.0)))));
+    pairs.push_back(std::make_pair(string("morse"),
+                              MAKE_PAIR(Morse, sysdef, nlist, r_cut,
+                                        make_scalar4(Scalar(1.0), Scalar(3.0), Scalar(1.0), Scalar(0.0)))));
+    pairs.push_back(std::make_pair(string("dpd_conservative"),
+                              MAKE_PAIR(DPD, sysdef, nlist, r_cut, make_scalar2(Scalar(25.0), Scalar(4.5)))));
+    pairs.push_back(std::make_pair(string("moliere"),
+                              MAKE_PAIR(Moliere, sysdef, nlist, r_cut, make_scalar2(Scalar(1.0), Scalar(1.0)))));
+    pairs.push_back(std::make_pair(string("zbl"),
+                              MAKE_PAIR(ZBL, sysdef, nlist, r_cut, make_scalar2(Scalar(1.0), Scalar(1.0)))));
+    pairs.push_back(std::make_pair(string("dpdlj_conservative"),
+                              MAKE_PAIR(DPDLJ, sysdef, nlist, r_cut,
+                                        make_scalar4(lj.x, lj.y, Scalar(4.5), Scalar(0.0)))));
+    pairs.push_back(std::make_pair(string("force_shifted_lj"), MAKE_PAIR(ForceShiftedLJ, sysdef, nlist, r_cut, lj)));
+
+    for (unsigned int i = 0; i < pairs.size(); i++)
+        runner.timeHook(pairs[i].first, boost::bind(&ForceCompute::benchmark, pairs[i].second, _1));
+
+    // fused evaluation of the potentials of a typical charged system, CPU only
+    if (!runner.getExecConf()->isCUDAEnabled())
+        {
+        boost::shared_ptr<PotentialPairFused> fused(new PotentialPairFused(sysdef, nlist));
+        fused->addPotential(MAKE_PAIR(LJ, sysdef, nlist, r_cut, lj));
+        fused->addPotential(MAKE_PAIR(Yukawa, sysdef, nlist, r_cut, make_scalar2(Scalar(1.0), Scalar(1.0))));
+        fused->addPotential(MAKE_PAIR(Ewald, sysdef, nlist, r_cut, make_scalar2(Scalar(1.0), Scalar(0.0))));
+        runner.timeHook("fused_lj_yukawa_ewald", boost::bind(&ForceCompute::benchmark, fused, _1));
+        }
+    }
+
+/*! Times the bonded force computes on a system of linear chains, where every particle takes part in one bond,
+    angle, dihedral and improper.
+*/
+void bmark_bonded(BenchmarkRunner& runner)
+    {
+    runner.setSuite("bonded");
+    const char *names_c[] = {"bond_harmonic", "bond_fene", "angle_harmonic", "dihedral_harmonic", "improper_harmonic"};
+    vector<string> names(names_c, names_c + sizeof(names_c)/sizeof(names_c[0]));
+    if (!runner.isSuiteSelected(names))
+        return;
+
+    boost::shared_ptr<ExecutionConfiguration> exec_conf = runner.getExecConf();
+    boost::shared_ptr<SystemDefinition> sysdef = makeSyntheticSystem(exec_conf, runner.getParams(), true);
+
+    boost::shared_ptr<PotentialBondHarmonic> harmonic;
+    boost::shared_ptr<PotentialBondFENE> fene;
+    boost::shared_ptr<HarmonicAngleForceCompute> angle;
+    boost::shared_ptr<HarmonicDihedralForceCompute> dihedral;
+    boost::shared_ptr<HarmonicImproperForceCompute> improper;
+
+    #ifdef ENABLE_CUDA
+    if (exec_conf->isCUDAEnabled())
+        {
+        harmonic = boost::shared_ptr<PotentialBondHarmonic>(new PotentialBondHarmonicGPU(sysdef));
+        fene = boost::shared_ptr<PotentialBondFENE>(new PotentialBondFENEGPU(sysdef));
+        angle = boost::shared_ptr<HarmonicAngleForceCompute>(new HarmonicAngleForceComputeGPU(sysdef));
+        dihedral = boost::shared_ptr<HarmonicDihedralForceCompute>(new HarmonicDihedralForceComputeGPU(sysdef));
+        improper = boost::shared_ptr<HarmonicImproperForceCompute>(new HarmonicImproperForceComputeGPU(sysdef));
+        }
+    else
+    #endif
+        {
+        harmonic = boost::shared_ptr<PotentialBondHarmonic>(new PotentialBondHarmonic(sysdef));
+        fene = boost::shared_ptr<PotentialBondFENE>(new PotentialBondFENE(sysdef));
+        angle = boost::shared_ptr<HarmonicAngleForceCompute>(new HarmonicAngleForceCompute(sysdef));
+        dihedral = boost::shared_ptr<HarmonicDihedralForceCompute>(new HarmonicDihedralForceCompute(sysdef));
+        improper = boost::shared_ptr<HarmonicImproperForceCompute>(new HarmonicImproperForceCompute(sysdef));
+        }
+
+    // bonds are about one lattice spacing long, keep FENE well inside r0
+    harmonic->setParams(0, make_scalar2(Scalar(330.0), Scalar(1.0)));
+    fene->setParams(0, make_scalar4(Scalar(30.0), Scalar(3.0), Scalar(1.0), Scalar(1.0)));
+    angle->setParams(0, Scalar(10.0), Scalar(M_PI/2.0));
+    dihedral->setParams(0, Scalar(5.0), 1, 3);
+    improper->setParams(0, Scalar(5.0), Scalar(0.0));
+
+    runner.timeHook("bond_harmonic", boost::bind(&ForceCompute::benchmark, harmonic, _1));
+    runner.timeHook("bond_fene", boost::bind(&ForceCompute::benchmark, fene, _1));
+    runner.timeHook("angle_harmonic", boost::bind(&ForceCompute::benchmark, angle, _1));
+    runner.timeHook("dihedral_harmonic", boost::bind(&ForceCompute::benchmark, dihedral, _1));
+    runner.timeHook("improper_harmonic", boost::bind(&ForceCompute::benchmark, improper, _1));
+    }
+
+/*! Times a complete PPPM force evaluation and, on the CPU, its stages: the charge assignment to the grid, the
+    multiplication with the influence function and the force interpolation. The FFTs are the difference between
+    the total and the sum of the stages. The grid has a spacing of at most 0.75 and a power of two points along each
+    direction.
+*/
+void bmark_pppm(BenchmarkRunner& runner)
+    {
+    runner.setSuite("pppm");
+    const char *names_c[] = {"total", "assign", "green", "interpolate"};
+    vector<string> names(names_c, names_c + sizeof(names_c)/sizeof(names_c[0]));
+    if (!runner.isSuiteSelected(names))
+        return;
+
+    boost::shared_ptr<ExecutionConfiguration> exec_conf = runner.getExecConf();
+    const BenchmarkParams& params = runner.getParams();
+    boost::shared_ptr<SystemDefinition> sysdef = makeSyntheticSystem(exec_conf, params, false);
+    boost::shared_ptr<NeighborList> nlist = make_nlist(sysdef, params);
+
+    boost::shared_ptr<ParticleSelector> selector_all(new ParticleSelectorTag(sysdef, 0, params.N-1));
+    boost::shared_ptr<ParticleGroup> group_all(new ParticleGroup(sysdef, selector_all));
+
+    boost::shared_ptr<PPPMForceCompute> pppm;
+    #ifdef ENABLE_CUDA
+    if (exec_conf->isCUDAEnabled())
+        pppm = boost::shared_ptr<PPPMForceCompute>(new PPPMForceComputeGPU(sysdef, nlist, group_all));
+    else
+    #endif
+        pppm = boost::shared_ptr<PPPMForceCompute>(new PPPMForceCompute(sysdef, nlist, group_all));
+
+    Scalar L = sysdef->getParticleData()->getGlobalBox().getL().x;
+    int n_grid = 1;
+    while (Scalar(n_grid) * Scalar(0.75) < L)
+        n_grid *= 2;
+    pppm->setParams(n_grid, n_grid, n_grid, 5, Scalar(1.0), params.r_cut);
+
+    // one evaluation allocates the grids and computes the influence function, the stages depend on it even when
+    // the total is not selected
+    pppm->compute(0);
+
+    runner.timeHook("total", boost::bind(&ForceCompute::benchmark, pppm, _1));
+
+    // the stage methods work on the host arrays, the GPU implementation is only timed as a whole
+    if (!exec_conf->isCUDAEnabled())
+        {
+        runner.time("assign", boost::bind(&PPPMForceCompute::assign_charges_to_grid, pppm));
+        runner.time("green", boost::bind(&PPPMForceCompute::combined_green_e, pppm));
+        runner.time("interpolate", boost::bind(&PPPMForceCompute::calculate_forces, pppm));
+        }
+    }
+
+#ifdef WIN32
+#pragma warning( pop )
+#endif
@@ -0,0 +1,237 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+/*! \file bmark_updaters.cc
+    \brief Benchmark suites of the particle sorter, the integrator and the communicator
+    \ingroup benchmarks
+*/
+
+#ifdef WIN32
+#pragma warning( push )
+#pragma warning( disable : 4103 4244 )
+#endif
+
+#include "BenchmarkHarness.h"
+
+#include "SFCPackUpdater.h"
+#include "IntegratorTwoStep.h"
+#include "TwoStepNVE.h"
+#include "NeighborListBinned.h"
+#include "AllPairPotentials.h"
+
+#ifdef ENABLE_CUDA
+#include "SFCPackUpdaterGPU.h"
+#include "TwoStepNVEGPU.h"
+#include "NeighborListGPUBinned.h"
+#endif
+
+#ifdef ENABLE_MPI
+#include "Communicator.h"
+#ifdef ENABLE_CUDA
+#include "CommunicatorGPU.h"
+#endif
+#endif
+
+#include <boost/bind.hpp>
+
+using namespace std;
+using namespace boost;
+
+/*! Times one SFCPackUpdater::update(), which computes the Hilbert curve keys, sorts them and reorders the particle
+    data. The random initial order is restored from a snapshot before every iteration, otherwise all but the first
+    iteration would sort data that is already sorted.
+*/
+void bmark_sort(BenchmarkRunner& runner)
+    {
+    runner.setSuite("sort");
+    if (!runner.isSelected("sfc_pack"))
+        return;
+
+    BenchmarkParams params = runner.getParams();
+    params.sorted = false;
+    boost::shared_ptr<SystemDefinition> sysdef = makeSyntheticSystem(runner.getExecConf(), params, false);
+
+    boost::shared_ptr<SFCPackUpdater> sorter;
+    #ifdef ENABLE_CUDA
+    if (runner.getExecConf()->isCUDAEnabled())
+        sorter = boost::shared_ptr<SFCPackUpdater>(new SFCPackUpdaterGPU(sysdef));
+    else
+    #endif
+        sorter = boost::shared_ptr<SFCPackUpdater>(new SFCPackUpdater(sysdef));
+
+    boost::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    SnapshotParticleData snap;
+    pdata->takeSnapshot(snap);
+
+    runner.time("sfc_pack", boost::bind(&SFCPackUpdater::update, sorter, _1),
+                boost::bind(&ParticleData::initializeFromSnapshot, pdata, snap));
+    }
+
+/*! Times a complete IntegratorTwoStep step of an NVE LJ liquid, which includes the neighbor list distance check,
+    its rebuilds and the force computation, and then the two halves of the NVE velocity Verlet update on their own.
+*/
+void bmark_integrate(BenchmarkRunner& runner)
+    {
+    runner.setSuite("integrate");
+    const char *names_c[] = {"step_nve_lj", "nve_step_one", "nve_step_two"};
+    vector<string> names(names_c, names_c + sizeof(names_c)/sizeof(names_c[0]));
+    if (!runner.isSuiteSelected(names))
+        return;
+
+    boost::shared_ptr<ExecutionConfiguration> exec_conf = runner.getExecConf();
+    const BenchmarkParams& params = runner.getParams();
+    boost::shared_ptr<SystemDefinition> sysdef = makeSyntheticSystem(exec_conf, params, false);
+
+    boost::shared_ptr<ParticleSelector> selector_all(new ParticleSelectorTag(sysdef, 0, params.N-1));
+    boost::shared_ptr<ParticleGroup> group_all(new ParticleGroup(sysdef, selector_all));
+
+    boost::shared_ptr<TwoStepNVE> nve;
+    boost::shared_ptr<NeighborList> nlist;
+    boost::shared_ptr<PotentialPairLJ> lj;
+    #ifdef ENABLE_CUDA
+    if (exec_conf->isCUDAEnabled())
+        {
+        nve = boost::shared_ptr<TwoStepNVE>(new TwoStepNVEGPU(sysdef, group_all));
+        nlist = boost::shared_ptr<NeighborList>(new NeighborListGPUBinned(sysdef, params.r_cut, params.r_buff));
+        lj = boost::shared_ptr<PotentialPairLJ>(new PotentialPairLJGPU(sysdef, nlist));
+        }
+    else
+    #endif
+        {
+        nve = boost::shared_ptr<TwoStepNVE>(new TwoStepNVE(sysdef, group_all));
+        nlist = boost::shared_ptr<NeighborList>(new NeighborListBinned(sysdef, params.r_cut, params.r_buff));
+        lj = boost::shared_ptr<PotentialPairLJ>(new PotentialPairLJ(sysdef, nlist));
+        }
+
+    Scalar dt = Scalar(0.005);
+    nve->setDeltaT(dt);
+
+    // the full step goes first, while the system is still the generated one
+    if (runner.isSelected("step_nve_lj"))
+        {
+        for (unsigned int i = 0; i < sysdef->getParticleData()->getNTypes(); i++)
+            for (unsigned int j = i; j < sysdef->getParticleData()->getNTypes(); j++)
+                {
+                lj->setParams(i, j, make_scalar2(Scalar(4.0), Scalar(4.0)));
+                lj->setRcut(i, j, params.r_cut);
+                }
+
+        boost::shared_ptr<IntegratorTwoStep> integrator(new IntegratorTwoStep(sysdef, dt));
+        integrator->addIntegrationMethod(nve);
+        integrator->addForceCompute(lj);
+        integrator->prepRun(0);
+
+        runner.time("step_nve_lj", boost::bind(&IntegratorTwoStep::update, integrator, _1));
+        }
+
+    runner.time("nve_step_one", boost::bind(&TwoStepNVE::integrateStepOne, nve, _1));
+    runner.time("nve_step_two", boost::bind(&TwoStepNVE::integrateStepTwo, nve, _1));
+    }
+
+#ifdef ENABLE_MPI
+//! Migrate particles and rebuild the ghost layer, as done on every neighbor list rebuild
+static void migrate_exchange(boost::shared_ptr<Communicator> comm)
+    {
+    comm->migrateParticles();
+    comm->exchangeGhosts();
+    }
+
+//! Update the ghost positions, as done on every step without a rebuild
+static void update_ghosts(boost::shared_ptr<Communicator> comm, unsigned int timestep)
+    {
+    comm->beginUpdateGhosts(timestep);
+    comm->finishUpdateGhosts(timestep);
+    }
+#endif
+
+/*! Times the Communicator steps on the system split over all ranks: the migration of particles with the rebuild of
+    the ghost layer, which packs, exchanges and unpacks the complete particle data of all boundary particles, and the
+    update of the ghost positions. The ghost layer is r_cut + r_buff wide. The suite needs more than one rank.
+*/
+void bmark_comm(BenchmarkRunner& runner)
+    {
+    runner.setSuite("comm");
+    #ifdef ENABLE_MPI
+    const char *names_c[] = {"migrate_exchange", "update_ghosts"};
+    vector<string> names(names_c, names_c + sizeof(names_c)/sizeof(names_c[0]));
+    if (!runner.isSuiteSelected(names))
+        return;
+
+    boost::shared_ptr<ExecutionConfiguration> exec_conf = runner.getExecConf();
+    if (exec_conf->getNRanks() < 2)
+        {
+        exec_conf->msg->notice(2) << "benchmark: skipping the comm suite, it needs more than one rank" << endl;
+        return;
+        }
+
+    const BenchmarkParams& params = runner.getParams();
+    boost::shared_ptr<SystemDefinition> sysdef = makeSyntheticSystem(exec_conf, params, false, true);
+    boost::shared_ptr<DomainDecomposition> decomposition = sysdef->getParticleData()->getDomainDecomposition();
+
+    boost::shared_ptr<Communicator> comm;
+    #ifdef ENABLE_CUDA
+    if (exec_conf->isCUDAEnabled())
+        comm = boost::shared_ptr<Communicator>(new CommunicatorGPU(sysdef, decomposition));
+    else
+    #endif
+        comm = boost::shared_ptr<Communicator>(new Communicator(sysdef, decomposition));
+
+    comm->setGhostLayerWidth(params.r_cut + params.r_buff);
+    migrate_exchange(comm);
+
+    runner.time("migrate_exchange", boost::bind(&migrate_exchange, comm));
+    runner.time("update_ghosts", boost::bind(&update_ghosts, comm, _1));
+    #endif
+    }
+
+#ifdef WIN32
+#pragma warning( pop )
+#endif
@@ -0,0 +1,242 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+/*! \file hoomd_benchmark.cc
+    \brief Command line driver of the microbenchmarks
+    \ingroup benchmarks
+*/
+
+/*! \addtogroup benchmarks
+
+    hoomd_benchmark times the core kernels of HOOMD-blue on synthetic systems with reproducible inputs and writes the
+    timing statistics as JSON or CSV. Its results from different builds can be compared directly, as long as the
+    systems and the timing loop are given the same options. It is built with <tt>make hoomd_benchmark</tt>.
+
+    The benchmarks, named suite.name, are:
+     - cell_list.compute
+     - nlist.binned_full, nlist.binned_half
+     - pair.lj, pair.gauss, pair.slj, pair.yukawa, pair.ewald, pair.ewald_fast_erfc, pair.morse,
+       pair.dpd_conservative, pair.moliere, pair.zbl, pair.dpdlj_conservative, pair.force_shifted_lj,
+       pair.fused_lj_yukawa_ewald
+     - bonded.bond_harmonic, bonded.bond_fene, bonded.angle_harmonic, bonded.dihedral_harmonic,
+       bonded.improper_harmonic
+     - pppm.total, pppm.assign, pppm.green, pppm.interpolate
+     - sort.sfc_pack
+     - integrate.step_nve_lj, integrate.nve_step_one, integrate.nve_step_two
+     - comm.migrate_exchange, comm.update_ghosts (MPI only, with more than one rank)
+
+    Benchmarks that are not implemented in the selected execution mode are left out.
+
+    \b Example:
+    \code
+    hoomd_benchmark --mode=cpu -N 32000 --filter pair. --output=pair.json
+    mpirun -n 8 hoomd_benchmark --filter comm.
+    \endcode
+*/
+
+#ifdef WIN32
+#pragma warning( push )
+#pragma warning( disable : 4103 4244 )
+#endif
+
+#include "BenchmarkHarness.h"
+#include "HOOMDVersion.h"
+
+#include <iostream>
+#include <fstream>
+#include <stdexcept>
+
+#include <boost/program_options.hpp>
+
+#ifdef ENABLE_MPI
+#include <mpi.h>
+#endif
+
+using namespace std;
+using namespace boost;
+namespace po = boost::program_options;
+
+//! Run the selected benchmarks and write their results
+int run_benchmarks(const po::variables_map& vm, const BenchmarkParams& params)
+    {
+    string mode_name = vm["mode"].as<string>();
+    ExecutionConfiguration::executionMode mode = ExecutionConfiguration::AUTO;
+    if (mode_name == "cpu")
+        mode = ExecutionConfiguration::CPU;
+    else if (mode_name == "gpu")
+        mode = ExecutionConfiguration::GPU;
+    else if (mode_name != "auto")
+        {
+        cerr << "***Error! --mode must be cpu, gpu or auto" << endl;
+        return 1;
+        }
+
+    boost::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(mode, vm["gpu"].as<int>()));
+    exec_conf->msg->setNoticeLevel(vm["notice-level"].as<unsigned int>());
+
+    vector<string> filters;
+    if (vm.count("filter"))
+        filters = vm["filter"].as< vector<string> >();
+
+    BenchmarkRunner runner(exec_conf, params, filters);
+
+    benchmark_suite suites[] = {bmark_cell_list, bmark_nlist, bmark_pair, bmark_bonded, bmark_pppm, bmark_sort,
+                                bmark_integrate, bmark_comm};
+    for (unsigned int i = 0; i < sizeof(suites)/sizeof(suites[0]); i++)
+        suites[i](runner);
+
+    // only the root rank writes the results
+    if (exec_conf->getRank() != 0)
+        return 0;
+
+    string format = vm["format"].as<string>();
+    ofstream file;
+    if (vm.count("output"))
+        {
+        file.open(vm["output"].as<string>().c_str());
+        if (!file.good())
+            {
+            exec_conf->msg->error() << "benchmark: unable to open " << vm["output"].as<string>() << endl;
+            return 1;
+            }
+        }
+    ostream& o = file.is_open() ? file : cout;
+
+    if (format == "csv")
+        runner.writeCSV(o);
+    else
+        runner.writeJSON(o);
+
+    return 0;
+    }
+
+//! Parse the options and run the benchmarks
+int main(int argc, char **argv)
+    {
+    BenchmarkParams params;
+
+    po::options_description desc("hoomd_benchmark options");
+    desc.add_options()
+        ("help,h", "print this help message")
+        ("mode", po::value<string>()->default_value("auto"), "execution mode: cpu, gpu or auto")
+        ("gpu", po::value<int>()->default_value(-1), "GPU to run on (-1 to select automatically)")
+        ("particles,N", po::value<unsigned int>(&params.N)->default_value(params.N), "number of particles")
+        ("density", po::value<Scalar>(&params.density)->default_value(params.density), "number density")
+        ("chain-length", po::value<unsigned int>(&params.chain_length)->default_value(params.chain_length),
+            "number of particles per chain in the bonded systems")
+        ("seed", po::value<unsigned int>(&params.seed)->default_value(params.seed), "random number seed")
+        ("unsorted", "do not sort the particles before timing")
+        ("r-cut", po::value<Scalar>(&params.r_cut)->default_value(params.r_cut), "pair potential cutoff")
+        ("r-buff", po::value<Scalar>(&params.r_buff)->default_value(params.r_buff), "neighbor list buffer")
+        ("warmup", po::value<unsigned int>(&params.warmup)->default_value(params.warmup),
+            "untimed iterations before the first sample")
+        ("iters", po::value<unsigned int>(&params.iters)->default_value(params.iters), "iterations per sample")
+        ("samples", po::value<unsigned int>(&params.samples)->default_value(params.samples), "number of samples")
+        ("filter", po::value< vector<string> >(), "run only benchmarks whose suite.name contains this (repeatable)")
+        ("format", po::value<string>()->default_value("json"), "output format: json or csv")
+        ("output,o", po::value<string>(), "file to write the results to (default: standard output)")
+        ("notice-level", po::value<unsigned int>()->default_value(2), "verbosity of the notices")
+        ;
+
+    po::variables_map vm;
+    try
+        {
+        po::store(po::parse_command_line(argc, argv, desc), vm);
+        po::notify(vm);
+        }
+    catch (std::exception& e)
+        {
+        cerr << "***Error! " << e.what() << endl << desc << endl;
+        return 1;
+        }
+
+    if (vm.count("help"))
+        {
+        cout << "HOOMD-blue " << HOOMD_VERSION_LONG << " microbenchmarks" << endl << desc << endl;
+        return 0;
+        }
+
+    string format = vm["format"].as<string>();
+    if (format != "json" && format != "csv")
+        {
+        cerr << "***Error! --format must be json or csv" << endl;
+        return 1;
+        }
+
+    params.sorted = (vm.count("unsorted") == 0);
+
+    #ifdef ENABLE_MPI
+    MPI_Init(&argc, &argv);
+    #endif
+
+    int result = 1;
+    try
+        {
+        result = run_benchmarks(vm, params);
+        }
+    catch (std::exception& e)
+        {
+        cerr << "***Error! " << e.what() << endl;
+        #ifdef ENABLE_MPI
+        MPI_Abort(MPI_COMM_WORLD, 1);
+        #endif
+        }
+
+    #ifdef ENABLE_MPI
+    MPI_Finalize();
+    #endif
+
+    return result;
+    }
+
+#ifdef WIN32
+#pragma warning( pop )
+#endif
@@ -4,6 +4,7 @@
 from hoomd_script import *
 import unittest
 import os
+import struct
 
 # unit tests for analyze.log
 class analyze_log_tests (unittest.TestCase):
@@ -28,6 +29,78 @@ class analyze_log_tests (unittest.TestCase):
         ana.set_params(quantities = ['test2', 'test3'], delimiter=',')
         run(100);
 
+    # test binary output, the flush period and the history buffer
+    def test_binary_history(self):
+        ana = analyze.log(quantities = ['test1', 'test2'], period = 10, filename="test.log", binary=True);
+        ana.set_params(flush_period = 5, history = 3);
+        run(100);
+        steps = ana.query_history('timestep');
+        self.assertEqual(len(steps), 3);
+        self.assertEqual(steps[2] - steps[1], 10);
+        self.assertEqual(steps[1] - steps[0], 10);
+        self.assertEqual(len(ana.query_history('test1')), 3);
+        self.assertRaises(RuntimeError, ana.set_params, flush_period = 0);
+        ana.set_params(quantities = ['test1', 'test2']);
+        self.assertRaises(RuntimeError, ana.set_params, quantities = ['test1']);
+
+    # read back the schema and rows of a binary log
+    def test_binary_file(self):
+        analyze.log(quantities = ['test1', 'test2'], period = 10, filename="test.log", header_prefix='#',
+                    overwrite=True, binary=True);
+        run(100);
+
+        if comm.get_rank() != 0:
+            return;
+
+        f = open("test.log", "rb");
+        data = f.read();
+        f.close();
+
+        self.assertEqual(data[0:8], b'HOOMDLOG');
+        (version, prefix_len) = struct.unpack_from('II', data, 8);
+        self.assertEqual(version, 2);
+        self.assertEqual(data[16:16+prefix_len], b'#');
+        pos = 16 + prefix_len;
+        (num_columns,) = struct.unpack_from('I', data, pos);
+        pos += 4;
+        columns = [];
+        for i in range(num_columns):
+            (name_len,) = struct.unpack_from('I', data, pos);
+            columns.append(data[pos+4:pos+4+name_len]);
+            pos += 4 + name_len;
+        self.assertEqual(columns, [b'timestep', b'test1', b'test2']);
+
+        # each row is a uint32 time step followed by one double per quantity, and there is only one schema
+        row = struct.Struct('=Idd');
+        self.assertEqual((len(data) - pos) % row.size, 0);
+        rows = [row.unpack_from(data, pos + i*row.size) for i in range((len(data) - pos) // row.size)];
+        self.assertEqual(len(rows), 10);
+        self.assertEqual([r[0] for r in rows], list(range(0, 100, 10)));
+        self.assertEqual(rows[3][1], 0.0);
+        self.assertEqual(rows[3][2], 0.0);
+        self.assertEqual(data.count(b'HOOMDLOG'), 1);
+
+    # appending to a binary log checks the schema already in the file
+    def test_binary_append(self):
+        analyze.log(quantities = ['test1', 'test2'], period = 10, filename="test.log", overwrite=True, binary=True);
+        run(10);
+
+        # matching quantities are appended
+        analyze.log(quantities = ['test1', 'test2'], period = 10, filename="test.log", binary=True);
+
+        # different quantities, a different prefix and a text log are rejected
+        self.assertRaises(RuntimeError, analyze.log, quantities = ['test1'], period = 10, filename="test.log",
+                          binary=True);
+        self.assertRaises(RuntimeError, analyze.log, quantities = ['test1', 'test2'], period = 10,
+                          filename="test.log", header_prefix='#', binary=True);
+
+        if comm.get_rank() == 0:
+            f = open("test.log", "w");
+            f.write("timestep\ttest1\ttest2\n");
+            f.close();
+        self.assertRaises(RuntimeError, analyze.log, quantities = ['test1', 'test2'], period = 10,
+                          filename="test.log", binary=True);
+
     # test variable period
     def test_variable(self):
         ana = analyze.log(quantities = ['test1', 'test2', 'test3'], period = lambda n: n*10, filename="test.log");
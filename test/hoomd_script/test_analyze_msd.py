@@ -33,6 +33,26 @@ class analyze_msd_tests (unittest.TestCase):
         ana.set_params(delimiter = ' ');
         run(100);
 
+    # test asynchronous output
+    def test_async(self):
+        analyze.set_async(num_threads=2, max_queue=2);
+        analyze.msd(period = 10, filename="test.log", groups=[group.all()]);
+        run(100);
+        if comm.get_rank() == 0:
+            f = open("test.log");
+            lines = f.readlines();
+            f.close();
+            # header + one row for each of steps 0, 10, ..., 90
+            self.assertEqual(len(lines), 11);
+        analyze.set_async(num_threads=0);
+
+    # test error if async set before initialization
+    def test_async_uninit(self):
+        init.reset();
+        self.assertRaises(RuntimeError, analyze.set_async);
+        init.create_random(N=100, phi_p=0.05);
+        analyze.msd(period = 10, filename="test.log", groups=[group.all()]);
+
     def tearDown(self):
         init.reset();
         if comm.get_rank() == 0:
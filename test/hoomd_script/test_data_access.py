@@ -4,6 +4,7 @@
 from hoomd_script import *
 import unittest
 import os
+import sys
 
 # tests for data access
 class particle_data_access_tests (unittest.TestCase):
@@ -95,6 +96,61 @@ class particle_data_access_tests (unittest.TestCase):
         self.assertAlmostEqual(3, t[2], 5)
         self.assertAlmostEqual(5, t[3], 5)
 
+    # tests bulk numpy access to the particles
+    def test_host_arrays(self):
+        try:
+            import numpy
+        except ImportError:
+            self.skipTest("numpy is not available");
+
+        p = self.s.particles[7].position;
+        with self.s.particles.host_arrays() as arrays:
+            self.assertEqual(len(arrays.tag), 100);
+            for i in range(len(arrays.tag)):
+                self.assertEqual(arrays.rtag[arrays.tag[i]], i);
+
+            idx = arrays.rtag[7];
+            self.assertAlmostEqual(p[0], arrays.position[idx,0], 5);
+            self.assertAlmostEqual(p[1], arrays.position[idx,1], 5);
+            self.assertAlmostEqual(p[2], arrays.position[idx,2], 5);
+
+            v = numpy.zeros((len(arrays.tag), 3));
+            v[:,0] = arrays.tag;
+            arrays.set_velocities(v);
+            arrays.velocity[idx,1] = 2.0;
+
+            pos = numpy.zeros((len(arrays.tag), 3));
+            pos[idx,0] = 1.5;
+            arrays.set_positions(pos);
+
+        self.assertAlmostEqual(7.0, self.s.particles[7].velocity[0], 5);
+        self.assertAlmostEqual(2.0, self.s.particles[7].velocity[1], 5);
+        self.assertAlmostEqual(1.5, self.s.particles[7].position[0], 5);
+
+        # the arrays must be released before running
+        arrays = self.s.particles.host_arrays();
+        self.assertRaises(RuntimeError, run, 1);
+        arrays.release();
+        run(1);
+
+        # tags cannot be modified
+        with self.s.particles.host_arrays() as arrays:
+            self.assertRaises(ValueError, arrays.tag.__setitem__, 0, 1);
+            self.assertRaises(ValueError, arrays.rtag.__setitem__, 0, 1);
+
+        # on python 3, release() invalidates the buffers behind the arrays
+        if sys.version_info[0] >= 3:
+            arrays = self.s.particles.host_arrays();
+            buffers = list(arrays._buffers);
+            arrays.release();
+            for buf in buffers:
+                self.assertRaises(ValueError, len, buf);
+
+        # an access that is collected without release() does not block the run
+        arrays = self.s.particles.host_arrays();
+        del arrays;
+        run(1);
+
     def tearDown(self):
         del self.s
         init.reset();
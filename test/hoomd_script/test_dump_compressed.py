@@ -0,0 +1,78 @@
+# -*- coding: iso-8859-1 -*-
+# Maintainer: joaander
+
+from hoomd_script import *
+import hoomd
+import unittest
+import os
+
+# unit tests for dump.compressed
+class dmp_compressed_tests (unittest.TestCase):
+    def setUp(self):
+        print
+        init.create_random(N=100, phi_p=0.05);
+
+        sorter.set_params(grid=8)
+
+    # tests basic creation of the dump
+    def test(self):
+        dump.compressed(filename="dump_compressed", period=100);
+        run(100)
+
+    # tests with a group and overwrite
+    def test_group(self):
+        typeA = group.type('A');
+        dump.compressed(filename="dump_compressed", period=100, group=typeA, overwrite=True);
+        run(100)
+
+    # test variable period
+    def test_variable(self):
+        dump.compressed(filename="dump_compressed", period=lambda n: n*100);
+        run(100);
+
+    # test that positions read back are within the requested precision
+    def test_read_back(self):
+        all = group.all();
+        integrate.mode_standard(dt=0.005);
+        pair = pair_lj(r_cut=2.5);
+        pair.pair_coeff.set('A', 'A', epsilon=1.0, sigma=1.0);
+        integrate.nve(group=all);
+        qtr = dump.compressed(filename="dump_compressed", period=10, precision=1e-3, overwrite=True, key_interval=3);
+        run(50);
+
+        # the frame at step 50 is written at the start of the next run, before the particles move
+        L = globals.system_definition.getParticleData().getGlobalBox().getL();
+        expected = {};
+        for p in system.particles:
+            ix, iy, iz = p.image;
+            expected[p.tag] = (p.position[0] + ix*L.x, p.position[1] + iy*L.y, p.position[2] + iz*L.z);
+        run(1);
+        qtr.disable();
+
+        if comm.get_rank() == 0:
+            reader = hoomd.CompressedTrajectoryReader(globals.exec_conf, "dump_compressed");
+            self.assertEqual(reader.getNumFrames(), 6);
+            self.assertEqual(reader.getNumParticles(), 100);
+            self.assertEqual(reader.getTimeStep(5), 50);
+
+            pos = reader.getPositions(5);
+            for tag in range(100):
+                for c in range(3):
+                    self.assertAlmostEqual(pos[tag][c], expected[tag][c], delta=1e-3);
+
+            # random access back into the file gives the same frames as sequential reads
+            first = reader.getPositions(1);
+            reader.getPositions(4);
+            self.assertEqual(first, reader.getPositions(1));
+
+    # test that an invalid precision is rejected
+    def test_bad_precision(self):
+        self.assertRaises(RuntimeError, dump.compressed, filename="dump_compressed", period=100, precision=0.0);
+
+    def tearDown(self):
+        init.reset();
+        if comm.get_rank() == 0 and os.path.exists("dump_compressed"):
+            os.remove("dump_compressed");
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
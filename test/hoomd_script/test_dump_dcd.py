@@ -4,6 +4,7 @@
 from hoomd_script import *
 import unittest
 import os
+import struct
 
 # unit tests for dump.dcd
 class dmp_dcd_tests (unittest.TestCase):
@@ -51,6 +52,24 @@ class dmp_dcd_tests (unittest.TestCase):
         if (comm.get_rank() == 0):
             os.remove('dump_dcd')
 
+    # tests asynchronous output, appending to the file with a second dump
+    def test_async_append(self):
+        analyze.set_async(num_threads=2, max_queue=2);
+        dcd = dump.dcd(filename="dump_dcd", period=10, overwrite=True);
+        run(100);
+        dcd.disable();
+        dump.dcd(filename="dump_dcd", period=10);
+        run(100);
+        analyze.set_async(num_threads=0);
+        if (comm.get_rank() == 0):
+            f = open('dump_dcd', 'rb');
+            header = f.read(12);
+            f.close();
+            # the number of frames follows the 84 byte block marker and CORD
+            (marker, cord, nframes) = struct.unpack('<i4si', header);
+            self.assertEqual(nframes, 20);
+            os.remove('dump_dcd')
+
     # test disable/enable
     def test_enable_disable(self):
         dcd = dump.dcd(filename="dump_dcd", period=100);
@@ -0,0 +1,44 @@
+# -*- coding: iso-8859-1 -*-
+# Maintainer: joaander
+
+from hoomd_script import *
+import unittest
+import os
+
+# unit tests for dump.indexed and init.read_indexed
+class dmp_indexed_tests (unittest.TestCase):
+    def setUp(self):
+        print
+        init.create_random(N=100, phi_p=0.05);
+
+        sorter.set_params(grid=8)
+
+    # tests basic creation of the dump and reading it back
+    def test(self):
+        dump.indexed(filename="dump_indexed.hidx", period=100, overwrite=True);
+        run(201);
+        init.reset();
+        sys = init.read_indexed(filename="dump_indexed.hidx", frame=1);
+        self.assertEqual(sys.sysdef.getParticleData().getNGlobal(), 100);
+        del sys;
+
+    # tests field selection and explicit writes
+    def test_fields(self):
+        idx = dump.indexed(filename="dump_indexed.hidx", fields=['position', 'type', 'velocity'], overwrite=True);
+        idx.write();
+        self.assertRaises(RuntimeError, idx.cpp_analyzer.setOutputField, 'not_a_field', True);
+        init.reset();
+        init.read_indexed(filename="dump_indexed.hidx", fields=['velocity'], time_step=10);
+
+    # tests variable periods
+    def test_variable(self):
+        dump.indexed(filename="dump_indexed.hidx", period=lambda n: n*100, overwrite=True);
+        run(101);
+
+    def tearDown(self):
+        init.reset();
+        if (comm.get_rank()==0):
+            os.remove("dump_indexed.hidx");
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
@@ -34,6 +34,23 @@ class dmp_xml_tests (unittest.TestCase):
         xml.set_params(image=True);
         xml.set_params(all=True);
 
+    # test asynchronous output
+    def test_async(self):
+        analyze.set_async(num_threads=2, max_queue=2);
+        xml = dump.xml(filename="dump_xml_async", period=10);
+        xml.set_params(all=True);
+        run(30);
+        analyze.set_async(num_threads=0);
+        if comm.get_rank() == 0:
+            for step in range(0, 30, 10):
+                fname = "dump_xml_async.%010d.xml" % step;
+                f = open(fname);
+                data = f.read();
+                f.close();
+                os.remove(fname);
+                self.assertTrue(data.endswith("</hoomd_xml>\n"));
+                self.assertTrue('time_step="%d"' % step in data);
+
     def tearDown(self):
         init.reset();
 
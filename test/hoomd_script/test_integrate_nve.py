@@ -38,6 +38,17 @@ class integrate_nve_tests (unittest.TestCase):
         nve.set_params(limit=0.1);
         nve.set_params(zero_force=False);
 
+    # test multiple time step integration with a slow pair force
+    def test_respa(self):
+        all = group.all();
+        lj = pair.lj(r_cut=2.5);
+        lj.pair_coeff.set('A', 'A', epsilon=1.0, sigma=1.0);
+        lj.set_respa(period=2);
+        integrate.mode_standard(dt=0.005);
+        integrate.nve(all);
+        run(100);
+        self.assertRaises(RuntimeError, lj.set_respa, period=0);
+
     # test w/ empty group
     def test_empty(self):
         empty = group.cuboid(name="empty", xmin=-100, xmax=-100, ymin=-100, ymax=-100, zmin=-100, zmax=-100)
@@ -63,9 +63,76 @@ class init_create_random_tests (unittest.TestCase):
 
         self.assertRaises(RuntimeError, option.set_notice_level, 'foo');
 
+    def test_trace(self):
+        option.set_trace('trace.json', period=10);
+        self.assert_(globals.options.trace_filename == 'trace.json');
+        self.assert_(globals.options.trace_format == 'json');
+        self.assert_(globals.options.trace_period == 10);
+
+        option.set_trace(None);
+        self.assert_(globals.options.trace_filename is None);
+
+        self.assertRaises(RuntimeError, option.set_trace, 'trace.json', format='foo');
+        self.assertRaises(RuntimeError, option.set_trace, 'trace.json', period=0);
+
+    def test_profile_counters(self):
+        option.set_profile_counters(vector_fp_event=0x3cc7);
+        self.assert_(globals.options.profile_counters);
+        self.assert_(globals.options.profile_vector_fp_event == 0x3cc7);
+
+        option.set_profile_counters(False);
+        self.assert_(not globals.options.profile_counters);
+        self.assert_(globals.options.profile_vector_fp_event is None);
+
+        self.assertRaises(RuntimeError, option.set_profile_counters, vector_fp_event=-1);
+
+    def test_msg_aggregate(self):
+        option.set_msg_aggregate();
+        self.assert_(globals.options.msg_aggregate);
+        self.assert_(globals.msg.getAggregate());
+
+        option.set_msg_aggregate(False);
+        self.assert_(not globals.options.msg_aggregate);
+        self.assert_(not globals.msg.getAggregate());
+
     def tearDown(self):
         pass;
 
+# tests that a trace is written during a run
+class option_trace_run_tests (unittest.TestCase):
+    def setUp(self):
+        print
+        init.create_random(N=100, phi_p=0.05);
+        pair.lj(r_cut=3.0).pair_coeff.set('A', 'A', epsilon=1.0, sigma=1.0);
+        integrate.mode_standard(dt=0.005);
+        integrate.nve(group=group.all());
+
+    def test_json(self):
+        option.set_trace('test_trace.json', period=5);
+        run(20);
+        run(20);
+        if comm.get_num_ranks() == 1:
+            self.assert_(os.path.exists('test_trace.json'));
+
+    def test_binary(self):
+        option.set_trace('test_trace.bin', format='binary');
+        run(10, profile=True);
+        if comm.get_num_ranks() == 1:
+            self.assert_(os.path.exists('test_trace.bin'));
+
+    def test_counters(self):
+        option.set_profile_counters();
+        run(10, profile=True);
+        option.set_profile_counters(False);
+
+    def tearDown(self):
+        option.set_trace(None);
+        init.reset();
+        if comm.get_num_ranks() == 1:
+            for f in ['test_trace.json', 'test_trace.bin']:
+                if os.path.exists(f):
+                    os.remove(f);
+
 
 if __name__ == '__main__':
     unittest.main(argv = ['test.py', '-v'])
@@ -0,0 +1,55 @@
+# -*- coding: iso-8859-1 -*-
+# Maintainer: joaander
+
+from hoomd_script import *
+import unittest
+import os
+
+# pair.ewald
+class pair_ewald_tests (unittest.TestCase):
+    def setUp(self):
+        print
+        s = init.create_random(N=100, phi_p=0.05);
+
+        sorter.set_params(grid=8)
+        for i in range(0,50):
+            s.particles[i].charge = -1;
+
+        for i in range(50,100):
+            s.particles[i].charge = 1;
+
+    # basic test of creation
+    def test(self):
+        ewald = pair.ewald(r_cut=3.0);
+        ewald.pair_coeff.set('A', 'A', kappa=1.0);
+        ewald.update_coeffs();
+
+    # test missing coefficients
+    def test_missing_AA(self):
+        ewald = pair.ewald(r_cut=3.0);
+        self.assertRaises(RuntimeError, ewald.update_coeffs);
+
+    # test set params
+    def test_set_params(self):
+        ewald = pair.ewald(r_cut=3.0);
+        ewald.set_params(mode="shift");
+        ewald.set_params(fast_erfc=True);
+        ewald.set_params(mode="no_shift", fast_erfc=False);
+        self.assertRaises(RuntimeError, ewald.set_params, mode="blah");
+
+    # test the fast erfc during a run
+    def test_fast_erfc(self):
+        ewald = pair.ewald(r_cut=3.0);
+        ewald.pair_coeff.set('A', 'A', kappa=1.0);
+        ewald.set_params(fast_erfc=True);
+        all = group.all();
+        integrate.mode_standard(dt=0.005);
+        integrate.nve(all);
+        run(10);
+
+    def tearDown(self):
+        init.reset();
+
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
@@ -0,0 +1,64 @@
+# -*- coding: iso-8859-1 -*-
+# Maintainer: joaander
+
+from hoomd_script import *
+import unittest
+import os
+
+# pair.fused
+class pair_fused_tests (unittest.TestCase):
+    def setUp(self):
+        print
+        init.create_random(N=100, phi_p=0.05);
+
+        sorter.set_params(grid=8)
+
+        self.lj = pair.lj(r_cut=3.0);
+        self.lj.pair_coeff.set('A', 'A', epsilon=1.0, sigma=1.0);
+        self.yuk = pair.yukawa(r_cut=3.0);
+        self.yuk.pair_coeff.set('A', 'A', epsilon=1.0, kappa=1.0);
+
+    # basic test of creation
+    def test(self):
+        if globals.exec_conf.isCUDAEnabled():
+            self.assertRaises(RuntimeError, pair.fused, [self.lj, self.yuk]);
+            return;
+
+        pair.fused([self.lj, self.yuk]);
+        all = group.all();
+        integrate.mode_standard(dt=0.005);
+        integrate.nve(all);
+        run(10);
+
+    # test that the fused energies are logged under the original names
+    def test_log(self):
+        if globals.exec_conf.isCUDAEnabled():
+            return;
+
+        pair.fused([self.lj, self.yuk]);
+        log = analyze.log(quantities=['pair_lj_energy', 'pair_yukawa_energy'], period=1, filename="test.log");
+        all = group.all();
+        integrate.mode_standard(dt=0.005);
+        integrate.nve(all);
+        run(1);
+        log.query('pair_lj_energy');
+        log.query('pair_yukawa_energy');
+        log.disable();
+        if comm.get_rank() == 0:
+            os.remove("test.log");
+
+    # test that a single pair force cannot be fused
+    def test_single(self):
+        self.assertRaises(RuntimeError, pair.fused, [self.lj]);
+
+    # test that disabled pair forces cannot be fused
+    def test_disabled(self):
+        self.yuk.disable();
+        self.assertRaises(RuntimeError, pair.fused, [self.lj, self.yuk]);
+
+    def tearDown(self):
+        init.reset();
+
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
@@ -0,0 +1,63 @@
+# -*- coding: iso-8859-1 -*-
+# Maintainer: joaander
+
+from hoomd_script import *
+import unittest
+import os
+
+# tests for schedule types
+class schedule_tests (unittest.TestCase):
+    def setUp(self):
+        print
+        init.create_random(N=100, phi_p=0.05);
+
+        sorter.set_params(grid=8)
+
+    # tests the log schedule
+    def test_log(self):
+        s = schedule.log(points_per_decade=1);
+        self.assertEqual(0, s.next_step(0));
+        self.assertEqual(10, s.next_step(2));
+        self.assertEqual(100, s.next_step(11));
+
+    # tests the linear_log schedule
+    def test_linear_log(self):
+        s = schedule.linear_log(cycle=100, points_per_decade=1);
+        self.assertEqual(10, s.next_step(2));
+        self.assertEqual(100, s.next_step(11));
+        self.assertEqual(110, s.next_step(102));
+
+    # tests the steps and combine schedules
+    def test_steps_combine(self):
+        s = schedule.steps([50, 5]);
+        self.assertEqual(5, s.next_step(0));
+        self.assertEqual(None, s.next_step(51));
+
+        c = schedule.combine(s, schedule.log(points_per_decade=1));
+        self.assertEqual(5, c.next_step(2));
+        self.assertEqual(100, c.next_step(51));
+
+    # tests invalid arguments
+    def test_errors(self):
+        self.assertRaises(RuntimeError, schedule.log, points_per_decade=0);
+        self.assertRaises(RuntimeError, schedule.linear_log, cycle=0);
+        self.assertRaises(RuntimeError, schedule.combine);
+
+    # tests an analyzer and an updater on a schedule
+    def test_period(self):
+        all = group.all();
+        integrate.mode_standard(dt=0.005);
+        integrate.nve(group=all);
+        ana = analyze.log(quantities=['potential_energy'], period=schedule.log(), filename="test_schedule.log");
+        upd = update.zero_momentum(period=schedule.steps([10, 20]));
+        run(100);
+        ana.set_period(schedule.linear_log(cycle=50));
+        run(100);
+        if comm.get_rank() == 0:
+            os.remove("test_schedule.log");
+
+    def tearDown(self):
+        init.reset();
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
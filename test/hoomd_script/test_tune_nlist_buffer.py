@@ -0,0 +1,69 @@
+# -*- coding: iso-8859-1 -*-
+# Maintainer: joaander
+
+from hoomd_script import *
+import unittest
+import os
+
+# tune.nlist_buffer testing
+class tune_nlist_buffer_tests (unittest.TestCase):
+    def setUp(self):
+        print
+        init.create_random(N=100, phi_p=0.05);
+        pair.lj(r_cut=3.0).pair_coeff.set('A', 'A', epsilon=1.0, sigma=1.0);
+        integrate.mode_standard(dt=0.005);
+        integrate.nve(group=group.all());
+
+        sorter.set_params(grid=8)
+
+    # tests basic creation of the tuner
+    def test(self):
+        tune.nlist_buffer();
+        run(100);
+
+    # tests that r_buff stays within the bounds while tuning
+    def test_bounds(self):
+        tune.nlist_buffer(period=10, r_min=0.2, r_max=0.5, dr=0.1, max_check_period=5);
+        run(200);
+        r_buff = globals.neighbor_list.cpp_nlist.getRBuff();
+        self.assert_(r_buff >= 0.2 - 1e-5);
+        self.assert_(r_buff <= 0.5 + 1e-5);
+
+        # the tuned value survives the next run
+        run(1);
+        self.assertAlmostEqual(globals.neighbor_list.r_buff, globals.neighbor_list.cpp_nlist.getRBuff(), 5);
+
+    # tests the log quantities
+    def test_log(self):
+        tune.nlist_buffer(period=10);
+        log = analyze.log(quantities=['nlist_r_buff', 'nlist_check_period'], period=10, filename="test_tune_nlist_buffer.log", overwrite=True);
+        run(50);
+        self.assert_(log.query('nlist_r_buff') > 0.0);
+        self.assert_(log.query('nlist_check_period') >= 0.0);
+
+    # tests the error checks
+    def test_errors(self):
+        self.assertRaises(RuntimeError, tune.nlist_buffer, r_min=0.0);
+        self.assertRaises(RuntimeError, tune.nlist_buffer, r_min=0.5, r_max=0.2);
+        self.assertRaises(RuntimeError, tune.nlist_buffer, dr=0.0);
+        self.assertRaises(RuntimeError, tune.nlist_buffer, max_check_period=0);
+
+    def tearDown(self):
+        init.reset();
+        if (comm.get_rank()==0) and os.path.exists("test_tune_nlist_buffer.log"):
+            os.remove("test_tune_nlist_buffer.log");
+
+# tune.nlist_buffer requires a neighbor list
+class tune_nlist_buffer_nonlist_tests (unittest.TestCase):
+    def setUp(self):
+        print
+        init.create_random(N=100, phi_p=0.05);
+
+    def test(self):
+        self.assertRaises(RuntimeError, tune.nlist_buffer);
+
+    def tearDown(self):
+        init.reset();
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
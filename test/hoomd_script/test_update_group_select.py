@@ -0,0 +1,48 @@
+# -*- coding: iso-8859-1 -*-
+# Maintainer: joaander
+
+from hoomd_script import *
+import unittest
+import os
+
+# tests for update.group_select
+class update_group_select_tests (unittest.TestCase):
+    def setUp(self):
+        print
+        self.s = init.create_random(N=100, phi_p=0.05);
+
+        sorter.set_params(grid=8)
+
+    # tests basic creation of the updater
+    def test(self):
+        slab = group.cuboid(name="slab", xmin=0);
+        update.group_select(slab);
+        run(100);
+
+    # the group follows the particles
+    def test_reselect(self):
+        slab = group.cuboid(name="slab", xmin=0);
+        update.group_select(slab, period=10);
+        for p in self.s.particles:
+            p.position = (-1.0, p.position[1], p.position[2]);
+        self.s.particles[5].position = (1.0, 0.0, 0.0);
+        run(1);
+        self.assertEqual(len(slab), 1);
+        self.assertEqual(slab[0].tag, 5);
+
+    # test variable periods
+    def test_variable(self):
+        slab = group.cuboid(name="slab", xmin=0);
+        update.group_select(slab, period = lambda n: n*100);
+        run(100);
+
+    # groups without a selection cannot be updated
+    def test_no_selector(self):
+        tags = group.tag_list(name="a", tags=[0, 1]);
+        self.assertRaises(RuntimeError, update.group_select, tags);
+
+    def tearDown(self):
+        init.reset();
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
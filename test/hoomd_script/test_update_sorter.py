@@ -16,6 +16,17 @@ class update_sorter_tests (unittest.TestCase):
 
         sorter.set_params(grid=20);
 
+    # test adaptive sorting
+    def test_adaptive(self):
+        lj = pair.lj(r_cut=3.0);
+        lj.pair_coeff.set('A', 'A', epsilon=1.0, sigma=1.0);
+        sorter.set_params(adaptive=True);
+        integrate.mode_standard(dt=0.005);
+        integrate.nve(group=group.all());
+        run(100);
+        sorter.set_params(adaptive=False);
+        run(100);
+
     def tearDown(self):
         init.reset();
 
@@ -0,0 +1,117 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+#ifdef WIN32
+#pragma warning( push )
+#pragma warning( disable : 4103 4244 )
+#endif
+
+#include <iostream>
+
+#include <boost/shared_ptr.hpp>
+
+#include "Autotuner.h"
+#include "ClockSource.h"
+
+using namespace std;
+using namespace boost;
+
+/*! \file test_autotuner.cc
+    \brief Implements unit tests for the host timer in Autotuner
+    \ingroup unit_tests
+*/
+
+//! Name the unit test module
+#define BOOST_TEST_MODULE AutotunerTests
+#include "boost_utf_configure.h"
+
+//! Spin on the host clock for the given number of milliseconds
+void spin_ms(unsigned int ms)
+    {
+    ClockSource clk;
+    int64_t end = clk.getTime() + int64_t(ms) * 1000000;
+    while (clk.getTime() < end) { }
+    }
+
+//! Checks that a CPU autotuner picks the parameter with the shortest wall clock time
+BOOST_AUTO_TEST_CASE( Autotuner_host_timer )
+    {
+    boost::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    std::vector<unsigned int> params;
+    params.push_back(3);
+    params.push_back(1);
+    params.push_back(2);
+
+    Autotuner tuner(params, 3, 100, "test", exec_conf);
+
+    // the initial scan takes nsamples calls per parameter
+    for (unsigned int i = 0; i < 9; i++)
+        {
+        BOOST_CHECK(!tuner.isComplete());
+        tuner.begin();
+        spin_ms(2*tuner.getParam());
+        tuner.end();
+        }
+
+    BOOST_REQUIRE(tuner.isComplete());
+    BOOST_CHECK_EQUAL(tuner.getParam(), (unsigned int)1);
+
+    // a disabled tuner keeps returning the optimal parameter
+    tuner.setEnabled(false);
+    tuner.begin();
+    tuner.end();
+    BOOST_CHECK_EQUAL(tuner.getParam(), (unsigned int)1);
+    }
+
+#ifdef WIN32
+#pragma warning( pop )
+#endif
@@ -601,6 +601,52 @@ void bd_updater_lj_tests(twostepbdnvt_creator bdnvt_creator, boost::shared_ptr<E
     }
 
 
+//! Check that the random forces do not depend on the number of threads
+void bd_updater_threads_tests(twostepbdnvt_creator bdnvt_creator, boost::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    const unsigned int N = 1000;
+    boost::shared_ptr<SystemDefinition> sysdef[2];
+    boost::shared_ptr<IntegratorTwoStep> bdnvt_up[2];
+    boost::shared_ptr<TwoStepBDNVT> two_step_bdnvt[2];
+
+    for (unsigned int k = 0; k < 2; k++)
+        {
+        sysdef[k] = boost::shared_ptr<SystemDefinition>(new SystemDefinition(N, BoxDim(1000000.0), 4, 0, 0, 0, 0, exec_conf));
+        boost::shared_ptr<ParticleData> pdata = sysdef[k]->getParticleData();
+        boost::shared_ptr<ParticleSelector> selector_all(new ParticleSelectorTag(sysdef[k], 0, pdata->getN()-1));
+        boost::shared_ptr<ParticleGroup> group_all(new ParticleGroup(sysdef[k], selector_all));
+
+        two_step_bdnvt[k] = bdnvt_creator(sysdef[k], group_all, Scalar(2.0), 123, 0);
+        two_step_bdnvt[k]->setTally(true);
+        bdnvt_up[k] = boost::shared_ptr<IntegratorTwoStep>(new IntegratorTwoStep(sysdef[k], Scalar(0.01)));
+        bdnvt_up[k]->addIntegrationMethod(two_step_bdnvt[k]);
+        bdnvt_up[k]->prepRun(0);
+        }
+
+    two_step_bdnvt[1]->setNumThreads(4);
+
+    for (unsigned int i = 0; i < 100; i++)
+        {
+        bdnvt_up[0]->update(i);
+        bdnvt_up[1]->update(i);
+        }
+
+    ArrayHandle<Scalar4> h_vel0(sysdef[0]->getParticleData()->getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_vel1(sysdef[1]->getParticleData()->getVelocities(), access_location::host, access_mode::read);
+    for (unsigned int j = 0; j < N; j++)
+        {
+        BOOST_CHECK_EQUAL(h_vel0.data[j].x, h_vel1.data[j].x);
+        BOOST_CHECK_EQUAL(h_vel0.data[j].y, h_vel1.data[j].y);
+        BOOST_CHECK_EQUAL(h_vel0.data[j].z, h_vel1.data[j].z);
+        }
+
+    // the reservoir energy is only summed in a different order
+    bool flag;
+    MY_BOOST_CHECK_CLOSE(two_step_bdnvt[0]->getLogValue("bdnvt_reservoir_energy", 100, flag),
+                         two_step_bdnvt[1]->getLogValue("bdnvt_reservoir_energy", 100, flag),
+                         loose_tol);
+    }
+
 //! BD_NVTUpdater factory for the unit tests
 boost::shared_ptr<TwoStepBDNVT> base_class_bdnvt_creator(boost::shared_ptr<SystemDefinition> sysdef,
                                                   boost::shared_ptr<ParticleGroup> group,
@@ -646,6 +692,13 @@ BOOST_AUTO_TEST_CASE( BDUpdater_twoparticles_tests )
     bd_twoparticles_updater_tests(bdnvt_creator, boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
 
+//! thread count test for the base class
+BOOST_AUTO_TEST_CASE( BDUpdater_threads_tests )
+    {
+    twostepbdnvt_creator bdnvt_creator = bind(base_class_bdnvt_creator, _1, _2, _3, _4, _5);
+    bd_updater_threads_tests(bdnvt_creator, boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
 //! extended LJ-liquid test for the base class
 BOOST_AUTO_TEST_CASE( BDUpdater_LJ_tests )
     {
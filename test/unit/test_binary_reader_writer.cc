@@ -56,6 +56,9 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <math.h>
 #include "HOOMDBinaryDumpWriter.h"
 #include "HOOMDBinaryInitializer.h"
+#include "HOOMDIndexedDumpWriter.h"
+#include "HOOMDIndexedInitializer.h"
+#include "SnapshotSystemData.h"
 #include "BondedGroupData.h"
 
 #include <iostream>
@@ -277,6 +280,128 @@ BOOST_AUTO_TEST_CASE( HOOMDBinaryReaderWriterBasicTests )
     remove_all("test.0000000010.bin");
     }
 
+//! Checks random access, partial reads, appending and recovery of indexed files
+BOOST_AUTO_TEST_CASE( HOOMDIndexedReaderWriterTests )
+    {
+    BoxDim box(Scalar(10.0), Scalar(11.0), Scalar(12.0));
+    box.setTiltFactors(Scalar(0.5), Scalar(0.0), Scalar(0.25));
+
+    boost::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    boost::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(3, box, 2, 1, 0, 0, 0, exec_conf));
+    boost::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    sysdef->getBondData()->addBondedGroup(Bond(0, 0, 2));
+
+    remove_all("test.hidx");
+    boost::shared_ptr<HOOMDIndexedDumpWriter> writer(new HOOMDIndexedDumpWriter(sysdef, "test.hidx", true));
+
+    // write three frames, each with a different position and velocity of particle 1
+    for (unsigned int frame = 0; frame < 3; frame++)
+        {
+            {
+            ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+            ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::readwrite);
+            h_pos.data[1].x = Scalar(frame) + Scalar(0.5);
+            h_pos.data[1].w = __int_as_scalar(1);
+            h_vel.data[1].y = Scalar(-2.0) * Scalar(frame);
+            }
+        writer->analyze(100*frame);
+        }
+    BOOST_CHECK_EQUAL(writer->getNumFrames(), (unsigned int)3);
+
+    // read the middle frame without velocities
+    HOOMDIndexedInitializer init(exec_conf, "test.hidx");
+    BOOST_REQUIRE_EQUAL(init.getNumFrames(), (unsigned int)3);
+    BOOST_CHECK_EQUAL(init.getFrameTimeStep(2), (unsigned int)200);
+    BOOST_CHECK_EQUAL(init.getTimeStep(), (unsigned int)200);
+    init.setFrame(1);
+    init.setReadField("velocity", false);
+    BOOST_CHECK_EQUAL(init.getTimeStep(), (unsigned int)100);
+
+    boost::shared_ptr<SnapshotSystemData> snap = init.getSnapshot();
+    BOOST_REQUIRE_EQUAL(snap->particle_data.size, (unsigned int)3);
+    MY_BOOST_CHECK_CLOSE(snap->particle_data.pos[1].x, Scalar(1.5), tol);
+    MY_BOOST_CHECK_SMALL(snap->particle_data.vel[1].y, tol_small);
+    BOOST_CHECK_EQUAL(snap->particle_data.type[1], (unsigned int)1);
+    BOOST_CHECK_EQUAL(snap->particle_data.type_mapping.size(), (unsigned int)2);
+    MY_BOOST_CHECK_CLOSE(snap->global_box.getL().y, Scalar(11.0), tol);
+    MY_BOOST_CHECK_CLOSE(snap->global_box.getTiltFactorXY(), Scalar(0.5), tol);
+    MY_BOOST_CHECK_CLOSE(snap->global_box.getTiltFactorYZ(), Scalar(0.25), tol);
+    BOOST_REQUIRE_EQUAL(snap->bond_data.groups.size(), (unsigned int)1);
+    BOOST_CHECK_EQUAL(snap->bond_data.groups[0].tag[1], (unsigned int)2);
+
+    // negative frames count back from the end
+    init.setFrame(-1);
+    init.setReadField("velocity", true);
+    snap = init.getSnapshot();
+    MY_BOOST_CHECK_CLOSE(snap->particle_data.pos[1].x, Scalar(2.5), tol);
+    MY_BOOST_CHECK_CLOSE(snap->particle_data.vel[1].y, Scalar(-4.0), tol);
+
+    // a new writer appends to the existing file
+    writer = boost::shared_ptr<HOOMDIndexedDumpWriter>(new HOOMDIndexedDumpWriter(sysdef, "test.hidx", false));
+    BOOST_CHECK_EQUAL(writer->getNumFrames(), (unsigned int)3);
+    writer->analyze(300);
+    BOOST_CHECK_EQUAL(writer->getNumFrames(), (unsigned int)4);
+
+    // chop off the index: the frames are recovered by walking the file
+    resize_file("test.hidx", file_size("test.hidx") - 8);
+    HOOMDIndexedInitializer init2(exec_conf, "test.hidx");
+    BOOST_CHECK_EQUAL(init2.getNumFrames(), (unsigned int)4);
+    BOOST_CHECK_EQUAL(init2.getTimeStep(), (unsigned int)300);
+
+    // a torn last frame is dropped during recovery: cut off the rest of the index and the end of the last frame
+    boost::uint64_t index_rest = 4 + sizeof(boost::uint64_t) + 4*sizeof(IndexedFrameEntry) + sizeof(IndexedFooter) - 8;
+    resize_file("test.hidx", file_size("test.hidx") - index_rest - 16);
+    HOOMDIndexedInitializer init3(exec_conf, "test.hidx");
+    BOOST_CHECK_EQUAL(init3.getNumFrames(), (unsigned int)3);
+    BOOST_CHECK_EQUAL(init3.getTimeStep(), (unsigned int)200);
+
+    // a write cut off between the trailer and the frame header: the old index is already gone and the frame has
+    // no header, so only the three complete frames are found
+    writer = boost::shared_ptr<HOOMDIndexedDumpWriter>(new HOOMDIndexedDumpWriter(sysdef, "test.hidx", false));
+    BOOST_REQUIRE_EQUAL(writer->getNumFrames(), (unsigned int)3);
+    boost::uint64_t frame_start = file_size("test.hidx");
+    writer->analyze(300);
+    writer = boost::shared_ptr<HOOMDIndexedDumpWriter>();
+
+    std::vector<char> contents(file_size("test.hidx"));
+        {
+        ifstream f("test.hidx", ios::in | ios::binary);
+        f.read(&contents[0], contents.size());
+        }
+    IndexedFrameHeader last_header;
+    memcpy(&last_header, &contents[frame_start], sizeof(IndexedFrameHeader));
+    std::vector<char> cut(contents.begin(), contents.begin() + frame_start + last_header.frame_size);
+    memset(&cut[frame_start], 0, sizeof(IndexedFrameHeader));
+        {
+        ofstream f("test.hidx", ios::out | ios::binary | ios::trunc);
+        f.write(&cut[0], cut.size());
+        }
+    HOOMDIndexedInitializer init5(exec_conf, "test.hidx");
+    BOOST_CHECK_EQUAL(init5.getNumFrames(), (unsigned int)3);
+    BOOST_CHECK_EQUAL(init5.getTimeStep(), (unsigned int)200);
+
+    // an index whose last frame does not match its checksum is not trusted
+    contents[frame_start + last_header.frame_size - sizeof(IndexedFrameTrailer) - 1] ^= 1;
+        {
+        ofstream f("test.hidx", ios::out | ios::binary | ios::trunc);
+        f.write(&contents[0], contents.size());
+        }
+    HOOMDIndexedInitializer init6(exec_conf, "test.hidx");
+    BOOST_CHECK_EQUAL(init6.getNumFrames(), (unsigned int)3);
+    BOOST_CHECK_EQUAL(init6.getTimeStep(), (unsigned int)200);
+
+    // a frame without positions is rejected
+    remove_all("test.hidx");
+    writer = boost::shared_ptr<HOOMDIndexedDumpWriter>(new HOOMDIndexedDumpWriter(sysdef, "test.hidx", true));
+    writer->setOutputField("position", false);
+    writer->analyze(0);
+    writer = boost::shared_ptr<HOOMDIndexedDumpWriter>();
+    HOOMDIndexedInitializer init4(exec_conf, "test.hidx");
+    BOOST_CHECK_THROW(init4.getSnapshot(), runtime_error);
+
+    remove_all("test.hidx");
+    }
+
 #ifdef WIN32
 #pragma warning( pop )
 #endif
@@ -198,6 +198,111 @@ BOOST_AUTO_TEST_CASE( CellList_dimension )
     celllist_dimension_test<CellList>(boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
 
+//! Test that CellList keeps its dimensions while the box grows within the width tolerance
+template <class CL>
+void celllist_width_tolerance_test(boost::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    boost::shared_ptr<SystemDefinition> sysdef_3(new SystemDefinition(3, BoxDim(50.0, 5.0, 5.0), 1, 0, 0, 0, 0, exec_conf));
+    boost::shared_ptr<ParticleData> pdata_3 = sysdef_3->getParticleData();
+
+    boost::shared_ptr<CellList> cl(new CL(sysdef_3));
+    cl->setNominalWidth(Scalar(1.0));
+    cl->setWidthTolerance(Scalar(0.1));
+    cl->compute(0);
+
+    uint3 dim = cl->getDim();
+    BOOST_CHECK_EQUAL_UINT(dim.x, 50);
+
+    // growing by 4% stretches the existing cells
+    pdata_3->setGlobalBoxL(make_scalar3(52.0f, 5.0f, 5.0f));
+    cl->compute(1);
+    dim = cl->getDim();
+    BOOST_CHECK_EQUAL_UINT(dim.x, 50);
+    BOOST_CHECK_EQUAL_UINT(cl->getCellIndexer().getNumElements(), 50*5*5);
+
+    // growing by 12% exceeds the tolerance
+    pdata_3->setGlobalBoxL(make_scalar3(56.0f, 5.0f, 5.0f));
+    cl->compute(2);
+    dim = cl->getDim();
+    BOOST_CHECK_EQUAL_UINT(dim.x, 56);
+    BOOST_CHECK_EQUAL_UINT(cl->getCellSizeArray().getNumElements(), 56*5*5);
+
+    // cells can never become narrower than the nominal width, a shrinking box reallocates with the widest cells
+    // within the tolerance
+    pdata_3->setGlobalBoxL(make_scalar3(55.5f, 5.0f, 5.0f));
+    cl->compute(3);
+    dim = cl->getDim();
+    BOOST_CHECK_EQUAL_UINT(dim.x, 51);
+    BOOST_CHECK_EQUAL_UINT(cl->getCellSizeArray().getNumElements(), 51*5*5);
+
+    // with no tolerance, the dimensions always follow the box
+    cl->setWidthTolerance(Scalar(0.0));
+    pdata_3->setGlobalBoxL(make_scalar3(57.0f, 5.0f, 5.0f));
+    cl->compute(4);
+    dim = cl->getDim();
+    BOOST_CHECK_EQUAL_UINT(dim.x, 57);
+    }
+
+//! boost test case for the cell list width tolerance on the CPU
+BOOST_AUTO_TEST_CASE( CellList_width_tolerance )
+    {
+    celllist_width_tolerance_test<CellList>(boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
+//! Test that CellList absorbs a gradual compression of the box without reallocating
+template <class CL>
+void celllist_compression_test(boost::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    boost::shared_ptr<SystemDefinition> sysdef_3(new SystemDefinition(3, BoxDim(50.0, 5.0, 5.0), 1, 0, 0, 0, 0, exec_conf));
+    boost::shared_ptr<ParticleData> pdata_3 = sysdef_3->getParticleData();
+
+    boost::shared_ptr<CellList> cl(new CL(sysdef_3));
+    cl->setNominalWidth(Scalar(1.0));
+    cl->setWidthTolerance(Scalar(0.1));
+    cl->compute(0);
+    BOOST_CHECK_EQUAL_UINT(cl->getDim().x, 50);
+
+    // the first compression reallocates with cells as wide as the tolerance allows, 48/44 = 1.09
+    pdata_3->setGlobalBoxL(make_scalar3(48.0f, 5.0f, 5.0f));
+    cl->compute(1);
+    BOOST_CHECK_EQUAL_UINT(cl->getDim().x, 44);
+    BOOST_CHECK_EQUAL_UINT(cl->getCellSizeArray().getNumElements(), 44*5*5);
+    unsigned int *cell_size;
+    unsigned int *cell_adj;
+        {
+        ArrayHandle<unsigned int> h_cell_size(cl->getCellSizeArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_cell_adj(cl->getCellAdjArray(), access_location::host, access_mode::read);
+        cell_size = h_cell_size.data;
+        cell_adj = h_cell_adj.data;
+        }
+
+    // further compression down to the nominal width keeps the same memory and adjacency list
+    for (unsigned int i = 0; i < 8; i++)
+        {
+        pdata_3->setGlobalBoxL(make_scalar3(47.5f - Scalar(i)*0.5f, 5.0f, 5.0f));
+        cl->compute(2+i);
+        BOOST_CHECK_EQUAL_UINT(cl->getDim().x, 44);
+        BOOST_CHECK_EQUAL_UINT(cl->getCellSizeArray().getNumElements(), 44*5*5);
+
+        ArrayHandle<unsigned int> h_cell_size(cl->getCellSizeArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_cell_adj(cl->getCellAdjArray(), access_location::host, access_mode::read);
+        BOOST_CHECK(h_cell_size.data == cell_size);
+        BOOST_CHECK(h_cell_adj.data == cell_adj);
+        }
+
+    // cells narrower than the nominal width force a reallocation, 43.5/40 = 1.09
+    pdata_3->setGlobalBoxL(make_scalar3(43.5f, 5.0f, 5.0f));
+    cl->compute(10);
+    BOOST_CHECK_EQUAL_UINT(cl->getDim().x, 40);
+    BOOST_CHECK_EQUAL_UINT(cl->getCellSizeArray().getNumElements(), 40*5*5);
+    }
+
+//! boost test case for the cell list compression on the CPU
+BOOST_AUTO_TEST_CASE( CellList_compression )
+    {
+    celllist_compression_test<CellList>(boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
 //! Test the ability of CellList to initialize the adj array
 template <class CL>
 void celllist_adj_test(boost::shared_ptr<ExecutionConfiguration> exec_conf)
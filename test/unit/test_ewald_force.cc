@@ -84,7 +84,9 @@ typedef boost::function<boost::shared_ptr<PotentialPairEwald> (boost::shared_ptr
                                                          boost::shared_ptr<NeighborList> nlist)> ewaldforce_creator;
 
 //! Test the ability of the ewald force compute to actually calucate forces
-void ewald_force_particle_test(ewaldforce_creator ewald_creator, boost::shared_ptr<ExecutionConfiguration> exec_conf)
+void ewald_force_particle_test(ewaldforce_creator ewald_creator,
+                               boost::shared_ptr<ExecutionConfiguration> exec_conf,
+                               Scalar fast_erfc=Scalar(0.0))
     {
     // this 3-particle test subtly checks several conditions
     // the particles are arranged on the x axis,  1   2   3
@@ -111,7 +113,7 @@ void ewald_force_particle_test(ewaldforce_creator ewald_creator, boost::shared_p
 
     // first test: choose a basic set of values
     Scalar kappa = Scalar(0.5);
-    fc_3->setParams(0,0,kappa);
+    fc_3->setParams(0,0,make_scalar2(kappa, fast_erfc));
 
     // compute the forces
     fc_3->compute(0);
@@ -202,8 +204,8 @@ void ewald_force_comparison_test(ewaldforce_creator ewald_creator1,
     Scalar kappa = Scalar(0.5);
 
     // specify the force parameters
-    fc1->setParams(0,0,kappa);
-    fc2->setParams(0,0,kappa);
+    fc1->setParams(0,0,make_scalar2(kappa, Scalar(0.0)));
+    fc2->setParams(0,0,make_scalar2(kappa, Scalar(0.0)));
 
     // compute the forces
     fc1->compute(0);
@@ -285,6 +287,24 @@ BOOST_AUTO_TEST_CASE( EwaldForce_particle )
     ewald_force_particle_test(ewald_creator_base, boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
 
+//! boost test case for particle test on CPU with the fast erfc
+BOOST_AUTO_TEST_CASE( EwaldForce_particle_fast_erfc )
+    {
+    ewaldforce_creator ewald_creator_base = bind(base_class_ewald_creator, _1, _2);
+    ewald_force_particle_test(ewald_creator_base,
+                              boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)),
+                              Scalar(1.0));
+    }
+
+//! boost test case for the error bound of the fast erfc
+BOOST_AUTO_TEST_CASE( EwaldForce_fast_erfc_error )
+    {
+    Scalar error = EvaluatorPairEwald::getFastErfcError(Scalar(4.0));
+    BOOST_CHECK(error > Scalar(0.0));
+    // 1.5e-7 from the approximation plus rounding in single precision
+    BOOST_CHECK(error < Scalar(5e-7));
+    }
+
 # ifdef ENABLE_CUDA
 //! boost test case for particle test on GPU
 BOOST_AUTO_TEST_CASE( EwaldForceGPU_particle )
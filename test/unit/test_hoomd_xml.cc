@@ -56,6 +56,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <math.h>
 #include "HOOMDDumpWriter.h"
 #include "HOOMDInitializer.h"
+#include "SnapshotSystemData.h"
 #include "BondedGroupData.h"
 
 #include <iostream>
@@ -1393,6 +1394,101 @@ im_b 5 4 3 2\n\
     remove_all("test_input.xml");
     }
 
+//! Test that HOOMDInitializer copes with the less common XML constructs
+BOOST_AUTO_TEST_CASE( HOOMDInitializer_format_tests )
+    {
+    // create a test input file with comments, empty nodes, upper case names, unknown nodes and long numbers
+    ofstream f("test_input.xml");
+    f << "<?xml version =\"1.0\" encoding =\"UTF-8\" ?>\n\
+<!-- a comment with a <position> tag in it -->\n\
+<hoomd_xml version=\"1.5\">\n\
+<configuration time_step='42' dimensions=\"3\">\n\
+<box lx=\"10\" ly=\"11\" lz=\"12\" />\n\
+<unknown><nested>1 2 3</nested></unknown>\n\
+<Position num=\"3\">\n\
+1.0000000000000000001 -2.5e-1 3\n\
+4 5 6 7 8 9\n\
+-1.25E+1 0.125 1e0\n\
+</Position>\n\
+<!-- <type> A A A </type> -->\n\
+<velocity/>\n\
+<TYPE>A B\tA\nB</TYPE>\n\
+<bond>\n\
+b 0 1\n\
+b 1 2\n\
+</bond>\n\
+</configuration>\n\
+</hoomd_xml>" << endl;
+    f.close();
+
+    boost::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    HOOMDInitializer init(exec_conf,"test_input.xml");
+    boost::shared_ptr<SnapshotSystemData> snapshot = init.getSnapshot();
+
+    BOOST_CHECK_EQUAL(init.getTimeStep(), (unsigned int)42);
+    BOOST_REQUIRE_EQUAL(snapshot->particle_data.size, (unsigned int)4);
+    MY_BOOST_CHECK_CLOSE(snapshot->global_box.getL().y, 11.0, tol);
+
+    const std::vector<Scalar3>& pos = snapshot->particle_data.pos;
+    MY_BOOST_CHECK_CLOSE(pos[0].x, 1.0, tol);
+    MY_BOOST_CHECK_CLOSE(pos[0].y, -0.25, tol);
+    MY_BOOST_CHECK_CLOSE(pos[0].z, 3.0, tol);
+    MY_BOOST_CHECK_CLOSE(pos[1].z, 6.0, tol);
+    MY_BOOST_CHECK_CLOSE(pos[2].x, 7.0, tol);
+    MY_BOOST_CHECK_CLOSE(pos[3].x, -12.5, tol);
+    MY_BOOST_CHECK_CLOSE(pos[3].y, 0.125, tol);
+    MY_BOOST_CHECK_CLOSE(pos[3].z, 1.0, tol);
+
+    BOOST_REQUIRE_EQUAL(snapshot->particle_data.type_mapping.size(), (unsigned int)2);
+    BOOST_CHECK_EQUAL(snapshot->particle_data.type[0], (unsigned int)0);
+    BOOST_CHECK_EQUAL(snapshot->particle_data.type[1], (unsigned int)1);
+    BOOST_CHECK_EQUAL(snapshot->particle_data.type[2], (unsigned int)0);
+
+    BOOST_REQUIRE_EQUAL(snapshot->bond_data.groups.size(), (unsigned int)2);
+    BOOST_CHECK_EQUAL(snapshot->bond_data.groups[1].tag[0], (unsigned int)1);
+    BOOST_CHECK_EQUAL(snapshot->bond_data.groups[1].tag[1], (unsigned int)2);
+
+    // clean up after ourselves
+    remove_all("test_input.xml");
+    }
+
+#ifdef ENABLE_ZLIB
+//! Checks that gzip compressed xml files written by HOOMDDumpWriter are read back by HOOMDInitializer
+BOOST_AUTO_TEST_CASE( HOOMDDumpWriter_gzip_test )
+    {
+    // enough particles that the compressed output spans many gzip members
+    unsigned int N = 50000;
+    BoxDim box(Scalar(100.0));
+    boost::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(N, box, 1));
+    boost::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    {
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+    for (unsigned int i = 0; i < N; i++)
+        h_pos.data[i].x = Scalar(i % 97) - Scalar(48.25);
+    }
+
+    boost::shared_ptr<HOOMDDumpWriter> writer(new HOOMDDumpWriter(sysdef, "test"));
+    writer->setOutputPosition(true);
+    writer->setOutputType(true);
+
+    remove_all("test_gz.xml.gz");
+    writer->writeFile("test_gz.xml.gz", 5);
+    BOOST_REQUIRE(exists("test_gz.xml.gz"));
+
+    boost::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    HOOMDInitializer init(exec_conf,"test_gz.xml.gz");
+    boost::shared_ptr<SnapshotSystemData> snapshot = init.getSnapshot();
+
+    BOOST_CHECK_EQUAL(init.getTimeStep(), (unsigned int)5);
+    BOOST_REQUIRE_EQUAL(snapshot->particle_data.size, N);
+    for (unsigned int i = 0; i < N; i += 997)
+        MY_BOOST_CHECK_CLOSE(snapshot->particle_data.pos[i].x, Scalar(i % 97) - Scalar(48.25), tol);
+
+    remove_all("test_gz.xml.gz");
+    }
+#endif
+
 #ifdef WIN32
 #pragma warning( pop )
 #endif
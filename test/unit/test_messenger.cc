@@ -52,6 +52,8 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include <fstream>
 #include <boost/filesystem/operations.hpp>
 #include <boost/filesystem/convenience.hpp>
+#include <boost/thread.hpp>
+#include <boost/bind.hpp>
 using namespace boost::filesystem;
 
 #include "Messenger.h"
@@ -219,3 +221,97 @@ BOOST_AUTO_TEST_CASE( Messenger_file )
 
     remove_all("test_messenger_output");
     }
+
+BOOST_AUTO_TEST_CASE( Messenger_aggregate )
+    {
+    Messenger msg;
+    msg.setErrorPrefix("err");
+    msg.setWarningPrefix("warn");
+    msg.setNoticePrefix("note");
+    msg.setNoticeLevel(5);
+
+    ostringstream strm;
+    msg.setErrorStream(strm);
+    msg.setWarningStream(strm);
+    msg.setNoticeStream(strm);
+
+    msg.setAggregate(true);
+    BOOST_CHECK(msg.getAggregate());
+
+    // notices above level 1 are buffered
+    msg.notice(5) << "1" << endl;
+    BOOST_CHECK_EQUAL(strm.str(), string(""));
+
+    // warnings are only buffered with more than one rank
+    msg.warning() << "2" << endl;
+    BOOST_CHECK_EQUAL(strm.str(), string("warn: 2\n"));
+
+    // level 1 notices write out the buffer first
+    msg.notice(1) << "3" << endl;
+    BOOST_CHECK_EQUAL(strm.str(), string("warn: 2\nnote(5): 1\n3\n"));
+
+    strm.str("");
+    msg.notice(2) << "4" << endl;
+    msg.collectiveFlush();
+    BOOST_CHECK_EQUAL(strm.str(), string("note(2): 4\n"));
+
+    // errors write out the buffer first
+    strm.str("");
+    msg.notice(2) << "5" << endl;
+    msg.error() << "6" << endl;
+    BOOST_CHECK_EQUAL(strm.str(), string("note(2): 5\nerr: 6\n"));
+
+    // a local flush writes out the buffer and keeps aggregating
+    strm.str("");
+    msg.notice(2) << "7" << endl;
+    msg.flushLocal();
+    BOOST_CHECK_EQUAL(strm.str(), string("note(2): 7\n"));
+    BOOST_CHECK(msg.getAggregate());
+
+    // disabling aggregation writes out the buffer
+    strm.str("");
+    msg.notice(2) << "8" << endl;
+    msg.setAggregate(false);
+    BOOST_CHECK_EQUAL(strm.str(), string("note(2): 8\n"));
+    BOOST_CHECK_EQUAL(&(msg.notice(2)), &strm);
+    }
+
+//! Writes numbered notices from a worker thread
+void write_notices(const Messenger *msg, unsigned int id, unsigned int n)
+    {
+    for (unsigned int i = 0; i < n; i++)
+        msg->notice(2) << id << " " << i << endl;
+    }
+
+//! Checks that buffered notices from concurrent threads are all written, each thread's in order
+BOOST_AUTO_TEST_CASE( Messenger_aggregate_threads )
+    {
+    Messenger msg;
+    msg.setNoticePrefix("");
+    msg.setNoticeLevel(5);
+
+    ostringstream strm;
+    msg.setNoticeStream(strm);
+    msg.setAggregate(true);
+
+    const unsigned int n_threads = 4;
+    const unsigned int n = 5000;
+    boost::thread_group threads;
+    for (unsigned int id = 0; id < n_threads; id++)
+        threads.create_thread(boost::bind(write_notices, &msg, id, n));
+    threads.join_all();
+    msg.collectiveFlush();
+
+    vector<unsigned int> next(n_threads, 0);
+    istringstream in(strm.str());
+    unsigned int id, i;
+    unsigned int lines = 0;
+    while (in >> id >> i)
+        {
+        BOOST_REQUIRE(id < n_threads);
+        BOOST_CHECK_EQUAL(i, next[id]);
+        next[id] = i+1;
+        lines++;
+        }
+    BOOST_CHECK_EQUAL(lines, n_threads*n);
+    }
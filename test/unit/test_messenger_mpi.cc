@@ -0,0 +1,117 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#ifdef ENABLE_MPI
+
+#include <iostream>
+#include <sstream>
+
+#include "Messenger.h"
+
+using namespace std;
+using namespace boost;
+
+/*! \file test_messenger_mpi.cc
+    \brief Unit test for aggregation of messages across ranks by Messenger
+    \ingroup unit_tests
+*/
+
+//! name the boost unit test module
+#define BOOST_TEST_MODULE MessengerTestsMPI
+#include "boost_utf_configure.h"
+
+//! Checks that collectiveFlush() prints each distinct warning of all ranks once on rank 0
+BOOST_AUTO_TEST_CASE( Messenger_aggregate_mpi )
+    {
+    int rank, size;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &size);
+    BOOST_REQUIRE(size >= 3);
+
+    Messenger msg;
+    msg.setWarningPrefix("warn");
+    msg.setNoticePrefix("note");
+
+    ostringstream strm;
+    msg.setErrorStream(strm);
+    msg.setWarningStream(strm);
+    msg.setNoticeStream(strm);
+    msg.setAggregate(true);
+
+    // warnings are held back until the collective flush
+    msg.warning() << "all ranks" << endl;
+    if (rank != 0)
+        msg.warning() << "not rank 0" << endl;
+    if (rank == 2)
+        msg.warning() << "only rank 2" << endl;
+    BOOST_CHECK_EQUAL(strm.str(), string(""));
+
+    msg.collectiveFlush();
+
+    // rank 0 prints every message once, with the number of ranks and the first rank that issued it
+    if (rank == 0)
+        {
+        ostringstream expected;
+        expected << "warn:  (" << size << " ranks, first 0): all ranks" << endl;
+        expected << "warn:  (" << size-1 << " ranks, first 1): not rank 0" << endl;
+        expected << "warn:  (Rank 2): only rank 2" << endl;
+        BOOST_CHECK_EQUAL(strm.str(), expected.str());
+        }
+    else
+        BOOST_CHECK_EQUAL(strm.str(), string(""));
+
+    // the buffers are empty after the flush
+    strm.str("");
+    msg.collectiveFlush();
+    BOOST_CHECK_EQUAL(strm.str(), string(""));
+
+    msg.setAggregate(false);
+    }
+
+#endif //ENABLE_MPI
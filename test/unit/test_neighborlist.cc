@@ -604,6 +604,36 @@ void neighborlist_large_ex_tests(boost::shared_ptr<ExecutionConfiguration> exec_
         }
     }
 
+//! Verify that the binned neighbor list is unchanged while its cell width is autotuned
+void neighborlist_cell_width_tuning_test(boost::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // construct the particle system
+    RandomInitializer init(1000, Scalar(0.016778), Scalar(0.9), "A");
+    boost::shared_ptr<SnapshotSystemData> snap = init.getSnapshot();
+    boost::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+    boost::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    boost::shared_ptr<NeighborList> nlist1(new NeighborList(sysdef, Scalar(3.0), Scalar(0.4)));
+    nlist1->setStorageMode(NeighborList::full);
+    nlist1->compute(0);
+
+    boost::shared_ptr<NeighborListBinned> nlist2(new NeighborListBinned(sysdef, Scalar(3.0), Scalar(0.4)));
+    nlist2->setStorageMode(NeighborList::full);
+
+    // rebuild enough times for the tuner to sweep through every cell width
+    for (unsigned int timestep = 0; timestep < 30; timestep++)
+        {
+        nlist2->forceUpdate();
+        nlist2->compute(timestep);
+
+        ArrayHandle<unsigned int> h_n_neigh1(nlist1->getNNeighArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_n_neigh2(nlist2->getNNeighArray(), access_location::host, access_mode::read);
+
+        for (unsigned int i = 0; i < pdata->getN(); i++)
+            BOOST_REQUIRE_EQUAL(h_n_neigh1.data[i], h_n_neigh2.data[i]);
+        }
+    }
+
 //! basic test case for base class
 BOOST_AUTO_TEST_CASE( NeighborList_basic )
     {
@@ -661,6 +691,12 @@ BOOST_AUTO_TEST_CASE( NeighborListBinned_comparison )
     neighborlist_comparison_test<NeighborList, NeighborListBinned>(boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
 
+//! cell width tuning test case for binned class
+BOOST_AUTO_TEST_CASE( NeighborListBinned_cell_width_tuning )
+    {
+    neighborlist_cell_width_tuning_test(boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
 #ifdef ENABLE_CUDA
 
 //! basic test case for GPU class
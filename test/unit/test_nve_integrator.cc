@@ -164,6 +164,117 @@ void nve_updater_integrate_tests(twostepnve_creator nve_creator, boost::shared_p
         }
     }
 
+//! Check that slow forces applied as RESPA impulses give the exact trajectory for constant forces
+void nve_updater_respa_tests(twostepnve_creator nve_creator, boost::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // a single particle in a huge box, pushed by one fast and one slow constant force
+    boost::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(1, BoxDim(1000.0), 4, 0, 0, 0, 0, exec_conf));
+    boost::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    boost::shared_ptr<ParticleSelector> selector_all(new ParticleSelectorTag(sysdef, 0, pdata->getN()-1));
+    boost::shared_ptr<ParticleGroup> group_all(new ParticleGroup(sysdef, selector_all));
+
+    {
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    h_pos.data[0].x = 0.0;
+    h_pos.data[0].y = 1.0;
+    h_pos.data[0].z = 2.0;
+    h_vel.data[0].x = 3.0;
+    h_vel.data[0].y = 2.0;
+    h_vel.data[0].z = 1.0;
+    }
+
+    Scalar deltaT = Scalar(0.0001);
+    boost::shared_ptr<TwoStepNVE> two_step_nve = nve_creator(sysdef, group_all);
+    boost::shared_ptr<IntegratorTwoStep> nve_up(new IntegratorTwoStep(sysdef, deltaT));
+    nve_up->addIntegrationMethod(two_step_nve);
+
+    boost::shared_ptr<ConstForceCompute> fc_fast(new ConstForceCompute(sysdef, 1.5, 0.0, 0.0));
+    nve_up->addForceCompute(fc_fast);
+    boost::shared_ptr<ConstForceCompute> fc_slow(new ConstForceCompute(sysdef, 0.0, 2.5, 0.0));
+    nve_up->addForceCompute(fc_slow);
+    nve_up->setRESPAPeriod(fc_slow, 4);
+
+    nve_up->prepRun(0);
+
+    // at the end of every slow interval, the impulses add up to the exact solution
+    for (int i = 0; i < 400; i++)
+        {
+        if (i % 4 == 0)
+            {
+            ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+            ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::read);
+
+            Scalar t = Scalar(i) * deltaT;
+            MY_BOOST_CHECK_CLOSE(h_pos.data[0].x, 0.0 + 3.0 * t + 1.0/2.0 * 1.5 * t*t, loose_tol);
+            MY_BOOST_CHECK_CLOSE(h_vel.data[0].x, 3.0 + 1.5 * t, loose_tol);
+
+            MY_BOOST_CHECK_CLOSE(h_pos.data[0].y, 1.0 + 2.0 * t + 1.0/2.0 * 2.5 * t*t, loose_tol);
+            MY_BOOST_CHECK_CLOSE(h_vel.data[0].y, 2.0 + 2.5 * t, loose_tol);
+
+            MY_BOOST_CHECK_CLOSE(h_pos.data[0].z, 2.0 + 1.0 * t, loose_tol);
+            MY_BOOST_CHECK_CLOSE(h_vel.data[0].z, 1.0, loose_tol);
+            }
+
+        nve_up->update(i);
+        }
+    }
+
+//! Check that RESPA intervals start with the run when it begins on a time step that is not a multiple of the period
+void nve_updater_respa_offset_tests(twostepnve_creator nve_creator, boost::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // a single particle in a huge box, pushed by one fast and one slow constant force
+    boost::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(1, BoxDim(1000.0), 4, 0, 0, 0, 0, exec_conf));
+    boost::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    boost::shared_ptr<ParticleSelector> selector_all(new ParticleSelectorTag(sysdef, 0, pdata->getN()-1));
+    boost::shared_ptr<ParticleGroup> group_all(new ParticleGroup(sysdef, selector_all));
+
+    {
+    ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    h_vel.data[0].x = 3.0;
+    }
+
+    Scalar deltaT = Scalar(0.0001);
+    boost::shared_ptr<TwoStepNVE> two_step_nve = nve_creator(sysdef, group_all);
+    boost::shared_ptr<IntegratorTwoStep> nve_up(new IntegratorTwoStep(sysdef, deltaT));
+    nve_up->addIntegrationMethod(two_step_nve);
+
+    boost::shared_ptr<ConstForceCompute> fc_fast(new ConstForceCompute(sysdef, 1.5, 0.0, 0.0));
+    nve_up->addForceCompute(fc_fast);
+    boost::shared_ptr<ConstForceCompute> fc_slow(new ConstForceCompute(sysdef, 0.0, 2.5, 0.0));
+    nve_up->addForceCompute(fc_slow);
+    nve_up->setRESPAPeriod(fc_slow, 4);
+
+    // the first run starts off-period and ends in the middle of an interval, the second run continues it
+    unsigned int start = 1003;
+    unsigned int split = start + 4*25 + 2;
+    nve_up->prepRun(start);
+    for (unsigned int i = start; i < start + 400; i++)
+        {
+        if (i == split)
+            nve_up->prepRun(i);
+
+        if ((i - start) % 4 == 0)
+            {
+            ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+            ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::read);
+
+            Scalar t = Scalar(i - start) * deltaT;
+            MY_BOOST_CHECK_CLOSE(h_pos.data[0].x, 3.0 * t + 1.0/2.0 * 1.5 * t*t, loose_tol);
+            MY_BOOST_CHECK_CLOSE(h_vel.data[0].x, 3.0 + 1.5 * t, loose_tol);
+
+            // the particle starts at rest along y, so a misplaced slow impulse shows up as a large relative error
+            if (i > start)
+                {
+                MY_BOOST_CHECK_CLOSE(h_pos.data[0].y, 1.0/2.0 * 2.5 * t*t, loose_tol);
+                MY_BOOST_CHECK_CLOSE(h_vel.data[0].y, 2.5 * t, loose_tol);
+                }
+            }
+
+        nve_up->update(i);
+        }
+    }
+
 //! Check that the particle movement limit works
 void nve_updater_limit_tests(twostepnve_creator nve_creator, boost::shared_ptr<ExecutionConfiguration> exec_conf)
     {
@@ -388,6 +499,88 @@ void nve_updater_compare_test(twostepnve_creator nve_creator1,
         }
     }
 
+//! Checks that deferring the second step to the next update() gives the same trajectory
+void nve_updater_fused_tests(twostepnve_creator nve_creator, boost::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    const unsigned int N = 500;
+
+    // create two identical random particle systems, one integrated with fused steps and one without
+    RandomInitializer rand_init(N, Scalar(0.2), Scalar(0.9), "A");
+    rand_init.setSeed(12345);
+    boost::shared_ptr<SnapshotSystemData> snap = rand_init.getSnapshot();
+
+    boost::shared_ptr<SystemDefinition> sysdef[2];
+    boost::shared_ptr<ParticleData> pdata[2];
+    boost::shared_ptr<IntegratorTwoStep> nve[2];
+    for (unsigned int k = 0; k < 2; k++)
+        {
+        sysdef[k] = boost::shared_ptr<SystemDefinition>(new SystemDefinition(snap, exec_conf));
+        pdata[k] = sysdef[k]->getParticleData();
+        boost::shared_ptr<ParticleSelector> selector_all(new ParticleSelectorTag(sysdef[k], 0, pdata[k]->getN()-1));
+        boost::shared_ptr<ParticleGroup> group_all(new ParticleGroup(sysdef[k], selector_all));
+
+        boost::shared_ptr<NeighborList> nlist(new NeighborList(sysdef[k], Scalar(3.0), Scalar(0.8)));
+        boost::shared_ptr<PotentialPairLJ> fc(new PotentialPairLJ(sysdef[k], nlist));
+        fc->setRcut(0, 0, Scalar(3.0));
+        fc->setParams(0,0,make_scalar2(Scalar(4.0), Scalar(4.0)));
+
+        boost::shared_ptr<TwoStepNVE> two_step_nve = nve_creator(sysdef[k], group_all);
+        two_step_nve->setLimit(Scalar(0.01));
+        nve[k] = boost::shared_ptr<IntegratorTwoStep>(new IntegratorTwoStep(sysdef[k], Scalar(0.005)));
+        nve[k]->addIntegrationMethod(two_step_nve);
+        nve[k]->addForceCompute(fc);
+        nve[k]->prepRun(0);
+        }
+
+    // defer every step but the last in each block of 10, as System does around analyzer calls
+    for (unsigned int i = 0; i < 50; i++)
+        {
+        nve[0]->setDeferStep(i % 10 != 9);
+        nve[0]->update(i);
+        nve[1]->update(i);
+
+        if (i % 10 == 9)
+            {
+            ArrayHandle<Scalar4> h_pos0(pdata[0]->getPositions(), access_location::host, access_mode::read);
+            ArrayHandle<Scalar4> h_vel0(pdata[0]->getVelocities(), access_location::host, access_mode::read);
+            ArrayHandle<int3> h_image0(pdata[0]->getImages(), access_location::host, access_mode::read);
+            ArrayHandle<Scalar4> h_pos1(pdata[1]->getPositions(), access_location::host, access_mode::read);
+            ArrayHandle<Scalar4> h_vel1(pdata[1]->getVelocities(), access_location::host, access_mode::read);
+            ArrayHandle<int3> h_image1(pdata[1]->getImages(), access_location::host, access_mode::read);
+
+            for (unsigned int j = 0; j < N; j++)
+                {
+                MY_BOOST_CHECK_CLOSE(h_pos0.data[j].x, h_pos1.data[j].x, tol);
+                MY_BOOST_CHECK_CLOSE(h_pos0.data[j].y, h_pos1.data[j].y, tol);
+                MY_BOOST_CHECK_CLOSE(h_pos0.data[j].z, h_pos1.data[j].z, tol);
+
+                MY_BOOST_CHECK_CLOSE(h_vel0.data[j].x, h_vel1.data[j].x, tol);
+                MY_BOOST_CHECK_CLOSE(h_vel0.data[j].y, h_vel1.data[j].y, tol);
+                MY_BOOST_CHECK_CLOSE(h_vel0.data[j].z, h_vel1.data[j].z, tol);
+
+                BOOST_CHECK_EQUAL(h_image0.data[j].x, h_image1.data[j].x);
+                BOOST_CHECK_EQUAL(h_image0.data[j].y, h_image1.data[j].y);
+                BOOST_CHECK_EQUAL(h_image0.data[j].z, h_image1.data[j].z);
+                }
+            }
+        }
+
+    // a pending step is completed by finishStep()
+    nve[0]->setDeferStep(true);
+    nve[0]->update(50);
+    nve[0]->finishStep();
+    nve[1]->update(50);
+
+    ArrayHandle<Scalar4> h_vel0(pdata[0]->getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_vel1(pdata[1]->getVelocities(), access_location::host, access_mode::read);
+    for (unsigned int j = 0; j < N; j++)
+        {
+        MY_BOOST_CHECK_CLOSE(h_vel0.data[j].x, h_vel1.data[j].x, tol);
+        MY_BOOST_CHECK_CLOSE(h_vel0.data[j].y, h_vel1.data[j].y, tol);
+        MY_BOOST_CHECK_CLOSE(h_vel0.data[j].z, h_vel1.data[j].z, tol);
+        }
+    }
+
 //! TwoStepNVE factory for the unit tests
 boost::shared_ptr<TwoStepNVE> base_class_nve_creator(boost::shared_ptr<SystemDefinition> sysdef, boost::shared_ptr<ParticleGroup> group)
     {
@@ -410,6 +603,27 @@ BOOST_AUTO_TEST_CASE( TwoStepNVE_integrate_tests )
     nve_updater_integrate_tests(nve_creator, boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
 
+//! boost test case for base class RESPA tests
+BOOST_AUTO_TEST_CASE( TwoStepNVE_respa_tests )
+    {
+    twostepnve_creator nve_creator = bind(base_class_nve_creator, _1, _2);
+    nve_updater_respa_tests(nve_creator, boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
+//! boost test case for base class RESPA tests starting off-period
+BOOST_AUTO_TEST_CASE( TwoStepNVE_respa_offset_tests )
+    {
+    twostepnve_creator nve_creator = bind(base_class_nve_creator, _1, _2);
+    nve_updater_respa_offset_tests(nve_creator, boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
+//! boost test case for base class fused step tests
+BOOST_AUTO_TEST_CASE( TwoStepNVE_fused_tests )
+    {
+    twostepnve_creator nve_creator = bind(base_class_nve_creator, _1, _2);
+    nve_updater_fused_tests(nve_creator, boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
 //! boost test case for base class limit tests
 BOOST_AUTO_TEST_CASE( TwoStepNVE_limit_tests )
     {
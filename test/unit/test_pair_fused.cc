@@ -0,0 +1,208 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+#ifdef WIN32
+#pragma warning( push )
+#pragma warning( disable : 4103 4244 )
+#endif
+
+#include <iostream>
+
+#include <boost/shared_ptr.hpp>
+
+#include "AllPairPotentials.h"
+#include "PotentialPairFused.h"
+
+#include "NeighborListBinned.h"
+#include "Initializers.h"
+
+#include <math.h>
+
+using namespace std;
+using namespace boost;
+
+/*! \file test_pair_fused.cc
+    \brief Implements unit tests for PotentialPairFused
+    \ingroup unit_tests
+*/
+
+//! Name the unit test module
+#define BOOST_TEST_MODULE PotentialPairFusedTests
+#include "boost_utf_configure.h"
+
+//! Compares a fused LJ + Yukawa pass to the two potentials computed separately
+void pair_fused_comparison_test(boost::shared_ptr<ExecutionConfiguration> exec_conf, NeighborList::storageMode mode)
+    {
+    const unsigned int N = 2000;
+
+    // create a random particle system to sum forces on
+    RandomInitializer rand_init(N, Scalar(0.2), Scalar(0.9), "A");
+    boost::shared_ptr<SnapshotSystemData> snap = rand_init.getSnapshot();
+    boost::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+    boost::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    pdata->setFlags(~PDataFlags(0));
+
+    boost::shared_ptr<NeighborListBinned> nlist(new NeighborListBinned(sysdef, Scalar(3.0), Scalar(0.4)));
+    nlist->setStorageMode(mode);
+
+    boost::shared_ptr<PotentialPairLJ> lj(new PotentialPairLJ(sysdef, nlist));
+    boost::shared_ptr<PotentialPairYukawa> yukawa(new PotentialPairYukawa(sysdef, nlist));
+
+    // different cutoffs and shift modes exercise the per potential parameters
+    lj->setRcut(0, 0, Scalar(2.5));
+    lj->setParams(0, 0, make_scalar2(Scalar(4.0), Scalar(4.0)));
+    lj->setShiftMode(PotentialPairLJ::xplor);
+    lj->setRon(0, 0, Scalar(2.0));
+    yukawa->setRcut(0, 0, Scalar(3.0));
+    yukawa->setParams(0, 0, make_scalar2(Scalar(1.5), Scalar(0.8)));
+    yukawa->setShiftMode(PotentialPairYukawa::shift);
+
+    boost::shared_ptr<PotentialPairFused> fused(new PotentialPairFused(sysdef, nlist));
+    fused->addPotential(lj);
+    fused->addPotential(yukawa);
+
+    // the fused compute logs the energy of each potential under its original name
+    std::vector<std::string> quantities = fused->getProvidedLogQuantities();
+    BOOST_REQUIRE_EQUAL(quantities.size(), (unsigned int)2);
+    BOOST_CHECK_EQUAL(quantities[0], lj->getProvidedLogQuantities()[0]);
+    BOOST_CHECK_EQUAL(quantities[1], yukawa->getProvidedLogQuantities()[0]);
+
+    lj->compute(0);
+    yukawa->compute(0);
+    fused->compute(0);
+
+    MY_BOOST_CHECK_CLOSE(fused->getLogValue(quantities[0], 0), lj->calcEnergySum(), tol);
+    MY_BOOST_CHECK_CLOSE(fused->getLogValue(quantities[1], 0), yukawa->calcEnergySum(), tol);
+
+    {
+    unsigned int pitch = lj->getVirialArray().getPitch();
+    ArrayHandle<Scalar4> h_force_lj(lj->getForceArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_virial_lj(lj->getVirialArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_force_yukawa(yukawa->getForceArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_virial_yukawa(yukawa->getVirialArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_force_fused(fused->getForceArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_virial_fused(fused->getVirialArray(), access_location::host, access_mode::read);
+
+    // compare average deviation between the fused and the summed separate computes
+    double deltaf2 = 0.0;
+    double deltape2 = 0.0;
+    double deltav2 = 0.0;
+    for (unsigned int i = 0; i < N; i++)
+        {
+        Scalar4 f = h_force_fused.data[i];
+        Scalar4 f_sum = h_force_lj.data[i];
+        f_sum.x += h_force_yukawa.data[i].x;
+        f_sum.y += h_force_yukawa.data[i].y;
+        f_sum.z += h_force_yukawa.data[i].z;
+        f_sum.w += h_force_yukawa.data[i].w;
+
+        deltaf2 += double(f.x - f_sum.x) * double(f.x - f_sum.x);
+        deltaf2 += double(f.y - f_sum.y) * double(f.y - f_sum.y);
+        deltaf2 += double(f.z - f_sum.z) * double(f.z - f_sum.z);
+        deltape2 += double(f.w - f_sum.w) * double(f.w - f_sum.w);
+        for (unsigned int j = 0; j < 6; j++)
+            {
+            double v_sum = double(h_virial_lj.data[j*pitch+i]) + double(h_virial_yukawa.data[j*pitch+i]);
+            deltav2 += (double(h_virial_fused.data[j*pitch+i]) - v_sum) * (double(h_virial_fused.data[j*pitch+i]) - v_sum);
+            }
+        }
+    deltaf2 /= double(N);
+    deltape2 /= double(N);
+    deltav2 /= double(N);
+
+    BOOST_CHECK_SMALL(deltaf2, double(tol_small));
+    BOOST_CHECK_SMALL(deltape2, double(tol_small));
+    BOOST_CHECK_SMALL(deltav2, double(tol_small));
+    }
+    }
+
+//! Tests that only standard pair potentials on the same neighbor list can be fused
+void pair_fused_error_test(boost::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    boost::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(2, BoxDim(10.0), 1, 0, 0, 0, 0, exec_conf));
+
+    boost::shared_ptr<NeighborList> nlist_1(new NeighborList(sysdef, Scalar(3.0), Scalar(0.4)));
+    boost::shared_ptr<NeighborList> nlist_2(new NeighborList(sysdef, Scalar(3.0), Scalar(0.4)));
+
+    boost::shared_ptr<PotentialPairLJ> lj_1(new PotentialPairLJ(sysdef, nlist_1));
+    boost::shared_ptr<PotentialPairLJ> lj_2(new PotentialPairLJ(sysdef, nlist_2));
+    boost::shared_ptr<PotentialPairDPDThermoDPD> dpd(new PotentialPairDPDThermoDPD(sysdef, nlist_1));
+
+    boost::shared_ptr<PotentialPairFused> fused(new PotentialPairFused(sysdef, nlist_1));
+    fused->addPotential(lj_1);
+    BOOST_CHECK_THROW(fused->addPotential(lj_1), runtime_error);
+    BOOST_CHECK_THROW(fused->addPotential(lj_2), runtime_error);
+    BOOST_CHECK_THROW(fused->addPotential(dpd), runtime_error);
+    }
+
+//! boost test case for the fused pass with a half neighbor list
+BOOST_AUTO_TEST_CASE( PotentialPairFused_half )
+    {
+    pair_fused_comparison_test(boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)),
+                               NeighborList::half);
+    }
+
+//! boost test case for the fused pass with a full neighbor list
+BOOST_AUTO_TEST_CASE( PotentialPairFused_full )
+    {
+    pair_fused_comparison_test(boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)),
+                               NeighborList::full);
+    }
+
+//! boost test case for invalid potentials
+BOOST_AUTO_TEST_CASE( PotentialPairFused_errors )
+    {
+    pair_fused_error_test(boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
+#ifdef WIN32
+#pragma warning( pop )
+#endif
@@ -64,6 +64,7 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #include "Initializers.h"
 #include "ParticleGroup.h"
 #include "RigidBodyGroup.h"
+#include "GroupSelectUpdater.h"
 
 using namespace std;
 using namespace boost;
@@ -471,6 +472,86 @@ BOOST_AUTO_TEST_CASE( ParticleGroup_cuboid_test )
     BOOST_CHECK_EQUAL_UINT(tags2.getMemberTag(2), 2);
     }
 
+//! Checks that GroupSelectUpdater re-evaluates a selection, with the cuboid scan split over several threads
+BOOST_AUTO_TEST_CASE( GroupSelectUpdater_test )
+    {
+    boost::shared_ptr<SystemDefinition> sysdef = create_sysdef();
+    boost::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    // create a group containing particles 0 and 1
+    boost::shared_ptr<ParticleSelectorCuboid> selector(new ParticleSelectorCuboid(sysdef,
+                                                                          make_scalar3(-0.5, -0.5, -0.5),
+                                                                          make_scalar3( 1.5,  2.5,  3.5)));
+    selector->setNumThreads(3);
+    boost::shared_ptr<ParticleGroup> group(new ParticleGroup(sysdef, selector));
+    BOOST_REQUIRE_EQUAL_UINT(group->getNumMembers(), 2);
+
+    GroupSelectUpdater updater(sysdef, group, selector);
+
+    // move particle 0 out and particles 7 and 9 in
+    pdata->setPosition(0, make_scalar3(4.0, 4.0, 4.0));
+    pdata->setPosition(7, make_scalar3(0.5, 0.5, 0.5));
+    pdata->setPosition(9, make_scalar3(1.0, 1.0, 1.0));
+    updater.update(1);
+    BOOST_REQUIRE_EQUAL_UINT(group->getNumMembers(), 3);
+    BOOST_CHECK_EQUAL_UINT(group->getMemberTag(0), 1);
+    BOOST_CHECK_EQUAL_UINT(group->getMemberTag(1), 7);
+    BOOST_CHECK_EQUAL_UINT(group->getMemberTag(2), 9);
+    BOOST_CHECK(!group->isMember(0));
+    }
+
+//! Checks that updateMemberTags re-evaluates a selection after particles move
+BOOST_AUTO_TEST_CASE( ParticleGroup_update_test )
+    {
+    boost::shared_ptr<SystemDefinition> sysdef = create_sysdef();
+    boost::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    // create a group containing particles 0 and 1
+    boost::shared_ptr<ParticleSelector> selector(new ParticleSelectorCuboid(sysdef,
+                                                                     make_scalar3(-0.5, -0.5, -0.5),
+                                                                     make_scalar3( 1.5,  2.5,  3.5)));
+    ParticleGroup group(sysdef, selector);
+    BOOST_REQUIRE_EQUAL_UINT(group.getNumMembers(), 2);
+
+    // re-selecting without changes keeps the group intact
+    group.updateMemberTags(selector);
+    BOOST_REQUIRE_EQUAL_UINT(group.getNumMembers(), 2);
+    BOOST_CHECK_EQUAL_UINT(group.getMemberTag(0), 0);
+    BOOST_CHECK_EQUAL_UINT(group.getMemberTag(1), 1);
+
+    // move particle 1 out and particle 9 in
+    pdata->setPosition(1, make_scalar3(4.0, 4.0, 4.0));
+    pdata->setPosition(9, make_scalar3(1.0, 1.0, 1.0));
+    group.updateMemberTags(selector);
+    BOOST_REQUIRE_EQUAL_UINT(group.getNumMembers(), 2);
+    BOOST_CHECK_EQUAL_UINT(group.getMemberTag(0), 0);
+    BOOST_CHECK_EQUAL_UINT(group.getMemberTag(1), 9);
+    BOOST_CHECK_EQUAL_UINT(group.getMemberIndex(0), 0);
+    BOOST_CHECK_EQUAL_UINT(group.getMemberIndex(1), 9);
+    BOOST_CHECK(group.isMember(9));
+    BOOST_CHECK(!group.isMember(1));
+
+    // move particle 2 in as well, so that the group grows
+    pdata->setPosition(2, make_scalar3(0.25, 0.25, 0.25));
+    group.updateMemberTags(selector);
+    BOOST_REQUIRE_EQUAL_UINT(group.getNumMembers(), 3);
+    BOOST_CHECK_EQUAL_UINT(group.getIndexArray().getNumElements(), 3);
+    BOOST_CHECK_EQUAL_UINT(group.getMemberTag(1), 2);
+    BOOST_CHECK(group.isMember(2));
+
+    // the batch selection by type must agree with the per-tag selection
+    boost::shared_ptr<ParticleSelector> selector_type(new ParticleSelectorType(sysdef, 1, 2));
+    std::vector<unsigned int> tags;
+    selector_type->getSelectedTags(tags);
+    std::vector<unsigned int> expected;
+    for (unsigned int tag = 0; tag < pdata->getNGlobal(); tag++)
+        if (selector_type->isSelected(tag))
+            expected.push_back(tag);
+    BOOST_REQUIRE_EQUAL(tags.size(), expected.size());
+    for (unsigned int i = 0; i < tags.size(); i++)
+        BOOST_CHECK_EQUAL_UINT(tags[i], expected[i]);
+    }
+
 //! Checks that the ParticleGroup boolean operation work correctly
 BOOST_AUTO_TEST_CASE( ParticleGroup_boolean_tests)
     {
@@ -0,0 +1,232 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+// Maintainer: joaander
+
+#ifdef WIN32
+#pragma warning( push )
+#pragma warning( disable : 4103 4244 )
+#endif
+
+#include <iostream>
+
+//! Name the unit test module
+#define BOOST_TEST_MODULE RandomGeneratorTests
+#include "boost_utf_configure.h"
+
+#include "RandomGenerator.h"
+
+#include <set>
+#include <boost/thread.hpp>
+
+using namespace std;
+using namespace boost;
+
+/*! \file test_random_generator.cc
+    \brief Implements unit tests for RandomGenerator
+    \ingroup unit_tests
+*/
+
+//! Generate a melt of 10-bead polymers large enough to be split into regions
+boost::shared_ptr<SnapshotSystemData> generate_melt(boost::shared_ptr<ExecutionConfiguration> exec_conf,
+                                                    unsigned int num_threads)
+    {
+    unsigned int n_poly = 4000;
+    unsigned int n_bead = 10;
+    Scalar phi_p = 0.2;
+    Scalar L = pow(M_PI/6.0/phi_p*Scalar(n_poly*n_bead),1.0/3.0);
+
+    std::vector<string> types(n_bead, "A");
+    std::vector<unsigned int> bond_a, bond_b;
+    std::vector<string> bond_types;
+    for (unsigned int i = 0; i < n_bead-1; i++)
+        {
+        bond_a.push_back(i);
+        bond_b.push_back(i+1);
+        bond_types.push_back("polymer");
+        }
+
+    RandomGenerator generator(exec_conf, BoxDim(L), 12345, 3);
+    generator.addGenerator(n_poly, boost::shared_ptr<PolymerParticleGenerator>(
+        new PolymerParticleGenerator(exec_conf, 1.0, types, bond_a, bond_b, bond_types, 100, 3)));
+    generator.setSeparationRadius("A", 0.4);
+    generator.setNumThreads(num_threads);
+    generator.generate();
+    return generator.getSnapshot();
+    }
+
+//! Checks that the generated system does not depend on the number of threads and is valid
+BOOST_AUTO_TEST_CASE( RandomGenerator_threads )
+    {
+    boost::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    boost::shared_ptr<SnapshotSystemData> snap_1 = generate_melt(exec_conf, 1);
+    boost::shared_ptr<SnapshotSystemData> snap_4 = generate_melt(exec_conf, 4);
+
+    const SnapshotParticleData& p1 = snap_1->particle_data;
+    const SnapshotParticleData& p4 = snap_4->particle_data;
+    BOOST_REQUIRE_EQUAL(p1.size, (unsigned int)40000);
+    BOOST_REQUIRE_EQUAL(p4.size, p1.size);
+    for (unsigned int i = 0; i < p1.size; i++)
+        {
+        BOOST_REQUIRE_EQUAL(p1.pos[i].x, p4.pos[i].x);
+        BOOST_REQUIRE_EQUAL(p1.pos[i].y, p4.pos[i].y);
+        BOOST_REQUIRE_EQUAL(p1.pos[i].z, p4.pos[i].z);
+        BOOST_REQUIRE_EQUAL(p1.image[i].x, p4.image[i].x);
+        BOOST_REQUIRE_EQUAL(p1.image[i].y, p4.image[i].y);
+        BOOST_REQUIRE_EQUAL(p1.image[i].z, p4.image[i].z);
+        }
+
+    const BondData::Snapshot& b1 = snap_1->bond_data;
+    const BondData::Snapshot& b4 = snap_4->bond_data;
+    BOOST_REQUIRE_EQUAL(b1.groups.size(), (unsigned int)(4000*9));
+    BOOST_REQUIRE_EQUAL(b4.groups.size(), b1.groups.size());
+
+    const BoxDim& box = snap_1->global_box;
+    for (unsigned int i = 0; i < b1.groups.size(); i++)
+        {
+        BOOST_REQUIRE_EQUAL(b1.groups[i].tag[0], b4.groups[i].tag[0]);
+        BOOST_REQUIRE_EQUAL(b1.groups[i].tag[1], b4.groups[i].tag[1]);
+
+        // bonded particles are placed one bond length apart, in unwrapped coordinates
+        unsigned int a = b1.groups[i].tag[0];
+        unsigned int b = b1.groups[i].tag[1];
+        Scalar3 dx = box.shift(p1.pos[b], p1.image[b]) - box.shift(p1.pos[a], p1.image[a]);
+        MY_BOOST_CHECK_CLOSE(sqrt(dot(dx,dx)), 1.0, tol);
+        }
+
+    // spot check that no particles overlap
+    for (unsigned int i = 0; i < p1.size; i += 97)
+        {
+        for (unsigned int j = 0; j < p1.size; j++)
+            {
+            if (i == j)
+                continue;
+            Scalar3 dx = box.minImage(p1.pos[j] - p1.pos[i]);
+            BOOST_REQUIRE(dot(dx,dx) >= Scalar(0.8*0.8*0.999));
+            }
+        }
+    }
+
+//! Places single particles and records the threads it was called on
+class ThreadRecordingGenerator : public ParticleGenerator
+    {
+    public:
+        //! Constructor
+        ThreadRecordingGenerator(bool thread_safe) : m_thread_safe(thread_safe) { }
+
+        //! Places one particle
+        virtual unsigned int getNumToGenerate()
+            {
+            return 1;
+            }
+
+        //! Place a particle in the region and record the calling thread
+        virtual void generateParticles(GeneratedParticles& particles, boost::mt19937& rnd, unsigned int start_idx)
+            {
+                {
+                boost::mutex::scoped_lock lock(m_mutex);
+                m_threads.insert(boost::this_thread::get_id());
+                }
+
+            Scalar3 f = (particles.getRegionLo() + particles.getRegionHi()) * Scalar(0.5);
+            GeneratedParticles::particle p;
+            p.type = "A";
+            for (unsigned int attempt = 0; attempt < 1000; attempt++)
+                {
+                Scalar3 pos = particles.getBox().makeCoordinates(f);
+                p.x = pos.x; p.y = pos.y; p.z = pos.z;
+                if (particles.canPlace(p))
+                    {
+                    particles.place(p, start_idx);
+                    return;
+                    }
+                f.x = particles.getRegionLo().x + Scalar(rnd() % 1000) / Scalar(1000.0)
+                      * (particles.getRegionHi().x - particles.getRegionLo().x);
+                f.y = particles.getRegionLo().y + Scalar(rnd() % 1000) / Scalar(1000.0)
+                      * (particles.getRegionHi().y - particles.getRegionLo().y);
+                f.z = particles.getRegionLo().z + Scalar(rnd() % 1000) / Scalar(1000.0)
+                      * (particles.getRegionHi().z - particles.getRegionLo().z);
+                }
+            throw runtime_error("Error generating particle");
+            }
+
+        //! Report the flag given to the constructor
+        virtual bool isThreadSafe()
+            {
+            return m_thread_safe;
+            }
+
+        std::set<boost::thread::id> m_threads; //!< Threads generateParticles() was called on
+
+    private:
+        bool m_thread_safe;     //!< Value returned by isThreadSafe()
+        boost::mutex m_mutex;   //!< Protects m_threads
+    };
+
+//! Checks that generators that are not thread safe are only called on the calling thread
+BOOST_AUTO_TEST_CASE( RandomGenerator_not_thread_safe )
+    {
+    boost::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    boost::shared_ptr<ThreadRecordingGenerator> gen(new ThreadRecordingGenerator(false));
+    RandomGenerator generator(exec_conf, BoxDim(40.0), 12345, 3);
+    generator.addGenerator(40000, gen);
+    generator.setSeparationRadius("A", 0.4);
+    generator.setNumThreads(4);
+    generator.generate();
+
+    BOOST_CHECK_EQUAL(generator.getSnapshot()->particle_data.size, (unsigned int)40000);
+    BOOST_REQUIRE_EQUAL(gen->m_threads.size(), (unsigned int)1);
+    BOOST_CHECK(*gen->m_threads.begin() == boost::this_thread::get_id());
+    }
+
+#ifdef WIN32
+#pragma warning( pop )
+#endif
@@ -0,0 +1,252 @@
+/*
+Highly Optimized Object-oriented Many-particle Dynamics -- Blue Edition
+(HOOMD-blue) Open Source Software License Copyright 2009-2014 The Regents of
+the University of Michigan All rights reserved.
+
+HOOMD-blue may contain modifications ("Contributions") provided, and to which
+copyright is held, by various Contributors who have granted The Regents of the
+University of Michigan the right to modify and/or distribute such Contributions.
+
+You may redistribute, use, and create derivate works of HOOMD-blue, in source
+and binary forms, provided you abide by the following conditions:
+
+* Redistributions of source code must retain the above copyright notice, this
+list of conditions, and the following disclaimer both in the code and
+prominently in any materials provided with the distribution.
+
+* Redistributions in binary form must reproduce the above copyright notice, this
+list of conditions, and the following disclaimer in the documentation and/or
+other materials provided with the distribution.
+
+* All publications and presentations based on HOOMD-blue, including any reports
+or published results obtained, in whole or in part, with HOOMD-blue, will
+acknowledge its use according to the terms posted at the time of submission on:
+http://codeblue.umich.edu/hoomd-blue/citations.html
+
+* Any electronic documents citing HOOMD-Blue will link to the HOOMD-Blue website:
+http://codeblue.umich.edu/hoomd-blue/
+
+* Apart from the above required attributions, neither the name of the copyright
+holder nor the names of HOOMD-blue's contributors may be used to endorse or
+promote products derived from this software without specific prior written
+permission.
+
+Disclaimer
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDER AND CONTRIBUTORS ``AS IS'' AND
+ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE, AND/OR ANY
+WARRANTIES THAT THIS SOFTWARE IS FREE OF INFRINGEMENT ARE DISCLAIMED.
+
+IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE
+OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF
+ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+#ifdef WIN32
+#pragma warning( push )
+#pragma warning( disable : 4103 4244 )
+#endif
+
+#include <iostream>
+
+#include <boost/bind.hpp>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include "SFCPackUpdater.h"
+#include "NeighborListBinned.h"
+#include "CellList.h"
+
+#ifdef ENABLE_CUDA
+#include "SFCPackUpdaterGPU.h"
+#endif
+
+#include <math.h>
+
+using namespace std;
+using namespace boost;
+
+//! label the boost test module
+#define BOOST_TEST_MODULE SFCPackUpdaterTests
+#include "boost_utf_configure.h"
+
+/*! \file test_sfc_pack_updater.cc
+    \brief Unit tests for the SFCPackUpdater class
+    \ingroup unit_tests
+*/
+
+//! Typedef'd SFCPackUpdater factory
+typedef boost::function<boost::shared_ptr<SFCPackUpdater> (boost::shared_ptr<SystemDefinition> sysdef)> sfcpack_creator;
+
+//! Checks that particles on a lattice are ordered along a hilbert curve, and that no particle data is lost
+void sfcpack_lattice_test(sfcpack_creator creator, boost::shared_ptr<ExecutionConfiguration> exec_conf, unsigned int dim)
+    {
+    // one particle per grid cell, so consecutive particles on the curve are lattice neighbors
+    const unsigned int L = 8;
+    unsigned int N = (dim == 3) ? L*L*L : L*L;
+    BoxDim box((Scalar)L);
+    boost::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(N, box, 1, 0, 0, 0, 0, exec_conf));
+    sysdef->setNDimensions(dim);
+    boost::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    // fill the lattice in a scrambled order and tag the data so that it can be tracked
+    for (unsigned int tag = 0; tag < N; tag++)
+        {
+        unsigned int idx = (tag * 37) % N;
+        unsigned int i = idx % L;
+        unsigned int j = (idx / L) % L;
+        unsigned int k = (dim == 3) ? idx / (L*L) : 0;
+
+        Scalar z = (dim == 3) ? Scalar(k) - Scalar(L)/Scalar(2.0) + Scalar(0.5) : Scalar(0.0);
+        pdata->setPosition(tag, make_scalar3(Scalar(i) - Scalar(L)/Scalar(2.0) + Scalar(0.5),
+                                             Scalar(j) - Scalar(L)/Scalar(2.0) + Scalar(0.5),
+                                             z));
+        pdata->setVelocity(tag, make_scalar3(Scalar(tag), Scalar(2*tag), Scalar(3*tag)));
+        pdata->setCharge(tag, Scalar(tag));
+        pdata->setDiameter(tag, Scalar(tag+1));
+        }
+
+    boost::shared_ptr<SFCPackUpdater> sorter = creator(sysdef);
+    sorter->setGrid(L);
+    sorter->update(0);
+
+    // all per-particle data must still belong to the same tag
+    for (unsigned int tag = 0; tag < N; tag++)
+        {
+        Scalar3 vel = pdata->getVelocity(tag);
+        MY_BOOST_CHECK_CLOSE(vel.x, Scalar(tag), tol_small);
+        MY_BOOST_CHECK_CLOSE(vel.y, Scalar(2*tag), tol_small);
+        MY_BOOST_CHECK_CLOSE(vel.z, Scalar(3*tag), tol_small);
+        MY_BOOST_CHECK_CLOSE(pdata->getCharge(tag), Scalar(tag), tol_small);
+        MY_BOOST_CHECK_CLOSE(pdata->getDiameter(tag), Scalar(tag+1), tol_small);
+        }
+
+    // consecutive particles in memory must be nearest neighbors on the lattice
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_rtag(pdata->getRTags(), access_location::host, access_mode::read);
+    for (unsigned int i = 0; i < N; i++)
+        {
+        BOOST_CHECK_EQUAL_UINT(h_rtag.data[h_tag.data[i]], i);
+
+        if (i > 0)
+            {
+            Scalar dx = h_pos.data[i].x - h_pos.data[i-1].x;
+            Scalar dy = h_pos.data[i].y - h_pos.data[i-1].y;
+            Scalar dz = h_pos.data[i].z - h_pos.data[i-1].z;
+            MY_BOOST_CHECK_CLOSE(dx*dx + dy*dy + dz*dz, Scalar(1.0), tol_small);
+            }
+        }
+    }
+
+//! Checks that adaptive sorting waits for the neighbor list and then takes a reference sort
+void sfcpack_adaptive_test(sfcpack_creator creator, boost::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // two particles far apart on the curve, stored in the wrong order
+    boost::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(3, BoxDim(10.0), 1, 0, 0, 0, 0, exec_conf));
+    boost::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    pdata->setPosition(0, make_scalar3(4.5, 4.5, 4.5));
+    pdata->setPosition(1, make_scalar3(-4.5, -4.5, -4.5));
+    pdata->setPosition(2, make_scalar3(-4.0, -4.5, -4.5));
+
+    boost::shared_ptr<CellList> cl(new CellList(sysdef));
+    boost::shared_ptr<NeighborList> nlist(new NeighborListBinned(sysdef, Scalar(1.0), Scalar(0.5), cl));
+
+    boost::shared_ptr<SFCPackUpdater> sorter = creator(sysdef);
+    sorter->setNeighborList(nlist);
+    sorter->setAdaptive(true);
+
+    // the neighbor list has not been built yet, so nothing may happen
+    sorter->update(0);
+        {
+        ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+        BOOST_CHECK_EQUAL_UINT(h_tag.data[0], 0);
+        }
+
+    // the first check with a valid neighbor list always sorts
+    nlist->compute(1);
+    sorter->update(1);
+        {
+        ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+        BOOST_CHECK_EQUAL_UINT(h_tag.data[2], 0);
+        }
+
+    // the next check only takes the reference, it never sorts
+    nlist->compute(2);
+    pdata->setPosition(0, make_scalar3(-4.5, -4.0, -4.5));
+    pdata->setPosition(1, make_scalar3(4.5, 4.5, 4.5));
+    sorter->update(2);
+        {
+        ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+        BOOST_CHECK_EQUAL_UINT(h_tag.data[2], 0);
+        }
+    }
+
+//! SFCPackUpdater creator for unit tests
+boost::shared_ptr<SFCPackUpdater> base_class_sfcpack_creator(boost::shared_ptr<SystemDefinition> sysdef)
+    {
+    return boost::shared_ptr<SFCPackUpdater>(new SFCPackUpdater(sysdef));
+    }
+
+//! SFCPackUpdater creator for unit tests that splits the radix sort over several threads
+boost::shared_ptr<SFCPackUpdater> threaded_sfcpack_creator(boost::shared_ptr<SystemDefinition> sysdef)
+    {
+    boost::shared_ptr<SFCPackUpdater> sorter(new SFCPackUpdater(sysdef));
+    sorter->setNumThreads(3);
+    return sorter;
+    }
+
+#ifdef ENABLE_CUDA
+//! SFCPackUpdaterGPU creator for unit tests
+boost::shared_ptr<SFCPackUpdater> gpu_sfcpack_creator(boost::shared_ptr<SystemDefinition> sysdef)
+    {
+    return boost::shared_ptr<SFCPackUpdater>(new SFCPackUpdaterGPU(sysdef));
+    }
+#endif
+
+//! boost test case for sorting a 3D lattice
+BOOST_AUTO_TEST_CASE( SFCPackUpdater_lattice3d )
+    {
+    sfcpack_creator creator = bind(base_class_sfcpack_creator, _1);
+    sfcpack_lattice_test(creator, boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)), 3);
+    }
+
+//! boost test case for sorting a 2D lattice
+BOOST_AUTO_TEST_CASE( SFCPackUpdater_lattice2d )
+    {
+    sfcpack_creator creator = bind(base_class_sfcpack_creator, _1);
+    sfcpack_lattice_test(creator, boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)), 2);
+    }
+
+//! boost test case for sorting a 3D lattice with the radix sort split over several threads
+BOOST_AUTO_TEST_CASE( SFCPackUpdater_lattice3d_threads )
+    {
+    sfcpack_creator creator = bind(threaded_sfcpack_creator, _1);
+    sfcpack_lattice_test(creator, boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)), 3);
+    }
+
+//! boost test case for adaptive sorting
+BOOST_AUTO_TEST_CASE( SFCPackUpdater_adaptive )
+    {
+    sfcpack_creator creator = bind(base_class_sfcpack_creator, _1);
+    sfcpack_adaptive_test(creator, boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
+#ifdef ENABLE_CUDA
+//! boost test case for sorting a 3D lattice on the GPU
+BOOST_AUTO_TEST_CASE( SFCPackUpdaterGPU_lattice3d )
+    {
+    sfcpack_creator creator = bind(gpu_sfcpack_creator, _1);
+    sfcpack_lattice_test(creator, boost::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)), 3);
+    }
+#endif
+
+#ifdef WIN32
+#pragma warning( pop )
+#endif
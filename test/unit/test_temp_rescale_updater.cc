@@ -108,6 +108,92 @@ BOOST_AUTO_TEST_CASE( ComputeThermo_basic )
     MY_BOOST_CHECK_CLOSE(tc->getTemperature(), 15.1666666666666666666667, tol);
     }
 
+//! boost test case to verify that ComputeThermo::computeMany gives the same results as separate computes
+BOOST_AUTO_TEST_CASE( ComputeThermo_many )
+    {
+    boost::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(4, BoxDim(10.0), 4));
+    boost::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    PDataFlags flags;
+    flags[pdata_flag::isotropic_virial] = 1;
+    flags[pdata_flag::potential_energy] = 1;
+    flags[pdata_flag::pressure_tensor] = 1;
+    pdata->setFlags(flags);
+
+    {
+    ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_net_force(pdata->getNetForce(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar> h_net_virial(pdata->getNetVirial(), access_location::host, access_mode::readwrite);
+    unsigned int virial_pitch = pdata->getNetVirial().getPitch();
+
+    for (unsigned int i = 0; i < 4; i++)
+        {
+        h_vel.data[i] = make_scalar4(Scalar(i+1), Scalar(2*i)-Scalar(3), Scalar(0.5)*Scalar(i), Scalar(1+i));
+        h_net_force.data[i].w = Scalar(0.25)*Scalar(i+1);
+        for (unsigned int k = 0; k < 6; k++)
+            h_net_virial.data[k*virial_pitch+i] = Scalar(0.1)*Scalar(k+1)*Scalar(i+2);
+        }
+    }
+
+    // overlapping groups, one of which is shared by two computes
+    boost::shared_ptr<ParticleSelector> selector_all(new ParticleSelectorTag(sysdef, 0, 3));
+    boost::shared_ptr<ParticleGroup> group_all(new ParticleGroup(sysdef, selector_all));
+    boost::shared_ptr<ParticleSelector> selector_part(new ParticleSelectorTag(sysdef, 1, 2));
+    boost::shared_ptr<ParticleGroup> group_part(new ParticleGroup(sysdef, selector_part));
+
+    std::vector< boost::shared_ptr<ComputeThermo> > fused;
+    fused.push_back(boost::shared_ptr<ComputeThermo>(new ComputeThermo(sysdef, group_all)));
+    fused.push_back(boost::shared_ptr<ComputeThermo>(new ComputeThermo(sysdef, group_part)));
+    fused.push_back(boost::shared_ptr<ComputeThermo>(new ComputeThermo(sysdef, group_part)));
+
+    std::vector< boost::shared_ptr<ComputeThermo> > separate;
+    separate.push_back(boost::shared_ptr<ComputeThermo>(new ComputeThermo(sysdef, group_all)));
+    separate.push_back(boost::shared_ptr<ComputeThermo>(new ComputeThermo(sysdef, group_part)));
+
+    fused[0]->setNDOF(12);
+    fused[1]->setNDOF(6);
+    fused[2]->setNDOF(5);
+    separate[0]->setNDOF(12);
+    separate[1]->setNDOF(6);
+
+    ComputeThermo::computeMany(fused, 0);
+    separate[0]->compute(0);
+    separate[1]->compute(0);
+
+    for (unsigned int i = 0; i < 2; i++)
+        {
+        MY_BOOST_CHECK_CLOSE(fused[i]->getTemperature(), separate[i]->getTemperature(), tol);
+        MY_BOOST_CHECK_CLOSE(fused[i]->getPressure(), separate[i]->getPressure(), tol);
+        MY_BOOST_CHECK_CLOSE(fused[i]->getKineticEnergy(), separate[i]->getKineticEnergy(), tol);
+        MY_BOOST_CHECK_CLOSE(fused[i]->getPotentialEnergy(), separate[i]->getPotentialEnergy(), tol);
+        PressureTensor p_fused = fused[i]->getPressureTensor();
+        PressureTensor p_separate = separate[i]->getPressureTensor();
+        MY_BOOST_CHECK_CLOSE(p_fused.xx, p_separate.xx, tol);
+        MY_BOOST_CHECK_CLOSE(p_fused.xy, p_separate.xy, tol);
+        MY_BOOST_CHECK_CLOSE(p_fused.xz, p_separate.xz, tol);
+        MY_BOOST_CHECK_CLOSE(p_fused.yy, p_separate.yy, tol);
+        MY_BOOST_CHECK_CLOSE(p_fused.yz, p_separate.yz, tol);
+        MY_BOOST_CHECK_CLOSE(p_fused.zz, p_separate.zz, tol);
+        }
+
+    // the temperature of the third compute uses its own number of degrees of freedom
+    MY_BOOST_CHECK_CLOSE(fused[2]->getKineticEnergy(), separate[1]->getKineticEnergy(), tol);
+    MY_BOOST_CHECK_CLOSE(fused[2]->getTemperature(), separate[1]->getTemperature()*Scalar(6.0/5.0), tol);
+
+    // splitting the particles over several threads gives the same sums
+    ComputeThermo::computeMany(fused, 1, 3);
+    for (unsigned int i = 0; i < 2; i++)
+        {
+        MY_BOOST_CHECK_CLOSE(fused[i]->getTemperature(), separate[i]->getTemperature(), tol);
+        MY_BOOST_CHECK_CLOSE(fused[i]->getPressure(), separate[i]->getPressure(), tol);
+        MY_BOOST_CHECK_CLOSE(fused[i]->getPotentialEnergy(), separate[i]->getPotentialEnergy(), tol);
+        PressureTensor p_fused = fused[i]->getPressureTensor();
+        PressureTensor p_separate = separate[i]->getPressureTensor();
+        MY_BOOST_CHECK_CLOSE(p_fused.xy, p_separate.xy, tol);
+        MY_BOOST_CHECK_CLOSE(p_fused.zz, p_separate.zz, tol);
+        }
+    }
+
 #ifdef ENABLE_CUDA
 //! boost test case to verify proper operation of ComputeThermoGPU
 BOOST_AUTO_TEST_CASE( ComputeThermoGPU_basic )
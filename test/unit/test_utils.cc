@@ -54,18 +54,23 @@ ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 #endif
 
 #include <iostream>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
 
 #include <math.h>
 #include "ClockSource.h"
 #include "Profiler.h"
+#include "HardwareCounters.h"
 #include "Variant.h"
+#include "Schedule.h"
 
 //! Name the unit test module
 #define BOOST_TEST_MODULE UtilityClassesTests
 #include "boost_utf_configure.h"
 
 /*! \file utils_test.cc
-    \brief Unit tests for ClockSource, Profiler, and Variant
+    \brief Unit tests for ClockSource, Profiler, ProfileTrace, Variant, and Schedule
     \ingroup unit_tests
 */
 
@@ -194,6 +199,178 @@ BOOST_AUTO_TEST_CASE(Profiler_test)
 
     }
 
+//! Record a few profiled steps with a trace attached
+void trace_steps(boost::shared_ptr<ProfileTrace> trace)
+    {
+    Profiler prof("Main");
+    prof.setTrace(trace);
+
+    // only the even steps are recorded
+    for (unsigned int step = 0; step < 4; step++)
+        {
+        trace->setTimestep(step);
+        prof.push("Step \"A\"");
+        prof.push("Inner");
+        prof.pop();
+        prof.pop();
+        }
+
+    trace->flush();
+    }
+
+//! check the JSON output of ProfileTrace
+BOOST_AUTO_TEST_CASE(ProfileTrace_json)
+    {
+    boost::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    // a small block size forces blocks to be handed to the writer during the run
+    boost::shared_ptr<ProfileTrace> trace(new ProfileTrace(exec_conf, "test_trace.json", ProfileTrace::json, 2, 3));
+    trace_steps(trace);
+    BOOST_CHECK_EQUAL(trace->getNumDropped(), (uint64_t)0);
+    trace = boost::shared_ptr<ProfileTrace>();
+
+    ifstream f("test_trace.json");
+    stringstream buf;
+    buf << f.rdbuf();
+    string s = buf.str();
+    f.close();
+
+    // 2 recorded steps with 2 regions each
+    unsigned int n_begin = 0, n_end = 0;
+    for (size_t pos = s.find("\"ph\":\"B\""); pos != string::npos; pos = s.find("\"ph\":\"B\"", pos+1))
+        n_begin++;
+    for (size_t pos = s.find("\"ph\":\"E\""); pos != string::npos; pos = s.find("\"ph\":\"E\"", pos+1))
+        n_end++;
+    BOOST_CHECK_EQUAL(n_begin, (unsigned int)4);
+    BOOST_CHECK_EQUAL(n_end, (unsigned int)4);
+
+    BOOST_CHECK(s.find("\"args\":{\"step\":2}") != string::npos);
+    BOOST_CHECK(s.find("\"args\":{\"step\":1}") == string::npos);
+    BOOST_CHECK(s.find("Step \\\"A\\\"") != string::npos);
+    BOOST_CHECK_EQUAL(s[0], '[');
+    BOOST_CHECK(s.find("]") != string::npos);
+
+    remove("test_trace.json");
+    }
+
+//! check the binary output of ProfileTrace
+BOOST_AUTO_TEST_CASE(ProfileTrace_binary)
+    {
+    boost::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    boost::shared_ptr<ProfileTrace> trace(new ProfileTrace(exec_conf, "test_trace.bin", ProfileTrace::binary, 2, 16));
+    trace_steps(trace);
+    trace = boost::shared_ptr<ProfileTrace>();
+
+    ifstream f("test_trace.bin", ios_base::in | ios_base::binary);
+    char magic[8];
+    unsigned int header[2];
+    f.read(magic, 8);
+    f.read((char *)header, sizeof(header));
+    BOOST_CHECK_EQUAL(string(magic, 8), string("HOOMDTRC"));
+    BOOST_CHECK_EQUAL(header[0], (unsigned int)1);
+    BOOST_CHECK_EQUAL(header[1], (unsigned int)0);
+
+    // read blocks up to the name table
+    unsigned int n_events = 0;
+    unsigned int block[2];
+    f.read((char *)block, sizeof(block));
+    while (f.good() && block[0] != 0xffffffffu)
+        {
+        for (unsigned int i = 0; i < block[1]; i++)
+            {
+            ProfileTraceEvent ev;
+            f.read((char *)&ev, sizeof(ev));
+            BOOST_CHECK_EQUAL(ev.timestep % 2, (unsigned int)0);
+            n_events++;
+            }
+        f.read((char *)block, sizeof(block));
+        }
+    BOOST_CHECK_EQUAL(n_events, (unsigned int)8);
+
+    // two names in the table
+    BOOST_CHECK_EQUAL(block[1], (unsigned int)2);
+    f.close();
+
+    remove("test_trace.bin");
+    }
+
+//! Check that hardware counters count forward and attach to the profiler
+BOOST_AUTO_TEST_CASE(HardwareCounters_test)
+    {
+    boost::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    boost::shared_ptr<HardwareCounters> hw(new HardwareCounters(exec_conf));
+
+    // no raw event was given
+    BOOST_CHECK(!hw->isAvailable(HardwareCounters::vector_fp));
+
+    int64_t start[HardwareCounters::num_counters];
+    int64_t end[HardwareCounters::num_counters];
+    hw->read(start);
+
+    volatile double x = 0.0;
+    for (unsigned int i = 0; i < 1000000; i++)
+        x += sqrt(double(i));
+
+    hw->read(end);
+    for (unsigned int c = 0; c < HardwareCounters::num_counters; c++)
+        {
+        // counters that could not be opened (the test may run without perf access) read as 0
+        if (hw->isAvailable(c))
+            BOOST_CHECK(end[c] >= start[c]);
+        else
+            BOOST_CHECK_EQUAL(end[c], 0);
+        }
+    if (hw->isAvailable(HardwareCounters::instructions))
+        BOOST_CHECK(end[HardwareCounters::instructions] - start[HardwareCounters::instructions] > 1000000);
+
+    // the profiler accumulates the counts into each region
+    Profiler prof("Main");
+    prof.setHardwareCounters(hw);
+    prof.push("Loop");
+    for (unsigned int i = 0; i < 1000000; i++)
+        x += sqrt(double(i));
+    prof.pop(1000000, 0);
+    cout << prof;
+    }
+
+//! check the steps generated by the schedule types
+BOOST_AUTO_TEST_CASE(Schedule_test)
+    {
+    ScheduleLog log(10);
+    unsigned int expected[] = {0, 1, 2, 3, 4, 5, 6, 8, 10, 13, 16, 20, 25, 32, 40, 50, 63, 79, 100, 126};
+    unsigned int step = 0;
+    for (unsigned int i = 0; i < 20; i++)
+        {
+        step = log.getNextStep(step);
+        BOOST_CHECK_EQUAL(step, expected[i]);
+        step++;
+        }
+    BOOST_CHECK_EQUAL(log.getNextStep(0xfffffff0), Schedule::never);
+
+    ScheduleLinearLog linear_log(100, 1);
+    BOOST_CHECK_EQUAL(linear_log.getNextStep(0), (unsigned int)0);
+    BOOST_CHECK_EQUAL(linear_log.getNextStep(2), (unsigned int)10);
+    BOOST_CHECK_EQUAL(linear_log.getNextStep(11), (unsigned int)100);
+    BOOST_CHECK_EQUAL(linear_log.getNextStep(101), (unsigned int)101);
+    BOOST_CHECK_EQUAL(linear_log.getNextStep(102), (unsigned int)110);
+
+    boost::shared_ptr<ScheduleList> list(new ScheduleList());
+    list->addStep(50);
+    list->addStep(5);
+    list->addStep(50);
+    BOOST_CHECK_EQUAL(list->getNextStep(0), (unsigned int)5);
+    BOOST_CHECK_EQUAL(list->getNextStep(6), (unsigned int)50);
+    BOOST_CHECK_EQUAL(list->getNextStep(51), Schedule::never);
+
+    ScheduleUnion u;
+    u.addSchedule(boost::shared_ptr<Schedule>(new ScheduleLog(1)));
+    u.addSchedule(list);
+    BOOST_CHECK_EQUAL(u.getNextStep(2), (unsigned int)5);
+    BOOST_CHECK_EQUAL(u.getNextStep(11), (unsigned int)50);
+    BOOST_CHECK_EQUAL(u.getNextStep(51), (unsigned int)100);
+    }
+
 //! perform some simple checks on the variant types
 BOOST_AUTO_TEST_CASE(Variant_test)
     {